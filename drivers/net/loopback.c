@@ -23,11 +23,148 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #include <net/net_if.h>
 
 #include <net/dummy.h>
+#include <net/loopback.h>
+
+#if defined(CONFIG_NET_LOOPBACK_SIMULATE_PACKET_DROP)
+static float loopback_packet_drop_ratio;
+static float loopback_packet_drop_state;
+static int loopback_packet_dropped_count;
+
+int loopback_set_packet_drop_ratio(float ratio)
+{
+	if (ratio < 0.0f || ratio > 1.0f) {
+		return -EINVAL;
+	}
+
+	loopback_packet_drop_ratio = ratio;
+	loopback_packet_drop_state = 0.0f;
+
+	return 0;
+}
+
+int loopback_get_num_dropped_packets(void)
+{
+	return loopback_packet_dropped_count;
+}
+
+static bool loopback_packet_drop(void)
+{
+	loopback_packet_drop_state += loopback_packet_drop_ratio;
+	if (loopback_packet_drop_state >= 1.0f) {
+		loopback_packet_drop_state -= 1.0f;
+		loopback_packet_dropped_count++;
+		return true;
+	}
+
+	return false;
+}
+#else
+#define loopback_packet_drop() false
+#endif /* CONFIG_NET_LOOPBACK_SIMULATE_PACKET_DROP */
+
+#if defined(CONFIG_NET_LOOPBACK_SIMULATE_PACKET_DELAY)
+struct loopback_delayed_pkt {
+	struct net_pkt *pkt;
+	int64_t deliver_at;
+};
+
+static struct loopback_delayed_pkt
+	delay_queue[CONFIG_NET_LOOPBACK_DELAY_QUEUE_SIZE];
+static uint16_t delay_queue_head;
+static uint16_t delay_queue_count;
+static uint32_t loopback_delay_ms;
+static struct k_spinlock delay_lock;
+static struct k_delayed_work delay_work;
+
+int loopback_set_packet_delay(uint32_t delay_ms)
+{
+	loopback_delay_ms = delay_ms;
+
+	return 0;
+}
+
+static void loopback_delay_deliver(struct k_work *work)
+{
+	struct net_pkt *pkt;
+	k_spinlock_key_t key;
+	int64_t now;
+
+	ARG_UNUSED(work);
+
+	while (true) {
+		now = k_uptime_get();
+		pkt = NULL;
+
+		key = k_spin_lock(&delay_lock);
+
+		if (delay_queue_count > 0) {
+			struct loopback_delayed_pkt *entry =
+				&delay_queue[delay_queue_head];
+
+			if (entry->deliver_at <= now) {
+				pkt = entry->pkt;
+				delay_queue_head = (delay_queue_head + 1) %
+					ARRAY_SIZE(delay_queue);
+				delay_queue_count--;
+			} else {
+				k_delayed_work_submit(&delay_work,
+					K_MSEC(entry->deliver_at - now));
+			}
+		}
+
+		k_spin_unlock(&delay_lock, key);
+
+		if (!pkt) {
+			break;
+		}
+
+		if (net_recv_data(net_pkt_iface(pkt), pkt) < 0) {
+			LOG_ERR("Data receive failed.");
+			net_pkt_unref(pkt);
+		}
+	}
+}
+
+/* The delay is the same for every packet so the queue stays ordered by
+ * delivery time.
+ */
+static int loopback_delay_queue(struct net_pkt *pkt)
+{
+	k_spinlock_key_t key;
+	int ret = 0;
+
+	key = k_spin_lock(&delay_lock);
+
+	if (delay_queue_count == ARRAY_SIZE(delay_queue)) {
+		ret = -ENOBUFS;
+	} else {
+		struct loopback_delayed_pkt *entry =
+			&delay_queue[(delay_queue_head + delay_queue_count) %
+				     ARRAY_SIZE(delay_queue)];
+
+		entry->pkt = pkt;
+		entry->deliver_at = k_uptime_get() + loopback_delay_ms;
+
+		if (delay_queue_count++ == 0) {
+			k_delayed_work_submit(&delay_work,
+					      K_MSEC(loopback_delay_ms));
+		}
+	}
+
+	k_spin_unlock(&delay_lock, key);
+
+	return ret;
+}
+#endif /* CONFIG_NET_LOOPBACK_SIMULATE_PACKET_DELAY */
 
 int loopback_dev_init(const struct device *dev)
 {
 	ARG_UNUSED(dev);
 
+#if defined(CONFIG_NET_LOOPBACK_SIMULATE_PACKET_DELAY)
+	k_delayed_work_init(&delay_work, loopback_delay_deliver);
+#endif
+
 	return 0;
 }
 
@@ -75,12 +212,31 @@ static int loopback_send(const struct device *dev, struct net_pkt *pkt)
 	 * must be dropped. This is very much needed for TCP packets where
 	 * the packet is reference counted in various stages of sending.
 	 */
+	if (loopback_packet_drop()) {
+		/* Pretend that the packet was sent but lost on the wire */
+		res = 0;
+		goto out;
+	}
+
 	cloned = net_pkt_clone(pkt, K_MSEC(100));
 	if (!cloned) {
 		res = -ENOMEM;
 		goto out;
 	}
 
+#if defined(CONFIG_NET_LOOPBACK_SIMULATE_PACKET_DELAY)
+	if (loopback_delay_ms) {
+		res = loopback_delay_queue(cloned);
+		if (res < 0) {
+			LOG_DBG("Delay queue full, dropping packet");
+			net_pkt_unref(cloned);
+			res = 0;
+		}
+
+		goto out;
+	}
+#endif
+
 	res = net_recv_data(net_pkt_iface(cloned), cloned);
 	if (res < 0) {
 		LOG_ERR("Data receive failed.");
@@ -9,6 +9,7 @@
 
 #include <sys/util.h>
 #include <stddef.h>
+#include <stdbool.h>
 #include <zephyr/types.h>
 #include <sys/types.h>
 
@@ -711,6 +712,289 @@ int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
 int json_arr_encode(const struct json_obj_descr *descr, const void *val,
 		    json_append_bytes_t append_bytes, void *data);
 
+/**
+ * @brief Event reported by the streaming parser.
+ */
+struct json_stream_event {
+	/** One of: JSON_TOK_OBJECT_START, JSON_TOK_OBJECT_END,
+	 *  JSON_TOK_LIST_START, JSON_TOK_LIST_END, JSON_TOK_STRING,
+	 *  JSON_TOK_NUMBER, JSON_TOK_TRUE, JSON_TOK_FALSE, JSON_TOK_NULL.
+	 */
+	enum json_tokens type;
+	/** Key of the value inside an object, NUL terminated, or NULL for
+	 *  values in arrays, top-level values and end events.
+	 */
+	const char *key;
+	size_t key_len;
+	/** Text of strings, without the quotes and not unescaped, and of
+	 *  numbers, NUL terminated. NULL for the other types.
+	 */
+	const char *value;
+	size_t value_len;
+	/** Nesting level, 0 for the top-level value. */
+	uint8_t depth;
+};
+
+/**
+ * @brief Function pointer type called by the streaming parser for each
+ * event.
+ *
+ * The key and value are only valid during the call.
+ *
+ * @param event Event
+ * @param user_data User-provided pointer
+ *
+ * @return 0 to continue parsing, or a negative number to abort (which will
+ * be propagated to the return value of json_stream_feed()).
+ */
+typedef int (*json_stream_cb_t)(const struct json_stream_event *event,
+				void *user_data);
+
+/**
+ * @brief Streaming parser context. Fields are private, use
+ * json_stream_init().
+ */
+struct json_stream {
+	json_stream_cb_t cb;
+	void *user_data;
+	char *buf;
+	size_t buf_size;
+	/* Bytes of buf taken by the pending key and its NUL character. */
+	size_t key_size;
+	/* Bytes of the token being received, stored after the key. */
+	size_t len;
+	/* Bit n set if the container at depth n is an object. */
+	uint32_t objects;
+	uint8_t depth;
+	uint8_t state;
+	/* Progress in a string escape, number or literal. */
+	uint8_t sub;
+	uint8_t literal;
+	bool in_key;
+};
+
+/**
+ * @brief Initializes a streaming parser.
+ *
+ * The streaming parser does not need the whole document: it is fed with
+ * chunks of any size, for instance as they are received from a socket, and
+ * reports the values to a callback as soon as they are complete. Only the
+ * key and value being received are kept, in @a buf.
+ *
+ * The same liberties as json_obj_parse() are taken, numbers are reported as
+ * text. Up to 32 levels of nesting are supported.
+ *
+ * @param stream Parser context
+ *
+ * @param buf Buffer for the tokens. It must hold the longest key and value
+ * of the same member, plus two NUL characters.
+ *
+ * @param buf_size Size of buf, in bytes
+ *
+ * @param cb Function called for each event
+ *
+ * @param user_data Data pointer to be passed to the callback function
+ */
+void json_stream_init(struct json_stream *stream, char *buf, size_t buf_size,
+		      json_stream_cb_t cb, void *user_data);
+
+/**
+ * @brief Feeds a chunk of a JSON document to a streaming parser.
+ *
+ * @param stream Parser context
+ *
+ * @param data Chunk of the document
+ *
+ * @param len Length of the chunk
+ *
+ * @return 0 if the chunk has been parsed. -EINVAL if the document is not
+ * valid, -ENOMEM if a token does not fit in the buffer or the document is
+ * nested too deeply, or the error returned by the callback. The parser must
+ * be initialized again after an error.
+ */
+int json_stream_feed(struct json_stream *stream, const char *data,
+		     size_t len);
+
+/**
+ * @brief Signals the end of the document to a streaming parser.
+ *
+ * This reports a pending top-level number, which is only known to be
+ * complete at the end of the document.
+ *
+ * @param stream Parser context
+ *
+ * @return 0 if a complete value has been parsed. A negative value indicates
+ * an error, -EINVAL if the document is truncated.
+ */
+int json_stream_end(struct json_stream *stream);
+
+/**
+ * @brief Streaming encoder context. Fields are private, use
+ * json_writer_init().
+ */
+struct json_writer {
+	json_append_bytes_t append_bytes;
+	void *data;
+	/* Bit n set if the container at depth n is an object. */
+	uint32_t objects;
+	/* Bit n set if the container at depth n has no member yet. */
+	uint32_t empty;
+	uint8_t depth;
+	/* Set once the top-level value has been started. */
+	bool root;
+	int ret;
+};
+
+/**
+ * @brief Initializes a streaming encoder.
+ *
+ * The streaming encoder builds a document element by element, without
+ * descriptors, and emits it in a single pass through @a append_bytes. It
+ * suits documents whose layout is only known at run time, and which would
+ * otherwise have to be measured with json_calc_encoded_len() and buffered.
+ * Commas are inserted as needed.
+ *
+ * The functions adding an element take the key of the element, which must
+ * be NULL for the top-level value and the elements of arrays. A document
+holds a single top-level value, adding another one fails. Errors are
+ * sticky: once a function failed, the following ones return the same error,
+ * so only the last return value needs to be checked. Up to 32 levels of
+ * nesting are supported.
+ *
+ * @param writer Encoder context
+ *
+ * @param append_bytes Function to append bytes to the output
+ *
+ * @param data Data pointer to be passed to the append_bytes callback
+ * function.
+ */
+void json_writer_init(struct json_writer *writer,
+		      json_append_bytes_t append_bytes, void *data);
+
+/**
+ * @brief Starts an object with a streaming encoder.
+ *
+ * @param writer Encoder context
+ *
+ * @param key Key of the object, or NULL
+ *
+ * @return 0 on success. A negative value indicates an error.
+ */
+int json_writer_obj_start(struct json_writer *writer, const char *key);
+
+/**
+ * @brief Ends the current object with a streaming encoder.
+ *
+ * @param writer Encoder context
+ *
+ * @return 0 on success. A negative value indicates an error.
+ */
+int json_writer_obj_end(struct json_writer *writer);
+
+/**
+ * @brief Starts an array with a streaming encoder.
+ *
+ * @param writer Encoder context
+ *
+ * @param key Key of the array, or NULL
+ *
+ * @return 0 on success. A negative value indicates an error.
+ */
+int json_writer_arr_start(struct json_writer *writer, const char *key);
+
+/**
+ * @brief Ends the current array with a streaming encoder.
+ *
+ * @param writer Encoder context
+ *
+ * @return 0 on success. A negative value indicates an error.
+ */
+int json_writer_arr_end(struct json_writer *writer);
+
+/**
+ * @brief Adds a string with a streaming encoder. The string is escaped.
+ *
+ * @param writer Encoder context
+ *
+ * @param key Key of the string, or NULL
+ *
+ * @param value String
+ *
+ * @return 0 on success. A negative value indicates an error.
+ */
+int json_writer_str(struct json_writer *writer, const char *key,
+		    const char *value);
+
+/**
+ * @brief Adds a number with a streaming encoder.
+ *
+ * @param writer Encoder context
+ *
+ * @param key Key of the number, or NULL
+ *
+ * @param value Number
+ *
+ * @return 0 on success. A negative value indicates an error.
+ */
+int json_writer_num(struct json_writer *writer, const char *key,
+		    int32_t value);
+
+/**
+ * @brief Adds a boolean with a streaming encoder.
+ *
+ * @param writer Encoder context
+ *
+ * @param key Key of the boolean, or NULL
+ *
+ * @param value Boolean
+ *
+ * @return 0 on success. A negative value indicates an error.
+ */
+int json_writer_bool(struct json_writer *writer, const char *key,
+		     bool value);
+
+/**
+ * @brief Adds a null value with a streaming encoder.
+ *
+ * @param writer Encoder context
+ *
+ * @param key Key of the value, or NULL
+ *
+ * @return 0 on success. A negative value indicates an error.
+ */
+int json_writer_null(struct json_writer *writer, const char *key);
+
+/**
+ * @brief Adds an object described by a descriptor with a streaming
+ * encoder, see json_obj_encode().
+ *
+ * @param writer Encoder context
+ *
+ * @param key Key of the object, or NULL
+ *
+ * @param descr Pointer to the descriptor array
+ *
+ * @param descr_len Number of elements in the descriptor array
+ *
+ * @param val Struct holding the values
+ *
+ * @return 0 on success. A negative value indicates an error.
+ */
+int json_writer_obj(struct json_writer *writer, const char *key,
+		    const struct json_obj_descr *descr, size_t descr_len,
+		    const void *val);
+
+/**
+ * @brief Ends a document with a streaming encoder.
+ *
+ * @param writer Encoder context
+ *
+ * @return 0 if the document has been successfully encoded, -EINVAL if it
+ * has no value or if an object or array has not been ended. A negative
+ * value indicates an error.
+ */
+int json_writer_end(struct json_writer *writer);
+
 #ifdef __cplusplus
 }
 #endif
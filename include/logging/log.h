@@ -70,6 +70,53 @@ extern "C" {
  */
 #define LOG_DBG(...)    Z_LOG(LOG_LEVEL_DBG, __VA_ARGS__)
 
+/**
+ * @brief Writes an ERROR level message to the log, with the rate of the call
+ *	  site limited.
+ *
+ * @details Each call site has its own token bucket, with the rate and burst
+ * set by CONFIG_LOG_RATE_LIMIT_RATE and CONFIG_LOG_RATE_LIMIT_BURST. It is
+ * meant for errors which can repeat, such as in a fault loop. Same as
+ * LOG_ERR() if CONFIG_LOG_RATE_LIMIT is disabled.
+ *
+ * @param ... A string optionally containing printk valid conversion specifier,
+ * followed by as many values as specifiers.
+ */
+#define LOG_ERR_RATELIMIT(...) Z_LOG_RATELIMIT(LOG_LEVEL_ERR, __VA_ARGS__)
+
+/**
+ * @brief Writes a WARNING level message to the log, with the rate of the call
+ *	  site limited.
+ *
+ * @details See LOG_ERR_RATELIMIT().
+ *
+ * @param ... A string optionally containing printk valid conversion specifier,
+ * followed by as many values as specifiers.
+ */
+#define LOG_WRN_RATELIMIT(...) Z_LOG_RATELIMIT(LOG_LEVEL_WRN, __VA_ARGS__)
+
+/**
+ * @brief Writes an INFO level message to the log, with the rate of the call
+ *	  site limited.
+ *
+ * @details See LOG_ERR_RATELIMIT().
+ *
+ * @param ... A string optionally containing printk valid conversion specifier,
+ * followed by as many values as specifiers.
+ */
+#define LOG_INF_RATELIMIT(...) Z_LOG_RATELIMIT(LOG_LEVEL_INF, __VA_ARGS__)
+
+/**
+ * @brief Writes a DEBUG level message to the log, with the rate of the call
+ *	  site limited.
+ *
+ * @details See LOG_ERR_RATELIMIT().
+ *
+ * @param ... A string optionally containing printk valid conversion specifier,
+ * followed by as many values as specifiers.
+ */
+#define LOG_DBG_RATELIMIT(...) Z_LOG_RATELIMIT(LOG_LEVEL_DBG, __VA_ARGS__)
+
 /**
  * @brief Writes an ERROR level message associated with the instance to the log.
  *
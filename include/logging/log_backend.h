@@ -7,6 +7,7 @@
 #define ZEPHYR_INCLUDE_LOGGING_LOG_BACKEND_H_
 
 #include <logging/log_msg.h>
+#include <logging/log_msg2.h>
 #include <stdarg.h>
 #include <sys/__assert.h>
 #include <sys/util.h>
@@ -31,6 +32,8 @@ struct log_backend;
 struct log_backend_api {
 	void (*put)(const struct log_backend *const backend,
 		    struct log_msg *msg);
+	void (*process)(const struct log_backend *const backend,
+			const struct log_msg2 *msg);
 	void (*put_sync_string)(const struct log_backend *const backend,
 			 struct log_msg_ids src_level, uint32_t timestamp,
 			 const char *fmt, va_list ap);
@@ -102,6 +105,27 @@ static inline void log_backend_put(const struct log_backend *const backend,
 	backend->api->put(backend, msg);
 }
 
+/**
+ * @brief Process packaged message with log entry by the backend.
+ *
+ * The message is valid only for the duration of the call. Backends not
+ * supporting packaged messages are skipped.
+ *
+ * @param[in] backend  Pointer to the backend instance.
+ * @param[in] msg      Pointer to message with log entry.
+ */
+static inline void log_backend_msg2_process(
+					const struct log_backend *const backend,
+					const struct log_msg2 *msg)
+{
+	__ASSERT_NO_MSG(backend != NULL);
+	__ASSERT_NO_MSG(msg != NULL);
+
+	if (backend->api->process) {
+		backend->api->process(backend, msg);
+	}
+}
+
 /**
  * @brief Synchronously process log message.
  *
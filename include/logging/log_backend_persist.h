@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef ZEPHYR_INCLUDE_LOGGING_LOG_BACKEND_PERSIST_H_
+#define ZEPHYR_INCLUDE_LOGGING_LOG_BACKEND_PERSIST_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Persistent log backend API
+ * @defgroup log_backend_persist Persistent log backend API
+ * @ingroup logger
+ * @{
+ */
+
+/** @brief Source ID of the records not coming from a log source, like the
+ *	   notifications of dropped messages.
+ */
+#define LOG_PERSIST_NO_SOURCE UINT16_MAX
+
+/** @brief Metadata of a persistent log record. */
+struct log_persist_record {
+	/** Sequence number, incremented for each record. */
+	uint32_t seq;
+	/** Timestamp of the message, in the ticks of the log timestamp, or 0
+	 *  if the record has no source.
+	 */
+	uint32_t timestamp;
+	/** Boot count when the record was written, see
+	 *  log_persist_boot_get().
+	 */
+	uint16_t boot;
+	/** Source ID, or LOG_PERSIST_NO_SOURCE. */
+	uint16_t source_id;
+	/** Level of the message. */
+	uint8_t level;
+};
+
+/** @brief Read a record of the persistent log.
+ *
+ * Records are indexed by their sequence numbers. Reading consecutive records
+ * takes a constant time.
+ *
+ * @param seq	 Sequence number. The oldest record with a sequence number not
+ *		 lower is read, and seq is set to the sequence number following
+ *		 it. Set to 0 to start from the oldest record.
+ * @param record Location for the metadata of the record.
+ * @param buf	 Location for the formatted message, NUL terminated.
+ * @param size	 Size of buf. The message is truncated to fit.
+ *
+ * @retval 0 on success.
+ * @retval -ENOENT if there is no record left.
+ */
+int log_persist_read(uint32_t *seq, struct log_persist_record *record,
+		     char *buf, size_t size);
+
+/** @brief Get the boot count.
+ *
+ * The boot count is incremented each time the backend is initialized and
+ * finds a valid log from a previous boot, in retained RAM or in flash.
+ *
+ * @return Boot count.
+ */
+uint16_t log_persist_boot_get(void);
+
+/** @brief Remove all records. */
+void log_persist_clear(void);
+
+/** @brief Copy the records to the flash partition.
+ *
+ * The copy replaces the older of the two copies in the partition, the last
+ * one is kept until the new one is complete.
+ *
+ * @retval 0 on success.
+ * @retval -ENOSPC if half of the partition cannot hold the ring.
+ * @retval -ENOTSUP if CONFIG_LOG_BACKEND_PERSIST_FLASH is disabled.
+ * @retval -EBUSY if the records kept changing during the copy.
+ * @retval -errno Other negative errno code on flash failure.
+ */
+int log_persist_flush(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_LOGGING_LOG_BACKEND_PERSIST_H_ */
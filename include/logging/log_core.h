@@ -7,6 +7,7 @@
 #define ZEPHYR_INCLUDE_LOGGING_LOG_CORE_H_
 
 #include <logging/log_msg.h>
+#include <logging/log_msg2.h>
 #include <logging/log_instance.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -188,6 +189,8 @@ extern "C" {
 			log_from_user(_src_level, __VA_ARGS__);		 \
 		} else if (IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {		 \
 			log_string_sync(_src_level, __VA_ARGS__);	 \
+		} else if (IS_ENABLED(CONFIG_LOG2)) {			 \
+			Z_LOG_MSG2_CREATE(_src_level, __VA_ARGS__);	 \
 		} else {						 \
 			Z_LOG_INTERNAL_X(Z_LOG_NARGS_POSTFIX(__VA_ARGS__), \
 						_src_level, __VA_ARGS__);\
@@ -307,6 +310,30 @@ static inline char z_log_minimal_level_to_char(int level)
 	      _inst,					 \
 	      __VA_ARGS__)
 
+#ifdef CONFIG_LOG_RATE_LIMIT
+/* The bucket of the call site is checked once the message passed the level
+ * filters, the bucket of the source being checked by Z_LOG() afterwards.
+ */
+#define Z_LOG_RATELIMIT(_level, ...)					       \
+	do {								       \
+		static struct log_rate_limit _log_rl =			       \
+			LOG_RATE_LIMIT_INITIALIZER(CONFIG_LOG_RATE_LIMIT_RATE, \
+						   CONFIG_LOG_RATE_LIMIT_BURST);\
+									       \
+		if (!Z_LOG_CONST_LEVEL_CHECK(_level) ||			       \
+		    _is_user_context() ||				       \
+		    (_level > LOG_RUNTIME_FILTER(			       \
+				LOG_CURRENT_DYNAMIC_DATA_ADDR())) ||	       \
+		    z_log_rate_limit_check(&_log_rl,			       \
+					   LOG_CURRENT_DYNAMIC_DATA_ADDR(),    \
+					   _level)) {			       \
+			Z_LOG(_level, __VA_ARGS__);			       \
+		}							       \
+	} while (false)
+#else
+#define Z_LOG_RATELIMIT(_level, ...) Z_LOG(_level, __VA_ARGS__)
+#endif
+
 
 /******************************************************************************/
 /****************** Macros for hexdump logging ********************************/
@@ -403,9 +430,32 @@ static inline char z_log_minimal_level_to_char(int level)
 
 #define LOG_FILTER_FIRST_BACKEND_SLOT_IDX 1
 
+#ifdef CONFIG_LOG_RATE_LIMIT
+/** @brief Take a token from the bucket of a source or of a call site.
+ *
+ * Pending suppressed messages of the source are reported first if a token
+ * is available.
+ *
+ * @param rl	 Token bucket.
+ * @param source Dynamic data of the source.
+ * @param level	 Level of the message.
+ *
+ * @return True if the message can be logged, false if it is suppressed.
+ */
+bool z_log_rate_limit_check(struct log_rate_limit *rl,
+			    struct log_source_dynamic_data *source,
+			    uint8_t level);
+
+#define Z_LOG_RATE_LIMIT_CHECK(_level, _filter) \
+	z_log_rate_limit_check(&(_filter)->rate_limit, _filter, _level)
+#else
+#define Z_LOG_RATE_LIMIT_CHECK(_level, _filter) (true)
+#endif
+
 #ifdef CONFIG_LOG_RUNTIME_FILTERING
 #define LOG_CHECK_CTX_LVL_FILTER(ctx, _level, _filter) \
-	(ctx || (_level <= LOG_RUNTIME_FILTER(_filter)))
+	(ctx || ((_level <= LOG_RUNTIME_FILTER(_filter)) && \
+		 Z_LOG_RATE_LIMIT_CHECK(_level, _filter)))
 #define LOG_RUNTIME_FILTER(_filter) \
 	LOG_FILTER_SLOT_GET(&(_filter)->filters, LOG_FILTER_AGGR_SLOT_IDX)
 #else
@@ -784,7 +834,8 @@ static inline log_arg_t z_log_do_strdup(uint32_t msk, uint32_t idx,
 do {									       \
 	if (is_user_context) {						       \
 		log_generic_from_user(_src_level, _str, _valist);	       \
-	} else if (IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {			       \
+	} else if (IS_ENABLED(CONFIG_LOG_IMMEDIATE) ||			       \
+		   IS_ENABLED(CONFIG_LOG2)) {				       \
 		log_generic(_src_level, _str, _valist, _strdup_action);        \
 	} else if (_argnum == 0) {					       \
 		_LOG_INTERNAL_0(_src_level, _str);			       \
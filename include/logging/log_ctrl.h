@@ -149,6 +149,48 @@ __syscall uint32_t log_filter_set(struct log_backend const *const backend,
 			       uint32_t src_id,
 			       uint32_t level);
 
+/**
+ * @brief Set the rate limit of the given source.
+ *
+ * The token bucket of the source is refilled and its count of suppressed
+ * messages is reset. Requires CONFIG_LOG_RATE_LIMIT.
+ *
+ * @param domain_id	ID of the domain.
+ * @param src_id	Source (module or instance) ID.
+ * @param rate		Sustained number of messages per second, 0 to remove
+ *			the limit.
+ * @param burst		Number of messages accepted in a row.
+ */
+void log_rate_limit_set(uint32_t domain_id, uint32_t src_id, uint16_t rate,
+			uint16_t burst);
+
+/**
+ * @brief Get the rate limit of the given source.
+ *
+ * Requires CONFIG_LOG_RATE_LIMIT.
+ *
+ * @param domain_id	ID of the domain.
+ * @param src_id	Source (module or instance) ID.
+ * @param rate		Location for the number of messages per second, 0 if
+ *			unlimited.
+ * @param burst		Location for the number of messages accepted in a row.
+ */
+void log_rate_limit_get(uint32_t domain_id, uint32_t src_id, uint16_t *rate,
+			uint16_t *burst);
+
+/**
+ * @brief Get the number of messages of the given source suppressed by its
+ *	  rate limit or by the rate limit of its call sites.
+ *
+ * Requires CONFIG_LOG_RATE_LIMIT.
+ *
+ * @param domain_id	ID of the domain.
+ * @param src_id	Source (module or instance) ID.
+ *
+ * @return Number of suppressed messages since the limit was set.
+ */
+uint32_t log_rate_limit_suppressed_get(uint32_t domain_id, uint32_t src_id);
+
 /**
  *
  * @brief Enable backend with initial maximum filtering level.
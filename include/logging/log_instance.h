@@ -25,9 +25,35 @@ struct log_source_const_data {
 #endif
 };
 
+/** @brief Token bucket limiting the rate of log messages. */
+struct log_rate_limit {
+	/* Uptime of the last refill, in milliseconds. */
+	uint32_t stamp;
+	/* Number of suppressed messages since the limit was set, only
+	 * counted by the buckets of the sources.
+	 */
+	uint32_t suppressed;
+	uint16_t tokens;
+	/* Tokens added per second, 0 if unlimited. */
+	uint16_t rate;
+	uint16_t burst;
+	/* Number of suppressed messages not reported yet. */
+	uint16_t pending;
+};
+
+/** @brief Initializer of a token bucket, starting full. */
+#define LOG_RATE_LIMIT_INITIALIZER(_rate, _burst) { \
+	.tokens = _burst, \
+	.rate = _rate, \
+	.burst = _burst, \
+}
+
 /** @brief Dynamic data associated with the source of log messages. */
 struct log_source_dynamic_data {
 	uint32_t filters;
+#ifdef CONFIG_LOG_RATE_LIMIT
+	struct log_rate_limit rate_limit;
+#endif
 #ifdef CONFIG_NIOS2
 	/* Workaround alert! Dummy data to ensure that structure is >8 bytes.
 	 * Nios2 uses global pointer register for structures <=8 bytes and
@@ -36,7 +62,9 @@ struct log_source_dynamic_data {
 	uint32_t dummy[2];
 #endif
 #if defined(CONFIG_RISCV) && defined(CONFIG_64BIT)
-	/* Workaround: RV64 needs to ensure that structure is just 8 bytes. */
+	/* Workaround: RV64 needs to ensure that structure size is a multiple
+	 * of 8 bytes.
+	 */
 	uint32_t dummy;
 #endif
 };
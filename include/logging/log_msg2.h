@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef ZEPHYR_INCLUDE_LOGGING_LOG_MSG2_H_
+#define ZEPHYR_INCLUDE_LOGGING_LOG_MSG2_H_
+
+#include <logging/log_msg.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <toolchain.h>
+#include <sys/cbprintf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Log message v2 API
+ * @defgroup log_msg2 Log message v2 API
+ * @ingroup logger
+ * @{
+ */
+
+/** @brief Packaged log message.
+ *
+ * A message is a single variable length record of the log buffer. It holds
+ * the format string and its arguments as a cbprintf package, see
+ * cbprintf_package(), followed by the optional hexdump data. Strings
+ * passed as arguments are copied in the package when the message is
+ * created, so log_strdup() is not needed.
+ */
+struct log_msg2 {
+	uint32_t timestamp;
+	struct log_msg_ids ids;
+	/** Length of the package, 0 if the message has no string. */
+	uint16_t package_len;
+	/** Length of the hexdump data, following the package. */
+	uint16_t data_len;
+	uint8_t data[];
+};
+
+/** @brief Get the package of a message.
+ *
+ * @param msg Message.
+ *
+ * @return Package, or NULL if the message has no string.
+ */
+static inline const uint8_t *log_msg2_get_package(const struct log_msg2 *msg)
+{
+	return msg->package_len ? msg->data : NULL;
+}
+
+/** @brief Get the hexdump data of a message.
+ *
+ * @param msg Message.
+ * @param len Set to the length of the data.
+ *
+ * @return Data.
+ */
+static inline const uint8_t *log_msg2_get_data(const struct log_msg2 *msg,
+					       size_t *len)
+{
+	*len = msg->data_len;
+
+	return msg->data + msg->package_len;
+}
+
+/** @brief Create a message from a format string and arguments.
+ *
+ * The format string is analyzed at runtime to package the arguments. The
+ * message is dropped if the log buffer is full.
+ *
+ * @param ids	Source and level of the message.
+ * @param data	Hexdump data, may be NULL.
+ * @param dlen	Length of the hexdump data.
+ * @param fmt	Format string, NULL if the message has no string.
+ * @param ...	Arguments of the format string.
+ */
+void z_log_msg2_runtime_create(struct log_msg_ids ids, const void *data,
+			       size_t dlen, const char *fmt, ...)
+			       __printf_like(4, 5);
+
+/** @brief Create a message from a format string and an argument list.
+ *
+ * @see z_log_msg2_runtime_create()
+ *
+ * @param ids	Source and level of the message.
+ * @param data	Hexdump data, may be NULL.
+ * @param dlen	Length of the hexdump data.
+ * @param fmt	Format string, NULL if the message has no string.
+ * @param ap	Arguments of the format string.
+ */
+void z_log_msg2_runtime_vcreate(struct log_msg_ids ids, const void *data,
+				size_t dlen, const char *fmt, va_list ap);
+
+/** @brief Create a message from a format string and arguments.
+ *
+ * The package is laid out from the types of the arguments at build time,
+ * see CBPRINTF_STATIC_PACKAGE(), unless @option{CONFIG_LOG2_ALWAYS_RUNTIME}
+ * is set. The message is dropped if the log buffer is full.
+ *
+ * @param _ids	Source and level of the message.
+ * @param ...	Format string followed by its arguments.
+ */
+#ifdef CONFIG_LOG2_ALWAYS_RUNTIME
+#define Z_LOG_MSG2_CREATE(_ids, ...) \
+	z_log_msg2_runtime_create(_ids, NULL, 0, __VA_ARGS__)
+#else
+#define Z_LOG_MSG2_CREATE(_ids, ...) do { \
+	Z_CBPRINTF_ARGS_DECL(__VA_ARGS__); \
+	struct log_msg2 *_msg = NULL; \
+	int _plen; \
+	\
+	Z_CBPRINTF_PKG_BUILD(NULL, 0, _plen, __VA_ARGS__); \
+	if (_plen >= 0 && _plen <= UINT16_MAX) { \
+		_msg = z_log_msg2_alloc(sizeof(*_msg) + _plen); \
+	} else { \
+		log_dropped(); \
+	} \
+	if (_msg != NULL) { \
+		Z_CBPRINTF_PKG_BUILD(_msg->data, _plen, _plen, __VA_ARGS__); \
+		_msg->ids = _ids; \
+		/* A string which grew since it was measured does not fit, \
+		 * the message is committed without its package. \
+		 */ \
+		_msg->package_len = (_plen < 0) ? 0U : (uint16_t)_plen; \
+		_msg->data_len = 0; \
+		z_log_msg2_commit(_msg); \
+	} \
+} while (false)
+#endif /* CONFIG_LOG2_ALWAYS_RUNTIME */
+
+/** @brief Allocate a message in the log buffer.
+ *
+ * @note This function is intended to be used internally
+ *	 by the logging subsystem.
+ *
+ * @param len Length of the message, header included.
+ *
+ * @return Message, or NULL if the log buffer is full.
+ */
+struct log_msg2 *z_log_msg2_alloc(size_t len);
+
+/** @brief Timestamp a message and commit it to the log buffer.
+ *
+ * @note This function is intended to be used internally
+ *	 by the logging subsystem.
+ *
+ * @param msg Message allocated with z_log_msg2_alloc().
+ */
+void z_log_msg2_commit(struct log_msg2 *msg);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_LOGGING_LOG_MSG2_H_ */
@@ -7,6 +7,7 @@
 #define ZEPHYR_INCLUDE_LOGGING_LOG_OUTPUT_H_
 
 #include <logging/log_msg.h>
+#include <logging/log_msg2.h>
 #include <sys/util.h>
 #include <stdarg.h>
 #include <sys/atomic.h>
@@ -109,6 +110,15 @@ void log_output_msg_process(const struct log_output *log_output,
 			    struct log_msg *msg,
 			    uint32_t flags);
 
+/** @brief Process packaged log messages to readable strings.
+ *
+ * @param log_output Pointer to the log output instance.
+ * @param msg Packaged log message.
+ * @param flags Optional flags.
+ */
+void log_output_msg2_process(const struct log_output *log_output,
+			     const struct log_msg2 *msg, uint32_t flags);
+
 /** @brief Process log string
  *
  * Function is formatting provided string adding optional prefixes and
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef ZEPHYR_INCLUDE_LOGGING_LOG_OUTPUT_DICT_H_
+#define ZEPHYR_INCLUDE_LOGGING_LOG_OUTPUT_DICT_H_
+
+#include <logging/log_output.h>
+#include <logging/log_msg2.h>
+#include <stdint.h>
+#include <toolchain.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Dictionary based log output API
+ * @defgroup log_output_dict Dictionary based log output API
+ * @ingroup logger
+ * @{
+ */
+
+/** @brief First byte of each frame.
+ *
+ * The host decoder resynchronizes on it when bytes of the stream were lost
+ * or other output was mixed in.
+ */
+#define LOG_DICT_SYNC		0x5a
+
+/** @brief Frame carrying a log message. */
+#define LOG_DICT_FRAME_MSG	0
+
+/** @brief Frame carrying the number of dropped messages. */
+#define LOG_DICT_FRAME_DROPPED	1
+
+/** @brief Header of a log message frame.
+ *
+ * The header is followed by the package of the message, whose format string
+ * is a pointer resolved by the host from the ELF file of the image, and by
+ * the hexdump data. Multibyte fields use the byte order of the target.
+ */
+struct log_dict_msg_hdr {
+	uint8_t sync;
+	uint8_t type;
+	uint8_t level;
+	uint8_t domain_id;
+	uint16_t source_id;
+	uint16_t package_len;
+	uint16_t data_len;
+	uint16_t reserved;
+	uint32_t timestamp;
+} __packed;
+
+/** @brief Dropped messages frame. */
+struct log_dict_dropped {
+	uint8_t sync;
+	uint8_t type;
+	uint8_t reserved[2];
+	uint32_t count;
+} __packed;
+
+/** @brief Output a packaged log message as a binary frame.
+ *
+ * The message is not formatted on the target. The frame is decoded on the
+ * host by scripts/logging/dictionary/log_parser.py.
+ *
+ * @param log_output Pointer to the log output instance.
+ * @param msg Packaged log message.
+ * @param flags Optional flags, unused.
+ */
+void log_dict_output_msg2_process(const struct log_output *log_output,
+				  const struct log_msg2 *msg, uint32_t flags);
+
+/** @brief Output the number of dropped messages as a binary frame.
+ *
+ * @param log_output Pointer to the log output instance.
+ * @param cnt Number of dropped messages.
+ */
+void log_dict_output_dropped_process(const struct log_output *log_output,
+				     uint32_t cnt);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_LOGGING_LOG_OUTPUT_DICT_H_ */
@@ -207,7 +207,28 @@ struct coap_resource {
 	void *user_data;
 	sys_slist_t observers;
 	int age;
+#if defined(CONFIG_COAP_RESOURCE_INDEX)
+	/* Private, maintained by coap_resource_index_init() */
+	struct coap_resource *index_next;
+	uint32_t path_hash;
+	uint16_t link_len;
+#endif
+};
+
+#if defined(CONFIG_COAP_RESOURCE_INDEX)
+/**
+ * @brief Hash index over the paths of a resource array.
+ *
+ * The index finds the resource of a request in constant time instead of
+ * comparing the URI-Path options with every resource path. Resources with
+ * wildcards in their path are compared one by one.
+ */
+struct coap_resource_index {
+	struct coap_resource *resources;
+	struct coap_resource *buckets[CONFIG_COAP_RESOURCE_INDEX_BUCKETS];
+	struct coap_resource *wildcards;
 };
+#endif
 
 /**
  * @brief Represents a remote device that is observing a local resource.
@@ -217,6 +238,16 @@ struct coap_observer {
 	struct sockaddr addr;
 	uint8_t token[8];
 	uint8_t tkl;
+#if defined(CONFIG_COAP_OBSERVE_ENGINE)
+	/* Private, maintained by the observe engine */
+	uint8_t retries; /* Retransmissions of the outstanding CON */
+	bool con; /* A confirmable notification is outstanding */
+	uint16_t id; /* Message ID of the last notification */
+	int age; /* Observe sequence number of the last notification */
+	uint32_t last_tx; /* Time of the last notification */
+	uint32_t last_con; /* Time of the last confirmable notification */
+	uint32_t timeout; /* Retransmission timeout of the outstanding CON */
+#endif
 };
 
 /**
@@ -491,6 +522,57 @@ int coap_handle_request(struct coap_packet *cpkt,
 			uint8_t opt_num,
 			struct sockaddr *addr, socklen_t addr_len);
 
+#if defined(CONFIG_COAP_RESOURCE_INDEX)
+/**
+ * @brief Build the path index of a resource array.
+ *
+ * The index must be built again if a path of the array changes.
+ *
+ * @param index Index to initialize
+ * @param resources Array of known resources, terminated by an entry
+ * without path
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_resource_index_init(struct coap_resource_index *index,
+			     struct coap_resource *resources);
+
+/**
+ * @brief Find the resource matching the URI-Path options of a request.
+ *
+ * As with coap_handle_request(), the first matching resource of the
+ * array is returned when several paths match.
+ *
+ * @param index Index of the resources
+ * @param options Parsed options from coap_packet_parse()
+ * @param opt_num Number of options
+ *
+ * @return Matching resource or NULL if there is none.
+ */
+struct coap_resource *coap_resource_index_find(
+	const struct coap_resource_index *index,
+	const struct coap_option *options, uint8_t opt_num);
+
+/**
+ * @brief When a request is received, call the appropriate methods of
+ * the matching resource found from an index.
+ *
+ * @param cpkt Packet received
+ * @param index Index of the known resources
+ * @param options Parsed options from coap_packet_parse()
+ * @param opt_num Number of options
+ * @param addr Peer address
+ * @param addr_len Peer address length
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_handle_request_index(struct coap_packet *cpkt,
+			      const struct coap_resource_index *index,
+			      struct coap_option *options,
+			      uint8_t opt_num,
+			      struct sockaddr *addr, socklen_t addr_len);
+#endif /* CONFIG_COAP_RESOURCE_INDEX */
+
 /**
  * Represents the size of each block that will be transferred using
  * block-wise transfers [RFC7959]:
@@ -855,6 +937,124 @@ int coap_resource_notify(struct coap_resource *resource);
  */
 bool coap_request_is_observe(const struct coap_packet *request);
 
+#if defined(CONFIG_COAP_OBSERVE_ENGINE)
+struct coap_observe_engine;
+
+/**
+ * @typedef coap_observe_encode_t
+ * @brief Encodes the current state of a resource into a notification.
+ *
+ * @details Called once per batch of notifications. @a cpkt already
+ * holds the Observe option, the callback appends the following options,
+ * e.g. Content-Format, the payload marker and the payload.
+ */
+typedef int (*coap_observe_encode_t)(struct coap_resource *resource,
+				     struct coap_packet *cpkt,
+				     void *user_data);
+
+/**
+ * @typedef coap_observe_send_t
+ * @brief Sends a notification to an observer.
+ *
+ * @details @a msg holds the address of the observer and the
+ * notification as an I/O vector, ready for zsock_sendmsg().
+ */
+typedef int (*coap_observe_send_t)(struct coap_observer *observer,
+				   const struct msghdr *msg,
+				   void *user_data);
+
+/**
+ * @brief Sends the notifications of a set of resources.
+ *
+ * Updates of a resource are coalesced: observers only receive the
+ * latest state, and at most one notification every @a min_interval_ms.
+ * Notifications are non-confirmable except one every
+ * @a con_interval_ms, and no other notification is sent to an observer
+ * while a confirmable one is outstanding (RFC 7641, section 4.5). The
+ * payload is encoded once for all the observers that are due.
+ */
+struct coap_observe_engine {
+	/** Resources, terminated by an entry without path */
+	struct coap_resource *resources;
+	coap_observe_encode_t encode;
+	coap_observe_send_t send;
+	void *user_data;
+	/** Buffer for encoding a notification */
+	uint8_t *buf;
+	uint16_t buf_len;
+	/** Minimum time between two notifications to an observer */
+	uint32_t min_interval_ms;
+	/** Maximum time between two confirmable notifications */
+	uint32_t con_interval_ms;
+	/* Private */
+	uint32_t next_due;
+	bool scheduled;
+	bool changed;
+};
+
+/**
+ * @brief Initializes an observe engine.
+ *
+ * @param engine Engine to be initialized
+ * @param resources Array of resources, terminated by an entry without path
+ * @param buf Buffer for encoding a notification
+ * @param buf_len Length of @a buf
+ * @param encode Callback encoding the state of a resource
+ * @param send Callback sending a notification
+ * @param user_data User data passed to the callbacks
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_observe_engine_init(struct coap_observe_engine *engine,
+			     struct coap_resource *resources,
+			     uint8_t *buf, uint16_t buf_len,
+			     coap_observe_encode_t encode,
+			     coap_observe_send_t send, void *user_data);
+
+/**
+ * @brief Indicates that a resource was updated.
+ *
+ * @details Nothing is sent until coap_observe_engine_process() is called,
+ * so several updates in a row result in a single notification.
+ *
+ * @param engine Observe engine
+ * @param resource Resource that was updated
+ */
+void coap_observe_engine_notify(struct coap_observe_engine *engine,
+				struct coap_resource *resource);
+
+/**
+ * @brief Sends the notifications that are due.
+ *
+ * @details Also retransmits outstanding confirmable notifications, and
+ * removes observers that did not acknowledge them. The address of a
+ * removed observer is cleared so coap_observer_next_unused() can reuse it.
+ *
+ * @param engine Observe engine
+ *
+ * @return Time in milliseconds until the engine has to be processed
+ * again, or SYS_FOREVER_MS if only an update can create work.
+ */
+int32_t coap_observe_engine_process(struct coap_observe_engine *engine);
+
+/**
+ * @brief Handles an ACK or RST to a notification.
+ *
+ * @details An ACK completes the outstanding confirmable notification of
+ * the observer, a RST removes the observer.
+ *
+ * @param engine Observe engine
+ * @param response Received ACK or RST
+ * @param addr Address the response was received from
+ *
+ * @return Observer the response is for, NULL if none matched.
+ */
+struct coap_observer *coap_observe_engine_response(
+	struct coap_observe_engine *engine,
+	const struct coap_packet *response,
+	const struct sockaddr *addr);
+#endif /* CONFIG_COAP_OBSERVE_ENGINE */
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * @brief CoAP packets stored in net_buf fragment chains.
+ *
+ * These functions build and parse CoAP packets directly in a chain of
+ * net_buf fragments. Received packets are parsed in place, options and
+ * payload are described by their position in the fragments instead of
+ * being copied. When building a packet, a payload fragment can be
+ * attached by reference, for example a block of a large resource
+ * wrapped with net_buf_alloc_with_data(), and the fragments can be
+ * handed to zsock_sendmsg() as an I/O vector without linearizing them.
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_COAP_BUF_H_
+#define ZEPHYR_INCLUDE_NET_COAP_BUF_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <kernel.h>
+#include <net/buf.h>
+#include <net/net_ip.h>
+#include <net/coap.h>
+
+/**
+ * @addtogroup coap COAP Library
+ * @{
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct net_pkt;
+
+/**
+ * @brief Representation of a CoAP packet in a net_buf fragment chain.
+ */
+struct coap_buf_packet {
+	struct net_buf *buf; /* Head of the fragment chain */
+	k_timeout_t timeout; /* Timeout for allocating new fragments */
+	struct net_buf *opt_frag; /* Fragment of the first option byte */
+	struct net_buf *payload_frag; /* Fragment of the first payload byte */
+	uint16_t opt_offset; /* Offset of the options in opt_frag */
+	uint16_t opt_len; /* Total options length (delta + len + value) */
+	uint16_t payload_offset; /* Offset of the payload in payload_frag */
+	uint16_t payload_len; /* Total payload length */
+	uint16_t delta; /* Used for delta calculation in CoAP packet */
+	uint8_t hdr_len; /* CoAP header length */
+	uint8_t hdr[4 + COAP_TOKEN_MAX_LEN]; /* Copy of the header and token */
+	bool payload_ref; /* Payload fragments are attached by reference */
+};
+
+/**
+ * @brief Option found in a #coap_buf_packet, the value is not copied.
+ */
+struct coap_buf_option {
+	struct net_buf *frag; /* Fragment of the first value byte */
+	uint16_t offset; /* Offset of the value in frag */
+	uint16_t delta; /* Option number */
+	uint16_t len; /* Value length */
+};
+
+/**
+ * @brief Parses the CoAP packet stored in a fragment chain.
+ *
+ * @details The packet is validated but nothing is copied except the
+ * header. @a buf must remain valid while @a cpkt is used.
+ *
+ * @param cpkt Packet to be initialized from @a buf.
+ * @param buf Fragment chain, the CoAP packet starts at the first byte
+ * of its data.
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_buf_packet_parse(struct coap_buf_packet *cpkt, struct net_buf *buf);
+
+/**
+ * @brief Parses the CoAP packet at the cursor of a network packet.
+ *
+ * @details This is meant for net_context receive callbacks where the
+ * cursor of @a pkt has been moved past the UDP header. The cursor is
+ * not modified. @a pkt must remain valid while @a cpkt is used.
+ *
+ * @param cpkt Packet to be initialized from @a pkt.
+ * @param pkt Network packet holding a CoAP packet at its cursor.
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_buf_packet_parse_pkt(struct coap_buf_packet *cpkt,
+			      struct net_pkt *pkt);
+
+/**
+ * @brief Creates a new CoAP packet in a fragment chain.
+ *
+ * @details The header is appended to @a buf. New fragments are
+ * allocated from the pool of @a buf when the chain runs out of room.
+ *
+ * @param cpkt New packet to be initialized.
+ * @param buf Fragment that will hold the start of the packet, the data
+ * is appended after its current content.
+ * @param timeout Timeout for allocating new fragments
+ * @param ver CoAP header version
+ * @param type CoAP header type
+ * @param token_len CoAP header token length
+ * @param token CoAP header token
+ * @param code CoAP header code
+ * @param id CoAP header message id
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_buf_packet_init(struct coap_buf_packet *cpkt, struct net_buf *buf,
+			 k_timeout_t timeout, uint8_t ver, uint8_t type,
+			 uint8_t token_len, const uint8_t *token,
+			 uint8_t code, uint16_t id);
+
+/**
+ * @brief Appends an option to the packet.
+ *
+ * @details Options must be appended in ascending order of their number.
+ *
+ * @param cpkt Packet to be updated
+ * @param code Option code to add to the packet, see #coap_option_num
+ * @param value Pointer to the value of the option, will be copied to
+ * the packet
+ * @param len Size of the data to be added
+ *
+ * @return 0 in case of success, -ENOMEM if a fragment could not be
+ * allocated or other negative in case of error.
+ */
+int coap_buf_packet_append_option(struct coap_buf_packet *cpkt, uint16_t code,
+				  const uint8_t *value, uint16_t len);
+
+/**
+ * @brief Appends an integer value option to the packet.
+ *
+ * @param cpkt Packet to be updated
+ * @param code Option code to add to the packet, see #coap_option_num
+ * @param val Integer value to be added
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_buf_append_option_int(struct coap_buf_packet *cpkt, uint16_t code,
+			       unsigned int val);
+
+/**
+ * @brief Append payload marker to the packet.
+ *
+ * @param cpkt Packet to append the payload marker (0xFF)
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_buf_packet_append_payload_marker(struct coap_buf_packet *cpkt);
+
+/**
+ * @brief Copies payload data to the packet.
+ *
+ * @param cpkt Packet to append the payload
+ * @param payload CoAP packet payload
+ * @param payload_len CoAP packet payload len
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_buf_packet_append_payload(struct coap_buf_packet *cpkt,
+				   const uint8_t *payload,
+				   uint16_t payload_len);
+
+/**
+ * @brief Attaches payload fragments to the packet without copying them.
+ *
+ * @details The packet takes over the reference to @a frag, use
+ * net_buf_ref() to keep it. Nothing can be appended to the packet
+ * afterwards.
+ *
+ * @param cpkt Packet to append the payload
+ * @param frag Fragment chain holding the payload
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_buf_packet_append_payload_frag(struct coap_buf_packet *cpkt,
+					struct net_buf *frag);
+
+/**
+ * @brief Returns the total length of the packet.
+ *
+ * @param cpkt CoAP packet representation
+ *
+ * @return Length of the packet in bytes.
+ */
+size_t coap_buf_packet_len(const struct coap_buf_packet *cpkt);
+
+/**
+ * @brief Describes the packet fragments as an I/O vector, e.g. for
+ * zsock_sendmsg().
+ *
+ * @param cpkt CoAP packet representation
+ * @param iov Array of I/O vector entries to fill
+ * @param iovlen Number of entries in @a iov
+ *
+ * @return Number of entries used or -ENOBUFS if @a iov is too short.
+ */
+int coap_buf_packet_to_iovec(const struct coap_buf_packet *cpkt,
+			     struct iovec *iov, size_t iovlen);
+
+/**
+ * @brief Returns the packet header type.
+ *
+ * @param cpkt CoAP packet representation
+ *
+ * @return The type of the packet
+ */
+uint8_t coap_buf_header_get_type(const struct coap_buf_packet *cpkt);
+
+/**
+ * @brief Returns the packet header code.
+ *
+ * @param cpkt CoAP packet representation
+ *
+ * @return The code of the packet
+ */
+uint8_t coap_buf_header_get_code(const struct coap_buf_packet *cpkt);
+
+/**
+ * @brief Returns the packet message id.
+ *
+ * @param cpkt CoAP packet representation
+ *
+ * @return The message id of the packet
+ */
+uint16_t coap_buf_header_get_id(const struct coap_buf_packet *cpkt);
+
+/**
+ * @brief Returns the packet token.
+ *
+ * @param cpkt CoAP packet representation
+ * @param token Where to store the token, must point to a buffer
+ *              of at least COAP_TOKEN_MAX_LEN bytes
+ *
+ * @return Token length in the CoAP packet (0 - COAP_TOKEN_MAX_LEN).
+ */
+uint8_t coap_buf_header_get_token(const struct coap_buf_packet *cpkt,
+				  uint8_t *token);
+
+/**
+ * @brief Return the options with the number @a code, in place.
+ *
+ * @param cpkt CoAP packet representation
+ * @param code Option number to look for
+ * @param options Array of #coap_buf_option where to store the
+ * position of the options found
+ * @param veclen Number of elements in the options array
+ *
+ * @return The number of options found in packet matching code,
+ * negative on error.
+ */
+int coap_buf_find_options(const struct coap_buf_packet *cpkt, uint16_t code,
+			  struct coap_buf_option *options, uint16_t veclen);
+
+/**
+ * @brief Get the value of an integer option.
+ *
+ * @param cpkt CoAP packet representation
+ * @param code Option number to look for
+ *
+ * @return The integer value of the option, negative if the option
+ * is not present.
+ */
+int coap_buf_get_option_int(const struct coap_buf_packet *cpkt,
+			    uint16_t code);
+
+/**
+ * @brief Returns a pointer to the option value if it is contiguous.
+ *
+ * @param option Option found with coap_buf_find_options()
+ *
+ * @return Pointer to the value or NULL if the value spans fragments.
+ */
+const uint8_t *coap_buf_option_value(const struct coap_buf_option *option);
+
+/**
+ * @brief Copies the option value.
+ *
+ * @param option Option found with coap_buf_find_options()
+ * @param dst Where to store the value
+ * @param len Size of @a dst
+ *
+ * @return Length of the value or -EINVAL if @a dst is too small.
+ */
+int coap_buf_option_read(const struct coap_buf_option *option,
+			 uint8_t *dst, uint16_t len);
+
+/**
+ * @brief Converts an option to its integer representation.
+ *
+ * @param option Option found with coap_buf_find_options()
+ *
+ * @return The integer representation of the option, 0 if the value
+ * is longer than 4 bytes.
+ */
+unsigned int coap_buf_option_value_to_int(
+	const struct coap_buf_option *option);
+
+/**
+ * @brief Returns the position of the payload.
+ *
+ * @param cpkt CoAP packet representation
+ * @param offset Offset of the payload in the returned fragment
+ * @param len Total length of the payload, which may continue in the
+ * following fragments
+ *
+ * @return Fragment holding the first payload byte or NULL and @a len
+ * set to 0 if there is no payload.
+ */
+struct net_buf *coap_buf_packet_get_payload(const struct coap_buf_packet *cpkt,
+					    uint16_t *offset, uint16_t *len);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_COAP_BUF_H_ */
@@ -0,0 +1,293 @@
+/** @file
+ * @brief HTTP server API
+ *
+ * An API for applications to serve HTTP/1.1 requests
+ */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_
+#define ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_
+
+/**
+ * @brief HTTP server API
+ * @defgroup http_server HTTP server API
+ * @ingroup networking
+ * @{
+ */
+
+#include <kernel.h>
+#include <net/net_ip.h>
+#include <net/socket.h>
+#include <net/http_parser.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if !defined(HTTP_CRLF)
+#define HTTP_CRLF "\r\n"
+#endif
+
+/** Length of a response with no known length, sent chunked. */
+#define HTTP_SERVER_CHUNKED -1
+
+/** Method mask bit of an HTTP method, see http_resource.methods */
+#define HTTP_METHOD_BIT(method) BIT64(method)
+
+struct http_server_conn;
+
+/** Request events delivered to a resource handler, in this order. */
+enum http_server_event {
+	/** Request line and headers were received. The method, the URL
+	 * and the content length are known.
+	 */
+	HTTP_SERVER_REQ_HEADERS,
+
+	/** Part of the request body, chunked encoding already removed.
+	 * Called as the data is received, the body is never buffered.
+	 */
+	HTTP_SERVER_REQ_BODY,
+
+	/** The request is complete. The handler shall respond to the
+	 * request, unless it already did.
+	 */
+	HTTP_SERVER_REQ_END,
+};
+
+/**
+ * @typedef http_resource_cb_t
+ * @brief Callback handling the requests of a resource.
+ *
+ * The response may be started at any event, and the request body is
+ * still delivered afterwards. A response not ended by the handler at
+ * HTTP_SERVER_REQ_END is ended by the server, and a response not started
+ * is answered with 500 Internal Server Error.
+ *
+ * @param conn Connection the request was received on
+ * @param evt Request event
+ * @param data Body data for HTTP_SERVER_REQ_BODY, NULL otherwise
+ * @param len Length of the body data
+ * @param user_data User data of the resource
+ *
+ * @return 0 on success, <0 to close the connection.
+ */
+typedef int (*http_resource_cb_t)(struct http_server_conn *conn,
+				  enum http_server_event evt,
+				  const uint8_t *data, size_t len,
+				  void *user_data);
+
+/**
+ * HTTP server resource. Resources are provided to the server as a
+ * constant table.
+ */
+struct http_resource {
+	/** Path of the resource, for example "/index.html". A path ending
+	 * with '*' matches any URL starting with the characters before it.
+	 * The query string is not part of the matched path.
+	 */
+	const char *path;
+
+	/** Mask of the HTTP_METHOD_BIT() of the methods accepted. Other
+	 * methods are answered with 405 Method Not Allowed.
+	 */
+	uint64_t methods;
+
+	/** Handler of the requests */
+	http_resource_cb_t cb;
+
+	/** User data passed to the handler */
+	void *user_data;
+};
+
+/**
+ * HTTP server connection. The application may read the request fields
+ * from the handler, the other fields are internal.
+ */
+struct http_server_conn {
+	/** Request URL, NUL terminated */
+	char url[CONFIG_HTTP_SERVER_MAX_URL_LENGTH];
+
+	/** Request method, see enum http_method */
+	enum http_method method;
+
+	/** Request Content-Length, 0 if absent or chunked */
+	uint64_t content_length;
+
+	/** HTTP parser context */
+	struct http_parser parser;
+
+	/** Server the connection belongs to */
+	struct http_server_ctx *ctx;
+
+	/** Resource of the request being received, NULL if none */
+	const struct http_resource *resource;
+
+	/** Uptime of the last data received, for the idle timeout */
+	int64_t last_activity;
+
+	/** Connection socket, -1 if the connection is unused */
+	int sock;
+
+	/** Length of the URL received so far */
+	uint16_t url_len;
+
+	/** Status of the error response to send, 0 if none */
+	uint16_t error_status;
+
+	/** The connection is kept after the response */
+	uint8_t keep_alive : 1;
+
+	/** The connection is closed once the response is sent */
+	uint8_t close : 1;
+
+	/** The response was started */
+	uint8_t response_started : 1;
+
+	/** The response was ended */
+	uint8_t response_ended : 1;
+
+	/** The response body is sent with chunked encoding */
+	uint8_t response_chunked : 1;
+
+	/** The response has no body, for HEAD requests */
+	uint8_t response_no_body : 1;
+};
+
+/** HTTP server context. */
+struct http_server_ctx {
+	/** Connections */
+	struct http_server_conn conns[CONFIG_HTTP_SERVER_MAX_CLIENTS];
+
+	/** Poll descriptors, listening socket first */
+	struct zsock_pollfd fds[CONFIG_HTTP_SERVER_MAX_CLIENTS + 1];
+
+	/** HTTP parser settings shared by the connections */
+	struct http_parser_settings parser_settings;
+
+	/** Resource table */
+	const struct http_resource *resources;
+
+	/** Number of resources */
+	size_t resource_count;
+
+	/** Receive buffer, shared by the connections as received data is
+	 * processed right away.
+	 */
+	uint8_t recv_buf[CONFIG_HTTP_SERVER_RECV_BUF_SIZE];
+
+	/** Listening socket */
+	int listen_sock;
+};
+
+/**
+ * @brief Initialize an HTTP server and start listening.
+ *
+ * @param ctx HTTP server context
+ * @param addr Local address and port to listen on
+ * @param addrlen Length of the address
+ * @param resources Resource table, kept by the server
+ * @param resource_count Number of resources
+ *
+ * @return 0 on success, <0 if error
+ */
+int http_server_init(struct http_server_ctx *ctx,
+		     const struct sockaddr *addr, socklen_t addrlen,
+		     const struct http_resource *resources,
+		     size_t resource_count);
+
+/**
+ * @brief Wait for and process the events of all the connections once.
+ *
+ * New connections are accepted, received requests are delivered to the
+ * resource handlers and idle connections are closed.
+ *
+ * @param ctx HTTP server context
+ * @param timeout Time to wait for an event, in milliseconds, or -1 to
+ *        wait forever.
+ *
+ * @return 0 on success, <0 if error
+ */
+int http_server_poll(struct http_server_ctx *ctx, int timeout);
+
+/**
+ * @brief Serve requests until an error occurs.
+ *
+ * @param ctx HTTP server context
+ *
+ * @return <0 error which stopped the server
+ */
+int http_server_run(struct http_server_ctx *ctx);
+
+/**
+ * @brief Close all the connections and the listening socket.
+ *
+ * @param ctx HTTP server context
+ */
+void http_server_close(struct http_server_ctx *ctx);
+
+/**
+ * @brief Start the response to the current request.
+ *
+ * @param conn Connection of the request
+ * @param status HTTP status code, for example 200
+ * @param content_type Value of the Content-Type header, may be NULL
+ * @param content_length Length of the body, or HTTP_SERVER_CHUNKED if
+ *        unknown. A body of unknown length is sent with chunked encoding,
+ *        or delimited by closing the connection for HTTP/1.0 clients.
+ *
+ * @return 0 on success, <0 if error
+ */
+int http_server_response_begin(struct http_server_conn *conn, uint16_t status,
+			       const char *content_type,
+			       ssize_t content_length);
+
+/**
+ * @brief Send part of the response body.
+ *
+ * @param conn Connection of the request
+ * @param data Body data
+ * @param len Length of the data. 0 is ignored.
+ *
+ * @return 0 on success, <0 if error
+ */
+int http_server_response_send(struct http_server_conn *conn,
+			      const void *data, size_t len);
+
+/**
+ * @brief End the response to the current request.
+ *
+ * @param conn Connection of the request
+ *
+ * @return 0 on success, <0 if error
+ */
+int http_server_response_end(struct http_server_conn *conn);
+
+/**
+ * @brief Send a complete response with the given body.
+ *
+ * @param conn Connection of the request
+ * @param status HTTP status code
+ * @param content_type Value of the Content-Type header, may be NULL
+ * @param body Response body, may be NULL if len is 0
+ * @param len Length of the body
+ *
+ * @return 0 on success, <0 if error
+ */
+int http_server_response(struct http_server_conn *conn, uint16_t status,
+			 const char *content_type, const void *body,
+			 size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_ */
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Loopback network interface test helpers
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_LOOPBACK_H_
+#define ZEPHYR_INCLUDE_NET_LOOPBACK_H_
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Loopback network interface test helpers
+ * @defgroup loopback Loopback Network Interface
+ * @ingroup networking
+ * @{
+ */
+
+#if defined(CONFIG_NET_LOOPBACK_SIMULATE_PACKET_DROP)
+/**
+ * @brief Set the ratio of packets the loopback interface drops.
+ *
+ * The drop pattern is deterministic so that the tests are repeatable,
+ * for example a ratio of 0.1 drops every tenth packet.
+ *
+ * @param ratio Value between 0 (no drops) and 1 (drop everything).
+ *
+ * @return 0 if ok, <0 if error
+ */
+int loopback_set_packet_drop_ratio(float ratio);
+
+/**
+ * @brief Get the number of packets dropped by the loopback interface.
+ *
+ * @return Number of packets dropped since boot.
+ */
+int loopback_get_num_dropped_packets(void);
+#endif
+
+#if defined(CONFIG_NET_LOOPBACK_SIMULATE_PACKET_DELAY)
+/**
+ * @brief Set the one way delay that the loopback interface adds to each
+ * packet.
+ *
+ * @param delay_ms Delay in milliseconds, 0 delivers packets immediately.
+ *
+ * @return 0 if ok, <0 if error
+ */
+int loopback_set_packet_delay(uint32_t delay_ms);
+#endif
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_NET_LOOPBACK_H_ */
@@ -687,6 +687,343 @@ int lwm2m_engine_get_float64(char *pathstr, float64_value_t *buf);
  */
 int lwm2m_engine_get_objlnk(char *pathstr, struct lwm2m_objlnk *buf);
 
+/**
+ * @brief Resolved LwM2M resource instance
+ *
+ * Filled in by lwm2m_engine_get_res_handle(), the members are private to
+ * the LwM2M engine. A handle stays valid until its object instance or
+ * resource instance is deleted, after which the handle functions return
+ * -ENOENT.
+ */
+struct lwm2m_res_handle {
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_res *res;
+	struct lwm2m_engine_res_inst *res_inst;
+	uint16_t obj_id;
+	uint16_t obj_inst_id;
+	uint16_t res_id;
+	uint16_t res_inst_id;
+};
+
+/**
+ * @brief Resolve a resource (instance) path into a handle
+ *
+ * The lwm2m_engine_handle_set_*() and lwm2m_engine_handle_get_*()
+ * functions access the resource through the handle without parsing the
+ * path and looking up the object instance again, which suits resources
+ * updated at a high rate. Observers are notified as with the path based
+ * functions.
+ *
+ * @param[in] pathstr LwM2M path string "obj/obj-inst/res(/res-inst)"
+ * @param[out] handle Handle to fill in
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_get_res_handle(char *pathstr, struct lwm2m_res_handle *handle);
+
+/**
+ * @brief Set resource (instance) value (opaque buffer) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[in] data_ptr Data buffer
+ * @param[in] data_len Length of buffer
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_set_opaque(struct lwm2m_res_handle *handle,
+				   char *data_ptr, uint16_t data_len);
+
+/**
+ * @brief Set resource (instance) value (string) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[in] data_ptr NULL terminated char buffer
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_set_string(struct lwm2m_res_handle *handle,
+				   char *data_ptr);
+
+/**
+ * @brief Set resource (instance) value (u8) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[in] value u8 value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_set_u8(struct lwm2m_res_handle *handle, uint8_t value);
+
+/**
+ * @brief Set resource (instance) value (u16) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[in] value u16 value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_set_u16(struct lwm2m_res_handle *handle,
+				uint16_t value);
+
+/**
+ * @brief Set resource (instance) value (u32) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[in] value u32 value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_set_u32(struct lwm2m_res_handle *handle,
+				uint32_t value);
+
+/**
+ * @brief Set resource (instance) value (u64) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[in] value u64 value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_set_u64(struct lwm2m_res_handle *handle,
+				uint64_t value);
+
+/**
+ * @brief Set resource (instance) value (s8) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[in] value s8 value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_set_s8(struct lwm2m_res_handle *handle, int8_t value);
+
+/**
+ * @brief Set resource (instance) value (s16) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[in] value s16 value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_set_s16(struct lwm2m_res_handle *handle, int16_t value);
+
+/**
+ * @brief Set resource (instance) value (s32) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[in] value s32 value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_set_s32(struct lwm2m_res_handle *handle, int32_t value);
+
+/**
+ * @brief Set resource (instance) value (s64) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[in] value s64 value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_set_s64(struct lwm2m_res_handle *handle, int64_t value);
+
+/**
+ * @brief Set resource (instance) value (bool) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[in] value bool value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_set_bool(struct lwm2m_res_handle *handle, bool value);
+
+/**
+ * @brief Set resource (instance) value (32-bit float structure) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[in] value 32-bit float value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_set_float32(struct lwm2m_res_handle *handle,
+				    float32_value_t *value);
+
+/**
+ * @brief Set resource (instance) value (64-bit float structure) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[in] value 64-bit float value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_set_float64(struct lwm2m_res_handle *handle,
+				    float64_value_t *value);
+
+/**
+ * @brief Set resource (instance) value (ObjLnk) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[in] value pointer to the lwm2m_objlnk structure
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_set_objlnk(struct lwm2m_res_handle *handle,
+				   struct lwm2m_objlnk *value);
+
+/**
+ * @brief Get resource (instance) value (opaque buffer) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[out] buf Data buffer to copy data into
+ * @param[in] buflen Length of buffer
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_get_opaque(struct lwm2m_res_handle *handle,
+				   void *buf, uint16_t buflen);
+
+/**
+ * @brief Get resource (instance) value (string) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[out] str String buffer to copy data into
+ * @param[in] strlen Length of buffer
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_get_string(struct lwm2m_res_handle *handle,
+				   void *str, uint16_t strlen);
+
+/**
+ * @brief Get resource (instance) value (u8) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[out] value u8 buffer to copy data into
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_get_u8(struct lwm2m_res_handle *handle, uint8_t *value);
+
+/**
+ * @brief Get resource (instance) value (u16) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[out] value u16 buffer to copy data into
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_get_u16(struct lwm2m_res_handle *handle,
+				uint16_t *value);
+
+/**
+ * @brief Get resource (instance) value (u32) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[out] value u32 buffer to copy data into
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_get_u32(struct lwm2m_res_handle *handle,
+				uint32_t *value);
+
+/**
+ * @brief Get resource (instance) value (u64) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[out] value u64 buffer to copy data into
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_get_u64(struct lwm2m_res_handle *handle,
+				uint64_t *value);
+
+/**
+ * @brief Get resource (instance) value (s8) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[out] value s8 buffer to copy data into
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_get_s8(struct lwm2m_res_handle *handle, int8_t *value);
+
+/**
+ * @brief Get resource (instance) value (s16) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[out] value s16 buffer to copy data into
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_get_s16(struct lwm2m_res_handle *handle,
+				int16_t *value);
+
+/**
+ * @brief Get resource (instance) value (s32) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[out] value s32 buffer to copy data into
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_get_s32(struct lwm2m_res_handle *handle,
+				int32_t *value);
+
+/**
+ * @brief Get resource (instance) value (s64) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[out] value s64 buffer to copy data into
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_get_s64(struct lwm2m_res_handle *handle,
+				int64_t *value);
+
+/**
+ * @brief Get resource (instance) value (bool) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[out] value bool buffer to copy data into
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_get_bool(struct lwm2m_res_handle *handle, bool *value);
+
+/**
+ * @brief Get resource (instance) value (32-bit float structure) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[out] buf 32-bit float buffer to copy data into
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_get_float32(struct lwm2m_res_handle *handle,
+				    float32_value_t *buf);
+
+/**
+ * @brief Get resource (instance) value (64-bit float structure) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[out] buf 64-bit float buffer to copy data into
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_get_float64(struct lwm2m_res_handle *handle,
+				    float64_value_t *buf);
+
+/**
+ * @brief Get resource (instance) value (ObjLnk) via handle
+ *
+ * @param[in] handle Handle from lwm2m_engine_get_res_handle()
+ * @param[out] buf lwm2m_objlnk buffer to copy data into
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_handle_get_objlnk(struct lwm2m_res_handle *handle,
+				   struct lwm2m_objlnk *buf);
+
 
 /**
  * @brief Set resource (instance) read callback
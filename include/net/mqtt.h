@@ -84,7 +84,10 @@ enum mqtt_evt_type {
 /** @brief MQTT version protocol level. */
 enum mqtt_version {
 	MQTT_VERSION_3_1_0 = 3, /**< Protocol level for 3.1.0. */
-	MQTT_VERSION_3_1_1 = 4  /**< Protocol level for 3.1.1. */
+	MQTT_VERSION_3_1_1 = 4, /**< Protocol level for 3.1.1. */
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	MQTT_VERSION_5_0 = 5    /**< Protocol level for 5.0. */
+#endif
 };
 
 /** @brief MQTT Quality of Service types. */
@@ -201,28 +204,85 @@ struct mqtt_connack_param {
 
 	/** The appropriate non-zero Connect return code indicates if the Server
 	 *  is unable to process a connection request for some reason.
+	 *  With MQTT 5.0 this is the Connect Reason Code, 0x80 or above on
+	 *  failure.
 	 */
 	enum mqtt_conn_return_code return_code;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 Session Expiry Interval in seconds, the one requested
+	 *  unless the server changed it.
+	 */
+	uint32_t session_expiry_interval;
+
+	/** MQTT 5.0 Receive Maximum of the server, the number of QoS 1 and
+	 *  QoS 2 messages it processes concurrently.
+	 */
+	uint16_t receive_maximum;
+
+	/** MQTT 5.0 Topic Alias Maximum of the server, 0 if the server
+	 *  accepts no topic alias.
+	 */
+	uint16_t topic_alias_maximum;
+
+	/** MQTT 5.0 Maximum QoS supported by the server. */
+	uint8_t maximum_qos;
+
+	/** MQTT 5.0 Retain Available, 0 if the server does not support
+	 *  retained messages.
+	 */
+	uint8_t retain_available;
+
+	/** MQTT 5.0 Maximum Packet Size accepted by the server, 0 if not
+	 *  limited.
+	 */
+	uint32_t maximum_packet_size;
+
+	/** MQTT 5.0 Client Identifier assigned by the server when an empty
+	 *  one was sent. Size is 0 if none.
+	 */
+	struct mqtt_utf8 assigned_client_id;
+#endif /* CONFIG_MQTT_VERSION_5_0 */
 };
 
 /** @brief Parameters for MQTT publish acknowledgment (PUBACK). */
 struct mqtt_puback_param {
 	uint16_t message_id;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 Reason Code, 0 on success. */
+	uint8_t reason_code;
+#endif
 };
 
 /** @brief Parameters for MQTT publish receive (PUBREC). */
 struct mqtt_pubrec_param {
 	uint16_t message_id;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 Reason Code, 0 on success. */
+	uint8_t reason_code;
+#endif
 };
 
 /** @brief Parameters for MQTT publish release (PUBREL). */
 struct mqtt_pubrel_param {
 	uint16_t message_id;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 Reason Code, 0 on success. */
+	uint8_t reason_code;
+#endif
 };
 
 /** @brief Parameters for MQTT publish complete (PUBCOMP). */
 struct mqtt_pubcomp_param {
 	uint16_t message_id;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 Reason Code, 0 on success. */
+	uint8_t reason_code;
+#endif
 };
 
 /** @brief Parameters for MQTT subscription acknowledgment (SUBACK). */
@@ -234,6 +294,11 @@ struct mqtt_suback_param {
 /** @brief Parameters for MQTT unsubscribe acknowledgment (UNSUBACK). */
 struct mqtt_unsuback_param {
 	uint16_t message_id;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 Reason Codes, one for each topic unsubscribed. */
+	struct mqtt_binstr reason_codes;
+#endif
 };
 
 /** @brief Parameters for a publish message. */
@@ -255,6 +320,25 @@ struct mqtt_publish_param {
 	 *  by the broker.
 	 */
 	uint8_t retain_flag : 1;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 Payload Format Indicator, 1 if the payload is UTF-8
+	 *  encoded character data.
+	 */
+	uint8_t payload_format_indicator : 1;
+
+	/** MQTT 5.0 Message Expiry Interval in seconds, 0 if the message
+	 *  does not expire.
+	 */
+	uint32_t message_expiry_interval;
+
+	/** MQTT 5.0 Topic Alias the message was received with, 0 if none.
+	 *  The topic is always provided, aliases are resolved by the
+	 *  library. Ignored when publishing, aliases are then assigned by
+	 *  the library.
+	 */
+	uint16_t topic_alias;
+#endif /* CONFIG_MQTT_VERSION_5_0 */
 };
 
 /** @brief List of topics in a subscription request. */
@@ -432,6 +516,17 @@ struct mqtt_transport {
 #endif
 };
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/** @brief MQTT 5.0 topic alias, internal. */
+struct mqtt_topic_alias {
+	/** Length of the topic, 0 if the alias is not set. */
+	uint16_t len;
+
+	/** Topic the alias stands for. */
+	uint8_t topic[CONFIG_MQTT_TOPIC_ALIAS_TOPIC_LEN];
+};
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 /** @brief MQTT internal state. */
 struct mqtt_internal {
 	/** Internal. Mutex to protect access to the client instance. */
@@ -450,6 +545,49 @@ struct mqtt_internal {
 
 	/** Internal. Remaining payload length to read. */
 	uint32_t remaining_payload;
+
+#if defined(CONFIG_MQTT_LIB_MSG_STORE)
+	/** Internal. Length of the message store in use. */
+	uint32_t msg_store_len;
+
+	/** Internal. Number of messages awaiting acknowledgment. */
+	uint8_t msg_store_count;
+#endif /* CONFIG_MQTT_LIB_MSG_STORE */
+
+#if defined(CONFIG_MQTT_LIB_TX_BATCH)
+	/** Internal. Publish messages are batched. */
+	bool batching;
+
+	/** Internal. Number of batch_iov entries in use. */
+	uint8_t batch_iovcnt;
+
+	/** Internal. Length of the transmit buffer holding batched
+	 *  headers.
+	 */
+	uint32_t batch_len;
+
+	/** Internal. Headers and payloads of the batched messages. */
+	struct iovec batch_iov[2 * CONFIG_MQTT_LIB_TX_BATCH_MAX_MSGS];
+#endif /* CONFIG_MQTT_LIB_TX_BATCH */
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** Internal. Receive Maximum of the server. */
+	uint16_t receive_maximum;
+
+	/** Internal. QoS 1 and QoS 2 messages which can still be sent
+	 *  before an acknowledgment is received.
+	 */
+	uint16_t send_quota;
+
+	/** Internal. Topic Alias Maximum of the server. */
+	uint16_t topic_alias_maximum;
+
+	/** Internal. Topics of the aliases sent to the server. */
+	struct mqtt_topic_alias tx_alias[CONFIG_MQTT_TOPIC_ALIAS_MAX];
+
+	/** Internal. Topics of the aliases received from the server. */
+	struct mqtt_topic_alias rx_alias[CONFIG_MQTT_TOPIC_ALIAS_MAX];
+#endif /* CONFIG_MQTT_VERSION_5_0 */
 };
 
 /**
@@ -506,6 +644,30 @@ struct mqtt_client {
 	/** Size of transmit buffer. */
 	uint32_t tx_buf_size;
 
+#if defined(CONFIG_MQTT_LIB_MSG_STORE)
+	/** Buffer keeping QoS 1 and QoS 2 messages until they are
+	 *  acknowledged, so they can be sent again after reconnecting.
+	 *  NULL disables the store. The buffer shall be kept between
+	 *  connections.
+	 */
+	uint8_t *msg_store_buf;
+
+	/** Size of message store buffer. */
+	uint32_t msg_store_buf_size;
+#endif /* CONFIG_MQTT_LIB_MSG_STORE */
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 Session Expiry Interval in seconds. 0 ends the session
+	 *  when the connection is closed, 0xFFFFFFFF keeps it forever.
+	 */
+	uint32_t session_expiry_interval;
+
+	/** MQTT 5.0 Receive Maximum, the number of QoS 1 and QoS 2 messages
+	 *  the client processes concurrently. 0 sends no limit.
+	 */
+	uint16_t receive_maximum;
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 	/** Keepalive interval for this client in seconds.
 	 *  Default is CONFIG_MQTT_KEEPALIVE.
 	 */
@@ -584,11 +746,65 @@ int mqtt_connect(struct mqtt_client *client);
  * @param[in] param Parameters to be used for the publish message.
  *                  Shall not be NULL.
  *
+ * @note With CONFIG_MQTT_LIB_MSG_STORE and a message store buffer, QoS 1
+ *       and QoS 2 messages are copied to the store until acknowledged,
+ *       and -ENOBUFS is returned when the store is full. The application
+ *       should then wait for acknowledgments before publishing again,
+ *       see mqtt_inflight_count().
+ *
+ * @note With MQTT 5.0, -ENOBUFS is also returned for QoS 1 and QoS 2
+ *       messages while the Receive Maximum of the server is reached.
+ *       Topic aliases are assigned to the topics published, up to the
+ *       Topic Alias Maximum of the server.
+ *
  * @return 0 or a negative error code (errno.h) indicating reason of failure.
  */
 int mqtt_publish(struct mqtt_client *client,
 		 const struct mqtt_publish_param *param);
 
+#if defined(CONFIG_MQTT_LIB_TX_BATCH)
+/**
+ * @brief API to start batching publish messages.
+ *
+ * @details Until mqtt_publish_batch_end() is called, mqtt_publish() only
+ *          encodes the messages and they are written to the transport
+ *          together, with a single call, once the batch is full or ended.
+ *          Other packets are written immediately.
+ *
+ * @param[in] client Client instance for which the procedure is requested.
+ *                   Shall not be NULL.
+ *
+ * @note The payload of the messages is not copied, it shall remain valid
+ *       until the batch is written.
+ *
+ * @return 0 or a negative error code (errno.h) indicating reason of failure.
+ */
+int mqtt_publish_batch_begin(struct mqtt_client *client);
+
+/**
+ * @brief API to write the batched publish messages and stop batching.
+ *
+ * @param[in] client Client instance for which the procedure is requested.
+ *                   Shall not be NULL.
+ *
+ * @return 0 or a negative error code (errno.h) indicating reason of failure.
+ */
+int mqtt_publish_batch_end(struct mqtt_client *client);
+#endif /* CONFIG_MQTT_LIB_TX_BATCH */
+
+#if defined(CONFIG_MQTT_LIB_MSG_STORE)
+/**
+ * @brief API to get the number of messages awaiting acknowledgment.
+ *
+ * @param[in] client Client instance for which the procedure is requested.
+ *                   Shall not be NULL.
+ *
+ * @return Number of QoS 1 and QoS 2 messages in the message store, or a
+ *         negative error code (errno.h) indicating reason of failure.
+ */
+int mqtt_inflight_count(const struct mqtt_client *client);
+#endif /* CONFIG_MQTT_LIB_MSG_STORE */
+
 /**
  * @brief API used by client to send acknowledgment on receiving QoS1 publish
  *        message. Should be called on reception of @ref MQTT_EVT_PUBLISH with
@@ -307,9 +307,30 @@ __net_socket struct net_context {
 #endif
 #if defined(CONFIG_NET_CONTEXT_RCVTIMEO)
 		k_timeout_t rcvtimeo;
+#endif
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+		/** Receive buffer size in bytes, 0 means no limit */
+		uint32_t rcvbuf;
+#endif
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+		/** Send buffer size in bytes, 0 means no limit */
+		uint32_t sndbuf;
 #endif
 	} options;
 
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	/** Bytes received but not yet read by the application */
+	atomic_t rcvbuf_used;
+
+	/** Datagrams dropped because the receive buffer was full */
+	uint32_t rcvbuf_drops;
+#endif
+
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+	/** Bytes passed to the stack that are not yet sent */
+	atomic_t sndbuf_used;
+#endif
+
 	/** Protocol (UDP, TCP or IEEE 802.3 protocol value) */
 	uint16_t proto;
 
@@ -1033,11 +1054,15 @@ int net_context_recv(struct net_context *context,
  * delta of -256. If a function extracts 10 bytes of the queued
  * data, it should call it with delta of 10.
  *
+ * If CONFIG_NET_CONTEXT_RCVBUF is enabled, the same calls do the
+ * receive buffer accounting of datagram contexts.
+ *
  * @param context The TCP network context to use.
  * @param delta Size, in bytes, by which to increase TCP receive
  * window (negative value to decrease).
  *
- * @return 0 if ok, < 0 if error
+ * @return 0 if ok, -ENOBUFS if a datagram does not fit into the
+ * receive buffer and should be dropped, other < 0 if error
  */
 int net_context_update_recv_wnd(struct net_context *context,
 				int32_t delta);
@@ -1048,6 +1073,9 @@ enum net_context_option {
 	NET_OPT_TXTIME		= 3,
 	NET_OPT_SOCKS5		= 4,
 	NET_OPT_RCVTIMEO        = 5,
+	NET_OPT_TCP_CONGESTION	= 6,
+	NET_OPT_RCVBUF		= 7,
+	NET_OPT_SNDBUF		= 8,
 };
 
 /**
@@ -112,6 +112,25 @@ enum net_verdict {
  */
 int net_recv_data(struct net_if *iface, struct net_pkt *pkt);
 
+/**
+ * @brief Called by network device driver when several network packets have
+ * been received at once, for example when draining a DMA ring. The
+ * packets are pushed up in the network stack in the given order.
+ *
+ * With CONFIG_NET_RX_BATCH the Rx thread is woken up only once for the
+ * whole batch. Without it this is the same as calling net_recv_data()
+ * for each packet.
+ *
+ * @param iface Network interface where the packets were received.
+ * @param pkts Array of network packets.
+ * @param count Number of packets in the array.
+ *
+ * @return Number of packets queued, the caller still owns the packets
+ * that were not queued, or <0 if error.
+ */
+int net_recv_data_batch(struct net_if *iface, struct net_pkt **pkts,
+			size_t count);
+
 /**
  * @brief Send data to network.
  *
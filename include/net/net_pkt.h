@@ -71,6 +71,13 @@ struct net_pkt {
 		 * the same memory area.
 		 */
 		intptr_t sock_recv_fifo;
+#if defined(CONFIG_NET_TX_FQ_CODEL)
+		/** Tx flow queue linkage. It only overlaps the k_queue
+		 * word of the k_work which is unused until the packet
+		 * leaves the flow queue.
+		 */
+		sys_snode_t fq_node;
+#endif
 	};
 
 	/** Slab pointer from where it belongs to */
@@ -125,6 +132,18 @@ struct net_pkt {
 	uint64_t txtime;
 #endif /* CONFIG_NET_PKT_TXTIME */
 
+#if defined(CONFIG_NET_TX_FQ_CODEL)
+	/** Time when the packet entered the Tx flow queue (in ms) */
+	uint32_t fq_time;
+#endif
+
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+	/** Bytes charged to the send buffer of the context. The packet
+	 *  holds a reference to the context while this is not 0.
+	 */
+	uint16_t sndbuf_len;
+#endif
+
 	/** Reference counter */
 	atomic_t atomic_ref;
 
@@ -823,6 +842,30 @@ static inline void net_pkt_set_txtime(struct net_pkt *pkt, uint64_t txtime)
 }
 #endif /* CONFIG_NET_PKT_TXTIME */
 
+#if defined(CONFIG_NET_TX_FQ_CODEL)
+static inline uint32_t net_pkt_fq_time(struct net_pkt *pkt)
+{
+	return pkt->fq_time;
+}
+
+static inline void net_pkt_set_fq_time(struct net_pkt *pkt, uint32_t time)
+{
+	pkt->fq_time = time;
+}
+#endif /* CONFIG_NET_TX_FQ_CODEL */
+
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+static inline uint16_t net_pkt_sndbuf_len(struct net_pkt *pkt)
+{
+	return pkt->sndbuf_len;
+}
+
+static inline void net_pkt_set_sndbuf_len(struct net_pkt *pkt, uint16_t len)
+{
+	pkt->sndbuf_len = len;
+}
+#endif /* CONFIG_NET_CONTEXT_SNDBUF */
+
 #if defined(CONFIG_NET_PKT_TXTIME_STATS_DETAIL) || \
 	defined(CONFIG_NET_PKT_RXTIME_STATS_DETAIL)
 static inline uint32_t *net_pkt_stats_tick(struct net_pkt *pkt)
@@ -259,6 +259,26 @@ struct net_stats_pm {
 	uint32_t start_time;
 };
 
+/**
+ * @brief TX flow queueing (fq_codel) statistics
+ */
+struct net_stats_fq_codel {
+	/** Packets queued to the flow queues */
+	net_stats_t enqueued;
+
+	/** Packets passed from the flow queues to the driver */
+	net_stats_t dequeued;
+
+	/** Packets dropped by CoDel because of a standing queue */
+	net_stats_t drop_codel;
+
+	/** Packets dropped because the queue limit was reached */
+	net_stats_t drop_overlimit;
+
+	/** How many times an idle flow became active */
+	net_stats_t new_flows;
+};
+
 
 /**
  * @brief All network statistics in one struct.
@@ -276,6 +296,14 @@ struct net_stats {
 	/** IP layer errors */
 	struct net_stats_ip_errors ip_errors;
 
+#if defined(CONFIG_NET_RX_BATCH)
+	/**
+	 * Number of batches of received packets processed by the Rx
+	 * thread, counted on the interface of their first packet.
+	 */
+	net_stats_t rx_batches;
+#endif
+
 #if defined(CONFIG_NET_STATISTICS_IPV6)
 	/** IPv6 statistics */
 	struct net_stats_ip ipv6;
@@ -344,6 +372,11 @@ struct net_stats {
 #if defined(CONFIG_NET_STATISTICS_POWER_MANAGEMENT)
 	struct net_stats_pm pm;
 #endif
+
+#if defined(CONFIG_NET_STATISTICS_FQ_CODEL)
+	/** TX flow queueing statistics */
+	struct net_stats_fq_codel fq_codel;
+#endif
 };
 
 /**
@@ -468,7 +501,8 @@ enum net_request_stats_cmd {
 	NET_REQUEST_STATS_CMD_GET_TCP,
 	NET_REQUEST_STATS_CMD_GET_ETHERNET,
 	NET_REQUEST_STATS_CMD_GET_PPP,
-	NET_REQUEST_STATS_CMD_GET_PM
+	NET_REQUEST_STATS_CMD_GET_PM,
+	NET_REQUEST_STATS_CMD_GET_FQ_CODEL,
 };
 
 #define NET_REQUEST_STATS_GET_ALL				\
@@ -556,6 +590,13 @@ NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PPP);
 NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PM);
 #endif /* CONFIG_NET_STATISTICS_POWER_MANAGEMENT */
 
+#if defined(CONFIG_NET_STATISTICS_FQ_CODEL)
+#define NET_REQUEST_STATS_GET_FQ_CODEL				\
+	(_NET_STATS_BASE | NET_REQUEST_STATS_CMD_GET_FQ_CODEL)
+
+NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_FQ_CODEL);
+#endif /* CONFIG_NET_STATISTICS_FQ_CODEL */
+
 /**
  * @}
  */
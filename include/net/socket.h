@@ -126,6 +126,32 @@ struct zsock_pollfd {
  *  the TLS handshake.
  */
 #define TLS_ALPN_LIST 7
+/** Socket option to enable TLS session resumption. It accepts and returns an
+ *  integer, TLS_SESSION_CACHE_ENABLED or TLS_SESSION_CACHE_DISABLED. Clients
+ *  with the cache enabled offer the session of the previous connection to
+ *  the same hostname (or peer address if hostname is not set) and sec_tag
+ *  list, servers accept resumption of the sessions they have cached or
+ *  issued a ticket for. Disabled by default.
+ *  Requires CONFIG_NET_SOCKETS_TLS_SESSION_CACHE.
+ */
+#define TLS_SESSION_CACHE 8
+/** Write-only socket option to drop all cached TLS sessions. The option
+ *  value is ignored.
+ */
+#define TLS_SESSION_CACHE_PURGE 9
+/** Read-only socket option to read the session cache statistics. It returns
+ *  a struct tls_session_cache_stats. The statistics are shared by all
+ *  sockets.
+ */
+#define TLS_SESSION_CACHE_STATS 10
+/** Socket option to serve many DTLS peers from one server socket. It
+ *  accepts and returns an integer, 1 to enable and 0 to disable. recvfrom()
+ *  returns data from any peer with the peer address, sendto() requires the
+ *  address of a peer that has finished the handshake. Must be set before
+ *  the first recvfrom() on the socket. Disabled by default.
+ *  Requires CONFIG_NET_SOCKETS_DTLS_MULTI_PEER.
+ */
+#define TLS_DTLS_MULTI_PEER 11
 
 /** @} */
 
@@ -138,6 +164,30 @@ struct zsock_pollfd {
 #define TLS_DTLS_ROLE_CLIENT 0 /**< Client role in a DTLS session. */
 #define TLS_DTLS_ROLE_SERVER 1 /**< Server role in a DTLS session. */
 
+/* Valid values for TLS_SESSION_CACHE option */
+#define TLS_SESSION_CACHE_DISABLED 0 /**< No TLS session resumption. */
+#define TLS_SESSION_CACHE_ENABLED 1  /**< TLS session resumption enabled. */
+
+/** Statistics of the TLS session cache, see TLS_SESSION_CACHE_STATS. */
+struct tls_session_cache_stats {
+	/** Client sessions stored after a handshake. */
+	uint32_t client_stored;
+	/** Client handshakes that resumed a cached session. */
+	uint32_t client_resumed;
+	/** Client handshakes that needed a full key exchange. */
+	uint32_t client_full;
+	/** Sessions stored by servers. */
+	uint32_t server_stored;
+	/** Server handshakes resumed by session ID. Ticket based
+	 *  resumption does not use the server cache.
+	 */
+	uint32_t server_hits;
+	/** Session IDs offered by clients that were not found. */
+	uint32_t server_misses;
+	/** Valid cache entries replaced to make room for new ones. */
+	uint32_t evictions;
+};
+
 struct zsock_addrinfo {
 	struct zsock_addrinfo *ai_next;
 	int ai_flags;
@@ -795,6 +845,10 @@ static inline char *inet_ntop(sa_family_t family, const void *src, char *dst,
 #define SO_REUSEADDR 2
 /** sockopt: Async error (ignored, for compatibility) */
 #define SO_ERROR 4
+/** sockopt: Size of the socket send buffer */
+#define SO_SNDBUF 7
+/** sockopt: Size of the socket receive buffer */
+#define SO_RCVBUF 8
 
 /**
  * sockopt: Receive timeout
@@ -808,6 +862,8 @@ static inline char *inet_ntop(sa_family_t family, const void *src, char *dst,
 /* Socket options for IPPROTO_TCP level */
 /** sockopt: Disable TCP buffering (ignored, for compatibility) */
 #define TCP_NODELAY 1
+/** sockopt: Name of the TCP congestion control algorithm, e.g. "cubic" */
+#define TCP_CONGESTION 13
 
 /* Socket options for IPPROTO_IPV6 level */
 /** sockopt: Don't support IPv4 access (ignored, for compatibility) */
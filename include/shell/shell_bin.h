@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SHELL_BIN_H__
+#define SHELL_BIN_H__
+
+#include <shell/shell.h>
+#include <sys/ring_buffer.h>
+#include <toolchain.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief First byte of every frame. */
+#define SHELL_BIN_SYNC 0xA5
+
+/** @brief Types of the frames of the binary shell protocol. */
+enum shell_bin_frame_type {
+	/** Command line to execute, from the host. A command line longer
+	 *  than CONFIG_SHELL_CMD_BUFF_SIZE - 1 bytes is dropped, with no
+	 *  result.
+	 */
+	SHELL_BIN_FRAME_CMD = 0x01,
+	/** Output of the command with the same sequence number. */
+	SHELL_BIN_FRAME_OUTPUT = 0x81,
+	/** Return value of the command with the same sequence number, as
+	 *  a little endian int32_t. Sent once the command completed.
+	 */
+	SHELL_BIN_FRAME_RESULT = 0x82,
+	/** Formatted log messages, with sequence number 0. */
+	SHELL_BIN_FRAME_LOG = 0x83,
+};
+
+/** @brief Header of a frame.
+ *
+ * The header is followed by the payload and by the CRC-16/XMODEM of the
+ * header, sync byte excluded, and of the payload. Multibyte fields are
+ * little endian.
+ */
+struct shell_bin_hdr {
+	uint8_t sync;
+	uint8_t type;
+	uint16_t seq;
+	uint16_t len;
+} __packed;
+
+extern const struct shell_transport_api shell_bin_transport_api;
+
+/** @brief Frame being received. */
+struct shell_bin_rx {
+	size_t len;
+	uint8_t buf[sizeof(struct shell_bin_hdr) + CONFIG_SHELL_CMD_BUFF_SIZE +
+		    sizeof(uint16_t)];
+};
+
+/** @brief Shell binary transport instance control block (RW data). */
+struct shell_bin_ctrl_blk {
+	const struct device *dev;
+	shell_transport_handler_t handler;
+	void *context;
+	struct shell_bin_rx rx;
+	/* Sequence number of the command being executed. */
+	uint16_t seq;
+	bool exec;
+	size_t tx_len;
+	uint8_t tx_buf[CONFIG_SHELL_BIN_TX_BUFFER_SIZE];
+};
+
+/** @brief Shell binary transport instance structure. */
+struct shell_bin {
+	struct shell_bin_ctrl_blk *ctrl_blk;
+	struct ring_buf *rx_ringbuf;
+};
+
+/** @brief Macro for creating shell binary transport instance. */
+#define SHELL_BIN_DEFINE(_name, _rx_ringbuf_size)			\
+	static struct shell_bin_ctrl_blk _name##_ctrl_blk;		\
+	RING_BUF_DECLARE(_name##_rx_ringbuf, _rx_ringbuf_size);		\
+	static const struct shell_bin _name##_shell_bin = {		\
+		.ctrl_blk = &_name##_ctrl_blk,				\
+		.rx_ringbuf = &_name##_rx_ringbuf,			\
+	};								\
+	struct shell_transport _name = {				\
+		.api = &shell_bin_transport_api,			\
+		.ctx = (struct shell_bin *)&_name##_shell_bin		\
+	}
+
+/**
+ * @brief This function provides pointer to shell binary backend instance.
+ *
+ * @returns Pointer to the shell instance.
+ */
+const struct shell *shell_backend_bin_get_ptr(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SHELL_BIN_H__ */
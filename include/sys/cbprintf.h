@@ -10,6 +10,7 @@
 #include <stdarg.h>
 #include <stddef.h>
 #include <toolchain.h>
+#include <sys/cbprintf_internal.h>
 
 #ifdef CONFIG_CBPRINTF_LIBC_SUBSTS
 #include <stdio.h>
@@ -100,6 +101,101 @@ int cbprintf(cbprintf_cb out, void *ctx, const char *format, ...);
  */
 int cbvprintf(cbprintf_cb out, void *ctx, const char *format, va_list ap);
 
+/** @brief Package a formatted message for later formatting.
+ *
+ * The package holds the format string pointer followed by the argument
+ * values, each stored with the size of its promoted type and without
+ * padding. The strings of the @c %s conversions are copied at the end of the
+ * package, NUL terminated and truncated to the precision given, so the
+ * package does not refer to the caller memory apart from the format string,
+ * which must stay valid until the package is formatted. Strings whose
+ * pointer lies beyond the first 255 bytes of arguments are not copied.
+ *
+ * The format string is analyzed at runtime. Positional arguments are not
+ * supported and nothing is written by the @c %n conversion.
+ *
+ * @param packaged buffer for the package, may be unaligned. If NULL, only
+ * the length of the package is computed.
+ *
+ * @param len length of the buffer.
+ *
+ * @param format a standard ISO C format string with characters and
+ * conversion specifications.
+ *
+ * @param ... arguments corresponding to the conversion specifications found
+ * within @p format.
+ *
+ * @return the length of the package in bytes, or -ENOSPC if @p len is too
+ * small.
+ */
+__printf_like(3, 4)
+int cbprintf_package(void *packaged, size_t len, const char *format, ...);
+
+/** @brief Package a formatted message for later formatting.
+ *
+ * @see cbprintf_package()
+ *
+ * @param packaged buffer for the package, may be unaligned. If NULL, only
+ * the length of the package is computed.
+ *
+ * @param len length of the buffer.
+ *
+ * @param format a standard ISO C format string with characters and
+ * conversion specifications.
+ *
+ * @param ap a reference to the values to be converted.
+ *
+ * @return the length of the package in bytes, or -ENOSPC if @p len is too
+ * small.
+ */
+int cbvprintf_package(void *packaged, size_t len, const char *format,
+		      va_list ap);
+
+/** @brief Package a formatted message, analyzing the arguments at build
+ * time.
+ *
+ * The package is the one cbprintf_package() creates, but its layout follows
+ * from the types of the arguments rather than from the format string, which
+ * is not parsed. The arguments are checked against the format string by the
+ * compiler and each argument is evaluated once.
+ *
+ * Arguments of type @c char* or @c const @c char* are taken as strings and
+ * copied in the package, whole, whatever the conversion they match. Their
+ * pointer is kept, so that a @c %p conversion prints it and a precision is
+ * applied to the copy when the package is formatted. Such an argument must
+ * therefore point to a NUL terminated string: cast a character buffer that
+ * is not to another pointer type, which is stored as a pointer and read
+ * when the package is formatted. Pointers to other character types are
+ * stored as pointers.
+ *
+ * @param packaged buffer for the package, may be unaligned. If NULL, only
+ * the length of the package is computed.
+ *
+ * @param inlen length of the buffer.
+ *
+ * @param outlen variable set to the length of the package in bytes, or to
+ * -ENOSPC if @p inlen is too small.
+ *
+ * @param ... a string literal format, followed by the arguments
+ * corresponding to its conversion specifications.
+ */
+#define CBPRINTF_STATIC_PACKAGE(packaged, inlen, outlen, ... /* fmt, args */) \
+	Z_CBPRINTF_STATIC_PACKAGE(packaged, inlen, outlen, __VA_ARGS__)
+
+/** @brief Format a package through a callback.
+ *
+ * @param out the function used to emit each generated character.
+ *
+ * @param ctx context provided when invoking out
+ *
+ * @param packaged a package created by cbprintf_package() or
+ * CBPRINTF_STATIC_PACKAGE().
+ *
+ * @return the number of characters printed, or a negative error value
+ * returned from invoking @p out.
+ */
+int cbpprintf(cbprintf_cb out, void *ctx, const void *packaged);
+
 #ifdef CONFIG_CBPRINTF_LIBC_SUBSTS
 
 /** @brief fprintf using Zephyrs cbprintf infrastructure.
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Package helpers
+ *
+ * Layout of the packages and macros needed by CBPRINTF_STATIC_PACKAGE().
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_CBPRINTF_INTERNAL_H_
+#define ZEPHYR_INCLUDE_SYS_CBPRINTF_INTERNAL_H_
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <toolchain.h>
+#include <sys/util.h>
+
+/*
+ * A package is laid out as:
+ *
+ * - the format string pointer,
+ * - the length of the arguments, as an uint16_t,
+ * - the number of copied strings, as an uint8_t,
+ * - the arguments, each with the size of its promoted type and without
+ *   padding, the string arguments being stored as pointers,
+ * - for each copied string, the offset of its pointer from the start of the
+ *   arguments, as an uint8_t, followed by the NUL terminated copy.
+ *
+ * All fields may be unaligned.
+ */
+
+/* Length of the package header. */
+#define Z_CBPRINTF_PKG_HDR_LEN \
+	(sizeof(const char *) + sizeof(uint16_t) + sizeof(uint8_t))
+
+/* Offset of the arguments length in the header. */
+#define Z_CBPRINTF_PKG_ARGS_LEN_OFFSET sizeof(const char *)
+
+/* Offset of the strings count in the header. */
+#define Z_CBPRINTF_PKG_STR_CNT_OFFSET \
+	(sizeof(const char *) + sizeof(uint16_t))
+
+/* Package being built. If buf is NULL, only the length is computed. */
+struct z_cbprintf_pkg {
+	uint8_t *buf;
+	size_t len;
+	/* Position of the next argument. */
+	size_t pos;
+	/* Position of the next string copy. */
+	size_t str_pos;
+	const char *fmt;
+	size_t args_len;
+	size_t str_cnt;
+	bool nospc;
+};
+
+static inline void z_cbprintf_pkg_init(struct z_cbprintf_pkg *pkg, void *buf,
+				       size_t len, const char *fmt,
+				       size_t args_len)
+{
+	pkg->buf = (uint8_t *)buf;
+	pkg->len = len;
+	pkg->pos = Z_CBPRINTF_PKG_HDR_LEN;
+	pkg->str_pos = Z_CBPRINTF_PKG_HDR_LEN + args_len;
+	pkg->fmt = fmt;
+	pkg->args_len = args_len;
+	pkg->str_cnt = 0;
+	pkg->nospc = false;
+}
+
+static inline void z_cbprintf_pkg_write(struct z_cbprintf_pkg *pkg,
+					size_t pos, const void *data,
+					size_t len)
+{
+	if (pkg->buf == NULL) {
+		return;
+	}
+
+	if (pos + len > pkg->len) {
+		pkg->nospc = true;
+	} else {
+		memcpy(pkg->buf + pos, data, len);
+	}
+}
+
+/* Store an argument value, already promoted. */
+static inline void z_cbprintf_pkg_val(struct z_cbprintf_pkg *pkg,
+				      const void *value, size_t size)
+{
+	z_cbprintf_pkg_write(pkg, pkg->pos, value, size);
+	pkg->pos += size;
+}
+
+/* Store a string argument, copying the string if its slot can be referred
+ * to by the strings table. At most precision characters are copied, if not
+ * negative.
+ */
+static inline void z_cbprintf_pkg_str(struct z_cbprintf_pkg *pkg,
+				      const char *s, int precision)
+{
+	size_t slot = pkg->pos - Z_CBPRINTF_PKG_HDR_LEN;
+	uint8_t offset = (uint8_t)slot;
+	size_t len;
+
+	z_cbprintf_pkg_val(pkg, &s, sizeof(s));
+
+	if (s == NULL || slot > UINT8_MAX || pkg->str_cnt == UINT8_MAX) {
+		return;
+	}
+
+	len = (precision < 0) ? strlen(s) : strnlen(s, precision);
+
+	z_cbprintf_pkg_write(pkg, pkg->str_pos, &offset, sizeof(offset));
+	z_cbprintf_pkg_write(pkg, pkg->str_pos + sizeof(offset), s, len);
+	z_cbprintf_pkg_write(pkg, pkg->str_pos + sizeof(offset) + len, "", 1);
+	pkg->str_pos += sizeof(offset) + len + 1;
+	pkg->str_cnt++;
+}
+
+/* Write the header and return the length of the package, or a negative
+ * error code.
+ */
+static inline int z_cbprintf_pkg_finish(struct z_cbprintf_pkg *pkg)
+{
+	uint16_t args_len = (uint16_t)pkg->args_len;
+	uint8_t str_cnt = (uint8_t)pkg->str_cnt;
+
+	if (pkg->args_len > UINT16_MAX) {
+		return -EINVAL;
+	}
+
+	z_cbprintf_pkg_write(pkg, 0, &pkg->fmt, sizeof(pkg->fmt));
+	z_cbprintf_pkg_write(pkg, Z_CBPRINTF_PKG_ARGS_LEN_OFFSET, &args_len,
+			     sizeof(args_len));
+	z_cbprintf_pkg_write(pkg, Z_CBPRINTF_PKG_STR_CNT_OFFSET, &str_cnt,
+			     sizeof(str_cnt));
+
+	return pkg->nospc ? -ENOSPC : (int)pkg->str_pos;
+}
+
+/* Never called, only checks the arguments against the format string. */
+static inline __printf_like(1, 2)
+void z_cbprintf_format_check(const char *fmt, ...)
+{
+	ARG_UNUSED(fmt);
+}
+
+#ifdef __cplusplus
+
+/* Arguments are stored with the type of their value after the default
+ * argument promotions, which overloading selects in C++.
+ */
+static inline void z_cbprintf_pkg_arg(struct z_cbprintf_pkg *pkg,
+				      const char *s)
+{
+	z_cbprintf_pkg_str(pkg, s, -1);
+}
+
+static inline void z_cbprintf_pkg_arg(struct z_cbprintf_pkg *pkg, char *s)
+{
+	z_cbprintf_pkg_str(pkg, s, -1);
+}
+
+static inline void z_cbprintf_pkg_arg(struct z_cbprintf_pkg *pkg, float v)
+{
+	double d = v;
+
+	z_cbprintf_pkg_val(pkg, &d, sizeof(d));
+}
+
+template <typename T>
+static inline void z_cbprintf_pkg_arg(struct z_cbprintf_pkg *pkg, T v)
+{
+	auto p = +v;
+
+	z_cbprintf_pkg_val(pkg, &p, sizeof(p));
+}
+
+static inline size_t z_cbprintf_arg_size(const char *s)
+{
+	return sizeof(s);
+}
+
+static inline size_t z_cbprintf_arg_size(float v)
+{
+	return sizeof(double);
+}
+
+template <typename T>
+static inline size_t z_cbprintf_arg_size(T v)
+{
+	return sizeof(+v);
+}
+
+#define Z_CBPRINTF_ARG_DECL(idx, arg) auto _cbp_arg##idx = (arg)
+
+#define Z_CBPRINTF_ARG_SIZE(v) z_cbprintf_arg_size(v)
+
+#define Z_CBPRINTF_PKG_ARG(pkg, v) z_cbprintf_pkg_arg(pkg, v)
+
+#else /* __cplusplus */
+
+/* Adding 0 applies the integer promotions and converts arrays to pointers,
+ * only float is left to promote.
+ */
+#define Z_CBPRINTF_ARG_DECL(idx, arg) __auto_type _cbp_arg##idx = (arg) + 0
+
+#define Z_CBPRINTF_ARG_SIZE(v) \
+	_Generic((v), float : sizeof(double), default : sizeof(v))
+
+#define Z_CBPRINTF_IS_PCHAR(v) \
+	_Generic((v), char * : 1, const char * : 1, default : 0)
+
+#define Z_CBPRINTF_PCHAR(v) \
+	_Generic((v), char * : (v), const char * : (v), default : NULL)
+
+#define Z_CBPRINTF_PKG_ARG(pkg, v) do { \
+	double _cbp_d = _Generic((v), float : (v), default : 0.0); \
+	\
+	if (Z_CBPRINTF_IS_PCHAR(v)) { \
+		z_cbprintf_pkg_str(pkg, Z_CBPRINTF_PCHAR(v), -1); \
+	} else { \
+		z_cbprintf_pkg_val(pkg, _Generic((v), \
+				float : (const void *)&_cbp_d, \
+				default : (const void *)&(v)), \
+			Z_CBPRINTF_ARG_SIZE(v)); \
+	} \
+} while (0)
+
+#endif /* __cplusplus */
+
+#define Z_CBPRINTF_ARG_SIZE_ADD(idx, arg) \
+	COND_CODE_0(idx, (), (+ Z_CBPRINTF_ARG_SIZE(_cbp_arg##idx)))
+
+#define Z_CBPRINTF_ARG_PUT(idx, arg) \
+	COND_CODE_0(idx, (), (Z_CBPRINTF_PKG_ARG(&_cbp_pkg, _cbp_arg##idx)))
+
+/* Declare the locals holding the format string and the arguments, so that
+ * each one is evaluated once whatever the number of Z_CBPRINTF_PKG_BUILD().
+ */
+#define Z_CBPRINTF_ARGS_DECL(...) \
+	FOR_EACH_IDX(Z_CBPRINTF_ARG_DECL, (;), __VA_ARGS__)
+
+/* Build the package of the arguments declared by Z_CBPRINTF_ARGS_DECL(),
+ * setting _outlen to its length or to a negative error code.
+ */
+#define Z_CBPRINTF_PKG_BUILD(_buf, _len, _outlen, ...) do { \
+	struct z_cbprintf_pkg _cbp_pkg; \
+	\
+	z_cbprintf_pkg_init(&_cbp_pkg, _buf, _len, _cbp_arg0, \
+		0 FOR_EACH_IDX(Z_CBPRINTF_ARG_SIZE_ADD, (), __VA_ARGS__)); \
+	FOR_EACH_IDX(Z_CBPRINTF_ARG_PUT, (;), __VA_ARGS__); \
+	_outlen = z_cbprintf_pkg_finish(&_cbp_pkg); \
+} while (0)
+
+#define Z_CBPRINTF_STATIC_PACKAGE(_packaged, _inlen, _outlen, ...) do { \
+	if (0) { \
+		z_cbprintf_format_check(__VA_ARGS__); \
+	} \
+	Z_CBPRINTF_ARGS_DECL(__VA_ARGS__); \
+	Z_CBPRINTF_PKG_BUILD(_packaged, _inlen, _outlen, __VA_ARGS__); \
+} while (0)
+
+#endif /* ZEPHYR_INCLUDE_SYS_CBPRINTF_INTERNAL_H_ */
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef ZEPHYR_INCLUDE_SYS_MPSC_PBUF_H_
+#define ZEPHYR_INCLUDE_SYS_MPSC_PBUF_H_
+
+#include <kernel.h>
+#include <sys/atomic.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Multi producer, single consumer packet buffer API
+ * @defgroup mpsc_buf MPSC (Multi producer, single consumer) packet buffer API
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/*
+ * The buffer holds variable length packets, each starting with a 32 bit
+ * header word made of the packet length in words and of the flags below.
+ *
+ * Producers reserve space by advancing the write index with a compare and
+ * swap, without any lock, then fill the packet and commit it by setting
+ * the valid flag of its header. The consumer claims the packets in the
+ * order of reservation, and waits for a reserved packet to be committed.
+ * A packet not fitting before the end of the buffer is placed at its
+ * start, and the end of the buffer is filled with a skip packet.
+ *
+ * The consumer clears the space of the freed packets, so that a packet
+ * reserved but not committed yet is never seen as valid.
+ */
+
+/** @brief Header flag of a committed packet. */
+#define MPSC_PBUF_HDR_VALID BIT(0)
+
+/** @brief Header flag of a padding packet, skipped by the consumer. */
+#define MPSC_PBUF_HDR_SKIP BIT(1)
+
+/** @brief Offset of the packet length, in words, in the header. */
+#define MPSC_PBUF_HDR_LEN_SHIFT 2
+
+/** @brief Mask of the index in the write index, higher bits are a tag. */
+#define MPSC_PBUF_IDX_MASK 0xFFFFU
+
+/** @brief MPSC packet buffer. */
+struct mpsc_pbuf_buffer {
+	/** Memory of the buffer. */
+	uint32_t *buf;
+
+	/** Size of the buffer, in words. */
+	uint32_t size;
+
+	/** Index up to which space is reserved by the producers, tagged. */
+	atomic_t wr_idx;
+
+	/** Index up to which space is freed by the consumer. */
+	atomic_t rd_idx;
+
+	/** Maximum number of words used, if CONFIG_MPSC_PBUF_PROFILING. */
+	uint32_t max_usage;
+};
+
+/**
+ * @brief Initialize a packet buffer.
+ *
+ * @param buffer Packet buffer.
+ * @param buf Memory of the buffer, 32 bit aligned.
+ * @param size Size of the memory, in words, up to MPSC_PBUF_IDX_MASK.
+ */
+void mpsc_pbuf_init(struct mpsc_pbuf_buffer *buffer, uint32_t *buf,
+		    uint32_t size);
+
+/**
+ * @brief Reserve a packet.
+ *
+ * Safe to call from any context, concurrently with other producers and
+ * with the consumer.
+ *
+ * @param buffer Packet buffer.
+ * @param len Length of the packet data, in bytes.
+ *
+ * @return Pointer to the packet data, 32 bit aligned, or NULL if the
+ *         buffer is full.
+ */
+void *mpsc_pbuf_alloc(struct mpsc_pbuf_buffer *buffer, size_t len);
+
+/**
+ * @brief Commit a packet filled by the producer.
+ *
+ * @param buffer Packet buffer.
+ * @param data Packet data returned by mpsc_pbuf_alloc().
+ */
+void mpsc_pbuf_commit(struct mpsc_pbuf_buffer *buffer, void *data);
+
+/**
+ * @brief Claim the oldest packet.
+ *
+ * Shall only be called by the consumer. The packet is not claimed again
+ * until it is freed.
+ *
+ * @param buffer Packet buffer.
+ * @param len Set to the length of the packet data, rounded up to words.
+ *
+ * @return Pointer to the packet data, or NULL if no committed packet is
+ *         pending.
+ */
+const void *mpsc_pbuf_claim(struct mpsc_pbuf_buffer *buffer, size_t *len);
+
+/**
+ * @brief Free the claimed packet.
+ *
+ * @param buffer Packet buffer.
+ * @param data Packet data returned by mpsc_pbuf_claim().
+ */
+void mpsc_pbuf_free(struct mpsc_pbuf_buffer *buffer, const void *data);
+
+/**
+ * @brief Check if packets are pending, committed or not.
+ *
+ * @param buffer Packet buffer.
+ *
+ * @return true if packets are pending.
+ */
+static inline bool mpsc_pbuf_is_pending(struct mpsc_pbuf_buffer *buffer)
+{
+	return (uint32_t)atomic_get(&buffer->rd_idx) !=
+	       ((uint32_t)atomic_get(&buffer->wr_idx) & MPSC_PBUF_IDX_MASK);
+}
+
+/**
+ * @brief Get the maximum number of bytes used in the buffer.
+ *
+ * @param buffer Packet buffer.
+ *
+ * @return Maximum usage, 0 without CONFIG_MPSC_PBUF_PROFILING.
+ */
+static inline size_t mpsc_pbuf_max_usage(struct mpsc_pbuf_buffer *buffer)
+{
+	return buffer->max_usage * sizeof(uint32_t);
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_MPSC_PBUF_H_ */
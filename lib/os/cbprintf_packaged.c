@@ -0,0 +1,508 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/cbprintf.h>
+#include <sys/util.h>
+
+/* Type of the value of a conversion, after promotion. */
+enum pkg_arg {
+	PKG_ARG_NONE,
+	PKG_ARG_INT,
+	PKG_ARG_LONG,
+	PKG_ARG_LLONG,
+	PKG_ARG_INTMAX,
+	PKG_ARG_SIZE,
+	PKG_ARG_PTRDIFF,
+	PKG_ARG_DOUBLE,
+	PKG_ARG_LDOUBLE,
+	PKG_ARG_PTR,
+	PKG_ARG_STR,
+};
+
+/* Conversion specification, from the '%' to the conversion character. */
+struct pkg_conv {
+	const char *start;
+	size_t len;
+	enum pkg_arg arg;
+	int precision;
+	bool width_star;
+	bool prec_star;
+	bool literal;
+};
+
+/* Parse the conversion starting at fp, the character after the '%'.
+ * Returns the character after the conversion.
+ */
+static const char *conv_parse(const char *fp, struct pkg_conv *conv)
+{
+	enum pkg_arg int_arg = PKG_ARG_INT;
+	bool ldouble = false;
+
+	conv->start = fp - 1;
+	conv->arg = PKG_ARG_NONE;
+	conv->precision = -1;
+	conv->width_star = false;
+	conv->prec_star = false;
+	conv->literal = false;
+
+	while (*fp != '\0' && strchr("-+ #0'", *fp) != NULL) {
+		fp++;
+	}
+
+	if (*fp == '*') {
+		conv->width_star = true;
+		fp++;
+	} else {
+		while (*fp >= '0' && *fp <= '9') {
+			fp++;
+		}
+	}
+
+	if (*fp == '.') {
+		fp++;
+		conv->precision = 0;
+		if (*fp == '*') {
+			conv->prec_star = true;
+			fp++;
+		} else {
+			while (*fp >= '0' && *fp <= '9') {
+				conv->precision = conv->precision * 10 +
+						  (*fp - '0');
+				fp++;
+			}
+		}
+	}
+
+	switch (*fp) {
+	case 'h':
+		fp += (fp[1] == 'h') ? 2 : 1;
+		break;
+	case 'l':
+		if (fp[1] == 'l') {
+			int_arg = PKG_ARG_LLONG;
+			fp += 2;
+		} else {
+			int_arg = PKG_ARG_LONG;
+			fp++;
+		}
+		break;
+	case 'j':
+		int_arg = PKG_ARG_INTMAX;
+		fp++;
+		break;
+	case 'z':
+		int_arg = PKG_ARG_SIZE;
+		fp++;
+		break;
+	case 't':
+		int_arg = PKG_ARG_PTRDIFF;
+		fp++;
+		break;
+	case 'L':
+		ldouble = true;
+		fp++;
+		break;
+	default:
+		break;
+	}
+
+	switch (*fp) {
+	case 'd':
+	case 'i':
+	case 'o':
+	case 'u':
+	case 'x':
+	case 'X':
+		conv->arg = int_arg;
+		break;
+	case 'c':
+		conv->arg = PKG_ARG_INT;
+		break;
+	case 'a':
+	case 'A':
+	case 'e':
+	case 'E':
+	case 'f':
+	case 'F':
+	case 'g':
+	case 'G':
+		conv->arg = ldouble ? PKG_ARG_LDOUBLE : PKG_ARG_DOUBLE;
+		break;
+	case 'p':
+		conv->arg = PKG_ARG_PTR;
+		break;
+	case 's':
+		conv->arg = PKG_ARG_STR;
+		break;
+	case 'n':
+		/* The pointer is stored but nothing is written through it. */
+		conv->arg = PKG_ARG_PTR;
+		break;
+	case '%':
+		conv->literal = true;
+		break;
+	case '\0':
+		/* Truncated conversion, printed as is. */
+		conv->literal = true;
+		conv->len = fp - conv->start;
+		return fp;
+	default:
+		conv->literal = true;
+		break;
+	}
+
+	fp++;
+	conv->len = fp - conv->start;
+
+	return fp;
+}
+
+static size_t arg_size(enum pkg_arg arg)
+{
+	switch (arg) {
+	case PKG_ARG_INT:
+		return sizeof(int);
+	case PKG_ARG_LONG:
+		return sizeof(long);
+	case PKG_ARG_LLONG:
+		return sizeof(long long);
+	case PKG_ARG_INTMAX:
+		return sizeof(intmax_t);
+	case PKG_ARG_SIZE:
+		return sizeof(size_t);
+	case PKG_ARG_PTRDIFF:
+		return sizeof(ptrdiff_t);
+	case PKG_ARG_DOUBLE:
+		return sizeof(double);
+	case PKG_ARG_LDOUBLE:
+		return sizeof(long double);
+	case PKG_ARG_PTR:
+		return sizeof(void *);
+	case PKG_ARG_STR:
+		return sizeof(const char *);
+	default:
+		return 0;
+	}
+}
+
+/* Length of the arguments of a format string, as stored in a package. */
+static size_t args_len_get(const char *fp)
+{
+	struct pkg_conv conv;
+	size_t len = 0;
+
+	while (*fp != '\0') {
+		if (*fp++ != '%') {
+			continue;
+		}
+
+		fp = conv_parse(fp, &conv);
+		if (conv.literal) {
+			continue;
+		}
+
+		len += (conv.width_star ? sizeof(int) : 0) +
+		       (conv.prec_star ? sizeof(int) : 0) +
+		       arg_size(conv.arg);
+	}
+
+	return len;
+}
+
+#define PKG_PUT_ARG(pkg, ap, type) do { \
+		type _v = va_arg(ap, type); \
+		z_cbprintf_pkg_val(pkg, &_v, sizeof(_v)); \
+	} while (0)
+
+int cbvprintf_package(void *packaged, size_t len, const char *format,
+		      va_list ap)
+{
+	struct z_cbprintf_pkg pkg;
+	struct pkg_conv conv;
+	const char *fp = format;
+
+	z_cbprintf_pkg_init(&pkg, packaged, len, format,
+			    args_len_get(format));
+
+	while (*fp != '\0') {
+		if (*fp++ != '%') {
+			continue;
+		}
+
+		fp = conv_parse(fp, &conv);
+		if (conv.literal) {
+			continue;
+		}
+
+		if (conv.width_star) {
+			PKG_PUT_ARG(&pkg, ap, int);
+		}
+
+		if (conv.prec_star) {
+			int precision = va_arg(ap, int);
+
+			conv.precision = precision;
+			z_cbprintf_pkg_val(&pkg, &precision, sizeof(precision));
+		}
+
+		switch (conv.arg) {
+		case PKG_ARG_INT:
+			PKG_PUT_ARG(&pkg, ap, int);
+			break;
+		case PKG_ARG_LONG:
+			PKG_PUT_ARG(&pkg, ap, long);
+			break;
+		case PKG_ARG_LLONG:
+			PKG_PUT_ARG(&pkg, ap, long long);
+			break;
+		case PKG_ARG_INTMAX:
+			PKG_PUT_ARG(&pkg, ap, intmax_t);
+			break;
+		case PKG_ARG_SIZE:
+			PKG_PUT_ARG(&pkg, ap, size_t);
+			break;
+		case PKG_ARG_PTRDIFF:
+			PKG_PUT_ARG(&pkg, ap, ptrdiff_t);
+			break;
+		case PKG_ARG_DOUBLE:
+			PKG_PUT_ARG(&pkg, ap, double);
+			break;
+		case PKG_ARG_LDOUBLE:
+			PKG_PUT_ARG(&pkg, ap, long double);
+			break;
+		case PKG_ARG_PTR:
+			PKG_PUT_ARG(&pkg, ap, void *);
+			break;
+		case PKG_ARG_STR:
+			z_cbprintf_pkg_str(&pkg, va_arg(ap, const char *),
+					   conv.precision);
+			break;
+		default:
+			break;
+		}
+	}
+
+	return z_cbprintf_pkg_finish(&pkg);
+}
+
+int cbprintf_package(void *packaged, size_t len, const char *format, ...)
+{
+	va_list ap;
+	int rc;
+
+	va_start(ap, format);
+	rc = cbvprintf_package(packaged, len, format, ap);
+	va_end(ap);
+
+	return rc;
+}
+
+/* Longest specification, with the '*' replaced by the values. */
+#define PKG_SPEC_MAX_LEN 48
+
+/* Longest int value, in characters. */
+#define PKG_INT_MAX_LEN 11
+
+static char *int_append(char *sp, int value)
+{
+	char digits[PKG_INT_MAX_LEN];
+	int n = 0;
+	unsigned int v = (value < 0) ? -(unsigned int)value : value;
+
+	if (value < 0) {
+		*sp++ = '-';
+	}
+
+	do {
+		digits[n++] = '0' + (v % 10U);
+		v /= 10U;
+	} while (v != 0U);
+
+	while (n > 0) {
+		*sp++ = digits[--n];
+	}
+
+	return sp;
+}
+
+/* Copy the specification, replacing the '*' by the packaged values. */
+static bool spec_build(char *spec, const struct pkg_conv *conv,
+		       const uint8_t **pp)
+{
+	const char *cp = conv->start;
+	const char *end = conv->start + conv->len;
+	char *sp = spec;
+	bool first_star = true;
+	int value;
+
+	if (conv->len + 2 * PKG_INT_MAX_LEN >= PKG_SPEC_MAX_LEN) {
+		return false;
+	}
+
+	while (cp < end) {
+		if (*cp != '*') {
+			*sp++ = *cp++;
+			continue;
+		}
+
+		memcpy(&value, *pp, sizeof(value));
+		*pp += sizeof(value);
+		cp++;
+
+		if (first_star && conv->width_star) {
+			sp = int_append(sp, value);
+		} else if (value >= 0) {
+			sp = int_append(sp, value);
+		} else {
+			/* A negative precision is taken as omitted. */
+			sp--;
+		}
+
+		first_star = false;
+	}
+
+	*sp = '\0';
+
+	return true;
+}
+
+#define PKG_PRINT_ARG(out, ctx, spec, pp, type) ({ \
+		type _v; \
+		memcpy(&_v, pp, sizeof(_v)); \
+		pp += sizeof(_v); \
+		cbprintf(out, ctx, spec, _v); \
+	})
+
+/* Find the copy of the string whose pointer is at offset slot from the
+ * start of the arguments, or return the pointer itself.
+ */
+static const char *pkg_str_get(const uint8_t *args, const uint8_t *strs,
+			       uint8_t str_cnt, const uint8_t *pp)
+{
+	size_t slot = pp - args;
+	const char *s;
+
+	while (str_cnt-- > 0) {
+		s = (const char *)&strs[1];
+		if (strs[0] == slot) {
+			return s;
+		}
+
+		strs = (const uint8_t *)s + strlen(s) + 1;
+	}
+
+	memcpy(&s, pp, sizeof(s));
+
+	return (s == NULL) ? "(null)" : s;
+}
+
+int cbpprintf(cbprintf_cb out, void *ctx, const void *packaged)
+{
+	const uint8_t *pp = packaged;
+	char spec[PKG_SPEC_MAX_LEN];
+	struct pkg_conv conv;
+	const uint8_t *args;
+	const char *format;
+	const char *fp;
+	uint16_t args_len;
+	uint8_t str_cnt;
+	int count = 0;
+	int rc;
+
+	memcpy(&format, pp, sizeof(format));
+	memcpy(&args_len, pp + Z_CBPRINTF_PKG_ARGS_LEN_OFFSET, sizeof(args_len));
+	memcpy(&str_cnt, pp + Z_CBPRINTF_PKG_STR_CNT_OFFSET, sizeof(str_cnt));
+	args = pp + Z_CBPRINTF_PKG_HDR_LEN;
+	pp = args;
+	fp = format;
+
+	while (*fp != '\0') {
+		if (*fp != '%') {
+			rc = out((int)*fp++, ctx);
+			if (rc < 0) {
+				return rc;
+			}
+
+			count++;
+			continue;
+		}
+
+		fp = conv_parse(fp + 1, &conv);
+		if (conv.literal && conv.start[conv.len - 1] == '%') {
+			rc = out('%', ctx);
+			rc = (rc < 0) ? rc : 1;
+		} else if (conv.literal) {
+			/* Invalid conversion, printed as is. */
+			rc = cbprintf(out, ctx, "%.*s", (int)conv.len,
+				      conv.start);
+		} else if (!spec_build(spec, &conv, &pp)) {
+			return -EINVAL;
+		} else {
+			switch (conv.arg) {
+			case PKG_ARG_INT:
+				rc = PKG_PRINT_ARG(out, ctx, spec, pp, int);
+				break;
+			case PKG_ARG_LONG:
+				rc = PKG_PRINT_ARG(out, ctx, spec, pp, long);
+				break;
+			case PKG_ARG_LLONG:
+				rc = PKG_PRINT_ARG(out, ctx, spec, pp,
+						   long long);
+				break;
+			case PKG_ARG_INTMAX:
+				rc = PKG_PRINT_ARG(out, ctx, spec, pp,
+						   intmax_t);
+				break;
+			case PKG_ARG_SIZE:
+				rc = PKG_PRINT_ARG(out, ctx, spec, pp, size_t);
+				break;
+			case PKG_ARG_PTRDIFF:
+				rc = PKG_PRINT_ARG(out, ctx, spec, pp,
+						   ptrdiff_t);
+				break;
+			case PKG_ARG_DOUBLE:
+				rc = PKG_PRINT_ARG(out, ctx, spec, pp, double);
+				break;
+			case PKG_ARG_LDOUBLE:
+				rc = PKG_PRINT_ARG(out, ctx, spec, pp,
+						   long double);
+				break;
+			case PKG_ARG_PTR:
+				if (spec[strlen(spec) - 1] == 'n') {
+					pp += sizeof(void *);
+					rc = 0;
+				} else {
+					rc = PKG_PRINT_ARG(out, ctx, spec, pp,
+							   void *);
+				}
+				break;
+			case PKG_ARG_STR:
+				rc = cbprintf(out, ctx, spec,
+					      pkg_str_get(args, args + args_len,
+							  str_cnt, pp));
+				pp += sizeof(const char *);
+				break;
+			default:
+				rc = 0;
+				break;
+			}
+		}
+
+		if (rc < 0) {
+			return rc;
+		}
+
+		count += rc;
+	}
+
+	return count;
+}
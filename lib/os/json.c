@@ -599,6 +599,386 @@ int json_obj_parse(char *payload, size_t len,
 	return obj_parse(&obj, descr, descr_len, val);
 }
 
+enum json_stream_state {
+	/* Value expected */
+	STREAM_VALUE,
+	/* Value or end of the array expected, after '[' */
+	STREAM_VALUE_OR_END,
+	/* Key expected, after ',' in an object */
+	STREAM_KEY,
+	/* Key or end of the object expected, after '{' */
+	STREAM_KEY_OR_END,
+	STREAM_COLON,
+	/* ',' or end of the container expected, after a value */
+	STREAM_NEXT,
+	STREAM_STRING,
+	STREAM_NUMBER,
+	STREAM_LITERAL,
+	/* Top-level value complete, only whitespace expected */
+	STREAM_DONE,
+	STREAM_ERROR,
+};
+
+/* Depth limit given by the size of the objects bitmap. */
+#define STREAM_MAX_DEPTH (sizeof(uint32_t) * CHAR_BIT)
+
+static const char *literal_text(enum json_tokens type)
+{
+	switch (type) {
+	case JSON_TOK_TRUE:
+		return "true";
+	case JSON_TOK_FALSE:
+		return "false";
+	default:
+		return "null";
+	}
+}
+
+static bool stream_in_obj(struct json_stream *stream)
+{
+	return stream->depth > 0 &&
+	       (stream->objects & BIT(stream->depth - 1)) != 0U;
+}
+
+static int stream_emit(struct json_stream *stream, enum json_tokens type,
+		       bool with_value)
+{
+	struct json_stream_event event = {
+		.type = type,
+		.depth = stream->depth,
+	};
+
+	if (stream->key_size > 0) {
+		event.key = stream->buf;
+		event.key_len = stream->key_size - 1;
+	}
+
+	if (with_value) {
+		event.value = stream->buf + stream->key_size;
+		event.value_len = stream->len;
+		stream->buf[stream->key_size + stream->len] = '\0';
+	}
+
+	stream->key_size = 0;
+	stream->len = 0;
+
+	return stream->cb(&event, stream->user_data);
+}
+
+static int stream_push_char(struct json_stream *stream, char chr)
+{
+	/* Keep room for the NUL character. */
+	if (stream->key_size + stream->len + 1 >= stream->buf_size) {
+		return -ENOMEM;
+	}
+
+	stream->buf[stream->key_size + stream->len++] = chr;
+
+	return 0;
+}
+
+static void stream_value_done(struct json_stream *stream)
+{
+	stream->state = stream->depth > 0 ? STREAM_NEXT : STREAM_DONE;
+}
+
+static int stream_container_start(struct json_stream *stream,
+				  enum json_tokens type)
+{
+	int ret;
+
+	if (stream->depth == STREAM_MAX_DEPTH) {
+		return -ENOMEM;
+	}
+
+	ret = stream_emit(stream, type, false);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (type == JSON_TOK_OBJECT_START) {
+		stream->objects |= BIT(stream->depth);
+		stream->state = STREAM_KEY_OR_END;
+	} else {
+		stream->objects &= ~BIT(stream->depth);
+		stream->state = STREAM_VALUE_OR_END;
+	}
+	stream->depth++;
+
+	return 0;
+}
+
+static int stream_container_end(struct json_stream *stream,
+				enum json_tokens type)
+{
+	bool obj = type == JSON_TOK_OBJECT_END;
+
+	if (stream->depth == 0 || stream_in_obj(stream) != obj) {
+		return -EINVAL;
+	}
+
+	stream->depth--;
+	stream_value_done(stream);
+
+	return stream_emit(stream, type, false);
+}
+
+static int stream_value(struct json_stream *stream, char chr)
+{
+	switch (chr) {
+	case '{':
+		return stream_container_start(stream, JSON_TOK_OBJECT_START);
+	case '[':
+		return stream_container_start(stream, JSON_TOK_LIST_START);
+	case '"':
+		stream->in_key = false;
+		stream->sub = 0U;
+		stream->state = STREAM_STRING;
+		return 0;
+	case 't':
+	case 'f':
+	case 'n':
+		stream->literal = chr;
+		stream->sub = 1U;
+		stream->state = STREAM_LITERAL;
+		return 0;
+	case '-':
+		stream->sub = 0U;
+		stream->state = STREAM_NUMBER;
+		return stream_push_char(stream, chr);
+	default:
+		if (isdigit((unsigned char)chr)) {
+			stream->sub = 1U;
+			stream->state = STREAM_NUMBER;
+			return stream_push_char(stream, chr);
+		}
+
+		return -EINVAL;
+	}
+}
+
+static int stream_string(struct json_stream *stream, char chr)
+{
+	int ret;
+
+	switch (stream->sub) {
+	case 0:
+		if (chr == '\\') {
+			stream->sub = 1U;
+		} else if (chr == '"') {
+			break;
+		}
+
+		return stream_push_char(stream, chr);
+	case 1:
+		if (chr == 'u') {
+			stream->sub = 2U;
+		} else if (chr != '\0' && strchr("\"\\/bfnrt", chr) != NULL) {
+			stream->sub = 0U;
+		} else {
+			return -EINVAL;
+		}
+
+		return stream_push_char(stream, chr);
+	default:
+		/* Hexadecimal digits of a \u escape, sub is 2 to 5. */
+		if (!isxdigit((unsigned char)chr)) {
+			return -EINVAL;
+		}
+
+		stream->sub = stream->sub == 5U ? 0U : stream->sub + 1U;
+
+		return stream_push_char(stream, chr);
+	}
+
+	/* End of the string */
+	if (!stream->in_key) {
+		stream_value_done(stream);
+
+		return stream_emit(stream, JSON_TOK_STRING, true);
+	}
+
+	/* Keep the key until its value is complete. */
+	ret = stream_push_char(stream, '\0');
+	if (ret < 0) {
+		return ret;
+	}
+
+	stream->key_size = stream->len;
+	stream->len = 0;
+	stream->state = STREAM_COLON;
+
+	return 0;
+}
+
+/* Returns 1 if chr is not part of the token and must be processed again. */
+static int stream_char(struct json_stream *stream, char chr)
+{
+	bool in_obj;
+	int ret;
+
+	switch (stream->state) {
+	case STREAM_STRING:
+		return stream_string(stream, chr);
+	case STREAM_NUMBER:
+		/* Like the lexer, leave the validation to the conversion. */
+		if (isdigit((unsigned char)chr)) {
+			stream->sub = 1U;
+			return stream_push_char(stream, chr);
+		}
+
+		if (stream->sub == 0U) {
+			return -EINVAL;
+		}
+
+		if (chr == '.' || chr == 'e' || chr == 'E' || chr == '+' ||
+		    chr == '-') {
+			return stream_push_char(stream, chr);
+		}
+
+		stream_value_done(stream);
+
+		ret = stream_emit(stream, JSON_TOK_NUMBER, true);
+
+		return ret < 0 ? ret : 1;
+	case STREAM_LITERAL: {
+		const char *text = literal_text(stream->literal);
+
+		if (chr != text[stream->sub]) {
+			return -EINVAL;
+		}
+
+		if (text[++stream->sub] != '\0') {
+			return 0;
+		}
+
+		stream_value_done(stream);
+
+		return stream_emit(stream, stream->literal, false);
+	}
+	default:
+		break;
+	}
+
+	if (isspace((unsigned char)chr)) {
+		return 0;
+	}
+
+	switch (stream->state) {
+	case STREAM_VALUE_OR_END:
+		if (chr == ']') {
+			return stream_container_end(stream, JSON_TOK_LIST_END);
+		}
+
+		__fallthrough;
+	case STREAM_VALUE:
+		return stream_value(stream, chr);
+	case STREAM_KEY_OR_END:
+		if (chr == '}') {
+			return stream_container_end(stream,
+						    JSON_TOK_OBJECT_END);
+		}
+
+		__fallthrough;
+	case STREAM_KEY:
+		if (chr != '"') {
+			return -EINVAL;
+		}
+
+		stream->in_key = true;
+		stream->sub = 0U;
+		stream->state = STREAM_STRING;
+
+		return 0;
+	case STREAM_COLON:
+		if (chr != ':') {
+			return -EINVAL;
+		}
+
+		stream->state = STREAM_VALUE;
+
+		return 0;
+	case STREAM_NEXT:
+		in_obj = stream_in_obj(stream);
+
+		if (chr == ',') {
+			stream->state = in_obj ? STREAM_KEY : STREAM_VALUE;
+			return 0;
+		}
+
+		if (chr == '}') {
+			return stream_container_end(stream,
+						    JSON_TOK_OBJECT_END);
+		}
+
+		if (chr == ']') {
+			return stream_container_end(stream, JSON_TOK_LIST_END);
+		}
+
+		return -EINVAL;
+	default:
+		return -EINVAL;
+	}
+}
+
+void json_stream_init(struct json_stream *stream, char *buf, size_t buf_size,
+		      json_stream_cb_t cb, void *user_data)
+{
+	__ASSERT_NO_MSG(buf != NULL && buf_size > 0);
+
+	*stream = (struct json_stream) {
+		.cb = cb,
+		.user_data = user_data,
+		.buf = buf,
+		.buf_size = buf_size,
+		.state = STREAM_VALUE,
+	};
+}
+
+int json_stream_feed(struct json_stream *stream, const char *data,
+		     size_t len)
+{
+	size_t i = 0;
+	int ret;
+
+	if (stream->state == STREAM_ERROR) {
+		return -EINVAL;
+	}
+
+	while (i < len) {
+		ret = stream_char(stream, data[i]);
+		if (ret < 0) {
+			stream->state = STREAM_ERROR;
+			return ret;
+		}
+
+		/* The character ending a number is processed again. */
+		if (ret == 0) {
+			i++;
+		}
+	}
+
+	return 0;
+}
+
+int json_stream_end(struct json_stream *stream)
+{
+	int ret;
+
+	if (stream->state == STREAM_NUMBER && stream->depth == 0 &&
+	    stream->sub == 1U) {
+		stream->state = STREAM_DONE;
+
+		ret = stream_emit(stream, JSON_TOK_NUMBER, true);
+		if (ret < 0) {
+			stream->state = STREAM_ERROR;
+			return ret;
+		}
+	}
+
+	return stream->state == STREAM_DONE ? 0 : -EINVAL;
+}
+
 static char escape_as(char chr)
 {
 	switch (chr) {
@@ -936,3 +1316,204 @@ ssize_t json_calc_encoded_len(const struct json_obj_descr *descr,
 
 	return total;
 }
+
+void json_writer_init(struct json_writer *writer,
+		      json_append_bytes_t append_bytes, void *data)
+{
+	*writer = (struct json_writer) {
+		.append_bytes = append_bytes,
+		.data = data,
+	};
+}
+
+static bool writer_in_obj(struct json_writer *writer)
+{
+	return writer->depth > 0 &&
+	       (writer->objects & BIT(writer->depth - 1)) != 0U;
+}
+
+/* Emits the separator and key preceding a value. */
+static int writer_value_start(struct json_writer *writer, const char *key)
+{
+	int ret;
+
+	if (writer->ret < 0) {
+		return writer->ret;
+	}
+
+	if (writer_in_obj(writer) != (key != NULL)) {
+		return -EINVAL;
+	}
+
+	if (writer->depth == 0) {
+		/* As json_stream_feed(), accept a single top-level value. */
+		if (writer->root) {
+			return -EINVAL;
+		}
+
+		writer->root = true;
+		return 0;
+	}
+
+	if (writer->empty & BIT(writer->depth - 1)) {
+		writer->empty &= ~BIT(writer->depth - 1);
+	} else {
+		ret = writer->append_bytes(",", 1, writer->data);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	if (key == NULL) {
+		return 0;
+	}
+
+	ret = str_encode(&key, writer->append_bytes, writer->data);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return writer->append_bytes(":", 1, writer->data);
+}
+
+static int writer_done(struct json_writer *writer, int ret)
+{
+	if (ret < 0) {
+		writer->ret = ret;
+	}
+
+	return ret;
+}
+
+static int writer_container_start(struct json_writer *writer,
+				  const char *key, bool obj)
+{
+	int ret;
+
+	if (writer->depth == sizeof(writer->objects) * CHAR_BIT) {
+		return writer_done(writer, -ENOMEM);
+	}
+
+	ret = writer_value_start(writer, key);
+	if (ret < 0) {
+		return writer_done(writer, ret);
+	}
+
+	WRITE_BIT(writer->objects, writer->depth, obj);
+	writer->empty |= BIT(writer->depth);
+	writer->depth++;
+
+	return writer_done(writer, writer->append_bytes(obj ? "{" : "[", 1,
+							writer->data));
+}
+
+static int writer_container_end(struct json_writer *writer, bool obj)
+{
+	if (writer->ret < 0) {
+		return writer->ret;
+	}
+
+	if (writer->depth == 0 || writer_in_obj(writer) != obj) {
+		return writer_done(writer, -EINVAL);
+	}
+
+	writer->depth--;
+
+	return writer_done(writer, writer->append_bytes(obj ? "}" : "]", 1,
+							writer->data));
+}
+
+int json_writer_obj_start(struct json_writer *writer, const char *key)
+{
+	return writer_container_start(writer, key, true);
+}
+
+int json_writer_obj_end(struct json_writer *writer)
+{
+	return writer_container_end(writer, true);
+}
+
+int json_writer_arr_start(struct json_writer *writer, const char *key)
+{
+	return writer_container_start(writer, key, false);
+}
+
+int json_writer_arr_end(struct json_writer *writer)
+{
+	return writer_container_end(writer, false);
+}
+
+int json_writer_str(struct json_writer *writer, const char *key,
+		    const char *value)
+{
+	int ret = writer_value_start(writer, key);
+
+	if (ret < 0) {
+		return writer_done(writer, ret);
+	}
+
+	return writer_done(writer, str_encode(&value, writer->append_bytes,
+					      writer->data));
+}
+
+int json_writer_num(struct json_writer *writer, const char *key,
+		    int32_t value)
+{
+	int ret = writer_value_start(writer, key);
+
+	if (ret < 0) {
+		return writer_done(writer, ret);
+	}
+
+	return writer_done(writer, num_encode(&value, writer->append_bytes,
+					      writer->data));
+}
+
+int json_writer_bool(struct json_writer *writer, const char *key,
+		     bool value)
+{
+	int ret = writer_value_start(writer, key);
+
+	if (ret < 0) {
+		return writer_done(writer, ret);
+	}
+
+	return writer_done(writer, bool_encode(&value, writer->append_bytes,
+					       writer->data));
+}
+
+int json_writer_null(struct json_writer *writer, const char *key)
+{
+	int ret = writer_value_start(writer, key);
+
+	if (ret < 0) {
+		return writer_done(writer, ret);
+	}
+
+	return writer_done(writer, writer->append_bytes("null", 4,
+							writer->data));
+}
+
+int json_writer_obj(struct json_writer *writer, const char *key,
+		    const struct json_obj_descr *descr, size_t descr_len,
+		    const void *val)
+{
+	int ret = writer_value_start(writer, key);
+
+	if (ret < 0) {
+		return writer_done(writer, ret);
+	}
+
+	return writer_done(writer, json_obj_encode(descr, descr_len, val,
+						   writer->append_bytes,
+						   writer->data));
+}
+
+int json_writer_end(struct json_writer *writer)
+{
+	if (writer->ret < 0) {
+		return writer->ret;
+	}
+
+	return (writer->root && writer->depth == 0) ? 0 : -EINVAL;
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <sys/mpsc_pbuf.h>
+#include <sys/__assert.h>
+
+#define HDR_LEN(hdr) ((hdr) >> MPSC_PBUF_HDR_LEN_SHIFT)
+
+/* The write index is tagged with a generation count, incremented by each
+ * reservation, so that a producer preempted while the buffer wraps around
+ * does not reserve space with stale indexes.
+ */
+#define WR_TAG_INC BIT(16)
+
+static inline uint32_t hdr_get(struct mpsc_pbuf_buffer *buffer, uint32_t idx)
+{
+	return __atomic_load_n(&buffer->buf[idx], __ATOMIC_ACQUIRE);
+}
+
+static inline void hdr_set(struct mpsc_pbuf_buffer *buffer, uint32_t idx,
+			   uint32_t hdr)
+{
+	__atomic_store_n(&buffer->buf[idx], hdr, __ATOMIC_RELEASE);
+}
+
+void mpsc_pbuf_init(struct mpsc_pbuf_buffer *buffer, uint32_t *buf,
+		    uint32_t size)
+{
+	__ASSERT_NO_MSG(size <= MPSC_PBUF_IDX_MASK);
+
+	memset(buf, 0, size * sizeof(uint32_t));
+	buffer->buf = buf;
+	buffer->size = size;
+	buffer->max_usage = 0;
+	atomic_set(&buffer->wr_idx, 0);
+	atomic_set(&buffer->rd_idx, 0);
+}
+
+static void usage_update(struct mpsc_pbuf_buffer *buffer, uint32_t wr,
+			 uint32_t rd)
+{
+	uint32_t usage = (wr >= rd) ? (wr - rd) : (buffer->size - rd + wr);
+
+	/* Racy but only used for sizing the buffer. */
+	if (usage > buffer->max_usage) {
+		buffer->max_usage = usage;
+	}
+}
+
+void *mpsc_pbuf_alloc(struct mpsc_pbuf_buffer *buffer, size_t len)
+{
+	uint32_t wlen = 1 + DIV_ROUND_UP(len, sizeof(uint32_t));
+	uint32_t tagged_wr, wr, rd, idx, new_wr;
+	bool wrap;
+
+	if (wlen >= buffer->size) {
+		return NULL;
+	}
+
+	/* One word is kept free, equal indexes mean an empty buffer. */
+	do {
+		tagged_wr = (uint32_t)atomic_get(&buffer->wr_idx);
+		wr = tagged_wr & MPSC_PBUF_IDX_MASK;
+		rd = (uint32_t)atomic_get(&buffer->rd_idx);
+		wrap = false;
+
+		if (rd > wr) {
+			if (wlen >= rd - wr) {
+				return NULL;
+			}
+		} else if (wlen > buffer->size - wr ||
+			   (wlen == buffer->size - wr && rd == 0)) {
+			if (wlen >= rd) {
+				return NULL;
+			}
+
+			wrap = true;
+		}
+
+		idx = wrap ? 0 : wr;
+		new_wr = idx + wlen;
+		if (new_wr == buffer->size) {
+			new_wr = 0;
+		}
+	} while (!atomic_cas(&buffer->wr_idx, tagged_wr,
+			     ((tagged_wr + WR_TAG_INC) & ~MPSC_PBUF_IDX_MASK) |
+			     new_wr));
+
+	if (wrap) {
+		hdr_set(buffer, wr, MPSC_PBUF_HDR_VALID | MPSC_PBUF_HDR_SKIP |
+			((buffer->size - wr) << MPSC_PBUF_HDR_LEN_SHIFT));
+	}
+
+	if (IS_ENABLED(CONFIG_MPSC_PBUF_PROFILING)) {
+		usage_update(buffer, new_wr, rd);
+	}
+
+	/* Not valid until committed. */
+	hdr_set(buffer, idx, wlen << MPSC_PBUF_HDR_LEN_SHIFT);
+
+	return &buffer->buf[idx + 1];
+}
+
+void mpsc_pbuf_commit(struct mpsc_pbuf_buffer *buffer, void *data)
+{
+	uint32_t idx = (uint32_t *)data - buffer->buf - 1;
+
+	hdr_set(buffer, idx, hdr_get(buffer, idx) | MPSC_PBUF_HDR_VALID);
+}
+
+const void *mpsc_pbuf_claim(struct mpsc_pbuf_buffer *buffer, size_t *len)
+{
+	uint32_t rd, hdr;
+
+	while (true) {
+		rd = (uint32_t)atomic_get(&buffer->rd_idx);
+		if (rd == ((uint32_t)atomic_get(&buffer->wr_idx) &
+			   MPSC_PBUF_IDX_MASK)) {
+			return NULL;
+		}
+
+		hdr = hdr_get(buffer, rd);
+		if ((hdr & MPSC_PBUF_HDR_VALID) == 0) {
+			/* Reserved, not committed yet. */
+			return NULL;
+		}
+
+		if ((hdr & MPSC_PBUF_HDR_SKIP) == 0) {
+			break;
+		}
+
+		/* The padding after the header is already cleared. */
+		hdr_set(buffer, rd, 0);
+		atomic_set(&buffer->rd_idx, 0);
+	}
+
+	*len = (HDR_LEN(hdr) - 1) * sizeof(uint32_t);
+
+	return &buffer->buf[rd + 1];
+}
+
+void mpsc_pbuf_free(struct mpsc_pbuf_buffer *buffer, const void *data)
+{
+	uint32_t idx = (const uint32_t *)data - buffer->buf - 1;
+	uint32_t wlen = HDR_LEN(hdr_get(buffer, idx));
+	uint32_t new_rd = idx + wlen;
+
+	__ASSERT_NO_MSG(idx == (uint32_t)atomic_get(&buffer->rd_idx));
+
+	/* Clear the space before releasing it to the producers. */
+	memset(&buffer->buf[idx], 0, wlen * sizeof(uint32_t));
+
+	atomic_set(&buffer->rd_idx, new_rd == buffer->size ? 0 : new_rd);
+}
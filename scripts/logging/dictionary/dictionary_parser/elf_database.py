@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import logging
+
+from elftools.elf.elffile import ELFFile
+
+
+# ELF section flags
+SHF_ALLOC = 0x2
+
+# Prefix of the constant data of the log sources, see log_instance.h
+LOG_CONST_PREFIX = "log_const_"
+
+# Size and format of long double, per machine, when it differs from double
+LONG_DOUBLE = {
+    "EM_386": (12, "x87"),
+    "EM_X86_64": (16, "x87"),
+    "EM_RISCV": (16, "binary128"),
+}
+
+
+logger = logging.getLogger("parser")
+
+
+class ElfDatabase():
+    """
+    Class to resolve the format strings and the log source names of a
+    dictionary log stream from the ELF file of the image.
+    """
+
+    def __init__(self, elffile):
+        self.elffile = elffile
+        self.regions = list()
+        self.sources = list()
+        self.strings = dict()
+        self.little_endian = True
+        self.ptr_size = 4
+        self.long_double_size = 8
+        self.long_double_format = "double"
+
+    def parse(self):
+        with open(self.elffile, "rb") as fd:
+            elf = ELFFile(fd)
+
+            self.little_endian = elf.little_endian
+            self.ptr_size = elf.elfclass // 8
+            self.long_double_size, self.long_double_format = \
+                LONG_DOUBLE.get(elf["e_machine"], (8, "double"))
+
+            for section in elf.iter_sections():
+                if section["sh_type"] != "SHT_PROGBITS" or \
+                   not section["sh_flags"] & SHF_ALLOC:
+                    continue
+
+                self.regions.append({"start": section["sh_addr"],
+                                     "data": section.data()})
+
+            symtab = elf.get_section_by_name(".symtab")
+            if symtab is None:
+                logger.error("No symbol table in the ELF file")
+                return False
+
+            sources = list()
+            for sym in symtab.iter_symbols():
+                if sym.name.startswith(LOG_CONST_PREFIX) and \
+                   sym["st_info"]["type"] == "STT_OBJECT":
+                    sources.append(sym["st_value"])
+
+        # Log sources are identified by their index in the sorted section.
+        for addr in sorted(set(sources)):
+            name_ptr = self.read_ptr(addr)
+            name = self.read_string(name_ptr) if name_ptr is not None \
+                else None
+            self.sources.append(name)
+
+        logger.info("%d log sources" % len(self.sources))
+
+        return True
+
+    def read(self, addr, size):
+        for region in self.regions:
+            offset = addr - region["start"]
+            if 0 <= offset and offset + size <= len(region["data"]):
+                return region["data"][offset:offset + size]
+
+        return None
+
+    def read_ptr(self, addr):
+        data = self.read(addr, self.ptr_size)
+        if data is None:
+            return None
+
+        return int.from_bytes(data, self.byteorder())
+
+    def read_string(self, addr):
+        if addr in self.strings:
+            return self.strings[addr]
+
+        string = None
+        for region in self.regions:
+            offset = addr - region["start"]
+            if 0 <= offset < len(region["data"]):
+                end = region["data"].find(b"\0", offset)
+                if end >= 0:
+                    string = region["data"][offset:end].decode(
+                        "utf-8", "replace")
+                break
+
+        self.strings[addr] = string
+
+        return string
+
+    def source_name(self, source_id):
+        if source_id < len(self.sources) and self.sources[source_id]:
+            return self.sources[source_id]
+
+        return "<source %d>" % source_id
+
+    def byteorder(self):
+        return "little" if self.little_endian else "big"
@@ -0,0 +1,411 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import logging
+import math
+import string
+import struct
+
+
+# First byte of the frames and frame types, see log_output_dict.h
+SYNC = 0x5a
+FRAME_MSG = 0
+FRAME_DROPPED = 1
+
+# struct log_dict_msg_hdr and struct log_dict_dropped
+MSG_HDR_FMT = "BBBBHHHHI"
+DROPPED_FMT = "BBBBI"
+
+# Length of the package header following the format string pointer: the
+# length of the arguments and the number of copied strings
+PKG_HDR_LEN = 3
+
+SEVERITY = [None, "err", "wrn", "inf", "dbg"]
+
+# Raw strings (printk) are logged with LOG_LEVEL_NONE
+LEVEL_RAW_STRING = 0
+
+HEXDUMP_BYTES_IN_LINE = 16
+
+FLAGS = "-+ #0'"
+LENGTHS = ["hh", "h", "ll", "l", "j", "z", "t", "L"]
+INT_CONVS = "diouxX"
+FLOAT_CONVS = "aAeEfFgG"
+
+
+logger = logging.getLogger("parser")
+
+
+class LogDecoder():
+    """
+    Class to decode the binary frames of a dictionary log stream, see
+    log_output_dict.h, into text lines.
+
+    Each message carries a cbprintf package: the address of the format
+    string, the length of the arguments and the number of copied strings,
+    followed by the arguments, unaligned, with the sizes of the target
+    types, and by the table of the copied strings. Each entry of the table
+    is the offset of the string pointer in the arguments followed by the
+    null terminated copy.
+    """
+
+    def __init__(self, database, frequency=0):
+        self.db = database
+        self.frequency = frequency
+        order = "<" if database.little_endian else ">"
+        self.hdr = struct.Struct(order + MSG_HDR_FMT)
+        self.dropped = struct.Struct(order + DROPPED_FMT)
+        self.order = order
+
+    def decode(self, data):
+        """Decode all complete frames of data, return the lines and the
+        number of bytes consumed. Bytes which do not form a valid frame are
+        skipped up to the next sync byte."""
+        lines = list()
+        offset = 0
+
+        while offset < len(data):
+            frame_lines, size = self.frame_decode(data, offset)
+
+            if size is None:
+                end = data.find(bytes([SYNC]), offset + 1)
+                end = len(data) if end < 0 else end
+                logger.warning("%d bytes skipped at offset %d, stream out "
+                               "of sync" % (end - offset, offset))
+                offset = end
+                continue
+
+            if size == 0:
+                break
+
+            lines.extend(frame_lines)
+            offset += size
+
+        return lines, offset
+
+    def frame_decode(self, data, offset):
+        """Decode the frame at offset, return its lines and its size. The
+        size is 0 if the frame is incomplete, and None if there is no valid
+        frame at offset."""
+        if data[offset] != SYNC:
+            return None, None
+
+        if offset + 2 > len(data):
+            return None, 0
+
+        frame_type = data[offset + 1]
+
+        if frame_type == FRAME_DROPPED:
+            if offset + self.dropped.size > len(data):
+                return None, 0
+
+            (_, _, reserved0, reserved1,
+             count) = self.dropped.unpack_from(data, offset)
+            if reserved0 or reserved1:
+                return None, None
+
+            return ["--- %d messages dropped ---" % count], \
+                self.dropped.size
+
+        if frame_type == FRAME_MSG:
+            if offset + self.hdr.size > len(data):
+                return None, 0
+
+            (_, _, level, domain_id, source_id, package_len, data_len,
+             reserved, timestamp) = self.hdr.unpack_from(data, offset)
+            if reserved or level >= len(SEVERITY) or \
+               0 < package_len < self.db.ptr_size + PKG_HDR_LEN:
+                return None, None
+
+            size = self.hdr.size + package_len + data_len
+            if offset + size > len(data):
+                return None, 0
+
+            start = offset + self.hdr.size
+            package = data[start:start + package_len]
+            hexdump = data[start + package_len:offset + size]
+
+            return self.msg_lines(level, domain_id, source_id, timestamp,
+                                  package, hexdump), size
+
+        return None, None
+
+    def msg_lines(self, level, domain_id, source_id, timestamp, package,
+                  hexdump):
+        text = self.package_format(package) if package else ""
+
+        if level == LEVEL_RAW_STRING:
+            return [text.rstrip("\n")]
+
+        prefix = "%s<%s> %s: " % (self.timestamp_format(timestamp),
+                                  SEVERITY[level] if level < len(SEVERITY)
+                                  else "?",
+                                  self.db.source_name(source_id))
+        lines = [prefix + text]
+
+        for i in range(0, len(hexdump), HEXDUMP_BYTES_IN_LINE):
+            lines.append(" " * len(prefix) + self.hexdump_line(
+                hexdump[i:i + HEXDUMP_BYTES_IN_LINE]))
+
+        return lines
+
+    def timestamp_format(self, timestamp):
+        if not self.frequency:
+            return "[%08u] " % timestamp
+
+        seconds, remainder = divmod(timestamp, self.frequency)
+        hours, seconds = divmod(seconds, 3600)
+        mins, seconds = divmod(seconds, 60)
+        us = remainder * 1000000 // self.frequency
+
+        return "[%02d:%02d:%02d.%03d,%03d] " % (hours, mins, seconds,
+                                                us // 1000, us % 1000)
+
+    @staticmethod
+    def hexdump_line(data):
+        hex_part = ""
+        char_part = ""
+
+        for i in range(HEXDUMP_BYTES_IN_LINE):
+            if i > 0 and i % 8 == 0:
+                hex_part += " "
+                char_part += " "
+
+            if i < len(data):
+                hex_part += "%02x " % data[i]
+                c = chr(data[i])
+                char_part += c if c in string.printable and \
+                    c not in "\t\n\r\x0b\x0c" else "."
+            else:
+                hex_part += "   "
+                char_part += " "
+
+        return hex_part + "|" + char_part
+
+    def package_format(self, package):
+        reader = PackageReader(package, self.order, self.db)
+        try:
+            fmt_addr = reader.header()
+        except IndexError:
+            return "<truncated package>"
+
+        fmt = self.db.read_string(fmt_addr)
+        if fmt is None:
+            return "<format string at 0x%x not in the ELF file>" % fmt_addr
+
+        try:
+            return self.format(fmt, reader)
+        except IndexError:
+            return "<truncated package for \"%s\">" % fmt
+
+    def format(self, fmt, reader):
+        out = ""
+        i = 0
+
+        while i < len(fmt):
+            if fmt[i] != "%":
+                out += fmt[i]
+                i += 1
+                continue
+
+            spec, i = self.conv_parse(fmt, i + 1)
+            out += self.conv_format(spec, reader)
+
+        return out
+
+    @staticmethod
+    def conv_parse(fmt, i):
+        spec = {"flags": "", "width": "", "precision": None,
+                "length": "", "conv": ""}
+
+        while i < len(fmt) and fmt[i] in FLAGS:
+            spec["flags"] += fmt[i]
+            i += 1
+
+        while i < len(fmt) and (fmt[i].isdigit() or fmt[i] == "*"):
+            spec["width"] += fmt[i]
+            i += 1
+
+        if i < len(fmt) and fmt[i] == ".":
+            spec["precision"] = ""
+            i += 1
+            while i < len(fmt) and (fmt[i].isdigit() or fmt[i] == "*"):
+                spec["precision"] += fmt[i]
+                i += 1
+
+        for length in LENGTHS:
+            if fmt.startswith(length, i):
+                spec["length"] = length
+                i += len(length)
+                break
+
+        if i < len(fmt):
+            spec["conv"] = fmt[i]
+            i += 1
+
+        return spec, i
+
+    def conv_format(self, spec, reader):
+        conv = spec["conv"]
+
+        if conv == "%":
+            return "%"
+
+        if conv == "" or conv not in INT_CONVS + FLOAT_CONVS + "cspn":
+            return "%" + spec["flags"] + spec["width"] + \
+                ("." + spec["precision"]
+                 if spec["precision"] is not None else "") + \
+                spec["length"] + conv
+
+        width = spec["width"]
+        if width == "*":
+            width = str(reader.int(4, True))
+            if width.startswith("-"):
+                spec["flags"] += "-"
+                width = width[1:]
+
+        precision = spec["precision"]
+        if precision == "*":
+            value = reader.int(4, True)
+            precision = str(value) if value >= 0 else None
+
+        pyspec = "%" + spec["flags"].replace("'", "") + width
+        if precision is not None:
+            pyspec += "." + (precision or "0")
+
+        if conv in INT_CONVS:
+            value = reader.int(self.int_size(spec["length"]),
+                               conv in "di")
+            bits = {"hh": 8, "h": 16}.get(spec["length"])
+            if bits:
+                value &= (1 << bits) - 1
+                if conv in "di" and value >> (bits - 1):
+                    value -= 1 << bits
+            if conv == "o" and "#" in pyspec:
+                # Python prefixes octal with "0o", C with "0".
+                pyspec = pyspec.replace("#", "")
+                return (pyspec + "s") % ("0%o" % value if value else "0")
+            return (pyspec + conv) % value
+
+        if conv in FLOAT_CONVS:
+            size = self.db.long_double_size if spec["length"] == "L" else 8
+            value = reader.float(size)
+            if conv in "aA":
+                text = float.hex(value)
+                return text.upper() if conv == "A" else text
+            return (pyspec + conv) % value
+
+        if conv == "c":
+            return (pyspec + "c") % chr(reader.int(4, False) & 0xff)
+
+        if conv == "s":
+            return (pyspec + "s") % reader.string()
+
+        if conv == "p":
+            value = reader.int(self.db.ptr_size, False)
+            return (pyspec + "s") % ("0x%x" % value)
+
+        # Nothing is written by %n, its pointer is skipped.
+        reader.int(self.db.ptr_size, False)
+        return ""
+
+    def int_size(self, length):
+        ptr_size = self.db.ptr_size
+
+        return {"": 4, "hh": 4, "h": 4, "l": ptr_size, "ll": 8, "j": 8,
+                "z": ptr_size, "t": ptr_size}.get(length, 4)
+
+
+class PackageReader():
+    """
+    Class to read the arguments of a package in order.
+    """
+
+    def __init__(self, package, order, database):
+        self.package = package
+        self.order = order
+        self.db = database
+        self.offset = 0
+        self.args = 0
+        self.strings = dict()
+
+    def header(self):
+        """Read the header and the strings table, return the address of the
+        format string."""
+        fmt_addr = self.int(self.db.ptr_size, False)
+        args_len = self.int(2, False)
+        str_cnt = self.int(1, False)
+        self.args = self.offset
+
+        offset = self.args + args_len
+        for _ in range(str_cnt):
+            end = self.package.find(b"\0", offset + 1)
+            if offset >= len(self.package) or end < 0:
+                raise IndexError
+            text = self.package[offset + 1:end].decode("utf-8", "replace")
+            self.strings[self.package[offset]] = text
+            offset = end + 1
+
+        return fmt_addr
+
+    def take(self, size):
+        if self.offset + size > len(self.package):
+            raise IndexError
+
+        data = self.package[self.offset:self.offset + size]
+        self.offset += size
+
+        return data
+
+    def int(self, size, signed):
+        return int.from_bytes(self.take(size), self.db.byteorder(),
+                              signed=signed)
+
+    def float(self, size):
+        data = self.take(size)
+
+        if size == 8 or self.db.long_double_format == "double":
+            return struct.unpack(self.order + "d", data[:8])[0]
+
+        if not self.db.little_endian:
+            data = data[::-1]
+
+        if self.db.long_double_format == "x87":
+            # 80-bit extended precision, padded to the type size
+            mantissa = int.from_bytes(data[0:8], "little")
+            sign_exp = int.from_bytes(data[8:10], "little")
+            sign = -1.0 if sign_exp & 0x8000 else 1.0
+            exponent = sign_exp & 0x7fff
+            if exponent == 0x7fff:
+                return sign * math.inf if mantissa << 1 == 0 else math.nan
+            return sign * math.ldexp(mantissa, exponent - 16383 - 63)
+
+        # IEEE 754 binary128
+        value = int.from_bytes(data, "little")
+        sign = -1.0 if value >> 127 else 1.0
+        exponent = (value >> 112) & 0x7fff
+        mantissa = value & ((1 << 112) - 1)
+        if exponent == 0x7fff:
+            return sign * math.inf if mantissa == 0 else math.nan
+        if exponent == 0:
+            return sign * math.ldexp(mantissa, -16382 - 112)
+        return sign * math.ldexp(mantissa | (1 << 112),
+                                 exponent - 16383 - 112)
+
+    def string(self):
+        slot = self.offset - self.args
+        addr = self.int(self.db.ptr_size, False)
+
+        if slot in self.strings:
+            return self.strings[slot]
+
+        if addr == 0:
+            return "(null)"
+
+        # Strings not copied in the package are read from the ELF file.
+        text = self.db.read_string(addr)
+
+        return text if text is not None else "<string at 0x%x>" % addr
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Decode the output of a dictionary logging backend, see
+CONFIG_LOG_BACKEND_UART_OUTPUT_DICTIONARY, into text.
+
+The format strings and the names of the log sources are read from the
+ELF file of the image which produced the log.
+"""
+
+import argparse
+import binascii
+import logging
+import os
+import sys
+
+from dictionary_parser.elf_database import ElfDatabase
+from dictionary_parser.log_decoder import LogDecoder
+
+LOGGING_FORMAT = "[%(levelname)s][%(name)s] %(message)s"
+
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+
+    parser.add_argument("elffile", help="Zephyr ELF binary")
+    parser.add_argument("logfile", help="Binary log file, - for stdin")
+    parser.add_argument("--hex", action="store_true",
+                        help="Log file is a hexadecimal string")
+    parser.add_argument("--frequency", type=int, default=0,
+                        help="Timestamp frequency in Hz, to format "
+                             "timestamps as time")
+    parser.add_argument("--debug", action="store_true",
+                        help="Print extra debugging information")
+    parser.add_argument("-v", "--verbose", action="store_true",
+                        help="Print more information")
+
+    return parser.parse_args()
+
+
+def read_log(args):
+    if args.logfile == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.logfile, "rb") as fd:
+            data = fd.read()
+
+    if args.hex:
+        data = binascii.unhexlify(b"".join(data.split()))
+
+    return data
+
+
+def main():
+    args = parse_args()
+
+    # Setup logging
+    logging.basicConfig(format=LOGGING_FORMAT)
+
+    logger = logging.getLogger("parser")
+    if args.debug:
+        logger.setLevel(logging.DEBUG)
+    elif args.verbose:
+        logger.setLevel(logging.INFO)
+    else:
+        logger.setLevel(logging.WARNING)
+
+    if not os.path.isfile(args.elffile):
+        logger.error(f"Cannot find file {args.elffile}, exiting...")
+        sys.exit(1)
+
+    if args.logfile != "-" and not os.path.isfile(args.logfile):
+        logger.error(f"Cannot find file {args.logfile}, exiting...")
+        sys.exit(1)
+
+    database = ElfDatabase(args.elffile)
+    if not database.parse():
+        logger.error("Cannot parse the ELF file, exiting...")
+        sys.exit(1)
+
+    data = read_log(args)
+    decoder = LogDecoder(database, args.frequency)
+    lines, consumed = decoder.decode(data)
+
+    for line in lines:
+        print(line)
+
+    if consumed != len(data):
+        logger.warning("Log truncated, last frame incomplete")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Intel Corporation.
+#
+# SPDX-License-Identifier: Apache-2.0
+"""
+Host client for the binary shell backend, see CONFIG_SHELL_BACKEND_BIN and
+include/shell/shell_bin.h.
+
+Commands are given on the command line, or read from the standard input one
+per line. The output of each command is printed, and the script exits with
+1 if any command returned a non-zero value:
+
+    ./scripts/shell/shell_bin.py -p /dev/ttyUSB1 "kernel version" "log status"
+
+The ShellBin class can also be imported by test tools:
+
+    shell = ShellBin(serial.Serial("/dev/ttyUSB1", 115200))
+    ret, output = shell.run("kernel version")
+"""
+
+import argparse
+import binascii
+import struct
+import sys
+import time
+
+SYNC = 0xA5
+FRAME_CMD = 0x01
+FRAME_OUTPUT = 0x81
+FRAME_RESULT = 0x82
+FRAME_LOG = 0x83
+
+# struct shell_bin_hdr without the sync byte
+HDR = struct.Struct("<BHH")
+CRC = struct.Struct("<H")
+
+# Larger than the payloads sent by the default configurations, a header
+# with a longer payload is taken as a wrong sync byte.
+MAX_PAYLOAD = 512
+
+# CONFIG_SHELL_CMD_BUFF_SIZE - 1 of the default configuration. The device
+# drops longer commands without a result.
+MAX_CMD = 255
+
+
+def frame_encode(frame_type, seq, payload):
+    """Return the frame carrying payload."""
+    body = HDR.pack(frame_type, seq, len(payload)) + payload
+
+    return bytes([SYNC]) + body + CRC.pack(binascii.crc_hqx(body, 0))
+
+
+class FrameDecoder():
+    """
+    Class to extract the frames from a byte stream. Bytes before a sync
+    byte, and frames with a wrong CRC, are skipped.
+    """
+
+    def __init__(self, max_payload=MAX_PAYLOAD):
+        self.buf = bytearray()
+        self.max_payload = max_payload
+
+    def feed(self, data):
+        """Add data, return the list of complete (type, seq, payload)."""
+        frames = list()
+        self.buf += data
+
+        while True:
+            start = self.buf.find(bytes([SYNC]))
+            if start < 0:
+                self.buf.clear()
+                break
+            del self.buf[:start]
+
+            if len(self.buf) < 1 + HDR.size:
+                break
+
+            frame_type, seq, length = HDR.unpack_from(self.buf, 1)
+            if length > self.max_payload:
+                del self.buf[0]
+                continue
+
+            end = 1 + HDR.size + length
+            if len(self.buf) < end + CRC.size:
+                break
+
+            (crc,) = CRC.unpack_from(self.buf, end)
+            if crc != binascii.crc_hqx(bytes(self.buf[1:end]), 0):
+                # Not a frame, look for the next sync byte.
+                del self.buf[0]
+                continue
+
+            frames.append((frame_type, seq, bytes(self.buf[1 + HDR.size:end])))
+            del self.buf[:end + CRC.size]
+
+        return frames
+
+
+class ShellBin():
+    """
+    Class to run shell commands over a serial port, which must have a read
+    timeout set.
+    """
+
+    def __init__(self, port, timeout=5.0, log=None, max_cmd=MAX_CMD):
+        self.port = port
+        self.timeout = timeout
+        self.log = log
+        self.max_cmd = max_cmd
+        self.seq = 0
+        self.decoder = FrameDecoder()
+
+    def run(self, cmd):
+        """Execute a command, return its return value and output.
+
+        Raise ValueError if the command is too long for the device, and
+        TimeoutError if the command does not complete in time."""
+        data = cmd.encode()
+        if len(data) > self.max_cmd:
+            raise ValueError("\"%s\" is longer than %d bytes" %
+                             (cmd, self.max_cmd))
+
+        self.seq = (self.seq % 0xffff) + 1
+        seq = self.seq
+        output = bytearray()
+        deadline = time.monotonic() + self.timeout
+
+        self.port.write(frame_encode(FRAME_CMD, seq, data))
+
+        while time.monotonic() < deadline:
+            data = self.port.read(max(1, self.port.in_waiting))
+            for frame_type, frame_seq, payload in self.decoder.feed(data):
+                if frame_type == FRAME_LOG:
+                    if self.log:
+                        self.log(payload.decode("utf-8", "replace"))
+                elif frame_seq != seq:
+                    # Late frame of a command which timed out.
+                    continue
+                elif frame_type == FRAME_OUTPUT:
+                    output += payload
+                elif frame_type == FRAME_RESULT:
+                    (ret,) = struct.unpack("<i", payload)
+                    return ret, output.decode("utf-8", "replace")
+
+        raise TimeoutError("no result for \"%s\"" % cmd)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+            description=__doc__,
+            formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-p", "--port", required=True,
+            help="Serial port")
+    parser.add_argument("-b", "--baudrate", type=int, default=115200,
+            help="Serial baudrate (default: %(default)s)")
+    parser.add_argument("-t", "--timeout", type=float, default=5.0,
+            help="Command timeout in seconds (default: %(default)s)")
+    parser.add_argument("-m", "--max-cmd", type=int, default=MAX_CMD,
+            help="CONFIG_SHELL_CMD_BUFF_SIZE of the device minus 1 "
+                 "(default: %(default)s)")
+    parser.add_argument("-l", "--log", action="store_true",
+            help="Print the log messages to the standard error")
+    parser.add_argument("cmds", nargs="*",
+            help="Commands, read from the standard input if none")
+
+    return parser.parse_args()
+
+
+def main():
+    try:
+        import serial
+    except ImportError:
+        sys.exit("Missing dependency: You need to install pyserial.")
+
+    args = parse_args()
+    port = serial.Serial(args.port, args.baudrate, timeout=0.05)
+    log = (lambda text: sys.stderr.write(text)) if args.log else None
+    shell = ShellBin(port, args.timeout, log, args.max_cmd)
+    cmds = args.cmds or (line.strip() for line in sys.stdin)
+    failed = False
+
+    for cmd in cmds:
+        if not cmd:
+            continue
+
+        try:
+            ret, output = shell.run(cmd)
+        except (ValueError, TimeoutError) as e:
+            sys.stderr.write("%s\n" % e)
+            failed = True
+            continue
+
+        sys.stdout.write(output)
+        if ret != 0:
+            sys.stderr.write("\"%s\" returned %d\n" % (cmd, ret))
+            failed = True
+
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+# Copyright (c) 2021 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""tests for the dictionary log decoder"""
+
+import os
+import struct
+import sys
+
+import pytest
+
+sys.path.insert(0, os.path.join(os.environ["ZEPHYR_BASE"],
+                                "scripts/logging/dictionary"))
+from dictionary_parser import log_decoder as iut  # Implementation Under Test
+
+# Address of the format strings in the fake image
+FMT_ADDR = 0x1000
+
+
+class FakeDatabase():
+    """Image of a 32-bit little endian target"""
+
+    def __init__(self, strings):
+        self.little_endian = True
+        self.ptr_size = 4
+        self.long_double_size = 8
+        self.long_double_format = "double"
+        self.strings = strings
+
+    def read_string(self, addr):
+        return self.strings.get(addr)
+
+    def source_name(self, source_id):
+        return "src%d" % source_id
+
+    def byteorder(self):
+        return "little"
+
+
+def package(args=b"", strings=()):
+    """Package of the format at FMT_ADDR, with the copied strings given as
+    (slot, text)"""
+    data = struct.pack("<IHB", FMT_ADDR, len(args), len(strings)) + args
+    for slot, text in strings:
+        data += bytes([slot]) + text.encode() + b"\0"
+
+    return data
+
+
+def msg_frame(pkg, hexdump=b"", level=3, timestamp=10):
+    return struct.pack("<BBBBHHHHI", iut.SYNC, iut.FRAME_MSG, level, 0, 1,
+                       len(pkg), len(hexdump), 0, timestamp) + pkg + hexdump
+
+
+def dropped_frame(count):
+    return struct.pack("<BBBBI", iut.SYNC, iut.FRAME_DROPPED, 0, 0, count)
+
+
+def decode(data, fmt, strings=None):
+    strings = dict(strings or {})
+    strings[FMT_ADDR] = fmt
+    database = FakeDatabase(strings)
+
+    return iut.LogDecoder(database).decode(data)
+
+
+@pytest.mark.parametrize("fmt, args, text", [
+    ("%lld %d", struct.pack("<qi", -2**40, 5), "-1099511627776 5"),
+    ("%llx", struct.pack("<Q", 0x123456789a), "123456789a"),
+    ("%hhd %c", struct.pack("<ii", 0x1ff, 0x41), "-1 A"),
+    ("%.2f", struct.pack("<d", 1.125), "1.12"),
+    ("%p", struct.pack("<I", 0x2000), "0x2000"),
+    ("%d%n%d", struct.pack("<iIi", 1, 0x3000, 2), "12"),
+    ("%*d|", struct.pack("<ii", 4, 7), "   7|"),
+])
+def test_args(fmt, args, text):
+    """Arguments are read with the sizes of the target types"""
+    lines, consumed = decode(msg_frame(package(args)), fmt)
+
+    assert lines == ["[00000010] <inf> src1: " + text]
+    assert consumed == len(msg_frame(package(args)))
+
+
+def test_strings():
+    """Copied strings come from the package, the others from the image"""
+    args = struct.pack("<III", 0x8000, 0x2000, 0)
+    data = msg_frame(package(args, [(0, "copied")]))
+
+    lines, _ = decode(data, "%s %s %s", {0x2000: "in image"})
+
+    assert lines == ["[00000010] <inf> src1: copied in image (null)"]
+
+
+def test_string_not_in_image():
+    data = msg_frame(package(struct.pack("<I", 0x8000)))
+
+    lines, _ = decode(data, "%s")
+
+    assert lines == ["[00000010] <inf> src1: <string at 0x8000>"]
+
+
+def test_hexdump():
+    """Hexdump data follows the package, 16 bytes per line"""
+    data = msg_frame(package(), bytes(range(0x41, 0x41 + 18)))
+
+    lines, _ = decode(data, "hex")
+
+    prefix = "[00000010] <inf> src1: "
+    assert lines[0] == prefix + "hex"
+    assert len(lines) == 3
+    assert lines[1].startswith(" " * len(prefix) + "41 42 43")
+    assert lines[1].endswith("|ABCDEFGH IJKLMNOP")
+    assert lines[2].strip().startswith("51 52")
+
+
+def test_raw_string():
+    """printk() messages are printed without prefix"""
+    lines, _ = decode(msg_frame(package(), level=0), "raw\n")
+
+    assert lines == ["raw"]
+
+
+def test_dropped():
+    data = msg_frame(package()) + dropped_frame(3)
+
+    lines, consumed = decode(data, "msg")
+
+    assert lines == ["[00000010] <inf> src1: msg",
+                     "--- 3 messages dropped ---"]
+    assert consumed == len(data)
+
+
+def test_truncated_frame():
+    """The last frame is only decoded once complete"""
+    first = msg_frame(package(struct.pack("<i", 1)))
+    second = msg_frame(package(struct.pack("<i", 2)))
+
+    for cut in range(1, len(second)):
+        lines, consumed = decode(first + second[:cut], "%d")
+
+        assert lines == ["[00000010] <inf> src1: 1"]
+        assert consumed == len(first)
+
+
+def test_truncated_package():
+    """A package shorter than its arguments is reported"""
+    lines, _ = decode(msg_frame(package(struct.pack("<i", 1))), "%d %d")
+
+    assert lines == ["[00000010] <inf> src1: <truncated package for "
+                     "\"%d %d\">"]
+
+
+def test_package_reader():
+    pkg = package(struct.pack("<iI", -1, 0x8000), [(4, "str")])
+    reader = iut.PackageReader(pkg, "<", FakeDatabase({}))
+
+    assert reader.header() == FMT_ADDR
+    assert reader.int(4, True) == -1
+    assert reader.string() == "str"
+
+    reader = iut.PackageReader(package(struct.pack("<i", 1)), "<",
+                               FakeDatabase({}))
+    reader.header()
+    assert reader.int(4, False) == 1
+    with pytest.raises(IndexError):
+        reader.int(4, False)
+
+
+def test_resync_other_output():
+    """Other output between frames is skipped"""
+    first = msg_frame(package(struct.pack("<i", 1)))
+    second = msg_frame(package(struct.pack("<i", 2)))
+    data = b"Hello\r\n" + first + b"booting\r\n" + bytes([iut.SYNC, 7]) + \
+        second
+
+    lines, consumed = decode(data, "%d")
+
+    assert lines == ["[00000010] <inf> src1: 1",
+                     "[00000010] <inf> src1: 2"]
+    assert consumed == len(data)
+
+
+def test_resync_lost_byte():
+    """A lost byte only costs the frames around it"""
+    frames = [msg_frame(package(struct.pack("<i", i)), timestamp=i)
+              for i in range(1, 5)]
+    data = frames[0] + frames[1][:-1] + b"".join(frames[2:])
+
+    lines, consumed = decode(data, "%d")
+
+    assert lines[0] == "[00000001] <inf> src1: 1"
+    assert lines[-1] == "[00000004] <inf> src1: 4"
+    assert consumed == len(data)
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+# Copyright (c) 2021 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""tests for shell_bin.py"""
+
+import binascii
+import os
+import struct
+import sys
+
+import pytest
+
+sys.path.insert(0, os.path.join(os.environ["ZEPHYR_BASE"], "scripts/shell"))
+import shell_bin as iut  # Implementation Under Test
+
+
+class FakePort():
+    """Serial port answering each command frame with the given frames"""
+
+    def __init__(self, reply):
+        self.reply = reply
+        self.written = bytearray()
+        self.rx = bytearray()
+
+    @property
+    def in_waiting(self):
+        return len(self.rx)
+
+    def write(self, data):
+        self.written += data
+        (_, seq, _), = iut.FrameDecoder().feed(data)
+        self.rx += b"".join(self.reply(seq))
+
+    def read(self, size):
+        data = bytes(self.rx[:size])
+        del self.rx[:size]
+        return data
+
+
+def test_frame_encode():
+    """Frames match struct shell_bin_hdr with a CRC-16/XMODEM"""
+    frame = iut.frame_encode(iut.FRAME_CMD, 0x1234, b"help")
+
+    assert frame[:6] == bytes([0xa5, 0x01, 0x34, 0x12, 0x04, 0x00])
+    assert frame[6:10] == b"help"
+    assert struct.unpack("<H", frame[10:])[0] == \
+        binascii.crc_hqx(frame[1:10], 0)
+    # CRC-16/XMODEM check value
+    assert binascii.crc_hqx(b"123456789", 0) == 0x31c3
+
+
+def test_decoder_split():
+    """Frames are decoded whatever the chunks they are received in"""
+    data = iut.frame_encode(iut.FRAME_OUTPUT, 1, b"abc") + \
+        iut.frame_encode(iut.FRAME_RESULT, 1, struct.pack("<i", -22))
+    decoder = iut.FrameDecoder()
+    frames = []
+
+    for i in range(len(data)):
+        frames += decoder.feed(data[i:i + 1])
+
+    assert frames == [
+        (iut.FRAME_OUTPUT, 1, b"abc"),
+        (iut.FRAME_RESULT, 1, struct.pack("<i", -22)),
+    ]
+
+
+def test_decoder_resync():
+    """Garbage, wrong CRCs and false sync bytes are skipped"""
+    bad_crc = bytearray(iut.frame_encode(iut.FRAME_OUTPUT, 2, b"bad"))
+    bad_crc[-1] ^= 0xff
+    # a sync byte followed by a length beyond the maximum payload
+    too_long = bytes([iut.SYNC]) + iut.HDR.pack(iut.FRAME_OUTPUT, 3, 0xffff)
+    good = iut.frame_encode(iut.FRAME_LOG, 0, b"log")
+
+    frames = iut.FrameDecoder().feed(b"\x00\xa5garbage" + bytes(bad_crc) +
+                                     too_long + good)
+    assert frames == [(iut.FRAME_LOG, 0, b"log")]
+
+
+def test_run():
+    """Output of the command is gathered until its result"""
+    logs = []
+
+    def reply(seq):
+        return [
+            iut.frame_encode(iut.FRAME_OUTPUT, seq, b"Zephyr "),
+            iut.frame_encode(iut.FRAME_LOG, 0, b"<inf> test: hi\r\n"),
+            # late output of a previous command
+            iut.frame_encode(iut.FRAME_OUTPUT, seq + 1, b"late"),
+            iut.frame_encode(iut.FRAME_OUTPUT, seq, b"2.5\r\n"),
+            iut.frame_encode(iut.FRAME_RESULT, seq, struct.pack("<i", 0)),
+        ]
+
+    port = FakePort(reply)
+    shell = iut.ShellBin(port, timeout=1.0, log=logs.append)
+
+    assert shell.run("kernel version") == (0, "Zephyr 2.5\r\n")
+    assert shell.run("kernel version") == (0, "Zephyr 2.5\r\n")
+    assert logs == ["<inf> test: hi\r\n"] * 2
+
+    frames = iut.FrameDecoder().feed(port.written)
+    assert frames == [
+        (iut.FRAME_CMD, 1, b"kernel version"),
+        (iut.FRAME_CMD, 2, b"kernel version"),
+    ]
+
+
+def test_run_errors():
+    """Missing results time out and long commands are not sent"""
+    port = FakePort(lambda seq: [])
+    shell = iut.ShellBin(port, timeout=0.1, max_cmd=8)
+
+    with pytest.raises(TimeoutError):
+        shell.run("kernel")
+    with pytest.raises(ValueError):
+        shell.run("kernel version")
+
+    assert len(iut.FrameDecoder().feed(port.written)) == 1
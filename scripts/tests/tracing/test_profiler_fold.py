@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+# Copyright (c) 2021 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""tests for profiler_fold.py"""
+
+import os
+import struct
+import sys
+
+import pytest
+
+sys.path.insert(0, os.path.join(os.environ["ZEPHYR_BASE"], "scripts/tracing"))
+import profiler_fold as iut  # Implementation Under Test
+
+THREAD_MAIN = 0x20000100
+THREAD_IDLE = 0x20000200
+
+FUNCS = [
+    (0x1000, 0x40, "main"),
+    (0x1040, 0x20, "compute"),
+    (0x1060, 0x10, "idle"),
+]
+OBJECTS = [
+    (THREAD_MAIN, 0x80, "z_main_thread"),
+    (THREAD_IDLE, 0x80, "z_idle_threads"),
+]
+
+
+def frame(thread, pcs, order="<", cpu=0):
+    """Pack a sample as struct profiler_sample_frame followed by the PCs"""
+    return struct.pack(order + "BBBBI", iut.FRAME_SYNC, iut.FRAME_SAMPLE, cpu,
+                       len(pcs), thread) + \
+        struct.pack(order + "%dI" % len(pcs), *pcs)
+
+
+@pytest.fixture(name="symbols")
+def _symbols():
+    return iut.Symbols(FUNCS, OBJECTS)
+
+
+def test_samples():
+    """Frames are unpacked in both byte orders and with any depth"""
+    for order in "<>":
+        data = frame(THREAD_MAIN, [0x1044, 0x1010], order, cpu=1) + \
+            frame(THREAD_IDLE, [0x1062], order)
+        assert list(iut.samples(data, order)) == [
+            (1, THREAD_MAIN, (0x1044, 0x1010)),
+            (0, THREAD_IDLE, (0x1062,)),
+        ]
+
+
+def test_samples_truncated():
+    """A frame cut short at the end of the capture is ignored"""
+    data = frame(THREAD_MAIN, [0x1044]) + frame(THREAD_MAIN, [0x1044, 0x1010])
+    assert len(list(iut.samples(data[:-2], "<"))) == 1
+    assert len(list(iut.samples(data[:-12], "<"))) == 1
+
+
+def test_samples_resync():
+    """Other output and invalid frames are skipped up to the next sync"""
+    sample = frame(THREAD_MAIN, [0x1044])
+    other = bytearray(frame(THREAD_IDLE, [0x1062]))
+    other[1] = ord('X')
+    deep = frame(THREAD_IDLE, [0x1062] * (iut.MAX_DEPTH + 1))
+
+    data = b"*** Booting Zephyr OS ***\r\n" + sample + bytes(other) + \
+        sample + deep + bytes([iut.FRAME_SYNC, 0]) + sample
+    assert list(iut.samples(data, "<")) == [(0, THREAD_MAIN, (0x1044,))] * 3
+
+
+def test_samples_lost_byte():
+    """A lost byte only costs the frames around it"""
+    frames = [frame(THREAD_MAIN + 4 * i, [0x1044, 0x1010]) for i in range(4)]
+    data = frames[0] + frames[1][:5] + frames[1][6:] + b"".join(frames[2:])
+
+    threads = [thread for _, thread, _ in iut.samples(data, "<")]
+    assert threads[0] == THREAD_MAIN
+    assert threads[-2:] == [THREAD_MAIN + 8, THREAD_MAIN + 12]
+
+
+def test_symbols(symbols):
+    """PCs and threads map to the symbols containing them"""
+    assert symbols.func(0x1000) == "main"
+    assert symbols.func(0x103f) == "main"
+    assert symbols.func(0x1040) == "compute"
+    assert symbols.func(0x2000) == "0x2000"
+    assert symbols.func(0) == "[interrupt]"
+    assert symbols.thread(THREAD_IDLE + 4) == "z_idle_threads"
+    assert symbols.thread(0x30000000) == "thread_0x30000000"
+
+
+def test_fold(symbols):
+    """Samples fold to root to leaf stacks with their number of samples"""
+    data = frame(THREAD_MAIN, [0x1044, 0x1010]) * 3 + \
+        frame(THREAD_MAIN, [0x1004, 0x1010]) + \
+        frame(THREAD_IDLE, [0x1062]) + \
+        frame(THREAD_MAIN, [0])
+
+    stacks, funcs = iut.fold(data, symbols)
+    assert stacks == {
+        "z_main_thread;main;compute": 3,
+        # the stale link register in main is dropped
+        "z_main_thread;main": 1,
+        "z_idle_threads;idle": 1,
+        "z_main_thread;[interrupt]": 1,
+    }
+    assert funcs == {"compute": 3, "main": 1, "idle": 1, "[interrupt]": 1}
+
+    stacks, _ = iut.fold(data, symbols, threads=False)
+    assert stacks["main;compute"] == 3
@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Intel Corporation.
+#
+# SPDX-License-Identifier: Apache-2.0
+"""
+Script to map the samples of the sampling profiler to functions and fold
+them, one line per call stack with its number of samples, as expected by
+flamegraph.pl.
+
+Capture the tracing stream of an image built with CONFIG_TRACING_PROFILER,
+for example with trace_capture_uart.py from the UART given by
+CONFIG_TRACING_BACKEND_UART_NAME, then:
+
+    ./scripts/tracing/profiler_fold.py -e build/zephyr/zephyr.elf \\
+      -t channel0_0 > samples.folded
+    flamegraph.pl samples.folded > samples.svg
+"""
+
+import argparse
+import bisect
+import collections
+import struct
+import sys
+
+try:
+    from elftools.elf.elffile import ELFFile
+except ImportError:
+    sys.exit("Missing dependency: You need to install pyelftools.")
+
+# struct profiler_sample_frame, see tracing_profiler.h
+FRAME_SYNC = 0xa5
+FRAME_SAMPLE = ord('S')
+FRAME_FMT = "BBBBI"
+MAX_DEPTH = 2
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+            description=__doc__,
+            formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-e", "--elf", required=True,
+            help="Zephyr ELF binary")
+    parser.add_argument("-t", "--trace", required=True,
+            help="tracing data captured from the profiler")
+    parser.add_argument("--no-threads", action="store_true",
+            help="do not add the interrupted thread at the stack root")
+    parser.add_argument("--summary", action="store_true",
+            help="print the samples per function instead of folded stacks")
+    return parser.parse_args()
+
+class Symbols():
+    def __init__(self, funcs, objects, order="<"):
+        self.funcs = sorted(funcs)
+        self.objects = sorted(objects)
+        self.order = order
+        self.func_addrs = [f[0] for f in self.funcs]
+        self.object_addrs = [o[0] for o in self.objects]
+
+    @staticmethod
+    def lookup(table, addrs, addr):
+        i = bisect.bisect_right(addrs, addr) - 1
+        if i >= 0 and addr < table[i][0] + table[i][1]:
+            return table[i][2]
+        return None
+
+    def func(self, pc):
+        if pc == 0:
+            return "[interrupt]"
+        return self.lookup(self.funcs, self.func_addrs, pc) or "0x%x" % pc
+
+    def thread(self, addr):
+        return self.lookup(self.objects, self.object_addrs, addr) or \
+            "thread_0x%x" % addr
+
+def samples(data, order):
+    """Yield the samples of the capture. Bytes that do not start a valid
+    frame, followed by the sync byte of the next one, are skipped up to the
+    next sync byte: other output on the UART or frames with lost bytes."""
+    hdr = struct.Struct(order + FRAME_FMT)
+    offset = 0
+
+    while offset + hdr.size <= len(data):
+        sync, frame_type, cpu, depth, thread = hdr.unpack_from(data, offset)
+        valid = sync == FRAME_SYNC and frame_type == FRAME_SAMPLE and \
+            0 < depth <= MAX_DEPTH
+        end = offset + hdr.size + 4 * depth
+        if valid and end > len(data):
+            break
+
+        if not valid or (end < len(data) and data[end] != FRAME_SYNC):
+            end = data.find(bytes([FRAME_SYNC]), offset + 1)
+            if end < 0:
+                end = len(data)
+            print("Skipped %d bytes at offset %d" % (end - offset, offset),
+                  file=sys.stderr)
+            offset = end
+            continue
+
+        pcs = struct.unpack_from(order + "%dI" % depth, data,
+                                 offset + hdr.size)
+        yield cpu, thread, pcs
+        offset = end
+
+def load_symbols(elffile):
+    funcs = []
+    objects = []
+
+    with open(elffile, "rb") as fd:
+        elf = ELFFile(fd)
+        order = "<" if elf.little_endian else ">"
+        symtab = elf.get_section_by_name(".symtab")
+        if symtab is None:
+            sys.exit("No symbol table in %s" % elffile)
+
+        for sym in symtab.iter_symbols():
+            sym_type = sym["st_info"]["type"]
+            # Clear the Thumb bit of function addresses.
+            addr = sym["st_value"] & ~1
+            size = max(sym["st_size"], 1)
+            if sym_type == "STT_FUNC":
+                funcs.append((addr, size, sym.name))
+            elif sym_type == "STT_OBJECT":
+                objects.append((addr, size, sym.name))
+
+    return Symbols(funcs, objects, order)
+
+def fold(data, symbols, threads=True):
+    stacks = collections.Counter()
+    funcs = collections.Counter()
+
+    for _, thread, pcs in samples(data, symbols.order):
+        # Outermost frame first, as folded stacks are root to leaf.
+        frames = [symbols.func(pc) for pc in reversed(pcs)]
+        # A stale link register may point in the interrupted function.
+        if len(frames) == 2 and frames[0] == frames[1]:
+            frames = frames[1:]
+        if threads:
+            frames.insert(0, symbols.thread(thread))
+        stacks[";".join(frames)] += 1
+        funcs[frames[-1]] += 1
+
+    return stacks, funcs
+
+def main():
+    args = parse_args()
+    symbols = load_symbols(args.elf)
+
+    with open(args.trace, "rb") as fd:
+        data = fd.read()
+
+    stacks, funcs = fold(data, symbols, not args.no_threads)
+    total = sum(funcs.values())
+
+    if args.summary:
+        for func, count in funcs.most_common():
+            print("%6.2f%% %8d %s" % (100.0 * count / total, count, func))
+    else:
+        for stack, count in sorted(stacks.items()):
+            print("%s %d" % (stack, count))
+
+if __name__ == "__main__":
+    main()
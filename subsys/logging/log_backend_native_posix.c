@@ -80,6 +80,24 @@ static void put(const struct log_backend *const backend,
 
 }
 
+static void process(const struct log_backend *const backend,
+		    const struct log_msg2 *msg)
+{
+	uint32_t flags = LOG_OUTPUT_FLAG_LEVEL | LOG_OUTPUT_FLAG_TIMESTAMP;
+
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_SHOW_COLOR)) {
+		if (posix_trace_over_tty(0)) {
+			flags |= LOG_OUTPUT_FLAG_COLORS;
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_FORMAT_TIMESTAMP)) {
+		flags |= LOG_OUTPUT_FLAG_FORMAT_TIMESTAMP;
+	}
+
+	log_output_msg2_process(&log_output_posix, msg, flags);
+}
+
 static void panic(struct log_backend const *const backend)
 {
 	log_output_flush(&log_output_posix);
@@ -135,7 +153,9 @@ static void sync_hexdump(const struct log_backend *const backend,
 }
 
 const struct log_backend_api log_backend_native_posix_api = {
-	.put = IS_ENABLED(CONFIG_LOG_IMMEDIATE) ? NULL : put,
+	.put = (IS_ENABLED(CONFIG_LOG_IMMEDIATE) || IS_ENABLED(CONFIG_LOG2)) ?
+		NULL : put,
+	.process = IS_ENABLED(CONFIG_LOG2) ? process : NULL,
 	.put_sync_string = IS_ENABLED(CONFIG_LOG_IMMEDIATE) ?
 			sync_string : NULL,
 	.put_sync_hexdump = IS_ENABLED(CONFIG_LOG_IMMEDIATE) ?
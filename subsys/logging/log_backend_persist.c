@@ -0,0 +1,642 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Log backend keeping the recent messages across resets.
+ *
+ * Formatted messages are stored as records in a ring kept in RAM which is
+ * not initialized at boot, so that they survive a warm reset. The ring can
+ * also be copied to the flash partition labeled "log-persist-partition" in
+ * devicetree, on panic and periodically, so that it survives a power loss.
+ * The partition holds two copies written in turn, a copy is only made valid
+ * once complete so that the previous one is kept until then.
+ *
+ * A record is only made visible by the update of the head of the ring once
+ * it is completely written, and records are only dropped from the tail, so
+ * that a reset at any time leaves a valid ring.
+ */
+
+#include <logging/log_backend.h>
+#include <logging/log_backend_persist.h>
+#include <logging/log_core.h>
+#include <logging/log_ctrl.h>
+#include <logging/log_msg.h>
+#include <logging/log_output.h>
+#include <kernel.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <sys/util.h>
+
+#ifdef CONFIG_LOG_BACKEND_PERSIST_FLASH
+#include <storage/flash_map.h>
+
+#if !FLASH_AREA_LABEL_EXISTS(log_persist_partition)
+#error "Need a fixed partition named 'log-persist-partition'!"
+#endif
+
+#define FLASH_PARTITION FLASH_AREA_ID(log_persist_partition)
+#endif
+
+#define RING_SIZE CONFIG_LOG_BACKEND_PERSIST_RAM_SIZE
+#define RING_MAGIC 0x474f4c50 /* "PLOG" */
+
+/* Attempts to get a consistent copy of the ring in flash. */
+#define FLASH_ATTEMPTS 3
+
+/* Unit of the copies to flash, the first chunk holds the ring header. */
+#define FLASH_CHUNK 64
+
+BUILD_ASSERT((RING_SIZE & (RING_SIZE - 1)) == 0,
+	     "Ring size must be a power of two");
+
+struct record_hdr {
+	uint16_t len;
+	uint16_t source_id;
+	uint16_t boot;
+	uint8_t level;
+	uint8_t reserved;
+	uint32_t seq;
+	uint32_t timestamp;
+};
+
+BUILD_ASSERT(sizeof(struct record_hdr) + CONFIG_LOG_BACKEND_PERSIST_RECORD_MAX
+	     <= RING_SIZE, "Ring too small for the records");
+
+struct ring {
+	uint32_t magic;
+	/* Sequence number of the next record. */
+	uint32_t seq;
+	/* Positions of the next record and of the oldest one, only wrapped
+	 * by the accesses to buf.
+	 */
+	uint32_t head;
+	uint32_t tail;
+	uint16_t boot;
+	uint16_t reserved[3];
+	uint8_t buf[RING_SIZE];
+};
+
+static struct ring ring __noinit __aligned(8);
+static struct k_spinlock lock;
+
+/* Position of the record following the last one read, to read consecutive
+ * records without walking the ring.
+ */
+static uint32_t read_hint_seq;
+static uint32_t read_hint_pos;
+
+static uint8_t staging[CONFIG_LOG_BACKEND_PERSIST_RECORD_MAX];
+static size_t staging_len;
+static bool panic_mode;
+
+static void ring_read(uint32_t pos, void *dst, size_t len)
+{
+	uint32_t idx = pos & (RING_SIZE - 1);
+	size_t first = MIN(len, RING_SIZE - idx);
+
+	memcpy(dst, &ring.buf[idx], first);
+	memcpy((uint8_t *)dst + first, ring.buf, len - first);
+}
+
+static void ring_write(uint32_t pos, const void *src, size_t len)
+{
+	uint32_t idx = pos & (RING_SIZE - 1);
+	size_t first = MIN(len, RING_SIZE - idx);
+
+	memcpy(&ring.buf[idx], src, first);
+	memcpy(ring.buf, (const uint8_t *)src + first, len - first);
+}
+
+static void ring_reset(void)
+{
+	ring.magic = RING_MAGIC;
+	ring.seq = 1U;
+	ring.head = 0U;
+	ring.tail = 0U;
+	ring.boot = 0U;
+}
+
+/* Check the ring left by the previous boot, record by record. */
+static bool ring_mount(void)
+{
+	struct record_hdr hdr;
+	uint32_t pos = ring.tail;
+	uint32_t seq = 0U;
+
+	if (ring.magic != RING_MAGIC || (ring.head - ring.tail) > RING_SIZE) {
+		return false;
+	}
+
+	while (pos != ring.head) {
+		if ((ring.head - pos) < sizeof(hdr)) {
+			return false;
+		}
+
+		ring_read(pos, &hdr, sizeof(hdr));
+		if (hdr.len > CONFIG_LOG_BACKEND_PERSIST_RECORD_MAX ||
+		    (ring.head - pos - sizeof(hdr)) < hdr.len ||
+		    (pos != ring.tail && hdr.seq != seq + 1U)) {
+			return false;
+		}
+
+		seq = hdr.seq;
+		pos += sizeof(hdr) + hdr.len;
+	}
+
+	if (ring.head != ring.tail) {
+		/* A reset may have occurred between the update of the head
+		 * and the one of the sequence number.
+		 */
+		if (seq != ring.seq && seq + 1U != ring.seq) {
+			return false;
+		}
+
+		ring.seq = seq + 1U;
+	}
+
+	return true;
+}
+
+static void record_commit(uint8_t level, uint16_t source_id,
+			  uint32_t timestamp)
+{
+	struct record_hdr hdr = {
+		.len = staging_len,
+		.source_id = source_id,
+		.level = level,
+		.timestamp = timestamp,
+	};
+	size_t len = sizeof(hdr) + staging_len;
+	struct record_hdr old;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&lock);
+
+	while ((RING_SIZE - (ring.head - ring.tail)) < len) {
+		ring_read(ring.tail, &old, sizeof(old));
+		ring.tail += sizeof(old) + old.len;
+	}
+
+	hdr.boot = ring.boot;
+	hdr.seq = ring.seq;
+	ring_write(ring.head, &hdr, sizeof(hdr));
+	ring_write(ring.head + sizeof(hdr), staging, staging_len);
+
+	/* The record must be complete before it becomes visible. */
+	compiler_barrier();
+	ring.head += len;
+	ring.seq++;
+
+	k_spin_unlock(&lock, key);
+
+	staging_len = 0;
+
+	/* The messages pending at the panic are processed in a row, the ring
+	 * is copied once, after the last one.
+	 */
+	if (panic_mode && log_buffered_cnt() == 0U) {
+		(void)log_persist_flush();
+	}
+}
+
+static int staging_out(uint8_t *data, size_t length, void *ctx)
+{
+	size_t len = MIN(length, sizeof(staging) - staging_len);
+
+	ARG_UNUSED(ctx);
+
+	memcpy(&staging[staging_len], data, len);
+	staging_len += len;
+
+	return length;
+}
+
+static uint8_t log_output_buf[16];
+
+LOG_OUTPUT_DEFINE(log_output_persist, staging_out, log_output_buf,
+		  sizeof(log_output_buf));
+
+/* The level and the timestamp are kept in the record header. */
+#define OUTPUT_FLAGS LOG_OUTPUT_FLAG_CRLF_NONE
+
+static void put(const struct log_backend *const backend,
+		struct log_msg *msg)
+{
+	log_output_msg_process(&log_output_persist, msg, OUTPUT_FLAGS);
+	record_commit(log_msg_level_get(msg), log_msg_source_id_get(msg),
+		      log_msg_timestamp_get(msg));
+}
+
+static void process(const struct log_backend *const backend,
+		    const struct log_msg2 *msg)
+{
+	log_output_msg2_process(&log_output_persist, msg, OUTPUT_FLAGS);
+	record_commit(msg->ids.level, msg->ids.source_id, msg->timestamp);
+}
+
+static void sync_string(const struct log_backend *const backend,
+			struct log_msg_ids src_level, uint32_t timestamp,
+			const char *fmt, va_list ap)
+{
+	/* Messages are logged from any context, the staging buffer is
+	 * shared.
+	 */
+	unsigned int key = irq_lock();
+
+	log_output_string(&log_output_persist, src_level, timestamp, fmt, ap,
+			  OUTPUT_FLAGS);
+	record_commit(src_level.level, src_level.source_id, timestamp);
+
+	irq_unlock(key);
+}
+
+static void sync_hexdump(const struct log_backend *const backend,
+			 struct log_msg_ids src_level, uint32_t timestamp,
+			 const char *metadata, const uint8_t *data,
+			 uint32_t length)
+{
+	unsigned int key = irq_lock();
+
+	log_output_hexdump(&log_output_persist, src_level, timestamp,
+			   metadata, data, length, OUTPUT_FLAGS);
+	record_commit(src_level.level, src_level.source_id, timestamp);
+
+	irq_unlock(key);
+}
+
+static void dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	staging_len = snprintk((char *)staging, sizeof(staging),
+			       "%u messages dropped", cnt);
+	staging_len = MIN(staging_len, sizeof(staging));
+	record_commit(LOG_LEVEL_WRN, LOG_PERSIST_NO_SOURCE, 0);
+}
+
+#ifdef CONFIG_LOG_BACKEND_PERSIST_FLASH
+BUILD_ASSERT(sizeof(struct ring) > FLASH_CHUNK,
+	     "Ring header and records in the same flash chunk");
+
+/* Slot the next copy is written to, the other one holds the last copy. */
+static int flash_slot;
+
+/* Serializes the copies, but cannot be waited for in panic mode. */
+static K_MUTEX_DEFINE(flash_mutex);
+
+static off_t flash_slot_off(const struct flash_area *fa, int slot)
+{
+	return slot * (fa->fa_size / 2U);
+}
+
+/* The chunk holding the header, with the magic number, is written last and
+ * only if the ring did not change meanwhile, so that an interrupted or
+ * inconsistent copy is never mounted.
+ */
+static int flash_copy(const struct flash_area *fa, off_t off)
+{
+	uint8_t hdr_chunk[FLASH_CHUNK] __aligned(8);
+	uint8_t chunk[FLASH_CHUNK] __aligned(8);
+	size_t align = flash_area_align(fa);
+	k_spinlock_key_t key;
+	uint32_t seq;
+	uint32_t tail;
+	bool changed;
+	size_t len;
+	int err;
+
+	if (sizeof(ring) > fa->fa_size / 2U || align > sizeof(chunk)) {
+		return -ENOSPC;
+	}
+
+	err = flash_area_erase(fa, off, fa->fa_size / 2U);
+	if (err) {
+		return err;
+	}
+
+	key = k_spin_lock(&lock);
+	memcpy(hdr_chunk, &ring, sizeof(hdr_chunk));
+	seq = ring.seq;
+	tail = ring.tail;
+	k_spin_unlock(&lock, key);
+
+	for (size_t pos = sizeof(chunk); pos < sizeof(ring); pos += len) {
+		len = MIN(sizeof(chunk), sizeof(ring) - pos);
+
+		key = k_spin_lock(&lock);
+		memcpy(chunk, (uint8_t *)&ring + pos, len);
+		k_spin_unlock(&lock, key);
+
+		/* Pad the last chunk to the write block size. */
+		memset(&chunk[len], 0xff, ROUND_UP(len, align) - len);
+
+		err = flash_area_write(fa, off + pos, chunk,
+				       ROUND_UP(len, align));
+		if (err) {
+			return err;
+		}
+	}
+
+	key = k_spin_lock(&lock);
+	changed = (seq != ring.seq) || (tail != ring.tail);
+	k_spin_unlock(&lock, key);
+
+	if (changed) {
+		return -EBUSY;
+	}
+
+	return flash_area_write(fa, off, hdr_chunk, sizeof(hdr_chunk));
+}
+
+/* Return the slot holding the last valid copy, or -1 if there is none. */
+static int flash_last_slot(const struct flash_area *fa)
+{
+	/* magic and seq of each slot */
+	uint32_t hdr[2][2];
+	bool valid[2];
+
+	for (int slot = 0; slot < 2; slot++) {
+		valid[slot] = flash_area_read(fa, flash_slot_off(fa, slot),
+					      hdr[slot], sizeof(hdr[slot])) == 0 &&
+			      hdr[slot][0] == RING_MAGIC;
+	}
+
+	if (valid[0] && valid[1]) {
+		return ((int32_t)(hdr[1][1] - hdr[0][1]) > 0) ? 1 : 0;
+	}
+
+	return valid[0] ? 0 : (valid[1] ? 1 : -1);
+}
+
+/* Pick the slot of the next copy, so that the last copy is kept, and load
+ * the last copy which mounts if load is set.
+ */
+static bool flash_load(bool load)
+{
+	const struct flash_area *fa;
+	bool valid = false;
+	int slot;
+
+	if (flash_area_open(FLASH_PARTITION, &fa)) {
+		return false;
+	}
+
+	slot = flash_last_slot(fa);
+	flash_slot = (slot == 0) ? 1 : 0;
+
+	/* The previous copy is tried if the last one is damaged. */
+	for (int i = 0; load && slot >= 0 && i < 2; i++, slot ^= 1) {
+		if (flash_area_read(fa, flash_slot_off(fa, slot), &ring,
+				    sizeof(ring)) == 0 && ring_mount()) {
+			flash_slot = slot ^ 1;
+			valid = true;
+			break;
+		}
+	}
+
+	flash_area_close(fa);
+
+	return valid;
+}
+
+static void flush_work_handler(struct k_work *work)
+{
+	static uint32_t flushed_seq;
+	uint32_t seq = ring.seq;
+
+	if (seq != flushed_seq && log_persist_flush() == 0) {
+		flushed_seq = seq;
+	}
+}
+
+static K_WORK_DEFINE(flush_work, flush_work_handler);
+
+static void flush_timer_expiry(struct k_timer *timer)
+{
+	k_work_submit(&flush_work);
+}
+
+static K_TIMER_DEFINE(flush_timer, flush_timer_expiry, NULL);
+#endif /* CONFIG_LOG_BACKEND_PERSIST_FLASH */
+
+int log_persist_flush(void)
+{
+#ifdef CONFIG_LOG_BACKEND_PERSIST_FLASH
+	const struct flash_area *fa;
+	bool locked = !panic_mode && !k_is_in_isr();
+	int err;
+
+	err = flash_area_open(FLASH_PARTITION, &fa);
+	if (err) {
+		return err;
+	}
+
+	if (locked) {
+		(void)k_mutex_lock(&flash_mutex, K_FOREVER);
+	}
+
+	/* The ring is copied by chunks while messages may be logged, the copy
+	 * is only validated if nothing was added or removed meanwhile.
+	 */
+	for (int i = 0; i < FLASH_ATTEMPTS; i++) {
+		err = flash_copy(fa, flash_slot_off(fa, flash_slot));
+		if (err != -EBUSY) {
+			break;
+		}
+	}
+
+	if (err == 0) {
+		flash_slot ^= 1;
+	}
+
+	if (locked) {
+		(void)k_mutex_unlock(&flash_mutex);
+	}
+
+	flash_area_close(fa);
+
+	return err;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+static void panic(struct log_backend const *const backend)
+{
+	panic_mode = true;
+
+	/* Otherwise the ring is copied after the pending messages. */
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_PERSIST_FLASH) &&
+	    log_buffered_cnt() == 0U) {
+		(void)log_persist_flush();
+	}
+}
+
+static void log_backend_persist_init(void)
+{
+	bool valid = ring_mount();
+
+#ifdef CONFIG_LOG_BACKEND_PERSIST_FLASH
+	/* The slots are also scanned with a valid ring, not to overwrite the
+	 * last copy.
+	 */
+	if (flash_load(!valid)) {
+		valid = true;
+	}
+#endif
+
+	if (valid) {
+		ring.boot++;
+	} else {
+		ring_reset();
+	}
+
+#ifdef CONFIG_LOG_BACKEND_PERSIST_FLASH
+	if (CONFIG_LOG_BACKEND_PERSIST_FLASH_PERIOD > 0) {
+		k_timer_start(&flush_timer,
+			      K_SECONDS(CONFIG_LOG_BACKEND_PERSIST_FLASH_PERIOD),
+			      K_SECONDS(CONFIG_LOG_BACKEND_PERSIST_FLASH_PERIOD));
+	}
+#endif
+}
+
+int log_persist_read(uint32_t *seq, struct log_persist_record *record,
+		     char *buf, size_t size)
+{
+	struct record_hdr hdr;
+	k_spinlock_key_t key;
+	uint32_t pos;
+	size_t len;
+
+	key = k_spin_lock(&lock);
+
+	pos = ring.tail;
+	if (*seq != 0U && *seq == read_hint_seq &&
+	    (read_hint_pos - ring.tail) <= (ring.head - ring.tail)) {
+		pos = read_hint_pos;
+	}
+
+	while (pos != ring.head) {
+		ring_read(pos, &hdr, sizeof(hdr));
+		if ((int32_t)(hdr.seq - *seq) >= 0 || *seq == 0U) {
+			break;
+		}
+
+		pos += sizeof(hdr) + hdr.len;
+	}
+
+	if (pos == ring.head) {
+		k_spin_unlock(&lock, key);
+		return -ENOENT;
+	}
+
+	len = MIN(hdr.len, size - 1);
+	ring_read(pos + sizeof(hdr), buf, len);
+	buf[len] = '\0';
+
+	record->seq = hdr.seq;
+	record->timestamp = hdr.timestamp;
+	record->boot = hdr.boot;
+	record->source_id = hdr.source_id;
+	record->level = hdr.level;
+
+	*seq = hdr.seq + 1U;
+	read_hint_seq = *seq;
+	read_hint_pos = pos + sizeof(hdr) + hdr.len;
+
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+uint16_t log_persist_boot_get(void)
+{
+	return ring.boot;
+}
+
+void log_persist_clear(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	/* The sequence numbers keep running, so that a copy to flash in
+	 * progress notices the change.
+	 */
+	ring.tail = ring.head;
+
+	k_spin_unlock(&lock, key);
+}
+
+const struct log_backend_api log_backend_persist_api = {
+	.put = (IS_ENABLED(CONFIG_LOG_IMMEDIATE) || IS_ENABLED(CONFIG_LOG2)) ?
+		NULL : put,
+	.process = IS_ENABLED(CONFIG_LOG2) ? process : NULL,
+	.put_sync_string = IS_ENABLED(CONFIG_LOG_IMMEDIATE) ?
+			sync_string : NULL,
+	.put_sync_hexdump = IS_ENABLED(CONFIG_LOG_IMMEDIATE) ?
+			sync_hexdump : NULL,
+	.panic = panic,
+	.init = log_backend_persist_init,
+	.dropped = IS_ENABLED(CONFIG_LOG_IMMEDIATE) ? NULL : dropped,
+};
+
+LOG_BACKEND_DEFINE(log_backend_persist, log_backend_persist_api, true);
+
+#ifdef CONFIG_LOG_BACKEND_PERSIST_SHELL
+#include <shell/shell.h>
+
+/* Level 0 is used by the printk() messages. */
+static const char * const level_names[] = {
+	"raw", "err", "wrn", "inf", "dbg",
+};
+
+static int cmd_dump(const struct shell *shell, size_t argc, char **argv)
+{
+	static char buf[CONFIG_LOG_BACKEND_PERSIST_RECORD_MAX + 1];
+	struct log_persist_record record;
+	uint32_t seq = 0U;
+	const char *level;
+
+	while (log_persist_read(&seq, &record, buf, sizeof(buf)) == 0) {
+		level = (record.level < ARRAY_SIZE(level_names)) ?
+			level_names[record.level] : "?";
+
+		shell_print(shell, "[%u:%u] %10u <%s> %s", record.boot,
+			    record.seq, record.timestamp, level, buf);
+	}
+
+	return 0;
+}
+
+static int cmd_clear(const struct shell *shell, size_t argc, char **argv)
+{
+	log_persist_clear();
+
+	return 0;
+}
+
+static int cmd_flush(const struct shell *shell, size_t argc, char **argv)
+{
+	int err = log_persist_flush();
+
+	if (err) {
+		shell_error(shell, "Copy to flash failed (err %d)", err);
+	}
+
+	return err;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_log_persist,
+	SHELL_CMD(clear, NULL, "Remove all records.", cmd_clear),
+	SHELL_CMD(dump, NULL,
+		  "Print the records as [<boot>:<seq>] <timestamp> <level> "
+		  "<message>.", cmd_dump),
+	SHELL_COND_CMD(CONFIG_LOG_BACKEND_PERSIST_FLASH, flush, NULL,
+		       "Copy the records to flash.", cmd_flush),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(log_persist, &sub_log_persist,
+		   "Persistent log commands", NULL);
+#endif /* CONFIG_LOG_BACKEND_PERSIST_SHELL */
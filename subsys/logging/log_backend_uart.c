@@ -9,6 +9,7 @@
 #include <logging/log_msg.h>
 #include <logging/log_output.h>
 #include <logging/log_backend_std.h>
+#include <logging/log_output_dict.h>
 #include <device.h>
 #include <drivers/uart.h>
 #include <sys/__assert.h>
@@ -39,6 +40,17 @@ static void put(const struct log_backend *const backend,
 	log_backend_std_put(&log_output_uart, flag, msg);
 }
 
+static void process(const struct log_backend *const backend,
+		    const struct log_msg2 *msg)
+{
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_UART_OUTPUT_DICTIONARY)) {
+		log_dict_output_msg2_process(&log_output_uart, msg, 0);
+		return;
+	}
+
+	log_backend_std_msg2_process(&log_output_uart, 0, msg);
+}
+
 static void log_backend_uart_init(void)
 {
 	uart_dev = device_get_binding(CONFIG_UART_CONSOLE_ON_DEV_NAME);
@@ -54,6 +66,11 @@ static void dropped(const struct log_backend *const backend, uint32_t cnt)
 {
 	ARG_UNUSED(backend);
 
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_UART_OUTPUT_DICTIONARY)) {
+		log_dict_output_dropped_process(&log_output_uart, cnt);
+		return;
+	}
+
 	log_backend_std_dropped(&log_output_uart, cnt);
 }
 
@@ -80,7 +97,9 @@ static void sync_hexdump(const struct log_backend *const backend,
 }
 
 const struct log_backend_api log_backend_uart_api = {
-	.put = IS_ENABLED(CONFIG_LOG_IMMEDIATE) ? NULL : put,
+	.put = (IS_ENABLED(CONFIG_LOG_IMMEDIATE) || IS_ENABLED(CONFIG_LOG2)) ?
+		NULL : put,
+	.process = IS_ENABLED(CONFIG_LOG2) ? process : NULL,
 	.put_sync_string = IS_ENABLED(CONFIG_LOG_IMMEDIATE) ?
 			sync_string : NULL,
 	.put_sync_hexdump = IS_ENABLED(CONFIG_LOG_IMMEDIATE) ?
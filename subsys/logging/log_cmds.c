@@ -7,6 +7,7 @@
 #include <shell/shell.h>
 #include <logging/log_ctrl.h>
 #include <logging/log.h>
+#include <stdlib.h>
 #include <string.h>
 
 typedef int (*log_backend_cmd_t)(const struct shell *shell,
@@ -401,6 +402,80 @@ static int cmd_log_strdup_utilization(const struct shell *shell,
 	return 0;
 }
 
+static void rate_limit_status(const struct shell *shell)
+{
+	uint32_t modules_cnt = log_sources_count();
+	uint16_t rate;
+	uint16_t burst;
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "%-40s | rate  | burst | suppressed\r\n", "module_name");
+	shell_fprintf(shell, SHELL_NORMAL,
+	      "-----------------------------------------------------------------"
+	      "-\r\n");
+
+	for (uint32_t i = 0U; i < modules_cnt; i++) {
+		log_rate_limit_get(CONFIG_LOG_DOMAIN_ID, i, &rate, &burst);
+
+		shell_fprintf(shell, SHELL_NORMAL, "%-40s | %-5u | %-5u | %u\r\n",
+			      log_source_name_get(CONFIG_LOG_DOMAIN_ID, i),
+			      rate, burst,
+			      log_rate_limit_suppressed_get(
+					CONFIG_LOG_DOMAIN_ID, i));
+	}
+}
+
+static int cmd_log_rate_limit(const struct shell *shell,
+			      size_t argc, char **argv)
+{
+	unsigned long rate;
+	unsigned long burst;
+	char *end;
+	int id;
+
+	if (argc == 1) {
+		rate_limit_status(shell);
+		return 0;
+	}
+
+	if (argc < 3) {
+		shell_error(shell, "Missing burst.");
+		return -EINVAL;
+	}
+
+	rate = strtoul(argv[1], &end, 10);
+	if (*end != '\0' || rate > UINT16_MAX) {
+		shell_error(shell, "Invalid rate: %s", argv[1]);
+		return -EINVAL;
+	}
+
+	burst = strtoul(argv[2], &end, 10);
+	if (*end != '\0' || burst > UINT16_MAX || (rate != 0 && burst == 0)) {
+		shell_error(shell, "Invalid burst: %s", argv[2]);
+		return -EINVAL;
+	}
+
+	/* Arguments following the burst are interpreted as module names. */
+	if (argc == 3) {
+		for (uint32_t i = 0U; i < log_sources_count(); i++) {
+			log_rate_limit_set(CONFIG_LOG_DOMAIN_ID, i, rate,
+					   burst);
+		}
+	}
+
+	for (size_t i = 3; i < argc; i++) {
+		id = module_id_get(argv[i]);
+		if (id < 0) {
+			shell_error(shell, "%s: unknown source name.",
+				    argv[i]);
+			continue;
+		}
+
+		log_rate_limit_set(CONFIG_LOG_DOMAIN_ID, id, rate, burst);
+	}
+
+	return 0;
+}
 
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_log_backend,
 	SHELL_CMD_ARG(disable, &dsub_module_name,
@@ -450,6 +525,11 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_log_stat,
 	SHELL_CMD(halt, NULL, "Halt logging", cmd_log_self_halt),
 	SHELL_CMD_ARG(list_backends, NULL, "Lists logger backends.",
 		      cmd_log_backends_list, 1, 0),
+	SHELL_COND_CMD_ARG(CONFIG_LOG_RATE_LIMIT, rate_limit, NULL,
+	"'log rate_limit <rate> <burst> <module_0> .. <module_n>' limits the "
+	"messages per second of specified modules (all if no modules "
+	"specified), 0 for no limit. Without arguments, prints the limits.",
+	cmd_log_rate_limit, 1, 255),
 	SHELL_CMD(status, NULL, "Logger status", cmd_log_self_status),
 	SHELL_COND_CMD_ARG(CONFIG_LOG_STRDUP_POOL_PROFILING, strdup_utilization,
 			NULL, "Get utilization of string duplicates pool",
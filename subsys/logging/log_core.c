@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <logging/log_msg.h>
+#include <logging/log_msg2.h>
 #include "log_list.h"
 #include <logging/log.h>
 #include <logging/log_backend.h>
@@ -13,6 +14,7 @@
 #include <init.h>
 #include <sys/__assert.h>
 #include <sys/atomic.h>
+#include <sys/mpsc_pbuf.h>
 #include <ctype.h>
 #include <logging/log_frontend.h>
 #include <syscall_handler.h>
@@ -43,6 +45,10 @@ LOG_MODULE_REGISTER(log);
 #define CONFIG_LOG_STRDUP_BUF_COUNT 0
 #endif
 
+#ifndef CONFIG_LOG_BUFFER_SIZE
+#define CONFIG_LOG_BUFFER_SIZE 0
+#endif
+
 struct log_strdup_buf {
 	atomic_t refcount;
 	char buf[CONFIG_LOG_STRDUP_MAX_STRING + 1]; /* for termination */
@@ -59,6 +65,11 @@ static uint8_t __noinit __aligned(sizeof(void *))
 		log_strdup_pool_buf[LOG_STRDUP_POOL_BUFFER_SIZE];
 
 static struct log_list_t list;
+static struct mpsc_pbuf_buffer log_buffer;
+#ifdef CONFIG_LOG2
+static uint32_t __noinit log_buffer_buf[CONFIG_LOG_BUFFER_SIZE /
+					sizeof(uint32_t)];
+#endif
 static atomic_t initialized;
 static bool panic_mode;
 static bool backend_attached;
@@ -182,22 +193,11 @@ static void detect_missed_strdup(struct log_msg *msg)
 #undef ERR_MSG
 }
 
-static inline void msg_finalize(struct log_msg *msg,
-				struct log_msg_ids src_level)
+/* Process the message in panic mode or wake up the processing thread. */
+static void msg_post_finalize(void)
 {
 	unsigned int key;
 
-	msg->hdr.ids = src_level;
-	msg->hdr.timestamp = timestamp_func();
-
-	atomic_inc(&buffered_cnt);
-
-	key = irq_lock();
-
-	log_list_add_tail(&list, msg);
-
-	irq_unlock(key);
-
 	if (panic_mode) {
 		key = irq_lock();
 		(void)log_process(false);
@@ -215,10 +215,73 @@ static inline void msg_finalize(struct log_msg *msg,
 	}
 }
 
+static inline void msg_finalize(struct log_msg *msg,
+				struct log_msg_ids src_level)
+{
+	unsigned int key;
+
+	msg->hdr.ids = src_level;
+	msg->hdr.timestamp = timestamp_func();
+
+	atomic_inc(&buffered_cnt);
+
+	key = irq_lock();
+
+	log_list_add_tail(&list, msg);
+
+	irq_unlock(key);
+
+	msg_post_finalize();
+}
+
+#ifdef CONFIG_LOG2
+struct log_msg2 *z_log_msg2_alloc(size_t len)
+{
+	struct log_msg2 *msg = mpsc_pbuf_alloc(&log_buffer, len);
+
+	if (msg == NULL) {
+		log_dropped();
+	}
+
+	return msg;
+}
+
+void z_log_msg2_commit(struct log_msg2 *msg)
+{
+	msg->timestamp = timestamp_func();
+
+	atomic_inc(&buffered_cnt);
+
+	mpsc_pbuf_commit(&log_buffer, msg);
+
+	msg_post_finalize();
+}
+#endif /* CONFIG_LOG2 */
+
+/* Create a packaged message from arguments already cast to log_arg_t. The
+ * arguments beyond the ones used by the string are ignored.
+ */
+static void msg2_args_create(const char *str, log_arg_t *args, uint32_t narg,
+			     struct log_msg_ids src_level)
+{
+	log_arg_t a[LOG_MAX_NARGS] = { 0 };
+
+	__ASSERT_NO_MSG(narg <= LOG_MAX_NARGS);
+	if (narg != 0) {
+		memcpy(a, args, narg * sizeof(log_arg_t));
+	}
+
+	z_log_msg2_runtime_create(src_level, NULL, 0, str, a[0], a[1], a[2],
+				  a[3], a[4], a[5], a[6], a[7], a[8], a[9],
+				  a[10], a[11], a[12], a[13], a[14]);
+}
+
 void log_0(const char *str, struct log_msg_ids src_level)
 {
 	if (IS_ENABLED(CONFIG_LOG_FRONTEND)) {
 		log_frontend_0(str, src_level);
+	} else if (IS_ENABLED(CONFIG_LOG2)) {
+		msg2_args_create(str, NULL, 0, src_level);
 	} else {
 		struct log_msg *msg = log_msg_create_0(str);
 
@@ -235,6 +298,8 @@ void log_1(const char *str,
 {
 	if (IS_ENABLED(CONFIG_LOG_FRONTEND)) {
 		log_frontend_1(str, arg0, src_level);
+	} else if (IS_ENABLED(CONFIG_LOG2)) {
+		z_log_msg2_runtime_create(src_level, NULL, 0, str, arg0);
 	} else {
 		struct log_msg *msg = log_msg_create_1(str, arg0);
 
@@ -252,6 +317,8 @@ void log_2(const char *str,
 {
 	if (IS_ENABLED(CONFIG_LOG_FRONTEND)) {
 		log_frontend_2(str, arg0, arg1, src_level);
+	} else if (IS_ENABLED(CONFIG_LOG2)) {
+		z_log_msg2_runtime_create(src_level, NULL, 0, str, arg0, arg1);
 	} else {
 		struct log_msg *msg = log_msg_create_2(str, arg0, arg1);
 
@@ -271,6 +338,9 @@ void log_3(const char *str,
 {
 	if (IS_ENABLED(CONFIG_LOG_FRONTEND)) {
 		log_frontend_3(str, arg0, arg1, arg2, src_level);
+	} else if (IS_ENABLED(CONFIG_LOG2)) {
+		z_log_msg2_runtime_create(src_level, NULL, 0, str, arg0, arg1,
+					  arg2);
 	} else {
 		struct log_msg *msg = log_msg_create_3(str, arg0, arg1, arg2);
 
@@ -289,6 +359,8 @@ void log_n(const char *str,
 {
 	if (IS_ENABLED(CONFIG_LOG_FRONTEND)) {
 		log_frontend_n(str, args, narg, src_level);
+	} else if (IS_ENABLED(CONFIG_LOG2)) {
+		msg2_args_create(str, args, narg, src_level);
 	} else {
 		struct log_msg *msg = log_msg_create_n(str, args, narg);
 
@@ -306,6 +378,8 @@ void log_hexdump(const char *str, const void *data, uint32_t length,
 	if (IS_ENABLED(CONFIG_LOG_FRONTEND)) {
 		log_frontend_hexdump(str, (const uint8_t *)data, length,
 				     src_level);
+	} else if (IS_ENABLED(CONFIG_LOG2)) {
+		z_log_msg2_runtime_create(src_level, data, length, "%s", str);
 	} else {
 		struct log_msg *msg =
 			log_msg_hexdump_create(str, (const uint8_t *)data, length);
@@ -339,6 +413,9 @@ void log_printk(const char *fmt, va_list ap)
 		} else if (IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {
 			log_generic(src_level_union.structure, fmt, ap,
 							LOG_STRDUP_SKIP);
+		} else if (IS_ENABLED(CONFIG_LOG2)) {
+			z_log_msg2_runtime_vcreate(src_level_union.structure,
+						   NULL, 0, fmt, ap);
 		} else {
 			uint8_t str[CONFIG_LOG_PRINTK_MAX_STRING_LENGTH + 1];
 			struct log_msg *msg;
@@ -402,6 +479,8 @@ void log_generic(struct log_msg_ids src_level, const char *fmt, va_list ap,
 				va_end(ap_tmp);
 			}
 		}
+	} else if (IS_ENABLED(CONFIG_LOG2)) {
+		z_log_msg2_runtime_vcreate(src_level, NULL, 0, fmt, ap);
 	} else {
 		log_arg_t args[LOG_MAX_NARGS];
 		uint32_t nargs = log_count_args(fmt);
@@ -467,6 +546,147 @@ void log_hexdump_sync(struct log_msg_ids src_level, const char *metadata,
 	}
 }
 
+#ifdef CONFIG_LOG_RATE_LIMIT
+static struct k_spinlock rate_limit_lock;
+
+static struct log_rate_limit *rate_limit_get(uint32_t src_id)
+{
+	return &__log_dynamic_start[src_id].rate_limit;
+}
+
+static void rate_limit_init(struct log_rate_limit *rl, uint16_t rate,
+			    uint16_t burst)
+{
+	rl->stamp = k_uptime_get_32();
+	rl->suppressed = 0U;
+	rl->tokens = burst;
+	rl->rate = rate;
+	rl->burst = burst;
+	rl->pending = 0U;
+}
+
+/* Add the tokens earned since the last refill. */
+static void rate_limit_refill(struct log_rate_limit *rl, uint32_t now)
+{
+	uint32_t elapsed = now - rl->stamp;
+	uint32_t add;
+
+	/* Also keeps elapsed * rate from overflowing below. */
+	if (elapsed >= ((uint32_t)rl->burst * MSEC_PER_SEC) / rl->rate) {
+		rl->tokens = rl->burst;
+		rl->stamp = now;
+		return;
+	}
+
+	add = (elapsed * rl->rate) / MSEC_PER_SEC;
+	if (add == 0U) {
+		return;
+	}
+
+	if (add >= (uint32_t)(rl->burst - rl->tokens)) {
+		rl->tokens = rl->burst;
+		rl->stamp = now;
+	} else {
+		rl->tokens += add;
+		/* Keep the remainder for the next refill. */
+		rl->stamp += (add * MSEC_PER_SEC) / rl->rate;
+	}
+}
+
+static void suppressed_report(struct log_source_dynamic_data *source,
+			      uint8_t level, uint32_t cnt)
+{
+	struct log_msg_ids src_level = {
+		.level = level,
+		.domain_id = CONFIG_LOG_DOMAIN_ID,
+		.source_id = log_dynamic_source_id(source)
+	};
+
+	log_string_sync(src_level, "%u messages suppressed", cnt);
+}
+
+static bool rate_limit_take(struct log_rate_limit *rl)
+{
+	rate_limit_refill(rl, k_uptime_get_32());
+
+	if (rl->tokens == 0U) {
+		return false;
+	}
+
+	rl->tokens--;
+
+	return true;
+}
+
+bool z_log_rate_limit_check(struct log_rate_limit *rl,
+			    struct log_source_dynamic_data *source,
+			    uint8_t level)
+{
+	/* Suppressed messages are counted by the source, also when suppressed
+	 * by the bucket of a call site.
+	 */
+	struct log_rate_limit *src_rl = &source->rate_limit;
+	k_spinlock_key_t key;
+	uint16_t pending;
+
+	if (rl->rate == 0U && src_rl->pending == 0U) {
+		return true;
+	}
+
+	key = k_spin_lock(&rate_limit_lock);
+
+	if (rl->rate != 0U && !rate_limit_take(rl)) {
+		src_rl->suppressed++;
+		if (src_rl->pending < UINT16_MAX) {
+			src_rl->pending++;
+		}
+		k_spin_unlock(&rate_limit_lock, key);
+
+		return false;
+	}
+
+	pending = src_rl->pending;
+	src_rl->pending = 0U;
+
+	k_spin_unlock(&rate_limit_lock, key);
+
+	if (pending != 0U) {
+		suppressed_report(source, level, pending);
+	}
+
+	return true;
+}
+
+void log_rate_limit_set(uint32_t domain_id, uint32_t src_id, uint16_t rate,
+			uint16_t burst)
+{
+	k_spinlock_key_t key;
+
+	__ASSERT_NO_MSG(src_id < log_sources_count());
+	__ASSERT_NO_MSG(rate == 0U || burst != 0U);
+
+	key = k_spin_lock(&rate_limit_lock);
+	rate_limit_init(rate_limit_get(src_id), rate, burst);
+	k_spin_unlock(&rate_limit_lock, key);
+}
+
+void log_rate_limit_get(uint32_t domain_id, uint32_t src_id, uint16_t *rate,
+			uint16_t *burst)
+{
+	__ASSERT_NO_MSG(src_id < log_sources_count());
+
+	*rate = rate_limit_get(src_id)->rate;
+	*burst = rate_limit_get(src_id)->burst;
+}
+
+uint32_t log_rate_limit_suppressed_get(uint32_t domain_id, uint32_t src_id)
+{
+	__ASSERT_NO_MSG(src_id < log_sources_count());
+
+	return rate_limit_get(src_id)->suppressed;
+}
+#endif /* CONFIG_LOG_RATE_LIMIT */
+
 static uint32_t k_cycle_get_32_wrapper(void)
 {
 	/*
@@ -480,7 +700,12 @@ void log_core_init(void)
 {
 	uint32_t freq;
 
-	if (!IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {
+	if (IS_ENABLED(CONFIG_LOG2)) {
+#ifdef CONFIG_LOG2
+		mpsc_pbuf_init(&log_buffer, log_buffer_buf,
+			       ARRAY_SIZE(log_buffer_buf));
+#endif
+	} else if (!IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {
 		log_msg_pool_init();
 		log_list_init(&list);
 
@@ -517,6 +742,11 @@ void log_core_init(void)
 			LOG_FILTER_SLOT_SET(filters,
 					    LOG_FILTER_AGGR_SLOT_IDX,
 					    level);
+#ifdef CONFIG_LOG_RATE_LIMIT
+			rate_limit_init(rate_limit_get(i),
+					CONFIG_LOG_RATE_LIMIT_RATE,
+					CONFIG_LOG_RATE_LIMIT_BURST);
+#endif
 		}
 	}
 }
@@ -623,19 +853,16 @@ void z_vrfy_log_panic(void)
 #endif
 
 static bool msg_filter_check(struct log_backend const *backend,
-			     struct log_msg *msg)
+			     struct log_msg_ids ids)
 {
 	if (IS_ENABLED(CONFIG_LOG_RUNTIME_FILTERING)) {
 		uint32_t backend_level;
-		uint32_t msg_level;
 
-		backend_level = log_filter_get(backend,
-					       log_msg_domain_id_get(msg),
-					       log_msg_source_id_get(msg),
+		backend_level = log_filter_get(backend, ids.domain_id,
+					       ids.source_id,
 					       true /*enum RUNTIME, COMPILETIME*/);
-		msg_level = log_msg_level_get(msg);
 
-		return (msg_level <= backend_level);
+		return (ids.level <= backend_level);
 	} else {
 		return true;
 	}
@@ -655,7 +882,7 @@ static void msg_process(struct log_msg *msg, bool bypass)
 			backend = log_backend_get(i);
 
 			if (log_backend_is_active(backend) &&
-			    msg_filter_check(backend, msg)) {
+			    msg_filter_check(backend, msg->hdr.ids)) {
 				log_backend_put(backend, msg);
 			}
 		}
@@ -664,6 +891,37 @@ static void msg_process(struct log_msg *msg, bool bypass)
 	log_msg_put(msg);
 }
 
+/* Process the oldest packaged message, return true if another is pending. */
+static bool msg2_process(bool bypass)
+{
+	struct log_backend const *backend;
+	const struct log_msg2 *msg;
+	size_t len;
+
+	msg = mpsc_pbuf_claim(&log_buffer, &len);
+	if (msg == NULL) {
+		return false;
+	}
+
+	atomic_dec(&buffered_cnt);
+
+	if (!bypass) {
+		for (int i = 0; i < log_backend_count_get(); i++) {
+			backend = log_backend_get(i);
+
+			if (log_backend_is_active(backend) &&
+			    msg_filter_check(backend, msg->ids)) {
+				log_backend_msg2_process(backend, msg);
+			}
+		}
+	}
+
+	mpsc_pbuf_free(&log_buffer, msg);
+
+	/* Claiming again returns the same message until it is freed. */
+	return mpsc_pbuf_claim(&log_buffer, &len) != NULL;
+}
+
 void dropped_notify(void)
 {
 	uint32_t dropped = atomic_set(&dropped_cnt, 0);
@@ -684,6 +942,17 @@ bool z_impl_log_process(bool bypass)
 	if (!backend_attached && !bypass) {
 		return false;
 	}
+
+	if (IS_ENABLED(CONFIG_LOG2)) {
+		bool pending = msg2_process(bypass);
+
+		if (!bypass && dropped_cnt) {
+			dropped_notify();
+		}
+
+		return pending;
+	}
+
 	unsigned int key = irq_lock();
 
 	msg = log_list_head_get(&list);
@@ -886,7 +1155,8 @@ char *log_strdup(const char *str)
 	struct log_strdup_buf *dup;
 	int err;
 
-	if (IS_ENABLED(CONFIG_LOG_IMMEDIATE) ||
+	/* Packaged messages hold a copy of the strings. */
+	if (IS_ENABLED(CONFIG_LOG_IMMEDIATE) || IS_ENABLED(CONFIG_LOG2) ||
 	    is_rodata(str) || _is_user_context()) {
 		return (char *)str;
 	}
@@ -1005,6 +1275,9 @@ void z_vrfy_z_log_string_from_user(uint32_t src_level_val, const char *str)
 
 	if (IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {
 		log_string_sync(src_level_union.structure, "%s", str);
+	} else if (IS_ENABLED(CONFIG_LOG2)) {
+		z_log_msg2_runtime_create(src_level_union.structure, NULL, 0,
+					  "%s", str);
 	} else if (IS_ENABLED(CONFIG_LOG_PRINTK) &&
 		   (level == LOG_LEVEL_INTERNAL_RAW_STRING)) {
 		struct log_msg *msg;
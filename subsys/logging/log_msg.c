@@ -27,8 +27,11 @@ BUILD_ASSERT((sizeof(union log_msg_head_data) ==
 	      sizeof(struct log_msg_ext_head_data)),
 	     "Structure must be same size");
 
-#ifndef CONFIG_LOG_BUFFER_SIZE
-#define CONFIG_LOG_BUFFER_SIZE 0
+/* With CONFIG_LOG2, the log buffer holds packaged messages instead. */
+#if defined(CONFIG_LOG_BUFFER_SIZE) && !defined(CONFIG_LOG2)
+#define LOG_MSG_POOL_SIZE CONFIG_LOG_BUFFER_SIZE
+#else
+#define LOG_MSG_POOL_SIZE 0
 #endif
 
 /* Define needed when CONFIG_LOG_BLOCK_IN_THREAD is disabled to satisfy
@@ -38,11 +41,11 @@ BUILD_ASSERT((sizeof(union log_msg_head_data) ==
 #endif
 
 #define MSG_SIZE sizeof(union log_msg_chunk)
-#define NUM_OF_MSGS (CONFIG_LOG_BUFFER_SIZE / MSG_SIZE)
+#define NUM_OF_MSGS (LOG_MSG_POOL_SIZE / MSG_SIZE)
 
 struct k_mem_slab log_msg_pool;
 static uint8_t __noinit __aligned(sizeof(void *))
-		log_msg_pool_buf[CONFIG_LOG_BUFFER_SIZE];
+		log_msg_pool_buf[LOG_MSG_POOL_SIZE];
 
 void log_msg_pool_init(void)
 {
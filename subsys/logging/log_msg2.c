@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <logging/log_msg2.h>
+#include <logging/log_core.h>
+#include <sys/cbprintf.h>
+#include <string.h>
+
+void z_log_msg2_runtime_vcreate(struct log_msg_ids ids, const void *data,
+				size_t dlen, const char *fmt, va_list ap)
+{
+	struct log_msg2 *msg;
+	int plen = 0;
+	va_list ap2;
+
+	if (fmt != NULL) {
+		va_copy(ap2, ap);
+		plen = cbvprintf_package(NULL, 0, fmt, ap2);
+		va_end(ap2);
+	}
+
+	if (plen < 0 || plen > UINT16_MAX || dlen > UINT16_MAX) {
+		log_dropped();
+		return;
+	}
+
+	msg = z_log_msg2_alloc(sizeof(*msg) + plen + dlen);
+	if (msg == NULL) {
+		return;
+	}
+
+	if (fmt != NULL) {
+		plen = cbvprintf_package(msg->data, plen, fmt, ap);
+		if (plen < 0) {
+			/* A string grew since it was measured, the message
+			 * is committed without its package.
+			 */
+			plen = 0;
+		}
+	}
+
+	if (dlen != 0) {
+		memcpy(msg->data + plen, data, dlen);
+	}
+
+	msg->ids = ids;
+	msg->package_len = (uint16_t)plen;
+	msg->data_len = (uint16_t)dlen;
+
+	z_log_msg2_commit(msg);
+}
+
+void z_log_msg2_runtime_create(struct log_msg_ids ids, const void *data,
+			       size_t dlen, const char *fmt, ...)
+{
+	va_list ap;
+
+	va_start(ap, fmt);
+	z_log_msg2_runtime_vcreate(ids, data, dlen, fmt, ap);
+	va_end(ap);
+}
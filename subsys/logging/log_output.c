@@ -548,6 +548,47 @@ void log_output_msg_process(const struct log_output *log_output,
 	log_output_flush(log_output);
 }
 
+void log_output_msg2_process(const struct log_output *log_output,
+			     const struct log_msg2 *msg, uint32_t flags)
+{
+	const uint8_t *package = log_msg2_get_package(msg);
+	uint8_t level = (uint8_t)msg->ids.level;
+	bool raw_string = (level == LOG_LEVEL_INTERNAL_RAW_STRING);
+	const uint8_t *data;
+	int prefix_offset;
+	size_t offset;
+	size_t len;
+
+	data = log_msg2_get_data(msg, &len);
+
+	/* Hexdump messages have no function name prefix. */
+	prefix_offset = raw_string ?
+			0 : prefix_print(log_output, flags, len == 0,
+					 msg->timestamp, level,
+					 msg->ids.domain_id,
+					 msg->ids.source_id);
+
+	if (package != NULL) {
+		(void)cbpprintf(out_func, (void *)log_output, package);
+	}
+
+	for (offset = 0; offset < len; offset += HEXDUMP_BYTES_IN_LINE) {
+		hexdump_line_print(log_output, data + offset,
+				   MIN(len - offset, HEXDUMP_BYTES_IN_LINE),
+				   prefix_offset, flags);
+	}
+
+	if (!raw_string) {
+		postfix_print(log_output, flags, level);
+	} else if (log_output->control_block->offset != 0 &&
+		   log_output->buf[log_output->control_block->offset - 1] ==
+		   '\n') {
+		print_formatted(log_output, "\r");
+	}
+
+	log_output_flush(log_output);
+}
+
 static bool ends_with_newline(const char *fmt)
 {
 	char c = '\0';
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log_output_dict.h>
+#include <logging/log_output.h>
+#include <logging/log_msg2.h>
+
+static void buffer_write(log_output_func_t outf, const void *buf, size_t len,
+			 void *ctx)
+{
+	uint8_t *data = (uint8_t *)buf;
+	int processed;
+
+	while (len != 0) {
+		processed = outf(data, len, ctx);
+		len -= processed;
+		data += processed;
+	}
+}
+
+void log_dict_output_msg2_process(const struct log_output *log_output,
+				  const struct log_msg2 *msg, uint32_t flags)
+{
+	struct log_dict_msg_hdr hdr = {
+		.sync = LOG_DICT_SYNC,
+		.type = LOG_DICT_FRAME_MSG,
+		.level = msg->ids.level,
+		.domain_id = msg->ids.domain_id,
+		.source_id = msg->ids.source_id,
+		.package_len = msg->package_len,
+		.data_len = msg->data_len,
+		.timestamp = msg->timestamp,
+	};
+	void *ctx = log_output->control_block->ctx;
+
+	ARG_UNUSED(flags);
+
+	buffer_write(log_output->func, &hdr, sizeof(hdr), ctx);
+	buffer_write(log_output->func, msg->data,
+		     msg->package_len + msg->data_len, ctx);
+}
+
+void log_dict_output_dropped_process(const struct log_output *log_output,
+				     uint32_t cnt)
+{
+	struct log_dict_dropped frame = {
+		.sync = LOG_DICT_SYNC,
+		.type = LOG_DICT_FRAME_DROPPED,
+		.count = cnt,
+	};
+
+	buffer_write(log_output->func, &frame, sizeof(frame),
+		     log_output->control_block->ctx);
+}
@@ -59,6 +59,116 @@ static struct net_conn conns[CONFIG_NET_MAX_CONN];
 static sys_slist_t conn_unused;
 static sys_slist_t conn_used;
 
+#if defined(CONFIG_NET_RX_BATCH)
+/* Result of the latest unicast lookup. The packets of an RX batch are
+ * very likely to belong to the same flow, so they can share the lookup
+ * instead of walking all the connections one packet at a time. The cache
+ * is flushed whenever a connection handler is added or removed.
+ */
+static struct {
+	struct net_conn *conn;
+	struct in6_addr src;
+	struct in6_addr dst;
+	uint16_t src_port;
+	uint16_t dst_port;
+	uint8_t proto;
+	sa_family_t family;
+} conn_cache;
+
+static struct k_spinlock conn_cache_lock;
+
+static void conn_cache_flush(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&conn_cache_lock);
+
+	conn_cache.conn = NULL;
+
+	k_spin_unlock(&conn_cache_lock, key);
+}
+
+static size_t conn_cache_addrs(struct net_pkt *pkt,
+			       union net_ip_header *ip_hdr,
+			       const void **src, const void **dst)
+{
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		*src = &ip_hdr->ipv4->src;
+		*dst = &ip_hdr->ipv4->dst;
+
+		return sizeof(struct in_addr);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && net_pkt_family(pkt) == AF_INET6) {
+		*src = &ip_hdr->ipv6->src;
+		*dst = &ip_hdr->ipv6->dst;
+
+		return sizeof(struct in6_addr);
+	}
+
+	return 0;
+}
+
+static struct net_conn *conn_cache_lookup(struct net_pkt *pkt,
+					  union net_ip_header *ip_hdr,
+					  uint8_t proto, uint16_t src_port,
+					  uint16_t dst_port)
+{
+	struct net_conn *conn = NULL;
+	const void *src, *dst;
+	k_spinlock_key_t key;
+	size_t len;
+
+	len = conn_cache_addrs(pkt, ip_hdr, &src, &dst);
+	if (!len) {
+		return NULL;
+	}
+
+	key = k_spin_lock(&conn_cache_lock);
+
+	if (conn_cache.conn && conn_cache.proto == proto &&
+	    conn_cache.family == net_pkt_family(pkt) &&
+	    conn_cache.src_port == src_port &&
+	    conn_cache.dst_port == dst_port &&
+	    !memcmp(&conn_cache.src, src, len) &&
+	    !memcmp(&conn_cache.dst, dst, len)) {
+		conn = conn_cache.conn;
+	}
+
+	k_spin_unlock(&conn_cache_lock, key);
+
+	return conn;
+}
+
+static void conn_cache_store(struct net_conn *conn, struct net_pkt *pkt,
+			     union net_ip_header *ip_hdr, uint8_t proto,
+			     uint16_t src_port, uint16_t dst_port)
+{
+	const void *src, *dst;
+	k_spinlock_key_t key;
+	size_t len;
+
+	len = conn_cache_addrs(pkt, ip_hdr, &src, &dst);
+	if (!len) {
+		return;
+	}
+
+	key = k_spin_lock(&conn_cache_lock);
+
+	conn_cache.conn = conn;
+	conn_cache.proto = proto;
+	conn_cache.family = net_pkt_family(pkt);
+	conn_cache.src_port = src_port;
+	conn_cache.dst_port = dst_port;
+	memcpy(&conn_cache.src, src, len);
+	memcpy(&conn_cache.dst, dst, len);
+
+	k_spin_unlock(&conn_cache_lock, key);
+}
+#else
+#define conn_cache_flush(...)
+#define conn_cache_lookup(...) NULL
+#define conn_cache_store(...)
+#endif /* CONFIG_NET_RX_BATCH */
+
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
 void conn_register_debug(struct net_conn *conn,
@@ -132,6 +242,8 @@ static void conn_set_used(struct net_conn *conn)
 	conn->flags |= NET_CONN_IN_USE;
 
 	sys_slist_prepend(&conn_used, &conn->node);
+
+	conn_cache_flush();
 }
 
 static void conn_set_unused(struct net_conn *conn)
@@ -379,6 +491,8 @@ int net_conn_unregister(struct net_conn_handle *handle)
 
 	sys_slist_find_and_remove(&conn_used, &conn->node);
 
+	conn_cache_flush();
+
 	conn_set_unused(conn);
 
 	return 0;
@@ -555,6 +669,7 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	bool is_bcast_pkt = false;
 	bool raw_pkt_delivered = false;
 	bool raw_pkt_continue = false;
+	bool cacheable;
 	int16_t best_rank = -1;
 	struct net_conn *conn;
 	enum net_verdict ret;
@@ -621,6 +736,18 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
+	cacheable = IS_ENABLED(CONFIG_NET_RX_BATCH) && !is_mcast_pkt &&
+		    !is_bcast_pkt &&
+		    ((IS_ENABLED(CONFIG_NET_UDP) && proto == IPPROTO_UDP) ||
+		     (IS_ENABLED(CONFIG_NET_TCP) && proto == IPPROTO_TCP));
+	if (cacheable) {
+		best_match = conn_cache_lookup(pkt, ip_hdr, proto, src_port,
+					       dst_port);
+		if (best_match) {
+			goto deliver;
+		}
+	}
+
 	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
 		/* For packet socket data, the proto is set to ETH_P_ALL but
 		 * the listener might have a specific protocol set. This is ok
@@ -662,6 +789,9 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		 */
 		if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) &&
 		    conn->family == AF_PACKET) {
+			/* Raw sockets see every packet, never skip them */
+			cacheable = false;
+
 			ret = conn_raw_socket(pkt, conn);
 			if (ret == NET_DROP) {
 				goto drop;
@@ -775,6 +905,12 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
+	if (cacheable && best_match) {
+		conn_cache_store(best_match, pkt, ip_hdr, proto, src_port,
+				 dst_port);
+	}
+
+deliver:
 	conn = best_match;
 	if (conn) {
 		NET_DBG("[%p] match found cb %p ud %p rank 0x%02x",
@@ -269,6 +269,16 @@ int net_context_get(sa_family_t family,
 #if defined(CONFIG_NET_CONTEXT_RCVTIMEO)
 		contexts[i].options.rcvtimeo = K_FOREVER;
 #endif
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+		/* TCP sets the receive buffer to its window size */
+		if (ip_proto != IPPROTO_TCP) {
+			contexts[i].options.rcvbuf =
+				CONFIG_NET_CONTEXT_RCVBUF_DEFAULT;
+		}
+#endif
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+		contexts[i].options.sndbuf = CONFIG_NET_CONTEXT_SNDBUF_DEFAULT;
+#endif
 
 		if (IS_ENABLED(CONFIG_NET_IPV6) ||
 		    IS_ENABLED(CONFIG_NET_IPV4)) {
@@ -1235,6 +1245,52 @@ static int get_context_rcvtimeo(struct net_context *context,
 #endif
 }
 
+static int get_context_rcvbuf(struct net_context *context,
+			      void *value, size_t *len)
+{
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	*((int *)value) = context->options.rcvbuf;
+
+	if (len) {
+		*len = sizeof(int);
+	}
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+static int get_context_sndbuf(struct net_context *context,
+			      void *value, size_t *len)
+{
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+	*((int *)value) = context->options.sndbuf;
+
+	if (len) {
+		*len = sizeof(int);
+	}
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+static int get_context_tcp_congestion(struct net_context *context,
+				      void *value, size_t *len)
+{
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	if (net_context_get_ip_proto(context) != IPPROTO_TCP || !len) {
+		return -EINVAL;
+	}
+
+	return net_tcp_get_congestion(context, value, len);
+#else
+	return -ENOTSUP;
+#endif
+}
+
 /* If buf is not NULL, then use it. Otherwise read the data to be written
  * to net_pkt from msghdr.
  */
@@ -1386,6 +1442,32 @@ static void set_pkt_txtime(struct net_pkt *pkt, const struct msghdr *msghdr)
 	}
 }
 
+/* The charge is released by net_pkt_unref() when the packet is freed. The
+ * packet holds a reference to the context until then, so that the space is
+ * never given back to a context that was released and reused meanwhile.
+ */
+static int context_sndbuf_charge(struct net_context *context,
+				 struct net_pkt *pkt, size_t len)
+{
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+	uint32_t sndbuf = context->options.sndbuf;
+
+	/* A datagram larger than the whole buffer can still be sent when
+	 * nothing else is queued.
+	 */
+	if (sndbuf && atomic_get(&context->sndbuf_used) > 0 &&
+	    atomic_get(&context->sndbuf_used) + len > sndbuf) {
+		return -EAGAIN;
+	}
+
+	net_context_ref(context);
+	atomic_add(&context->sndbuf_used, len);
+	net_pkt_set_sndbuf_len(pkt, len);
+#endif
+
+	return 0;
+}
+
 static int context_sendto(struct net_context *context,
 			  const void *buf,
 			  size_t len,
@@ -1655,6 +1737,11 @@ static int context_sendto(struct net_context *context,
 		}
 	} else if (IS_ENABLED(CONFIG_NET_UDP) &&
 	    net_context_get_ip_proto(context) == IPPROTO_UDP) {
+		ret = context_sndbuf_charge(context, pkt, len);
+		if (ret < 0) {
+			goto fail;
+		}
+
 		ret = context_setup_udp_packet(context, pkt, buf, len, msghdr,
 					       dst_addr, addrlen);
 		if (ret < 0) {
@@ -2092,8 +2179,32 @@ int net_context_update_recv_wnd(struct net_context *context,
 
 	k_mutex_lock(&context->lock, K_FOREVER);
 
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	if (net_context_get_type(context) != SOCK_STREAM) {
+		uint32_t rcvbuf = context->options.rcvbuf;
+
+		if (rcvbuf && delta < 0 &&
+		    atomic_get(&context->rcvbuf_used) - delta >
+		    (atomic_val_t)rcvbuf) {
+			context->rcvbuf_drops++;
+			net_stats_update_udp_drop(net_context_get_iface(context));
+			ret = -ENOBUFS;
+		} else {
+			atomic_sub(&context->rcvbuf_used, delta);
+			ret = 0;
+		}
+
+		goto unlock;
+	}
+
+	atomic_sub(&context->rcvbuf_used, delta);
+#endif
+
 	ret = net_tcp_update_recv_wnd(context, delta);
 
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+unlock:
+#endif
 	k_mutex_unlock(&context->lock);
 
 	return ret;
@@ -2186,6 +2297,74 @@ static int set_context_rcvtimeo(struct net_context *context,
 #endif
 }
 
+static int set_context_rcvbuf(struct net_context *context,
+			      const void *value, size_t len)
+{
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	int rcvbuf;
+
+	if (len != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	rcvbuf = *((int *)value);
+	if (rcvbuf < 0) {
+		return -EINVAL;
+	}
+
+	if (net_context_get_ip_proto(context) == IPPROTO_TCP) {
+		/* The window cannot be smaller than one segment */
+		context->options.rcvbuf = MAX(rcvbuf, NET_IPV6_MTU);
+
+		/* Advertise the new window */
+		(void)net_tcp_update_recv_wnd(context, 0);
+	} else {
+		context->options.rcvbuf = rcvbuf;
+	}
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+static int set_context_sndbuf(struct net_context *context,
+			      const void *value, size_t len)
+{
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+	int sndbuf;
+
+	if (len != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	sndbuf = *((int *)value);
+	if (sndbuf < 0) {
+		return -EINVAL;
+	}
+
+	context->options.sndbuf = sndbuf;
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+static int set_context_tcp_congestion(struct net_context *context,
+				      const void *value, size_t len)
+{
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	if (net_context_get_ip_proto(context) != IPPROTO_TCP) {
+		return -EINVAL;
+	}
+
+	return net_tcp_set_congestion(context, value, len);
+#else
+	return -ENOTSUP;
+#endif
+}
+
 int net_context_set_option(struct net_context *context,
 			   enum net_context_option option,
 			   const void *value, size_t len)
@@ -2216,6 +2395,15 @@ int net_context_set_option(struct net_context *context,
 	case NET_OPT_RCVTIMEO:
 		ret = set_context_rcvtimeo(context, value, len);
 		break;
+	case NET_OPT_TCP_CONGESTION:
+		ret = set_context_tcp_congestion(context, value, len);
+		break;
+	case NET_OPT_RCVBUF:
+		ret = set_context_rcvbuf(context, value, len);
+		break;
+	case NET_OPT_SNDBUF:
+		ret = set_context_sndbuf(context, value, len);
+		break;
 	}
 
 	k_mutex_unlock(&context->lock);
@@ -2253,6 +2441,15 @@ int net_context_get_option(struct net_context *context,
 	case NET_OPT_RCVTIMEO:
 		ret = get_context_rcvtimeo(context, value, len);
 		break;
+	case NET_OPT_TCP_CONGESTION:
+		ret = get_context_tcp_congestion(context, value, len);
+		break;
+	case NET_OPT_RCVBUF:
+		ret = get_context_rcvbuf(context, value, len);
+		break;
+	case NET_OPT_SNDBUF:
+		ret = get_context_sndbuf(context, value, len);
+		break;
 	}
 
 	k_mutex_unlock(&context->lock);
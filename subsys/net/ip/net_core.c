@@ -339,9 +339,6 @@ static void net_rx(struct net_if *iface, struct net_pkt *pkt)
 	}
 
 	processing_data(pkt, is_loopback);
-
-	net_print_statistics();
-	net_pkt_print();
 }
 
 static void process_rx_packet(struct k_work *work)
@@ -353,14 +350,35 @@ static void process_rx_packet(struct k_work *work)
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
 	net_rx(net_pkt_iface(pkt), pkt);
+
+	net_print_statistics();
+	net_pkt_print();
+}
+
+#if defined(CONFIG_NET_RX_BATCH)
+void net_process_rx_batch(struct net_pkt **pkts, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i < count; i++) {
+		net_pkt_set_rx_stats_tick(pkts[i], k_cycle_get_32());
+
+		net_rx(net_pkt_iface(pkts[i]), pkts[i]);
+	}
+
+	net_print_statistics();
+	net_pkt_print();
 }
+#endif /* CONFIG_NET_RX_BATCH */
 
 static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 {
 	uint8_t prio = net_pkt_priority(pkt);
 	uint8_t tc = net_rx_priority2tc(prio);
 
-	k_work_init(net_pkt_work(pkt), process_rx_packet);
+	if (!IS_ENABLED(CONFIG_NET_RX_BATCH)) {
+		k_work_init(net_pkt_work(pkt), process_rx_packet);
+	}
 
 #if defined(CONFIG_NET_STATISTICS)
 	net_stats_update_tc_recv_pkt(iface, tc);
@@ -407,6 +425,39 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 	return 0;
 }
 
+int net_recv_data_batch(struct net_if *iface, struct net_pkt **pkts,
+			size_t count)
+{
+	bool sched_locked = false;
+	size_t i;
+	int ret = 0;
+
+	if (!pkts) {
+		return -EINVAL;
+	}
+
+	/* Queue the whole batch before a pre-emptive Rx thread gets a
+	 * chance to run, so that it is woken up only once.
+	 */
+	if (IS_ENABLED(CONFIG_NET_RX_BATCH) && !k_is_in_isr()) {
+		k_sched_lock();
+		sched_locked = true;
+	}
+
+	for (i = 0; i < count; i++) {
+		ret = net_recv_data(iface, pkts[i]);
+		if (ret < 0) {
+			break;
+		}
+	}
+
+	if (sched_locked) {
+		k_sched_unlock();
+	}
+
+	return (i == 0 && ret < 0) ? ret : (int)i;
+}
+
 static inline void l3_init(void)
 {
 	net_icmpv4_init();
@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_tc, CONFIG_NET_TC_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <string.h>
+
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_if.h>
+#include <net/net_context.h>
+#include <net/net_stats.h>
+
+#include "net_private.h"
+#include "net_stats.h"
+#include "net_fq_codel.h"
+
+#define FQ_QUANTUM CONFIG_NET_TX_FQ_CODEL_QUANTUM
+#define FQ_LIMIT CONFIG_NET_TX_FQ_CODEL_LIMIT
+#define CODEL_TARGET CONFIG_NET_TX_FQ_CODEL_TARGET_MS
+#define CODEL_INTERVAL CONFIG_NET_TX_FQ_CODEL_INTERVAL_MS
+
+/* The flow queue node must not overwrite the k_work handler or flags */
+BUILD_ASSERT(offsetof(struct net_pkt, fq_node) ==
+	     offsetof(struct net_pkt, work));
+BUILD_ASSERT(sizeof(sys_snode_t) <= offsetof(struct k_work, handler));
+
+static inline bool time_reached(uint32_t now, uint32_t time)
+{
+	return (int32_t)(now - time) >= 0;
+}
+
+static uint32_t fq_isqrt(uint32_t x)
+{
+	uint32_t res = 0U;
+	uint32_t bit = 1UL << 30;
+
+	while (bit > x) {
+		bit >>= 2;
+	}
+
+	while (bit) {
+		if (x >= res + bit) {
+			x -= res + bit;
+			res = (res >> 1) + bit;
+		} else {
+			res >>= 1;
+		}
+
+		bit >>= 2;
+	}
+
+	return res;
+}
+
+/* Next drop time, interval / sqrt(count) after t, RFC 8289 ch 5.5 */
+static uint32_t codel_control_law(uint32_t t, uint32_t count)
+{
+	return t + MAX(1U, CODEL_INTERVAL / fq_isqrt(count));
+}
+
+static struct net_fq_flow *fq_flow_get(struct net_fq_codel *fq,
+				       struct net_pkt *pkt)
+{
+	struct net_context *context = net_pkt_context(pkt);
+	uintptr_t key;
+
+	/* The contexts are allocated from an array so dividing the address
+	 * by the size gives consecutive keys to consecutive contexts, and
+	 * up to CONFIG_NET_TX_FQ_CODEL_FLOWS contexts never share a queue.
+	 * Packets sent by the stack itself are grouped by family.
+	 */
+	if (context) {
+		key = (uintptr_t)context / sizeof(*context);
+	} else {
+		key = net_pkt_family(pkt);
+	}
+
+	return &fq->flows[key % ARRAY_SIZE(fq->flows)];
+}
+
+static struct net_pkt *fq_flow_pop(struct net_fq_codel *fq,
+				   struct net_fq_flow *flow)
+{
+	struct net_pkt *pkt;
+	sys_snode_t *node;
+
+	node = sys_slist_get(&flow->queue);
+	if (!node) {
+		return NULL;
+	}
+
+	pkt = CONTAINER_OF(node, struct net_pkt, fq_node);
+
+	flow->backlog -= net_pkt_get_len(pkt);
+	fq->qlen--;
+
+	return pkt;
+}
+
+/* Dropped packets are collected and freed after the lock is released */
+static void fq_drop(struct net_pkt *pkt, sys_slist_t *drops, bool codel)
+{
+	if (codel) {
+		net_stats_update_fq_codel_drop_codel(net_pkt_iface(pkt));
+	} else {
+		net_stats_update_fq_codel_drop_overlimit(net_pkt_iface(pkt));
+	}
+
+	NET_DBG("Drop pkt %p (%s)", pkt, codel ? "codel" : "overlimit");
+
+	sys_slist_append(drops, &pkt->fq_node);
+}
+
+static void fq_free(sys_slist_t *drops)
+{
+	sys_snode_t *node;
+
+	while ((node = sys_slist_get(drops))) {
+		struct net_pkt *pkt = CONTAINER_OF(node, struct net_pkt,
+						   fq_node);
+
+#if defined(CONFIG_NET_POWER_MANAGEMENT)
+		net_pkt_iface(pkt)->tx_pending--;
+#endif
+		net_pkt_unref(pkt);
+	}
+}
+
+/* RFC 8289 ch 5.3 */
+static struct net_pkt *codel_dodequeue(struct net_fq_codel *fq,
+				       struct net_fq_flow *flow,
+				       uint32_t now, bool *ok_to_drop)
+{
+	struct net_pkt *pkt;
+	uint32_t sojourn;
+
+	*ok_to_drop = false;
+
+	pkt = fq_flow_pop(fq, flow);
+	if (!pkt) {
+		flow->first_above_time = 0U;
+		return NULL;
+	}
+
+	sojourn = now - net_pkt_fq_time(pkt);
+
+	if (sojourn < CODEL_TARGET || flow->backlog <= FQ_QUANTUM) {
+		/* Went below the target, or less than a packet is left */
+		flow->first_above_time = 0U;
+	} else if (!flow->first_above_time) {
+		/* Zero means unset, so the time is kept odd */
+		flow->first_above_time = (now + CODEL_INTERVAL) | 1U;
+	} else if (time_reached(now, flow->first_above_time)) {
+		*ok_to_drop = true;
+	}
+
+	return pkt;
+}
+
+/* RFC 8289 ch 5.4 */
+static struct net_pkt *codel_dequeue(struct net_fq_codel *fq,
+				     struct net_fq_flow *flow, uint32_t now,
+				     sys_slist_t *drops)
+{
+	struct net_pkt *pkt;
+	bool ok_to_drop;
+
+	pkt = codel_dodequeue(fq, flow, now, &ok_to_drop);
+	if (!pkt) {
+		flow->dropping = false;
+		return NULL;
+	}
+
+	if (flow->dropping) {
+		if (!ok_to_drop) {
+			flow->dropping = false;
+		}
+
+		while (flow->dropping && time_reached(now, flow->drop_next)) {
+			fq_drop(pkt, drops, true);
+			flow->count++;
+
+			pkt = codel_dodequeue(fq, flow, now, &ok_to_drop);
+			if (!pkt || !ok_to_drop) {
+				flow->dropping = false;
+			} else {
+				flow->drop_next =
+					codel_control_law(flow->drop_next,
+							  flow->count);
+			}
+		}
+	} else if (ok_to_drop) {
+		uint32_t delta;
+
+		fq_drop(pkt, drops, true);
+		pkt = codel_dodequeue(fq, flow, now, &ok_to_drop);
+
+		flow->dropping = true;
+
+		/* Start from the previous drop rate if the last dropping
+		 * state ended recently.
+		 */
+		delta = flow->count - flow->lastcount;
+		flow->count = 1U;
+
+		if (delta > 1 &&
+		    (int32_t)(now - flow->drop_next) < 16 * CODEL_INTERVAL) {
+			flow->count = delta;
+		}
+
+		flow->drop_next = codel_control_law(now, flow->count);
+		flow->lastcount = flow->count;
+	}
+
+	return pkt;
+}
+
+void net_fq_codel_init(struct net_fq_codel *fq)
+{
+	int i;
+
+	memset(fq, 0, sizeof(*fq));
+
+	sys_slist_init(&fq->new_flows);
+	sys_slist_init(&fq->old_flows);
+
+	for (i = 0; i < ARRAY_SIZE(fq->flows); i++) {
+		sys_slist_init(&fq->flows[i].queue);
+	}
+}
+
+void net_fq_codel_enqueue(struct net_fq_codel *fq, struct net_pkt *pkt)
+{
+	struct net_fq_flow *flow = fq_flow_get(fq, pkt);
+	sys_slist_t drops;
+	k_spinlock_key_t key;
+
+	sys_slist_init(&drops);
+
+	net_pkt_set_fq_time(pkt, k_uptime_get_32());
+
+	key = k_spin_lock(&fq->lock);
+
+	sys_slist_append(&flow->queue, &pkt->fq_node);
+	flow->backlog += net_pkt_get_len(pkt);
+	fq->qlen++;
+
+	net_stats_update_fq_codel_enqueued(net_pkt_iface(pkt));
+
+	if (!flow->active) {
+		flow->active = true;
+		flow->deficit = FQ_QUANTUM;
+		sys_slist_append(&fq->new_flows, &flow->node);
+
+		net_stats_update_fq_codel_new_flows(net_pkt_iface(pkt));
+	}
+
+	if (fq->qlen > FQ_LIMIT) {
+		struct net_fq_flow *fattest = &fq->flows[0];
+		int i;
+
+		for (i = 1; i < ARRAY_SIZE(fq->flows); i++) {
+			if (fq->flows[i].backlog > fattest->backlog) {
+				fattest = &fq->flows[i];
+			}
+		}
+
+		fq_drop(fq_flow_pop(fq, fattest), &drops, false);
+	}
+
+	k_spin_unlock(&fq->lock, key);
+
+	fq_free(&drops);
+}
+
+/* RFC 8290 ch 4.2 */
+struct net_pkt *net_fq_codel_dequeue(struct net_fq_codel *fq)
+{
+	uint32_t now = k_uptime_get_32();
+	struct net_pkt *pkt = NULL;
+	struct net_fq_flow *flow;
+	k_spinlock_key_t key;
+	sys_slist_t drops;
+	sys_slist_t *list;
+	sys_snode_t *node;
+
+	sys_slist_init(&drops);
+
+	key = k_spin_lock(&fq->lock);
+
+	while (true) {
+		list = &fq->new_flows;
+		node = sys_slist_peek_head(list);
+		if (!node) {
+			list = &fq->old_flows;
+			node = sys_slist_peek_head(list);
+			if (!node) {
+				break;
+			}
+		}
+
+		flow = CONTAINER_OF(node, struct net_fq_flow, node);
+
+		if (flow->deficit <= 0) {
+			flow->deficit += FQ_QUANTUM;
+			sys_slist_get(list);
+			sys_slist_append(&fq->old_flows, node);
+			continue;
+		}
+
+		pkt = codel_dequeue(fq, flow, now, &drops);
+		if (!pkt) {
+			sys_slist_get(list);
+
+			/* An emptied new flow goes through the old list once
+			 * so that it cannot starve the old flows by going
+			 * idle and active again.
+			 */
+			if (list == &fq->new_flows &&
+			    !sys_slist_is_empty(&fq->old_flows)) {
+				sys_slist_append(&fq->old_flows, node);
+			} else {
+				flow->active = false;
+			}
+
+			continue;
+		}
+
+		flow->deficit -= net_pkt_get_len(pkt);
+		break;
+	}
+
+	k_spin_unlock(&fq->lock, key);
+
+	fq_free(&drops);
+
+	if (pkt) {
+		net_stats_update_fq_codel_dequeued(net_pkt_iface(pkt));
+	}
+
+	return pkt;
+}
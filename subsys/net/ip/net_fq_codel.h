@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief Flow queueing with CoDel for the network Tx path
+ *
+ * - Packets are hashed into a fixed number of flow queues by the
+ *   network context that sent them.
+ * - Flow queues are served with deficit round robin using a quantum of
+ *   CONFIG_NET_TX_FQ_CODEL_QUANTUM bytes. Flows that just became active
+ *   are served before the old ones, which gives sparse flows such as
+ *   DNS or control traffic a low latency next to bulk transfers.
+ * - Each flow runs its own CoDel instance that drops packets when the
+ *   flow keeps a standing queue, see RFC 8289 and RFC 8290.
+ */
+
+#ifndef __NET_FQ_CODEL_H
+#define __NET_FQ_CODEL_H
+
+#include <kernel.h>
+#include <sys/slist.h>
+#include <net/net_pkt.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct net_fq_flow {
+	sys_snode_t node;		/* entry in new_flows or old_flows */
+	sys_slist_t queue;		/* queued packets */
+	uint32_t backlog;		/* queued bytes */
+	int32_t deficit;		/* DRR deficit in bytes */
+
+	/* CoDel state, times are in ms */
+	uint32_t first_above_time;
+	uint32_t drop_next;
+	uint32_t count;
+	uint32_t lastcount;
+	bool dropping;
+	bool active;			/* flow is in one of the lists */
+};
+
+struct net_fq_codel {
+	struct k_spinlock lock;
+	sys_slist_t new_flows;
+	sys_slist_t old_flows;
+	uint32_t qlen;			/* packets in all the flows */
+	struct net_fq_flow flows[CONFIG_NET_TX_FQ_CODEL_FLOWS];
+};
+
+/**
+ * @brief Initialize the flow queues
+ *
+ * @param fq Flow queues of a Tx traffic class
+ */
+void net_fq_codel_init(struct net_fq_codel *fq);
+
+/**
+ * @brief Queue a packet to its flow
+ *
+ * @details If the queue limit is exceeded, a packet is dropped from the
+ * flow with the largest backlog, which may be the packet just queued.
+ * The caller does not own the packet after this call.
+ *
+ * @param fq Flow queues of a Tx traffic class
+ * @param pkt Packet whose k_work has been initialized for sending
+ */
+void net_fq_codel_enqueue(struct net_fq_codel *fq, struct net_pkt *pkt);
+
+/**
+ * @brief Get the next packet to send
+ *
+ * @param fq Flow queues of a Tx traffic class
+ *
+ * @return Packet or NULL if all the flows are empty
+ */
+struct net_pkt *net_fq_codel_dequeue(struct net_fq_codel *fq);
+
+/**
+ * @brief Check whether packets are waiting in the flow queues
+ */
+static inline bool net_fq_codel_is_empty(struct net_fq_codel *fq)
+{
+	return fq->qlen == 0U;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NET_FQ_CODEL_H */
@@ -582,6 +582,16 @@ done:
 		return;
 	}
 
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+	/* The packet has left the stack, give the space back to the sender
+	 * and drop the reference taken when the space was charged.
+	 */
+	if (pkt->sndbuf_len && pkt->context) {
+		atomic_sub(&pkt->context->sndbuf_used, pkt->sndbuf_len);
+		net_context_unref(pkt->context);
+	}
+#endif
+
 	if (pkt->frags) {
 		net_pkt_frag_unref(pkt->frags);
 	}
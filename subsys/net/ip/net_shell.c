@@ -1042,6 +1042,23 @@ static void print_net_pm_stats(const struct shell *shell, struct net_if *iface)
 #endif
 }
 
+static void print_net_fq_codel_stats(const struct shell *shell,
+				     struct net_if *iface)
+{
+#if defined(CONFIG_NET_STATISTICS_FQ_CODEL)
+	PR("TX flow queue stats:\n");
+	PR("\tEnqueued      : %u\n", GET_STAT(iface, fq_codel.enqueued));
+	PR("\tDequeued      : %u\n", GET_STAT(iface, fq_codel.dequeued));
+	PR("\tCoDel drops   : %u\n", GET_STAT(iface, fq_codel.drop_codel));
+	PR("\tOverlimit drop: %u\n",
+	   GET_STAT(iface, fq_codel.drop_overlimit));
+	PR("\tNew flows     : %u\n", GET_STAT(iface, fq_codel.new_flows));
+#else
+	ARG_UNUSED(shell);
+	ARG_UNUSED(iface);
+#endif
+}
+
 static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 {
 	struct net_shell_user_data *data = user_data;
@@ -1147,6 +1164,9 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 	PR("Bytes received %u\n", GET_STAT(iface, bytes.received));
 	PR("Bytes sent     %u\n", GET_STAT(iface, bytes.sent));
 	PR("Processing err %d\n", GET_STAT(iface, processing_error));
+#if defined(CONFIG_NET_RX_BATCH)
+	PR("Rx batches     %d\n", GET_STAT(iface, rx_batches));
+#endif
 
 	print_tc_tx_stats(shell, iface);
 	print_tc_rx_stats(shell, iface);
@@ -1180,6 +1200,7 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 #endif /* CONFIG_NET_STATISTICS_PPP && CONFIG_NET_STATISTICS_USER_API */
 
 	print_net_pm_stats(shell, iface);
+	print_net_fq_codel_stats(shell, iface);
 }
 #endif /* CONFIG_NET_STATISTICS */
 
@@ -1404,6 +1425,39 @@ static void tcp_sent_list_cb(struct net_tcp *tcp, void *user_data)
 #endif /* CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG */
 #endif /* TCP1 */
 
+#if defined(CONFIG_NET_CONTEXT_RCVBUF) || defined(CONFIG_NET_CONTEXT_SNDBUF)
+static void context_buf_cb(struct net_context *context, void *user_data)
+{
+	struct net_shell_user_data *data = user_data;
+	const struct shell *shell = data->shell;
+	int *count = data->user_data;
+	int rcvbuf_used = 0, rcvbuf = 0, sndbuf_used = 0, sndbuf = 0;
+	uint32_t drops = 0U;
+
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	rcvbuf_used = MAX(atomic_get(&context->rcvbuf_used), 0);
+	rcvbuf = context->options.rcvbuf;
+	drops = context->rcvbuf_drops;
+#endif
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+	sndbuf_used = MAX(atomic_get(&context->sndbuf_used), 0);
+	sndbuf = context->options.sndbuf;
+#if defined(CONFIG_NET_TCP2)
+	/* TCP keeps the unacknowledged data itself */
+	if (context->tcp) {
+		sndbuf_used = ((struct tcp *)context->tcp)->send_data_total;
+	}
+#endif
+#endif
+
+	PR("[%2d] %p %8d %8d %8u %8d %8d\n",
+	   (*count) + 1, context, rcvbuf_used, rcvbuf, drops,
+	   sndbuf_used, sndbuf);
+
+	(*count)++;
+}
+#endif /* CONFIG_NET_CONTEXT_RCVBUF || CONFIG_NET_CONTEXT_SNDBUF */
+
 #if defined(CONFIG_NET_TCP2) && \
 	(defined(CONFIG_NET_OFFLOAD) || defined(CONFIG_NET_NATIVE))
 static void tcp_cb(struct tcp *conn, void *user_data)
@@ -1423,6 +1477,34 @@ static void tcp_cb(struct tcp *conn, void *user_data)
 	(*count)++;
 }
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+static void tcp_cc_cb(struct tcp *conn, void *user_data)
+{
+	struct net_shell_user_data *data = user_data;
+	const struct shell *shell = data->shell;
+	int *count = data->user_data;
+	int srtt = -1, rttvar = -1;
+
+	if (conn->state == TCP_LISTEN) {
+		return;
+	}
+
+#if defined(CONFIG_NET_TCP_TIMESTAMPS)
+	if (conn->rto) {
+		srtt = conn->srtt >> 3;
+		rttvar = conn->rttvar >> 2;
+	}
+#endif
+
+	PR("%p %-8s %8u %10u %8u %5d %6d %5d\n",
+	   conn, conn->cc->name, conn->cwnd,
+	   conn->ssthresh, conn->send_win, srtt, rttvar,
+	   conn->rto ? conn->rto : CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT);
+
+	(*count)++;
+}
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
+
 #if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
 static void tcp_sent_list_cb(struct tcp *conn, void *user_data)
 {
@@ -1719,6 +1801,17 @@ static int cmd_net_conn(const struct shell *shell, size_t argc, char *argv[])
 		PR("No connections\n");
 	}
 
+#if defined(CONFIG_NET_CONTEXT_RCVBUF) || defined(CONFIG_NET_CONTEXT_SNDBUF)
+	if (count > 0) {
+		PR("\n     Context     Rcv-used   Rcvbuf    Drops "
+		   "Snd-used   Sndbuf\n");
+
+		count = 0;
+
+		net_context_foreach(context_buf_cb, &user_data);
+	}
+#endif
+
 #if CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG
 	PR("\n     Handler    Callback  \tProto\tLocal           \tRemote\n");
 
@@ -1742,6 +1835,15 @@ static int cmd_net_conn(const struct shell *shell, size_t argc, char *argv[])
 	if (count == 0) {
 		PR("No TCP connections\n");
 	} else {
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+		PR("\nTCP        CC           Cwnd   Ssthresh Send_win  SRTT "
+		   "RTTvar   RTO\n");
+
+		count = 0;
+
+		net_tcp_foreach(tcp_cc_cb, &user_data);
+#endif
+
 #if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
 		/* Print information about pending packets */
 		struct tcp2_detail_info details;
@@ -158,6 +158,9 @@ static inline void stats(struct net_if *iface)
 		NET_INFO("Bytes sent     %u", GET_STAT(iface, bytes.sent));
 		NET_INFO("Processing err %d",
 			 GET_STAT(iface, processing_error));
+#if defined(CONFIG_NET_RX_BATCH)
+		NET_INFO("Rx batches     %d", GET_STAT(iface, rx_batches));
+#endif
 
 #if NET_TC_COUNT > 1
 #if NET_TC_TX_COUNT > 1
@@ -302,6 +305,12 @@ static int net_stats_get(uint32_t mgmt_request, struct net_if *iface,
 		len_chk = sizeof(struct net_stats_pm);
 		src = GET_STAT_ADDR(iface, pm);
 		break;
+#endif
+#if defined(CONFIG_NET_STATISTICS_FQ_CODEL)
+	case NET_REQUEST_STATS_CMD_GET_FQ_CODEL:
+		len_chk = sizeof(struct net_stats_fq_codel);
+		src = GET_STAT_ADDR(iface, fq_codel);
+		break;
 #endif
 	}
 
@@ -361,6 +370,11 @@ NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PM,
 				  net_stats_get);
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_FQ_CODEL)
+NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_FQ_CODEL,
+				  net_stats_get);
+#endif
+
 #endif /* CONFIG_NET_STATISTICS_USER_API */
 
 void net_stats_reset(struct net_if *iface)
@@ -67,6 +67,16 @@ static inline void net_stats_update_bytes_sent(struct net_if *iface,
 #define net_stats_update_bytes_sent(iface, bytes)
 #endif /* CONFIG_NET_STATISTICS */
 
+#if defined(CONFIG_NET_RX_BATCH) && defined(CONFIG_NET_STATISTICS) && \
+	defined(CONFIG_NET_NATIVE)
+static inline void net_stats_update_rx_batches(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.rx_batches++);
+}
+#else
+#define net_stats_update_rx_batches(iface)
+#endif /* CONFIG_NET_RX_BATCH && CONFIG_NET_STATISTICS */
+
 #if defined(CONFIG_NET_STATISTICS_IPV6) && defined(CONFIG_NET_NATIVE_IPV6)
 /* IPv6 stats */
 
@@ -601,6 +611,40 @@ static inline void net_stats_add_suspend_end_time(struct net_if *iface,
 #define net_stats_add_suspend_end_time(iface, time)
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_FQ_CODEL) && defined(CONFIG_NET_NATIVE)
+static inline void net_stats_update_fq_codel_enqueued(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.fq_codel.enqueued++);
+}
+
+static inline void net_stats_update_fq_codel_dequeued(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.fq_codel.dequeued++);
+}
+
+static inline void net_stats_update_fq_codel_drop_codel(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.fq_codel.drop_codel++);
+}
+
+static inline void net_stats_update_fq_codel_drop_overlimit(
+							struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.fq_codel.drop_overlimit++);
+}
+
+static inline void net_stats_update_fq_codel_new_flows(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.fq_codel.new_flows++);
+}
+#else
+#define net_stats_update_fq_codel_enqueued(iface)
+#define net_stats_update_fq_codel_dequeued(iface)
+#define net_stats_update_fq_codel_drop_codel(iface)
+#define net_stats_update_fq_codel_drop_overlimit(iface)
+#define net_stats_update_fq_codel_new_flows(iface)
+#endif /* CONFIG_NET_STATISTICS_FQ_CODEL */
+
 #if defined(CONFIG_NET_STATISTICS_PERIODIC_OUTPUT) \
 	&& defined(CONFIG_NET_NATIVE)
 /* A simple periodic statistic printer, used only in net core */
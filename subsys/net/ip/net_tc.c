@@ -17,6 +17,7 @@ LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 #include "net_private.h"
 #include "net_stats.h"
 #include "net_tc_mapping.h"
+#include "net_fq_codel.h"
 
 /* Template for thread name. The "xx" is either "TX" denoting transmit thread,
  * or "RX" denoting receive thread. The "q[y]" denotes the traffic class queue
@@ -35,6 +36,81 @@ K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, NET_TC_RX_COUNT,
 static struct net_traffic_class tx_classes[NET_TC_TX_COUNT];
 static struct net_traffic_class rx_classes[NET_TC_RX_COUNT];
 
+#if defined(CONFIG_NET_RX_BATCH)
+/* In batch mode the received packets are queued per traffic class and a
+ * single work item drains them, so the Rx thread is woken up once for a
+ * burst of packets instead of once for every packet.
+ */
+struct net_rx_batch {
+	struct k_work work;
+	struct k_fifo fifo;
+	uint8_t tc;
+};
+
+static struct net_rx_batch rx_batches[NET_TC_RX_COUNT];
+
+static void rx_batch_process(struct k_work *work)
+{
+	struct net_rx_batch *batch = CONTAINER_OF(work, struct net_rx_batch,
+						  work);
+	struct net_pkt *pkts[CONFIG_NET_RX_BATCH_SIZE];
+	struct net_pkt *pkt;
+	size_t count = 0;
+
+	while (count < ARRAY_SIZE(pkts)) {
+		pkt = k_fifo_get(&batch->fifo, K_NO_WAIT);
+		if (!pkt) {
+			break;
+		}
+
+		pkts[count++] = pkt;
+	}
+
+	if (count) {
+		net_stats_update_rx_batches(net_pkt_iface(pkts[0]));
+		net_process_rx_batch(pkts, count);
+	}
+
+	/* Let other work in the queue run before the rest of the burst */
+	if (!k_fifo_is_empty(&batch->fifo)) {
+		k_work_submit_to_queue(&rx_classes[batch->tc].work_q, work);
+	}
+}
+#endif /* CONFIG_NET_RX_BATCH */
+
+#if defined(CONFIG_NET_TX_FQ_CODEL)
+/* Packets of a Tx traffic class wait in the flow queues and a single work
+ * item passes them to the driver one at a time in fair queueing order.
+ */
+struct net_tx_fq {
+	struct k_work work;
+	struct net_fq_codel fq;
+	uint8_t tc;
+};
+
+static struct net_tx_fq tx_fqs[NET_TC_TX_COUNT];
+
+static void tx_fq_process(struct k_work *work)
+{
+	struct net_tx_fq *txq = CONTAINER_OF(work, struct net_tx_fq, work);
+	struct net_pkt *pkt;
+
+	pkt = net_fq_codel_dequeue(&txq->fq);
+	if (pkt) {
+		struct k_work *pkt_work = net_pkt_work(pkt);
+
+		/* The packet work was set up by net_if_queue_tx() and we
+		 * are already running in the Tx thread of the class.
+		 */
+		pkt_work->handler(pkt_work);
+	}
+
+	if (!net_fq_codel_is_empty(&txq->fq)) {
+		k_work_submit_to_queue(&tx_classes[txq->tc].work_q, work);
+	}
+}
+#endif /* CONFIG_NET_TX_FQ_CODEL */
+
 bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt)
 {
 	if (k_work_pending(net_pkt_work(pkt))) {
@@ -43,7 +119,12 @@ bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt)
 
 	net_pkt_set_tx_stats_tick(pkt, k_cycle_get_32());
 
+#if defined(CONFIG_NET_TX_FQ_CODEL)
+	net_fq_codel_enqueue(&tx_fqs[tc].fq, pkt);
+	k_work_submit_to_queue(&tx_classes[tc].work_q, &tx_fqs[tc].work);
+#else
 	k_work_submit_to_queue(&tx_classes[tc].work_q, net_pkt_work(pkt));
+#endif
 
 	return true;
 }
@@ -52,7 +133,12 @@ void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt)
 {
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
+#if defined(CONFIG_NET_RX_BATCH)
+	k_fifo_put(&rx_batches[tc].fifo, pkt);
+	k_work_submit_to_queue(&rx_classes[tc].work_q, &rx_batches[tc].work);
+#else
 	k_work_submit_to_queue(&rx_classes[tc].work_q, net_pkt_work(pkt));
+#endif
 }
 
 int net_tx_priority2tc(enum net_priority prio)
@@ -233,6 +319,12 @@ void net_tc_tx_init(void)
 			       K_KERNEL_STACK_SIZEOF(tx_stack[i]),
 			       priority);
 
+#if defined(CONFIG_NET_TX_FQ_CODEL)
+		tx_fqs[i].tc = i;
+		net_fq_codel_init(&tx_fqs[i].fq);
+		k_work_init(&tx_fqs[i].work, tx_fq_process);
+#endif
+
 		if (IS_ENABLED(CONFIG_THREAD_NAME)) {
 			char name[MAX_NAME_LEN];
 
@@ -276,6 +368,12 @@ void net_tc_rx_init(void)
 			       K_KERNEL_STACK_SIZEOF(rx_stack[i]),
 			       priority);
 
+#if defined(CONFIG_NET_RX_BATCH)
+		rx_batches[i].tc = i;
+		k_fifo_init(&rx_batches[i].fifo);
+		k_work_init(&rx_batches[i].work, rx_batch_process);
+#endif
+
 		if (IS_ENABLED(CONFIG_THREAD_NAME)) {
 			char name[MAX_NAME_LEN];
 
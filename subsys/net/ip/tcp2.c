@@ -27,9 +27,17 @@ LOG_MODULE_REGISTER(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
 #define FIN_TIMEOUT_MS MSEC_PER_SEC
 #define FIN_TIMEOUT K_MSEC(FIN_TIMEOUT_MS)
 
+/* Timestamp clock used for RFC 7323 TSval, one tick per millisecond */
+#define tcp_ts_now() k_uptime_get_32()
+
 static int tcp_rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
 static int tcp_retries = CONFIG_NET_TCP_RETRY_COUNT;
-static int tcp_window = NET_IPV6_MTU;
+static int tcp_window =
+#if CONFIG_NET_TCP_MAX_RECV_WINDOW_SIZE != 0
+	CONFIG_NET_TCP_MAX_RECV_WINDOW_SIZE;
+#else
+	NET_IPV6_MTU;
+#endif
 
 static sys_slist_t tcp_conns = SYS_SLIST_STATIC_INIT(&tcp_conns);
 
@@ -594,8 +602,13 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 
 	NET_DBG("len=%zd", len);
 
-	recv_options->mss_found = false;
+	/* The MSS is only sent in SYN segments so keep the value that we
+	 * got during connection establishment.
+	 */
 	recv_options->wnd_found = false;
+	recv_options->sack_perm_found = false;
+	recv_options->ts_found = false;
+	recv_options->sack_count = 0U;
 
 	for ( ; options && len >= 1; options += opt_len, len -= opt_len) {
 		opt = options[0];
@@ -639,9 +652,51 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 				goto end;
 			}
 
-			recv_options->window = opt;
+			recv_options->window = options[2];
 			recv_options->wnd_found = true;
 			break;
+		case TCPOPT_SACK_PERM:
+			if (opt_len != TCPOLEN_SACK_PERM) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->sack_perm_found = true;
+			break;
+		case TCPOPT_SACK:
+			if (((opt_len - 2) % TCPOLEN_SACK_BLOCK) != 0 ||
+			    opt_len == 2) {
+				result = false;
+				goto end;
+			}
+
+			for (int i = 2; i < opt_len &&
+			     recv_options->sack_count < ARRAY_SIZE(
+				     recv_options->sack);
+			     i += TCPOLEN_SACK_BLOCK) {
+				struct tcp_sack_block *blk =
+				  &recv_options->sack[recv_options->sack_count];
+
+				blk->start = ntohl(UNALIGNED_GET(
+						(uint32_t *)(options + i)));
+				blk->end = ntohl(UNALIGNED_GET(
+						(uint32_t *)(options + i + 4)));
+				recv_options->sack_count++;
+			}
+
+			break;
+		case TCPOPT_TIMESTAMP:
+			if (opt_len != TCPOLEN_TIMESTAMP) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->tsval =
+				ntohl(UNALIGNED_GET((uint32_t *)(options + 2)));
+			recv_options->tsecr =
+				ntohl(UNALIGNED_GET((uint32_t *)(options + 6)));
+			recv_options->ts_found = true;
+			break;
 		default:
 			continue;
 		}
@@ -654,6 +709,212 @@ end:
 	return result;
 }
 
+static void tcp_options_negotiate(struct tcp *conn, bool has_options)
+{
+	struct tcp_options *opts = &conn->recv_options;
+
+	conn->wscale_ok = IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) &&
+		has_options && opts->wnd_found;
+	if (conn->wscale_ok) {
+		conn->snd_wscale = MIN(opts->window, TCP_MAX_WINDOW_SHIFT);
+	} else {
+		/* Scaling is only used if both ends send the option */
+		conn->snd_wscale = 0U;
+		conn->rcv_wscale = 0U;
+	}
+
+	conn->sack_ok = IS_ENABLED(CONFIG_NET_TCP_SACK) &&
+		has_options && opts->sack_perm_found;
+
+	conn->ts_ok = IS_ENABLED(CONFIG_NET_TCP_TIMESTAMPS) &&
+		has_options && opts->ts_found;
+
+#if defined(CONFIG_NET_TCP_TIMESTAMPS)
+	if (conn->ts_ok) {
+		conn->ts_recent = opts->tsval;
+	}
+#endif
+
+	NET_DBG("conn: %p wscale %d (snd %hu rcv %hu) sack %d ts %d", conn,
+		conn->wscale_ok, (uint16_t)conn->snd_wscale,
+		(uint16_t)conn->rcv_wscale, conn->sack_ok, conn->ts_ok);
+}
+
+/* Protection Against Wrapped Sequences, RFC 7323 ch 5. Returns false if the
+ * segment is an old duplicate and should be dropped.
+ */
+static bool tcp_paws_check(struct tcp *conn, struct tcphdr *th)
+{
+#if defined(CONFIG_NET_TCP_TIMESTAMPS)
+	struct tcp_options *opts = &conn->recv_options;
+
+	if (!conn->ts_ok || !opts->ts_found) {
+		return true;
+	}
+
+	if ((int32_t)(opts->tsval - conn->ts_recent) < 0 &&
+	    !(th_flags(th) & RST)) {
+		return false;
+	}
+
+	if (net_tcp_seq_cmp(th_seq(th), conn->ack) <= 0) {
+		conn->ts_recent = opts->tsval;
+	}
+#endif
+	return true;
+}
+
+/* Update the RTT estimate and RTO from the echoed timestamp as described in
+ * RFC 6298 ch 2. The srtt is scaled by 8 and rttvar by 4.
+ */
+static void tcp_rtt_update(struct tcp *conn)
+{
+#if defined(CONFIG_NET_TCP_TIMESTAMPS)
+	struct tcp_options *opts = &conn->recv_options;
+	int32_t rtt, delta;
+
+	if (!conn->ts_ok || !opts->ts_found || !opts->tsecr) {
+		return;
+	}
+
+	rtt = (int32_t)(tcp_ts_now() - opts->tsecr);
+	if (rtt < 0) {
+		return;
+	}
+
+	if (!conn->rto) {
+		conn->srtt = rtt << 3;
+		conn->rttvar = rtt << 1;
+	} else {
+		delta = rtt - (conn->srtt >> 3);
+		conn->srtt += delta;
+
+		if (delta < 0) {
+			delta = -delta;
+		}
+
+		conn->rttvar += delta - (conn->rttvar >> 2);
+	}
+
+	conn->rto = (conn->srtt >> 3) + MAX(1, conn->rttvar);
+	conn->rto = CLAMP(conn->rto, TCP_RTO_MIN_MS, TCP_RTO_MAX_MS);
+
+	NET_DBG("conn: %p rtt %d srtt %d rttvar %d rto %d", conn, rtt,
+		conn->srtt >> 3, conn->rttvar >> 2, conn->rto);
+#endif
+}
+
+#if defined(CONFIG_NET_TCP_SACK)
+static void tcp_sack_block_add(struct tcp *conn,
+			       const struct tcp_sack_block *blk)
+{
+	struct tcp_sack_block *sb = conn->sack_scoreboard;
+	struct tcp_sack_block new = *blk;
+	int count = conn->sack_count;
+	int i = 0, j;
+
+	/* The scoreboard is kept sorted, find the first block that ends
+	 * at or after the start of the new block.
+	 */
+	while (i < count && net_tcp_seq_cmp(sb[i].end, new.start) < 0) {
+		i++;
+	}
+
+	/* Merge the blocks that overlap or touch the new block */
+	for (j = i; j < count && net_tcp_seq_cmp(sb[j].start, new.end) <= 0;
+	     j++) {
+		if (net_tcp_seq_cmp(sb[j].start, new.start) < 0) {
+			new.start = sb[j].start;
+		}
+
+		if (net_tcp_seq_cmp(sb[j].end, new.end) > 0) {
+			new.end = sb[j].end;
+		}
+	}
+
+	if (j == i) {
+		if (count == ARRAY_SIZE(conn->sack_scoreboard)) {
+			/* No room, forget the right-most block as it is
+			 * the least useful one for the retransmissions.
+			 */
+			if (i == count) {
+				return;
+			}
+
+			count--;
+		}
+
+		memmove(&sb[i + 1], &sb[i], (count - i) * sizeof(*sb));
+		count++;
+	} else {
+		memmove(&sb[i + 1], &sb[j], (count - j) * sizeof(*sb));
+		count -= j - i - 1;
+	}
+
+	sb[i] = new;
+	conn->sack_count = count;
+}
+
+static void tcp_sack_scoreboard_add(struct tcp *conn)
+{
+	struct tcp_options *opts = &conn->recv_options;
+	uint32_t snd_max = conn->seq + conn->send_data_total;
+
+	for (int i = 0; i < opts->sack_count; i++) {
+		struct tcp_sack_block *blk = &opts->sack[i];
+
+		/* Ignore bogus blocks and blocks that cover data that is
+		 * acknowledged already or that we have not sent.
+		 */
+		if (net_tcp_seq_cmp(blk->end, blk->start) <= 0 ||
+		    net_tcp_seq_cmp(blk->start, conn->seq) < 0 ||
+		    net_tcp_seq_cmp(blk->end, snd_max) > 0) {
+			continue;
+		}
+
+		NET_DBG("conn: %p SACK %u-%u", conn, blk->start, blk->end);
+
+		tcp_sack_block_add(conn, blk);
+	}
+}
+
+static void tcp_sack_scoreboard_prune(struct tcp *conn)
+{
+	struct tcp_sack_block *sb = conn->sack_scoreboard;
+
+	while (conn->sack_count &&
+	       net_tcp_seq_cmp(sb[0].end, conn->seq) <= 0) {
+		conn->sack_count--;
+		memmove(&sb[0], &sb[1], conn->sack_count * sizeof(*sb));
+	}
+
+	if (conn->sack_count && net_tcp_seq_cmp(sb[0].start, conn->seq) < 0) {
+		sb[0].start = conn->seq;
+	}
+}
+
+/* Returns the number of bytes at seq that the peer already holds, and
+ * limits *len so that the segment does not overlap the next SACKed block.
+ */
+static int tcp_sack_skip(struct tcp *conn, uint32_t seq, int *len)
+{
+	struct tcp_sack_block *sb = conn->sack_scoreboard;
+
+	for (int i = 0; i < conn->sack_count; i++) {
+		if (net_tcp_seq_cmp(sb[i].start, seq) > 0) {
+			*len = MIN(*len, (int)(sb[i].start - seq));
+			break;
+		}
+
+		if (net_tcp_seq_cmp(sb[i].end, seq) > 0) {
+			return sb[i].end - seq;
+		}
+	}
+
+	return 0;
+}
+#endif /* CONFIG_NET_TCP_SACK */
+
 static size_t tcp_check_pending_data(struct tcp *conn, struct net_pkt *pkt,
 				     size_t len)
 {
@@ -667,15 +928,30 @@ static size_t tcp_check_pending_data(struct tcp *conn, struct net_pkt *pkt,
 
 		pending_seq = tcp_get_seq(conn->queue_recv_data->buffer);
 		if (pending_seq == expected_seq) {
-			pending_len = net_pkt_get_len(conn->queue_recv_data);
+			struct net_buf *last = conn->queue_recv_data->buffer;
+
+			/* The queue can contain several non-contiguous
+			 * blocks, only pass the first contiguous one.
+			 */
+			pending_len = last->len;
+
+			while (last->frags &&
+			       tcp_get_seq(last->frags) ==
+			       tcp_get_seq(last) + last->len) {
+				last = last->frags;
+				pending_len += last->len;
+			}
 
 			NET_DBG("Found pending data seq %u len %zd",
 				pending_seq, pending_len);
 			net_buf_frag_add(pkt->buffer,
 					 conn->queue_recv_data->buffer);
-			conn->queue_recv_data->buffer = NULL;
+			conn->queue_recv_data->buffer = last->frags;
+			last->frags = NULL;
 
-			k_delayed_work_cancel(&conn->recv_queue_timer);
+			if (!conn->queue_recv_data->buffer) {
+				k_delayed_work_cancel(&conn->recv_queue_timer);
+			}
 		}
 	}
 
@@ -736,11 +1012,134 @@ static int tcp_finalize_pkt(struct net_pkt *pkt)
 	return -EINVAL;
 }
 
+static uint8_t *tcp_option_put32(uint8_t *opt, uint32_t val)
+{
+	UNALIGNED_PUT(htonl(val), (uint32_t *)opt);
+
+	return opt + sizeof(uint32_t);
+}
+
+/* Generate SACK blocks (RFC 2018) describing the out-of-order data that
+ * we have queued. The block with the most recently received data should
+ * be first but as we do not track that, report the blocks closest to the
+ * left window edge first as those are the most useful to the sender.
+ */
+static int tcp_sack_blocks_get(struct tcp *conn, struct tcp_sack_block *blocks,
+			       int max_blocks)
+{
+	struct net_buf *buf;
+	int count = 0;
+
+	if (!CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT ||
+	    net_pkt_is_empty(conn->queue_recv_data)) {
+		return 0;
+	}
+
+	for (buf = conn->queue_recv_data->buffer; buf; buf = buf->frags) {
+		uint32_t seq = tcp_get_seq(buf);
+
+		if (count > 0 && blocks[count - 1].end == seq) {
+			blocks[count - 1].end += buf->len;
+			continue;
+		}
+
+		if (count == max_blocks) {
+			break;
+		}
+
+		blocks[count].start = seq;
+		blocks[count].end = seq + buf->len;
+		count++;
+	}
+
+	return count;
+}
+
+/* Build the TCP options for an outgoing segment. Returns the options length
+ * which is always a multiple of 4.
+ */
+static size_t tcp_options_build(struct tcp *conn, uint8_t flags, uint8_t *buf)
+{
+	uint8_t *opt = buf;
+	bool syn = flags & SYN;
+
+	/* When sending the initial SYN, offer everything that we support.
+	 * In SYN-ACK and the following segments, only use options that
+	 * the peer has also enabled.
+	 */
+	bool offer = syn && !(flags & ACK);
+
+	if (flags & RST) {
+		return 0;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) && syn &&
+	    (offer || conn->wscale_ok)) {
+		*opt++ = TCPOPT_NOP;
+		*opt++ = TCPOPT_WINDOW;
+		*opt++ = TCPOLEN_WINDOW;
+		*opt++ = conn->rcv_wscale;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_TCP_SACK) && syn &&
+	    (offer || conn->sack_ok)) {
+		*opt++ = TCPOPT_NOP;
+		*opt++ = TCPOPT_NOP;
+		*opt++ = TCPOPT_SACK_PERM;
+		*opt++ = TCPOLEN_SACK_PERM;
+	}
+
+#if defined(CONFIG_NET_TCP_TIMESTAMPS)
+	if (offer || conn->ts_ok) {
+		*opt++ = TCPOPT_NOP;
+		*opt++ = TCPOPT_NOP;
+		*opt++ = TCPOPT_TIMESTAMP;
+		*opt++ = TCPOLEN_TIMESTAMP;
+		opt = tcp_option_put32(opt, tcp_ts_now());
+		opt = tcp_option_put32(opt, (flags & ACK) ?
+				       conn->ts_recent : 0U);
+	}
+#endif
+
+	if (IS_ENABLED(CONFIG_NET_TCP_SACK) && !syn && conn->sack_ok &&
+	    (flags & ACK)) {
+		struct tcp_sack_block blocks[TCP_SACK_MAX_BLOCKS + 1];
+		int count;
+
+		count = tcp_sack_blocks_get(conn, blocks,
+					    conn->ts_ok ? TCP_SACK_MAX_BLOCKS :
+					    TCP_SACK_MAX_BLOCKS + 1);
+		if (count > 0) {
+			*opt++ = TCPOPT_NOP;
+			*opt++ = TCPOPT_NOP;
+			*opt++ = TCPOPT_SACK;
+			*opt++ = 2 + count * TCPOLEN_SACK_BLOCK;
+
+			for (int i = 0; i < count; i++) {
+				opt = tcp_option_put32(opt, blocks[i].start);
+				opt = tcp_option_put32(opt, blocks[i].end);
+			}
+		}
+	}
+
+	return opt - buf;
+}
+
+static uint16_t tcp_win_advertised(struct tcp *conn, uint8_t flags)
+{
+	/* Window field in SYN segments is never scaled, RFC 7323 ch 2.2 */
+	uint32_t win = conn->recv_win >> ((flags & SYN) ? 0 : conn->rcv_wscale);
+
+	return MIN(win, UINT16_MAX);
+}
+
 static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
-			  uint32_t seq)
+			  uint32_t seq, const uint8_t *options,
+			  size_t options_len)
 {
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
 	struct tcphdr *th;
+	int ret;
 
 	th = (struct tcphdr *)net_pkt_get_data(pkt, &tcp_access);
 	if (!th) {
@@ -751,16 +1150,21 @@ static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
 
 	UNALIGNED_PUT(conn->src.sin.sin_port, &th->th_sport);
 	UNALIGNED_PUT(conn->dst.sin.sin_port, &th->th_dport);
-	th->th_off = 5;
+	th->th_off = 5 + options_len / 4;
 	UNALIGNED_PUT(flags, &th->th_flags);
-	UNALIGNED_PUT(htons(conn->recv_win), &th->th_win);
+	UNALIGNED_PUT(htons(tcp_win_advertised(conn, flags)), &th->th_win);
 	UNALIGNED_PUT(htonl(seq), &th->th_seq);
 
 	if (ACK & flags) {
 		UNALIGNED_PUT(htonl(conn->ack), &th->th_ack);
 	}
 
-	return net_pkt_set_data(pkt, &tcp_access);
+	ret = net_pkt_set_data(pkt, &tcp_access);
+	if (ret < 0 || !options_len) {
+		return ret;
+	}
+
+	return net_pkt_write(pkt, options, options_len);
 }
 
 static int ip_header_add(struct tcp *conn, struct net_pkt *pkt)
@@ -783,10 +1187,14 @@ static int ip_header_add(struct tcp *conn, struct net_pkt *pkt)
 static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		       uint32_t seq)
 {
+	uint8_t options[40]; /* TCP header max options size is 40 */
+	size_t options_len;
 	struct net_pkt *pkt;
 	int ret = 0;
 
-	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr));
+	options_len = tcp_options_build(conn, flags, options);
+
+	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr) + options_len);
 	if (!pkt) {
 		ret = -ENOBUFS;
 		goto out;
@@ -804,7 +1212,7 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		goto out;
 	}
 
-	ret = tcp_header_add(conn, pkt, flags, seq);
+	ret = tcp_header_add(conn, pkt, flags, seq, options, options_len);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
 		goto out;
@@ -869,9 +1277,65 @@ static int tcp_pkt_peek(struct net_pkt *to, struct net_pkt *from, size_t pos,
 	return net_pkt_copy(to, from, len);
 }
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+static bool tcp_cc_in_recovery(struct tcp *conn)
+{
+	return net_tcp_seq_cmp(conn->seq, conn->recover) < 0;
+}
+
+static void tcp_cc_init(struct tcp *conn)
+{
+	conn->recover = conn->seq;
+	conn->cc->init(conn);
+
+	NET_DBG("conn: %p cc %s cwnd %u", conn, conn->cc->name, conn->cwnd);
+}
+
+static void tcp_cc_ack(struct tcp *conn, uint32_t acked)
+{
+	/* Partial ACKs during the recovery do not grow the window,
+	 * RFC 6582 ch 3.2.
+	 */
+	if (tcp_cc_in_recovery(conn)) {
+		return;
+	}
+
+	conn->cc->on_ack(conn, acked);
+}
+
+/* Called with the data in flight still accounted in conn->unacked_len */
+static void tcp_cc_loss(struct tcp *conn, enum tcp_cc_loss type)
+{
+	if (type == TCP_CC_LOSS_DUPACK && tcp_cc_in_recovery(conn)) {
+		return;
+	}
+
+	conn->recover = conn->seq + conn->unacked_len;
+	conn->cc->on_loss(conn, type);
+}
+
+/* The usable window is the smaller of the peer's receive window and the
+ * congestion window. The congestion window is zero until the connection
+ * is established.
+ */
+static uint32_t tcp_send_window(struct tcp *conn)
+{
+	if (conn->cwnd) {
+		return MIN(conn->send_win, conn->cwnd);
+	}
+
+	return conn->send_win;
+}
+#else
+#define tcp_cc_init(...)
+#define tcp_cc_ack(...)
+#define tcp_cc_loss(...)
+#define tcp_send_window(_conn) ((_conn)->send_win)
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
+
 static bool tcp_window_full(struct tcp *conn)
 {
-	bool window_full = !(conn->unacked_len < conn->send_win);
+	bool window_full = !(conn->unacked_len < tcp_send_window(conn));
 
 	NET_DBG("conn: %p window_full=%hu", conn, window_full);
 
@@ -896,6 +1360,16 @@ static int tcp_unsent_len(struct tcp *conn)
 	return unsent_len;
 }
 
+/* The window can shrink below the data in flight, when the congestion
+ * window is reduced on a loss or when the peer shrinks its receive window.
+ */
+static uint32_t tcp_usable_window(struct tcp *conn)
+{
+	uint32_t window = tcp_send_window(conn);
+
+	return window > conn->unacked_len ? window - conn->unacked_len : 0;
+}
+
 static int tcp_send_data(struct tcp *conn)
 {
 	int ret = 0;
@@ -904,9 +1378,22 @@ static int tcp_send_data(struct tcp *conn)
 
 	pos = conn->unacked_len;
 	len = MIN3(conn->send_data_total - conn->unacked_len,
-		   conn->send_win - conn->unacked_len,
+		   tcp_usable_window(conn),
 		   conn_mss(conn));
 
+#if defined(CONFIG_NET_TCP_SACK)
+	if (conn->sack_count) {
+		int sacked = tcp_sack_skip(conn, conn->seq + pos, &len);
+
+		if (sacked) {
+			NET_DBG("conn: %p skipping %d SACKed bytes", conn,
+				sacked);
+			conn->unacked_len += sacked;
+			goto out;
+		}
+	}
+#endif
+
 	pkt = tcp_pkt_alloc(conn, len);
 	if (!pkt) {
 		NET_ERR("conn: %p packet allocation failed, len=%d", conn, len);
@@ -988,7 +1475,8 @@ static int tcp_send_queued_data(struct tcp *conn)
 
 	if (subscribe) {
 		conn->send_data_retries = 0;
-		k_delayed_work_submit(&conn->send_data_timer, K_MSEC(tcp_rto));
+		k_delayed_work_submit(&conn->send_data_timer,
+				      K_MSEC(conn_rto(conn)));
 	}
  out:
 	return ret;
@@ -1026,9 +1514,21 @@ static void tcp_resend_data(struct k_work *work)
 		goto out;
 	}
 
+	/* Only the first expiry is a new loss event, RFC 5681 ch 3.1 */
+	if (conn->send_data_retries == 0) {
+		tcp_cc_loss(conn, TCP_CC_LOSS_TIMEOUT);
+	}
+
 	conn->data_mode = TCP_DATA_MODE_RESEND;
 	conn->unacked_len = 0;
 
+#if defined(CONFIG_NET_TCP_SACK)
+	/* The receiver is allowed to discard SACKed data so do not trust
+	 * the scoreboard after a timeout, RFC 2018 ch 8.
+	 */
+	conn->sack_count = 0U;
+#endif
+
 	ret = tcp_send_data(conn);
 	if (ret == 0) {
 		conn->send_data_retries++;
@@ -1051,7 +1551,7 @@ static void tcp_resend_data(struct k_work *work)
 		}
 	}
 
-	k_delayed_work_submit(&conn->send_data_timer, K_MSEC(tcp_rto));
+	k_delayed_work_submit(&conn->send_data_timer, K_MSEC(conn_rto(conn)));
 
  out:
 	k_mutex_unlock(&conn->lock);
@@ -1061,6 +1561,26 @@ static void tcp_resend_data(struct k_work *work)
 	}
 }
 
+/* Resend the first unacknowledged segment without waiting for the
+ * retransmission timer. Used when SACK is negotiated as the peer then
+ * tells us exactly which data is missing, or when congestion control
+ * is enabled.
+ */
+static void tcp_fast_retransmit(struct tcp *conn)
+{
+	NET_DBG("conn: %p fast retransmit seq %u", conn, conn->seq);
+
+	tcp_cc_loss(conn, TCP_CC_LOSS_DUPACK);
+
+	conn->data_mode = TCP_DATA_MODE_RESEND;
+	conn->unacked_len = 0;
+
+	if (tcp_send_data(conn) == 0) {
+		k_delayed_work_submit(&conn->send_data_timer,
+				      K_MSEC(conn_rto(conn)));
+	}
+}
+
 static void tcp_timewait_timeout(struct k_work *work)
 {
 	struct tcp *conn = CONTAINER_OF(work, struct tcp, timewait_timer);
@@ -1102,6 +1622,33 @@ static void tcp_conn_ref(struct tcp *conn)
 	NET_DBG("conn: %p, ref_count: %d", conn, ref_count);
 }
 
+/* Smallest scale that fits the receive window into the header field */
+static void tcp_recv_wscale_init(struct tcp *conn)
+{
+	conn->rcv_wscale = 0U;
+
+	if (IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE)) {
+		while (conn->rcv_wscale < TCP_MAX_WINDOW_SHIFT &&
+		       (conn->recv_win >> conn->rcv_wscale) > UINT16_MAX) {
+			conn->rcv_wscale++;
+		}
+	}
+}
+
+/* Upper bound of the receive window, data up to it is accepted even if
+ * the advertised window has shrunk since the peer sent it.
+ */
+static uint32_t tcp_recv_win_max(struct tcp *conn)
+{
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	if (conn->context && conn->context->options.rcvbuf) {
+		return conn->context->options.rcvbuf;
+	}
+#endif
+
+	return tcp_window;
+}
+
 static struct tcp *tcp_conn_alloc(void)
 {
 	struct tcp *conn = NULL;
@@ -1137,6 +1684,13 @@ static struct tcp *tcp_conn_alloc(void)
 	conn->in_connect = false;
 	conn->state = TCP_LISTEN;
 	conn->recv_win = tcp_window;
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	conn->cc = tcp_cc_default();
+#endif
+
+	tcp_recv_wscale_init(conn);
+
 	conn->seq = (IS_ENABLED(CONFIG_NET_TEST_PROTOCOL) ||
 		     IS_ENABLED(CONFIG_NET_TEST)) ? 0 : sys_rand32_get();
 
@@ -1182,6 +1736,10 @@ int net_tcp_get(struct net_context *context)
 	/* Mutually link the net_context and tcp connection */
 	conn->context = context;
 	context->tcp = conn;
+
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	context->options.rcvbuf = tcp_window;
+#endif
 out:
 	k_mutex_unlock(&tcp_lock);
 
@@ -1256,6 +1814,27 @@ static enum net_verdict tcp_recv(struct net_conn *net_conn,
 		net_ipaddr_copy(&conn_old->context->remote, &conn->dst.sa);
 
 		conn->accepted_conn = conn_old;
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+		/* Accepted connections inherit the algorithm of the
+		 * listening socket.
+		 */
+		conn->cc = conn_old->cc;
+#endif
+
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+		/* The buffer sizes of the listening socket too, the SYN-ACK
+		 * is not sent yet so the window scale can still change.
+		 */
+		conn->context->options.rcvbuf =
+			conn_old->context->options.rcvbuf;
+		conn->recv_win = conn->context->options.rcvbuf;
+		tcp_recv_wscale_init(conn);
+#endif
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+		conn->context->options.sndbuf =
+			conn_old->context->options.sndbuf;
+#endif
 	}
  in:
 	if (conn) {
@@ -1365,7 +1944,8 @@ err:
 static bool tcp_validate_seq(struct tcp *conn, struct tcphdr *hdr)
 {
 	return (net_tcp_seq_cmp(th_seq(hdr), conn->ack) >= 0) &&
-		(net_tcp_seq_cmp(th_seq(hdr), conn->ack + conn->recv_win) < 0);
+		(net_tcp_seq_cmp(th_seq(hdr),
+				 conn->ack + tcp_recv_win_max(conn)) < 0);
 }
 
 static void print_seq_list(struct net_buf *buf)
@@ -1408,30 +1988,36 @@ static void tcp_queue_recv_data(struct tcp *conn, struct net_pkt *pkt,
 		print_seq_list(pkt->buffer);
 	}
 
-	if (!net_pkt_is_empty(conn->queue_recv_data)) {
-		/* Place the data to correct place in the list. If the data
-		 * would not be sequential, then drop this packet.
+	if (net_tcp_seq_cmp(seq, conn->ack + tcp_recv_win_max(conn)) > 0) {
+		NET_DBG("Data outside of receive window, dropping");
+	} else if (!net_pkt_is_empty(conn->queue_recv_data)) {
+		/* Place the data to correct place in the list, the list is
+		 * kept ordered by sequence number. There can be holes
+		 * between the queued blocks, those are reported to peer in
+		 * SACK option. If the data would overlap already queued
+		 * data, then drop this packet.
 		 */
-		uint32_t pending_seq;
+		struct net_buf *prev = NULL;
+		struct net_buf *cur = conn->queue_recv_data->buffer;
 
-		pending_seq = tcp_get_seq(conn->queue_recv_data->buffer);
-		if (pending_seq == seq) {
-			/* Put new data before the pending data */
-			net_buf_frag_add(pkt->buffer,
-					 conn->queue_recv_data->buffer);
-			conn->queue_recv_data->buffer = pkt->buffer;
-			inserted = true;
-		} else {
-			struct net_buf *last;
+		while (cur && net_tcp_seq_cmp(tcp_get_seq(cur),
+					      seq_start) < 0) {
+			prev = cur;
+			cur = cur->frags;
+		}
 
-			last = net_buf_frag_last(conn->queue_recv_data->buffer);
-			pending_seq = tcp_get_seq(last);
+		if ((!prev || net_tcp_seq_cmp(tcp_get_seq(prev) + prev->len,
+					      seq_start) <= 0) &&
+		    (!cur || net_tcp_seq_cmp(seq, tcp_get_seq(cur)) <= 0)) {
+			net_buf_frag_last(pkt->buffer)->frags = cur;
 
-			if ((pending_seq + last->len) == seq_start) {
-				/* Put new data after pending data */
-				last->frags = pkt->buffer;
-				inserted = true;
+			if (prev) {
+				prev->frags = pkt->buffer;
+			} else {
+				conn->queue_recv_data->buffer = pkt->buffer;
 			}
+
+			inserted = true;
 		}
 
 		if (IS_ENABLED(CONFIG_NET_TCP_LOG_LEVEL_DBG)) {
@@ -1487,6 +2073,13 @@ static void tcp_out_of_order_data(struct tcp *conn, struct net_pkt *pkt,
 	/* We received out-of-order data. Try to queue it.
 	 */
 	tcp_queue_recv_data(conn, pkt, data_len, seq);
+
+	/* Send a duplicate ACK right away so that the peer learns about
+	 * the hole from the SACK option.
+	 */
+	if (conn->sack_ok) {
+		tcp_out(conn, ACK);
+	}
 }
 
 /* TCP state machine, everything happens here */
@@ -1539,10 +2132,32 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		goto next_state;
 	}
 
+	if (th && !tcp_options_len) {
+		conn->recv_options.wnd_found = false;
+		conn->recv_options.sack_perm_found = false;
+		conn->recv_options.ts_found = false;
+		conn->recv_options.sack_count = 0U;
+	}
+
+	if (th && (th_flags(th) & SYN) &&
+	    (conn->state == TCP_LISTEN || conn->state == TCP_SYN_SENT)) {
+		tcp_options_negotiate(conn, tcp_options_len > 0);
+	}
+
+	if (th && !tcp_paws_check(conn, th)) {
+		NET_DBG("DROP: PAWS check failed");
+		net_stats_update_tcp_seg_drop(conn->iface);
+		tcp_out(conn, ACK);
+		k_mutex_unlock(&conn->lock);
+		return;
+	}
+
 	if (th) {
 		size_t max_win;
 
-		conn->send_win = ntohs(th_win(th));
+		/* Window field in SYN segments is never scaled */
+		conn->send_win = (uint32_t)ntohs(th_win(th)) <<
+			((th_flags(th) & SYN) ? 0 : conn->snd_wscale);
 
 #if defined(CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE)
 		if (CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE) {
@@ -1592,6 +2207,7 @@ next_state:
 				th_seq(th) == conn->ack)) {
 			k_delayed_work_cancel(&conn->establish_timer);
 			tcp_send_timer_cancel(conn);
+			tcp_cc_init(conn);
 			next = TCP_ESTABLISHED;
 			net_context_set_state(conn->context,
 					      NET_CONTEXT_CONNECTED);
@@ -1624,6 +2240,7 @@ next_state:
 		 */
 		if (FL(&fl, &, SYN | ACK, th && th_ack(th) == conn->seq)) {
 			tcp_send_timer_cancel(conn);
+			tcp_rtt_update(conn);
 			conn_ack(conn, th_seq(th) + 1);
 			if (len) {
 				if (tcp_data_get(conn, pkt, &len) < 0) {
@@ -1631,6 +2248,7 @@ next_state:
 				}
 				conn_ack(conn, + len);
 			}
+			tcp_cc_init(conn);
 			k_sem_give(&conn->connect_sem);
 			next = TCP_ESTABLISHED;
 			net_context_set_state(conn->context,
@@ -1670,6 +2288,12 @@ next_state:
 			break;
 		}
 
+#if defined(CONFIG_NET_TCP_SACK)
+		if (th && conn->sack_ok && conn->recv_options.sack_count) {
+			tcp_sack_scoreboard_add(conn);
+		}
+#endif
+
 		if (th && net_tcp_seq_cmp(th_ack(th), conn->seq) > 0) {
 			uint32_t len_acked = th_ack(th) - conn->seq;
 
@@ -1692,6 +2316,13 @@ next_state:
 			conn_seq(conn, + len_acked);
 			net_stats_update_tcp_seg_recv(conn->iface);
 
+			conn->dup_ack_cnt = 0U;
+			tcp_rtt_update(conn);
+			tcp_cc_ack(conn, len_acked);
+#if defined(CONFIG_NET_TCP_SACK)
+			tcp_sack_scoreboard_prune(conn);
+#endif
+
 			conn_send_data_dump(conn);
 
 			if (!k_delayed_work_remaining_get(&conn->send_data_timer)) {
@@ -1722,6 +2353,15 @@ next_state:
 				conn_state(conn, TCP_CLOSED);
 				break;
 			}
+		} else if (th && !len &&
+			   (conn->sack_ok ||
+			    IS_ENABLED(CONFIG_NET_TCP_CONGESTION_CONTROL)) &&
+			   (th_flags(th) & ACK) && th_ack(th) == conn->seq &&
+			   conn->unacked_len > 0) {
+			/* Duplicate ACK, the peer is missing data */
+			if (++conn->dup_ack_cnt == 3U) {
+				tcp_fast_retransmit(conn);
+			}
 		}
 
 		if (th && len) {
@@ -1864,7 +2504,7 @@ int net_tcp_put(struct net_context *context)
 			/* How long to wait until all the data has been sent?
 			 */
 			k_delayed_work_submit(&conn->send_data_timer,
-					      K_MSEC(tcp_rto));
+					      K_MSEC(conn_rto(conn)));
 		} else {
 			int ret;
 
@@ -1904,12 +2544,113 @@ int net_tcp_listen(struct net_context *context)
 
 int net_tcp_update_recv_wnd(struct net_context *context, int32_t delta)
 {
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	struct tcp *conn = context->tcp;
+	atomic_val_t used = atomic_get(&context->rcvbuf_used);
+	uint32_t rcvbuf, old_win;
+
+	ARG_UNUSED(delta);
+
+	if (!conn) {
+		return -EPROTOTYPE;
+	}
+
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	rcvbuf = tcp_recv_win_max(conn);
+
+	/* net_context has already accounted the delta, the window is
+	 * what is left of the receive buffer.
+	 */
+	old_win = conn->recv_win;
+	conn->recv_win = used <= 0 ? rcvbuf :
+		((uint32_t)used < rcvbuf ? rcvbuf - (uint32_t)used : 0U);
+
+	if (conn->state == TCP_LISTEN) {
+		tcp_recv_wscale_init(conn);
+	} else if (conn->state == TCP_ESTABLISHED &&
+		   old_win < conn_mss(conn) &&
+		   conn->recv_win >= conn_mss(conn)) {
+		/* The peer stopped sending because of a small window, tell
+		 * it that a full segment fits again, RFC 1122 ch 4.2.3.3
+		 */
+		tcp_out(conn, ACK);
+	}
+
+	k_mutex_unlock(&conn->lock);
+
+	return 0;
+#else
 	ARG_UNUSED(context);
 	ARG_UNUSED(delta);
 
 	return -EPROTONOSUPPORT;
+#endif
+}
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+int net_tcp_set_congestion(struct net_context *context, const char *name,
+			   size_t len)
+{
+	struct tcp *conn = context->tcp;
+	const struct tcp_cc_ops *cc;
+
+	if (!conn) {
+		return -EPROTOTYPE;
+	}
+
+	cc = tcp_cc_find(name, len);
+	if (!cc) {
+		return -ENOENT;
+	}
+
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	if (conn->cc != cc) {
+		conn->cc = cc;
+
+		/* If the connection is already running, only reset the
+		 * private state of the new algorithm: the windows describe
+		 * the path and stay valid, and an ongoing recovery goes on.
+		 */
+		if (conn->cwnd) {
+			uint32_t cwnd = conn->cwnd;
+			uint32_t ssthresh = conn->ssthresh;
+
+			cc->init(conn);
+
+			conn->cwnd = cwnd;
+			conn->ssthresh = ssthresh;
+		}
+	}
+
+	k_mutex_unlock(&conn->lock);
+
+	return 0;
 }
 
+int net_tcp_get_congestion(struct net_context *context, char *name,
+			   size_t *len)
+{
+	struct tcp *conn = context->tcp;
+	size_t name_len;
+
+	if (!conn) {
+		return -EPROTOTYPE;
+	}
+
+	name_len = strlen(conn->cc->name) + 1;
+	if (*len < name_len) {
+		return -EINVAL;
+	}
+
+	memcpy(name, conn->cc->name, name_len);
+	*len = name_len;
+
+	return 0;
+}
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
+
 /* net_context queues the outgoing data for the TCP connection */
 int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 {
@@ -1937,6 +2678,15 @@ int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 
 	len = net_pkt_get_len(pkt);
 
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+	if (context->options.sndbuf && conn->send_data_total > 0 &&
+	    conn->send_data_total + len > context->options.sndbuf) {
+		NET_DBG("conn: %p send buffer full", conn);
+		ret = -EAGAIN;
+		goto out;
+	}
+#endif
+
 	if (conn->send_data->buffer) {
 		orig_buf = net_buf_frag_last(conn->send_data->buffer);
 	}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <string.h>
+#include <zephyr.h>
+#include <net/net_pkt.h>
+#include <net/net_context.h>
+#include "net_private.h"
+#include "tcp2_priv.h"
+
+static const struct tcp_cc_ops *const tcp_cc_algorithms[] = {
+#if defined(CONFIG_NET_TCP_CC_NEWRENO)
+	&tcp_cc_newreno,
+#endif
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+	&tcp_cc_cubic,
+#endif
+};
+
+BUILD_ASSERT(ARRAY_SIZE(tcp_cc_algorithms) > 0,
+	     "No TCP congestion control algorithm enabled");
+
+const struct tcp_cc_ops *tcp_cc_find(const char *name, size_t len)
+{
+	int i;
+
+	/* Accept both a plain name and a NUL terminated string as the
+	 * length of the TCP_CONGESTION value varies between applications.
+	 */
+	len = strnlen(name, len);
+
+	for (i = 0; i < ARRAY_SIZE(tcp_cc_algorithms); i++) {
+		const char *cc_name = tcp_cc_algorithms[i]->name;
+
+		if (strlen(cc_name) == len && !strncmp(cc_name, name, len)) {
+			return tcp_cc_algorithms[i];
+		}
+	}
+
+	return NULL;
+}
+
+const struct tcp_cc_ops *tcp_cc_default(void)
+{
+	const struct tcp_cc_ops *cc;
+
+	cc = tcp_cc_find(CONFIG_NET_TCP_CC_DEFAULT,
+			 sizeof(CONFIG_NET_TCP_CC_DEFAULT));
+	if (!cc) {
+		cc = tcp_cc_algorithms[0];
+	}
+
+	return cc;
+}
+
+uint32_t tcp_cc_initial_window(struct tcp *conn)
+{
+	uint32_t mss = conn_mss(conn);
+
+	if (mss > 2190) {
+		return 2 * mss;
+	} else if (mss > 1095) {
+		return 3 * mss;
+	}
+
+	return 4 * mss;
+}
+
+uint32_t tcp_cc_loss_ssthresh(struct tcp *conn, uint32_t win,
+			      uint32_t tenths)
+{
+	return MAX(win / 10 * tenths, 2U * conn_mss(conn));
+}
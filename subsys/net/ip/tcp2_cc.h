@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief TCP congestion control
+ *
+ * - Each connection points to a struct tcp_cc_ops that owns the
+ *   congestion window (conn->cwnd) and slow start threshold
+ *   (conn->ssthresh) of the connection.
+ * - init() is called when the connection is established or when the
+ *   application selects another algorithm with TCP_CONGESTION. In the
+ *   latter case cwnd and ssthresh are restored after the call, only the
+ *   private state of the algorithm is reset.
+ * - on_ack() is called for every ACK that acknowledges new data
+ *   outside of loss recovery.
+ * - on_loss() is called once per loss event, either from the fast
+ *   retransmit path or from the retransmission timer.
+ */
+
+#ifndef TCP2_CC_H
+#define TCP2_CC_H
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct tcp;
+
+enum tcp_cc_loss {
+	TCP_CC_LOSS_DUPACK = 0,	/* Three duplicate ACKs received */
+	TCP_CC_LOSS_TIMEOUT,	/* Retransmission timer expired */
+};
+
+struct tcp_cc_ops {
+	const char *name;
+	void (*init)(struct tcp *conn);
+	void (*on_ack)(struct tcp *conn, uint32_t acked);
+	void (*on_loss)(struct tcp *conn, enum tcp_cc_loss type);
+};
+
+/* Private per connection state of the CUBIC algorithm, RFC 8312 */
+struct tcp_cc_cubic {
+	uint32_t w_max;		/* cwnd before the last reduction */
+	uint32_t origin;	/* cwnd the cubic function is centered on */
+	uint32_t w_est;		/* Reno friendly window estimate */
+	uint32_t k;		/* time to reach origin, in ms */
+	uint32_t epoch_start;	/* start of the congestion avoidance epoch */
+};
+
+union tcp_cc_priv {
+	struct tcp_cc_cubic cubic;
+};
+
+#if defined(CONFIG_NET_TCP_CC_NEWRENO)
+extern const struct tcp_cc_ops tcp_cc_newreno;
+#endif
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+extern const struct tcp_cc_ops tcp_cc_cubic;
+#endif
+
+/**
+ * @brief Find a congestion control algorithm by name
+ *
+ * @param name Name of the algorithm, does not need to be NUL terminated
+ * @param len Length of the name
+ *
+ * @return Algorithm or NULL if not found
+ */
+const struct tcp_cc_ops *tcp_cc_find(const char *name, size_t len);
+
+/**
+ * @brief Return the algorithm selected by CONFIG_NET_TCP_CC_DEFAULT
+ */
+const struct tcp_cc_ops *tcp_cc_default(void);
+
+/**
+ * @brief Initial congestion window as described in RFC 5681 ch 3.1
+ */
+uint32_t tcp_cc_initial_window(struct tcp *conn);
+
+/**
+ * @brief Slow start threshold after a loss, RFC 5681 ch 3.1 eq. 4
+ *
+ * @param conn TCP connection
+ * @param win Window the reduction is applied to
+ * @param tenths Multiplicative decrease factor, in tenths
+ *
+ * @return max(win * tenths / 10, 2 * SMSS)
+ */
+uint32_t tcp_cc_loss_ssthresh(struct tcp *conn, uint32_t win,
+			      uint32_t tenths);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TCP2_CC_H */
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* CUBIC congestion control, RFC 8312. The window grows as a cubic
+ * function of the time since the last loss, which makes it independent
+ * of the RTT and lets it fill long fat pipes faster than NewReno.
+ *
+ * All the calculations are done in integer arithmetic, the constants
+ * are C = 0.4 segments / s^3 and beta = 0.7. Time is in milliseconds.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <string.h>
+#include <zephyr.h>
+#include <net/net_pkt.h>
+#include <net/net_context.h>
+#include "net_private.h"
+#include "tcp2_priv.h"
+
+#define CUBIC_BETA_TENTHS 7
+
+/* Limit for |t - K| so that the cube fits into 64 bits, about 17 min */
+#define CUBIC_MAX_DELTA_MS (1 << 20)
+
+static uint32_t cubic_cbrt(uint64_t x)
+{
+	uint64_t y = 0;
+	int s;
+
+	for (s = 63; s >= 0; s -= 3) {
+		uint64_t b;
+
+		y <<= 1;
+		b = 3 * y * (y + 1) + 1;
+
+		if ((x >> s) >= b) {
+			x -= b << s;
+			y++;
+		}
+	}
+
+	return (uint32_t)y;
+}
+
+static uint32_t cubic_rtt(struct tcp *conn)
+{
+#if defined(CONFIG_NET_TCP_TIMESTAMPS)
+	if (conn->rto) {
+		return conn->srtt >> 3;
+	}
+#endif
+	return 0;
+}
+
+static void cubic_epoch_start(struct tcp *conn, uint32_t now)
+{
+	struct tcp_cc_cubic *c = &conn->cc_priv.cubic;
+	uint32_t mss = conn_mss(conn);
+
+	c->epoch_start = now ? now : 1;
+	c->w_est = conn->cwnd;
+
+	if (conn->cwnd < c->w_max) {
+		/* K = cbrt((W_max - cwnd) / C), RFC 8312 eq. 2, in ms */
+		c->k = cubic_cbrt((uint64_t)(c->w_max - conn->cwnd) *
+				  2500000000ULL / mss);
+		c->origin = c->w_max;
+	} else {
+		c->k = 0U;
+		c->origin = conn->cwnd;
+	}
+}
+
+/* W_cubic(t) = C * (t - K)^3 + W_max, RFC 8312 eq. 1, in bytes */
+static uint32_t cubic_window(struct tcp *conn, uint32_t t)
+{
+	struct tcp_cc_cubic *c = &conn->cc_priv.cubic;
+	int64_t delta = (int64_t)t - c->k;
+	int64_t target;
+
+	delta = CLAMP(delta, -CUBIC_MAX_DELTA_MS, CUBIC_MAX_DELTA_MS);
+
+	/* 0.4 * d^3 / 10^9 segments, computed in hundredths of a segment */
+	target = 4 * delta * delta * delta / 100000000LL;
+	target = (int64_t)c->origin + target * conn_mss(conn) / 100;
+
+	return (uint32_t)CLAMP(target, 0, (int64_t)UINT32_MAX);
+}
+
+static void cubic_init(struct tcp *conn)
+{
+	memset(&conn->cc_priv.cubic, 0, sizeof(conn->cc_priv.cubic));
+
+	conn->cwnd = tcp_cc_initial_window(conn);
+	conn->ssthresh = UINT32_MAX;
+}
+
+static void cubic_on_ack(struct tcp *conn, uint32_t acked)
+{
+	struct tcp_cc_cubic *c = &conn->cc_priv.cubic;
+	uint32_t mss = conn_mss(conn);
+	uint32_t now = k_uptime_get_32();
+	uint32_t target;
+
+	if (conn->cwnd < conn->ssthresh) {
+		conn->cwnd += MIN(acked, mss);
+		return;
+	}
+
+	if (!c->epoch_start) {
+		cubic_epoch_start(conn, now);
+	}
+
+	/* Aim at the window one RTT ahead, RFC 8312 ch 4.1 */
+	target = cubic_window(conn, now - c->epoch_start + cubic_rtt(conn));
+
+	/* Reno friendly region, RFC 8312 ch 4.2 eq. 4:
+	 * W_est += 3 * (1 - beta) / (1 + beta) * acked / cwnd
+	 */
+	c->w_est += (uint32_t)((uint64_t)acked * mss * 9U /
+			       (17U * (uint64_t)conn->cwnd));
+	target = MAX(target, c->w_est);
+
+	/* Never grow by more than half of the window per RTT */
+	target = MIN(target, conn->cwnd + conn->cwnd / 2);
+
+	if (target > conn->cwnd) {
+		conn->cwnd += MAX(1U, (uint32_t)((uint64_t)(target - conn->cwnd)
+						 * acked / conn->cwnd));
+	}
+}
+
+static void cubic_on_loss(struct tcp *conn, enum tcp_cc_loss type)
+{
+	struct tcp_cc_cubic *c = &conn->cc_priv.cubic;
+
+	c->epoch_start = 0U;
+
+	/* Fast convergence, RFC 8312 ch 4.6 */
+	if (conn->cwnd < c->w_max) {
+		c->w_max = conn->cwnd / 20 * 17;
+	} else {
+		c->w_max = conn->cwnd;
+	}
+
+	conn->ssthresh = tcp_cc_loss_ssthresh(conn, conn->cwnd,
+					      CUBIC_BETA_TENTHS);
+
+	if (type == TCP_CC_LOSS_TIMEOUT) {
+		conn->cwnd = conn_mss(conn);
+	} else {
+		conn->cwnd = conn->ssthresh;
+	}
+
+	NET_DBG("conn: %p cwnd %u ssthresh %u w_max %u", conn, conn->cwnd,
+		conn->ssthresh, c->w_max);
+}
+
+const struct tcp_cc_ops tcp_cc_cubic = {
+	.name = "cubic",
+	.init = cubic_init,
+	.on_ack = cubic_on_ack,
+	.on_loss = cubic_on_loss,
+};
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* NewReno congestion control, RFC 5681 and RFC 6582. The recovery point
+ * that prevents multiple window reductions per loss event is tracked by
+ * the TCP core in conn->recover.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <net/net_pkt.h>
+#include <net/net_context.h>
+#include "net_private.h"
+#include "tcp2_priv.h"
+
+static void newreno_init(struct tcp *conn)
+{
+	conn->cwnd = tcp_cc_initial_window(conn);
+	conn->ssthresh = UINT32_MAX;
+}
+
+static void newreno_on_ack(struct tcp *conn, uint32_t acked)
+{
+	uint32_t mss = conn_mss(conn);
+
+	if (conn->cwnd < conn->ssthresh) {
+		/* Slow start, RFC 5681 ch 3.1 eq. 2 */
+		conn->cwnd += MIN(acked, mss);
+	} else {
+		/* Congestion avoidance, RFC 5681 ch 3.1 eq. 3 */
+		conn->cwnd += MAX(1U, mss * mss / conn->cwnd);
+	}
+}
+
+static void newreno_on_loss(struct tcp *conn, enum tcp_cc_loss type)
+{
+	conn->ssthresh = tcp_cc_loss_ssthresh(conn, conn->unacked_len, 5);
+
+	if (type == TCP_CC_LOSS_TIMEOUT) {
+		/* Loss window, RFC 5681 ch 3.1 */
+		conn->cwnd = conn_mss(conn);
+	} else {
+		conn->cwnd = conn->ssthresh;
+	}
+
+	NET_DBG("conn: %p cwnd %u ssthresh %u", conn, conn->cwnd,
+		conn->ssthresh);
+}
+
+const struct tcp_cc_ops tcp_cc_newreno = {
+	.name = "newreno",
+	.init = newreno_init,
+	.on_ack = newreno_on_ack,
+	.on_loss = newreno_on_loss,
+};
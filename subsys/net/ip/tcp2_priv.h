@@ -5,6 +5,7 @@
  */
 
 #include "tp.h"
+#include "tcp2_cc.h"
 
 #define is(_a, _b) (strcmp((_a), (_b)) == 0)
 
@@ -125,7 +126,7 @@
 #define conn_send_data_dump(_conn)					\
 ({									\
 	NET_DBG("conn: %p total=%zd, unacked_len=%d, "			\
-		"send_win=%hu, mss=%hu",				\
+		"send_win=%u, mss=%hu",					\
 		(_conn), net_pkt_get_len((_conn)->send_data),		\
 		conn->unacked_len, conn->send_win,			\
 		(uint16_t)conn_mss((_conn)));				\
@@ -139,6 +140,28 @@
 #define TCPOPT_NOP	1
 #define TCPOPT_MAXSEG	2
 #define TCPOPT_WINDOW	3
+#define TCPOPT_SACK_PERM	4
+#define TCPOPT_SACK	5
+#define TCPOPT_TIMESTAMP	8
+
+#define TCPOLEN_MAXSEG		4
+#define TCPOLEN_WINDOW		3
+#define TCPOLEN_SACK_PERM	2
+#define TCPOLEN_SACK_BLOCK	8
+#define TCPOLEN_TIMESTAMP	10
+
+/* Largest window shift allowed by RFC 7323 ch. 2.3 */
+#define TCP_MAX_WINDOW_SHIFT	14
+
+/* Number of SACK blocks that fit into the options space together with
+ * the timestamp option (RFC 2018 ch. 3).
+ */
+#define TCP_SACK_MAX_BLOCKS	3
+
+#define TCP_RTO_MIN_MS		100
+#define TCP_RTO_MAX_MS		60000
+
+#define conn_rto(_conn) ((_conn)->rto ? (_conn)->rto : tcp_rto)
 
 enum pkt_addr {
 	TCP_EP_SRC = 1,
@@ -200,11 +223,22 @@ union tcp_endpoint {
 	struct sockaddr_in6 sin6;
 };
 
+struct tcp_sack_block {
+	uint32_t start;
+	uint32_t end;
+};
+
 struct tcp_options {
 	uint16_t mss;
 	uint16_t window;
+	uint32_t tsval;
+	uint32_t tsecr;
+	struct tcp_sack_block sack[TCP_SACK_MAX_BLOCKS + 1];
+	uint8_t sack_count;
 	bool mss_found : 1;
 	bool wnd_found : 1;
+	bool sack_perm_found : 1;
+	bool ts_found : 1;
 };
 
 struct tcp { /* TCP connection */
@@ -245,12 +279,36 @@ struct tcp { /* TCP connection */
 	enum tcp_data_mode data_mode;
 	uint32_t seq;
 	uint32_t ack;
-	uint16_t recv_win;
-	uint16_t send_win;
+	uint32_t recv_win;
+	uint32_t send_win;
+#if defined(CONFIG_NET_TCP_TIMESTAMPS)
+	uint32_t ts_recent; /* latest peer TSval to echo back */
+	int32_t srtt; /* smoothed RTT, RFC 6298, in ms << 3 */
+	int32_t rttvar; /* RTT variance, in ms << 2 */
+#endif
+#if defined(CONFIG_NET_TCP_SACK)
+	/* Blocks the peer has told us it holds beyond conn->seq */
+	struct tcp_sack_block sack_scoreboard[TCP_SACK_MAX_BLOCKS + 1];
+	uint8_t sack_count;
+#endif
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	const struct tcp_cc_ops *cc;
+	union tcp_cc_priv cc_priv;
+	uint32_t cwnd;
+	uint32_t ssthresh;
+	uint32_t recover; /* end of the loss recovery, RFC 6582 */
+#endif
+	int rto;
 	uint8_t send_data_retries;
+	uint8_t snd_wscale; /* shift applied to windows received from peer */
+	uint8_t rcv_wscale; /* shift applied to windows we advertise */
+	uint8_t dup_ack_cnt;
 	bool in_retransmission : 1;
 	bool in_connect : 1;
 	bool in_close : 1;
+	bool wscale_ok : 1;
+	bool sack_ok : 1;
+	bool ts_ok : 1;
 };
 
 #define _flags(_fl, _op, _mask, _cond)					\
@@ -850,6 +850,58 @@ static inline int net_tcp_put(struct net_context *context)
 }
 #endif
 
+/**
+ * @brief Select the congestion control algorithm of a TCP connection
+ *
+ * @param context Network context
+ * @param name Name of the algorithm, for example "newreno" or "cubic"
+ * @param len Length of the name
+ *
+ * @return 0 on success, -EPROTOTYPE if there is no TCP context, -ENOENT
+ *         if the algorithm is not available, -ENOTSUP if congestion
+ *         control is not enabled
+ */
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+int net_tcp_set_congestion(struct net_context *context, const char *name,
+			   size_t len);
+#else
+static inline int net_tcp_set_congestion(struct net_context *context,
+					 const char *name, size_t len)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(name);
+	ARG_UNUSED(len);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Get the name of the congestion control algorithm in use
+ *
+ * @param context Network context
+ * @param name Buffer for the NUL terminated name
+ * @param len Size of the buffer, updated to the length of the name
+ *
+ * @return 0 on success, -EPROTOTYPE if there is no TCP context, -EINVAL
+ *         if the buffer is too small, -ENOTSUP if congestion control is
+ *         not enabled
+ */
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+int net_tcp_get_congestion(struct net_context *context, char *name,
+			   size_t *len);
+#else
+static inline int net_tcp_get_congestion(struct net_context *context,
+					 char *name, size_t *len)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(name);
+	ARG_UNUSED(len);
+
+	return -ENOTSUP;
+}
+#endif
+
 #define NET_TCP_MAX_OPT_SIZE  8
 
 #if defined(CONFIG_NET_NATIVE_TCP)
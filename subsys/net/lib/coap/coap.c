@@ -753,9 +753,8 @@ const uint8_t *coap_packet_get_payload(const struct coap_packet *cpkt, uint16_t
 		cpkt->data + cpkt->hdr_len + cpkt->opt_len;
 }
 
-static bool uri_path_eq(const struct coap_packet *cpkt,
-			const char * const *path,
-			struct coap_option *options,
+static bool uri_path_eq(const char * const *path,
+			const struct coap_option *options,
 			uint8_t opt_num)
 {
 	uint8_t i;
@@ -825,6 +824,22 @@ static bool is_request(const struct coap_packet *cpkt)
 	return !(code & ~COAP_REQUEST_MASK);
 }
 
+static int handle_resource(struct coap_resource *resource,
+			   struct coap_packet *cpkt,
+			   struct sockaddr *addr, socklen_t addr_len)
+{
+	coap_method_t method;
+	uint8_t code;
+
+	code = coap_header_get_code(cpkt);
+	method = method_from_code(resource, code);
+	if (!method) {
+		return -EPERM;
+	}
+
+	return method(resource, cpkt, addr, addr_len);
+}
+
 int coap_handle_request(struct coap_packet *cpkt,
 			struct coap_resource *resources,
 			struct coap_option *options,
@@ -839,26 +854,155 @@ int coap_handle_request(struct coap_packet *cpkt,
 
 	/* FIXME: deal with hierarchical resources */
 	for (resource = resources; resource && resource->path; resource++) {
-		coap_method_t method;
-		uint8_t code;
-
-		if (!uri_path_eq(cpkt, resource->path, options, opt_num)) {
+		if (!uri_path_eq(resource->path, options, opt_num)) {
 			continue;
 		}
 
-		code = coap_header_get_code(cpkt);
-		method = method_from_code(resource, code);
-		if (!method) {
-			return -EPERM;
-		}
-
-		return method(resource, cpkt, addr, addr_len);
+		return handle_resource(resource, cpkt, addr, addr_len);
 	}
 
 	NET_DBG("%d", __LINE__);
 	return -ENOENT;
 }
 
+#if defined(CONFIG_COAP_RESOURCE_INDEX)
+#define PATH_HASH_INIT 2166136261U
+
+static uint32_t path_hash_segment(uint32_t hash, const uint8_t *segment,
+				  uint16_t len)
+{
+	/* The separator keeps "a/bc" and "ab/c" apart */
+	hash = (hash ^ '/') * 16777619U;
+
+	while (len--) {
+		hash = (hash ^ *segment++) * 16777619U;
+	}
+
+	return hash;
+}
+
+static bool path_has_wildcard(const char * const *path)
+{
+	if (!IS_ENABLED(CONFIG_COAP_URI_WILDCARD)) {
+		return false;
+	}
+
+	for (; *path; path++) {
+		if (!strcmp(*path, "+") || !strcmp(*path, "#")) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int coap_resource_index_init(struct coap_resource_index *index,
+			     struct coap_resource *resources)
+{
+	struct coap_resource *resource;
+	const char * const *p;
+	int count = 0;
+
+	if (!index || !resources) {
+		return -EINVAL;
+	}
+
+	(void)memset(index, 0, sizeof(*index));
+	index->resources = resources;
+
+	for (resource = resources; resource->path; resource++) {
+		count++;
+	}
+
+	/* Insert from the end so that the chains keep the order of the
+	 * array, which decides between several matching paths.
+	 */
+	while (count--) {
+		struct coap_resource **head;
+
+		resource = &resources[count];
+		resource->link_len = 0U;
+
+		if (path_has_wildcard(resource->path)) {
+			head = &index->wildcards;
+		} else {
+			resource->path_hash = PATH_HASH_INIT;
+
+			for (p = resource->path; *p; p++) {
+				resource->path_hash = path_hash_segment(
+					resource->path_hash,
+					(const uint8_t *)*p, strlen(*p));
+			}
+
+			head = &index->buckets[resource->path_hash %
+					       ARRAY_SIZE(index->buckets)];
+		}
+
+		resource->index_next = *head;
+		*head = resource;
+	}
+
+	return 0;
+}
+
+struct coap_resource *coap_resource_index_find(
+	const struct coap_resource_index *index,
+	const struct coap_option *options, uint8_t opt_num)
+{
+	struct coap_resource *found = NULL;
+	struct coap_resource *resource;
+	uint32_t hash = PATH_HASH_INIT;
+	uint8_t i;
+
+	for (i = 0U; i < opt_num; i++) {
+		if (options[i].delta == COAP_OPTION_URI_PATH) {
+			hash = path_hash_segment(hash, options[i].value,
+						 options[i].len);
+		}
+	}
+
+	for (resource = index->buckets[hash % ARRAY_SIZE(index->buckets)];
+	     resource; resource = resource->index_next) {
+		if (resource->path_hash == hash &&
+		    uri_path_eq(resource->path, options, opt_num)) {
+			found = resource;
+			break;
+		}
+	}
+
+	/* A wildcard resource wins if it comes first in the array */
+	for (resource = index->wildcards;
+	     resource && (!found || resource < found);
+	     resource = resource->index_next) {
+		if (uri_path_eq(resource->path, options, opt_num)) {
+			return resource;
+		}
+	}
+
+	return found;
+}
+
+int coap_handle_request_index(struct coap_packet *cpkt,
+			      const struct coap_resource_index *index,
+			      struct coap_option *options,
+			      uint8_t opt_num,
+			      struct sockaddr *addr, socklen_t addr_len)
+{
+	struct coap_resource *resource;
+
+	if (!is_request(cpkt)) {
+		return 0;
+	}
+
+	resource = coap_resource_index_find(index, options, opt_num);
+	if (!resource) {
+		return -ENOENT;
+	}
+
+	return handle_resource(resource, cpkt, addr, addr_len);
+}
+#endif /* CONFIG_COAP_RESOURCE_INDEX */
+
 int coap_block_transfer_init(struct coap_block_context *ctx,
 			      enum coap_block_size block_size,
 			      size_t total_size)
@@ -1383,6 +1527,13 @@ bool coap_register_observer(struct coap_resource *resource,
 		resource->age = 2;
 	}
 
+#if defined(CONFIG_COAP_OBSERVE_ENGINE)
+	observer->con = false;
+	observer->age = resource->age;
+	observer->last_tx = k_uptime_get_32();
+	observer->last_con = observer->last_tx;
+#endif
+
 	return first;
 }
 
@@ -1445,6 +1596,275 @@ struct coap_observer *coap_find_observer_by_addr(
 	return NULL;
 }
 
+#if defined(CONFIG_COAP_OBSERVE_ENGINE)
+/* Observe sequence numbers are 24 bits, RFC 7641 section 3.4 */
+#define OBSERVE_SEQ_MAX 0xFFFFFF
+
+static inline bool time_reached(uint32_t now, uint32_t time)
+{
+	return (int32_t)(now - time) >= 0;
+}
+
+static int32_t observe_next_due(int32_t next, uint32_t now, uint32_t due)
+{
+	int32_t remaining = due - now;
+
+	if (next == SYS_FOREVER_MS || remaining < next) {
+		return remaining;
+	}
+
+	return next;
+}
+
+int coap_observe_engine_init(struct coap_observe_engine *engine,
+			     struct coap_resource *resources,
+			     uint8_t *buf, uint16_t buf_len,
+			     coap_observe_encode_t encode,
+			     coap_observe_send_t send, void *user_data)
+{
+	if (!engine || !resources || !buf || buf_len <= BASIC_HEADER_SIZE ||
+	    !encode || !send) {
+		return -EINVAL;
+	}
+
+	memset(engine, 0, sizeof(*engine));
+
+	engine->resources = resources;
+	engine->buf = buf;
+	engine->buf_len = buf_len;
+	engine->encode = encode;
+	engine->send = send;
+	engine->user_data = user_data;
+	engine->min_interval_ms = CONFIG_COAP_OBSERVE_MIN_INTERVAL_MS;
+	engine->con_interval_ms = CONFIG_COAP_OBSERVE_CON_INTERVAL *
+				  MSEC_PER_SEC;
+
+	return 0;
+}
+
+void coap_observe_engine_notify(struct coap_observe_engine *engine,
+				struct coap_resource *resource)
+{
+	/* Wrapping to 2 keeps the sequence increasing for the observers,
+	 * which compare 24 bit serial numbers, and 0 means no observer.
+	 */
+	if (++resource->age > OBSERVE_SEQ_MAX) {
+		resource->age = 2;
+	}
+
+	engine->changed = true;
+}
+
+/* The part of a notification following the header and token is the same
+ * for every observer, so it is encoded once per batch.
+ */
+static int observe_encode(struct coap_observe_engine *engine,
+			  struct coap_resource *resource,
+			  struct coap_packet *cpkt)
+{
+	int r;
+
+	r = coap_packet_init(cpkt, engine->buf, engine->buf_len, COAP_VERSION,
+			     COAP_TYPE_NON_CON, 0, NULL,
+			     COAP_RESPONSE_CODE_CONTENT, 0);
+	if (r < 0) {
+		return r;
+	}
+
+	r = coap_append_option_int(cpkt, COAP_OPTION_OBSERVE, resource->age);
+	if (r < 0) {
+		return r;
+	}
+
+	return engine->encode(resource, cpkt, engine->user_data);
+}
+
+static int observe_send(struct coap_observe_engine *engine,
+			struct coap_observer *observer,
+			const struct coap_packet *cpkt, bool con)
+{
+	uint8_t hdr[BASIC_HEADER_SIZE];
+	struct msghdr msg = { 0 };
+	struct iovec iov[3];
+
+	hdr[0] = COAP_VERSION << 6;
+	hdr[0] |= (con ? COAP_TYPE_CON : COAP_TYPE_NON_CON) << 4;
+	hdr[0] |= observer->tkl & 0xF;
+	hdr[1] = cpkt->data[1];
+	sys_put_be16(observer->id, &hdr[2]);
+
+	iov[0].iov_base = hdr;
+	iov[0].iov_len = sizeof(hdr);
+	iov[1].iov_base = observer->token;
+	iov[1].iov_len = observer->tkl;
+	iov[2].iov_base = cpkt->data + BASIC_HEADER_SIZE;
+	iov[2].iov_len = cpkt->offset - BASIC_HEADER_SIZE;
+
+	msg.msg_name = &observer->addr;
+	msg.msg_namelen = observer->addr.sa_family == AF_INET6 ?
+			  sizeof(struct sockaddr_in6) :
+			  sizeof(struct sockaddr_in);
+	msg.msg_iov = iov;
+	msg.msg_iovlen = ARRAY_SIZE(iov);
+
+	return engine->send(observer, &msg, engine->user_data);
+}
+
+int32_t coap_observe_engine_process(struct coap_observe_engine *engine)
+{
+	uint32_t now = k_uptime_get_32();
+	int32_t next = SYS_FOREVER_MS;
+	struct coap_resource *resource;
+
+	/* Nothing to do until the next timer without a new update */
+	if (!engine->changed) {
+		if (!engine->scheduled) {
+			return SYS_FOREVER_MS;
+		}
+
+		if (!time_reached(now, engine->next_due)) {
+			return engine->next_due - now;
+		}
+	}
+
+	engine->changed = false;
+
+	for (resource = engine->resources; resource->path; resource++) {
+		sys_snode_t *node, *tmp, *prev = NULL;
+		struct coap_packet cpkt;
+		bool encoded = false;
+
+		SYS_SLIST_FOR_EACH_NODE_SAFE(&resource->observers, node, tmp) {
+			struct coap_observer *o =
+				CONTAINER_OF(node, struct coap_observer, list);
+			uint32_t due;
+			bool new_id;
+			int r;
+
+			if (o->con) {
+				/* RFC 7641 section 4.5.2, the retransmission
+				 * carries the latest state.
+				 */
+				due = o->last_tx + o->timeout;
+				if (!time_reached(now, due)) {
+					next = observe_next_due(next, now, due);
+					prev = node;
+					continue;
+				}
+
+				if (o->retries == COAP_DEFAULT_MAX_RETRANSMIT) {
+					NET_DBG("Observer %p timed out", o);
+					sys_slist_remove(&resource->observers,
+							 prev, node);
+					memset(&o->addr, 0, sizeof(o->addr));
+					continue;
+				}
+
+				o->retries++;
+				o->timeout <<= 1;
+				new_id = o->age != resource->age;
+			} else {
+				if (o->age == resource->age) {
+					prev = node;
+					continue;
+				}
+
+				due = o->last_tx + engine->min_interval_ms;
+				if (!time_reached(now, due)) {
+					next = observe_next_due(next, now, due);
+					prev = node;
+					continue;
+				}
+
+				o->con = time_reached(now, o->last_con +
+						      engine->con_interval_ms);
+				if (o->con) {
+					o->retries = 0U;
+					o->timeout = init_ack_timeout();
+					o->last_con = now;
+				}
+
+				new_id = true;
+			}
+
+			if (!encoded) {
+				r = observe_encode(engine, resource, &cpkt);
+				if (r < 0) {
+					NET_ERR("Cannot encode notification "
+						"(%d)", r);
+					next = observe_next_due(
+						next, now,
+						now + engine->min_interval_ms);
+					break;
+				}
+
+				encoded = true;
+			}
+
+			if (new_id) {
+				o->id = coap_next_id();
+			}
+
+			r = observe_send(engine, o, &cpkt, o->con);
+			if (r < 0) {
+				NET_DBG("Cannot send notification (%d)", r);
+			}
+
+			o->age = resource->age;
+			o->last_tx = now;
+
+			if (o->con) {
+				next = observe_next_due(next, now,
+							now + o->timeout);
+			}
+
+			prev = node;
+		}
+	}
+
+	engine->scheduled = next != SYS_FOREVER_MS;
+	engine->next_due = now + next;
+
+	return next;
+}
+
+struct coap_observer *coap_observe_engine_response(
+	struct coap_observe_engine *engine,
+	const struct coap_packet *response,
+	const struct sockaddr *addr)
+{
+	uint8_t type = coap_header_get_type(response);
+	uint16_t id = coap_header_get_id(response);
+	struct coap_resource *resource;
+	struct coap_observer *o;
+
+	if (type != COAP_TYPE_ACK && type != COAP_TYPE_RESET) {
+		return NULL;
+	}
+
+	for (resource = engine->resources; resource->path; resource++) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&resource->observers, o, list) {
+			if (o->id != id || !sockaddr_equal(&o->addr, addr)) {
+				continue;
+			}
+
+			if (type == COAP_TYPE_RESET) {
+				coap_remove_observer(resource, o);
+				memset(&o->addr, 0, sizeof(o->addr));
+			} else if (o->con) {
+				/* Updates held back by the CON may be due */
+				o->con = false;
+				engine->changed = true;
+			}
+
+			return o;
+		}
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_COAP_OBSERVE_ENGINE */
+
 /**
  * @brief Internal initialization function for CoAP library.
  *
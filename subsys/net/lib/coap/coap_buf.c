@@ -0,0 +1,636 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_coap, CONFIG_COAP_LOG_LEVEL);
+
+#include <string.h>
+#include <errno.h>
+
+#include <zephyr/types.h>
+#include <sys/byteorder.h>
+#include <sys/math_extras.h>
+
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/coap_buf.h>
+
+/* See RFC 7252, section-3.1 and the definitions in coap.c */
+#define COAP_OPTION_EXT_13 13
+#define COAP_OPTION_EXT_14 14
+#define COAP_OPTION_EXT_269 269
+
+#define COAP_MARKER		0xFF
+
+#define BASIC_HEADER_SIZE	4
+
+/* Read position in a fragment chain */
+struct coap_buf_cursor {
+	struct net_buf *frag;
+	uint16_t offset;
+	uint16_t left; /* Bytes left to read in the packet */
+};
+
+static void cursor_init(struct coap_buf_cursor *c, struct net_buf *frag,
+			uint16_t offset, uint16_t left)
+{
+	c->frag = frag;
+	c->offset = offset;
+	c->left = left;
+}
+
+/* Moves the cursor to the fragment of the next byte to read */
+static void cursor_normalize(struct coap_buf_cursor *c)
+{
+	while (c->frag && c->offset >= c->frag->len && c->frag->frags) {
+		c->offset -= c->frag->len;
+		c->frag = c->frag->frags;
+	}
+}
+
+/* Reads len bytes, or skips them if dst is NULL */
+static int cursor_read(struct coap_buf_cursor *c, uint8_t *dst, uint16_t len)
+{
+	if (c->left < len) {
+		return -EINVAL;
+	}
+
+	c->left -= len;
+
+	while (len) {
+		uint16_t count;
+
+		cursor_normalize(c);
+
+		count = MIN(len, c->frag->len - c->offset);
+		if (dst) {
+			memcpy(dst, c->frag->data + c->offset, count);
+			dst += count;
+		}
+
+		c->offset += count;
+		len -= count;
+	}
+
+	return 0;
+}
+
+static int decode_ext(struct coap_buf_cursor *c, uint8_t nibble,
+		      uint16_t *value)
+{
+	uint8_t ext[2];
+	int r;
+
+	if (nibble < COAP_OPTION_EXT_13) {
+		*value = nibble;
+	} else if (nibble == COAP_OPTION_EXT_13) {
+		r = cursor_read(c, ext, 1);
+		if (r < 0) {
+			return r;
+		}
+
+		*value = ext[0] + COAP_OPTION_EXT_13;
+	} else if (nibble == COAP_OPTION_EXT_14) {
+		r = cursor_read(c, ext, 2);
+		if (r < 0) {
+			return r;
+		}
+
+		if (u16_add_overflow(sys_get_be16(ext), COAP_OPTION_EXT_269,
+				     value)) {
+			return -EINVAL;
+		}
+	} else {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* Returns 1 if an option was read, 0 at the end of the options */
+static int next_option(struct coap_buf_cursor *c, uint16_t *delta,
+		       struct coap_buf_option *option)
+{
+	uint16_t opt_delta;
+	uint16_t len;
+	uint8_t opt;
+	int r;
+
+	if (c->left == 0U) {
+		return 0;
+	}
+
+	r = cursor_read(c, &opt, 1);
+	if (r < 0) {
+		return r;
+	}
+
+	if (opt == COAP_MARKER) {
+		/* packet w/ marker but no payload is malformed */
+		return c->left ? 0 : -EINVAL;
+	}
+
+	r = decode_ext(c, opt >> 4, &opt_delta);
+	if (r < 0) {
+		return r;
+	}
+
+	r = decode_ext(c, opt & 0xF, &len);
+	if (r < 0) {
+		return r;
+	}
+
+	if (u16_add_overflow(*delta, opt_delta, &opt_delta)) {
+		return -EINVAL;
+	}
+
+	*delta = opt_delta;
+
+	cursor_normalize(c);
+
+	if (option) {
+		option->frag = c->frag;
+		option->offset = c->offset;
+		option->delta = *delta;
+		option->len = len;
+	}
+
+	r = cursor_read(c, NULL, len);
+	if (r < 0) {
+		return r;
+	}
+
+	return 1;
+}
+
+static int buf_parse(struct coap_buf_packet *cpkt, struct net_buf *frag,
+		     uint16_t offset, size_t len)
+{
+	struct coap_buf_cursor c;
+	uint16_t delta = 0U;
+	uint8_t tkl;
+	int r;
+
+	if (len < BASIC_HEADER_SIZE || len > UINT16_MAX) {
+		return -EINVAL;
+	}
+
+	memset(cpkt, 0, sizeof(*cpkt));
+
+	cursor_init(&c, frag, offset, len);
+
+	r = cursor_read(&c, cpkt->hdr, BASIC_HEADER_SIZE);
+	if (r < 0) {
+		return r;
+	}
+
+	/* Token lengths 9-15 are reserved. */
+	tkl = cpkt->hdr[0] & 0x0f;
+	if (tkl > COAP_TOKEN_MAX_LEN) {
+		return -EINVAL;
+	}
+
+	r = cursor_read(&c, cpkt->hdr + BASIC_HEADER_SIZE, tkl);
+	if (r < 0) {
+		return r;
+	}
+
+	cursor_normalize(&c);
+
+	cpkt->buf = frag;
+	cpkt->hdr_len = BASIC_HEADER_SIZE + tkl;
+	cpkt->opt_frag = c.frag;
+	cpkt->opt_offset = c.offset;
+
+	do {
+		r = next_option(&c, &delta, NULL);
+	} while (r > 0);
+
+	if (r < 0) {
+		return r;
+	}
+
+	cpkt->delta = delta;
+
+	if (c.left) {
+		cursor_normalize(&c);
+
+		cpkt->payload_frag = c.frag;
+		cpkt->payload_offset = c.offset;
+		cpkt->payload_len = c.left;
+
+		/* Options, without the payload marker */
+		cpkt->opt_len = len - cpkt->hdr_len - c.left - 1;
+	} else {
+		cpkt->opt_len = len - cpkt->hdr_len;
+	}
+
+	return 0;
+}
+
+int coap_buf_packet_parse(struct coap_buf_packet *cpkt, struct net_buf *buf)
+{
+	if (!cpkt || !buf) {
+		return -EINVAL;
+	}
+
+	return buf_parse(cpkt, buf, 0, net_buf_frags_len(buf));
+}
+
+int coap_buf_packet_parse_pkt(struct coap_buf_packet *cpkt,
+			      struct net_pkt *pkt)
+{
+	struct net_buf *frag;
+
+	if (!cpkt || !pkt || !pkt->cursor.buf) {
+		return -EINVAL;
+	}
+
+	frag = pkt->cursor.buf;
+
+	return buf_parse(cpkt, frag, pkt->cursor.pos - frag->data,
+			 net_pkt_remaining_data(pkt));
+}
+
+static int append(struct coap_buf_packet *cpkt, const uint8_t *data,
+		  uint16_t len)
+{
+	if (cpkt->payload_ref) {
+		return -EINVAL;
+	}
+
+	if (net_buf_append_bytes(cpkt->buf, len, data, cpkt->timeout,
+				 NULL, NULL) != len) {
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+int coap_buf_packet_init(struct coap_buf_packet *cpkt, struct net_buf *buf,
+			 k_timeout_t timeout, uint8_t ver, uint8_t type,
+			 uint8_t token_len, const uint8_t *token,
+			 uint8_t code, uint16_t id)
+{
+	struct net_buf *last;
+
+	if (!cpkt || !buf || token_len > COAP_TOKEN_MAX_LEN ||
+	    (token_len && !token)) {
+		return -EINVAL;
+	}
+
+	memset(cpkt, 0, sizeof(*cpkt));
+
+	cpkt->buf = buf;
+	cpkt->timeout = timeout;
+
+	cpkt->hdr[0] = (ver & 0x3) << 6;
+	cpkt->hdr[0] |= (type & 0x3) << 4;
+	cpkt->hdr[0] |= token_len & 0xF;
+	cpkt->hdr[1] = code;
+	sys_put_be16(id, &cpkt->hdr[2]);
+
+	if (token_len) {
+		memcpy(&cpkt->hdr[BASIC_HEADER_SIZE], token, token_len);
+	}
+
+	cpkt->hdr_len = BASIC_HEADER_SIZE + token_len;
+
+	last = net_buf_frag_last(buf);
+
+	cpkt->opt_frag = last;
+	cpkt->opt_offset = last->len + cpkt->hdr_len;
+
+	return append(cpkt, cpkt->hdr, cpkt->hdr_len);
+}
+
+static uint8_t encode_ext(uint16_t num, uint8_t *nibble, uint8_t *ext)
+{
+	if (num < COAP_OPTION_EXT_13) {
+		*nibble = num;
+
+		return 0;
+	} else if (num < COAP_OPTION_EXT_269) {
+		*nibble = COAP_OPTION_EXT_13;
+		ext[0] = num - COAP_OPTION_EXT_13;
+
+		return 1;
+	}
+
+	*nibble = COAP_OPTION_EXT_14;
+	sys_put_be16(num - COAP_OPTION_EXT_269, ext);
+
+	return 2;
+}
+
+int coap_buf_packet_append_option(struct coap_buf_packet *cpkt, uint16_t code,
+				  const uint8_t *value, uint16_t len)
+{
+	uint8_t hdr[5];
+	uint8_t delta_nibble;
+	uint8_t len_nibble;
+	uint8_t hdr_len = 1U;
+	uint16_t delta;
+	int r;
+
+	if (!cpkt || (len && !value)) {
+		return -EINVAL;
+	}
+
+	if (code < cpkt->delta) {
+		NET_ERR("Options should be in ascending order");
+		return -EINVAL;
+	}
+
+	if (cpkt->payload_len) {
+		return -EINVAL;
+	}
+
+	delta = code - cpkt->delta;
+
+	hdr_len += encode_ext(delta, &delta_nibble, &hdr[hdr_len]);
+	hdr_len += encode_ext(len, &len_nibble, &hdr[hdr_len]);
+	hdr[0] = (delta_nibble << 4) | len_nibble;
+
+	r = append(cpkt, hdr, hdr_len);
+	if (r < 0) {
+		return r;
+	}
+
+	if (len) {
+		r = append(cpkt, value, len);
+		if (r < 0) {
+			return r;
+		}
+	}
+
+	cpkt->opt_len += hdr_len + len;
+	cpkt->delta = code;
+
+	return 0;
+}
+
+int coap_buf_append_option_int(struct coap_buf_packet *cpkt, uint16_t code,
+			       unsigned int val)
+{
+	uint8_t data[4];
+	uint8_t len = 0U;
+
+	/* Minimal big endian encoding, leading zero bytes are dropped */
+	while (len < sizeof(data) && (val >> (8 * len))) {
+		len++;
+	}
+
+	sys_put_be32(val, data);
+
+	return coap_buf_packet_append_option(cpkt, code,
+					     data + sizeof(data) - len, len);
+}
+
+int coap_buf_packet_append_payload_marker(struct coap_buf_packet *cpkt)
+{
+	uint8_t marker = COAP_MARKER;
+
+	if (!cpkt) {
+		return -EINVAL;
+	}
+
+	return append(cpkt, &marker, 1);
+}
+
+/* Records where the payload starts before its first byte is appended */
+static void payload_start(struct coap_buf_packet *cpkt)
+{
+	struct net_buf *last;
+
+	if (cpkt->payload_frag) {
+		return;
+	}
+
+	last = net_buf_frag_last(cpkt->buf);
+
+	cpkt->payload_frag = last;
+	cpkt->payload_offset = last->len;
+}
+
+int coap_buf_packet_append_payload(struct coap_buf_packet *cpkt,
+				   const uint8_t *payload,
+				   uint16_t payload_len)
+{
+	uint16_t len;
+	int r;
+
+	if (!cpkt || !payload) {
+		return -EINVAL;
+	}
+
+	if (u16_add_overflow(cpkt->payload_len, payload_len, &len)) {
+		return -EINVAL;
+	}
+
+	payload_start(cpkt);
+
+	r = append(cpkt, payload, payload_len);
+	if (r < 0) {
+		return r;
+	}
+
+	cpkt->payload_len = len;
+
+	return 0;
+}
+
+int coap_buf_packet_append_payload_frag(struct coap_buf_packet *cpkt,
+					struct net_buf *frag)
+{
+	size_t len;
+
+	if (!cpkt || !frag || cpkt->payload_ref) {
+		return -EINVAL;
+	}
+
+	len = net_buf_frags_len(frag);
+	if (len > UINT16_MAX - cpkt->payload_len) {
+		return -EINVAL;
+	}
+
+	payload_start(cpkt);
+
+	net_buf_frag_add(cpkt->buf, frag);
+
+	cpkt->payload_len += len;
+	cpkt->payload_ref = true;
+
+	return 0;
+}
+
+size_t coap_buf_packet_len(const struct coap_buf_packet *cpkt)
+{
+	size_t len = cpkt->hdr_len + cpkt->opt_len;
+
+	if (cpkt->payload_len) {
+		len += 1 + cpkt->payload_len;
+	}
+
+	return len;
+}
+
+int coap_buf_packet_to_iovec(const struct coap_buf_packet *cpkt,
+			     struct iovec *iov, size_t iovlen)
+{
+	struct net_buf *frag;
+	size_t count = 0;
+
+	for (frag = cpkt->buf; frag; frag = frag->frags) {
+		if (!frag->len) {
+			continue;
+		}
+
+		if (count == iovlen) {
+			return -ENOBUFS;
+		}
+
+		iov[count].iov_base = frag->data;
+		iov[count].iov_len = frag->len;
+		count++;
+	}
+
+	return count;
+}
+
+uint8_t coap_buf_header_get_type(const struct coap_buf_packet *cpkt)
+{
+	return (cpkt->hdr[0] & 0x30) >> 4;
+}
+
+uint8_t coap_buf_header_get_code(const struct coap_buf_packet *cpkt)
+{
+	return cpkt->hdr[1];
+}
+
+uint16_t coap_buf_header_get_id(const struct coap_buf_packet *cpkt)
+{
+	return sys_get_be16(&cpkt->hdr[2]);
+}
+
+uint8_t coap_buf_header_get_token(const struct coap_buf_packet *cpkt,
+				  uint8_t *token)
+{
+	uint8_t tkl = cpkt->hdr[0] & 0x0f;
+
+	if (tkl) {
+		memcpy(token, &cpkt->hdr[BASIC_HEADER_SIZE], tkl);
+	}
+
+	return tkl;
+}
+
+int coap_buf_find_options(const struct coap_buf_packet *cpkt, uint16_t code,
+			  struct coap_buf_option *options, uint16_t veclen)
+{
+	struct coap_buf_option option;
+	struct coap_buf_cursor c;
+	uint16_t delta = 0U;
+	int count = 0;
+	int r;
+
+	if (!cpkt || !options || !veclen) {
+		return -EINVAL;
+	}
+
+	cursor_init(&c, cpkt->opt_frag, cpkt->opt_offset, cpkt->opt_len);
+
+	while (count < veclen) {
+		r = next_option(&c, &delta, &option);
+		if (r < 0) {
+			return r;
+		} else if (r == 0 || delta > code) {
+			/* Options are sorted by their number */
+			break;
+		}
+
+		if (delta == code) {
+			options[count++] = option;
+		}
+	}
+
+	return count;
+}
+
+int coap_buf_get_option_int(const struct coap_buf_packet *cpkt,
+			    uint16_t code)
+{
+	struct coap_buf_option option;
+	int r;
+
+	r = coap_buf_find_options(cpkt, code, &option, 1);
+	if (r <= 0) {
+		return -ENOENT;
+	}
+
+	return coap_buf_option_value_to_int(&option);
+}
+
+const uint8_t *coap_buf_option_value(const struct coap_buf_option *option)
+{
+	if (option->offset + option->len > option->frag->len) {
+		return NULL;
+	}
+
+	return option->frag->data + option->offset;
+}
+
+int coap_buf_option_read(const struct coap_buf_option *option,
+			 uint8_t *dst, uint16_t len)
+{
+	if (len < option->len) {
+		return -EINVAL;
+	}
+
+	return net_buf_linearize(dst, len, option->frag, option->offset,
+				 option->len);
+}
+
+unsigned int coap_buf_option_value_to_int(
+	const struct coap_buf_option *option)
+{
+	uint8_t value[4];
+	unsigned int val = 0U;
+	int i;
+
+	if (option->len > sizeof(value)) {
+		return 0;
+	}
+
+	coap_buf_option_read(option, value, sizeof(value));
+
+	for (i = 0; i < option->len; i++) {
+		val = (val << 8) | value[i];
+	}
+
+	return val;
+}
+
+struct net_buf *coap_buf_packet_get_payload(const struct coap_buf_packet *cpkt,
+					    uint16_t *offset, uint16_t *len)
+{
+	struct coap_buf_cursor c;
+
+	if (!cpkt->payload_len) {
+		*offset = 0U;
+		*len = 0U;
+		return NULL;
+	}
+
+	cursor_init(&c, cpkt->payload_frag, cpkt->payload_offset,
+		    cpkt->payload_len);
+	cursor_normalize(&c);
+
+	*offset = c.offset;
+	*len = cpkt->payload_len;
+
+	return c.frag;
+}
@@ -394,6 +394,39 @@ static int format_resource(const struct coap_resource *resource,
 				 current, more);
 }
 
+#if defined(CONFIG_COAP_RESOURCE_INDEX)
+/* Length of what format_resource() writes, cached in the resource until
+ * coap_resource_index_init() is called again.
+ */
+static size_t resource_link_len(struct coap_resource *resource)
+{
+	struct coap_core_metadata *meta = resource->user_data;
+	const char * const *p;
+	size_t len;
+
+	if (resource->link_len) {
+		return resource->link_len;
+	}
+
+	/* "</" and ">" around the path */
+	len = 3;
+
+	for (p = resource->path; *p; p++) {
+		len += strlen(*p) + (p != resource->path ? 1 : 0);
+	}
+
+	for (p = meta ? meta->attributes : NULL; p && *p; p++) {
+		len += 1 + strlen(*p);
+	}
+
+	if (len <= UINT16_MAX) {
+		resource->link_len = len;
+	}
+
+	return len;
+}
+#endif /* CONFIG_COAP_RESOURCE_INDEX */
+
 /* coap_well_known_core_get() added Option (delta and len) with
  * out any extended options so this function will not consider Extended
  * options at the moment.
@@ -512,6 +545,21 @@ int coap_well_known_core_get(struct coap_resource *resource,
 			break;
 		}
 
+#if defined(CONFIG_COAP_RESOURCE_INDEX)
+		/* Entries that end before the requested block are only
+		 * counted, not formatted.
+		 */
+		if (num_queries == 0) {
+			size_t entry_len = resource_link_len(resource) +
+					   ((resource + 1)->path ? 1 : 0);
+
+			if (offset + entry_len <= ctx.current) {
+				offset += entry_len;
+				continue;
+			}
+		}
+#endif
+
 		if (!match_queries_resource(resource, &query, num_queries)) {
 			continue;
 		}
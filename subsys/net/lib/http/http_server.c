@@ -0,0 +1,677 @@
+/** @file
+ * @brief HTTP server API
+ *
+ * An API for applications to serve HTTP/1.1 requests
+ */
+
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_http_server, CONFIG_NET_HTTP_LOG_LEVEL);
+
+#include <kernel.h>
+#include <string.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include <net/net_ip.h>
+#include <net/socket.h>
+#include <net/http_server.h>
+
+#include "net_private.h"
+
+#define HTTP_SERVER_HEADER_SIZE 160
+#define HTTP_CHUNK_HEADER_SIZE sizeof("ffffffff" HTTP_CRLF)
+#define HTTP_LAST_CHUNK "0" HTTP_CRLF HTTP_CRLF
+
+static ssize_t sendall(int sock, const void *buf, size_t len)
+{
+	while (len) {
+		ssize_t out_len = zsock_send(sock, buf, len, 0);
+
+		if (out_len < 0) {
+			return -errno;
+		}
+
+		buf = (const char *)buf + out_len;
+		len -= out_len;
+	}
+
+	return 0;
+}
+
+static const char *http_status_str(uint16_t status)
+{
+	switch (status) {
+	case 200: return "OK";
+	case 201: return "Created";
+	case 202: return "Accepted";
+	case 204: return "No Content";
+	case 301: return "Moved Permanently";
+	case 302: return "Found";
+	case 304: return "Not Modified";
+	case 400: return "Bad Request";
+	case 401: return "Unauthorized";
+	case 403: return "Forbidden";
+	case 404: return "Not Found";
+	case 405: return "Method Not Allowed";
+	case 408: return "Request Timeout";
+	case 411: return "Length Required";
+	case 413: return "Payload Too Large";
+	case 414: return "URI Too Long";
+	case 500: return "Internal Server Error";
+	case 501: return "Not Implemented";
+	case 503: return "Service Unavailable";
+	default: return "";
+	}
+}
+
+static void conn_close(struct http_server_conn *conn)
+{
+	struct http_server_ctx *ctx = conn->ctx;
+	int idx = conn - ctx->conns;
+
+	NET_DBG("[%p] Closing connection %d", conn, conn->sock);
+
+	(void)zsock_close(conn->sock);
+	conn->sock = -1;
+	ctx->fds[idx + 1].fd = -1;
+}
+
+static void conn_open(struct http_server_ctx *ctx, int sock)
+{
+	int nodelay = 1;
+	int i;
+
+	/* Responses are sent whole, do not delay them. */
+	(void)zsock_setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &nodelay,
+			       sizeof(nodelay));
+
+	for (i = 0; i < ARRAY_SIZE(ctx->conns); i++) {
+		struct http_server_conn *conn = &ctx->conns[i];
+
+		if (conn->sock >= 0) {
+			continue;
+		}
+
+		memset(conn, 0, sizeof(*conn));
+		conn->sock = sock;
+		conn->ctx = ctx;
+		conn->last_activity = k_uptime_get();
+
+		http_parser_init(&conn->parser, HTTP_REQUEST);
+		conn->parser.data = conn;
+
+		ctx->fds[i + 1].fd = sock;
+		ctx->fds[i + 1].events = ZSOCK_POLLIN;
+
+		NET_DBG("[%p] New connection %d", conn, sock);
+		return;
+	}
+
+	NET_DBG("No free connection, closing %d", sock);
+	(void)zsock_close(sock);
+}
+
+static const struct http_resource *
+resource_find(struct http_server_ctx *ctx, const char *url)
+{
+	size_t path_len = strcspn(url, "?");
+	int i;
+
+	for (i = 0; i < ctx->resource_count; i++) {
+		const struct http_resource *res = &ctx->resources[i];
+		size_t len = strlen(res->path);
+
+		if (len > 0 && res->path[len - 1] == '*') {
+			if (path_len >= len - 1 &&
+			    strncmp(url, res->path, len - 1) == 0) {
+				return res;
+			}
+		} else if (path_len == len &&
+			   strncmp(url, res->path, len) == 0) {
+			return res;
+		}
+	}
+
+	return NULL;
+}
+
+static int on_message_begin(struct http_parser *parser)
+{
+	struct http_server_conn *conn = parser->data;
+
+	conn->resource = NULL;
+	conn->url_len = 0;
+	conn->content_length = 0;
+	conn->error_status = 0;
+	conn->response_started = 0;
+	conn->response_ended = 0;
+	conn->response_chunked = 0;
+	conn->response_no_body = 0;
+
+	return 0;
+}
+
+static int on_url(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_server_conn *conn = parser->data;
+
+	if (conn->url_len + length >= sizeof(conn->url)) {
+		conn->error_status = 414;
+		return 0;
+	}
+
+	memcpy(conn->url + conn->url_len, at, length);
+	conn->url_len += length;
+
+	return 0;
+}
+
+static int on_headers_complete(struct http_parser *parser)
+{
+	struct http_server_conn *conn = parser->data;
+	const struct http_resource *res;
+
+	conn->url[conn->url_len] = '\0';
+	conn->method = parser->method;
+	conn->keep_alive = http_should_keep_alive(parser);
+
+	if ((parser->flags & F_CHUNKED) == 0 &&
+	    parser->content_length != UINT64_MAX) {
+		conn->content_length = parser->content_length;
+	}
+
+	NET_DBG("[%p] %s %s", conn, http_method_str(conn->method),
+		log_strdup(conn->url));
+
+	if (conn->error_status) {
+		return 0;
+	}
+
+	res = resource_find(conn->ctx, conn->url);
+	if (res == NULL) {
+		conn->error_status = 404;
+		return 0;
+	}
+
+	if ((res->methods & HTTP_METHOD_BIT(conn->method)) == 0) {
+		conn->error_status = 405;
+		return 0;
+	}
+
+	conn->resource = res;
+
+	if (res->cb(conn, HTTP_SERVER_REQ_HEADERS, NULL, 0,
+		    res->user_data) < 0) {
+		return -1;
+	}
+
+	return 0;
+}
+
+static int on_body(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_server_conn *conn = parser->data;
+	const struct http_resource *res = conn->resource;
+
+	if (res == NULL) {
+		return 0;
+	}
+
+	if (res->cb(conn, HTTP_SERVER_REQ_BODY, (const uint8_t *)at, length,
+		    res->user_data) < 0) {
+		return -1;
+	}
+
+	return 0;
+}
+
+static int on_message_complete(struct http_parser *parser)
+{
+	struct http_server_conn *conn = parser->data;
+	const struct http_resource *res = conn->resource;
+	int ret;
+
+	if (res != NULL) {
+		ret = res->cb(conn, HTTP_SERVER_REQ_END, NULL, 0,
+			      res->user_data);
+		if (ret < 0) {
+			return -1;
+		}
+
+		if (!conn->response_started) {
+			NET_ERR("[%p] No response to %s", conn,
+				log_strdup(conn->url));
+			conn->error_status = 500;
+		}
+	}
+
+	if (conn->error_status) {
+		ret = http_server_response(conn, conn->error_status, NULL,
+					   NULL, 0);
+	} else {
+		ret = http_server_response_end(conn);
+	}
+
+	if (ret < 0) {
+		return -1;
+	}
+
+	/* Stop parsing the pipelined requests, the connection is closed. */
+	if (conn->close) {
+		http_parser_pause(parser, 1);
+	}
+
+	return 0;
+}
+
+static void conn_recv(struct http_server_conn *conn)
+{
+	struct http_server_ctx *ctx = conn->ctx;
+	enum http_errno err;
+	ssize_t len;
+	size_t parsed;
+
+	len = zsock_recv(conn->sock, ctx->recv_buf, sizeof(ctx->recv_buf), 0);
+	if (len < 0) {
+		if (errno == EAGAIN) {
+			return;
+		}
+
+		NET_DBG("[%p] Receive error %d", conn, -errno);
+		conn_close(conn);
+		return;
+	}
+
+	conn->last_activity = k_uptime_get();
+
+	/* A zero length tells the parser about the end of the stream. */
+	parsed = http_parser_execute(&conn->parser, &ctx->parser_settings,
+				     (const char *)ctx->recv_buf, len);
+
+	err = HTTP_PARSER_ERRNO(&conn->parser);
+	if (err == HPE_OK && len > 0 && !conn->parser.upgrade) {
+		return;
+	}
+
+	if (err != HPE_OK && err != HPE_PAUSED) {
+		NET_DBG("[%p] Parse error %s at %zu", conn,
+			http_errno_name(err), parsed);
+
+		/* Only answer if it does not break a response being sent. */
+		if (err < HPE_CB_message_begin || err > HPE_CB_chunk_complete) {
+			if (!conn->response_started || conn->response_ended) {
+				conn->keep_alive = 0;
+				conn->response_started = 0;
+				conn->response_ended = 0;
+				conn->response_chunked = 0;
+				(void)http_server_response(conn, 400, NULL,
+							   NULL, 0);
+			}
+		}
+	}
+
+	conn_close(conn);
+}
+
+static int next_timeout(struct http_server_ctx *ctx, int timeout)
+{
+	int64_t now = k_uptime_get();
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(ctx->conns); i++) {
+		struct http_server_conn *conn = &ctx->conns[i];
+		int64_t remaining;
+
+		if (conn->sock < 0) {
+			continue;
+		}
+
+		remaining = conn->last_activity +
+			    CONFIG_HTTP_SERVER_IDLE_TIMEOUT - now;
+		if (remaining < 0) {
+			remaining = 0;
+		}
+
+		if (timeout < 0 || remaining < timeout) {
+			timeout = remaining;
+		}
+	}
+
+	return timeout;
+}
+
+static void idle_close(struct http_server_ctx *ctx)
+{
+	int64_t now = k_uptime_get();
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(ctx->conns); i++) {
+		struct http_server_conn *conn = &ctx->conns[i];
+
+		if (conn->sock >= 0 && now - conn->last_activity >=
+				       CONFIG_HTTP_SERVER_IDLE_TIMEOUT) {
+			NET_DBG("[%p] Idle timeout", conn);
+			conn_close(conn);
+		}
+	}
+}
+
+int http_server_init(struct http_server_ctx *ctx,
+		     const struct sockaddr *addr, socklen_t addrlen,
+		     const struct http_resource *resources,
+		     size_t resource_count)
+{
+	int sock;
+	int i;
+
+	if (ctx == NULL || addr == NULL ||
+	    (resources == NULL && resource_count > 0)) {
+		return -EINVAL;
+	}
+
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->resources = resources;
+	ctx->resource_count = resource_count;
+
+	http_parser_settings_init(&ctx->parser_settings);
+	ctx->parser_settings.on_message_begin = on_message_begin;
+	ctx->parser_settings.on_url = on_url;
+	ctx->parser_settings.on_headers_complete = on_headers_complete;
+	ctx->parser_settings.on_body = on_body;
+	ctx->parser_settings.on_message_complete = on_message_complete;
+
+	for (i = 0; i < ARRAY_SIZE(ctx->conns); i++) {
+		ctx->conns[i].sock = -1;
+		ctx->fds[i + 1].fd = -1;
+	}
+
+	sock = zsock_socket(addr->sa_family, SOCK_STREAM, IPPROTO_TCP);
+	if (sock < 0) {
+		return -errno;
+	}
+
+	if (zsock_bind(sock, addr, addrlen) < 0 ||
+	    zsock_listen(sock, CONFIG_HTTP_SERVER_MAX_CLIENTS) < 0) {
+		int ret = -errno;
+
+		NET_ERR("Cannot listen (%d)", ret);
+		(void)zsock_close(sock);
+		return ret;
+	}
+
+	ctx->listen_sock = sock;
+	ctx->fds[0].fd = sock;
+	ctx->fds[0].events = ZSOCK_POLLIN;
+
+	return 0;
+}
+
+int http_server_poll(struct http_server_ctx *ctx, int timeout)
+{
+	int ret;
+	int i;
+
+	ret = zsock_poll(ctx->fds, ARRAY_SIZE(ctx->fds),
+			 next_timeout(ctx, timeout));
+	if (ret < 0) {
+		return -errno;
+	}
+
+	for (i = 0; ret > 0 && i < ARRAY_SIZE(ctx->conns); i++) {
+		struct zsock_pollfd *fd = &ctx->fds[i + 1];
+
+		if (fd->fd < 0 || fd->revents == 0) {
+			continue;
+		}
+
+		ret--;
+
+		if (fd->revents & ZSOCK_POLLIN) {
+			conn_recv(&ctx->conns[i]);
+		} else {
+			conn_close(&ctx->conns[i]);
+		}
+	}
+
+	if (ctx->fds[0].revents & ZSOCK_POLLIN) {
+		int sock = zsock_accept(ctx->listen_sock, NULL, NULL);
+
+		if (sock >= 0) {
+			conn_open(ctx, sock);
+		}
+	} else if (ctx->fds[0].revents) {
+		return -EIO;
+	}
+
+	idle_close(ctx);
+
+	return 0;
+}
+
+int http_server_run(struct http_server_ctx *ctx)
+{
+	int ret;
+
+	do {
+		ret = http_server_poll(ctx, -1);
+	} while (ret == 0 || ret == -EINTR);
+
+	return ret;
+}
+
+void http_server_close(struct http_server_ctx *ctx)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(ctx->conns); i++) {
+		if (ctx->conns[i].sock >= 0) {
+			conn_close(&ctx->conns[i]);
+		}
+	}
+
+	if (ctx->listen_sock >= 0) {
+		(void)zsock_close(ctx->listen_sock);
+		ctx->listen_sock = -1;
+		ctx->fds[0].fd = -1;
+	}
+}
+
+static int sendall_iov(int sock, struct iovec *iov, size_t iovlen)
+{
+	struct msghdr msg = { .msg_iov = iov, .msg_iovlen = iovlen };
+	ssize_t sent;
+	size_t i;
+	int ret;
+
+	sent = zsock_sendmsg(sock, &msg, 0);
+	if (sent < 0) {
+		return -errno;
+	}
+
+	/* Complete a partial send. */
+	for (i = 0; i < iovlen; i++) {
+		if (sent >= (ssize_t)iov[i].iov_len) {
+			sent -= iov[i].iov_len;
+			continue;
+		}
+
+		ret = sendall(sock, (uint8_t *)iov[i].iov_base + sent,
+			      iov[i].iov_len - sent);
+		if (ret < 0) {
+			return ret;
+		}
+
+		sent = 0;
+	}
+
+	return 0;
+}
+
+static int response_header(struct http_server_conn *conn, uint16_t status,
+			   const char *content_type, ssize_t content_length,
+			   char *header, size_t size)
+{
+	int len;
+
+	if (conn->response_started) {
+		return -EALREADY;
+	}
+
+	conn->response_started = 1;
+	conn->response_no_body = (conn->method == HTTP_HEAD);
+
+	/* Without chunked encoding, the end of the body is the end of the
+	 * connection.
+	 */
+	if (content_length < 0) {
+		if (conn->parser.http_major > 1 ||
+		    (conn->parser.http_major == 1 &&
+		     conn->parser.http_minor >= 1)) {
+			conn->response_chunked = !conn->response_no_body;
+		} else {
+			conn->keep_alive = 0;
+		}
+	}
+
+	conn->close = !conn->keep_alive;
+
+	/* snprintk() returns the untruncated length, which must be checked
+	 * before it moves the write position.
+	 */
+	len = snprintk(header, size, "HTTP/1.1 %u %s" HTTP_CRLF "%s%s%s",
+		       status, http_status_str(status),
+		       content_type ? "Content-Type: " : "",
+		       content_type ? content_type : "",
+		       content_type ? HTTP_CRLF : "");
+	if (len >= size) {
+		goto too_long;
+	}
+
+	if (content_length >= 0) {
+		len += snprintk(header + len, size - len,
+				"Content-Length: %zd" HTTP_CRLF,
+				content_length);
+	} else if (conn->response_chunked) {
+		len += snprintk(header + len, size - len,
+				"Transfer-Encoding: chunked" HTTP_CRLF);
+	}
+
+	if (len >= size) {
+		goto too_long;
+	}
+
+	len += snprintk(header + len, size - len, "%s" HTTP_CRLF,
+			conn->close ? "Connection: close" HTTP_CRLF : "");
+	if (len >= size) {
+		goto too_long;
+	}
+
+	return len;
+
+too_long:
+	NET_ERR("[%p] Response header too long", conn);
+	conn->close = 1;
+	return -ENOMEM;
+}
+
+int http_server_response_begin(struct http_server_conn *conn, uint16_t status,
+			       const char *content_type,
+			       ssize_t content_length)
+{
+	char header[HTTP_SERVER_HEADER_SIZE];
+	int len;
+
+	len = response_header(conn, status, content_type, content_length,
+			      header, sizeof(header));
+	if (len < 0) {
+		return len;
+	}
+
+	return sendall(conn->sock, header, len);
+}
+
+int http_server_response_send(struct http_server_conn *conn,
+			      const void *data, size_t len)
+{
+	char chunk_header[HTTP_CHUNK_HEADER_SIZE];
+	struct iovec iov[3];
+
+	if (!conn->response_started || conn->response_ended) {
+		return -EINVAL;
+	}
+
+	if (len == 0 || conn->response_no_body) {
+		return 0;
+	}
+
+	if (!conn->response_chunked) {
+		return sendall(conn->sock, data, len);
+	}
+
+	/* Send the chunk framing and data together. */
+	iov[0].iov_base = chunk_header;
+	iov[0].iov_len = snprintk(chunk_header, sizeof(chunk_header),
+				  "%x" HTTP_CRLF, (unsigned int)len);
+	iov[1].iov_base = (void *)data;
+	iov[1].iov_len = len;
+	iov[2].iov_base = HTTP_CRLF;
+	iov[2].iov_len = sizeof(HTTP_CRLF) - 1;
+
+	return sendall_iov(conn->sock, iov, ARRAY_SIZE(iov));
+}
+
+int http_server_response_end(struct http_server_conn *conn)
+{
+	if (!conn->response_started) {
+		return -EINVAL;
+	}
+
+	if (conn->response_ended) {
+		return 0;
+	}
+
+	conn->response_ended = 1;
+
+	if (conn->response_chunked) {
+		return sendall(conn->sock, HTTP_LAST_CHUNK,
+			       sizeof(HTTP_LAST_CHUNK) - 1);
+	}
+
+	return 0;
+}
+
+int http_server_response(struct http_server_conn *conn, uint16_t status,
+			 const char *content_type, const void *body,
+			 size_t len)
+{
+	char header[HTTP_SERVER_HEADER_SIZE];
+	struct iovec iov[2];
+	int ret;
+
+	ret = response_header(conn, status, content_type, len, header,
+			      sizeof(header));
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* Send the header and body together, a small response then takes
+	 * a single segment.
+	 */
+	iov[0].iov_base = header;
+	iov[0].iov_len = ret;
+	iov[1].iov_base = (void *)body;
+	iov[1].iov_len = conn->response_no_body ? 0 : len;
+
+	ret = sendall_iov(conn->sock, iov, ARRAY_SIZE(iov));
+	if (ret < 0) {
+		return ret;
+	}
+
+	return http_server_response_end(conn);
+}
@@ -45,6 +45,9 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #ifdef CONFIG_LWM2M_RW_JSON_SUPPORT
 #include "lwm2m_rw_json.h"
 #endif
+#ifdef CONFIG_LWM2M_RW_CBOR_SUPPORT
+#include "lwm2m_rw_cbor.h"
+#endif
 #ifdef CONFIG_LWM2M_RD_CLIENT_SUPPORT
 #include "lwm2m_rd_client.h"
 #endif
@@ -128,6 +131,8 @@ static struct service_node service_node_data[MAX_PERIODIC_SERVICE];
 
 static sys_slist_t engine_obj_list;
 static sys_slist_t engine_obj_inst_list;
+static sys_slist_t
+	engine_obj_inst_index[CONFIG_LWM2M_ENGINE_OBJ_INST_INDEX_SIZE];
 static sys_slist_t engine_observer_list;
 static sys_slist_t engine_service_list;
 
@@ -638,9 +643,30 @@ lwm2m_get_engine_obj_field(struct lwm2m_engine_obj *obj, int res_id)
 
 /* engine object instance */
 
+BUILD_ASSERT((CONFIG_LWM2M_ENGINE_OBJ_INST_INDEX_SIZE &
+	      (CONFIG_LWM2M_ENGINE_OBJ_INST_INDEX_SIZE - 1)) == 0,
+	     "Object instance index size must be a power of two");
+
+static sys_slist_t *obj_inst_index_bucket(uint16_t obj_id,
+					  uint16_t obj_inst_id)
+{
+	uint32_t key = ((uint32_t)obj_id << 16) | obj_inst_id;
+
+	/* fold the object id onto the low bits holding the instance id */
+	key ^= key >> 16;
+	key *= 0x45d9f3bU;
+	key ^= key >> 16;
+
+	return &engine_obj_inst_index[key &
+		(CONFIG_LWM2M_ENGINE_OBJ_INST_INDEX_SIZE - 1)];
+}
+
 static void engine_register_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 {
 	sys_slist_append(&engine_obj_inst_list, &obj_inst->node);
+	sys_slist_append(obj_inst_index_bucket(obj_inst->obj->obj_id,
+					       obj_inst->obj_inst_id),
+			 &obj_inst->index_node);
 }
 
 static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
@@ -648,6 +674,10 @@ static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 	engine_remove_observer_by_id(
 			obj_inst->obj->obj_id, obj_inst->obj_inst_id);
 	sys_slist_find_and_remove(&engine_obj_inst_list, &obj_inst->node);
+	sys_slist_find_and_remove(
+		obj_inst_index_bucket(obj_inst->obj->obj_id,
+				      obj_inst->obj_inst_id),
+		&obj_inst->index_node);
 }
 
 static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
@@ -655,8 +685,8 @@ static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
 {
 	struct lwm2m_engine_obj_inst *obj_inst;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_inst_list, obj_inst,
-				     node) {
+	SYS_SLIST_FOR_EACH_CONTAINER(obj_inst_index_bucket(obj_id, obj_inst_id),
+				     obj_inst, index_node) {
 		if (obj_inst->obj->obj_id == obj_id &&
 		    obj_inst->obj_inst_id == obj_inst_id) {
 			return obj_inst;
@@ -1186,6 +1216,16 @@ static int select_writer(struct lwm2m_output_context *out, uint16_t accept)
 		break;
 #endif
 
+#ifdef CONFIG_LWM2M_RW_CBOR_SUPPORT
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+		out->writer = &senml_cbor_writer;
+		break;
+
+	case LWM2M_FORMAT_OMA_CBOR:
+		out->writer = &lwm2m_cbor_writer;
+		break;
+#endif
+
 	default:
 		LOG_WRN("Unknown content type %u", accept);
 		return -ENOMSG;
@@ -1217,6 +1257,13 @@ static int select_reader(struct lwm2m_input_context *in, uint16_t format)
 		break;
 #endif
 
+#ifdef CONFIG_LWM2M_RW_CBOR_SUPPORT
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+	case LWM2M_FORMAT_OMA_CBOR:
+		in->reader = &cbor_reader;
+		break;
+#endif
+
 	default:
 		LOG_WRN("Unknown content type %u", format);
 		return -ENOMSG;
@@ -1426,19 +1473,14 @@ int lwm2m_engine_set_res_data(char *pathstr, void *data_ptr, uint16_t data_len,
 	return ret;
 }
 
-static int lwm2m_engine_set(char *pathstr, void *value, uint16_t len)
+/* resolve a path string down to its resource instance */
+static int path_to_res_handle(char *pathstr, struct lwm2m_res_handle *handle)
 {
 	struct lwm2m_obj_path path;
-	struct lwm2m_engine_obj_inst *obj_inst;
-	struct lwm2m_engine_obj_field *obj_field;
-	struct lwm2m_engine_res *res = NULL;
-	struct lwm2m_engine_res_inst *res_inst = NULL;
-	void *data_ptr = NULL;
-	size_t max_data_len = 0;
-	int ret = 0;
-	bool changed = false;
+	int ret;
 
-	LOG_DBG("path:%s, value:%p, len:%d", log_strdup(pathstr), value, len);
+	/* path_to_objs() leaves res_inst alone when it is not found */
+	(void)memset(handle, 0, sizeof(*handle));
 
 	/* translate path -> path_obj */
 	ret = string_to_path(pathstr, &path, '/');
@@ -1452,20 +1494,67 @@ static int lwm2m_engine_set(char *pathstr, void *value, uint16_t len)
 	}
 
 	/* look up resource obj */
-	ret = path_to_objs(&path, &obj_inst, &obj_field, &res, &res_inst);
+	ret = path_to_objs(&path, &handle->obj_inst, &handle->obj_field,
+			   &handle->res, &handle->res_inst);
 	if (ret < 0) {
 		return ret;
 	}
 
-	if (!res_inst) {
+	if (!handle->res_inst) {
 		LOG_ERR("res instance %d not found", path.res_inst_id);
 		return -ENOENT;
 	}
 
+	handle->obj_id = path.obj_id;
+	handle->obj_inst_id = path.obj_inst_id;
+	handle->res_id = path.res_id;
+	handle->res_inst_id = path.res_inst_id;
+
+	return 0;
+}
+
+/*
+ * The object instance and resource arrays are cleared when an instance
+ * or a resource instance is deleted, so a handle resolved before that
+ * no longer matches its ids.
+ */
+static int res_handle_check(const struct lwm2m_res_handle *handle)
+{
+	if (!handle || !handle->res_inst) {
+		return -EINVAL;
+	}
+
+	if (!handle->obj_inst->obj ||
+	    handle->obj_inst->obj->obj_id != handle->obj_id ||
+	    handle->obj_inst->obj_inst_id != handle->obj_inst_id ||
+	    handle->res->res_id != handle->res_id ||
+	    handle->res_inst->res_inst_id != handle->res_inst_id) {
+		LOG_ERR("stale handle [%u/%u/%u/%u]", handle->obj_id,
+			handle->obj_inst_id, handle->res_id,
+			handle->res_inst_id);
+		return -ENOENT;
+	}
+
+	return 0;
+}
+
+static int engine_set_res(const struct lwm2m_res_handle *handle,
+			  void *value, uint16_t len)
+{
+	struct lwm2m_engine_obj_inst *obj_inst = handle->obj_inst;
+	struct lwm2m_engine_obj_field *obj_field = handle->obj_field;
+	struct lwm2m_engine_res *res = handle->res;
+	struct lwm2m_engine_res_inst *res_inst = handle->res_inst;
+	struct lwm2m_obj_path path;
+	void *data_ptr = NULL;
+	size_t max_data_len = 0;
+	int ret = 0;
+	bool changed = false;
+
 	if (LWM2M_HAS_RES_FLAG(res_inst, LWM2M_RES_DATA_FLAG_RO)) {
 		LOG_ERR("res instance data pointer is read-only "
-			"[%u/%u/%u/%u:%u]", path.obj_id, path.obj_inst_id,
-			path.res_id, path.res_inst_id, path.level);
+			"[%u/%u/%u/%u]", handle->obj_id, handle->obj_inst_id,
+			handle->res_id, handle->res_inst_id);
 		return -EACCES;
 	}
 
@@ -1481,9 +1570,9 @@ static int lwm2m_engine_set(char *pathstr, void *value, uint16_t len)
 	}
 
 	if (!data_ptr) {
-		LOG_ERR("res instance data pointer is NULL [%u/%u/%u/%u:%u]",
-			path.obj_id, path.obj_inst_id, path.res_id,
-			path.res_inst_id, path.level);
+		LOG_ERR("res instance data pointer is NULL [%u/%u/%u/%u]",
+			handle->obj_id, handle->obj_inst_id, handle->res_id,
+			handle->res_inst_id);
 		return -EINVAL;
 	}
 
@@ -1491,7 +1580,7 @@ static int lwm2m_engine_set(char *pathstr, void *value, uint16_t len)
 	if (len > max_data_len -
 		(obj_field->data_type == LWM2M_RES_TYPE_STRING ? 1 : 0)) {
 		LOG_ERR("length %u is too long for res instance %d data",
-			len, path.res_id);
+			len, handle->res_id);
 		return -ENOMEM;
 	}
 
@@ -1581,12 +1670,32 @@ static int lwm2m_engine_set(char *pathstr, void *value, uint16_t len)
 	}
 
 	if (changed) {
+		path.obj_id = handle->obj_id;
+		path.obj_inst_id = handle->obj_inst_id;
+		path.res_id = handle->res_id;
+		path.res_inst_id = handle->res_inst_id;
+		path.level = 4U;
 		NOTIFY_OBSERVER_PATH(&path);
 	}
 
 	return ret;
 }
 
+static int lwm2m_engine_set(char *pathstr, void *value, uint16_t len)
+{
+	struct lwm2m_res_handle handle;
+	int ret;
+
+	LOG_DBG("path:%s, value:%p, len:%d", log_strdup(pathstr), value, len);
+
+	ret = path_to_res_handle(pathstr, &handle);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return engine_set_res(&handle, value, len);
+}
+
 int lwm2m_engine_set_opaque(char *pathstr, char *data_ptr, uint16_t data_len)
 {
 	return lwm2m_engine_set(pathstr, data_ptr, data_len);
@@ -1697,41 +1806,16 @@ int lwm2m_engine_get_res_data(char *pathstr, void **data_ptr, uint16_t *data_len
 	return 0;
 }
 
-static int lwm2m_engine_get(char *pathstr, void *buf, uint16_t buflen)
+static int engine_get_res(const struct lwm2m_res_handle *handle,
+			  void *buf, uint16_t buflen)
 {
-	int ret = 0;
-	struct lwm2m_obj_path path;
-	struct lwm2m_engine_obj_inst *obj_inst;
-	struct lwm2m_engine_obj_field *obj_field;
-	struct lwm2m_engine_res *res = NULL;
-	struct lwm2m_engine_res_inst *res_inst = NULL;
+	struct lwm2m_engine_obj_inst *obj_inst = handle->obj_inst;
+	struct lwm2m_engine_obj_field *obj_field = handle->obj_field;
+	struct lwm2m_engine_res *res = handle->res;
+	struct lwm2m_engine_res_inst *res_inst = handle->res_inst;
 	void *data_ptr = NULL;
 	size_t data_len = 0;
 
-	LOG_DBG("path:%s, buf:%p, buflen:%d", log_strdup(pathstr), buf, buflen);
-
-	/* translate path -> path_obj */
-	ret = string_to_path(pathstr, &path, '/');
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (path.level < 3) {
-		LOG_ERR("path must have at least 3 parts");
-		return -EINVAL;
-	}
-
-	/* look up resource obj */
-	ret = path_to_objs(&path, &obj_inst, &obj_field, &res, &res_inst);
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (!res_inst) {
-		LOG_ERR("res instance %d not found", path.res_inst_id);
-		return -ENOENT;
-	}
-
 	/* setup initial data elements */
 	data_ptr = res_inst->data_ptr;
 	data_len = res_inst->data_len;
@@ -1827,6 +1911,21 @@ static int lwm2m_engine_get(char *pathstr, void *buf, uint16_t buflen)
 	return 0;
 }
 
+static int lwm2m_engine_get(char *pathstr, void *buf, uint16_t buflen)
+{
+	struct lwm2m_res_handle handle;
+	int ret;
+
+	LOG_DBG("path:%s, buf:%p, buflen:%d", log_strdup(pathstr), buf, buflen);
+
+	ret = path_to_res_handle(pathstr, &handle);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return engine_get_res(&handle, buf, buflen);
+}
+
 int lwm2m_engine_get_opaque(char *pathstr, void *buf, uint16_t buflen)
 {
 	return lwm2m_engine_get(pathstr, buf, buflen);
@@ -1905,6 +2004,213 @@ int lwm2m_engine_get_objlnk(char *pathstr, struct lwm2m_objlnk *buf)
 	return lwm2m_engine_get(pathstr, buf, sizeof(struct lwm2m_objlnk));
 }
 
+/* resolved resource handles */
+
+int lwm2m_engine_get_res_handle(char *pathstr, struct lwm2m_res_handle *handle)
+{
+	int ret;
+
+	if (!handle) {
+		return -EINVAL;
+	}
+
+	ret = path_to_res_handle(pathstr, handle);
+	if (ret < 0) {
+		(void)memset(handle, 0, sizeof(*handle));
+	}
+
+	return ret;
+}
+
+static int res_handle_set(struct lwm2m_res_handle *handle, void *value,
+			  uint16_t len)
+{
+	int ret;
+
+	ret = res_handle_check(handle);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return engine_set_res(handle, value, len);
+}
+
+static int res_handle_get(struct lwm2m_res_handle *handle, void *buf,
+			  uint16_t buflen)
+{
+	int ret;
+
+	ret = res_handle_check(handle);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return engine_get_res(handle, buf, buflen);
+}
+
+int lwm2m_engine_handle_set_opaque(struct lwm2m_res_handle *handle,
+				   char *data_ptr, uint16_t data_len)
+{
+	return res_handle_set(handle, data_ptr, data_len);
+}
+
+int lwm2m_engine_handle_set_string(struct lwm2m_res_handle *handle,
+				   char *data_ptr)
+{
+	return res_handle_set(handle, data_ptr, strlen(data_ptr));
+}
+
+int lwm2m_engine_handle_set_u8(struct lwm2m_res_handle *handle, uint8_t value)
+{
+	return res_handle_set(handle, &value, 1);
+}
+
+int lwm2m_engine_handle_set_u16(struct lwm2m_res_handle *handle, uint16_t value)
+{
+	return res_handle_set(handle, &value, 2);
+}
+
+int lwm2m_engine_handle_set_u32(struct lwm2m_res_handle *handle, uint32_t value)
+{
+	return res_handle_set(handle, &value, 4);
+}
+
+int lwm2m_engine_handle_set_u64(struct lwm2m_res_handle *handle, uint64_t value)
+{
+	return res_handle_set(handle, &value, 8);
+}
+
+int lwm2m_engine_handle_set_s8(struct lwm2m_res_handle *handle, int8_t value)
+{
+	return res_handle_set(handle, &value, 1);
+}
+
+int lwm2m_engine_handle_set_s16(struct lwm2m_res_handle *handle, int16_t value)
+{
+	return res_handle_set(handle, &value, 2);
+}
+
+int lwm2m_engine_handle_set_s32(struct lwm2m_res_handle *handle, int32_t value)
+{
+	return res_handle_set(handle, &value, 4);
+}
+
+int lwm2m_engine_handle_set_s64(struct lwm2m_res_handle *handle, int64_t value)
+{
+	return res_handle_set(handle, &value, 8);
+}
+
+int lwm2m_engine_handle_set_bool(struct lwm2m_res_handle *handle, bool value)
+{
+	uint8_t temp = (value != 0 ? 1 : 0);
+
+	return res_handle_set(handle, &temp, 1);
+}
+
+int lwm2m_engine_handle_set_float32(struct lwm2m_res_handle *handle,
+				    float32_value_t *value)
+{
+	return res_handle_set(handle, value, sizeof(float32_value_t));
+}
+
+int lwm2m_engine_handle_set_float64(struct lwm2m_res_handle *handle,
+				    float64_value_t *value)
+{
+	return res_handle_set(handle, value, sizeof(float64_value_t));
+}
+
+int lwm2m_engine_handle_set_objlnk(struct lwm2m_res_handle *handle,
+				   struct lwm2m_objlnk *value)
+{
+	return res_handle_set(handle, value, sizeof(struct lwm2m_objlnk));
+}
+
+int lwm2m_engine_handle_get_opaque(struct lwm2m_res_handle *handle,
+				   void *buf, uint16_t buflen)
+{
+	return res_handle_get(handle, buf, buflen);
+}
+
+int lwm2m_engine_handle_get_string(struct lwm2m_res_handle *handle,
+				   void *buf, uint16_t buflen)
+{
+	return res_handle_get(handle, buf, buflen);
+}
+
+int lwm2m_engine_handle_get_u8(struct lwm2m_res_handle *handle, uint8_t *value)
+{
+	return res_handle_get(handle, value, 1);
+}
+
+int lwm2m_engine_handle_get_u16(struct lwm2m_res_handle *handle,
+				uint16_t *value)
+{
+	return res_handle_get(handle, value, 2);
+}
+
+int lwm2m_engine_handle_get_u32(struct lwm2m_res_handle *handle,
+				uint32_t *value)
+{
+	return res_handle_get(handle, value, 4);
+}
+
+int lwm2m_engine_handle_get_u64(struct lwm2m_res_handle *handle,
+				uint64_t *value)
+{
+	return res_handle_get(handle, value, 8);
+}
+
+int lwm2m_engine_handle_get_s8(struct lwm2m_res_handle *handle, int8_t *value)
+{
+	return res_handle_get(handle, value, 1);
+}
+
+int lwm2m_engine_handle_get_s16(struct lwm2m_res_handle *handle, int16_t *value)
+{
+	return res_handle_get(handle, value, 2);
+}
+
+int lwm2m_engine_handle_get_s32(struct lwm2m_res_handle *handle, int32_t *value)
+{
+	return res_handle_get(handle, value, 4);
+}
+
+int lwm2m_engine_handle_get_s64(struct lwm2m_res_handle *handle, int64_t *value)
+{
+	return res_handle_get(handle, value, 8);
+}
+
+int lwm2m_engine_handle_get_bool(struct lwm2m_res_handle *handle, bool *value)
+{
+	int ret = 0;
+	int8_t temp = 0;
+
+	ret = res_handle_get(handle, &temp, 1);
+	if (!ret) {
+		*value = temp != 0;
+	}
+
+	return ret;
+}
+
+int lwm2m_engine_handle_get_float32(struct lwm2m_res_handle *handle,
+				    float32_value_t *buf)
+{
+	return res_handle_get(handle, buf, sizeof(float32_value_t));
+}
+
+int lwm2m_engine_handle_get_float64(struct lwm2m_res_handle *handle,
+				    float64_value_t *buf)
+{
+	return res_handle_get(handle, buf, sizeof(float64_value_t));
+}
+
+int lwm2m_engine_handle_get_objlnk(struct lwm2m_res_handle *handle,
+				   struct lwm2m_objlnk *buf)
+{
+	return res_handle_get(handle, buf, sizeof(struct lwm2m_objlnk));
+}
+
 int lwm2m_engine_get_resource(char *pathstr, struct lwm2m_engine_res **res)
 {
 	int ret;
@@ -2907,6 +3213,12 @@ static int do_read_op(struct lwm2m_message *msg, uint16_t content_format)
 		return do_read_op_json(msg, content_format);
 #endif
 
+#if defined(CONFIG_LWM2M_RW_CBOR_SUPPORT)
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+	case LWM2M_FORMAT_OMA_CBOR:
+		return do_read_op_cbor(msg, content_format);
+#endif
+
 	default:
 		LOG_ERR("Unsupported content-format: %u", content_format);
 		return -ENOMSG;
@@ -3336,6 +3648,14 @@ static int do_write_op(struct lwm2m_message *msg,
 		return do_write_op_json(msg);
 #endif
 
+#ifdef CONFIG_LWM2M_RW_CBOR_SUPPORT
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+		return do_write_op_senml_cbor(msg);
+
+	case LWM2M_FORMAT_OMA_CBOR:
+		return do_write_op_lwm2m_cbor(msg);
+#endif
+
 	default:
 		LOG_ERR("Unsupported format: %u", format);
 		return -ENOMSG;
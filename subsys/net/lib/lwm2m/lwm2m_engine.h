@@ -18,12 +18,14 @@
 #define LWM2M_FORMAT_APP_OCTET_STREAM	42
 #define LWM2M_FORMAT_APP_EXI		47
 #define LWM2M_FORMAT_APP_JSON		50
+#define LWM2M_FORMAT_APP_SENML_CBOR	112
 #define LWM2M_FORMAT_OMA_PLAIN_TEXT	1541
 #define LWM2M_FORMAT_OMA_OLD_TLV	1542
 #define LWM2M_FORMAT_OMA_OLD_JSON	1543
 #define LWM2M_FORMAT_OMA_OLD_OPAQUE	1544
 #define LWM2M_FORMAT_OMA_TLV		11542
 #define LWM2M_FORMAT_OMA_JSON		11543
+#define LWM2M_FORMAT_OMA_CBOR		11544
 /* 65000 ~ 65535 inclusive are reserved for experiments */
 #define LWM2M_FORMAT_NONE		65535
 
@@ -0,0 +1,1473 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * SenML-CBOR (RFC 8428) and LwM2M-CBOR (LwM2M 1.2 TS Core 7.4.6)
+ * content formats.
+ *
+ * The writers encode the CBOR items straight into the outgoing CoAP
+ * packet, there is no intermediate document. As the number of records
+ * or resources is not known when a container is started, arrays and
+ * maps are written with indefinite length and closed with a break.
+ *
+ * Both formats carry the values as plain CBOR data items so they share
+ * a single reader, the write operations only differ in how the paths
+ * are found.
+ */
+
+#define LOG_MODULE_NAME net_lwm2m_cbor
+#define LOG_LEVEL CONFIG_LWM2M_LOG_LEVEL
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(LOG_MODULE_NAME);
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <sys/byteorder.h>
+
+#include "lwm2m_object.h"
+#include "lwm2m_rw_cbor.h"
+#include "lwm2m_engine.h"
+
+/* major types, RFC 7049 ch 2.1 */
+#define CBOR_MT_UINT		0
+#define CBOR_MT_NINT		1
+#define CBOR_MT_BSTR		2
+#define CBOR_MT_TSTR		3
+#define CBOR_MT_ARRAY		4
+#define CBOR_MT_MAP		5
+#define CBOR_MT_TAG		6
+#define CBOR_MT_SIMPLE		7
+
+/* additional information */
+#define CBOR_AI_UINT8		24
+#define CBOR_AI_UINT16		25
+#define CBOR_AI_UINT32		26
+#define CBOR_AI_UINT64		27
+#define CBOR_AI_INDEFINITE	31
+
+#define CBOR_HEAD(mt, ai)	(((mt) << 5) | (ai))
+
+#define CBOR_FALSE		CBOR_HEAD(CBOR_MT_SIMPLE, 20)
+#define CBOR_TRUE		CBOR_HEAD(CBOR_MT_SIMPLE, 21)
+#define CBOR_FLOAT16		CBOR_AI_UINT16
+#define CBOR_FLOAT32		CBOR_AI_UINT32
+#define CBOR_FLOAT64		CBOR_AI_UINT64
+#define CBOR_BREAK		CBOR_HEAD(CBOR_MT_SIMPLE, CBOR_AI_INDEFINITE)
+
+/* nesting accepted when skipping unknown items */
+#define CBOR_MAX_DEPTH		8
+
+/* SenML labels, RFC 8428 ch 6 */
+#define SENML_LABEL_BN		-2
+#define SENML_LABEL_N		0
+#define SENML_LABEL_V		2
+#define SENML_LABEL_VS		3
+#define SENML_LABEL_VB		4
+#define SENML_LABEL_VD		8
+/* object link value, LwM2M TS Core 7.4.5 */
+#define SENML_LABEL_VLO		"vlo"
+
+#define NAME_BUF_LEN		sizeof("/65535/65535/65535/65535/")
+#define OBJLNK_BUF_LEN		sizeof("65535:65535")
+
+struct cbor_out_formatter_data {
+	/* flags */
+	uint8_t writer_flags;
+
+	/* SenML base name is still to be written */
+	bool base_name;
+
+	/* first encoding error, returned by do_read_op_cbor() */
+	int error;
+};
+
+/* encoder */
+
+/*
+ * The writers can only return the number of bytes written, so a failure
+ * is kept in the formatter data. Nothing is written after it, a partial
+ * document would still be valid CBOR with the wrong content.
+ */
+static size_t cbor_put_raw(struct lwm2m_output_context *out,
+			   uint8_t *buf, size_t buflen)
+{
+	struct cbor_out_formatter_data *fd;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd || fd->error) {
+		return 0;
+	}
+
+	if (buflen > UINT16_MAX ||
+	    buf_append(CPKT_BUF_WRITE(out->out_cpkt), buf, buflen) < 0) {
+		fd->error = -ENOMEM;
+		return 0;
+	}
+
+	return buflen;
+}
+
+static size_t cbor_put_byte(struct lwm2m_output_context *out, uint8_t value)
+{
+	return cbor_put_raw(out, &value, sizeof(value));
+}
+
+static size_t cbor_put_head(struct lwm2m_output_context *out,
+			    uint8_t mt, uint64_t value)
+{
+	uint8_t buf[9];
+	size_t len;
+
+	if (value < CBOR_AI_UINT8) {
+		buf[0] = CBOR_HEAD(mt, value);
+		len = 1;
+	} else if (value <= UINT8_MAX) {
+		buf[0] = CBOR_HEAD(mt, CBOR_AI_UINT8);
+		buf[1] = value;
+		len = 2;
+	} else if (value <= UINT16_MAX) {
+		buf[0] = CBOR_HEAD(mt, CBOR_AI_UINT16);
+		sys_put_be16(value, &buf[1]);
+		len = 3;
+	} else if (value <= UINT32_MAX) {
+		buf[0] = CBOR_HEAD(mt, CBOR_AI_UINT32);
+		sys_put_be32(value, &buf[1]);
+		len = 5;
+	} else {
+		buf[0] = CBOR_HEAD(mt, CBOR_AI_UINT64);
+		sys_put_be64(value, &buf[1]);
+		len = 9;
+	}
+
+	return cbor_put_raw(out, buf, len);
+}
+
+static size_t cbor_put_int(struct lwm2m_output_context *out, int64_t value)
+{
+	if (value < 0) {
+		/* -1 - value, without overflowing on INT64_MIN */
+		return cbor_put_head(out, CBOR_MT_NINT, ~(uint64_t)value);
+	}
+
+	return cbor_put_head(out, CBOR_MT_UINT, value);
+}
+
+static size_t cbor_put_str(struct lwm2m_output_context *out, uint8_t mt,
+			   const void *buf, size_t buflen)
+{
+	size_t len;
+
+	len = cbor_put_head(out, mt, buflen);
+	if (len == 0) {
+		return 0;
+	}
+
+	if (buflen > 0 && cbor_put_raw(out, (uint8_t *)buf, buflen) == 0) {
+		return 0;
+	}
+
+	return len + buflen;
+}
+
+static size_t cbor_put_double(struct lwm2m_output_context *out, double value)
+{
+	uint8_t buf[9];
+	float single = (float)value;
+	uint64_t u64;
+	uint32_t u32;
+
+	/* use the shortest encoding that keeps the value */
+	if ((double)single == value) {
+		memcpy(&u32, &single, sizeof(u32));
+		buf[0] = CBOR_HEAD(CBOR_MT_SIMPLE, CBOR_FLOAT32);
+		sys_put_be32(u32, &buf[1]);
+		return cbor_put_raw(out, buf, 5);
+	}
+
+	memcpy(&u64, &value, sizeof(u64));
+	buf[0] = CBOR_HEAD(CBOR_MT_SIMPLE, CBOR_FLOAT64);
+	sys_put_be64(u64, &buf[1]);
+	return cbor_put_raw(out, buf, 9);
+}
+
+/*
+ * val2 holds the fraction in 1/dec_max units, it only carries the sign
+ * when val1 is 0.
+ */
+static size_t cbor_put_fix(struct lwm2m_output_context *out,
+			   int64_t val1, int64_t val2, int64_t dec_max)
+{
+	double value;
+
+	if (val2 == 0) {
+		return cbor_put_int(out, val1);
+	}
+
+	value = (double)(val2 < 0 ? -val2 : val2) / dec_max;
+	if (val1 < 0 || (val1 == 0 && val2 < 0)) {
+		value = (double)val1 - value;
+	} else {
+		value = (double)val1 + value;
+	}
+
+	return cbor_put_double(out, value);
+}
+
+static size_t cbor_put_objlnk(struct lwm2m_output_context *out,
+			      struct lwm2m_objlnk *value)
+{
+	char buf[OBJLNK_BUF_LEN];
+	int len;
+
+	len = snprintk(buf, sizeof(buf), "%u:%u", value->obj_id,
+		       value->obj_inst);
+	if (len < 0) {
+		return 0;
+	}
+
+	return cbor_put_str(out, CBOR_MT_TSTR, buf, len);
+}
+
+static size_t put_end(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path)
+{
+	return cbor_put_byte(out, CBOR_BREAK);
+}
+
+/* SenML-CBOR writer */
+
+static size_t senml_put_begin(struct lwm2m_output_context *out,
+			      struct lwm2m_obj_path *path)
+{
+	struct cbor_out_formatter_data *fd;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	fd->base_name = true;
+
+	return cbor_put_byte(out, CBOR_HEAD(CBOR_MT_ARRAY, CBOR_AI_INDEFINITE));
+}
+
+static size_t senml_put_begin_ri(struct lwm2m_output_context *out,
+				 struct lwm2m_obj_path *path)
+{
+	struct cbor_out_formatter_data *fd;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	fd->writer_flags |= WRITER_RESOURCE_INSTANCE;
+	return 0;
+}
+
+/* Also used as put_end_r, see lwm2m_cbor_put_end_ri() */
+static size_t senml_put_end_ri(struct lwm2m_output_context *out,
+			       struct lwm2m_obj_path *path)
+{
+	struct cbor_out_formatter_data *fd;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	fd->writer_flags &= ~WRITER_RESOURCE_INSTANCE;
+	return 0;
+}
+
+/*
+ * Starts a record: the base name goes in the first record only, the
+ * name is relative to it. The caller adds the value label and value.
+ */
+static size_t senml_put_prefix(struct lwm2m_output_context *out,
+			       struct lwm2m_obj_path *path)
+{
+	struct cbor_out_formatter_data *fd;
+	char name[NAME_BUF_LEN];
+	size_t len;
+	int ret;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	len = cbor_put_head(out, CBOR_MT_MAP, fd->base_name ? 3 : 2);
+
+	if (fd->base_name) {
+		if (path->level >= 2U) {
+			ret = snprintk(name, sizeof(name), "/%u/%u/",
+				       path->obj_id, path->obj_inst_id);
+		} else {
+			ret = snprintk(name, sizeof(name), "/%u/",
+				       path->obj_id);
+		}
+
+		if (ret < 0) {
+			return 0;
+		}
+
+		len += cbor_put_int(out, SENML_LABEL_BN);
+		len += cbor_put_str(out, CBOR_MT_TSTR, name, ret);
+		fd->base_name = false;
+	}
+
+	if (path->level >= 2U) {
+		if (fd->writer_flags & WRITER_RESOURCE_INSTANCE) {
+			ret = snprintk(name, sizeof(name), "%u/%u",
+				       path->res_id, path->res_inst_id);
+		} else {
+			ret = snprintk(name, sizeof(name), "%u",
+				       path->res_id);
+		}
+	} else {
+		if (fd->writer_flags & WRITER_RESOURCE_INSTANCE) {
+			ret = snprintk(name, sizeof(name), "%u/%u/%u",
+				       path->obj_inst_id, path->res_id,
+				       path->res_inst_id);
+		} else {
+			ret = snprintk(name, sizeof(name), "%u/%u",
+				       path->obj_inst_id, path->res_id);
+		}
+	}
+
+	if (ret < 0) {
+		return 0;
+	}
+
+	len += cbor_put_int(out, SENML_LABEL_N);
+	len += cbor_put_str(out, CBOR_MT_TSTR, name, ret);
+	return len;
+}
+
+static size_t senml_put_s64(struct lwm2m_output_context *out,
+			    struct lwm2m_obj_path *path, int64_t value)
+{
+	size_t len;
+
+	len = senml_put_prefix(out, path);
+	len += cbor_put_int(out, SENML_LABEL_V);
+	len += cbor_put_int(out, value);
+	return len;
+}
+
+static size_t senml_put_s32(struct lwm2m_output_context *out,
+			    struct lwm2m_obj_path *path, int32_t value)
+{
+	return senml_put_s64(out, path, value);
+}
+
+static size_t senml_put_s16(struct lwm2m_output_context *out,
+			    struct lwm2m_obj_path *path, int16_t value)
+{
+	return senml_put_s64(out, path, value);
+}
+
+static size_t senml_put_s8(struct lwm2m_output_context *out,
+			   struct lwm2m_obj_path *path, int8_t value)
+{
+	return senml_put_s64(out, path, value);
+}
+
+static size_t senml_put_string(struct lwm2m_output_context *out,
+			       struct lwm2m_obj_path *path,
+			       char *buf, size_t buflen)
+{
+	size_t len;
+
+	len = senml_put_prefix(out, path);
+	len += cbor_put_int(out, SENML_LABEL_VS);
+	len += cbor_put_str(out, CBOR_MT_TSTR, buf, buflen);
+	return len;
+}
+
+static size_t senml_put_float32fix(struct lwm2m_output_context *out,
+				   struct lwm2m_obj_path *path,
+				   float32_value_t *value)
+{
+	size_t len;
+
+	len = senml_put_prefix(out, path);
+	len += cbor_put_int(out, SENML_LABEL_V);
+	len += cbor_put_fix(out, value->val1, value->val2,
+			    LWM2M_FLOAT32_DEC_MAX);
+	return len;
+}
+
+static size_t senml_put_float64fix(struct lwm2m_output_context *out,
+				   struct lwm2m_obj_path *path,
+				   float64_value_t *value)
+{
+	size_t len;
+
+	len = senml_put_prefix(out, path);
+	len += cbor_put_int(out, SENML_LABEL_V);
+	len += cbor_put_fix(out, value->val1, value->val2,
+			    LWM2M_FLOAT64_DEC_MAX);
+	return len;
+}
+
+static size_t senml_put_bool(struct lwm2m_output_context *out,
+			     struct lwm2m_obj_path *path, bool value)
+{
+	size_t len;
+
+	len = senml_put_prefix(out, path);
+	len += cbor_put_int(out, SENML_LABEL_VB);
+	len += cbor_put_byte(out, value ? CBOR_TRUE : CBOR_FALSE);
+	return len;
+}
+
+static size_t senml_put_opaque(struct lwm2m_output_context *out,
+			       struct lwm2m_obj_path *path,
+			       char *buf, size_t buflen)
+{
+	size_t len;
+
+	len = senml_put_prefix(out, path);
+	len += cbor_put_int(out, SENML_LABEL_VD);
+	len += cbor_put_str(out, CBOR_MT_BSTR, buf, buflen);
+	return len;
+}
+
+static size_t senml_put_objlnk(struct lwm2m_output_context *out,
+			       struct lwm2m_obj_path *path,
+			       struct lwm2m_objlnk *value)
+{
+	size_t len;
+
+	len = senml_put_prefix(out, path);
+	len += cbor_put_str(out, CBOR_MT_TSTR, SENML_LABEL_VLO,
+			    sizeof(SENML_LABEL_VLO) - 1);
+	len += cbor_put_objlnk(out, value);
+	return len;
+}
+
+const struct lwm2m_writer senml_cbor_writer = {
+	.put_begin = senml_put_begin,
+	.put_end = put_end,
+	.put_end_r = senml_put_end_ri,
+	.put_begin_ri = senml_put_begin_ri,
+	.put_end_ri = senml_put_end_ri,
+	.put_s8 = senml_put_s8,
+	.put_s16 = senml_put_s16,
+	.put_s32 = senml_put_s32,
+	.put_s64 = senml_put_s64,
+	.put_string = senml_put_string,
+	.put_float32fix = senml_put_float32fix,
+	.put_float64fix = senml_put_float64fix,
+	.put_bool = senml_put_bool,
+	.put_opaque = senml_put_opaque,
+	.put_objlnk = senml_put_objlnk,
+};
+
+/*
+ * LwM2M-CBOR writer
+ *
+ * The payload is a tree of maps keyed by the path elements, e.g. a read
+ * of /3 gives {3: {0: {0: "Zephyr", 7: {0: 3800, 1: 5000}, ...}}}. The
+ * root key is [obj, inst] when a single instance is read.
+ */
+
+static size_t lwm2m_cbor_put_begin(struct lwm2m_output_context *out,
+				   struct lwm2m_obj_path *path)
+{
+	size_t len;
+
+	len = cbor_put_head(out, CBOR_MT_MAP, 1);
+
+	if (path->level >= 2U) {
+		len += cbor_put_head(out, CBOR_MT_ARRAY, 2);
+		len += cbor_put_int(out, path->obj_id);
+		len += cbor_put_int(out, path->obj_inst_id);
+	} else {
+		len += cbor_put_int(out, path->obj_id);
+	}
+
+	len += cbor_put_byte(out, CBOR_HEAD(CBOR_MT_MAP, CBOR_AI_INDEFINITE));
+	return len;
+}
+
+static size_t lwm2m_cbor_put_begin_oi(struct lwm2m_output_context *out,
+				      struct lwm2m_obj_path *path)
+{
+	size_t len;
+
+	len = cbor_put_int(out, path->obj_inst_id);
+	len += cbor_put_byte(out, CBOR_HEAD(CBOR_MT_MAP, CBOR_AI_INDEFINITE));
+	return len;
+}
+
+static size_t lwm2m_cbor_put_begin_ri(struct lwm2m_output_context *out,
+				      struct lwm2m_obj_path *path)
+{
+	struct cbor_out_formatter_data *fd;
+	size_t len;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	len = cbor_put_int(out, path->res_id);
+	len += cbor_put_byte(out, CBOR_HEAD(CBOR_MT_MAP, CBOR_AI_INDEFINITE));
+	fd->writer_flags |= WRITER_RESOURCE_INSTANCE;
+	return len;
+}
+
+/*
+ * Also used as put_end_r: the engine does not call put_end_ri when the
+ * read of a resource instance fails, the map has to be closed anyway.
+ */
+static size_t lwm2m_cbor_put_end_ri(struct lwm2m_output_context *out,
+				    struct lwm2m_obj_path *path)
+{
+	struct cbor_out_formatter_data *fd;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd || !(fd->writer_flags & WRITER_RESOURCE_INSTANCE)) {
+		return 0;
+	}
+
+	fd->writer_flags &= ~WRITER_RESOURCE_INSTANCE;
+	return cbor_put_byte(out, CBOR_BREAK);
+}
+
+static size_t lwm2m_cbor_put_key(struct lwm2m_output_context *out,
+				 struct lwm2m_obj_path *path)
+{
+	struct cbor_out_formatter_data *fd;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	if (fd->writer_flags & WRITER_RESOURCE_INSTANCE) {
+		return cbor_put_int(out, path->res_inst_id);
+	}
+
+	return cbor_put_int(out, path->res_id);
+}
+
+static size_t lwm2m_cbor_put_s64(struct lwm2m_output_context *out,
+				 struct lwm2m_obj_path *path, int64_t value)
+{
+	size_t len;
+
+	len = lwm2m_cbor_put_key(out, path);
+	len += cbor_put_int(out, value);
+	return len;
+}
+
+static size_t lwm2m_cbor_put_s32(struct lwm2m_output_context *out,
+				 struct lwm2m_obj_path *path, int32_t value)
+{
+	return lwm2m_cbor_put_s64(out, path, value);
+}
+
+static size_t lwm2m_cbor_put_s16(struct lwm2m_output_context *out,
+				 struct lwm2m_obj_path *path, int16_t value)
+{
+	return lwm2m_cbor_put_s64(out, path, value);
+}
+
+static size_t lwm2m_cbor_put_s8(struct lwm2m_output_context *out,
+				struct lwm2m_obj_path *path, int8_t value)
+{
+	return lwm2m_cbor_put_s64(out, path, value);
+}
+
+static size_t lwm2m_cbor_put_string(struct lwm2m_output_context *out,
+				    struct lwm2m_obj_path *path,
+				    char *buf, size_t buflen)
+{
+	size_t len;
+
+	len = lwm2m_cbor_put_key(out, path);
+	len += cbor_put_str(out, CBOR_MT_TSTR, buf, buflen);
+	return len;
+}
+
+static size_t lwm2m_cbor_put_float32fix(struct lwm2m_output_context *out,
+					struct lwm2m_obj_path *path,
+					float32_value_t *value)
+{
+	size_t len;
+
+	len = lwm2m_cbor_put_key(out, path);
+	len += cbor_put_fix(out, value->val1, value->val2,
+			    LWM2M_FLOAT32_DEC_MAX);
+	return len;
+}
+
+static size_t lwm2m_cbor_put_float64fix(struct lwm2m_output_context *out,
+					struct lwm2m_obj_path *path,
+					float64_value_t *value)
+{
+	size_t len;
+
+	len = lwm2m_cbor_put_key(out, path);
+	len += cbor_put_fix(out, value->val1, value->val2,
+			    LWM2M_FLOAT64_DEC_MAX);
+	return len;
+}
+
+static size_t lwm2m_cbor_put_bool(struct lwm2m_output_context *out,
+				  struct lwm2m_obj_path *path, bool value)
+{
+	size_t len;
+
+	len = lwm2m_cbor_put_key(out, path);
+	len += cbor_put_byte(out, value ? CBOR_TRUE : CBOR_FALSE);
+	return len;
+}
+
+static size_t lwm2m_cbor_put_opaque(struct lwm2m_output_context *out,
+				    struct lwm2m_obj_path *path,
+				    char *buf, size_t buflen)
+{
+	size_t len;
+
+	len = lwm2m_cbor_put_key(out, path);
+	len += cbor_put_str(out, CBOR_MT_BSTR, buf, buflen);
+	return len;
+}
+
+static size_t lwm2m_cbor_put_objlnk(struct lwm2m_output_context *out,
+				    struct lwm2m_obj_path *path,
+				    struct lwm2m_objlnk *value)
+{
+	size_t len;
+
+	len = lwm2m_cbor_put_key(out, path);
+	len += cbor_put_objlnk(out, value);
+	return len;
+}
+
+const struct lwm2m_writer lwm2m_cbor_writer = {
+	.put_begin = lwm2m_cbor_put_begin,
+	.put_end = put_end,
+	.put_begin_oi = lwm2m_cbor_put_begin_oi,
+	.put_end_oi = put_end,
+	.put_end_r = lwm2m_cbor_put_end_ri,
+	.put_begin_ri = lwm2m_cbor_put_begin_ri,
+	.put_end_ri = lwm2m_cbor_put_end_ri,
+	.put_s8 = lwm2m_cbor_put_s8,
+	.put_s16 = lwm2m_cbor_put_s16,
+	.put_s32 = lwm2m_cbor_put_s32,
+	.put_s64 = lwm2m_cbor_put_s64,
+	.put_string = lwm2m_cbor_put_string,
+	.put_float32fix = lwm2m_cbor_put_float32fix,
+	.put_float64fix = lwm2m_cbor_put_float64fix,
+	.put_bool = lwm2m_cbor_put_bool,
+	.put_opaque = lwm2m_cbor_put_opaque,
+	.put_objlnk = lwm2m_cbor_put_objlnk,
+};
+
+/* decoder */
+
+/*
+ * Reads the head of the item at offset. Returns the major type, the
+ * additional information and the argument, or a negative error.
+ */
+static int cbor_get_head(struct coap_packet *cpkt, uint16_t *offset,
+			 uint8_t *ai, uint64_t *value)
+{
+	uint8_t buf[8];
+	uint8_t head;
+	int i, len;
+
+	if (buf_read_u8(&head, CPKT_BUF_READ(cpkt), offset) < 0) {
+		return -EINVAL;
+	}
+
+	*ai = head & 0x1f;
+	*value = 0U;
+
+	if (*ai < CBOR_AI_UINT8) {
+		*value = *ai;
+		return head >> 5;
+	}
+
+	if (*ai == CBOR_AI_INDEFINITE) {
+		return head >> 5;
+	}
+
+	if (*ai > CBOR_AI_UINT64) {
+		return -EINVAL;
+	}
+
+	len = 1 << (*ai - CBOR_AI_UINT8);
+	if (buf_read(buf, len, CPKT_BUF_READ(cpkt), offset) < 0) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < len; i++) {
+		*value = (*value << 8) | buf[i];
+	}
+
+	return head >> 5;
+}
+
+/* Consumes the break ending an indefinite length item, if present */
+static bool cbor_get_break(struct coap_packet *cpkt, uint16_t *offset)
+{
+	if (*offset < cpkt->max_len && cpkt->data[*offset] == CBOR_BREAK) {
+		(*offset)++;
+		return true;
+	}
+
+	return false;
+}
+
+static int cbor_skip(struct coap_packet *cpkt, uint16_t *offset, int depth)
+{
+	uint64_t value, i;
+	uint8_t ai;
+	int mt, ret;
+
+	if (depth > CBOR_MAX_DEPTH) {
+		return -EINVAL;
+	}
+
+	mt = cbor_get_head(cpkt, offset, &ai, &value);
+	switch (mt) {
+
+	case CBOR_MT_UINT:
+	case CBOR_MT_NINT:
+		return 0;
+
+	case CBOR_MT_SIMPLE:
+		/* a break is only valid where cbor_get_break() looks for it */
+		return ai == CBOR_AI_INDEFINITE ? -EINVAL : 0;
+
+	case CBOR_MT_BSTR:
+	case CBOR_MT_TSTR:
+		/* chunked strings are not supported */
+		if (ai == CBOR_AI_INDEFINITE || value > UINT16_MAX) {
+			return -ENOTSUP;
+		}
+
+		return buf_skip(value, CPKT_BUF_READ(cpkt), offset);
+
+	case CBOR_MT_TAG:
+		return cbor_skip(cpkt, offset, depth + 1);
+
+	case CBOR_MT_ARRAY:
+	case CBOR_MT_MAP:
+		if (ai == CBOR_AI_INDEFINITE) {
+			while (!cbor_get_break(cpkt, offset)) {
+				ret = cbor_skip(cpkt, offset, depth + 1);
+				if (ret < 0) {
+					return ret;
+				}
+			}
+
+			return 0;
+		}
+
+		if (mt == CBOR_MT_MAP) {
+			value *= 2U;
+		}
+
+		for (i = 0; i < value; i++) {
+			ret = cbor_skip(cpkt, offset, depth + 1);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+
+		return 0;
+
+	default:
+		return mt;
+
+	}
+}
+
+static int cbor_get_str(struct coap_packet *cpkt, uint16_t *offset,
+			uint8_t mt, uint16_t *len)
+{
+	uint64_t value;
+	uint8_t ai;
+
+	if (cbor_get_head(cpkt, offset, &ai, &value) != mt ||
+	    ai == CBOR_AI_INDEFINITE ||
+	    value > cpkt->max_len - *offset) {
+		return -EINVAL;
+	}
+
+	*len = value;
+	return 0;
+}
+
+/* Copies a text string item, it is truncated to fit in buf */
+static int cbor_get_text(struct coap_packet *cpkt, uint16_t *offset,
+			 char *buf, size_t buflen)
+{
+	uint16_t len, copy;
+
+	if (cbor_get_str(cpkt, offset, CBOR_MT_TSTR, &len) < 0) {
+		return -EINVAL;
+	}
+
+	copy = MIN(len, buflen - 1);
+	memcpy(buf, cpkt->data + *offset, copy);
+	buf[copy] = '\0';
+	*offset += len;
+
+	return copy;
+}
+
+static int cbor_float_to_double(uint8_t ai, uint64_t value, double *d)
+{
+	uint32_t u32;
+	float single;
+	int exp, mant;
+
+	switch (ai) {
+
+	case CBOR_FLOAT64:
+		memcpy(d, &value, sizeof(*d));
+		break;
+
+	case CBOR_FLOAT32:
+		u32 = value;
+		memcpy(&single, &u32, sizeof(single));
+		*d = single;
+		break;
+
+	case CBOR_FLOAT16:
+		exp = (value >> 10) & 0x1f;
+		mant = value & 0x3ff;
+
+		if (exp == 0) {
+			/* subnormal, mant * 2^-24 */
+			*d = mant / 16777216.0;
+		} else if (exp < 25) {
+			*d = (double)(mant + 1024) / (1 << (25 - exp));
+		} else if (exp < 31) {
+			*d = (double)(mant + 1024) * (1 << (exp - 25));
+		} else {
+			/* infinity or NaN */
+			return -EINVAL;
+		}
+
+		if (value & 0x8000) {
+			*d = -*d;
+		}
+
+		break;
+
+	default:
+		return -EINVAL;
+
+	}
+
+	return 0;
+}
+
+/*
+ * Reads an integer or a floating point number as a fixed point value
+ * with a fraction in 1/dec_max units.
+ */
+static size_t cbor_get_number(struct lwm2m_input_context *in,
+			      int64_t *val1, int64_t *val2, int64_t dec_max)
+{
+	uint16_t start = in->offset;
+	uint64_t value;
+	int64_t frac;
+	uint8_t ai;
+	double d;
+
+	*val1 = 0;
+	*val2 = 0;
+
+	switch (cbor_get_head(in->in_cpkt, &in->offset, &ai, &value)) {
+
+	case CBOR_MT_UINT:
+		*val1 = value;
+		break;
+
+	case CBOR_MT_NINT:
+		if (value > INT64_MAX) {
+			goto error;
+		}
+
+		*val1 = (int64_t)~value;
+		break;
+
+	case CBOR_MT_SIMPLE:
+		/* also rejects NaN */
+		if (cbor_float_to_double(ai, value, &d) < 0 ||
+		    !(d > -9.2e18 && d < 9.2e18)) {
+			goto error;
+		}
+
+		*val1 = (int64_t)d;
+		frac = (int64_t)((d - *val1) * dec_max + (d < 0 ? -0.5 : 0.5));
+		if (frac >= dec_max || frac <= -dec_max) {
+			/* rounded up to the next integer */
+			*val1 += frac > 0 ? 1 : -1;
+			frac = 0;
+		}
+
+		if (*val1 != 0 && frac < 0) {
+			frac = -frac;
+		}
+
+		*val2 = frac;
+		break;
+
+	default:
+		goto error;
+
+	}
+
+	return in->offset - start;
+
+error:
+	in->offset = start;
+	return 0;
+}
+
+/* CBOR reader */
+
+static size_t get_s64(struct lwm2m_input_context *in, int64_t *value)
+{
+	int64_t frac;
+
+	return cbor_get_number(in, value, &frac, 1);
+}
+
+static size_t get_s32(struct lwm2m_input_context *in, int32_t *value)
+{
+	int64_t tmp, frac;
+	size_t len;
+
+	len = cbor_get_number(in, &tmp, &frac, 1);
+	if (len > 0) {
+		*value = (int32_t)tmp;
+	}
+
+	return len;
+}
+
+static size_t get_string(struct lwm2m_input_context *in,
+			 uint8_t *buf, size_t buflen)
+{
+	uint16_t start = in->offset;
+
+	if (buflen == 0 ||
+	    cbor_get_text(in->in_cpkt, &in->offset, (char *)buf,
+			  buflen) < 0) {
+		in->offset = start;
+		return 0;
+	}
+
+	return in->offset - start;
+}
+
+static size_t get_float32fix(struct lwm2m_input_context *in,
+			     float32_value_t *value)
+{
+	int64_t tmp1, tmp2;
+	size_t len;
+
+	len = cbor_get_number(in, &tmp1, &tmp2, LWM2M_FLOAT32_DEC_MAX);
+	if (len > 0) {
+		value->val1 = (int32_t)tmp1;
+		value->val2 = (int32_t)tmp2;
+	}
+
+	return len;
+}
+
+static size_t get_float64fix(struct lwm2m_input_context *in,
+			     float64_value_t *value)
+{
+	int64_t tmp1, tmp2;
+	size_t len;
+
+	len = cbor_get_number(in, &tmp1, &tmp2, LWM2M_FLOAT64_DEC_MAX);
+	if (len > 0) {
+		value->val1 = tmp1;
+		value->val2 = tmp2;
+	}
+
+	return len;
+}
+
+static size_t get_bool(struct lwm2m_input_context *in, bool *value)
+{
+	uint8_t head;
+
+	if (buf_read_u8(&head, CPKT_BUF_READ(in->in_cpkt), &in->offset) < 0) {
+		return 0;
+	}
+
+	if (head != CBOR_TRUE && head != CBOR_FALSE) {
+		in->offset--;
+		return 0;
+	}
+
+	*value = head == CBOR_TRUE;
+	return 1;
+}
+
+static size_t get_opaque(struct lwm2m_input_context *in,
+			 uint8_t *value, size_t buflen,
+			 struct lwm2m_opaque_context *opaque,
+			 bool *last_block)
+{
+	uint16_t len;
+
+	/* the byte string must be complete in this packet */
+	if (opaque->remaining == 0) {
+		if (cbor_get_str(in->in_cpkt, &in->offset, CBOR_MT_BSTR,
+				 &len) < 0) {
+			*last_block = true;
+			return 0;
+		}
+
+		opaque->len = len;
+		opaque->remaining = len;
+	}
+
+	return lwm2m_engine_get_opaque_more(in, value, buflen,
+					    opaque, last_block);
+}
+
+static size_t get_objlnk(struct lwm2m_input_context *in,
+			 struct lwm2m_objlnk *value)
+{
+	char buf[OBJLNK_BUF_LEN];
+	unsigned long obj_id, obj_inst;
+	uint16_t start = in->offset;
+	char *end;
+
+	if (cbor_get_text(in->in_cpkt, &in->offset, buf, sizeof(buf)) < 0) {
+		goto error;
+	}
+
+	obj_id = strtoul(buf, &end, 10);
+	if (*end != ':' || obj_id > UINT16_MAX) {
+		goto error;
+	}
+
+	obj_inst = strtoul(end + 1, &end, 10);
+	if (*end != '\0' || obj_inst > UINT16_MAX) {
+		goto error;
+	}
+
+	value->obj_id = obj_id;
+	value->obj_inst = obj_inst;
+	return in->offset - start;
+
+error:
+	in->offset = start;
+	return 0;
+}
+
+const struct lwm2m_reader cbor_reader = {
+	.get_s32 = get_s32,
+	.get_s64 = get_s64,
+	.get_string = get_string,
+	.get_float32fix = get_float32fix,
+	.get_float64fix = get_float64fix,
+	.get_bool = get_bool,
+	.get_opaque = get_opaque,
+	.get_objlnk = get_objlnk,
+};
+
+int do_read_op_cbor(struct lwm2m_message *msg, int content_format)
+{
+	struct cbor_out_formatter_data fd;
+	int ret;
+
+	(void)memset(&fd, 0, sizeof(fd));
+	engine_set_out_user_data(&msg->out, &fd);
+	ret = lwm2m_perform_read_op(msg, content_format);
+	engine_clear_out_user_data(&msg->out);
+
+	if (ret == 0 && fd.error < 0) {
+		LOG_ERR("CBOR payload does not fit the message");
+		return fd.error;
+	}
+
+	return ret;
+}
+
+static int path_set_id(struct lwm2m_obj_path *path, uint8_t level,
+		       uint64_t id)
+{
+	if (id > UINT16_MAX) {
+		return -EINVAL;
+	}
+
+	switch (level) {
+	case 0:
+		path->obj_id = id;
+		break;
+	case 1:
+		path->obj_inst_id = id;
+		break;
+	case 2:
+		path->res_id = id;
+		break;
+	case 3:
+		path->res_inst_id = id;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/*
+ * Writes the value found at value_offset to msg->path. Errors of the
+ * write handler are only returned on a single resource write.
+ */
+static int cbor_write_resource(struct lwm2m_message *msg,
+			       uint16_t value_offset, uint8_t orig_level)
+{
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_obj_inst *obj_inst = NULL;
+	struct lwm2m_engine_res *res = NULL;
+	struct lwm2m_engine_res_inst *res_inst = NULL;
+	uint8_t created = 0U;
+	int ret, index;
+
+	if (msg->path.level < 3U) {
+		return -EINVAL;
+	}
+
+	ret = lwm2m_get_or_create_engine_obj(msg, &obj_inst, &created);
+	if (ret < 0) {
+		return ret;
+	}
+
+	obj_field = lwm2m_get_engine_obj_field(obj_inst->obj,
+					       msg->path.res_id);
+	if (!obj_field) {
+		return -ENOENT;
+	}
+
+	if (!LWM2M_HAS_PERM(obj_field, LWM2M_PERM_W)) {
+		return -EPERM;
+	}
+
+	if (!obj_inst->resources || obj_inst->resource_count == 0U) {
+		return -EINVAL;
+	}
+
+	for (index = 0; index < obj_inst->resource_count; index++) {
+		if (obj_inst->resources[index].res_id == msg->path.res_id) {
+			res = &obj_inst->resources[index];
+			break;
+		}
+	}
+
+	if (!res) {
+		return -ENOENT;
+	}
+
+	for (index = 0; index < res->res_inst_count; index++) {
+		if (res->res_instances[index].res_inst_id ==
+		    msg->path.res_inst_id) {
+			res_inst = &res->res_instances[index];
+			break;
+		}
+	}
+
+	if (!res_inst) {
+		return -ENOENT;
+	}
+
+	msg->in.offset = value_offset;
+	ret = lwm2m_write_handler(obj_inst, res, res_inst, obj_field, msg);
+	if (ret < 0 && orig_level < 3U) {
+		/* ignore errors when writing several resources */
+		ret = 0;
+	}
+
+	return ret;
+}
+
+/* SenML-CBOR write */
+
+static int senml_parse_path(const char *name, struct lwm2m_obj_path *path)
+{
+	uint32_t val;
+	int level = 0;
+
+	(void)memset(path, 0, sizeof(*path));
+
+	if (*name == '/') {
+		name++;
+	}
+
+	while (*name) {
+		if (!isdigit((unsigned char)*name)) {
+			return -EINVAL;
+		}
+
+		val = 0U;
+		while (isdigit((unsigned char)*name)) {
+			val = val * 10U + (*name++ - '0');
+			if (val > UINT16_MAX) {
+				return -EINVAL;
+			}
+		}
+
+		if (path_set_id(path, level++, val) < 0) {
+			return -EINVAL;
+		}
+
+		if (*name == '/') {
+			name++;
+		} else if (*name) {
+			return -EINVAL;
+		}
+	}
+
+	return level;
+}
+
+/*
+ * Parses one record. The base name applies to the following records
+ * until it is replaced, value_offset is 0 when the record has no value.
+ */
+static int senml_get_record(struct coap_packet *cpkt, uint16_t *offset,
+			    char *base_name, char *name,
+			    uint16_t *value_offset)
+{
+	uint64_t count, i, key;
+	uint8_t ai, key_ai;
+	uint16_t len;
+	int mt, ret;
+
+	*value_offset = 0U;
+	name[0] = '\0';
+
+	if (cbor_get_head(cpkt, offset, &ai, &count) != CBOR_MT_MAP) {
+		return -EINVAL;
+	}
+
+	for (i = 0; ai == CBOR_AI_INDEFINITE || i < count; i++) {
+		if (ai == CBOR_AI_INDEFINITE && cbor_get_break(cpkt, offset)) {
+			break;
+		}
+
+		mt = cbor_get_head(cpkt, offset, &key_ai, &key);
+		if (mt == CBOR_MT_TSTR) {
+			/* "vlo" is the only text label we know */
+			len = key;
+			if (key > cpkt->max_len - *offset) {
+				return -EINVAL;
+			}
+
+			if (len == sizeof(SENML_LABEL_VLO) - 1 &&
+			    !memcmp(cpkt->data + *offset, SENML_LABEL_VLO,
+				    len)) {
+				*value_offset = *offset + len;
+			}
+
+			*offset += len;
+		} else if (mt == CBOR_MT_NINT && key == -SENML_LABEL_BN - 1) {
+			ret = cbor_get_text(cpkt, offset, base_name,
+					    NAME_BUF_LEN);
+			if (ret < 0) {
+				return ret;
+			}
+
+			continue;
+		} else if (mt == CBOR_MT_UINT && key == SENML_LABEL_N) {
+			ret = cbor_get_text(cpkt, offset, name, NAME_BUF_LEN);
+			if (ret < 0) {
+				return ret;
+			}
+
+			continue;
+		} else if (mt == CBOR_MT_UINT &&
+			   (key == SENML_LABEL_V || key == SENML_LABEL_VS ||
+			    key == SENML_LABEL_VB || key == SENML_LABEL_VD)) {
+			*value_offset = *offset;
+		} else if (mt != CBOR_MT_UINT && mt != CBOR_MT_NINT) {
+			return -EINVAL;
+		}
+
+		ret = cbor_skip(cpkt, offset, 0);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+int do_write_op_senml_cbor(struct lwm2m_message *msg)
+{
+	struct coap_packet *cpkt = msg->in.in_cpkt;
+	char base_name[NAME_BUF_LEN] = "";
+	char name[NAME_BUF_LEN];
+	char full_name[2 * NAME_BUF_LEN];
+	uint16_t offset = msg->in.offset;
+	uint16_t value_offset;
+	uint8_t orig_level = msg->path.level;
+	uint64_t count, i;
+	uint8_t ai;
+	int ret = 0;
+
+	if (cbor_get_head(cpkt, &offset, &ai, &count) != CBOR_MT_ARRAY) {
+		return -EINVAL;
+	}
+
+	for (i = 0; ai == CBOR_AI_INDEFINITE || i < count; i++) {
+		if (ai == CBOR_AI_INDEFINITE && cbor_get_break(cpkt, &offset)) {
+			break;
+		}
+
+		ret = senml_get_record(cpkt, &offset, base_name, name,
+				       &value_offset);
+		if (ret < 0) {
+			LOG_ERR("Error parsing record: %d", ret);
+			break;
+		}
+
+		if (value_offset == 0U) {
+			continue;
+		}
+
+		snprintk(full_name, sizeof(full_name), "%s%s",
+			 base_name, name);
+
+		ret = senml_parse_path(full_name, &msg->path);
+		if (ret < 0) {
+			LOG_ERR("Invalid name %s", log_strdup(full_name));
+			break;
+		}
+
+		msg->path.level = ret;
+
+		ret = cbor_write_resource(msg, value_offset, orig_level);
+		if (ret < 0) {
+			break;
+		}
+	}
+
+	return ret;
+}
+
+/* LwM2M-CBOR write */
+
+/*
+ * Walks a map of the LwM2M-CBOR tree. A key is a path element or an
+ * array of path elements, a value is either a nested map or the value
+ * of the resource (instance) at the path built so far.
+ */
+static int lwm2m_cbor_write_map(struct lwm2m_message *msg, uint16_t *offset,
+				struct lwm2m_obj_path *path, uint8_t level,
+				uint8_t orig_level)
+{
+	struct coap_packet *cpkt = msg->in.in_cpkt;
+	uint64_t count, i, n, key;
+	uint8_t sub_level;
+	uint8_t ai, key_ai;
+	int mt, ret;
+
+	if (cbor_get_head(cpkt, offset, &ai, &count) != CBOR_MT_MAP) {
+		return -EINVAL;
+	}
+
+	for (i = 0; ai == CBOR_AI_INDEFINITE || i < count; i++) {
+		if (ai == CBOR_AI_INDEFINITE && cbor_get_break(cpkt, offset)) {
+			break;
+		}
+
+		mt = cbor_get_head(cpkt, offset, &key_ai, &key);
+		if (mt == CBOR_MT_UINT) {
+			ret = path_set_id(path, level, key);
+			if (ret < 0) {
+				return ret;
+			}
+
+			sub_level = level + 1;
+		} else if (mt == CBOR_MT_ARRAY && key > 0 &&
+			   key <= 4U - level) {
+			sub_level = level;
+			for (n = 0; n < key; n++) {
+				if (cbor_get_head(cpkt, offset, &key_ai,
+						  &count) != CBOR_MT_UINT) {
+					return -EINVAL;
+				}
+
+				ret = path_set_id(path, sub_level++, count);
+				if (ret < 0) {
+					return ret;
+				}
+			}
+		} else {
+			return -EINVAL;
+		}
+
+		if (*offset >= cpkt->max_len) {
+			return -EINVAL;
+		}
+
+		if ((cpkt->data[*offset] >> 5) == CBOR_MT_MAP) {
+			ret = lwm2m_cbor_write_map(msg, offset, path,
+						   sub_level, orig_level);
+			if (ret < 0) {
+				return ret;
+			}
+
+			continue;
+		}
+
+		/* a sibling may have left a resource instance behind */
+		memcpy(&msg->path, path, sizeof(msg->path));
+		msg->path.level = sub_level;
+		if (sub_level < 4U) {
+			msg->path.res_inst_id = 0U;
+		}
+
+		ret = cbor_write_resource(msg, *offset, orig_level);
+		if (ret < 0) {
+			return ret;
+		}
+
+		ret = cbor_skip(cpkt, offset, 0);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+int do_write_op_lwm2m_cbor(struct lwm2m_message *msg)
+{
+	struct lwm2m_obj_path path;
+	uint16_t offset = msg->in.offset;
+
+	(void)memset(&path, 0, sizeof(path));
+
+	return lwm2m_cbor_write_map(msg, &offset, &path, 0U,
+				    msg->path.level);
+}
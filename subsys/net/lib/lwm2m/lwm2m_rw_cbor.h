@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef LWM2M_RW_CBOR_H_
+#define LWM2M_RW_CBOR_H_
+
+#include "lwm2m_object.h"
+
+extern const struct lwm2m_writer senml_cbor_writer;
+extern const struct lwm2m_writer lwm2m_cbor_writer;
+extern const struct lwm2m_reader cbor_reader;
+
+int do_read_op_cbor(struct lwm2m_message *msg, int content_format);
+int do_write_op_senml_cbor(struct lwm2m_message *msg);
+int do_write_op_lwm2m_cbor(struct lwm2m_message *msg);
+
+#endif /* LWM2M_RW_CBOR_H_ */
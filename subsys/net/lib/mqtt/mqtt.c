@@ -25,13 +25,38 @@ static void client_reset(struct mqtt_client *client)
 	client->internal.last_activity = 0U;
 	client->internal.rx_buf_datalen = 0U;
 	client->internal.remaining_payload = 0U;
+
+#if defined(CONFIG_MQTT_LIB_TX_BATCH)
+	client->internal.batching = false;
+	client->internal.batch_iovcnt = 0U;
+	client->internal.batch_len = 0U;
+#endif
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/* Topic aliases only last for the connection. */
+	client->internal.topic_alias_maximum = 0U;
+	memset(client->internal.tx_alias, 0, sizeof(client->internal.tx_alias));
+	memset(client->internal.rx_alias, 0, sizeof(client->internal.rx_alias));
+#endif
+}
+
+/** @brief Length of the tx buffer holding batched headers. */
+static uint32_t tx_batch_len(const struct mqtt_client *client)
+{
+#if defined(CONFIG_MQTT_LIB_TX_BATCH)
+	return client->internal.batch_len;
+#else
+	return 0U;
+#endif
 }
 
-/** @brief Initialize tx buffer. */
+/** @brief Initialize tx buffer, after the batched headers if any. */
 static void tx_buf_init(struct mqtt_client *client, struct buf_ctx *buf)
 {
-	memset(client->tx_buf, 0, client->tx_buf_size);
-	buf->cur = client->tx_buf;
+	uint32_t batch_len = tx_batch_len(client);
+
+	memset(client->tx_buf + batch_len, 0, client->tx_buf_size - batch_len);
+	buf->cur = client->tx_buf + batch_len;
 	buf->end = client->tx_buf + client->tx_buf_size;
 }
 
@@ -236,6 +261,163 @@ static int verify_tx_state(const struct mqtt_client *client)
 	return 0;
 }
 
+#if defined(CONFIG_MQTT_LIB_TX_BATCH)
+static int tx_batch_flush(struct mqtt_client *client)
+{
+	int err_code = 0;
+	struct msghdr msg;
+
+	if (client->internal.batch_iovcnt > 0U) {
+		memset(&msg, 0, sizeof(msg));
+
+		msg.msg_iov = client->internal.batch_iov;
+		msg.msg_iovlen = client->internal.batch_iovcnt;
+
+		err_code = client_write_msg(client, &msg);
+	}
+
+	client->internal.batch_iovcnt = 0U;
+	client->internal.batch_len = 0U;
+
+	return err_code;
+}
+
+/** @brief Queue an encoded publish message, flush if the batch is full. */
+static int tx_batch_add(struct mqtt_client *client,
+			const struct buf_ctx *packet,
+			const struct iovec *io_vector, size_t iovcnt)
+{
+	size_t i;
+
+	for (i = 0; i < iovcnt; i++) {
+		if (io_vector[i].iov_len == 0U) {
+			continue;
+		}
+
+		client->internal.batch_iov[client->internal.batch_iovcnt++] =
+								io_vector[i];
+	}
+
+	client->internal.batch_len = packet->end - client->tx_buf;
+
+	if (client->internal.batch_iovcnt + iovcnt >
+	    ARRAY_SIZE(client->internal.batch_iov)) {
+		return tx_batch_flush(client);
+	}
+
+	return 0;
+}
+
+int mqtt_publish_batch_begin(struct mqtt_client *client)
+{
+	int err_code;
+
+	NULL_PARAM_CHECK(client);
+
+	mqtt_mutex_lock(client);
+
+	err_code = verify_tx_state(client);
+	if (err_code == 0) {
+		client->internal.batching = true;
+	}
+
+	mqtt_mutex_unlock(client);
+
+	return err_code;
+}
+
+int mqtt_publish_batch_end(struct mqtt_client *client)
+{
+	int err_code;
+
+	NULL_PARAM_CHECK(client);
+
+	mqtt_mutex_lock(client);
+
+	err_code = verify_tx_state(client);
+	if (err_code == 0) {
+		err_code = tx_batch_flush(client);
+	}
+
+	client->internal.batching = false;
+
+	mqtt_mutex_unlock(client);
+
+	return err_code;
+}
+#else
+static int tx_batch_flush(struct mqtt_client *client)
+{
+	return 0;
+}
+#endif /* CONFIG_MQTT_LIB_TX_BATCH */
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/** @brief Picks the topic alias of a message sent to the server. */
+static void tx_topic_alias_get(const struct mqtt_client *client,
+			       struct mqtt_publish_param *param)
+{
+	const struct mqtt_utf8 *topic = &param->message.topic.topic;
+	const struct mqtt_topic_alias *alias;
+	uint16_t max_alias = MIN(CONFIG_MQTT_TOPIC_ALIAS_MAX,
+				 client->internal.topic_alias_maximum);
+	uint16_t free_alias = 0U;
+	uint16_t i;
+
+	param->topic_alias = 0U;
+
+	if (topic->size == 0U ||
+	    topic->size > sizeof(client->internal.tx_alias[0].topic)) {
+		return;
+	}
+
+#if defined(CONFIG_MQTT_LIB_MSG_STORE)
+	/* Stored messages are sent again on a new connection, which does not
+	 * know the aliases, so they keep the full topic.
+	 */
+	if (param->message.topic.qos > MQTT_QOS_0_AT_MOST_ONCE &&
+	    client->msg_store_buf != NULL) {
+		return;
+	}
+#endif
+
+	for (i = 0U; i < max_alias; i++) {
+		alias = &client->internal.tx_alias[i];
+
+		if (alias->len == topic->size &&
+		    memcmp(alias->topic, topic->utf8, topic->size) == 0) {
+			/* Known to the server, only the alias is sent. */
+			param->topic_alias = i + 1U;
+			param->message.topic.topic.size = 0U;
+			return;
+		}
+
+		if (alias->len == 0U && free_alias == 0U) {
+			free_alias = i + 1U;
+		}
+	}
+
+	/* Sent along with the topic, to be used by the next messages. */
+	param->topic_alias = free_alias;
+}
+
+/** @brief Records the topic alias of a message sent to the server. */
+static void tx_topic_alias_set(struct mqtt_client *client,
+			       const struct mqtt_publish_param *param)
+{
+	const struct mqtt_utf8 *topic = &param->message.topic.topic;
+	struct mqtt_topic_alias *alias;
+
+	if (param->topic_alias == 0U || topic->size == 0U) {
+		return;
+	}
+
+	alias = &client->internal.tx_alias[param->topic_alias - 1U];
+	memcpy(alias->topic, topic->utf8, topic->size);
+	alias->len = topic->size;
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 int mqtt_publish(struct mqtt_client *client,
 		 const struct mqtt_publish_param *param)
 {
@@ -243,6 +425,9 @@ int mqtt_publish(struct mqtt_client *client,
 	struct buf_ctx packet;
 	struct iovec io_vector[2];
 	struct msghdr msg;
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	struct mqtt_publish_param param_5;
+#endif
 
 	NULL_PARAM_CHECK(client);
 	NULL_PARAM_CHECK(param);
@@ -261,7 +446,35 @@ int mqtt_publish(struct mqtt_client *client,
 		goto error;
 	}
 
-	err_code = publish_encode(param, &packet);
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (mqtt_is_version_5(client)) {
+		/* No more messages than the Receive Maximum of the server
+		 * may wait for an acknowledgment.
+		 */
+		if (param->message.topic.qos > MQTT_QOS_0_AT_MOST_ONCE &&
+		    client->internal.send_quota == 0U) {
+			err_code = -ENOBUFS;
+			goto error;
+		}
+
+		param_5 = *param;
+		tx_topic_alias_get(client, &param_5);
+		param = &param_5;
+	}
+#endif
+
+	err_code = publish_encode(client, param, &packet);
+	if (err_code == -ENOMEM && tx_batch_len(client) > 0U) {
+		/* No room left after the batched headers, send them first. */
+		err_code = tx_batch_flush(client);
+		if (err_code < 0) {
+			goto error;
+		}
+
+		tx_buf_init(client, &packet);
+		err_code = publish_encode(client, param, &packet);
+	}
+
 	if (err_code < 0) {
 		goto error;
 	}
@@ -271,6 +484,32 @@ int mqtt_publish(struct mqtt_client *client,
 	io_vector[1].iov_base = param->message.payload.data;
 	io_vector[1].iov_len = param->message.payload.len;
 
+	if (param->message.topic.qos > MQTT_QOS_0_AT_MOST_ONCE) {
+		err_code = mqtt_msg_store_add(client, param->message_id,
+					      io_vector, ARRAY_SIZE(io_vector));
+		if (err_code < 0) {
+			goto error;
+		}
+	}
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (mqtt_is_version_5(client)) {
+		tx_topic_alias_set(client, param);
+
+		if (param->message.topic.qos > MQTT_QOS_0_AT_MOST_ONCE) {
+			client->internal.send_quota--;
+		}
+	}
+#endif
+
+#if defined(CONFIG_MQTT_LIB_TX_BATCH)
+	if (client->internal.batching) {
+		err_code = tx_batch_add(client, &packet, io_vector,
+					ARRAY_SIZE(io_vector));
+		goto error;
+	}
+#endif
+
 	memset(&msg, 0, sizeof(msg));
 
 	msg.msg_iov = io_vector;
@@ -387,6 +626,9 @@ int mqtt_publish_qos2_release(struct mqtt_client *client,
 		goto error;
 	}
 
+	mqtt_msg_store_release(client, param->message_id, packet.cur,
+			       packet.end - packet.cur);
+
 	err_code = client_write(client, packet.cur, packet.end - packet.cur);
 
 error:
@@ -454,6 +696,13 @@ int mqtt_disconnect(struct mqtt_client *client)
 		goto error;
 	}
 
+	err_code = tx_batch_flush(client);
+	if (err_code < 0) {
+		goto error;
+	}
+
+	tx_buf_init(client, &packet);
+
 	err_code = disconnect_encode(&packet);
 	if (err_code < 0) {
 		goto error;
@@ -494,7 +743,7 @@ int mqtt_subscribe(struct mqtt_client *client,
 		goto error;
 	}
 
-	err_code = subscribe_encode(param, &packet);
+	err_code = subscribe_encode(client, param, &packet);
 	if (err_code < 0) {
 		goto error;
 	}
@@ -528,7 +777,7 @@ int mqtt_unsubscribe(struct mqtt_client *client,
 		goto error;
 	}
 
-	err_code = unsubscribe_encode(param, &packet);
+	err_code = unsubscribe_encode(client, param, &packet);
 	if (err_code < 0) {
 		goto error;
 	}
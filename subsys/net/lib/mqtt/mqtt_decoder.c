@@ -13,6 +13,8 @@
 #include <logging/log.h>
 LOG_MODULE_REGISTER(net_mqtt_dec, CONFIG_MQTT_LOG_LEVEL);
 
+#include <sys/byteorder.h>
+
 #include "mqtt_internal.h"
 #include "mqtt_os.h"
 
@@ -69,6 +71,35 @@ static int unpack_uint16(struct buf_ctx *buf, uint16_t *val)
 	return 0;
 }
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/**
+ * @brief Unpacks unsigned 32 bit value from the buffer from the offset
+ *        requested.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ * @param[out] val Memory where the value is to be unpacked.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -EINVAL if the buffer would be exceeded during the read
+ */
+static int unpack_uint32(struct buf_ctx *buf, uint32_t *val)
+{
+	MQTT_TRC(">> cur:%p, end:%p", buf->cur, buf->end);
+
+	if ((buf->end - buf->cur) < sizeof(uint32_t)) {
+		return -EINVAL;
+	}
+
+	*val = sys_get_be32(buf->cur);
+	buf->cur += sizeof(uint32_t);
+
+	MQTT_TRC("<< val:%08x", *val);
+
+	return 0;
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 /**
  * @brief Unpacks utf8 string from the buffer from the offset requested.
  *
@@ -188,6 +219,349 @@ static int packet_length_decode(struct buf_ctx *buf, uint32_t *length)
 	return 0;
 }
 
+int properties_length_decode(struct buf_ctx *buf, uint32_t *length)
+{
+	/* Encoded as a Variable Byte Integer, like the packet length. */
+	return packet_length_decode(buf, length);
+}
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/** @brief Encodings of the MQTT 5.0 property values. */
+enum property_type {
+	PROPERTY_INVALID,
+	PROPERTY_BYTE,
+	PROPERTY_UINT16,
+	PROPERTY_UINT32,
+	PROPERTY_VAR_INT,
+	PROPERTY_BINARY,
+	PROPERTY_STRING_PAIR,
+};
+
+/** @brief Decoded MQTT 5.0 property. */
+struct property {
+	/** Property identifier. */
+	uint8_t id;
+
+	/** Value of the integer properties. */
+	uint32_t value;
+
+	/** Value of the UTF-8 string and binary data properties. */
+	struct mqtt_utf8 data;
+};
+
+static enum property_type property_type_get(uint8_t id)
+{
+	switch (id) {
+	case MQTT_PROP_PAYLOAD_FORMAT_INDICATOR:
+	case MQTT_PROP_REQUEST_PROBLEM_INFORMATION:
+	case MQTT_PROP_REQUEST_RESPONSE_INFORMATION:
+	case MQTT_PROP_MAXIMUM_QOS:
+	case MQTT_PROP_RETAIN_AVAILABLE:
+	case MQTT_PROP_WILDCARD_SUB_AVAILABLE:
+	case MQTT_PROP_SUBSCRIPTION_ID_AVAILABLE:
+	case MQTT_PROP_SHARED_SUB_AVAILABLE:
+		return PROPERTY_BYTE;
+
+	case MQTT_PROP_SERVER_KEEP_ALIVE:
+	case MQTT_PROP_RECEIVE_MAXIMUM:
+	case MQTT_PROP_TOPIC_ALIAS_MAXIMUM:
+	case MQTT_PROP_TOPIC_ALIAS:
+		return PROPERTY_UINT16;
+
+	case MQTT_PROP_MESSAGE_EXPIRY_INTERVAL:
+	case MQTT_PROP_SESSION_EXPIRY_INTERVAL:
+	case MQTT_PROP_WILL_DELAY_INTERVAL:
+	case MQTT_PROP_MAXIMUM_PACKET_SIZE:
+		return PROPERTY_UINT32;
+
+	case MQTT_PROP_SUBSCRIPTION_IDENTIFIER:
+		return PROPERTY_VAR_INT;
+
+	case MQTT_PROP_CONTENT_TYPE:
+	case MQTT_PROP_RESPONSE_TOPIC:
+	case MQTT_PROP_CORRELATION_DATA:
+	case MQTT_PROP_ASSIGNED_CLIENT_IDENTIFIER:
+	case MQTT_PROP_AUTHENTICATION_METHOD:
+	case MQTT_PROP_AUTHENTICATION_DATA:
+	case MQTT_PROP_RESPONSE_INFORMATION:
+	case MQTT_PROP_SERVER_REFERENCE:
+	case MQTT_PROP_REASON_STRING:
+		return PROPERTY_BINARY;
+
+	case MQTT_PROP_USER_PROPERTY:
+		return PROPERTY_STRING_PAIR;
+
+	default:
+		return PROPERTY_INVALID;
+	}
+}
+
+/**
+ * @brief Unpacks the next MQTT 5.0 property.
+ *
+ * @param[inout] props Properties of the packet, see properties_get().
+ * @param[out] prop Decoded property. The name of a User Property is
+ *                  skipped, its value is provided.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -EINVAL if the property is malformed or unknown.
+ */
+static int property_decode(struct buf_ctx *props, struct property *prop)
+{
+	uint16_t val16;
+	uint8_t val8;
+	int err_code;
+
+	err_code = unpack_uint8(props, &prop->id);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	switch (property_type_get(prop->id)) {
+	case PROPERTY_BYTE:
+		err_code = unpack_uint8(props, &val8);
+		prop->value = val8;
+		break;
+
+	case PROPERTY_UINT16:
+		err_code = unpack_uint16(props, &val16);
+		prop->value = val16;
+		break;
+
+	case PROPERTY_UINT32:
+		err_code = unpack_uint32(props, &prop->value);
+		break;
+
+	case PROPERTY_VAR_INT:
+		err_code = packet_length_decode(props, &prop->value);
+		break;
+
+	case PROPERTY_BINARY:
+		err_code = unpack_utf8_str(props, &prop->data);
+		break;
+
+	case PROPERTY_STRING_PAIR:
+		/* Name, then value. */
+		err_code = unpack_utf8_str(props, &prop->data);
+		if (err_code == 0) {
+			err_code = unpack_utf8_str(props, &prop->data);
+		}
+
+		break;
+
+	default:
+		MQTT_ERR("Unknown property 0x%02x", prop->id);
+		return -EINVAL;
+	}
+
+	/* A property never extends past the properties length. */
+	return (err_code != 0) ? -EINVAL : 0;
+}
+
+/**
+ * @brief Locates the MQTT 5.0 properties of a packet.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position. As output points after the properties.
+ * @param[out] props Bounds of the properties.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -EINVAL if the buffer would be exceeded during the read.
+ */
+static int properties_get(struct buf_ctx *buf, struct buf_ctx *props)
+{
+	uint32_t length;
+	int err_code;
+
+	err_code = properties_length_decode(buf, &length);
+	if (err_code != 0) {
+		return -EINVAL;
+	}
+
+	if ((buf->end - buf->cur) < length) {
+		return -EINVAL;
+	}
+
+	props->cur = buf->cur;
+	props->end = buf->cur + length;
+	buf->cur += length;
+
+	return 0;
+}
+
+static int connect_ack_properties_decode(const struct mqtt_client *client,
+					 struct buf_ctx *buf,
+					 struct mqtt_connack_param *param)
+{
+	struct buf_ctx props;
+	struct property prop;
+	int err_code;
+
+	/* Defaults of the properties absent from the packet. */
+	param->session_expiry_interval = client->session_expiry_interval;
+	param->receive_maximum = MQTT_RECEIVE_MAXIMUM_DEFAULT;
+	param->topic_alias_maximum = 0U;
+	param->maximum_qos = MQTT_QOS_2_EXACTLY_ONCE;
+	param->retain_available = 1U;
+	param->maximum_packet_size = 0U;
+	param->assigned_client_id.utf8 = NULL;
+	param->assigned_client_id.size = 0U;
+
+	err_code = properties_get(buf, &props);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	while (props.cur < props.end) {
+		err_code = property_decode(&props, &prop);
+		if (err_code != 0) {
+			return err_code;
+		}
+
+		switch (prop.id) {
+		case MQTT_PROP_SESSION_EXPIRY_INTERVAL:
+			param->session_expiry_interval = prop.value;
+			break;
+
+		case MQTT_PROP_RECEIVE_MAXIMUM:
+			if (prop.value == 0U) {
+				return -EINVAL;
+			}
+
+			param->receive_maximum = prop.value;
+			break;
+
+		case MQTT_PROP_TOPIC_ALIAS_MAXIMUM:
+			param->topic_alias_maximum = prop.value;
+			break;
+
+		case MQTT_PROP_MAXIMUM_QOS:
+			param->maximum_qos = prop.value;
+			break;
+
+		case MQTT_PROP_RETAIN_AVAILABLE:
+			param->retain_available = prop.value;
+			break;
+
+		case MQTT_PROP_MAXIMUM_PACKET_SIZE:
+			param->maximum_packet_size = prop.value;
+			break;
+
+		case MQTT_PROP_ASSIGNED_CLIENT_IDENTIFIER:
+			param->assigned_client_id = prop.data;
+			break;
+
+		default:
+			/* Not used by the client. */
+			break;
+		}
+	}
+
+	return 0;
+}
+
+static int publish_properties_decode(struct buf_ctx *buf,
+				     struct mqtt_publish_param *param)
+{
+	struct buf_ctx props;
+	struct property prop;
+	int err_code;
+
+	param->payload_format_indicator = 0U;
+	param->message_expiry_interval = 0U;
+	param->topic_alias = 0U;
+
+	err_code = properties_get(buf, &props);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	while (props.cur < props.end) {
+		err_code = property_decode(&props, &prop);
+		if (err_code != 0) {
+			return err_code;
+		}
+
+		switch (prop.id) {
+		case MQTT_PROP_PAYLOAD_FORMAT_INDICATOR:
+			param->payload_format_indicator = prop.value;
+			break;
+
+		case MQTT_PROP_MESSAGE_EXPIRY_INTERVAL:
+			param->message_expiry_interval = prop.value;
+			break;
+
+		case MQTT_PROP_TOPIC_ALIAS:
+			if (prop.value == 0U) {
+				return -EINVAL;
+			}
+
+			param->topic_alias = prop.value;
+			break;
+
+		default:
+			/* Not used by the client. */
+			break;
+		}
+	}
+
+	return 0;
+}
+
+/** @brief Skips the properties of a packet, if any. */
+static int properties_skip(const struct mqtt_client *client,
+			   struct buf_ctx *buf)
+{
+	struct buf_ctx props;
+
+	if (!mqtt_is_version_5(client)) {
+		return 0;
+	}
+
+	return properties_get(buf, &props);
+}
+
+#define ACK_REASON_CODE(param) (&(param)->reason_code)
+#else
+static int properties_skip(const struct mqtt_client *client,
+			   struct buf_ctx *buf)
+{
+	return 0;
+}
+
+#define ACK_REASON_CODE(param) NULL
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
+/**
+ * @brief Decodes an acknowledgment containing a message id, followed by
+ *        an MQTT 5.0 Reason Code and properties.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ * @param[out] message_id Acknowledged message id.
+ * @param[out] reason_code Reason Code, 0 if omitted. May be NULL.
+ *
+ * @return 0 if the procedure is successful, an error code otherwise.
+ */
+static int ack_decode(struct buf_ctx *buf, uint16_t *message_id,
+		      uint8_t *reason_code)
+{
+	int err_code;
+
+	err_code = unpack_uint16(buf, message_id);
+	if (err_code != 0 || reason_code == NULL) {
+		return err_code;
+	}
+
+	/* The Reason Code is omitted on success. */
+	*reason_code = 0U;
+	if (buf->cur < buf->end) {
+		err_code = unpack_uint8(buf, reason_code);
+	}
+
+	return err_code;
+}
+
 int fixed_header_decode(struct buf_ctx *buf, uint8_t *type_and_flags,
 			uint32_t *length)
 {
@@ -217,7 +591,8 @@ int connect_ack_decode(const struct mqtt_client *client, struct buf_ctx *buf,
 		return err_code;
 	}
 
-	if (client->protocol_version == MQTT_VERSION_3_1_1) {
+	if (client->protocol_version == MQTT_VERSION_3_1_1 ||
+	    mqtt_is_version_5(client)) {
 		param->session_present_flag =
 			flags & MQTT_CONNACK_FLAG_SESSION_PRESENT;
 
@@ -227,10 +602,17 @@ int connect_ack_decode(const struct mqtt_client *client, struct buf_ctx *buf,
 
 	param->return_code = (enum mqtt_conn_return_code)ret_code;
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (mqtt_is_version_5(client)) {
+		return connect_ack_properties_decode(client, buf, param);
+	}
+#endif
+
 	return 0;
 }
 
-int publish_decode(uint8_t flags, uint32_t var_length, struct buf_ctx *buf,
+int publish_decode(const struct mqtt_client *client, uint8_t flags,
+		   uint32_t var_length, struct buf_ctx *buf,
 		   struct mqtt_publish_param *param)
 {
 	int err_code;
@@ -256,6 +638,19 @@ int publish_decode(uint8_t flags, uint32_t var_length, struct buf_ctx *buf,
 		var_header_length += sizeof(uint16_t);
 	}
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (mqtt_is_version_5(client)) {
+		uint8_t *props_start = buf->cur;
+
+		err_code = publish_properties_decode(buf, param);
+		if (err_code != 0) {
+			return err_code;
+		}
+
+		var_header_length += buf->cur - props_start;
+	}
+#endif
+
 	if (var_length < var_header_length) {
 		MQTT_ERR("Corrupted PUBLISH message, header length (%u) larger "
 			 "than total length (%u)", var_header_length,
@@ -271,26 +666,27 @@ int publish_decode(uint8_t flags, uint32_t var_length, struct buf_ctx *buf,
 
 int publish_ack_decode(struct buf_ctx *buf, struct mqtt_puback_param *param)
 {
-	return unpack_uint16(buf, &param->message_id);
+	return ack_decode(buf, &param->message_id, ACK_REASON_CODE(param));
 }
 
 int publish_receive_decode(struct buf_ctx *buf, struct mqtt_pubrec_param *param)
 {
-	return unpack_uint16(buf, &param->message_id);
+	return ack_decode(buf, &param->message_id, ACK_REASON_CODE(param));
 }
 
 int publish_release_decode(struct buf_ctx *buf, struct mqtt_pubrel_param *param)
 {
-	return unpack_uint16(buf, &param->message_id);
+	return ack_decode(buf, &param->message_id, ACK_REASON_CODE(param));
 }
 
 int publish_complete_decode(struct buf_ctx *buf,
 			    struct mqtt_pubcomp_param *param)
 {
-	return unpack_uint16(buf, &param->message_id);
+	return ack_decode(buf, &param->message_id, ACK_REASON_CODE(param));
 }
 
-int subscribe_ack_decode(struct buf_ctx *buf, struct mqtt_suback_param *param)
+int subscribe_ack_decode(const struct mqtt_client *client,
+			 struct buf_ctx *buf, struct mqtt_suback_param *param)
 {
 	int err_code;
 
@@ -299,11 +695,47 @@ int subscribe_ack_decode(struct buf_ctx *buf, struct mqtt_suback_param *param)
 		return err_code;
 	}
 
+	err_code = properties_skip(client, buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
 	return unpack_data(buf->end - buf->cur, buf, &param->return_codes);
 }
 
-int unsubscribe_ack_decode(struct buf_ctx *buf,
+int unsubscribe_ack_decode(const struct mqtt_client *client,
+			   struct buf_ctx *buf,
 			   struct mqtt_unsuback_param *param)
 {
-	return unpack_uint16(buf, &param->message_id);
+	int err_code;
+
+	err_code = unpack_uint16(buf, &param->message_id);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (mqtt_is_version_5(client)) {
+		err_code = properties_skip(client, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+
+		return unpack_data(buf->end - buf->cur, buf,
+				   &param->reason_codes);
+	}
+#endif
+
+	return 0;
+}
+
+int disconnect_decode(struct buf_ctx *buf, uint8_t *reason_code)
+{
+	/* Normal disconnection if the Reason Code is omitted. */
+	*reason_code = 0U;
+	if (buf->cur == buf->end) {
+		return 0;
+	}
+
+	return unpack_uint8(buf, reason_code);
 }
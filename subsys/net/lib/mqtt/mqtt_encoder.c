@@ -12,6 +12,8 @@
 #include <logging/log.h>
 LOG_MODULE_REGISTER(net_mqtt_enc, CONFIG_MQTT_LOG_LEVEL);
 
+#include <sys/byteorder.h>
+
 #include "mqtt_internal.h"
 #include "mqtt_os.h"
 
@@ -82,6 +84,33 @@ static int pack_uint16(uint16_t val, struct buf_ctx *buf)
 	return 0;
 }
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/**
+ * @brief Packs unsigned 32 bit value to the buffer at the offset requested.
+ *
+ * @param[in] val Value to be packed.
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -ENOMEM if there is no place in the buffer to store the value.
+ */
+static int pack_uint32(uint32_t val, struct buf_ctx *buf)
+{
+	if ((buf->end - buf->cur) < sizeof(uint32_t)) {
+		return -ENOMEM;
+	}
+
+	MQTT_TRC(">> val:%08x cur:%p, end:%p", val, buf->cur, buf->end);
+
+	/* Pack value. */
+	sys_put_be32(val, buf->cur);
+	buf->cur += sizeof(uint32_t);
+
+	return 0;
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 /**
  * @brief Packs utf8 string to the buffer at the offset requested.
  *
@@ -215,6 +244,214 @@ static uint32_t mqtt_encode_fixed_header(uint8_t message_type, uint8_t *start,
 	return 0;
 }
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/**
+ * @brief Starts the MQTT 5.0 properties of a packet.
+ *
+ * @note Only fixed size properties are encoded by the library, the
+ *       properties of a packet always fit in 127 bytes and their length
+ *       is a single byte.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ *
+ * @return Position of the properties length, NULL if there is no place in
+ *         the buffer.
+ */
+static uint8_t *properties_start(struct buf_ctx *buf)
+{
+	uint8_t *length_pos = buf->cur;
+
+	if (pack_uint8(0, buf) != 0) {
+		return NULL;
+	}
+
+	return length_pos;
+}
+
+/**
+ * @brief Ends the MQTT 5.0 properties of a packet, writing their length.
+ *
+ * @param[in] length_pos Position returned by properties_start().
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ */
+static void properties_end(uint8_t *length_pos, struct buf_ctx *buf)
+{
+	uint32_t length = buf->cur - length_pos - sizeof(uint8_t);
+
+	__ASSERT_NO_MSG(length <= MQTT_LENGTH_VALUE_MASK);
+
+	*length_pos = length;
+}
+
+/** @brief Packs a property with a byte value. */
+static int pack_property_uint8(uint8_t id, uint8_t val, struct buf_ctx *buf)
+{
+	int err_code;
+
+	err_code = pack_uint8(id, buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	return pack_uint8(val, buf);
+}
+
+/** @brief Packs a property with a two byte integer value. */
+static int pack_property_uint16(uint8_t id, uint16_t val, struct buf_ctx *buf)
+{
+	int err_code;
+
+	err_code = pack_uint8(id, buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	return pack_uint16(val, buf);
+}
+
+/** @brief Packs a property with a four byte integer value. */
+static int pack_property_uint32(uint8_t id, uint32_t val, struct buf_ctx *buf)
+{
+	int err_code;
+
+	err_code = pack_uint8(id, buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	return pack_uint32(val, buf);
+}
+
+/**
+ * @brief Encodes the properties of a Connect packet.
+ *
+ * @param[in] client Client for which the packet is encoded.
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ *
+ * @retval 0 or an error code indicating a reason for failure.
+ */
+static int connect_properties_encode(const struct mqtt_client *client,
+				     struct buf_ctx *buf)
+{
+	uint8_t *length_pos;
+	int err_code;
+
+	length_pos = properties_start(buf);
+	if (length_pos == NULL) {
+		return -ENOMEM;
+	}
+
+	if (client->session_expiry_interval != 0U) {
+		err_code = pack_property_uint32(
+				MQTT_PROP_SESSION_EXPIRY_INTERVAL,
+				client->session_expiry_interval, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
+	if (client->receive_maximum != 0U) {
+		err_code = pack_property_uint16(MQTT_PROP_RECEIVE_MAXIMUM,
+						client->receive_maximum, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
+	if (CONFIG_MQTT_TOPIC_ALIAS_MAX > 0) {
+		err_code = pack_property_uint16(MQTT_PROP_TOPIC_ALIAS_MAXIMUM,
+						CONFIG_MQTT_TOPIC_ALIAS_MAX,
+						buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
+	properties_end(length_pos, buf);
+
+	return 0;
+}
+
+/**
+ * @brief Encodes the properties of a Publish packet.
+ *
+ * @param[in] param Publish message parameters.
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ *
+ * @retval 0 or an error code indicating a reason for failure.
+ */
+static int publish_properties_encode(const struct mqtt_publish_param *param,
+				     struct buf_ctx *buf)
+{
+	uint8_t *length_pos;
+	int err_code;
+
+	length_pos = properties_start(buf);
+	if (length_pos == NULL) {
+		return -ENOMEM;
+	}
+
+	if (param->payload_format_indicator) {
+		err_code = pack_property_uint8(
+				MQTT_PROP_PAYLOAD_FORMAT_INDICATOR, 1U, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
+	if (param->message_expiry_interval != 0U) {
+		err_code = pack_property_uint32(
+				MQTT_PROP_MESSAGE_EXPIRY_INTERVAL,
+				param->message_expiry_interval, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
+	if (param->topic_alias != 0U) {
+		err_code = pack_property_uint16(MQTT_PROP_TOPIC_ALIAS,
+						param->topic_alias, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
+	properties_end(length_pos, buf);
+
+	return 0;
+}
+
+/**
+ * @brief Encodes empty properties, for the packets the library sends
+ *        without any.
+ *
+ * @param[in] client Client for which the packet is encoded.
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ *
+ * @retval 0 or an error code indicating a reason for failure.
+ */
+static int empty_properties_encode(const struct mqtt_client *client,
+				   struct buf_ctx *buf)
+{
+	if (!mqtt_is_version_5(client)) {
+		return 0;
+	}
+
+	return pack_uint8(0, buf);
+}
+#else
+static int empty_properties_encode(const struct mqtt_client *client,
+				   struct buf_ctx *buf)
+{
+	return 0;
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 /**
  * @brief Encodes a string of a zero length.
  *
@@ -238,13 +475,14 @@ static int zero_len_str_encode(struct buf_ctx *buf)
  *
  * @param[in] message_type Message type and reserved bit fields.
  * @param[in] message_id Message id to be encoded in the variable header.
+ * @param[in] reason_code MQTT 5.0 Reason Code, only encoded if not 0.
  * @param[inout] buf_ctx Pointer to the buffer context structure,
  *                       containing buffer for the encoded message.
  *
  * @retval 0 or an error code indicating a reason for failure.
  */
 static int mqtt_message_id_only_enc(uint8_t message_type, uint16_t message_id,
-				    struct buf_ctx *buf)
+				    uint8_t reason_code, struct buf_ctx *buf)
 {
 	int err_code;
 	uint8_t *start;
@@ -263,9 +501,24 @@ static int mqtt_message_id_only_enc(uint8_t message_type, uint16_t message_id,
 		return err_code;
 	}
 
+	/* The properties may be omitted along with a success reason code. */
+	if (reason_code != 0U) {
+		err_code = pack_uint8(reason_code, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
 	return mqtt_encode_fixed_header(message_type, start, buf);
 }
 
+/** @brief Reason Code of an acknowledgment to encode. */
+#if defined(CONFIG_MQTT_VERSION_5_0)
+#define ACK_REASON_CODE(param) ((param)->reason_code)
+#else
+#define ACK_REASON_CODE(param) 0U
+#endif
+
 int connect_request_encode(const struct mqtt_client *client,
 			   struct buf_ctx *buf)
 {
@@ -277,7 +530,8 @@ int connect_request_encode(const struct mqtt_client *client,
 	int err_code;
 	uint8_t *start;
 
-	if (client->protocol_version == MQTT_VERSION_3_1_1) {
+	if (client->protocol_version == MQTT_VERSION_3_1_1 ||
+	    mqtt_is_version_5(client)) {
 		mqtt_proto_desc = &mqtt_3_1_1_proto_desc;
 	} else {
 		mqtt_proto_desc = &mqtt_3_1_0_proto_desc;
@@ -317,6 +571,15 @@ int connect_request_encode(const struct mqtt_client *client,
 		return err_code;
 	}
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (mqtt_is_version_5(client)) {
+		err_code = connect_properties_encode(client, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+#endif
+
 	MQTT_TRC("Encoding Client Id. Str:%s Size:%08x.",
 		 client->client_id.utf8, client->client_id.size);
 	err_code = pack_utf8_str(&client->client_id, buf);
@@ -331,6 +594,12 @@ int connect_request_encode(const struct mqtt_client *client,
 		connect_flags |= ((client->will_topic->qos & 0x03) << 3);
 		connect_flags |= client->will_retain << 5;
 
+		/* No Will Properties. */
+		err_code = empty_properties_encode(client, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+
 		MQTT_TRC("Encoding Will Topic. Str:%s Size:%08x.",
 			 client->will_topic->topic.utf8,
 			 client->will_topic->topic.size);
@@ -386,7 +655,8 @@ int connect_request_encode(const struct mqtt_client *client,
 	return mqtt_encode_fixed_header(message_type, start, buf);
 }
 
-int publish_encode(const struct mqtt_publish_param *param, struct buf_ctx *buf)
+int publish_encode(const struct mqtt_client *client,
+		   const struct mqtt_publish_param *param, struct buf_ctx *buf)
 {
 	const uint8_t message_type = MQTT_MESSAGES_OPTIONS(
 			MQTT_PKT_TYPE_PUBLISH, param->dup_flag,
@@ -415,6 +685,15 @@ int publish_encode(const struct mqtt_publish_param *param, struct buf_ctx *buf)
 		}
 	}
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (mqtt_is_version_5(client)) {
+		err_code = publish_properties_encode(param, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+#endif
+
 	/* Do not copy payload. We move the buffer pointer to ensure that
 	 * message length in fixed header is encoded correctly.
 	 */
@@ -436,7 +715,8 @@ int publish_ack_encode(const struct mqtt_puback_param *param,
 	const uint8_t message_type =
 		MQTT_MESSAGES_OPTIONS(MQTT_PKT_TYPE_PUBACK, 0, 0, 0);
 
-	return mqtt_message_id_only_enc(message_type, param->message_id, buf);
+	return mqtt_message_id_only_enc(message_type, param->message_id,
+					ACK_REASON_CODE(param), buf);
 }
 
 int publish_receive_encode(const struct mqtt_pubrec_param *param,
@@ -445,7 +725,8 @@ int publish_receive_encode(const struct mqtt_pubrec_param *param,
 	const uint8_t message_type =
 		MQTT_MESSAGES_OPTIONS(MQTT_PKT_TYPE_PUBREC, 0, 0, 0);
 
-	return mqtt_message_id_only_enc(message_type, param->message_id, buf);
+	return mqtt_message_id_only_enc(message_type, param->message_id,
+					ACK_REASON_CODE(param), buf);
 }
 
 int publish_release_encode(const struct mqtt_pubrel_param *param,
@@ -454,7 +735,8 @@ int publish_release_encode(const struct mqtt_pubrel_param *param,
 	const uint8_t message_type =
 		MQTT_MESSAGES_OPTIONS(MQTT_PKT_TYPE_PUBREL, 0, 1, 0);
 
-	return mqtt_message_id_only_enc(message_type, param->message_id, buf);
+	return mqtt_message_id_only_enc(message_type, param->message_id,
+					ACK_REASON_CODE(param), buf);
 }
 
 int publish_complete_encode(const struct mqtt_pubcomp_param *param,
@@ -463,7 +745,8 @@ int publish_complete_encode(const struct mqtt_pubcomp_param *param,
 	const uint8_t message_type =
 		MQTT_MESSAGES_OPTIONS(MQTT_PKT_TYPE_PUBCOMP, 0, 0, 0);
 
-	return mqtt_message_id_only_enc(message_type, param->message_id, buf);
+	return mqtt_message_id_only_enc(message_type, param->message_id,
+					ACK_REASON_CODE(param), buf);
 }
 
 int disconnect_encode(struct buf_ctx *buf)
@@ -478,7 +761,8 @@ int disconnect_encode(struct buf_ctx *buf)
 	return 0;
 }
 
-int subscribe_encode(const struct mqtt_subscription_list *param,
+int subscribe_encode(const struct mqtt_client *client,
+		     const struct mqtt_subscription_list *param,
 		     struct buf_ctx *buf)
 {
 	const uint8_t message_type = MQTT_MESSAGES_OPTIONS(
@@ -500,6 +784,11 @@ int subscribe_encode(const struct mqtt_subscription_list *param,
 		return err_code;
 	}
 
+	err_code = empty_properties_encode(client, buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
 	for (i = 0; i < param->list_count; i++) {
 		err_code = pack_utf8_str(&param->list[i].topic, buf);
 		if (err_code != 0) {
@@ -515,7 +804,8 @@ int subscribe_encode(const struct mqtt_subscription_list *param,
 	return mqtt_encode_fixed_header(message_type, start, buf);
 }
 
-int unsubscribe_encode(const struct mqtt_subscription_list *param,
+int unsubscribe_encode(const struct mqtt_client *client,
+		       const struct mqtt_subscription_list *param,
 		       struct buf_ctx *buf)
 {
 	const uint8_t message_type = MQTT_MESSAGES_OPTIONS(
@@ -532,6 +822,11 @@ int unsubscribe_encode(const struct mqtt_subscription_list *param,
 		return err_code;
 	}
 
+	err_code = empty_properties_encode(client, buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
 	for (i = 0; i < param->list_count; i++) {
 		err_code = pack_utf8_str(&param->list[i].topic, buf);
 		if (err_code != 0) {
@@ -69,6 +69,41 @@ extern "C" {
 
 #define MQTT_CONNACK_FLAG_SESSION_PRESENT 0x01
 
+/**@brief MQTT 5.0 Property identifiers. */
+#define MQTT_PROP_PAYLOAD_FORMAT_INDICATOR     0x01
+#define MQTT_PROP_MESSAGE_EXPIRY_INTERVAL      0x02
+#define MQTT_PROP_CONTENT_TYPE                 0x03
+#define MQTT_PROP_RESPONSE_TOPIC               0x08
+#define MQTT_PROP_CORRELATION_DATA             0x09
+#define MQTT_PROP_SUBSCRIPTION_IDENTIFIER      0x0B
+#define MQTT_PROP_SESSION_EXPIRY_INTERVAL      0x11
+#define MQTT_PROP_ASSIGNED_CLIENT_IDENTIFIER   0x12
+#define MQTT_PROP_SERVER_KEEP_ALIVE            0x13
+#define MQTT_PROP_AUTHENTICATION_METHOD        0x15
+#define MQTT_PROP_AUTHENTICATION_DATA          0x16
+#define MQTT_PROP_REQUEST_PROBLEM_INFORMATION  0x17
+#define MQTT_PROP_WILL_DELAY_INTERVAL          0x18
+#define MQTT_PROP_REQUEST_RESPONSE_INFORMATION 0x19
+#define MQTT_PROP_RESPONSE_INFORMATION         0x1A
+#define MQTT_PROP_SERVER_REFERENCE             0x1C
+#define MQTT_PROP_REASON_STRING                0x1F
+#define MQTT_PROP_RECEIVE_MAXIMUM              0x21
+#define MQTT_PROP_TOPIC_ALIAS_MAXIMUM          0x22
+#define MQTT_PROP_TOPIC_ALIAS                  0x23
+#define MQTT_PROP_MAXIMUM_QOS                  0x24
+#define MQTT_PROP_RETAIN_AVAILABLE             0x25
+#define MQTT_PROP_USER_PROPERTY                0x26
+#define MQTT_PROP_MAXIMUM_PACKET_SIZE          0x27
+#define MQTT_PROP_WILDCARD_SUB_AVAILABLE       0x28
+#define MQTT_PROP_SUBSCRIPTION_ID_AVAILABLE    0x29
+#define MQTT_PROP_SHARED_SUB_AVAILABLE         0x2A
+
+/**@brief MQTT 5.0 Receive Maximum when the property is absent. */
+#define MQTT_RECEIVE_MAXIMUM_DEFAULT 65535
+
+/**@brief MQTT 5.0 Reason Codes of 0x80 and above indicate a failure. */
+#define MQTT_REASON_CODE_FAILURE 0x80
+
 /**@brief Maximum payload size of MQTT packet. */
 #define MQTT_MAX_PAYLOAD_SIZE 0x0FFFFFFF
 
@@ -147,6 +182,16 @@ enum mqtt_state {
 	MQTT_STATE_CONNECTED            = 0x00000004,
 };
 
+/**@brief Checks if the client connects with MQTT 5.0. */
+static inline bool mqtt_is_version_5(const struct mqtt_client *client)
+{
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	return client->protocol_version == MQTT_VERSION_5_0;
+#else
+	return false;
+#endif
+}
+
 /**@brief Notify application about MQTT event.
  *
  * @param[in] client Identifies the client for which event occurred.
@@ -181,7 +226,10 @@ int connect_request_encode(const struct mqtt_client *client,
 
 /**@brief Constructs/encodes Publish packet.
  *
- * @param[in] param Publish message parameters.
+ * @param[in] client Identifies the client for which the procedure is requested.
+ * @param[in] param Publish message parameters. With MQTT 5.0, topic_alias
+ *                  is encoded as is and an empty topic is sent if the topic
+ *                  size is 0.
  * @param[inout] buf_ctx Pointer to the buffer context structure,
  *                       containing buffer for the encoded message.
  *                       As output points to the beginning and end of
@@ -189,7 +237,8 @@ int connect_request_encode(const struct mqtt_client *client,
  *
  * @return 0 if the procedure is successful, an error code otherwise.
  */
-int publish_encode(const struct mqtt_publish_param *param, struct buf_ctx *buf);
+int publish_encode(const struct mqtt_client *client,
+		   const struct mqtt_publish_param *param, struct buf_ctx *buf);
 
 /**@brief Constructs/encodes Publish Ack packet.
  *
@@ -256,6 +305,7 @@ int disconnect_encode(struct buf_ctx *buf);
 
 /**@brief Constructs/encodes Subscribe packet.
  *
+ * @param[in] client Identifies the client for which the procedure is requested.
  * @param[in] param Subscribe message parameters.
  * @param[inout] buf_ctx Pointer to the buffer context structure,
  *                       containing buffer for the encoded message.
@@ -264,11 +314,13 @@ int disconnect_encode(struct buf_ctx *buf);
  *
  * @return 0 if the procedure is successful, an error code otherwise.
  */
-int subscribe_encode(const struct mqtt_subscription_list *param,
+int subscribe_encode(const struct mqtt_client *client,
+		     const struct mqtt_subscription_list *param,
 		     struct buf_ctx *buf);
 
 /**@brief Constructs/encodes Unsubscribe packet.
  *
+ * @param[in] client Identifies the client for which the procedure is requested.
  * @param[in] param Unsubscribe message parameters.
  * @param[inout] buf_ctx Pointer to the buffer context structure,
  *                       containing buffer for the encoded message.
@@ -277,7 +329,8 @@ int subscribe_encode(const struct mqtt_subscription_list *param,
  *
  * @return 0 if the procedure is successful, an error code otherwise.
  */
-int unsubscribe_encode(const struct mqtt_subscription_list *param,
+int unsubscribe_encode(const struct mqtt_client *client,
+		       const struct mqtt_subscription_list *param,
 		       struct buf_ctx *buf);
 
 /**@brief Constructs/encodes Ping Request packet.
@@ -317,6 +370,7 @@ int connect_ack_decode(const struct mqtt_client *client, struct buf_ctx *buf,
 
 /**@brief Decode MQTT Publish packet.
  *
+ * @param[in] client MQTT client for which packet is decoded.
  * @param[in] flags Byte containing message type and flags.
  * @param[in] var_length Length of the variable part of the message.
  * @param[inout] buf A pointer to the buf_ctx structure containing current
@@ -325,7 +379,8 @@ int connect_ack_decode(const struct mqtt_client *client, struct buf_ctx *buf,
  *
  * @return 0 if the procedure is successful, an error code otherwise.
  */
-int publish_decode(uint8_t flags, uint32_t var_length, struct buf_ctx *buf,
+int publish_decode(const struct mqtt_client *client, uint8_t flags,
+		   uint32_t var_length, struct buf_ctx *buf,
 		   struct mqtt_publish_param *param);
 
 /**@brief Decode MQTT Publish Ack packet.
@@ -373,26 +428,122 @@ int publish_complete_decode(struct buf_ctx *buf,
 
 /**@brief Decode MQTT Subscribe packet.
  *
+ * @param[in] client MQTT client for which packet is decoded.
  * @param[inout] buf A pointer to the buf_ctx structure containing current
  *                   buffer position.
  * @param[out] param Pointer to buffer for decoded Subscribe parameters.
  *
  * @return 0 if the procedure is successful, an error code otherwise.
  */
-int subscribe_ack_decode(struct buf_ctx *buf,
+int subscribe_ack_decode(const struct mqtt_client *client,
+			 struct buf_ctx *buf,
 			 struct mqtt_suback_param *param);
 
 /**@brief Decode MQTT Unsubscribe packet.
  *
+ * @param[in] client MQTT client for which packet is decoded.
  * @param[inout] buf A pointer to the buf_ctx structure containing current
  *                   buffer position.
  * @param[out] param Pointer to buffer for decoded Unsubscribe parameters.
  *
  * @return 0 if the procedure is successful, an error code otherwise.
  */
-int unsubscribe_ack_decode(struct buf_ctx *buf,
+int unsubscribe_ack_decode(const struct mqtt_client *client,
+			   struct buf_ctx *buf,
 			   struct mqtt_unsuback_param *param);
 
+/**@brief Decode MQTT 5.0 Disconnect packet sent by the server.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ * @param[out] reason_code Disconnect Reason Code.
+ *
+ * @return 0 if the procedure is successful, an error code otherwise.
+ */
+int disconnect_decode(struct buf_ctx *buf, uint8_t *reason_code);
+
+/**@brief Decode the length of MQTT 5.0 properties.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ * @param[out] length Length of the properties following the length field.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -EINVAL if the length is malformed.
+ * @retval -EAGAIN if the buffer would be exceeded during the read.
+ */
+int properties_length_decode(struct buf_ctx *buf, uint32_t *length);
+
+#if defined(CONFIG_MQTT_LIB_MSG_STORE)
+/**@brief Stores an outgoing QoS 1 or QoS 2 Publish packet until it is
+ *        acknowledged.
+ *
+ * @param[in] client MQTT client sending the packet.
+ * @param[in] message_id Message id of the packet.
+ * @param[in] iov Encoded packet, header and payload.
+ * @param[in] iovcnt Number of entries in iov.
+ *
+ * @return 0 if the packet is stored or the client has no message store,
+ *         -ENOBUFS if the in flight window or the store is full, an error
+ *         code otherwise.
+ */
+int mqtt_msg_store_add(struct mqtt_client *client, uint16_t message_id,
+		       const struct iovec *iov, size_t iovcnt);
+
+/**@brief Replaces a stored Publish packet by its Publish Release packet.
+ *
+ * @param[in] client MQTT client sending the packet.
+ * @param[in] message_id Message id of the packet.
+ * @param[in] data Encoded Publish Release packet.
+ * @param[in] len Length of the encoded packet.
+ */
+void mqtt_msg_store_release(struct mqtt_client *client, uint16_t message_id,
+			    const uint8_t *data, uint32_t len);
+
+/**@brief Removes an acknowledged packet from the store.
+ *
+ * @param[in] client MQTT client which received the acknowledgment.
+ * @param[in] type MQTT_PKT_TYPE_PUBLISH for a Publish Ack,
+ *                 MQTT_PKT_TYPE_PUBREL for a Publish Complete.
+ * @param[in] message_id Acknowledged message id.
+ */
+void mqtt_msg_store_remove(struct mqtt_client *client, uint8_t type,
+			   uint16_t message_id);
+
+/**@brief Retransmits the stored packets after a connection is accepted.
+ *
+ * @param[in] client MQTT client which received the Connect Ack.
+ * @param[in] session_present Session Present flag of the Connect Ack.
+ *
+ * @return 0 if the procedure is successful, an error code otherwise.
+ */
+int mqtt_msg_store_resend(struct mqtt_client *client, bool session_present);
+#else
+static inline int mqtt_msg_store_add(struct mqtt_client *client,
+				     uint16_t message_id,
+				     const struct iovec *iov, size_t iovcnt)
+{
+	return 0;
+}
+
+static inline void mqtt_msg_store_release(struct mqtt_client *client,
+					  uint16_t message_id,
+					  const uint8_t *data, uint32_t len)
+{
+}
+
+static inline void mqtt_msg_store_remove(struct mqtt_client *client,
+					 uint8_t type, uint16_t message_id)
+{
+}
+
+static inline int mqtt_msg_store_resend(struct mqtt_client *client,
+					bool session_present)
+{
+	return 0;
+}
+#endif /* CONFIG_MQTT_LIB_MSG_STORE */
+
 #ifdef __cplusplus
 }
 #endif
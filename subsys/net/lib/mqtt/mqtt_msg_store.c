@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file mqtt_msg_store.c
+ *
+ * @brief Store of the QoS 1 and QoS 2 messages awaiting acknowledgment.
+ *
+ * @details Messages are kept in the order they were sent, each one as a
+ *          header followed by the encoded packet, in the buffer provided
+ *          by the application. A PUBLISH is replaced in place by its
+ *          PUBREL once released, so retransmission keeps the original
+ *          order as required by the specification.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_mqtt_store, CONFIG_MQTT_LOG_LEVEL);
+
+#include "mqtt_internal.h"
+#include "mqtt_transport.h"
+#include "mqtt_os.h"
+
+/** Messages retransmitted with a single transport write. */
+#define MSG_STORE_RESEND_IOV 8
+
+/** Header of a stored message, not aligned in the buffer. */
+struct msg_store_hdr {
+	/** Length of the encoded packet following the header. */
+	uint32_t len;
+
+	/** Message id of the packet. */
+	uint16_t message_id;
+
+	/** MQTT_PKT_TYPE_PUBLISH or MQTT_PKT_TYPE_PUBREL. */
+	uint8_t type;
+};
+
+#define MSG_STORE_HDR_SIZE sizeof(struct msg_store_hdr)
+
+static void hdr_get(const struct mqtt_client *client, uint32_t offset,
+		    struct msg_store_hdr *hdr)
+{
+	memcpy(hdr, client->msg_store_buf + offset, MSG_STORE_HDR_SIZE);
+}
+
+static void hdr_set(struct mqtt_client *client, uint32_t offset,
+		    const struct msg_store_hdr *hdr)
+{
+	memcpy(client->msg_store_buf + offset, hdr, MSG_STORE_HDR_SIZE);
+}
+
+static uint32_t entry_size(const struct msg_store_hdr *hdr)
+{
+	return MSG_STORE_HDR_SIZE + hdr->len;
+}
+
+/** Returns the offset of the message with the given type and id. */
+static int entry_find(const struct mqtt_client *client, uint8_t type,
+		      uint16_t message_id, struct msg_store_hdr *hdr)
+{
+	uint32_t offset = 0U;
+
+	while (offset < client->internal.msg_store_len) {
+		hdr_get(client, offset, hdr);
+
+		if ((type == 0U || hdr->type == type) &&
+		    hdr->message_id == message_id) {
+			return offset;
+		}
+
+		offset += entry_size(hdr);
+	}
+
+	return -ENOENT;
+}
+
+/** Resizes the entry at offset, moving the entries following it. */
+static void entry_resize(struct mqtt_client *client, uint32_t offset,
+			 uint32_t old_size, uint32_t new_size)
+{
+	uint8_t *entry = client->msg_store_buf + offset;
+
+	memmove(entry + new_size, entry + old_size,
+		client->internal.msg_store_len - offset - old_size);
+	client->internal.msg_store_len -= old_size;
+	client->internal.msg_store_len += new_size;
+}
+
+static int entry_append(struct mqtt_client *client, uint8_t type,
+			uint16_t message_id, const struct iovec *iov,
+			size_t iovcnt)
+{
+	struct msg_store_hdr hdr = {
+		.message_id = message_id,
+		.type = type,
+	};
+	uint8_t *data;
+	size_t i;
+
+	for (i = 0; i < iovcnt; i++) {
+		hdr.len += iov[i].iov_len;
+	}
+
+	if (client->internal.msg_store_count >=
+				CONFIG_MQTT_LIB_MSG_STORE_MAX_INFLIGHT ||
+	    client->msg_store_buf_size - client->internal.msg_store_len <
+				entry_size(&hdr)) {
+		return -ENOBUFS;
+	}
+
+	hdr_set(client, client->internal.msg_store_len, &hdr);
+	data = client->msg_store_buf + client->internal.msg_store_len +
+	       MSG_STORE_HDR_SIZE;
+
+	for (i = 0; i < iovcnt; i++) {
+		memcpy(data, iov[i].iov_base, iov[i].iov_len);
+		data += iov[i].iov_len;
+	}
+
+	client->internal.msg_store_len += entry_size(&hdr);
+	client->internal.msg_store_count++;
+
+	return 0;
+}
+
+int mqtt_msg_store_add(struct mqtt_client *client, uint16_t message_id,
+		       const struct iovec *iov, size_t iovcnt)
+{
+	struct msg_store_hdr hdr;
+
+	if (client->msg_store_buf == NULL) {
+		return 0;
+	}
+
+	/* Published again by the application, the stored copy is kept. */
+	if (entry_find(client, 0U, message_id, &hdr) >= 0) {
+		MQTT_TRC("[CID %p]: Message id 0x%04x already stored", client,
+			 message_id);
+		return 0;
+	}
+
+	return entry_append(client, MQTT_PKT_TYPE_PUBLISH, message_id,
+			    iov, iovcnt);
+}
+
+void mqtt_msg_store_release(struct mqtt_client *client, uint16_t message_id,
+			    const uint8_t *data, uint32_t len)
+{
+	struct msg_store_hdr hdr;
+	struct iovec iov = {
+		.iov_base = (void *)data,
+		.iov_len = len,
+	};
+	uint32_t old_size;
+	int offset;
+
+	if (client->msg_store_buf == NULL) {
+		return;
+	}
+
+	offset = entry_find(client, 0U, message_id, &hdr);
+	if (offset < 0) {
+		/* Not sent through the store, keep the release anyway. */
+		if (entry_append(client, MQTT_PKT_TYPE_PUBREL, message_id,
+				 &iov, 1) < 0) {
+			MQTT_ERR("No room to store PUBREL 0x%04x", message_id);
+		}
+
+		return;
+	}
+
+	old_size = entry_size(&hdr);
+	hdr.type = MQTT_PKT_TYPE_PUBREL;
+	hdr.len = len;
+
+	/* A PUBREL is never longer than the PUBLISH it replaces. */
+	entry_resize(client, offset, old_size, entry_size(&hdr));
+	hdr_set(client, offset, &hdr);
+	memcpy(client->msg_store_buf + offset + MSG_STORE_HDR_SIZE, data, len);
+}
+
+void mqtt_msg_store_remove(struct mqtt_client *client, uint8_t type,
+			   uint16_t message_id)
+{
+	struct msg_store_hdr hdr;
+	int offset;
+
+	if (client->msg_store_buf == NULL) {
+		return;
+	}
+
+	offset = entry_find(client, type, message_id, &hdr);
+	if (offset < 0) {
+		MQTT_TRC("[CID %p]: Message id 0x%04x not stored", client,
+			 message_id);
+		return;
+	}
+
+	entry_resize(client, offset, entry_size(&hdr), 0U);
+	client->internal.msg_store_count--;
+}
+
+/** Drops the releases and clears the DUP flag for a new session. */
+static void msg_store_new_session(struct mqtt_client *client)
+{
+	struct msg_store_hdr hdr;
+	uint32_t offset = 0U;
+
+	while (offset < client->internal.msg_store_len) {
+		hdr_get(client, offset, &hdr);
+
+		if (hdr.type == MQTT_PKT_TYPE_PUBREL) {
+			entry_resize(client, offset, entry_size(&hdr), 0U);
+			client->internal.msg_store_count--;
+			continue;
+		}
+
+		client->msg_store_buf[offset + MSG_STORE_HDR_SIZE] &=
+							~MQTT_HEADER_DUP_MASK;
+		offset += entry_size(&hdr);
+	}
+}
+
+int mqtt_msg_store_resend(struct mqtt_client *client, bool session_present)
+{
+	struct iovec iov[MSG_STORE_RESEND_IOV];
+	struct msg_store_hdr hdr;
+	struct msghdr msg;
+	uint32_t offset = 0U;
+	size_t iovcnt = 0;
+	uint8_t *data;
+	int err_code;
+
+	if (client->msg_store_buf == NULL) {
+		return 0;
+	}
+
+	if (!session_present) {
+		/* The broker has no state of the previous session, the
+		 * published messages are sent again as new ones.
+		 */
+		msg_store_new_session(client);
+	}
+
+	MQTT_TRC("[CID %p]: Resending %u messages", client,
+		 client->internal.msg_store_count);
+
+	while (offset < client->internal.msg_store_len) {
+		hdr_get(client, offset, &hdr);
+		data = client->msg_store_buf + offset + MSG_STORE_HDR_SIZE;
+
+		if (session_present && hdr.type == MQTT_PKT_TYPE_PUBLISH) {
+			data[0] |= MQTT_HEADER_DUP_MASK;
+		}
+
+		iov[iovcnt].iov_base = data;
+		iov[iovcnt].iov_len = hdr.len;
+		iovcnt++;
+
+		offset += entry_size(&hdr);
+
+		if (iovcnt < ARRAY_SIZE(iov) &&
+		    offset < client->internal.msg_store_len) {
+			continue;
+		}
+
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = iov;
+		msg.msg_iovlen = iovcnt;
+
+		err_code = mqtt_transport_write_msg(client, &msg);
+		if (err_code < 0) {
+			return err_code;
+		}
+
+		client->internal.last_activity = mqtt_sys_tick_in_ms_get();
+		iovcnt = 0;
+	}
+
+	return 0;
+}
+
+int mqtt_inflight_count(const struct mqtt_client *client)
+{
+	NULL_PARAM_CHECK(client);
+
+	return client->internal.msg_store_count;
+}
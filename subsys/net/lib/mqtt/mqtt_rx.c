@@ -16,6 +16,105 @@ LOG_MODULE_REGISTER(net_mqtt_rx, CONFIG_MQTT_LOG_LEVEL);
  * @brief MQTT Received data handling.
  */
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+static void connack_limits_set(struct mqtt_client *client,
+			       const struct mqtt_connack_param *param)
+{
+	if (!mqtt_is_version_5(client)) {
+		return;
+	}
+
+	client->internal.receive_maximum = param->receive_maximum;
+	client->internal.topic_alias_maximum = param->topic_alias_maximum;
+
+	/* Stored messages are sent again right away and count as in
+	 * flight, releases included.
+	 */
+	client->internal.send_quota = param->receive_maximum;
+#if defined(CONFIG_MQTT_LIB_MSG_STORE)
+	client->internal.send_quota -= MIN(client->internal.send_quota,
+					   client->internal.msg_store_count);
+#endif
+}
+
+/** @brief Another QoS 1 or QoS 2 message may be sent to the server. */
+static void send_quota_release(struct mqtt_client *client)
+{
+	if (mqtt_is_version_5(client) &&
+	    client->internal.send_quota < client->internal.receive_maximum) {
+		client->internal.send_quota++;
+	}
+}
+
+/** @brief Records or resolves the topic alias of a received message. */
+static int rx_topic_alias_apply(struct mqtt_client *client,
+				struct mqtt_publish_param *param)
+{
+	struct mqtt_utf8 *topic = &param->message.topic.topic;
+	struct mqtt_topic_alias *alias;
+
+	if (param->topic_alias == 0U) {
+		return 0;
+	}
+
+	if (param->topic_alias > CONFIG_MQTT_TOPIC_ALIAS_MAX) {
+		MQTT_ERR("[CID %p]: Topic alias %u exceeds maximum", client,
+			 param->topic_alias);
+		return -EINVAL;
+	}
+
+	alias = &client->internal.rx_alias[param->topic_alias - 1];
+
+	if (topic->size > 0U) {
+		if (topic->size > sizeof(alias->topic)) {
+			MQTT_ERR("[CID %p]: Topic too long for alias %u",
+				 client, param->topic_alias);
+			return -EINVAL;
+		}
+
+		memcpy(alias->topic, topic->utf8, topic->size);
+		alias->len = topic->size;
+
+		return 0;
+	}
+
+	if (alias->len == 0U) {
+		MQTT_ERR("[CID %p]: Topic alias %u not set", client,
+			 param->topic_alias);
+		return -EINVAL;
+	}
+
+	topic->utf8 = alias->topic;
+	topic->size = alias->len;
+
+	return 0;
+}
+#else
+static void connack_limits_set(struct mqtt_client *client,
+			       const struct mqtt_connack_param *param)
+{
+}
+
+static void send_quota_release(struct mqtt_client *client)
+{
+}
+
+static int rx_topic_alias_apply(struct mqtt_client *client,
+				struct mqtt_publish_param *param)
+{
+	return 0;
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
+/** @brief Checks if an MQTT 5.0 Reason Code of an acknowledgment is an
+ *         error.
+ */
+#if defined(CONFIG_MQTT_VERSION_5_0)
+#define ACK_FAILED(param) ((param)->reason_code >= MQTT_REASON_CODE_FAILURE)
+#else
+#define ACK_FAILED(param) false
+#endif
+
 static int mqtt_handle_packet(struct mqtt_client *client,
 			      uint8_t type_and_flags,
 			      uint32_t var_length,
@@ -42,6 +141,11 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 						MQTT_CONNECTION_ACCEPTED) {
 				/* Set state. */
 				MQTT_SET_STATE(client, MQTT_STATE_CONNECTED);
+				connack_limits_set(client, &evt.param.connack);
+
+				/* Messages not acknowledged before. */
+				err_code = mqtt_msg_store_resend(client,
+					evt.param.connack.session_present_flag);
 			} else {
 				err_code = -ECONNREFUSED;
 			}
@@ -57,8 +161,13 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		MQTT_TRC("[CID %p]: Received MQTT_PKT_TYPE_PUBLISH", client);
 
 		evt.type = MQTT_EVT_PUBLISH;
-		err_code = publish_decode(type_and_flags, var_length, buf,
-					  &evt.param.publish);
+		err_code = publish_decode(client, type_and_flags, var_length,
+					  buf, &evt.param.publish);
+		if (err_code == 0) {
+			err_code = rx_topic_alias_apply(client,
+							&evt.param.publish);
+		}
+
 		evt.result = err_code;
 
 		client->internal.remaining_payload =
@@ -77,6 +186,11 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		evt.type = MQTT_EVT_PUBACK;
 		err_code = publish_ack_decode(buf, &evt.param.puback);
 		evt.result = err_code;
+		if (err_code == 0) {
+			mqtt_msg_store_remove(client, MQTT_PKT_TYPE_PUBLISH,
+					      evt.param.puback.message_id);
+			send_quota_release(client);
+		}
 		break;
 
 	case MQTT_PKT_TYPE_PUBREC:
@@ -85,6 +199,12 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		evt.type = MQTT_EVT_PUBREC;
 		err_code = publish_receive_decode(buf, &evt.param.pubrec);
 		evt.result = err_code;
+		if (err_code == 0 && ACK_FAILED(&evt.param.pubrec)) {
+			/* The message is dropped, no release follows. */
+			mqtt_msg_store_remove(client, MQTT_PKT_TYPE_PUBLISH,
+					      evt.param.pubrec.message_id);
+			send_quota_release(client);
+		}
 		break;
 
 	case MQTT_PKT_TYPE_PUBREL:
@@ -101,13 +221,19 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		evt.type = MQTT_EVT_PUBCOMP;
 		err_code = publish_complete_decode(buf, &evt.param.pubcomp);
 		evt.result = err_code;
+		if (err_code == 0) {
+			mqtt_msg_store_remove(client, MQTT_PKT_TYPE_PUBREL,
+					      evt.param.pubcomp.message_id);
+			send_quota_release(client);
+		}
 		break;
 
 	case MQTT_PKT_TYPE_SUBACK:
 		MQTT_TRC("[CID %p]: Received MQTT_PKT_TYPE_SUBACK!", client);
 
 		evt.type = MQTT_EVT_SUBACK;
-		err_code = subscribe_ack_decode(buf, &evt.param.suback);
+		err_code = subscribe_ack_decode(client, buf,
+						&evt.param.suback);
 		evt.result = err_code;
 		break;
 
@@ -115,7 +241,8 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		MQTT_TRC("[CID %p]: Received MQTT_PKT_TYPE_UNSUBACK!", client);
 
 		evt.type = MQTT_EVT_UNSUBACK;
-		err_code = unsubscribe_ack_decode(buf, &evt.param.unsuback);
+		err_code = unsubscribe_ack_decode(client, buf,
+						  &evt.param.unsuback);
 		evt.result = err_code;
 		break;
 
@@ -132,6 +259,31 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		evt.type = MQTT_EVT_PINGRESP;
 		break;
 
+	case MQTT_PKT_TYPE_DISCONNECT: {
+		uint8_t reason_code;
+
+		if (!mqtt_is_version_5(client)) {
+			notify_event = false;
+			break;
+		}
+
+		MQTT_TRC("[CID %p]: Received MQTT_PKT_TYPE_DISCONNECT!",
+			 client);
+
+		/* The connection is closed and the application notified
+		 * with MQTT_EVT_DISCONNECT.
+		 */
+		notify_event = false;
+		err_code = disconnect_decode(buf, &reason_code);
+		if (err_code == 0) {
+			MQTT_ERR("[CID %p]: Disconnected by the server, "
+				 "reason 0x%02x", client, reason_code);
+			err_code = -ECONNRESET;
+		}
+
+		break;
+	}
+
 	default:
 		/* Nothing to notify. */
 		notify_event = false;
@@ -191,6 +343,42 @@ static int mqtt_read_message_chunk(struct mqtt_client *client,
 	return 0;
 }
 
+/* The properties of an MQTT 5.0 Publish follow the message id, their
+ * length is a Variable Byte Integer read one byte at a time.
+ */
+static int mqtt_read_publish_properties(struct mqtt_client *client,
+					struct buf_ctx *buf,
+					uint32_t variable_header_length)
+{
+	struct buf_ctx length_buf;
+	uint32_t properties_length;
+	uint32_t length_size = 0U;
+	int err_code;
+
+	do {
+		length_size++;
+		err_code = mqtt_read_message_chunk(client, buf,
+					variable_header_length + length_size);
+		if (err_code < 0) {
+			return err_code;
+		}
+
+		length_buf.cur = buf->cur + variable_header_length;
+		length_buf.end = length_buf.cur + length_size;
+
+		err_code = properties_length_decode(&length_buf,
+						    &properties_length);
+	} while (err_code == -EAGAIN);
+
+	if (err_code < 0) {
+		return err_code;
+	}
+
+	return mqtt_read_message_chunk(client, buf,
+				       variable_header_length + length_size +
+				       properties_length);
+}
+
 static int mqtt_read_publish_var_header(struct mqtt_client *client,
 					uint8_t type_and_flags,
 					struct buf_ctx *buf)
@@ -223,6 +411,14 @@ static int mqtt_read_publish_var_header(struct mqtt_client *client,
 		return err_code;
 	}
 
+	if (mqtt_is_version_5(client)) {
+		err_code = mqtt_read_publish_properties(
+				client, buf, variable_header_length);
+		if (err_code < 0) {
+			return err_code;
+		}
+	}
+
 	return 0;
 }
 
@@ -346,6 +346,18 @@ static void zsock_received_cb(struct net_context *ctx,
 
 	if (net_context_get_type(ctx) == SOCK_STREAM) {
 		net_context_update_recv_wnd(ctx, -net_pkt_remaining_data(pkt));
+	} else if (IS_ENABLED(CONFIG_NET_CONTEXT_RCVBUF) &&
+		   net_context_get_type(ctx) == SOCK_DGRAM) {
+		/* Datagrams that do not fit into the receive buffer are
+		 * dropped instead of tying up network buffers.
+		 */
+		if (net_context_update_recv_wnd(
+			    ctx, -net_pkt_remaining_data(pkt)) == -ENOBUFS) {
+			NET_DBG("ctx=%p, receive buffer full, drop pkt=%p",
+				ctx, pkt);
+			net_pkt_unref(pkt);
+			return;
+		}
 	}
 
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
@@ -953,6 +965,11 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 		pkt = k_fifo_peek_head(&ctx->recv_q);
 	} else {
 		pkt = k_fifo_get(&ctx->recv_q, timeout);
+
+		if (IS_ENABLED(CONFIG_NET_CONTEXT_RCVBUF) && pkt) {
+			net_context_update_recv_wnd(
+				ctx, net_pkt_remaining_data(pkt));
+		}
 	}
 
 	if (!pkt) {
@@ -1509,6 +1526,61 @@ int zsock_getsockopt_ctx(struct net_context *ctx, int level, int optname,
 
 				return 0;
 			}
+
+			break;
+
+		case SO_RCVBUF:
+		case SO_SNDBUF:
+			if ((optname == SO_RCVBUF &&
+			     IS_ENABLED(CONFIG_NET_CONTEXT_RCVBUF)) ||
+			    (optname == SO_SNDBUF &&
+			     IS_ENABLED(CONFIG_NET_CONTEXT_SNDBUF))) {
+				size_t len;
+
+				if (*optlen < sizeof(int)) {
+					errno = EINVAL;
+					return -1;
+				}
+
+				ret = net_context_get_option(
+					ctx, optname == SO_RCVBUF ?
+					NET_OPT_RCVBUF : NET_OPT_SNDBUF,
+					optval, &len);
+				if (ret < 0) {
+					errno = -ret;
+					return -1;
+				}
+
+				*optlen = len;
+
+				return 0;
+			}
+
+			break;
+		}
+
+		break;
+
+	case IPPROTO_TCP:
+		switch (optname) {
+		case TCP_CONGESTION:
+			if (IS_ENABLED(CONFIG_NET_TCP_CONGESTION_CONTROL)) {
+				size_t len = *optlen;
+
+				ret = net_context_get_option(
+					ctx, NET_OPT_TCP_CONGESTION,
+					optval, &len);
+				if (ret < 0) {
+					errno = -ret;
+					return -1;
+				}
+
+				*optlen = len;
+
+				return 0;
+			}
+
+			break;
 		}
 
 		break;
@@ -1662,6 +1734,26 @@ int zsock_setsockopt_ctx(struct net_context *ctx, int level, int optname,
 				return 0;
 			}
 
+			break;
+
+		case SO_RCVBUF:
+		case SO_SNDBUF:
+			if ((optname == SO_RCVBUF &&
+			     IS_ENABLED(CONFIG_NET_CONTEXT_RCVBUF)) ||
+			    (optname == SO_SNDBUF &&
+			     IS_ENABLED(CONFIG_NET_CONTEXT_SNDBUF))) {
+				ret = net_context_set_option(
+					ctx, optname == SO_RCVBUF ?
+					NET_OPT_RCVBUF : NET_OPT_SNDBUF,
+					optval, optlen);
+				if (ret < 0) {
+					errno = -ret;
+					return -1;
+				}
+
+				return 0;
+			}
+
 			break;
 		}
 
@@ -1674,6 +1766,21 @@ int zsock_setsockopt_ctx(struct net_context *ctx, int level, int optname,
 			 * existing apps.
 			 */
 			return 0;
+
+		case TCP_CONGESTION:
+			if (IS_ENABLED(CONFIG_NET_TCP_CONGESTION_CONTROL)) {
+				ret = net_context_set_option(
+					ctx, NET_OPT_TCP_CONGESTION,
+					optval, optlen);
+				if (ret < 0) {
+					errno = -ret;
+					return -1;
+				}
+
+				return 0;
+			}
+
+			break;
 		}
 		break;
 
@@ -32,6 +32,9 @@ LOG_MODULE_REGISTER(net_sock_tls, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <mbedtls/x509_crt.h>
 #include <mbedtls/ssl.h>
 #include <mbedtls/ssl_cookie.h>
+#if defined(MBEDTLS_SSL_TICKET_C)
+#include <mbedtls/ssl_ticket.h>
+#endif
 #include <mbedtls/error.h>
 #include <mbedtls/debug.h>
 #endif /* CONFIG_MBEDTLS */
@@ -120,8 +123,23 @@ struct tls_context {
 		 * protocols.
 		 */
 		const char *alpn_list[ALPN_MAX_PROTOCOLS];
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+		/** Information whether session resumption is enabled. */
+		bool cache_enabled;
+#endif
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+		/** Information whether a DTLS server serves many peers. */
+		bool multi_peer;
+#endif
 	} options;
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	/** Client session cache key of the peer, 0 for servers. */
+	uint32_t session_key;
+#endif
+
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	/** Context information for DTLS timing. */
 	struct dtls_timing_context dtls_timing;
@@ -276,6 +294,9 @@ static int dtls_timing_get_delay(void *data)
 }
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
+static void tls_session_cache_init(void);
+static void dtls_multi_peer_init(void);
+
 /* Initialize TLS internals. */
 static int tls_init(const struct device *unused)
 {
@@ -299,6 +320,10 @@ static int tls_init(const struct device *unused)
 
 	k_mutex_init(&context_lock);
 
+	tls_session_cache_init();
+
+	dtls_multi_peer_init();
+
 	mbedtls_ctr_drbg_init(&tls_ctr_drbg);
 
 	ret = mbedtls_ctr_drbg_seed(&tls_ctr_drbg, tls_entropy_func, NULL,
@@ -323,6 +348,16 @@ static inline bool is_handshake_complete(struct tls_context *ctx)
 	return k_sem_count_get(&ctx->tls_established) != 0;
 }
 
+static inline bool dtls_is_multi_peer(struct tls_context *ctx)
+{
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+	return ctx->options.multi_peer &&
+	       ctx->options.role == MBEDTLS_SSL_IS_SERVER;
+#else
+	return false;
+#endif
+}
+
 /*
  * Copied from include/mbedtls/ssl_internal.h
  *
@@ -481,35 +516,36 @@ static inline int time_left(uint32_t start, uint32_t timeout)
 }
 
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
-static bool dtls_is_peer_addr_valid(struct tls_context *context,
-				    const struct sockaddr *peer_addr,
-				    socklen_t addrlen)
+static bool dtls_addr_cmp(const struct sockaddr *addr1, socklen_t addrlen1,
+			  const struct sockaddr *addr2, socklen_t addrlen2)
 {
-	if (context->dtls_peer_addrlen != addrlen ||
-	    context->dtls_peer_addr.sa_family != peer_addr->sa_family) {
+	if (addrlen1 != addrlen2 || addr1->sa_family != addr2->sa_family) {
 		return false;
 	}
 
-	if (IS_ENABLED(CONFIG_NET_IPV6) && peer_addr->sa_family == AF_INET6) {
-		struct sockaddr_in6 *addr1 = net_sin6(peer_addr);
-		struct sockaddr_in6 *addr2 =
-				net_sin6(&context->dtls_peer_addr);
-
-		return (addr1->sin6_port == addr2->sin6_port) &&
-			net_ipv6_addr_cmp(&addr1->sin6_addr, &addr2->sin6_addr);
-	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
-		   peer_addr->sa_family == AF_INET) {
-		struct sockaddr_in *addr1 = net_sin(peer_addr);
-		struct sockaddr_in *addr2 =
-				net_sin(&context->dtls_peer_addr);
-
-		return (addr1->sin_port == addr2->sin_port) &&
-			net_ipv4_addr_cmp(&addr1->sin_addr, &addr2->sin_addr);
+	if (IS_ENABLED(CONFIG_NET_IPV6) && addr1->sa_family == AF_INET6) {
+		return (net_sin6(addr1)->sin6_port ==
+			net_sin6(addr2)->sin6_port) &&
+			net_ipv6_addr_cmp(&net_sin6(addr1)->sin6_addr,
+					  &net_sin6(addr2)->sin6_addr);
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) && addr1->sa_family == AF_INET) {
+		return (net_sin(addr1)->sin_port ==
+			net_sin(addr2)->sin_port) &&
+			net_ipv4_addr_cmp(&net_sin(addr1)->sin_addr,
+					  &net_sin(addr2)->sin_addr);
 	}
 
 	return false;
 }
 
+static bool dtls_is_peer_addr_valid(struct tls_context *context,
+				    const struct sockaddr *peer_addr,
+				    socklen_t addrlen)
+{
+	return dtls_addr_cmp(&context->dtls_peer_addr,
+			     context->dtls_peer_addrlen, peer_addr, addrlen);
+}
+
 static void dtls_peer_address_set(struct tls_context *context,
 				  const struct sockaddr *peer_addr,
 				  socklen_t addrlen)
@@ -827,6 +863,395 @@ exit:
 	return err;
 }
 
+#define FNV1A_INIT 2166136261U
+
+static inline uint32_t fnv1a(uint32_t hash, const void *data, size_t len)
+{
+	const uint8_t *p = data;
+
+	while (len--) {
+		hash = (hash ^ *p++) * 16777619U;
+	}
+
+	return hash;
+}
+
+static inline uint32_t fnv1a_sockaddr(uint32_t hash,
+				      const struct sockaddr *addr,
+				      socklen_t addrlen)
+{
+	if (IS_ENABLED(CONFIG_NET_IPV6) && addr->sa_family == AF_INET6 &&
+	    addrlen >= sizeof(struct sockaddr_in6)) {
+		hash = fnv1a(hash, &net_sin6(addr)->sin6_addr,
+			     sizeof(struct in6_addr));
+		hash = fnv1a(hash, &net_sin6(addr)->sin6_port,
+			     sizeof(uint16_t));
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) && addr->sa_family == AF_INET &&
+		   addrlen >= sizeof(struct sockaddr_in)) {
+		hash = fnv1a(hash, &net_sin(addr)->sin_addr,
+			     sizeof(struct in_addr));
+		hash = fnv1a(hash, &net_sin(addr)->sin_port,
+			     sizeof(uint16_t));
+	}
+
+	return hash;
+}
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+#define SESSION_LIFETIME_MS \
+	(CONFIG_NET_SOCKETS_TLS_SESSION_LIFETIME * MSEC_PER_SEC)
+
+/** Session cached by a TLS client. */
+struct tls_client_session {
+	/** Cache key of the peer, 0 if the entry is not used. */
+	uint32_t key;
+
+	/** Uptime when the session was stored. */
+	int64_t timestamp;
+
+	/** mbedTLS session, including the session ID or ticket. */
+	mbedtls_ssl_session session;
+};
+
+/** Session cached by a TLS server, the subset of mbedtls_ssl_session
+ *  needed to resume it by session ID.
+ */
+struct tls_server_session {
+	/** Uptime when the session was stored. */
+	int64_t timestamp;
+
+	int ciphersuite;
+	int compression;
+	uint32_t verify_result;
+	size_t id_len;
+	unsigned char id[32];
+	unsigned char master[48];
+};
+
+static struct tls_client_session
+	client_sessions[CONFIG_NET_SOCKETS_TLS_SESSION_CACHE_SIZE];
+static struct tls_server_session
+	server_sessions[CONFIG_NET_SOCKETS_TLS_SERVER_SESSION_CACHE_SIZE];
+static struct tls_session_cache_stats session_stats;
+
+/* Protects the session caches and statistics. */
+static struct k_mutex session_lock;
+
+#if defined(MBEDTLS_SSL_TICKET_C) && defined(MBEDTLS_GCM_C)
+#define TLS_SESSION_TICKETS 1
+
+static mbedtls_ssl_ticket_context ticket_ctx;
+static bool ticket_ctx_ready;
+#endif
+
+static void tls_session_cache_init(void)
+{
+	int i;
+
+	k_mutex_init(&session_lock);
+
+	for (i = 0; i < ARRAY_SIZE(client_sessions); i++) {
+		mbedtls_ssl_session_init(&client_sessions[i].session);
+	}
+
+#if defined(TLS_SESSION_TICKETS)
+	mbedtls_ssl_ticket_init(&ticket_ctx);
+#endif
+}
+
+static inline bool session_expired(int64_t timestamp)
+{
+	return k_uptime_get() - timestamp > SESSION_LIFETIME_MS;
+}
+
+/* Key of the client cache. A collision only makes the client offer a
+ * session the server does not know, which ends in a full handshake.
+ */
+static uint32_t tls_session_key(struct tls_context *ctx,
+				const struct sockaddr *addr, socklen_t addrlen)
+{
+	uint32_t hash = FNV1A_INIT;
+
+	hash = fnv1a(hash, &ctx->type, sizeof(ctx->type));
+	hash = fnv1a(hash, ctx->options.sec_tag_list.sec_tags,
+		     ctx->options.sec_tag_list.sec_tag_count *
+		     sizeof(sec_tag_t));
+
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+	if (ctx->options.is_hostname_set && ctx->ssl.hostname) {
+		return fnv1a(hash, ctx->ssl.hostname,
+			     strlen(ctx->ssl.hostname)) | 1U;
+	}
+#endif
+
+	/* No hostname, the peer is identified by its address. */
+	hash = fnv1a_sockaddr(hash, addr, addrlen);
+
+	/* Zero marks a free entry */
+	return hash | 1U;
+}
+
+static struct tls_client_session *client_session_find(uint32_t key)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(client_sessions); i++) {
+		if (client_sessions[i].key != key) {
+			continue;
+		}
+
+		if (session_expired(client_sessions[i].timestamp)) {
+			client_sessions[i].key = 0U;
+			mbedtls_ssl_session_free(&client_sessions[i].session);
+			return NULL;
+		}
+
+		return &client_sessions[i];
+	}
+
+	return NULL;
+}
+
+/* Offer the cached session of the peer in the next handshake. */
+static void tls_session_restore(struct tls_context *ctx,
+				const struct sockaddr *addr,
+				socklen_t addrlen)
+{
+	struct tls_client_session *entry;
+
+	if (!ctx->options.cache_enabled) {
+		return;
+	}
+
+	ctx->session_key = tls_session_key(ctx, addr, addrlen);
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+
+	entry = client_session_find(ctx->session_key);
+	if (entry && mbedtls_ssl_set_session(&ctx->ssl,
+					     &entry->session) != 0) {
+		NET_DBG("Cannot restore TLS session");
+	}
+
+	k_mutex_unlock(&session_lock);
+}
+
+/* Update the client cache after a successful handshake. */
+static void tls_session_save(struct tls_context *ctx)
+{
+	struct tls_client_session *entry;
+	int i;
+
+	if (ctx->session_key == 0U) {
+		return;
+	}
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+
+	entry = client_session_find(ctx->session_key);
+
+	/* A resumed session keeps the master secret of the cached one,
+	 * a full handshake always derives a new one.
+	 */
+	if (entry && memcmp(entry->session.master, ctx->ssl.session->master,
+			    sizeof(entry->session.master)) == 0) {
+		session_stats.client_resumed++;
+	} else {
+		session_stats.client_full++;
+	}
+
+	if (!entry) {
+		entry = &client_sessions[0];
+
+		for (i = 0; i < ARRAY_SIZE(client_sessions); i++) {
+			if (client_sessions[i].key == 0U ||
+			    session_expired(client_sessions[i].timestamp)) {
+				entry = &client_sessions[i];
+				break;
+			}
+
+			if (client_sessions[i].timestamp < entry->timestamp) {
+				entry = &client_sessions[i];
+			}
+		}
+
+		if (entry->key != 0U && !session_expired(entry->timestamp)) {
+			session_stats.evictions++;
+		}
+	}
+
+	/* The server may have issued a new ticket, so store the session
+	 * even if it was resumed.
+	 */
+	if (mbedtls_ssl_get_session(&ctx->ssl, &entry->session) == 0) {
+		entry->key = ctx->session_key;
+		entry->timestamp = k_uptime_get();
+		session_stats.client_stored++;
+	} else {
+		entry->key = 0U;
+		mbedtls_ssl_session_free(&entry->session);
+	}
+
+	k_mutex_unlock(&session_lock);
+}
+
+/* mbedTLS callback to look up a session offered by a client. */
+static int tls_server_session_get(void *data, mbedtls_ssl_session *session)
+{
+	struct tls_server_session *entry;
+	int i, ret = 1;
+
+	ARG_UNUSED(data);
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(server_sessions); i++) {
+		entry = &server_sessions[i];
+
+		if (entry->id_len == 0 || session_expired(entry->timestamp) ||
+		    entry->ciphersuite != session->ciphersuite ||
+		    entry->compression != session->compression ||
+		    entry->id_len != session->id_len ||
+		    memcmp(entry->id, session->id, entry->id_len) != 0) {
+			continue;
+		}
+
+		memcpy(session->master, entry->master, sizeof(entry->master));
+		session->verify_result = entry->verify_result;
+
+		session_stats.server_hits++;
+		ret = 0;
+		break;
+	}
+
+	if (ret) {
+		session_stats.server_misses++;
+	}
+
+	k_mutex_unlock(&session_lock);
+
+	return ret;
+}
+
+/* mbedTLS callback to store a session after a server handshake. */
+static int tls_server_session_set(void *data,
+				  const mbedtls_ssl_session *session)
+{
+	struct tls_server_session *oldest = &server_sessions[0];
+	struct tls_server_session *entry = NULL, *unused = NULL;
+	struct tls_server_session *cur;
+	int i;
+
+	ARG_UNUSED(data);
+
+	if (session->id_len == 0 || session->id_len > sizeof(cur->id)) {
+		return 1;
+	}
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(server_sessions); i++) {
+		cur = &server_sessions[i];
+
+		if (cur->id_len == session->id_len &&
+		    memcmp(cur->id, session->id, session->id_len) == 0) {
+			entry = cur;
+			break;
+		}
+
+		if (!unused &&
+		    (cur->id_len == 0 || session_expired(cur->timestamp))) {
+			unused = cur;
+		}
+
+		if (cur->timestamp < oldest->timestamp) {
+			oldest = cur;
+		}
+	}
+
+	if (!entry) {
+		entry = unused;
+	}
+
+	if (!entry) {
+		entry = oldest;
+		session_stats.evictions++;
+	}
+
+	entry->timestamp = k_uptime_get();
+	entry->ciphersuite = session->ciphersuite;
+	entry->compression = session->compression;
+	entry->verify_result = session->verify_result;
+	entry->id_len = session->id_len;
+	memcpy(entry->id, session->id, session->id_len);
+	memcpy(entry->master, session->master, sizeof(entry->master));
+
+	session_stats.server_stored++;
+
+	k_mutex_unlock(&session_lock);
+
+	return 0;
+}
+
+static void tls_session_server_setup(struct tls_context *ctx)
+{
+	if (!ctx->options.cache_enabled) {
+		return;
+	}
+
+	mbedtls_ssl_conf_session_cache(&ctx->config, NULL,
+				       tls_server_session_get,
+				       tls_server_session_set);
+
+#if defined(TLS_SESSION_TICKETS)
+	k_mutex_lock(&session_lock, K_FOREVER);
+
+	/* The ticket key is shared by all the server sockets so that
+	 * tickets stay valid across connections.
+	 */
+	if (!ticket_ctx_ready &&
+	    mbedtls_ssl_ticket_setup(&ticket_ctx, mbedtls_ctr_drbg_random,
+				     &tls_ctr_drbg, MBEDTLS_CIPHER_AES_128_GCM,
+				     CONFIG_NET_SOCKETS_TLS_SESSION_LIFETIME)
+	    == 0) {
+		ticket_ctx_ready = true;
+	}
+
+	k_mutex_unlock(&session_lock);
+
+	if (ticket_ctx_ready) {
+		mbedtls_ssl_conf_session_tickets_cb(&ctx->config,
+						    mbedtls_ssl_ticket_write,
+						    mbedtls_ssl_ticket_parse,
+						    &ticket_ctx);
+	}
+#endif /* TLS_SESSION_TICKETS */
+}
+
+static void tls_session_cache_purge(void)
+{
+	int i;
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(client_sessions); i++) {
+		client_sessions[i].key = 0U;
+		mbedtls_ssl_session_free(&client_sessions[i].session);
+	}
+
+	(void)memset(server_sessions, 0, sizeof(server_sessions));
+
+	k_mutex_unlock(&session_lock);
+}
+#else
+static inline void tls_session_cache_init(void) {}
+static inline void tls_session_restore(struct tls_context *ctx,
+				       const struct sockaddr *addr,
+				       socklen_t addrlen) {}
+static inline void tls_session_save(struct tls_context *ctx) {}
+static inline void tls_session_server_setup(struct tls_context *ctx) {}
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE */
+
 static int tls_mbedtls_reset(struct tls_context *context)
 {
 	int ret;
@@ -877,131 +1302,703 @@ static int tls_mbedtls_handshake(struct tls_context *context, bool block)
 		break;
 	}
 
-	if (ret == 0) {
-		k_sem_give(&context->tls_established);
+	if (ret == 0) {
+		tls_session_save(context);
+		k_sem_give(&context->tls_established);
+	}
+
+	return ret;
+}
+
+static int tls_mbedtls_init(struct tls_context *context, bool is_server)
+{
+	int role, type, ret;
+
+	role = is_server ? MBEDTLS_SSL_IS_SERVER : MBEDTLS_SSL_IS_CLIENT;
+
+	type = (context->type == SOCK_STREAM) ?
+		MBEDTLS_SSL_TRANSPORT_STREAM :
+		MBEDTLS_SSL_TRANSPORT_DATAGRAM;
+
+	if (type == MBEDTLS_SSL_TRANSPORT_STREAM) {
+		mbedtls_ssl_set_bio(&context->ssl, context,
+				    tls_tx, tls_rx, NULL);
+	} else {
+#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
+		mbedtls_ssl_set_bio(&context->ssl, context,
+				    dtls_tx, NULL, dtls_rx);
+#else
+		return -ENOTSUP;
+#endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
+	}
+
+	ret = mbedtls_ssl_config_defaults(&context->config, role, type,
+					  MBEDTLS_SSL_PRESET_DEFAULT);
+	if (ret != 0) {
+		/* According to mbedTLS API documentation,
+		 * mbedtls_ssl_config_defaults can fail due to memory
+		 * allocation failure
+		 */
+		return -ENOMEM;
+	}
+
+#if defined(MBEDTLS_SSL_RENEGOTIATION)
+	mbedtls_ssl_conf_legacy_renegotiation(&context->config,
+					   MBEDTLS_SSL_LEGACY_BREAK_HANDSHAKE);
+	mbedtls_ssl_conf_renegotiation(&context->config,
+				       MBEDTLS_SSL_RENEGOTIATION_ENABLED);
+#endif
+
+#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
+	if (type == MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
+		/* DTLS requires timer callbacks to operate */
+		mbedtls_ssl_set_timer_cb(&context->ssl,
+					 &context->dtls_timing,
+					 dtls_timing_set_delay,
+					 dtls_timing_get_delay);
+
+		/* Configure cookie for DTLS server */
+		if (role == MBEDTLS_SSL_IS_SERVER) {
+			ret = mbedtls_ssl_cookie_setup(&context->cookie,
+						       mbedtls_ctr_drbg_random,
+						       &tls_ctr_drbg);
+			if (ret != 0) {
+				return -ENOMEM;
+			}
+
+			mbedtls_ssl_conf_dtls_cookies(&context->config,
+						      mbedtls_ssl_cookie_write,
+						      mbedtls_ssl_cookie_check,
+						      &context->cookie);
+
+			mbedtls_ssl_conf_read_timeout(
+					&context->config,
+					CONFIG_NET_SOCKETS_DTLS_TIMEOUT);
+		}
+	}
+#endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
+
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+	/* For TLS clients, set hostname to empty string to enforce it's
+	 * verification - only if hostname option was not set. Otherwise
+	 * depend on user configuration.
+	 */
+	if (!is_server && !context->options.is_hostname_set) {
+		mbedtls_ssl_set_hostname(&context->ssl, "");
+	}
+#endif
+
+	/* If verification level was specified explicitly, set it. Otherwise,
+	 * use mbedTLS default values (required for client, none for server)
+	 */
+	if (context->options.verify_level != -1) {
+		mbedtls_ssl_conf_authmode(&context->config,
+					  context->options.verify_level);
+	}
+
+	mbedtls_ssl_conf_rng(&context->config,
+			     mbedtls_ctr_drbg_random,
+			     &tls_ctr_drbg);
+
+	ret = tls_mbedtls_set_credentials(context);
+	if (ret != 0) {
+		return ret;
+	}
+
+	if (is_server) {
+		tls_session_server_setup(context);
+	}
+
+#if defined(CONFIG_MBEDTLS_SSL_ALPN)
+	if (ALPN_MAX_PROTOCOLS && context->options.alpn_list[0] != NULL) {
+		ret = mbedtls_ssl_conf_alpn_protocols(&context->config,
+				context->options.alpn_list);
+		if (ret != 0) {
+			return -EINVAL;
+		}
+	}
+#endif /* CONFIG_MBEDTLS_SSL_ALPN */
+
+	/* Each peer of a multi-peer socket has its own mbedTLS context. */
+	if (dtls_is_multi_peer(context)) {
+		context->is_initialized = true;
+		return 0;
+	}
+
+	ret = mbedtls_ssl_setup(&context->ssl,
+				&context->config);
+	if (ret != 0) {
+		/* According to mbedTLS API documentation,
+		 * mbedtls_ssl_setup can fail due to memory allocation failure
+		 */
+		return -ENOMEM;
+	}
+
+	context->is_initialized = true;
+
+	return 0;
+}
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+/* Largest datagram: record header, explicit IV, MAC and padding on top of
+ * the content, as MBEDTLS_SSL_IN_BUFFER_LEN in ssl_internal.h.
+ */
+#define DTLS_DATAGRAM_LEN (MBEDTLS_SSL_IN_CONTENT_LEN + 13 + 16 + 48 + 256)
+
+/* Length of a DTLS record header. */
+#define DTLS_HEADER_LEN 13
+
+/** DTLS session of a multi-peer server socket. */
+struct dtls_peer {
+	/** Entry in the peer hash table. */
+	sys_snode_t node;
+
+	/** Server socket context owning the peer, NULL if unused. */
+	struct tls_context *owner;
+
+	/** mbedTLS context of the session. */
+	mbedtls_ssl_context ssl;
+
+	/** Context information for DTLS timing. */
+	struct dtls_timing_context timing;
+
+	/** Peer address. */
+	struct sockaddr addr;
+
+	/** Peer address length. */
+	socklen_t addrlen;
+
+	/** Hash of the owner and the peer address. */
+	uint32_t hash;
+
+	/** Datagram returned to mbedTLS by the next read, if not NULL. */
+	const uint8_t *rx_buf;
+
+	/** Length of the datagram. */
+	size_t rx_len;
+
+	/** Time of the last datagram from the peer. */
+	uint32_t last_rx;
+
+	/** Information whether DTLS handshake is complete. */
+	bool established;
+};
+
+static struct dtls_peer dtls_peers[CONFIG_NET_SOCKETS_DTLS_MAX_PEERS];
+static sys_slist_t dtls_peer_table[CONFIG_NET_SOCKETS_DTLS_PEER_TABLE_SIZE];
+
+/* Protects the peers and the datagram buffer. */
+static struct k_mutex dtls_peer_lock;
+
+/* Datagram being dispatched to a peer. */
+static uint8_t dtls_datagram[DTLS_DATAGRAM_LEN];
+
+static void dtls_multi_peer_init(void)
+{
+	int i;
+
+	k_mutex_init(&dtls_peer_lock);
+
+	for (i = 0; i < ARRAY_SIZE(dtls_peer_table); i++) {
+		sys_slist_init(&dtls_peer_table[i]);
+	}
+}
+
+static int dtls_peer_tx(void *ctx, const unsigned char *buf, size_t len)
+{
+	struct dtls_peer *peer = ctx;
+	ssize_t sent;
+
+	sent = zsock_sendto(peer->owner->sock, buf, len, peer->owner->flags,
+			    &peer->addr, peer->addrlen);
+	if (sent < 0) {
+		if (errno == EAGAIN) {
+			return MBEDTLS_ERR_SSL_WANT_WRITE;
+		}
+
+		return MBEDTLS_ERR_NET_SEND_FAILED;
+	}
+
+	return sent;
+}
+
+/* The datagrams are read from the socket before the peer is known, so
+ * mbedTLS gets the one handed over to the peer, if any.
+ */
+static int dtls_peer_rx(void *ctx, unsigned char *buf, size_t len,
+			uint32_t dtls_timeout)
+{
+	struct dtls_peer *peer = ctx;
+	size_t rx_len;
+
+	ARG_UNUSED(dtls_timeout);
+
+	if (peer->rx_buf == NULL) {
+		return MBEDTLS_ERR_SSL_WANT_READ;
+	}
+
+	rx_len = MIN(peer->rx_len, len);
+	memcpy(buf, peer->rx_buf, rx_len);
+	peer->rx_buf = NULL;
+
+	return rx_len;
+}
+
+static inline sys_slist_t *dtls_peer_bucket(uint32_t hash)
+{
+	return &dtls_peer_table[hash % ARRAY_SIZE(dtls_peer_table)];
+}
+
+static uint32_t dtls_peer_hash(struct tls_context *owner,
+			       const struct sockaddr *addr, socklen_t addrlen)
+{
+	uint32_t hash = fnv1a(FNV1A_INIT, &owner, sizeof(owner));
+
+	return fnv1a_sockaddr(hash, addr, addrlen);
+}
+
+static void dtls_peer_insert(struct dtls_peer *peer,
+			     const struct sockaddr *addr,
+			     socklen_t addrlen)
+{
+	memcpy(&peer->addr, addr, addrlen);
+	peer->addrlen = addrlen;
+	peer->hash = dtls_peer_hash(peer->owner, addr, addrlen);
+
+	sys_slist_append(dtls_peer_bucket(peer->hash), &peer->node);
+}
+
+static struct dtls_peer *dtls_peer_find(struct tls_context *owner,
+					const struct sockaddr *addr,
+					socklen_t addrlen)
+{
+	uint32_t hash = dtls_peer_hash(owner, addr, addrlen);
+	struct dtls_peer *peer;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(dtls_peer_bucket(hash), peer, node) {
+		if (peer->owner == owner && peer->hash == hash &&
+		    dtls_addr_cmp(&peer->addr, peer->addrlen, addr, addrlen)) {
+			return peer;
+		}
+	}
+
+	return NULL;
+}
+
+static struct dtls_peer *dtls_peer_alloc(struct tls_context *owner,
+					 const struct sockaddr *addr,
+					 socklen_t addrlen)
+{
+	struct dtls_peer *peer = NULL;
+	int i, ret;
+
+	if (addrlen > sizeof(peer->addr)) {
+		return NULL;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(dtls_peers); i++) {
+		if (dtls_peers[i].owner == NULL) {
+			peer = &dtls_peers[i];
+			break;
+		}
+	}
+
+	if (!peer) {
+		NET_DBG("No free DTLS peer");
+		return NULL;
+	}
+
+	(void)memset(peer, 0, sizeof(*peer));
+
+	mbedtls_ssl_init(&peer->ssl);
+
+	ret = mbedtls_ssl_setup(&peer->ssl, &owner->config);
+	if (ret != 0) {
+		goto fail;
+	}
+
+	mbedtls_ssl_set_bio(&peer->ssl, peer, dtls_peer_tx, NULL,
+			    dtls_peer_rx);
+	mbedtls_ssl_set_timer_cb(&peer->ssl, &peer->timing,
+				 dtls_timing_set_delay, dtls_timing_get_delay);
+
+	ret = mbedtls_ssl_set_client_transport_id(
+		&peer->ssl, (const unsigned char *)addr, addrlen);
+	if (ret != 0) {
+		goto fail;
+	}
+
+	peer->owner = owner;
+	peer->last_rx = k_uptime_get_32();
+	dtls_peer_insert(peer, addr, addrlen);
+
+	NET_DBG("Allocated DTLS peer %d for %p", i, owner);
+
+	return peer;
+
+fail:
+	mbedtls_ssl_free(&peer->ssl);
+
+	return NULL;
+}
+
+static void dtls_peer_free(struct dtls_peer *peer)
+{
+	NET_DBG("Released DTLS peer %d", (int)(peer - dtls_peers));
+
+	sys_slist_find_and_remove(dtls_peer_bucket(peer->hash), &peer->node);
+	mbedtls_ssl_free(&peer->ssl);
+	peer->owner = NULL;
+}
+
+static void dtls_peer_close(struct dtls_peer *peer)
+{
+	if (peer->established) {
+		(void)mbedtls_ssl_close_notify(&peer->ssl);
+	}
+
+	dtls_peer_free(peer);
+}
+
+/* Let mbedTLS process the handed over datagram, or the records left from
+ * the previous one. Application data stays in the mbedTLS context until
+ * it is read.
+ */
+static int dtls_peer_run(struct dtls_peer *peer)
+{
+	unsigned char byte;
+	int ret;
+
+	if (!peer->established) {
+		ret = mbedtls_ssl_handshake(&peer->ssl);
+		if (ret == MBEDTLS_ERR_SSL_WANT_READ ||
+		    ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+			return 0;
+		} else if (ret == MBEDTLS_ERR_SSL_HELLO_VERIFY_REQUIRED) {
+			/* Keep no state until the client returns the cookie. */
+			return -ECONNRESET;
+		} else if (ret != 0) {
+			NET_DBG("DTLS handshake error: -%x", -ret);
+			return -ECONNABORTED;
+		}
+
+		peer->established = true;
+
+		/* Data may follow the Finished message in the datagram. */
+		if (!mbedtls_ssl_check_pending(&peer->ssl)) {
+			return 0;
+		}
+	}
+
+	ret = mbedtls_ssl_read(&peer->ssl, &byte, 0);
+	if (ret >= 0 || ret == MBEDTLS_ERR_SSL_WANT_READ ||
+	    ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+		return 0;
+	}
+
+	if (ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY) {
+		/* Do not answer the close notification. */
+		peer->established = false;
+	}
+
+	return -ECONNRESET;
+}
+
+/* Retransmit the handshake messages and drop the peers that timed out.
+ * Returns the time until the next timer of a peer expires, -1 if none.
+ */
+static int dtls_multi_peer_timers(struct tls_context *ctx)
+{
+	int timeout = -1;
+	int i, left;
+
+	for (i = 0; i < ARRAY_SIZE(dtls_peers); i++) {
+		struct dtls_peer *peer = &dtls_peers[i];
+
+		if (peer->owner != ctx) {
+			continue;
+		}
+
+		if (CONFIG_NET_SOCKETS_DTLS_TIMEOUT != 0 &&
+		    mbedtls_ssl_get_bytes_avail(&peer->ssl) == 0) {
+			left = time_left(peer->last_rx,
+					 CONFIG_NET_SOCKETS_DTLS_TIMEOUT);
+			if (left <= 0) {
+				dtls_peer_close(peer);
+				continue;
+			}
+
+			if (timeout < 0 || left < timeout) {
+				timeout = left;
+			}
+		}
+
+		if (peer->established || peer->timing.fin_ms == 0U) {
+			continue;
+		}
+
+		if (dtls_timing_get_delay(&peer->timing) == 2 &&
+		    dtls_peer_run(peer) < 0) {
+			dtls_peer_free(peer);
+			continue;
+		}
+
+		if (peer->timing.fin_ms != 0U) {
+			left = MAX(time_left(peer->timing.snapshot,
+					     peer->timing.fin_ms), 0);
+			if (timeout < 0 || left < timeout) {
+				timeout = left;
+			}
+		}
+	}
+
+	return timeout;
+}
+
+static struct dtls_peer *dtls_multi_peer_readable(struct tls_context *ctx)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(dtls_peers); i++) {
+		struct dtls_peer *peer = &dtls_peers[i];
+
+		if (peer->owner != ctx || !peer->established) {
+			continue;
+		}
+
+		/* A datagram can carry several records. */
+		while (mbedtls_ssl_get_bytes_avail(&peer->ssl) == 0 &&
+		       mbedtls_ssl_check_pending(&peer->ssl)) {
+			if (dtls_peer_run(peer) < 0) {
+				dtls_peer_close(peer);
+				break;
+			}
+		}
+
+		if (peer->owner == ctx &&
+		    mbedtls_ssl_get_bytes_avail(&peer->ssl) > 0) {
+			return peer;
+		}
+	}
+
+	return NULL;
+}
+
+/* Read one datagram from the socket and pass it to the session of its
+ * peer, creating the session for a ClientHello from a new peer.
+ */
+static int dtls_multi_peer_rx(struct tls_context *ctx)
+{
+	struct dtls_peer *peer;
+	socklen_t addrlen = sizeof(struct sockaddr);
+	struct sockaddr addr;
+	ssize_t len;
+	int ret;
+
+	len = zsock_recvfrom(ctx->sock, dtls_datagram, sizeof(dtls_datagram),
+			     ZSOCK_MSG_DONTWAIT, &addr, &addrlen);
+	if (len < 0) {
+		return -errno;
+	}
+
+	peer = dtls_peer_find(ctx, &addr, addrlen);
+	if (!peer) {
+		if (len < DTLS_HEADER_LEN ||
+		    dtls_datagram[0] != MBEDTLS_SSL_MSG_HANDSHAKE) {
+			return 0;
+		}
+
+		peer = dtls_peer_alloc(ctx, &addr, addrlen);
+		if (!peer) {
+			return 0;
+		}
+	}
+
+	peer->rx_buf = dtls_datagram;
+	peer->rx_len = len;
+
+	ret = dtls_peer_run(peer);
+
+	peer->rx_buf = NULL;
+
+	if (ret < 0) {
+		dtls_peer_close(peer);
+		return 0;
+	}
+
+	peer->last_rx = k_uptime_get_32();
+
+	return 0;
+}
+
+/* Process the datagrams queued on the socket until a peer has data to
+ * read. Returns the peer, or NULL with the time until the next timer of
+ * a peer in timeout.
+ */
+static struct dtls_peer *dtls_multi_peer_process(struct tls_context *ctx,
+						 int *timeout)
+{
+	struct dtls_peer *peer;
+	int ret;
+
+	do {
+		*timeout = dtls_multi_peer_timers(ctx);
+
+		peer = dtls_multi_peer_readable(ctx);
+		if (peer) {
+			return peer;
+		}
+
+		ret = dtls_multi_peer_rx(ctx);
+	} while (ret == 0);
+
+	return NULL;
+}
+
+static ssize_t recvfrom_dtls_multi_peer(struct tls_context *ctx, void *buf,
+					size_t max_len, int flags,
+					struct sockaddr *src_addr,
+					socklen_t *addrlen)
+{
+	bool is_block = !((flags & ZSOCK_MSG_DONTWAIT) ||
+			  (zsock_fcntl(ctx->sock, F_GETFL, 0) & O_NONBLOCK));
+	struct zsock_pollfd fds;
+	struct dtls_peer *peer;
+	int timeout;
+	int ret;
+
+	k_mutex_lock(&dtls_peer_lock, K_FOREVER);
+
+	if (!ctx->is_initialized) {
+		ret = tls_mbedtls_init(ctx, true);
+		if (ret < 0) {
+			goto out;
+		}
+	}
+
+	while (true) {
+		peer = dtls_multi_peer_process(ctx, &timeout);
+		if (peer) {
+			ret = mbedtls_ssl_read(&peer->ssl, buf, max_len);
+			if (ret < 0) {
+				dtls_peer_close(peer);
+				continue;
+			}
+
+			if (src_addr && addrlen) {
+				*addrlen = MIN(*addrlen, peer->addrlen);
+				memcpy(src_addr, &peer->addr, *addrlen);
+			}
+
+			break;
+		}
+
+		if (!is_block) {
+			ret = -EAGAIN;
+			break;
+		}
+
+		/* Wait for a datagram or the next timer without the lock. */
+		k_mutex_unlock(&dtls_peer_lock);
+
+		fds.fd = ctx->sock;
+		fds.events = ZSOCK_POLLIN;
+
+		ret = zsock_poll(&fds, 1, timeout);
+
+		k_mutex_lock(&dtls_peer_lock, K_FOREVER);
+
+		if (ret < 0) {
+			ret = -errno;
+			break;
+		}
+	}
+
+out:
+	k_mutex_unlock(&dtls_peer_lock);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
 	}
 
 	return ret;
 }
 
-static int tls_mbedtls_init(struct tls_context *context, bool is_server)
+static ssize_t sendto_dtls_multi_peer(struct tls_context *ctx,
+				      const void *buf, size_t len,
+				      const struct sockaddr *dest_addr,
+				      socklen_t addrlen)
 {
-	int role, type, ret;
+	struct dtls_peer *peer;
+	int ret;
 
-	role = is_server ? MBEDTLS_SSL_IS_SERVER : MBEDTLS_SSL_IS_CLIENT;
+	if (!dest_addr) {
+		errno = EDESTADDRREQ;
+		return -1;
+	}
 
-	type = (context->type == SOCK_STREAM) ?
-		MBEDTLS_SSL_TRANSPORT_STREAM :
-		MBEDTLS_SSL_TRANSPORT_DATAGRAM;
+	k_mutex_lock(&dtls_peer_lock, K_FOREVER);
 
-	if (type == MBEDTLS_SSL_TRANSPORT_STREAM) {
-		mbedtls_ssl_set_bio(&context->ssl, context,
-				    tls_tx, tls_rx, NULL);
+	peer = dtls_peer_find(ctx, dest_addr, addrlen);
+	if (!peer || !peer->established) {
+		ret = -ENOTCONN;
 	} else {
-#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
-		mbedtls_ssl_set_bio(&context->ssl, context,
-				    dtls_tx, NULL, dtls_rx);
-#else
-		return -ENOTSUP;
-#endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
+		ret = mbedtls_ssl_write(&peer->ssl, buf, len);
+		if (ret == MBEDTLS_ERR_SSL_WANT_READ ||
+		    ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+			ret = -EAGAIN;
+		} else if (ret < 0) {
+			ret = -EIO;
+		}
 	}
 
-	ret = mbedtls_ssl_config_defaults(&context->config, role, type,
-					  MBEDTLS_SSL_PRESET_DEFAULT);
-	if (ret != 0) {
-		/* According to mbedTLS API documentation,
-		 * mbedtls_ssl_config_defaults can fail due to memory
-		 * allocation failure
-		 */
-		return -ENOMEM;
-	}
+	k_mutex_unlock(&dtls_peer_lock);
 
-#if defined(MBEDTLS_SSL_RENEGOTIATION)
-	mbedtls_ssl_conf_legacy_renegotiation(&context->config,
-					   MBEDTLS_SSL_LEGACY_BREAK_HANDSHAKE);
-	mbedtls_ssl_conf_renegotiation(&context->config,
-				       MBEDTLS_SSL_RENEGOTIATION_ENABLED);
-#endif
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
 
-#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
-	if (type == MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
-		/* DTLS requires timer callbacks to operate */
-		mbedtls_ssl_set_timer_cb(&context->ssl,
-					 &context->dtls_timing,
-					 dtls_timing_set_delay,
-					 dtls_timing_get_delay);
+	return ret;
+}
 
-		/* Configure cookie for DTLS server */
-		if (role == MBEDTLS_SSL_IS_SERVER) {
-			ret = mbedtls_ssl_cookie_setup(&context->cookie,
-						       mbedtls_ctr_drbg_random,
-						       &tls_ctr_drbg);
-			if (ret != 0) {
-				return -ENOMEM;
-			}
+static void dtls_multi_peer_release(struct tls_context *ctx)
+{
+	int i;
 
-			mbedtls_ssl_conf_dtls_cookies(&context->config,
-						      mbedtls_ssl_cookie_write,
-						      mbedtls_ssl_cookie_check,
-						      &context->cookie);
+	k_mutex_lock(&dtls_peer_lock, K_FOREVER);
 
-			mbedtls_ssl_conf_read_timeout(
-					&context->config,
-					CONFIG_NET_SOCKETS_DTLS_TIMEOUT);
+	for (i = 0; i < ARRAY_SIZE(dtls_peers); i++) {
+		if (dtls_peers[i].owner == ctx) {
+			dtls_peer_close(&dtls_peers[i]);
 		}
 	}
-#endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
-
-#if defined(MBEDTLS_X509_CRT_PARSE_C)
-	/* For TLS clients, set hostname to empty string to enforce it's
-	 * verification - only if hostname option was not set. Otherwise
-	 * depend on user configuration.
-	 */
-	if (!is_server && !context->options.is_hostname_set) {
-		mbedtls_ssl_set_hostname(&context->ssl, "");
-	}
-#endif
-
-	/* If verification level was specified explicitly, set it. Otherwise,
-	 * use mbedTLS default values (required for client, none for server)
-	 */
-	if (context->options.verify_level != -1) {
-		mbedtls_ssl_conf_authmode(&context->config,
-					  context->options.verify_level);
-	}
 
-	mbedtls_ssl_conf_rng(&context->config,
-			     mbedtls_ctr_drbg_random,
-			     &tls_ctr_drbg);
+	k_mutex_unlock(&dtls_peer_lock);
+}
 
-	ret = tls_mbedtls_set_credentials(context);
-	if (ret != 0) {
-		return ret;
-	}
+/* Data is ready when a peer has some. The datagrams are processed here
+ * as most of them are handshake or otherwise carry no data.
+ */
+static bool dtls_multi_peer_pollin(struct tls_context *ctx)
+{
+	struct dtls_peer *peer = NULL;
+	int timeout;
 
-#if defined(CONFIG_MBEDTLS_SSL_ALPN)
-	if (ALPN_MAX_PROTOCOLS && context->options.alpn_list[0] != NULL) {
-		ret = mbedtls_ssl_conf_alpn_protocols(&context->config,
-				context->options.alpn_list);
-		if (ret != 0) {
-			return -EINVAL;
-		}
-	}
-#endif /* CONFIG_MBEDTLS_SSL_ALPN */
+	k_mutex_lock(&dtls_peer_lock, K_FOREVER);
 
-	ret = mbedtls_ssl_setup(&context->ssl,
-				&context->config);
-	if (ret != 0) {
-		/* According to mbedTLS API documentation,
-		 * mbedtls_ssl_setup can fail due to memory allocation failure
-		 */
-		return -ENOMEM;
+	if (ctx->is_initialized || tls_mbedtls_init(ctx, true) == 0) {
+		peer = dtls_multi_peer_process(ctx, &timeout);
 	}
 
-	context->is_initialized = true;
+	k_mutex_unlock(&dtls_peer_lock);
 
-	return 0;
+	return peer != NULL;
 }
+#else
+static inline void dtls_multi_peer_init(void) {}
+#endif /* CONFIG_NET_SOCKETS_DTLS_MULTI_PEER */
 
 static int tls_opt_sec_tag_list_set(struct tls_context *context,
 				    const void *optval, socklen_t optlen)
@@ -1249,6 +2246,141 @@ static int tls_opt_dtls_role_set(struct tls_context *context,
 	return 0;
 }
 
+static int tls_opt_session_cache_set(struct tls_context *context,
+				     const void *optval, socklen_t optlen)
+{
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	int *cache;
+
+	if (!optval) {
+		return -EINVAL;
+	}
+
+	if (optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	cache = (int *)optval;
+	if (*cache != TLS_SESSION_CACHE_ENABLED &&
+	    *cache != TLS_SESSION_CACHE_DISABLED) {
+		return -EINVAL;
+	}
+
+	context->options.cache_enabled = (*cache == TLS_SESSION_CACHE_ENABLED);
+
+	return 0;
+#else
+	return -ENOPROTOOPT;
+#endif
+}
+
+static int tls_opt_session_cache_get(struct tls_context *context,
+				     void *optval, socklen_t *optlen)
+{
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	*(int *)optval = context->options.cache_enabled ?
+		TLS_SESSION_CACHE_ENABLED : TLS_SESSION_CACHE_DISABLED;
+
+	return 0;
+#else
+	return -ENOPROTOOPT;
+#endif
+}
+
+static int tls_opt_session_cache_purge(struct tls_context *context,
+				       const void *optval, socklen_t optlen)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(optval);
+	ARG_UNUSED(optlen);
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	tls_session_cache_purge();
+
+	return 0;
+#else
+	return -ENOPROTOOPT;
+#endif
+}
+
+static int tls_opt_session_cache_stats_get(struct tls_context *context,
+					   void *optval, socklen_t *optlen)
+{
+	ARG_UNUSED(context);
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	if (*optlen < sizeof(struct tls_session_cache_stats)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+	memcpy(optval, &session_stats, sizeof(session_stats));
+	k_mutex_unlock(&session_lock);
+
+	*optlen = sizeof(struct tls_session_cache_stats);
+
+	return 0;
+#else
+	return -ENOPROTOOPT;
+#endif
+}
+
+static int tls_opt_dtls_multi_peer_set(struct tls_context *context,
+				       const void *optval, socklen_t optlen)
+{
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+	int *multi_peer;
+
+	if (!optval) {
+		return -EINVAL;
+	}
+
+	if (optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	multi_peer = (int *)optval;
+	if (*multi_peer != 0 && *multi_peer != 1) {
+		return -EINVAL;
+	}
+
+	if (context->type != SOCK_DGRAM) {
+		return -EINVAL;
+	}
+
+	/* The sessions are set up differently in this mode. */
+	if (context->is_initialized) {
+		return -EISCONN;
+	}
+
+	context->options.multi_peer = *multi_peer;
+
+	return 0;
+#else
+	return -ENOPROTOOPT;
+#endif
+}
+
+static int tls_opt_dtls_multi_peer_get(struct tls_context *context,
+				       void *optval, socklen_t *optlen)
+{
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	*(int *)optval = context->options.multi_peer;
+
+	return 0;
+#else
+	return -ENOPROTOOPT;
+#endif
+}
+
 static int protocol_check(int family, int type, int *proto)
 {
 	if (family != AF_INET && family != AF_INET6) {
@@ -1332,6 +2464,12 @@ int ztls_close_ctx(struct tls_context *ctx)
 	/* Try to send close notification. */
 	ctx->flags = 0;
 
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+	if (dtls_is_multi_peer(ctx)) {
+		dtls_multi_peer_release(ctx);
+	}
+#endif
+
 	(void)mbedtls_ssl_close_notify(&ctx->ssl);
 
 	err = tls_release(ctx);
@@ -1366,6 +2504,8 @@ int ztls_connect_ctx(struct tls_context *ctx, const struct sockaddr *addr,
 			goto error;
 		}
 
+		tls_session_restore(ctx, addr, addrlen);
+
 		/* Do not use any socket flags during the handshake. */
 		ctx->flags = 0;
 
@@ -1506,6 +2646,9 @@ static ssize_t sendto_dtls_client(struct tls_context *ctx, const void *buf,
 		if (ret < 0) {
 			goto error;
 		}
+
+		tls_session_restore(ctx, &ctx->dtls_peer_addr,
+				    ctx->dtls_peer_addrlen);
 	}
 
 	if (!is_handshake_complete(ctx)) {
@@ -1562,6 +2705,13 @@ ssize_t ztls_sendto_ctx(struct tls_context *ctx, const void *buf, size_t len,
 
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	/* DTLS */
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+	if (dtls_is_multi_peer(ctx)) {
+		return sendto_dtls_multi_peer(ctx, buf, len, dest_addr,
+					      addrlen);
+	}
+#endif
+
 	if (ctx->options.role == MBEDTLS_SSL_IS_SERVER) {
 		return sendto_dtls_server(ctx, buf, len, flags,
 					  dest_addr, addrlen);
@@ -1780,6 +2930,13 @@ ssize_t ztls_recvfrom_ctx(struct tls_context *ctx, void *buf, size_t max_len,
 
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	/* DTLS */
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+	if (dtls_is_multi_peer(ctx)) {
+		return recvfrom_dtls_multi_peer(ctx, buf, max_len, flags,
+						src_addr, addrlen);
+	}
+#endif
+
 	if (ctx->options.role == MBEDTLS_SSL_IS_SERVER) {
 		return recvfrom_dtls_server(ctx, buf, max_len, flags,
 					    src_addr, addrlen);
@@ -1795,6 +2952,12 @@ ssize_t ztls_recvfrom_ctx(struct tls_context *ctx, void *buf, size_t max_len,
 
 static int ztls_poll_prepare_pollin(struct tls_context *ctx)
 {
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+	if (dtls_is_multi_peer(ctx)) {
+		return dtls_multi_peer_pollin(ctx) ? -EALREADY : 0;
+	}
+#endif
+
 	/* If there already is mbedTLS data to read, there is no
 	 * need to set the k_poll_event object. Return EALREADY
 	 * so we won't block in the k_poll.
@@ -1841,6 +3004,21 @@ static int ztls_poll_update_pollin(int fd, struct tls_context *ctx,
 {
 	int ret;
 
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+	if (dtls_is_multi_peer(ctx)) {
+		if (dtls_multi_peer_pollin(ctx)) {
+			pfd->revents |= ZSOCK_POLLIN;
+			goto next;
+		}
+
+		if (pfd->revents & ZSOCK_POLLIN) {
+			goto again;
+		}
+
+		goto next;
+	}
+#endif
+
 	if (!ctx->is_listening) {
 		/* Already had TLS data to read on socket. */
 		if (mbedtls_ssl_get_bytes_avail(&ctx->ssl) > 0) {
@@ -2052,6 +3230,18 @@ int ztls_getsockopt_ctx(struct tls_context *ctx, int level, int optname,
 		err = tls_opt_ciphersuite_used_get(ctx, optval, optlen);
 		break;
 
+	case TLS_SESSION_CACHE:
+		err = tls_opt_session_cache_get(ctx, optval, optlen);
+		break;
+
+	case TLS_SESSION_CACHE_STATS:
+		err = tls_opt_session_cache_stats_get(ctx, optval, optlen);
+		break;
+
+	case TLS_DTLS_MULTI_PEER:
+		err = tls_opt_dtls_multi_peer_get(ctx, optval, optlen);
+		break;
+
 	case TLS_ALPN_LIST:
 		err = tls_opt_alpn_list_get(ctx, optval, optlen);
 		break;
@@ -2101,6 +3291,18 @@ int ztls_setsockopt_ctx(struct tls_context *ctx, int level, int optname,
 		err = tls_opt_dtls_role_set(ctx, optval, optlen);
 		break;
 
+	case TLS_SESSION_CACHE:
+		err = tls_opt_session_cache_set(ctx, optval, optlen);
+		break;
+
+	case TLS_SESSION_CACHE_PURGE:
+		err = tls_opt_session_cache_purge(ctx, optval, optlen);
+		break;
+
+	case TLS_DTLS_MULTI_PEER:
+		err = tls_opt_dtls_multi_peer_set(ctx, optval, optlen);
+		break;
+
 	case TLS_ALPN_LIST:
 		err = tls_opt_alpn_list_set(ctx, optval, optlen);
 		break;
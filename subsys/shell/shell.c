@@ -322,6 +322,18 @@ static void find_completion_candidates(const struct shell *shell,
 	*longest = 0U;
 	*cnt = 0;
 
+	if (cmd == NULL) {
+		/* Root candidates are contiguous in the sorted commands. */
+		*cnt = z_shell_root_cmd_prefix_find(incompl_cmd,
+						    incompl_cmd_len, first_idx);
+		for (idx = *first_idx; idx < *first_idx + *cnt; idx++) {
+			candidate = z_shell_cmd_get(NULL, idx, NULL);
+			*longest = Z_MAX(strlen(candidate->syntax), *longest);
+		}
+
+		return;
+	}
+
 	while ((candidate = z_shell_cmd_get(cmd, idx, &dloc)) != NULL) {
 		bool is_candidate;
 		is_candidate = is_completion_candidate(candidate->syntax,
@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <shell/shell_bin.h>
+#include <drivers/uart.h>
+#include <init.h>
+#include <logging/log.h>
+#include <logging/log_backend.h>
+#include <logging/log_backend_std.h>
+#include <logging/log_output.h>
+#include <sys/byteorder.h>
+#include <sys/crc.h>
+
+LOG_MODULE_REGISTER(shell_bin);
+
+/* Return of rx_byte(). */
+enum rx_status {
+	RX_PENDING,
+	RX_FRAME,
+};
+
+SHELL_BIN_DEFINE(shell_transport_bin, CONFIG_SHELL_BIN_RX_RING_BUFFER_SIZE);
+SHELL_DEFINE(shell_bin, "", &shell_transport_bin, 1, 0, SHELL_FLAG_OLF_CRLF);
+
+/* Frames of command output and of logs must not interleave. They are sent
+ * by the shell thread and by the log thread. Sending a frame takes long,
+ * so other threads and interrupts keep running meanwhile.
+ */
+static K_MUTEX_DEFINE(tx_lock);
+
+static void frame_send(const struct device *dev, uint8_t type, uint16_t seq,
+		       const uint8_t *data, size_t len)
+{
+	struct shell_bin_hdr hdr = {
+		.sync = SHELL_BIN_SYNC,
+		.type = type,
+		.seq = sys_cpu_to_le16(seq),
+		.len = sys_cpu_to_le16(len),
+	};
+	const uint8_t *hdr8 = (const uint8_t *)&hdr;
+	uint8_t crc[sizeof(uint16_t)];
+	/* In panic mode, logs are flushed from the fault handler. */
+	bool lock = !k_is_in_isr();
+
+	sys_put_le16(crc16_itu_t(crc16_itu_t(0, &hdr.type, sizeof(hdr) - 1),
+				 data, len), crc);
+
+	if (lock) {
+		(void)k_mutex_lock(&tx_lock, K_FOREVER);
+	}
+
+	for (size_t i = 0; i < sizeof(hdr); i++) {
+		uart_poll_out(dev, hdr8[i]);
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		uart_poll_out(dev, data[i]);
+	}
+
+	uart_poll_out(dev, crc[0]);
+	uart_poll_out(dev, crc[1]);
+
+	if (lock) {
+		(void)k_mutex_unlock(&tx_lock);
+	}
+}
+
+/* Accumulate a received byte in the frame. Bytes are skipped until the sync
+ * byte, and the frame is dropped if its CRC is wrong. A frame too long for
+ * the buffer is dropped as soon as its header is received, without any
+ * result since its sequence number cannot be checked.
+ */
+static enum rx_status rx_byte(struct shell_bin_rx *rx, uint8_t byte)
+{
+	const struct shell_bin_hdr *hdr = (const struct shell_bin_hdr *)rx->buf;
+	size_t len;
+	uint16_t crc;
+
+	if ((rx->len == 0) && (byte != SHELL_BIN_SYNC)) {
+		return RX_PENDING;
+	}
+
+	rx->buf[rx->len++] = byte;
+	if (rx->len < sizeof(*hdr)) {
+		return RX_PENDING;
+	}
+
+	len = sys_le16_to_cpu(hdr->len);
+	if (len >= CONFIG_SHELL_CMD_BUFF_SIZE) {
+		LOG_WRN("Frame dropped, too long.");
+		rx->len = 0;
+		return RX_PENDING;
+	}
+
+	if (rx->len < sizeof(*hdr) + len + sizeof(crc)) {
+		return RX_PENDING;
+	}
+
+	rx->len = 0;
+	crc = crc16_itu_t(0, &hdr->type, sizeof(*hdr) - 1 + len);
+	if (crc != sys_get_le16(&rx->buf[sizeof(*hdr) + len])) {
+		LOG_WRN("Frame dropped, wrong CRC.");
+		return RX_PENDING;
+	}
+
+	return RX_FRAME;
+}
+
+static void output_flush(struct shell_bin_ctrl_blk *ctrl_blk)
+{
+	if (ctrl_blk->tx_len > 0) {
+		frame_send(ctrl_blk->dev, SHELL_BIN_FRAME_OUTPUT, ctrl_blk->seq,
+			   ctrl_blk->tx_buf, ctrl_blk->tx_len);
+		ctrl_blk->tx_len = 0;
+	}
+}
+
+static void result_send(struct shell_bin_ctrl_blk *ctrl_blk, uint16_t seq,
+			int ret)
+{
+	uint8_t data[sizeof(int32_t)];
+
+	sys_put_le32((uint32_t)ret, data);
+	frame_send(ctrl_blk->dev, SHELL_BIN_FRAME_RESULT, seq, data,
+		   sizeof(data));
+}
+
+static void frame_handle(struct shell_bin_ctrl_blk *ctrl_blk)
+{
+	struct shell_bin_hdr *hdr = (struct shell_bin_hdr *)ctrl_blk->rx.buf;
+	char *cmd = (char *)&ctrl_blk->rx.buf[sizeof(*hdr)];
+	int ret;
+
+	if (hdr->type != SHELL_BIN_FRAME_CMD) {
+		return;
+	}
+
+	/* Overwrites the CRC, already checked. */
+	cmd[sys_le16_to_cpu(hdr->len)] = '\0';
+
+	ctrl_blk->seq = sys_le16_to_cpu(hdr->seq);
+	ctrl_blk->exec = true;
+	ret = shell_execute_cmd((const struct shell *)ctrl_blk->context, cmd);
+	output_flush(ctrl_blk);
+	ctrl_blk->exec = false;
+
+	result_send(ctrl_blk, ctrl_blk->seq, ret);
+}
+
+static void uart_rx_handle(const struct device *dev,
+			   const struct shell_bin *sh_bin)
+{
+	uint8_t *data;
+	uint32_t len;
+	uint32_t rd_len;
+	bool new_data = false;
+
+	do {
+		len = ring_buf_put_claim(sh_bin->rx_ringbuf, &data,
+					 sh_bin->rx_ringbuf->size);
+
+		if (len > 0) {
+			rd_len = uart_fifo_read(dev, data, len);
+			if (rd_len > 0) {
+				new_data = true;
+			}
+
+			int err = ring_buf_put_finish(sh_bin->rx_ringbuf,
+						      rd_len);
+			(void)err;
+			__ASSERT_NO_MSG(err == 0);
+		} else {
+			uint8_t dummy;
+
+			/* No space in the ring buffer - consume byte, the
+			 * frame is dropped by its CRC.
+			 */
+			rd_len = uart_fifo_read(dev, &dummy, 1);
+		}
+	} while (rd_len && (rd_len == len));
+
+	if (new_data) {
+		sh_bin->ctrl_blk->handler(SHELL_TRANSPORT_EVT_RX_RDY,
+					  sh_bin->ctrl_blk->context);
+	}
+}
+
+static void uart_callback(const struct device *dev, void *user_data)
+{
+	const struct shell_bin *sh_bin = (struct shell_bin *)user_data;
+
+	uart_irq_update(dev);
+
+	if (uart_irq_rx_ready(dev)) {
+		uart_rx_handle(dev, sh_bin);
+	}
+}
+
+static int init(const struct shell_transport *transport,
+		const void *config,
+		shell_transport_handler_t evt_handler,
+		void *context)
+{
+	const struct shell_bin *sh_bin = (struct shell_bin *)transport->ctx;
+	const struct device *dev = (const struct device *)config;
+
+	memset(sh_bin->ctrl_blk, 0, sizeof(*sh_bin->ctrl_blk));
+	sh_bin->ctrl_blk->dev = dev;
+	sh_bin->ctrl_blk->handler = evt_handler;
+	sh_bin->ctrl_blk->context = context;
+
+	ring_buf_reset(sh_bin->rx_ringbuf);
+	uart_irq_callback_user_data_set(dev, uart_callback, (void *)sh_bin);
+	uart_irq_rx_enable(dev);
+
+	return 0;
+}
+
+static int uninit(const struct shell_transport *transport)
+{
+	const struct shell_bin *sh_bin = (struct shell_bin *)transport->ctx;
+
+	uart_irq_rx_disable(sh_bin->ctrl_blk->dev);
+
+	return 0;
+}
+
+static int enable(const struct shell_transport *transport, bool blocking_tx)
+{
+	ARG_UNUSED(transport);
+	ARG_UNUSED(blocking_tx);
+
+	return 0;
+}
+
+static int write(const struct shell_transport *transport,
+		 const void *data, size_t length, size_t *cnt)
+{
+	const struct shell_bin *sh_bin = (struct shell_bin *)transport->ctx;
+	struct shell_bin_ctrl_blk *ctrl_blk = sh_bin->ctrl_blk;
+	const uint8_t *data8 = (const uint8_t *)data;
+	size_t len;
+
+	*cnt = length;
+
+	/* Only command output is sent, the prompt is not. */
+	if (!ctrl_blk->exec) {
+		return 0;
+	}
+
+	while (length > 0) {
+		len = MIN(length, sizeof(ctrl_blk->tx_buf) - ctrl_blk->tx_len);
+		memcpy(&ctrl_blk->tx_buf[ctrl_blk->tx_len], data8, len);
+		ctrl_blk->tx_len += len;
+		data8 += len;
+		length -= len;
+
+		if (ctrl_blk->tx_len == sizeof(ctrl_blk->tx_buf)) {
+			output_flush(ctrl_blk);
+		}
+	}
+
+	return 0;
+}
+
+static int read(const struct shell_transport *transport,
+		void *data, size_t length, size_t *cnt)
+{
+	ARG_UNUSED(transport);
+	ARG_UNUSED(data);
+	ARG_UNUSED(length);
+
+	/* Frames are consumed by update(), nothing reaches the VT100 input. */
+	*cnt = 0;
+
+	return 0;
+}
+
+/* Called from the shell thread, which commands are executed in. */
+static void update(const struct shell_transport *transport)
+{
+	const struct shell_bin *sh_bin = (struct shell_bin *)transport->ctx;
+	struct shell_bin_ctrl_blk *ctrl_blk = sh_bin->ctrl_blk;
+	uint8_t byte;
+
+	while (ring_buf_get(sh_bin->rx_ringbuf, &byte, 1) == 1) {
+		if (rx_byte(&ctrl_blk->rx, byte) == RX_FRAME) {
+			frame_handle(ctrl_blk);
+		}
+	}
+}
+
+const struct shell_transport_api shell_bin_transport_api = {
+	.init = init,
+	.uninit = uninit,
+	.enable = enable,
+	.write = write,
+	.read = read,
+	.update = update,
+};
+
+static int enable_shell_bin(const struct device *arg)
+{
+	ARG_UNUSED(arg);
+	const struct device *dev =
+			device_get_binding(CONFIG_UART_SHELL_BIN_ON_DEV_NAME);
+
+	if (dev == NULL) {
+		return -ENODEV;
+	}
+
+	return shell_init(&shell_bin, dev, false, false, LOG_LEVEL_NONE);
+}
+SYS_INIT(enable_shell_bin, POST_KERNEL, CONFIG_SHELL_BIN_INIT_PRIORITY);
+
+const struct shell *shell_backend_bin_get_ptr(void)
+{
+	return &shell_bin;
+}
+
+#ifdef CONFIG_SHELL_BIN_LOG_BACKEND
+static int log_out(uint8_t *data, size_t length, void *ctx)
+{
+	const struct device *dev = shell_transport_bin_ctrl_blk.dev;
+
+	ARG_UNUSED(ctx);
+
+	if (dev != NULL) {
+		frame_send(dev, SHELL_BIN_FRAME_LOG, 0, data, length);
+	}
+
+	return length;
+}
+
+static uint8_t log_output_buf[CONFIG_SHELL_BIN_TX_BUFFER_SIZE];
+
+LOG_OUTPUT_DEFINE(log_output_shell_bin, log_out, log_output_buf,
+		  sizeof(log_output_buf));
+
+static void put(const struct log_backend *const backend, struct log_msg *msg)
+{
+	log_backend_std_put(&log_output_shell_bin, 0, msg);
+}
+
+static void process(const struct log_backend *const backend,
+		    const struct log_msg2 *msg)
+{
+	log_backend_std_msg2_process(&log_output_shell_bin, 0, msg);
+}
+
+static void panic(struct log_backend const *const backend)
+{
+	log_backend_std_panic(&log_output_shell_bin);
+}
+
+static void dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	log_backend_std_dropped(&log_output_shell_bin, cnt);
+}
+
+static const struct log_backend_api log_backend_shell_bin_api = {
+	.put = IS_ENABLED(CONFIG_LOG2) ? NULL : put,
+	.process = IS_ENABLED(CONFIG_LOG2) ? process : NULL,
+	.panic = panic,
+	.dropped = dropped,
+};
+
+LOG_BACKEND_DEFINE(log_backend_shell_bin, log_backend_shell_bin_api, true);
+#endif /* CONFIG_SHELL_BIN_LOG_BACKEND */
@@ -228,20 +228,60 @@ static inline uint32_t shell_root_cmd_count(void)
 				sizeof(struct shell_cmd_entry);
 }
 
+/* Root commands are placed in sections named after their syntax, which the
+ * linker sorts by name. Returns the index of the first root command whose
+ * syntax, limited to len characters, is not below str.
+ */
+static size_t root_cmd_lower_bound(const char *str, size_t len)
+{
+	size_t lo = 0;
+	size_t hi = shell_root_cmd_count();
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+
+		if (strncmp(shell_root_cmd_get(mid)->u.entry->syntax,
+			    str, len) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
 /* Function returning pointer to parent command matching requested syntax. */
 static const struct shell_static_entry *root_cmd_find(const char *syntax)
+{
+	/* Comparing the terminating character too gives an exact match. */
+	size_t idx = root_cmd_lower_bound(syntax, strlen(syntax) + 1);
+	const struct shell_static_entry *entry;
+
+	if (idx == shell_root_cmd_count()) {
+		return NULL;
+	}
+
+	entry = shell_root_cmd_get(idx)->u.entry;
+
+	return (strcmp(syntax, entry->syntax) == 0) ? entry : NULL;
+}
+
+size_t z_shell_root_cmd_prefix_find(const char *prefix, size_t len,
+				    size_t *first)
 {
 	const size_t cmd_count = shell_root_cmd_count();
-	const struct shell_cmd_entry *cmd;
+	size_t idx = root_cmd_lower_bound(prefix, len);
 
-	for (size_t cmd_idx = 0; cmd_idx < cmd_count; ++cmd_idx) {
-		cmd = shell_root_cmd_get(cmd_idx);
-		if (strcmp(syntax, cmd->u.entry->syntax) == 0) {
-			return cmd->u.entry;
-		}
+	*first = idx;
+
+	while ((idx < cmd_count) &&
+	       (strncmp(shell_root_cmd_get(idx)->u.entry->syntax,
+			prefix, len) == 0)) {
+		idx++;
 	}
 
-	return NULL;
+	return idx - *first;
 }
 
 const struct shell_static_entry *z_shell_cmd_get(
@@ -292,6 +332,10 @@ const struct shell_static_entry *z_shell_find_cmd(
 	const struct shell_static_entry *entry;
 	size_t idx = 0;
 
+	if (parent == NULL) {
+		return root_cmd_find(cmd_str);
+	}
+
 	while ((entry = z_shell_cmd_get(parent, idx++, dloc)) != NULL) {
 		if (strcmp(cmd_str, entry->syntax) == 0) {
 			return entry;
@@ -53,6 +53,20 @@ const struct shell_static_entry *z_shell_cmd_get(
 					size_t idx,
 					struct shell_static_entry *dloc);
 
+/** @brief Find the root commands starting with a prefix.
+ *
+ * Root commands are sorted by syntax at link time, so the matching commands
+ * are contiguous and found by binary search.
+ *
+ * @param prefix	Prefix, not necessarily NUL terminated.
+ * @param len		Length of the prefix.
+ * @param first		Set to the index of the first matching command.
+ *
+ * @return Number of matching commands.
+ */
+size_t z_shell_root_cmd_prefix_find(const char *prefix, size_t len,
+				    size_t *first);
+
 const struct shell_static_entry *z_shell_find_cmd(
 					const struct shell_static_entry *parent,
 					const char *cmd_str,
@@ -113,6 +113,45 @@ uint32_t tracing_buffer_get(uint8_t *data, uint32_t size);
  */
 uint32_t tracing_cmd_buffer_alloc(uint8_t **data);
 
+/**
+ * @brief Allocate an event in the buffer of the current CPU.
+ *
+ * Any context can allocate an event, only the interrupts of the local
+ * CPU are masked while its space is reserved. The event is timestamped
+ * once reserved, the timestamps of a CPU buffer are in order.
+ *
+ * @param size Event size (in bytes).
+ *
+ * @return Address of the event data, or NULL if the buffer is full.
+ */
+uint8_t *tracing_buffer_event_alloc(uint32_t size);
+
+/**
+ * @brief Commit an event filled after tracing_buffer_event_alloc().
+ *
+ * @param data Address of the event data.
+ */
+void tracing_buffer_event_commit(uint8_t *data);
+
+/**
+ * @brief Claim the oldest committed event of all CPUs.
+ *
+ * Events of the CPUs are merged by timestamp. Nothing is claimed while
+ * the oldest event of a CPU is allocated but not committed yet, or if the
+ * oldest event is not older than the call. The claimed event must be
+ * freed with tracing_buffer_event_free() before the next claim.
+ *
+ * @param data Pointer to the address. It's set to the event data.
+ *
+ * @return Event size (in bytes), or 0 if no event can be claimed.
+ */
+uint32_t tracing_buffer_event_claim(uint8_t **data);
+
+/**
+ * @brief Free the event claimed with tracing_buffer_event_claim().
+ */
+void tracing_buffer_event_free(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _TRACE_PROFILER_H
+#define _TRACE_PROFILER_H
+
+#include <kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** First byte of each frame, to find frames again after lost bytes. */
+#define PROFILER_FRAME_SYNC	0xa5
+
+/** Type of a sample frame in the tracing stream. */
+#define PROFILER_FRAME_SAMPLE	'S'
+
+/** Maximum number of program counters of a sample. */
+#define PROFILER_MAX_DEPTH	2
+
+/**
+ * @brief Sample frame, in the byte order of the target.
+ *
+ * The frame is followed by @a depth program counters: the interrupted one,
+ * then its caller if recorded. A program counter of 0 is a sample taken
+ * while an interrupt was being handled.
+ */
+struct profiler_sample_frame {
+	uint8_t sync;
+	uint8_t type;
+	uint8_t cpu;
+	uint8_t depth;
+	uint32_t thread;
+} __packed;
+
+/**
+ * @brief Start sampling.
+ *
+ * @param frequency Sampling frequency in Hz, rounded to system ticks.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if the frequency is 0.
+ */
+int profiler_start(uint32_t frequency);
+
+/**
+ * @brief Stop sampling.
+ */
+void profiler_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
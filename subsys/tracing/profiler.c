@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <init.h>
+#include <errno.h>
+#include <arch/arm/aarch32/cortex_m/cmsis.h>
+#include <tracing/tracing_format.h>
+#include <tracing_profiler.h>
+
+static struct k_timer sample_timer;
+
+/* Basic stack frame pushed on exception entry. */
+enum exc_frame {
+	EXC_FRAME_R0,
+	EXC_FRAME_R1,
+	EXC_FRAME_R2,
+	EXC_FRAME_R3,
+	EXC_FRAME_R12,
+	EXC_FRAME_LR,
+	EXC_FRAME_PC,
+	EXC_FRAME_XPSR,
+};
+
+static uint8_t sample_pcs(uint32_t *pcs)
+{
+	const uint32_t *frame;
+
+	/* Without any other active exception the timer interrupted a thread,
+	 * whose frame is on the process stack. Otherwise the frame of the
+	 * interrupted handler cannot be found and the sample is attributed
+	 * to interrupts.
+	 */
+	if ((SCB->ICSR & SCB_ICSR_RETTOBASE_Msk) == 0U) {
+		pcs[0] = 0U;
+		return 1U;
+	}
+
+	frame = (const uint32_t *)__get_PSP();
+	pcs[0] = frame[EXC_FRAME_PC];
+
+	if (!IS_ENABLED(CONFIG_TRACING_PROFILER_CALLER)) {
+		return 1U;
+	}
+
+	/* The link register holds the caller of a leaf function, it is only
+	 * an approximation of the caller of other functions.
+	 */
+	pcs[1] = frame[EXC_FRAME_LR] & ~1U;
+
+	return 2U;
+}
+
+static void sample_timer_expiry(struct k_timer *timer)
+{
+	struct {
+		struct profiler_sample_frame hdr;
+		uint32_t pcs[PROFILER_MAX_DEPTH];
+	} __packed sample;
+
+	ARG_UNUSED(timer);
+
+	sample.hdr.sync = PROFILER_FRAME_SYNC;
+	sample.hdr.type = PROFILER_FRAME_SAMPLE;
+	/* ARMv7-M and ARMv8-M Mainline cores are never SMP. */
+	sample.hdr.cpu = 0U;
+	sample.hdr.thread = (uint32_t)k_current_get();
+	sample.hdr.depth = sample_pcs(sample.pcs);
+
+	tracing_format_raw_data((uint8_t *)&sample,
+				sizeof(sample.hdr) +
+				sample.hdr.depth * sizeof(sample.pcs[0]));
+}
+
+int profiler_start(uint32_t frequency)
+{
+	k_timeout_t period;
+
+	if (frequency == 0U) {
+		return -EINVAL;
+	}
+
+	period = K_TICKS(MAX(1, CONFIG_SYS_CLOCK_TICKS_PER_SEC / frequency));
+	k_timer_start(&sample_timer, period, period);
+
+	return 0;
+}
+
+void profiler_stop(void)
+{
+	k_timer_stop(&sample_timer);
+}
+
+static int profiler_init(const struct device *arg)
+{
+	ARG_UNUSED(arg);
+
+	k_timer_init(&sample_timer, sample_timer_expiry, NULL);
+
+	if (IS_ENABLED(CONFIG_TRACING_PROFILER_AUTOSTART)) {
+		return profiler_start(CONFIG_TRACING_PROFILER_FREQUENCY);
+	}
+
+	return 0;
+}
+
+/* After tracing_init() */
+SYS_INIT(profiler_init, APPLICATION, 1);
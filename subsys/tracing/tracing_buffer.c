@@ -4,10 +4,36 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <kernel.h>
 #include <sys/ring_buffer.h>
+#include <sys/mpsc_pbuf.h>
+#include <tracing_buffer.h>
+
+#ifdef CONFIG_TRACING_BUFFER_PER_CPU
+/* Events go to the per-CPU buffers, the ring buffer is not used. */
+#define TRACING_RING_BUF_SIZE 1
+
+/* Header of an event in a per-CPU buffer. */
+struct tracing_event {
+	uint32_t timestamp;
+	uint16_t length;
+	uint16_t cpu;
+	uint8_t data[];
+};
+
+static struct mpsc_pbuf_buffer cpu_buffers[CONFIG_MP_NUM_CPUS];
+static uint32_t cpu_buffer_mem[CONFIG_MP_NUM_CPUS]
+			      [CONFIG_TRACING_BUFFER_SIZE / sizeof(uint32_t)];
+
+/* Oldest claimed event of each CPU, not output yet. */
+static const struct tracing_event *cpu_heads[CONFIG_MP_NUM_CPUS];
+static int claimed_cpu = -1;
+#else
+#define TRACING_RING_BUF_SIZE (CONFIG_TRACING_BUFFER_SIZE + 1)
+#endif
 
 static struct ring_buf tracing_ring_buf;
-static uint8_t tracing_buffer[CONFIG_TRACING_BUFFER_SIZE + 1];
+static uint8_t tracing_buffer[TRACING_RING_BUF_SIZE];
 static uint8_t tracing_cmd_buffer[CONFIG_TRACING_CMD_BUFFER_SIZE];
 
 uint32_t tracing_cmd_buffer_alloc(uint8_t **data)
@@ -51,11 +77,29 @@ void tracing_buffer_init(void)
 {
 	ring_buf_init(&tracing_ring_buf,
 		      sizeof(tracing_buffer), tracing_buffer);
+
+#ifdef CONFIG_TRACING_BUFFER_PER_CPU
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		mpsc_pbuf_init(&cpu_buffers[i], cpu_buffer_mem[i],
+			       ARRAY_SIZE(cpu_buffer_mem[i]));
+	}
+#endif
 }
 
 bool tracing_buffer_is_empty(void)
 {
+#ifdef CONFIG_TRACING_BUFFER_PER_CPU
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (cpu_heads[i] != NULL ||
+		    mpsc_pbuf_is_pending(&cpu_buffers[i])) {
+			return false;
+		}
+	}
+
+	return true;
+#else
 	return ring_buf_is_empty(&tracing_ring_buf);
+#endif
 }
 
 uint32_t tracing_buffer_capacity_get(void)
@@ -67,3 +111,111 @@ uint32_t tracing_buffer_space_get(void)
 {
 	return ring_buf_space_get(&tracing_ring_buf);
 }
+
+#ifdef CONFIG_TRACING_BUFFER_PER_CPU
+static inline uint16_t tracing_cpu_id(void)
+{
+#ifdef CONFIG_SMP
+	return arch_curr_cpu()->id;
+#else
+	return 0;
+#endif
+}
+
+uint8_t *tracing_buffer_event_alloc(uint32_t size)
+{
+	struct tracing_event *event;
+	uint32_t timestamp;
+	unsigned int key;
+	uint16_t cpu;
+
+	/* Only the local interrupts are masked: the thread cannot migrate
+	 * and nothing else reserves space in this buffer between the
+	 * reservation and the timestamp, so the timestamps of a buffer are
+	 * in order. Other CPUs are not held up.
+	 *
+	 * The event is timestamped once reserved: an event not reserved yet
+	 * when the merge starts is timestamped after it.
+	 */
+	key = arch_irq_lock();
+	cpu = tracing_cpu_id();
+	event = mpsc_pbuf_alloc(&cpu_buffers[cpu], sizeof(*event) + size);
+	timestamp = k_cycle_get_32();
+	arch_irq_unlock(key);
+
+	if (event == NULL) {
+		return NULL;
+	}
+
+	event->timestamp = timestamp;
+	event->length = size;
+	event->cpu = cpu;
+
+	return event->data;
+}
+
+void tracing_buffer_event_commit(uint8_t *data)
+{
+	struct tracing_event *event =
+		CONTAINER_OF(data, struct tracing_event, data);
+
+	mpsc_pbuf_commit(&cpu_buffers[event->cpu], event);
+}
+
+uint32_t tracing_buffer_event_claim(uint8_t **data)
+{
+	const struct tracing_event *oldest = NULL;
+	uint32_t start = k_cycle_get_32();
+	int oldest_cpu = -1;
+	size_t len;
+
+	__ASSERT_NO_MSG(claimed_cpu < 0);
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (cpu_heads[i] == NULL) {
+			cpu_heads[i] = mpsc_pbuf_claim(&cpu_buffers[i], &len);
+		}
+
+		/* An event allocated but not committed yet may be older
+		 * than all the others, wait for it.
+		 */
+		if (cpu_heads[i] == NULL) {
+			if (mpsc_pbuf_is_pending(&cpu_buffers[i])) {
+				return 0;
+			}
+
+			continue;
+		}
+
+		/* Timestamps wrap, compare their difference. */
+		if (oldest == NULL ||
+		    (int32_t)(cpu_heads[i]->timestamp -
+			      oldest->timestamp) < 0) {
+			oldest = cpu_heads[i];
+			oldest_cpu = i;
+		}
+	}
+
+	/* A CPU found empty may have reserved an event since, timestamped
+	 * after the start of the merge. Only older events are certainly
+	 * before it.
+	 */
+	if (oldest == NULL || (int32_t)(oldest->timestamp - start) >= 0) {
+		return 0;
+	}
+
+	claimed_cpu = oldest_cpu;
+	*data = (uint8_t *)oldest->data;
+
+	return oldest->length;
+}
+
+void tracing_buffer_event_free(void)
+{
+	__ASSERT_NO_MSG(claimed_cpu >= 0);
+
+	mpsc_pbuf_free(&cpu_buffers[claimed_cpu], cpu_heads[claimed_cpu]);
+	cpu_heads[claimed_cpu] = NULL;
+	claimed_cpu = -1;
+}
+#endif /* CONFIG_TRACING_BUFFER_PER_CPU */
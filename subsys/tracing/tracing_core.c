@@ -37,6 +37,7 @@ static struct tracing_backend *working_backend;
 
 #ifdef CONFIG_TRACING_ASYNC
 #define TRACING_THREAD_NAME "tracing_thread"
+#define WAIT_UNCOMMITTED CONFIG_TRACING_THREAD_WAIT_THRESHOLD
 
 static k_tid_t tracing_thread_tid;
 static struct k_thread tracing_thread;
@@ -55,7 +56,23 @@ static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
 	tracing_buffer_max_length = tracing_buffer_capacity_get();
 
 	while (true) {
-		if (tracing_buffer_is_empty()) {
+		if (IS_ENABLED(CONFIG_TRACING_BUFFER_PER_CPU)) {
+			transferring_length =
+				tracing_buffer_event_claim(&transferring_buf);
+			if (transferring_length == 0) {
+				/* Poll while events are allocated but not
+				 * committed yet, no output is triggered for
+				 * them.
+				 */
+				k_sem_take(&tracing_thread_sem,
+					   tracing_buffer_is_empty() ?
+					   K_FOREVER : K_MSEC(WAIT_UNCOMMITTED));
+			} else {
+				tracing_buffer_handle(transferring_buf,
+						      transferring_length);
+				tracing_buffer_event_free();
+			}
+		} else if (tracing_buffer_is_empty()) {
 			k_sem_take(&tracing_thread_sem, K_FOREVER);
 		} else {
 			transferring_length =
@@ -8,10 +8,28 @@
 #include <tracing_buffer.h>
 #include <tracing_format_common.h>
 
+/* The per-CPU buffers lock the local interrupts on their own. */
+static inline unsigned int tracing_put_lock(void)
+{
+	if (IS_ENABLED(CONFIG_TRACING_BUFFER_PER_CPU)) {
+		return 0;
+	}
+
+	return irq_lock();
+}
+
+static inline void tracing_put_unlock(unsigned int key)
+{
+	if (!IS_ENABLED(CONFIG_TRACING_BUFFER_PER_CPU)) {
+		irq_unlock(key);
+	}
+}
+
 void tracing_format_string(const char *str, ...)
 {
 	va_list args;
 	bool put_success, before_put_is_empty;
+	unsigned int key;
 
 	if (!is_tracing_enabled() || is_tracing_thread()) {
 		return;
@@ -19,10 +37,10 @@ void tracing_format_string(const char *str, ...)
 
 	va_start(args, str);
 
-	TRACING_LOCK();
+	key = tracing_put_lock();
 	before_put_is_empty = tracing_buffer_is_empty();
 	put_success = tracing_format_string_put(str, args);
-	TRACING_UNLOCK();
+	tracing_put_unlock(key);
 
 	va_end(args);
 
@@ -36,15 +54,16 @@ void tracing_format_string(const char *str, ...)
 void tracing_format_raw_data(uint8_t *data, uint32_t length)
 {
 	bool put_success, before_put_is_empty;
+	unsigned int key;
 
 	if (!is_tracing_enabled() || is_tracing_thread()) {
 		return;
 	}
 
-	TRACING_LOCK();
+	key = tracing_put_lock();
 	before_put_is_empty = tracing_buffer_is_empty();
 	put_success = tracing_format_raw_data_put(data, length);
-	TRACING_UNLOCK();
+	tracing_put_unlock(key);
 
 	if (put_success) {
 		tracing_trigger_output(before_put_is_empty);
@@ -56,15 +75,16 @@ void tracing_format_raw_data(uint8_t *data, uint32_t length)
 void tracing_format_data(tracing_data_t *tracing_data_array, uint32_t count)
 {
 	bool put_success, before_put_is_empty;
+	unsigned int key;
 
 	if (!is_tracing_enabled() || is_tracing_thread()) {
 		return;
 	}
 
-	TRACING_LOCK();
+	key = tracing_put_lock();
 	before_put_is_empty = tracing_buffer_is_empty();
 	put_success = tracing_format_data_put(tracing_data_array, count);
-	TRACING_UNLOCK();
+	tracing_put_unlock(key);
 
 	if (put_success) {
 		tracing_trigger_output(before_put_is_empty);
@@ -5,6 +5,7 @@
  */
 
 #include <string.h>
+#include <sys/util.h>
 #include <sys/cbprintf.h>
 #include <tracing_buffer.h>
 #include <tracing_format_common.h>
@@ -29,10 +30,80 @@ static int str_put(int c, void *ctx)
 	return 0;
 }
 
+static int str_count(int c, void *ctx)
+{
+	ARG_UNUSED(c);
+
+	((tracing_ctx_t *)ctx)->length++;
+
+	return 0;
+}
+
+static int str_copy(int c, void *ctx)
+{
+	uint8_t **buf = ctx;
+
+	*(*buf)++ = (uint8_t)c;
+
+	return 0;
+}
+
+static bool event_string_put(const char *str, va_list args)
+{
+	tracing_ctx_t str_ctx = {0};
+	uint8_t *event, *buf;
+	va_list args2;
+
+	va_copy(args2, args);
+	(void)cbvprintf(str_count, (void *)&str_ctx, str, args2);
+	va_end(args2);
+
+	event = tracing_buffer_event_alloc(str_ctx.length);
+	if (event == NULL) {
+		return false;
+	}
+
+	buf = event;
+	(void)cbvprintf(str_copy, (void *)&buf, str, args);
+	tracing_buffer_event_commit(event);
+
+	return true;
+}
+
+static bool event_data_put(tracing_data_t *tracing_data_array, uint32_t count)
+{
+	uint32_t total_size = 0U;
+	uint8_t *event, *buf;
+
+	for (uint32_t i = 0; i < count; i++) {
+		total_size += tracing_data_array[i].length;
+	}
+
+	event = tracing_buffer_event_alloc(total_size);
+	if (event == NULL) {
+		return false;
+	}
+
+	buf = event;
+	for (uint32_t i = 0; i < count; i++) {
+		memcpy(buf, tracing_data_array[i].data,
+		       tracing_data_array[i].length);
+		buf += tracing_data_array[i].length;
+	}
+
+	tracing_buffer_event_commit(event);
+
+	return true;
+}
+
 bool tracing_format_string_put(const char *str, va_list args)
 {
 	tracing_ctx_t str_ctx = {0};
 
+	if (IS_ENABLED(CONFIG_TRACING_BUFFER_PER_CPU)) {
+		return event_string_put(str, args);
+	}
+
 	(void)cbvprintf(str_put, (void *)&str_ctx, str, args);
 
 	if (str_ctx.status == 0) {
@@ -46,7 +117,18 @@ bool tracing_format_string_put(const char *str, va_list args)
 
 bool tracing_format_raw_data_put(uint8_t *data, uint32_t size)
 {
-	uint32_t space = tracing_buffer_space_get();
+	uint32_t space;
+
+	if (IS_ENABLED(CONFIG_TRACING_BUFFER_PER_CPU)) {
+		tracing_data_t tracing_data = {
+			.data = data,
+			.length = size,
+		};
+
+		return event_data_put(&tracing_data, 1);
+	}
+
+	space = tracing_buffer_space_get();
 
 	if (space >= size) {
 		tracing_buffer_put(data, size);
@@ -60,6 +142,10 @@ bool tracing_format_data_put(tracing_data_t *tracing_data_array, uint32_t count)
 {
 	uint32_t total_size = 0U;
 
+	if (IS_ENABLED(CONFIG_TRACING_BUFFER_PER_CPU)) {
+		return event_data_put(tracing_data_array, count);
+	}
+
 	for (uint32_t i = 0; i < count; i++) {
 		tracing_data_t *tracing_data =
 				tracing_data_array + i;
@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+#include <net/http_server.h>
+
+/*
+ * Measures the HTTP server throughput over the loopback interface, with
+ * the server in its own thread:
+ * - get: pipelined GET requests on one persistent connection,
+ * - upload: a chunked POST request body, consumed as it is received,
+ * - download: a chunked response body, sent as it is produced.
+ */
+
+#define SERVER_PORT 8080
+#define STACK_SIZE 2048
+#define PRIORITY 5
+
+#define N_REQUESTS 200
+#define N_PIPELINED 8
+#define BODY_SIZE 256
+#define STREAM_SIZE (64 * 1024)
+#define BLOCK_SIZE 512
+
+#define GET_REQUEST "GET /data HTTP/1.1\r\nHost: bench\r\n\r\n"
+#define LAST_CHUNK "0\r\n\r\n"
+
+static struct http_server_ctx server;
+static K_SEM_DEFINE(server_ready, 0, 1);
+static uint8_t block[BLOCK_SIZE];
+static size_t uploaded;
+
+static int data_cb(struct http_server_conn *conn, enum http_server_event evt,
+		   const uint8_t *data, size_t len, void *user_data)
+{
+	if (evt == HTTP_SERVER_REQ_END) {
+		return http_server_response(conn, 200, "text/plain", block,
+					    BODY_SIZE);
+	}
+
+	return 0;
+}
+
+static int upload_cb(struct http_server_conn *conn, enum http_server_event evt,
+		     const uint8_t *data, size_t len, void *user_data)
+{
+	switch (evt) {
+	case HTTP_SERVER_REQ_HEADERS:
+		uploaded = 0;
+		return 0;
+	case HTTP_SERVER_REQ_BODY:
+		uploaded += len;
+		return 0;
+	default:
+		return http_server_response(conn, 204, NULL, NULL, 0);
+	}
+}
+
+static int download_cb(struct http_server_conn *conn,
+		       enum http_server_event evt, const uint8_t *data,
+		       size_t len, void *user_data)
+{
+	size_t sent;
+	int ret;
+
+	if (evt != HTTP_SERVER_REQ_END) {
+		return 0;
+	}
+
+	ret = http_server_response_begin(conn, 200, "application/octet-stream",
+					 HTTP_SERVER_CHUNKED);
+
+	for (sent = 0; ret == 0 && sent < STREAM_SIZE; sent += BLOCK_SIZE) {
+		ret = http_server_response_send(conn, block, BLOCK_SIZE);
+	}
+
+	return ret;
+}
+
+static const struct http_resource resources[] = {
+	{ "/data", HTTP_METHOD_BIT(HTTP_GET), data_cb, NULL },
+	{ "/upload", HTTP_METHOD_BIT(HTTP_POST), upload_cb, NULL },
+	{ "/download", HTTP_METHOD_BIT(HTTP_GET), download_cb, NULL },
+};
+
+static void server_thread(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	int ret;
+
+	ret = http_server_init(&server, (struct sockaddr *)&addr, sizeof(addr),
+			       resources, ARRAY_SIZE(resources));
+	k_sem_give(&server_ready);
+	if (ret < 0) {
+		printk("server init failed (%d)\n", ret);
+		return;
+	}
+
+	ret = http_server_run(&server);
+	printk("server stopped (%d)\n", ret);
+}
+
+K_THREAD_DEFINE(server_tid, STACK_SIZE, server_thread, NULL, NULL, NULL,
+		PRIORITY, 0, 0);
+
+static int client_connect(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+		.sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+	};
+	int sock;
+
+	sock = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (sock < 0) {
+		return -errno;
+	}
+
+	if (zsock_connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		zsock_close(sock);
+		return -errno;
+	}
+
+	return sock;
+}
+
+static int send_all(int sock, const void *buf, size_t len)
+{
+	while (len) {
+		ssize_t out_len = zsock_send(sock, buf, len, 0);
+
+		if (out_len < 0) {
+			return -errno;
+		}
+
+		buf = (const uint8_t *)buf + out_len;
+		len -= out_len;
+	}
+
+	return 0;
+}
+
+/* Receive len bytes, or until the end of a chunked body if len is 0. */
+static ssize_t recv_response(int sock, size_t len)
+{
+	static uint8_t buf[BLOCK_SIZE];
+	char tail[sizeof(LAST_CHUNK) - 1] = { 0 };
+	size_t received = 0;
+	ssize_t ret;
+
+	while (len == 0 || received < len) {
+		ret = zsock_recv(sock, buf,
+				 len ? MIN(sizeof(buf), len - received) :
+				 sizeof(buf), 0);
+		if (ret <= 0) {
+			return ret < 0 ? -errno : -ECONNRESET;
+		}
+
+		received += ret;
+
+		if (len) {
+			continue;
+		}
+
+		/* Keep the last bytes received to find the last chunk. */
+		if (ret >= sizeof(tail)) {
+			memcpy(tail, buf + ret - sizeof(tail), sizeof(tail));
+		} else {
+			memmove(tail, tail + ret, sizeof(tail) - ret);
+			memcpy(tail + sizeof(tail) - ret, buf, ret);
+		}
+
+		if (memcmp(tail, LAST_CHUNK, sizeof(tail)) == 0) {
+			break;
+		}
+	}
+
+	return received;
+}
+
+static int bench_get(int sock)
+{
+	static char requests[N_PIPELINED * (sizeof(GET_REQUEST) - 1)];
+	size_t response_len;
+	int64_t start;
+	int ret;
+	int i;
+
+	for (i = 0; i < N_PIPELINED; i++) {
+		memcpy(requests + i * (sizeof(GET_REQUEST) - 1), GET_REQUEST,
+		       sizeof(GET_REQUEST) - 1);
+	}
+
+	/* Warm up the connection with a first request. */
+	ret = send_all(sock, GET_REQUEST, sizeof(GET_REQUEST) - 1);
+	if (ret < 0) {
+		return ret;
+	}
+
+	response_len = sizeof("HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\n"
+			      "Content-Length: " STRINGIFY(BODY_SIZE)
+			      "\r\n\r\n") - 1 + BODY_SIZE;
+	ret = recv_response(sock, response_len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	start = k_uptime_get();
+
+	for (i = 0; i < N_REQUESTS; i += N_PIPELINED) {
+		ret = send_all(sock, requests, sizeof(requests));
+		if (ret < 0) {
+			return ret;
+		}
+
+		ret = recv_response(sock, N_PIPELINED * response_len);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	printk("get: %u requests %u bytes %u ms\n", N_REQUESTS,
+	       N_REQUESTS * BODY_SIZE, (uint32_t)(k_uptime_get() - start));
+
+	return 0;
+}
+
+static int bench_upload(int sock)
+{
+	static const char header[] = "POST /upload HTTP/1.1\r\n"
+				     "Transfer-Encoding: chunked\r\n\r\n";
+	static const char response[] = "HTTP/1.1 204 No Content\r\n"
+				       "Content-Length: 0\r\n\r\n";
+	char chunk_header[8];
+	int64_t start;
+	size_t sent;
+	int ret;
+
+	start = k_uptime_get();
+
+	ret = send_all(sock, header, sizeof(header) - 1);
+
+	for (sent = 0; ret == 0 && sent < STREAM_SIZE; sent += BLOCK_SIZE) {
+		snprintk(chunk_header, sizeof(chunk_header), "%x\r\n",
+			 BLOCK_SIZE);
+		ret = send_all(sock, chunk_header, strlen(chunk_header));
+		if (ret == 0) {
+			ret = send_all(sock, block, BLOCK_SIZE);
+		}
+
+		if (ret == 0) {
+			ret = send_all(sock, "\r\n", 2);
+		}
+	}
+
+	if (ret == 0) {
+		ret = send_all(sock, LAST_CHUNK, sizeof(LAST_CHUNK) - 1);
+	}
+
+	if (ret == 0) {
+		ret = recv_response(sock, sizeof(response) - 1);
+	}
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (uploaded != STREAM_SIZE) {
+		printk("upload: server received %zu bytes\n", uploaded);
+		return -EIO;
+	}
+
+	printk("upload: %u bytes %u ms\n", STREAM_SIZE,
+	       (uint32_t)(k_uptime_get() - start));
+
+	return 0;
+}
+
+static int bench_download(int sock)
+{
+	static const char request[] = "GET /download HTTP/1.1\r\n\r\n";
+	int64_t start;
+	ssize_t ret;
+
+	start = k_uptime_get();
+
+	ret = send_all(sock, request, sizeof(request) - 1);
+	if (ret == 0) {
+		ret = recv_response(sock, 0);
+	}
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	printk("download: %u bytes %u ms\n", STREAM_SIZE,
+	       (uint32_t)(k_uptime_get() - start));
+
+	return 0;
+}
+
+void main(void)
+{
+	int sock;
+	int ret;
+
+	memset(block, 'x', sizeof(block));
+	k_sem_take(&server_ready, K_FOREVER);
+
+	printk("HTTP server, %d byte blocks\n", BLOCK_SIZE);
+
+	sock = client_connect();
+	if (sock < 0) {
+		printk("connect failed (%d)\n", sock);
+		return;
+	}
+
+	ret = bench_get(sock);
+	if (ret == 0) {
+		ret = bench_upload(sock);
+	}
+
+	if (ret == 0) {
+		ret = bench_download(sock);
+	}
+
+	zsock_close(sock);
+
+	if (ret < 0) {
+		printk("failed (%d)\n", ret);
+		return;
+	}
+
+	printk("done\n");
+}
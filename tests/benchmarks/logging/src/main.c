@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <logging/log.h>
+#include <logging/log_backend.h>
+#include <logging/log_ctrl.h>
+
+/*
+ * Measures the average number of cycles spent in the context of the caller
+ * of a deferred log call, with the given mode:
+ * - no args: message without argument,
+ * - 1 arg, 3 args: integer arguments,
+ * - string: a transient string argument, duplicated with log_strdup() by
+ *   the legacy mode and copied in the message by the packaged mode.
+ *
+ * The messages are processed between the batches, the processing time is
+ * not measured.
+ */
+
+LOG_MODULE_REGISTER(bench, LOG_LEVEL_INF);
+
+#define N_BATCHES 32
+#define BATCH_SIZE 16
+
+static uint32_t processed;
+
+static void put(const struct log_backend *const backend,
+		struct log_msg *msg)
+{
+	processed++;
+}
+
+static void process(const struct log_backend *const backend,
+		    const struct log_msg2 *msg)
+{
+	processed++;
+}
+
+static void dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	printk("dropped %u messages\n", cnt);
+}
+
+static void panic(const struct log_backend *const backend)
+{
+}
+
+static const struct log_backend_api bench_backend_api = {
+	.put = IS_ENABLED(CONFIG_LOG2) ? NULL : put,
+	.process = IS_ENABLED(CONFIG_LOG2) ? process : NULL,
+	.dropped = dropped,
+	.panic = panic,
+};
+
+LOG_BACKEND_DEFINE(bench_backend, bench_backend_api, false);
+
+static void flush(void)
+{
+	while (log_process(false)) {
+	}
+}
+
+#define MEASURE(name, ...)						\
+	do {								\
+		uint32_t cycles = 0;					\
+		uint32_t start;						\
+									\
+		processed = 0;						\
+		for (int b = 0; b < N_BATCHES; b++) {			\
+			start = k_cycle_get_32();			\
+			for (int i = 0; i < BATCH_SIZE; i++) {		\
+				__VA_ARGS__;				\
+			}						\
+			cycles += k_cycle_get_32() - start;		\
+			flush();					\
+		}							\
+		printk("%s: %u cycles (%u/%u processed)\n", name,	\
+		       cycles / (N_BATCHES * BATCH_SIZE), processed,	\
+		       N_BATCHES * BATCH_SIZE);				\
+	} while (0)
+
+void main(void)
+{
+	char str[] = "transient";
+
+	log_backend_enable(&bench_backend, NULL, LOG_LEVEL_INF);
+
+	MEASURE("no args", LOG_INF("no args"));
+	MEASURE("1 arg", LOG_INF("%d", i));
+	MEASURE("3 args", LOG_INF("%d %d %d", i, b, 3));
+	MEASURE("string", LOG_INF("%s", log_strdup(str)));
+
+	printk("done\n");
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <net/coap.h>
+#include <net/lwm2m.h>
+
+#include "lwm2m_object.h"
+#include "lwm2m_engine.h"
+#include "lwm2m_rw_oma_tlv.h"
+#include "lwm2m_rw_json.h"
+#include "lwm2m_rw_cbor.h"
+
+/*
+ * Compares the cost of the multi resource content formats. Encoding
+ * reads the whole device object instance /3/0, decoding writes the
+ * time, UTC offset and timezone resources of /3/0 with the same values
+ * in each format.
+ */
+
+#define N_RUNS 200
+
+#define TIME_HI 0x5f, 0x5e
+#define TIME_LO 0x10, 0x00
+#define UTC_OFFSET '+', '0', '2', ':', '0', '0'
+#define TIMEZONE 'E', 'u', 'r', 'o', 'p', 'e', '/', 'P', 'a', 'r', 'i', 's'
+
+static const uint8_t tlv_payload[] = {
+	0xc4, 13, TIME_HI, TIME_LO,
+	0xc6, 14, UTC_OFFSET,
+	0xc8, 15, 12, TIMEZONE,
+};
+
+static const char json_payload[] =
+	"{\"bn\":\"/3/0/\",\"e\":["
+	"{\"n\":\"13\",\"v\":1600000000},"
+	"{\"n\":\"14\",\"sv\":\"+02:00\"},"
+	"{\"n\":\"15\",\"sv\":\"Europe/Paris\"}]}";
+
+/* [{-2: "/3/0/", 0: "13", 2: 1600000000}, {0: "14", 3: "+02:00"}, ...] */
+static const uint8_t senml_cbor_payload[] = {
+	0x83,
+	0xa3, 0x21, 0x65, '/', '3', '/', '0', '/',
+	0x00, 0x62, '1', '3', 0x02, 0x1a, TIME_HI, TIME_LO,
+	0xa2, 0x00, 0x62, '1', '4', 0x03, 0x66, UTC_OFFSET,
+	0xa2, 0x00, 0x62, '1', '5', 0x03, 0x6c, TIMEZONE,
+};
+
+/* {[3, 0]: {13: 1600000000, 14: "+02:00", 15: "Europe/Paris"}} */
+static const uint8_t lwm2m_cbor_payload[] = {
+	0xa1, 0x82, 0x03, 0x00,
+	0xa3, 0x0d, 0x1a, TIME_HI, TIME_LO,
+	0x0e, 0x66, UTC_OFFSET,
+	0x0f, 0x6c, TIMEZONE,
+};
+
+struct content_format {
+	const char *name;
+	uint16_t content_format;
+	const struct lwm2m_writer *writer;
+	const struct lwm2m_reader *reader;
+	int (*read_op)(struct lwm2m_message *msg, int content_format);
+	int (*write_op)(struct lwm2m_message *msg);
+	const uint8_t *payload;
+	uint16_t payload_len;
+};
+
+static const struct content_format formats[] = {
+	{ "tlv", LWM2M_FORMAT_OMA_TLV, &oma_tlv_writer, &oma_tlv_reader,
+	  do_read_op_tlv, do_write_op_tlv,
+	  tlv_payload, sizeof(tlv_payload) },
+	{ "json", LWM2M_FORMAT_OMA_JSON, &json_writer, &json_reader,
+	  do_read_op_json, do_write_op_json,
+	  (const uint8_t *)json_payload, sizeof(json_payload) - 1 },
+	{ "senml-cbor", LWM2M_FORMAT_APP_SENML_CBOR, &senml_cbor_writer,
+	  &cbor_reader, do_read_op_cbor, do_write_op_senml_cbor,
+	  senml_cbor_payload, sizeof(senml_cbor_payload) },
+	{ "lwm2m-cbor", LWM2M_FORMAT_OMA_CBOR, &lwm2m_cbor_writer,
+	  &cbor_reader, do_read_op_cbor, do_write_op_lwm2m_cbor,
+	  lwm2m_cbor_payload, sizeof(lwm2m_cbor_payload) },
+};
+
+static struct lwm2m_ctx ctx;
+static struct lwm2m_message msg;
+static uint8_t out_buf[1024];
+static uint8_t in_buf[256];
+
+static void init_msg(void)
+{
+	(void)memset(&msg, 0, sizeof(msg));
+	msg.ctx = &ctx;
+	msg.path.obj_id = 3;
+	msg.path.obj_inst_id = 0;
+	msg.path.level = 2;
+}
+
+static int encode(const struct content_format *fmt, uint16_t *len)
+{
+	struct coap_packet cpkt;
+	uint16_t hdr_len;
+	int ret;
+
+	ret = coap_packet_init(&cpkt, out_buf, sizeof(out_buf), 1,
+			       COAP_TYPE_ACK, 0, NULL,
+			       COAP_RESPONSE_CODE_CONTENT, 0);
+	if (ret < 0) {
+		return ret;
+	}
+
+	hdr_len = cpkt.offset;
+
+	init_msg();
+	msg.out.out_cpkt = &cpkt;
+	msg.out.writer = fmt->writer;
+
+	ret = fmt->read_op(&msg, fmt->content_format);
+
+	/* content-format option, payload marker and payload */
+	*len = cpkt.offset - hdr_len;
+	return ret;
+}
+
+static int decode(const struct content_format *fmt)
+{
+	struct coap_packet cpkt;
+
+	/* the reader may not modify the payload but works on a copy anyway */
+	memcpy(in_buf, fmt->payload, fmt->payload_len);
+	cpkt.data = in_buf;
+	cpkt.offset = fmt->payload_len;
+	cpkt.max_len = fmt->payload_len;
+
+	init_msg();
+	msg.in.in_cpkt = &cpkt;
+	msg.in.offset = 0U;
+	msg.in.reader = fmt->reader;
+
+	return fmt->write_op(&msg);
+}
+
+static uint32_t avg_ns(uint32_t cycles)
+{
+	return (uint32_t)k_cyc_to_ns_floor64(cycles) / N_RUNS;
+}
+
+void main(void)
+{
+	uint32_t start, encode_cycles, decode_cycles;
+	uint16_t len = 0U;
+	int i, j, ret;
+
+	printk("LwM2M content formats, %d runs\n", N_RUNS);
+
+	for (i = 0; i < ARRAY_SIZE(formats); i++) {
+		const struct content_format *fmt = &formats[i];
+
+		ret = 0;
+
+		start = k_cycle_get_32();
+		for (j = 0; j < N_RUNS && ret >= 0; j++) {
+			ret = encode(fmt, &len);
+		}
+
+		encode_cycles = k_cycle_get_32() - start;
+
+		if (ret < 0) {
+			printk("%s encode failed (%d)\n", fmt->name, ret);
+			continue;
+		}
+
+		start = k_cycle_get_32();
+		for (j = 0; j < N_RUNS && ret >= 0; j++) {
+			ret = decode(fmt);
+		}
+
+		decode_cycles = k_cycle_get_32() - start;
+
+		if (ret < 0) {
+			printk("%s decode failed (%d)\n", fmt->name, ret);
+			continue;
+		}
+
+		printk("%s: encode %u bytes %u ns, decode %u bytes %u ns\n",
+		       fmt->name, len, avg_ns(encode_cycles),
+		       fmt->payload_len, avg_ns(decode_cycles));
+	}
+
+	printk("done\n");
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Test the packages created at build time against the runtime ones
+ *
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <sys/cbprintf.h>
+
+#include "test.inc"
+
+/* Defined in the C++ file */
+void test_cpp_types(void);
+
+struct out_buf {
+	char buf[64];
+	size_t len;
+};
+
+static int buf_out(int c, void *ctx)
+{
+	struct out_buf *out = ctx;
+
+	zassert_true(out->len < sizeof(out->buf) - 1, "Output too long");
+	out->buf[out->len++] = (char)c;
+	out->buf[out->len] = '\0';
+
+	return c;
+}
+
+static void test_c_types(void)
+{
+	pkg_types_check();
+}
+
+static void test_char_pointer(void)
+{
+	uint8_t pkg[PKG_MAX_LEN];
+	struct out_buf output = { .len = 0 };
+	char expected[sizeof(output.buf)];
+	char str[] = "abcdef";
+	int len;
+
+	/* The string is copied whole, its pointer is still printed by %p and
+	 * the precision applied when formatting.
+	 */
+	CBPRINTF_STATIC_PACKAGE(pkg, sizeof(pkg), len, "%p %.3s", str, str);
+	zassert_true(len > 0, "Package failed (%d)", len);
+
+	(void)memset(str, 0, sizeof(str));
+	zassert_true(cbpprintf(buf_out, &output, pkg) > 0, "Format failed");
+
+	snprintk(expected, sizeof(expected), "%p abc", str);
+	zassert_true(strcmp(output.buf, expected) == 0, "Wrong output %s",
+		     output.buf);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(cbprintf_package,
+			 ztest_unit_test(test_c_types),
+			 ztest_unit_test(test_cpp_types),
+			 ztest_unit_test(test_char_pointer));
+
+	ztest_run_test_suite(cbprintf_package);
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <sys/cbprintf.h>
+
+#include "test.inc"
+
+extern "C" void test_cpp_types(void)
+{
+	pkg_types_check();
+}
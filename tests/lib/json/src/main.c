@@ -539,6 +539,200 @@ static void test_json_encode_bounds_check(void)
 	zassert_equal(ret, -ENOMEM, "Bounds check rejected");
 }
 
+struct stream_result {
+	char text[256];
+	size_t len;
+};
+
+static int stream_record(const struct json_stream_event *event,
+			 void *user_data)
+{
+	struct stream_result *result = user_data;
+	int ret;
+
+	ret = snprintk(result->text + result->len,
+		       sizeof(result->text) - result->len, "%c%s%s%s%s ",
+		       event->type, event->key ? event->key : "",
+		       event->key ? ":" : "", event->value ? "=" : "",
+		       event->value ? event->value : "");
+	if (ret < 0 || (size_t)ret >= sizeof(result->text) - result->len) {
+		return -ENOMEM;
+	}
+
+	result->len += ret;
+
+	return 0;
+}
+
+static int stream_parse(const char *json, size_t chunk_len,
+			struct stream_result *result)
+{
+	struct json_stream stream;
+	char buf[32];
+	size_t len = strlen(json);
+	size_t pos;
+	int ret;
+
+	result->len = 0;
+	result->text[0] = '\0';
+	json_stream_init(&stream, buf, sizeof(buf), stream_record, result);
+
+	for (pos = 0; pos < len; pos += chunk_len) {
+		ret = json_stream_feed(&stream, json + pos,
+				       MIN(chunk_len, len - pos));
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return json_stream_end(&stream);
+}
+
+static void test_json_stream_parse(void)
+{
+	const char *json = "{\"some_string\":\"zephyr \\\"123\\\"\","
+		"\"some_int\":-42, \"nested\": {\"list\":[1,true,null,"
+		"false,{}, []]}, \"empty\":\"\"}";
+	const char *expected = "{ \"some_string:=zephyr \\\"123\\\" "
+		"0some_int:=-42 {nested: [list: 0=1 t n f { } [ ] ] } "
+		"\"empty:= } ";
+	struct stream_result result;
+	size_t chunk_len;
+	int ret;
+
+	/* The events must not depend on how the document is split. */
+	for (chunk_len = 1; chunk_len <= strlen(json); chunk_len *= 3) {
+		ret = stream_parse(json, chunk_len, &result);
+		zassert_equal(ret, 0, "Stream parsed in chunks of %zu",
+			      chunk_len);
+		zassert_true(!strcmp(result.text, expected),
+			     "Events correct: %s", result.text);
+	}
+
+	ret = stream_parse(" 1234 ", 1, &result);
+	zassert_equal(ret, 0, "Top-level number parsed");
+	zassert_true(!strcmp(result.text, "0=1234 "), "Number reported");
+
+	ret = stream_parse("1234", 1, &result);
+	zassert_equal(ret, 0, "Number ending the document parsed");
+	zassert_true(!strcmp(result.text, "0=1234 "), "Number reported");
+}
+
+static void test_json_stream_invalid(void)
+{
+	const char *invalid[] = {
+		"", "{", "{\"a\":1,}", "{\"a\":1]", "[1,]", "{\"a\"}",
+		"{1:2}", "tru", "truex", "[-]", "\"\\x\"", "\"\\u12x4\"",
+		"{} {}",
+	};
+	struct stream_result result;
+	struct json_stream stream;
+	char buf[8];
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(invalid); i++) {
+		zassert_equal(stream_parse(invalid[i], 1, &result), -EINVAL,
+			      "Invalid document rejected: %s", invalid[i]);
+	}
+
+	/* A key and value need 8 bytes: "abc", "def" and two NULs. */
+	json_stream_init(&stream, buf, 7, stream_record, &result);
+	zassert_equal(json_stream_feed(&stream, "{\"abc\":\"def\"}", 13),
+		      -ENOMEM, "Token larger than the buffer rejected");
+
+	json_stream_init(&stream, buf, 8, stream_record, &result);
+	zassert_equal(json_stream_feed(&stream, "{\"abc\":\"def\"}", 13), 0,
+		      "Token fitting in the buffer accepted");
+	zassert_equal(json_stream_end(&stream), 0, "Document complete");
+}
+
+struct writer_buf {
+	char buf[128];
+	size_t used;
+};
+
+static int writer_append(const char *bytes, size_t len, void *data)
+{
+	struct writer_buf *out = data;
+
+	if (len >= sizeof(out->buf) - out->used) {
+		return -ENOMEM;
+	}
+
+	memcpy(out->buf + out->used, bytes, len);
+	out->used += len;
+	out->buf[out->used] = '\0';
+
+	return 0;
+}
+
+static void test_json_writer(void)
+{
+	struct test_nested nested = {
+		.nested_int = 1,
+		.nested_bool = true,
+		.nested_string = "x",
+	};
+	const char *expected = "{\"name\":\"tab\\t\",\"values\":[-1,false,"
+		"null,{\"nested_int\":1,\"nested_bool\":true,"
+		"\"nested_string\":\"x\"}],\"empty\":{}}";
+	struct writer_buf out = { .used = 0 };
+	struct json_writer writer;
+	int ret;
+
+	json_writer_init(&writer, writer_append, &out);
+	json_writer_obj_start(&writer, NULL);
+	json_writer_str(&writer, "name", "tab\t");
+	json_writer_arr_start(&writer, "values");
+	json_writer_num(&writer, NULL, -1);
+	json_writer_bool(&writer, NULL, false);
+	json_writer_null(&writer, NULL);
+	json_writer_obj(&writer, NULL, nested_descr,
+			ARRAY_SIZE(nested_descr), &nested);
+	json_writer_arr_end(&writer);
+	json_writer_obj_start(&writer, "empty");
+	json_writer_obj_end(&writer);
+	json_writer_obj_end(&writer);
+	ret = json_writer_end(&writer);
+
+	zassert_equal(ret, 0, "Document encoded");
+	zassert_true(!strcmp(out.buf, expected),
+		     "Encoded document correct: %s", out.buf);
+
+	/* Errors are sticky. */
+	json_writer_init(&writer, writer_append, &out);
+	json_writer_obj_start(&writer, NULL);
+	zassert_equal(json_writer_num(&writer, NULL, 1), -EINVAL,
+		      "Value without key rejected in object");
+	zassert_equal(json_writer_obj_end(&writer), -EINVAL, "Error kept");
+	zassert_equal(json_writer_end(&writer), -EINVAL, "Error kept");
+
+	json_writer_init(&writer, writer_append, &out);
+	json_writer_arr_start(&writer, NULL);
+	zassert_equal(json_writer_end(&writer), -EINVAL,
+		      "Unterminated array rejected");
+
+	/* A document holds a single top-level value. */
+	out.used = 0;
+	json_writer_init(&writer, writer_append, &out);
+	zassert_equal(json_writer_num(&writer, NULL, 1), 0, "Root value added");
+	zassert_equal(json_writer_num(&writer, NULL, 2), -EINVAL,
+		      "Second root value rejected");
+	zassert_equal(json_writer_end(&writer), -EINVAL, "Error kept");
+	zassert_true(!strcmp(out.buf, "1"), "Second value not written: %s",
+		     out.buf);
+
+	json_writer_init(&writer, writer_append, &out);
+	json_writer_obj_start(&writer, NULL);
+	json_writer_obj_end(&writer);
+	zassert_equal(json_writer_arr_start(&writer, NULL), -EINVAL,
+		      "Value after the root object rejected");
+
+	json_writer_init(&writer, writer_append, &out);
+	zassert_equal(json_writer_end(&writer), -EINVAL,
+		      "Empty document rejected");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_json_test,
@@ -560,7 +754,10 @@ void test_main(void)
 			 ztest_unit_test(test_json_escape_empty),
 			 ztest_unit_test(test_json_escape_no_op),
 			 ztest_unit_test(test_json_escape_bounds_check),
-			 ztest_unit_test(test_json_encode_bounds_check)
+			 ztest_unit_test(test_json_encode_bounds_check),
+			 ztest_unit_test(test_json_stream_parse),
+			 ztest_unit_test(test_json_stream_invalid),
+			 ztest_unit_test(test_json_writer)
 			 );
 
 	ztest_run_test_suite(lib_json_test);
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+#include <sys/mpsc_pbuf.h>
+
+#define BUF_WORDS 16
+
+static uint32_t buf_mem[BUF_WORDS];
+static struct mpsc_pbuf_buffer buffer;
+
+static void *alloc_fill(size_t len, uint8_t value)
+{
+	uint8_t *data = mpsc_pbuf_alloc(&buffer, len);
+
+	if (data != NULL) {
+		memset(data, value, len);
+	}
+
+	return data;
+}
+
+static void claim_check(size_t len, uint8_t value)
+{
+	const uint8_t *data;
+	size_t claimed_len;
+
+	data = mpsc_pbuf_claim(&buffer, &claimed_len);
+	zassert_not_null(data, "no packet");
+	zassert_equal(claimed_len, ROUND_UP(len, sizeof(uint32_t)),
+		      "wrong length");
+
+	for (size_t i = 0; i < len; i++) {
+		zassert_equal(data[i], value, "wrong data");
+	}
+
+	mpsc_pbuf_free(&buffer, data);
+}
+
+static void test_setup(void)
+{
+	mpsc_pbuf_init(&buffer, buf_mem, BUF_WORDS);
+}
+
+static void test_alloc_claim(void)
+{
+	size_t len;
+	void *data;
+
+	zassert_is_null(mpsc_pbuf_claim(&buffer, &len), "buffer not empty");
+
+	data = alloc_fill(5, 0xaa);
+	zassert_not_null(data, "alloc failed");
+	zassert_true(mpsc_pbuf_is_pending(&buffer), "no pending packet");
+	mpsc_pbuf_commit(&buffer, data);
+
+	data = alloc_fill(12, 0xbb);
+	zassert_not_null(data, "alloc failed");
+	mpsc_pbuf_commit(&buffer, data);
+
+	claim_check(5, 0xaa);
+	claim_check(12, 0xbb);
+
+	zassert_is_null(mpsc_pbuf_claim(&buffer, &len), "buffer not empty");
+	zassert_false(mpsc_pbuf_is_pending(&buffer), "pending packet");
+}
+
+static void test_commit_order(void)
+{
+	void *first = alloc_fill(4, 1);
+	void *second = alloc_fill(4, 2);
+	size_t len;
+
+	/* The second packet is not claimed before the first one. */
+	mpsc_pbuf_commit(&buffer, second);
+	zassert_is_null(mpsc_pbuf_claim(&buffer, &len), "claimed out of order");
+
+	mpsc_pbuf_commit(&buffer, first);
+	claim_check(4, 1);
+	claim_check(4, 2);
+}
+
+static void test_full(void)
+{
+	void *data;
+	int n = 0;
+
+	/* Each packet takes 2 words, one word is kept free. */
+	while ((data = alloc_fill(4, n)) != NULL) {
+		mpsc_pbuf_commit(&buffer, data);
+		n++;
+	}
+
+	zassert_equal(n, (BUF_WORDS - 1) / 2, "wrong number of packets");
+	zassert_is_null(mpsc_pbuf_alloc(&buffer, BUF_WORDS * 4),
+			"oversized alloc succeeded");
+
+	claim_check(4, 0);
+
+	data = alloc_fill(4, 0xff);
+	zassert_not_null(data, "no space after free");
+	mpsc_pbuf_commit(&buffer, data);
+
+	for (int i = 1; i < n; i++) {
+		claim_check(4, i);
+	}
+
+	claim_check(4, 0xff);
+
+	zassert_equal(mpsc_pbuf_max_usage(&buffer),
+		      (BUF_WORDS - 2) * sizeof(uint32_t), "wrong usage");
+}
+
+static void test_wrap(void)
+{
+	void *data;
+	int i;
+
+	/* Move the indexes close to the end of the buffer. */
+	for (i = 0; i < 3; i++) {
+		data = alloc_fill(12, i);
+		mpsc_pbuf_commit(&buffer, data);
+		claim_check(12, i);
+	}
+
+	/* 4 words left before the end, the packet is placed at the start. */
+	data = alloc_fill(16, 0x55);
+	zassert_equal_ptr(data, &buf_mem[1], "packet not wrapped");
+	mpsc_pbuf_commit(&buffer, data);
+
+	claim_check(16, 0x55);
+	zassert_false(mpsc_pbuf_is_pending(&buffer), "pending packet");
+}
+
+static void offload_alloc(const void *arg)
+{
+	void *data = alloc_fill(8, 0x77);
+
+	zassert_not_null(data, "alloc failed in interrupt");
+	mpsc_pbuf_commit(&buffer, data);
+}
+
+static void test_interrupt(void)
+{
+	void *data = alloc_fill(8, 0x66);
+
+	/* The packet of the interrupted producer is claimed first, even
+	 * though the packet of the interrupt is committed before it.
+	 */
+	irq_offload(offload_alloc, NULL);
+	mpsc_pbuf_commit(&buffer, data);
+
+	claim_check(8, 0x66);
+	claim_check(8, 0x77);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_mpsc_pbuf,
+			 ztest_unit_test_setup_teardown(test_alloc_claim,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_commit_order,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_full,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_wrap,
+							test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_interrupt,
+							test_setup,
+							unit_test_noop));
+	ztest_run_test_suite(test_mpsc_pbuf);
+}
@@ -64,7 +64,13 @@ static bool recv_cb_reconfig_called;
 static bool recv_cb_timeout_called;
 static bool test_sending;
 
+/* Packets kept by the driver to test the send buffer accounting */
+static bool hold_pkts;
+static struct net_pkt *held_pkts[3];
+static int held_count;
+
 static struct k_sem wait_data;
+static struct k_sem wait_held;
 
 #define WAIT_TIME K_MSEC(250)
 #define WAIT_TIME_LONG MSEC_PER_SEC
@@ -825,6 +831,79 @@ static void test_net_ctx_recv_v4_timeout_forever(void)
 	recv_cb_timeout_called = false;
 }
 
+static int sndbuf_send(struct net_context *ctx)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PEER_PORT),
+		.sin_addr = { { { 192, 0, 2, 2 } } },
+	};
+	int ret;
+
+	ret = net_context_sendto(ctx, test_data, strlen(test_data),
+				 (struct sockaddr *)&addr,
+				 sizeof(struct sockaddr_in), NULL,
+				 K_NO_WAIT, NULL);
+	if (ret < 0) {
+		return ret;
+	}
+
+	zassert_equal(k_sem_take(&wait_held, WAIT_TIME), 0,
+		      "Packet not sent");
+
+	return 0;
+}
+
+static void test_net_ctx_sndbuf(void)
+{
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+	struct net_context *ctx;
+	int sndbuf = 2 * strlen(test_data);
+	int ret;
+
+	ret = net_context_get(AF_INET, SOCK_DGRAM, IPPROTO_UDP, &ctx);
+	zassert_equal(ret, 0, "Context get failed");
+
+	ret = net_context_set_option(ctx, NET_OPT_SNDBUF, &sndbuf,
+				     sizeof(sndbuf));
+	zassert_equal(ret, 0, "Cannot set the send buffer size");
+
+	hold_pkts = true;
+	held_count = 0;
+
+	zassert_equal(sndbuf_send(ctx), 0, "First datagram not sent");
+	zassert_equal(sndbuf_send(ctx), 0, "Second datagram not sent");
+	zassert_equal(atomic_get(&ctx->sndbuf_used), sndbuf,
+		      "Invalid send buffer usage");
+
+	zassert_equal(sndbuf_send(ctx), -EAGAIN,
+		      "Datagram over the send buffer size sent");
+
+	/* Freeing a packet gives its space back */
+	net_pkt_unref(held_pkts[0]);
+	zassert_equal(sndbuf_send(ctx), 0, "Space not given back");
+
+	/* The context stays allocated until its last charged packet is
+	 * freed, so that a reused context is not credited.
+	 */
+	ret = net_context_put(ctx);
+	zassert_equal(ret, 0, "Context put failed");
+
+	net_pkt_unref(held_pkts[1]);
+	zassert_true(net_context_is_used(ctx),
+		     "Context released with a packet pending");
+
+	net_pkt_unref(held_pkts[2]);
+	zassert_false(net_context_is_used(ctx), "Context not released");
+	zassert_equal(atomic_get(&ctx->sndbuf_used), 0,
+		      "Invalid send buffer usage");
+
+	hold_pkts = false;
+#else
+	ztest_test_skip();
+#endif
+}
+
 static void test_net_ctx_put(void)
 {
 	int ret;
@@ -896,6 +975,15 @@ static int tester_send(const struct device *dev, struct net_pkt *pkt)
 		return -ENODATA;
 	}
 
+	if (hold_pkts) {
+		zassert_true(held_count < ARRAY_SIZE(held_pkts),
+			     "Too many packets held");
+		held_pkts[held_count++] = net_pkt_ref(pkt);
+		k_sem_give(&wait_held);
+
+		return 0;
+	}
+
 	if (test_sending) {
 		/* We are now about to send data to outside but in this
 		 * test we just check what would be sent. In real life
@@ -997,6 +1085,7 @@ static void test_init(void)
 
 	/* The semaphore is there to wait the data to be received. */
 	k_sem_init(&wait_data, 0, UINT_MAX);
+	k_sem_init(&wait_held, 0, UINT_MAX);
 }
 
 /*test case main entry*/
@@ -1034,6 +1123,7 @@ void test_main(void)
 			 ztest_unit_test(test_net_ctx_recv_v4_timeout),
 			 ztest_unit_test(test_net_ctx_recv_v6_timeout_forever),
 			 ztest_unit_test(test_net_ctx_recv_v4_timeout_forever),
+			 ztest_unit_test(test_net_ctx_sndbuf),
 			 ztest_unit_test(test_net_ctx_put));
 	ztest_run_test_suite(test_context);
 }
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_TC_LOG_LEVEL);
+
+#include <zephyr/types.h>
+#include <string.h>
+#include <errno.h>
+#include <random/rand32.h>
+
+#include <ztest.h>
+
+#include <net/dummy.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+#include <net/net_mgmt.h>
+#include <net/net_stats.h>
+#include <net/net_context.h>
+#include <net/udp.h>
+
+#include "ipv6.h"
+#include "net_private.h"
+
+#define PAYLOAD_LEN 200
+
+#define BULK_COUNT 20
+#define SPARSE_COUNT 2
+#define STANDING_QUEUE_COUNT 30
+
+#define DRAIN_TIMEOUT_MS 2000
+
+#define BULK_MARK 'B'
+#define SPARSE_MARK 'S'
+
+static struct in6_addr my_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 1, 0, 0, 0,
+				       0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static struct in6_addr peer_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 9, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+
+static struct sockaddr_in6 peer_addr6 = {
+	.sin6_family = AF_INET6,
+	.sin6_port = htons(9999),
+};
+
+static struct net_if *iface;
+static struct net_context *bulk_ctx;
+static struct net_context *sparse_ctx;
+
+/* Order in which the "link" transmitted the packets */
+static uint8_t sent_marks[STANDING_QUEUE_COUNT + BULK_COUNT + SPARSE_COUNT];
+static int sent_count;
+
+/* Time it takes the emulated link to send one packet */
+static int32_t link_delay_ms;
+
+struct fq_test_context {
+	uint8_t mac_addr[6];
+};
+
+static struct fq_test_context fq_test_context;
+
+static void fq_iface_init(struct net_if *iface)
+{
+	const struct device *dev = net_if_get_device(iface);
+	struct fq_test_context *ctx = dev->data;
+
+	ctx->mac_addr[0] = 0x00;
+	ctx->mac_addr[1] = 0x00;
+	ctx->mac_addr[2] = 0x5E;
+	ctx->mac_addr[3] = 0x00;
+	ctx->mac_addr[4] = 0x53;
+	ctx->mac_addr[5] = sys_rand32_get();
+
+	net_if_set_link_addr(iface, ctx->mac_addr, sizeof(ctx->mac_addr),
+			     NET_LINK_DUMMY);
+}
+
+static int fq_iface_send(const struct device *dev, struct net_pkt *pkt)
+{
+	uint8_t mark;
+
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_skip(pkt, sizeof(struct net_ipv6_hdr) +
+			 sizeof(struct net_udp_hdr)) ||
+	    net_pkt_read_u8(pkt, &mark)) {
+		return -EINVAL;
+	}
+
+	if (sent_count < ARRAY_SIZE(sent_marks)) {
+		sent_marks[sent_count] = mark;
+	}
+
+	sent_count++;
+
+	/* Keep the Tx thread busy so that a queue builds up behind it */
+	if (link_delay_ms) {
+		k_sleep(K_MSEC(link_delay_ms));
+	}
+
+	return 0;
+}
+
+static int fq_dev_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static struct dummy_api fq_iface_api = {
+	.iface_api.init = fq_iface_init,
+	.send = fq_iface_send,
+};
+
+NET_DEVICE_INIT(fq_codel_test, "fq_codel_test", fq_dev_init,
+		device_pm_control_nop, &fq_test_context, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &fq_iface_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), NET_IPV6_MTU);
+
+/* Counters at the start of the current test */
+static struct net_stats_fq_codel base;
+
+static void get_fq_stats(struct net_stats_fq_codel *stats)
+{
+	int ret;
+
+	ret = net_mgmt(NET_REQUEST_STATS_GET_FQ_CODEL, iface, stats,
+		       sizeof(*stats));
+	zassert_equal(ret, 0, "Cannot get fq_codel statistics (%d)", ret);
+
+	stats->enqueued -= base.enqueued;
+	stats->dequeued -= base.dequeued;
+	stats->drop_codel -= base.drop_codel;
+	stats->drop_overlimit -= base.drop_overlimit;
+	stats->new_flows -= base.new_flows;
+}
+
+static void start_test(int32_t delay_ms)
+{
+	memset(&base, 0, sizeof(base));
+	get_fq_stats(&base);
+
+	sent_count = 0;
+	link_delay_ms = delay_ms;
+}
+
+static void setup_context(struct net_context **ctx)
+{
+	struct sockaddr_in6 addr6 = {
+		.sin6_family = AF_INET6,
+		.sin6_port = 0,
+	};
+	int ret;
+
+	ret = net_context_get(AF_INET6, SOCK_DGRAM, IPPROTO_UDP, ctx);
+	zassert_equal(ret, 0, "Cannot get context (%d)", ret);
+
+	net_ipaddr_copy(&addr6.sin6_addr, &my_addr);
+
+	ret = net_context_bind(*ctx, (struct sockaddr *)&addr6,
+			       sizeof(addr6));
+	zassert_equal(ret, 0, "Cannot bind context (%d)", ret);
+}
+
+static void send_pkts(struct net_context *ctx, uint8_t mark, int count)
+{
+	uint8_t data[PAYLOAD_LEN];
+	int i, ret;
+
+	memset(data, mark, sizeof(data));
+
+	for (i = 0; i < count; i++) {
+		ret = net_context_sendto(ctx, data, sizeof(data),
+					 (struct sockaddr *)&peer_addr6,
+					 sizeof(peer_addr6), NULL, K_NO_WAIT,
+					 NULL);
+		zassert_true(ret > 0, "Send failed (%d)", ret);
+	}
+}
+
+/* Wait until every queued packet has been either sent or dropped */
+static void wait_drained(struct net_stats_fq_codel *stats)
+{
+	int64_t end = k_uptime_get() + DRAIN_TIMEOUT_MS;
+
+	do {
+		k_sleep(K_MSEC(10));
+		get_fq_stats(stats);
+	} while (stats->enqueued != stats->dequeued + stats->drop_codel +
+		 stats->drop_overlimit && k_uptime_get() < end);
+
+	zassert_equal(stats->enqueued, stats->dequeued + stats->drop_codel +
+		      stats->drop_overlimit, "Packets left in the queue");
+	zassert_equal(stats->dequeued, sent_count,
+		      "Dequeued packets were not sent");
+}
+
+static void test_setup(void)
+{
+	struct net_if_addr *ifaddr;
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(iface, "No test interface");
+
+	ifaddr = net_if_ipv6_addr_add(iface, &my_addr, NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "Cannot add address");
+	ifaddr->addr_state = NET_ADDR_PREFERRED;
+
+	net_ipaddr_copy(&peer_addr6.sin6_addr, &peer_addr);
+
+	setup_context(&bulk_ctx);
+	setup_context(&sparse_ctx);
+
+	net_if_up(iface);
+}
+
+static void test_sparse_flow_not_delayed(void)
+{
+	struct net_stats_fq_codel stats;
+	int sparse_seen = 0;
+	int i;
+
+	start_test(2);
+
+	/* A bulk transfer fills the queue and a sparse flow sends a couple
+	 * of packets after it. Without flow queueing the sparse packets
+	 * would wait behind the whole bulk backlog.
+	 */
+	send_pkts(bulk_ctx, BULK_MARK, BULK_COUNT);
+	send_pkts(sparse_ctx, SPARSE_MARK, SPARSE_COUNT);
+
+	wait_drained(&stats);
+
+	for (i = 0; i < sent_count && sparse_seen < SPARSE_COUNT; i++) {
+		if (sent_marks[i] != SPARSE_MARK) {
+			continue;
+		}
+
+		zassert_true(i < 2 + 2 * SPARSE_COUNT,
+			     "Sparse packet %d sent as packet %d", sparse_seen,
+			     i);
+		sparse_seen++;
+	}
+
+	zassert_equal(sparse_seen, SPARSE_COUNT, "Sparse packets missing");
+	zassert_equal(stats.enqueued, BULK_COUNT + SPARSE_COUNT,
+		      "Invalid enqueued count");
+	zassert_equal(stats.drop_overlimit, 0, "Unexpected overlimit drop");
+	zassert_true(stats.new_flows >= 2, "Flows not detected");
+}
+
+static void test_standing_queue_dropped(void)
+{
+	struct net_stats_fq_codel stats;
+
+	start_test(5);
+
+	/* With 5 ms per packet the queue delay stays above the target for
+	 * much longer than the interval, so CoDel must start dropping.
+	 */
+	send_pkts(bulk_ctx, BULK_MARK, STANDING_QUEUE_COUNT);
+
+	wait_drained(&stats);
+
+	zassert_true(stats.drop_codel > 0, "CoDel did not drop");
+	zassert_equal(stats.drop_overlimit, 0, "Unexpected overlimit drop");
+	zassert_equal(stats.dequeued + stats.drop_codel, STANDING_QUEUE_COUNT,
+		      "Packets lost");
+}
+
+static void test_overlimit_drop(void)
+{
+	struct net_stats_fq_codel stats;
+	int i, sparse_sent = 0;
+
+	start_test(1);
+
+	/* The bulk flow alone goes over the limit, the packets dropped to
+	 * make room must come from it and not from the sparse flow.
+	 */
+	send_pkts(sparse_ctx, SPARSE_MARK, SPARSE_COUNT);
+	send_pkts(bulk_ctx, BULK_MARK, CONFIG_NET_TX_FQ_CODEL_LIMIT + 5);
+
+	wait_drained(&stats);
+
+	for (i = 0; i < MIN(sent_count, ARRAY_SIZE(sent_marks)); i++) {
+		if (sent_marks[i] == SPARSE_MARK) {
+			sparse_sent++;
+		}
+	}
+
+	zassert_true(stats.drop_overlimit > 0, "Limit not enforced");
+	zassert_equal(sparse_sent, SPARSE_COUNT, "Sparse flow was dropped");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_fq_codel,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_sparse_flow_not_delayed),
+			 ztest_unit_test(test_standing_queue_dropped),
+			 ztest_unit_test(test_overlimit_drop));
+
+	ztest_run_test_suite(net_fq_codel);
+}
@@ -17,6 +17,8 @@ LOG_MODULE_REGISTER(net_test, LOG_LEVEL_DBG);
 #include <kernel.h>
 
 #include <net/coap.h>
+#include <net/coap_buf.h>
+#include <net/coap_link_format.h>
 
 #include <tc_util.h>
 
@@ -1455,6 +1457,622 @@ done:
 	return result;
 }
 
+static const char * const index_path_a_b[] = { "a", "b", NULL };
+static const char * const index_path_a_any[] = { "a", "+", NULL };
+static const char * const index_path_a_c[] = { "a", "c", NULL };
+static const char * const index_path_x[] = { "x", NULL };
+static const char * const index_path_x_all[] = { "x", "#", NULL };
+
+static struct coap_resource index_resources[] = {
+	{ .path = index_path_a_b },
+	{ .path = index_path_a_any },
+	{ .path = index_path_a_c },
+	{ .path = index_path_x },
+	{ .path = index_path_x_all },
+	{ },
+};
+
+/* Find the resource of a request for the '/' separated path */
+static struct coap_resource *index_lookup(struct coap_resource_index *index,
+					  const char *uri)
+{
+	uint8_t data[COAP_BUF_SIZE];
+	struct coap_option options[4];
+	struct coap_packet cpkt;
+	const char *end;
+	int r;
+
+	r = coap_packet_init(&cpkt, data, sizeof(data), 1, COAP_TYPE_CON,
+			     0, NULL, COAP_METHOD_GET, coap_next_id());
+	if (r < 0) {
+		return NULL;
+	}
+
+	while (*uri) {
+		end = strchr(uri, '/');
+		if (!end) {
+			end = uri + strlen(uri);
+		}
+
+		r = coap_packet_append_option(&cpkt, COAP_OPTION_URI_PATH,
+					      (const uint8_t *)uri,
+					      end - uri);
+		if (r < 0) {
+			return NULL;
+		}
+
+		uri = *end ? end + 1 : end;
+	}
+
+	r = coap_packet_parse(&cpkt, data, cpkt.offset, options,
+			      ARRAY_SIZE(options));
+	if (r < 0) {
+		return NULL;
+	}
+
+	return coap_resource_index_find(index, options, r);
+}
+
+static int test_resource_index(void)
+{
+	struct coap_resource_index index;
+	int result = TC_FAIL;
+	static const struct {
+		const char *uri;
+		int resource;
+	} lookups[] = {
+		{ "a/b", 0 },
+		/* The wildcard comes before a/c in the array */
+		{ "a/c", 1 },
+		{ "a/d", 1 },
+		{ "a", -1 },
+		{ "a/b/c", -1 },
+		{ "x", 3 },
+		{ "x/y/z", 4 },
+		{ "y", -1 },
+	};
+	int i;
+
+	if (coap_resource_index_init(&index, index_resources) < 0) {
+		TC_PRINT("Could not build the index\n");
+		goto out;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(lookups); i++) {
+		struct coap_resource *expected = NULL;
+
+		if (lookups[i].resource >= 0) {
+			expected = &index_resources[lookups[i].resource];
+		}
+
+		if (index_lookup(&index, lookups[i].uri) != expected) {
+			TC_PRINT("Wrong resource for %s\n", lookups[i].uri);
+			goto out;
+		}
+	}
+
+	result = TC_PASS;
+
+out:
+	TC_END_RESULT(result);
+
+	return result;
+}
+
+static const char * const wk_path_a_b[] = { "a", "b", NULL };
+static const char * const wk_path_light[] = { "sensors", "light", NULL };
+static const char * const wk_path_x[] = { "x", NULL };
+static const char * const wk_path_long[] = { "long", "path", "segment", NULL };
+static const char * const wk_attrs_a_b[] = { "ct=0", "rt=\"temp\"", NULL };
+static const char * const wk_attrs_light[] = { "obs", NULL };
+static const char * const wk_attrs_long[] = { "if=sensor", NULL };
+static struct coap_core_metadata wk_meta_a_b = { .attributes = wk_attrs_a_b };
+static struct coap_core_metadata wk_meta_light = {
+	.attributes = wk_attrs_light
+};
+static struct coap_core_metadata wk_meta_long = {
+	.attributes = wk_attrs_long
+};
+
+static struct coap_resource wk_resources[] = {
+	{ .get = coap_well_known_core_get,
+	  .path = COAP_WELL_KNOWN_CORE_PATH,
+	},
+	{ .path = wk_path_a_b, .user_data = &wk_meta_a_b },
+	{ .path = wk_path_light, .user_data = &wk_meta_light },
+	{ .path = wk_path_x },
+	{ .path = wk_path_long, .user_data = &wk_meta_long },
+	{ },
+};
+
+static const char wk_links[] =
+	"</a/b>;ct=0;rt=\"temp\",</sensors/light>;obs,</x>,"
+	"</long/path/segment>;if=sensor";
+
+/* Get the block num of .well-known/core, or all of it without block-wise
+ * transfers, and check its payload.
+ */
+static int well_known_core_check(int num, bool *more)
+{
+	static uint8_t rsp_data[COAP_BUF_SIZE];
+	struct coap_packet response;
+	struct coap_packet request;
+	uint8_t data[COAP_BUF_SIZE];
+	const uint8_t *payload;
+	size_t offset = 0;
+	size_t len = sizeof(wk_links) - 1;
+	uint16_t payload_len;
+	int block2;
+	int r;
+#if defined(CONFIG_COAP_WELL_KNOWN_BLOCK_WISE)
+	enum coap_block_size block_size = COAP_BLOCK_16;
+	struct coap_block_context ctx;
+#endif
+
+	r = coap_packet_init(&request, data, sizeof(data), 1, COAP_TYPE_CON,
+			     0, NULL, COAP_METHOD_GET, coap_next_id());
+	if (r < 0) {
+		return r;
+	}
+
+#if defined(CONFIG_COAP_WELL_KNOWN_BLOCK_WISE)
+	while (coap_block_size_to_bytes(block_size) <
+	       CONFIG_COAP_WELL_KNOWN_BLOCK_WISE_SIZE) {
+		block_size++;
+	}
+
+	coap_block_transfer_init(&ctx, block_size, 0);
+	ctx.current = num * coap_block_size_to_bytes(ctx.block_size);
+
+	r = coap_append_block2_option(&request, &ctx);
+	if (r < 0) {
+		return r;
+	}
+
+	offset = MIN(ctx.current, len);
+	len = MIN(len - offset, coap_block_size_to_bytes(ctx.block_size));
+#endif
+
+	r = coap_well_known_core_get(&wk_resources[0], &request, &response,
+				     rsp_data, sizeof(rsp_data));
+	if (r < 0) {
+		TC_PRINT("Could not get block %d (%d)\n", num, r);
+		return r;
+	}
+
+	r = coap_packet_parse(&response, rsp_data, response.offset, NULL, 0);
+	if (r < 0) {
+		return r;
+	}
+
+	payload = coap_packet_get_payload(&response, &payload_len);
+	if (payload_len != len ||
+	    memcmp(payload, &wk_links[offset], len) != 0) {
+		TC_PRINT("Wrong payload for block %d: %.*s\n", num,
+			 payload_len, payload ? (const char *)payload : "");
+		return -EINVAL;
+	}
+
+	block2 = coap_get_option_int(&response, COAP_OPTION_BLOCK2);
+	*more = block2 > 0 && (block2 & 0x08);
+
+	if (*more != (offset + len < sizeof(wk_links) - 1)) {
+		TC_PRINT("Wrong more flag for block %d\n", num);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int test_well_known_core(void)
+{
+	struct coap_resource_index index;
+	int result = TC_FAIL;
+	bool more;
+	int num;
+
+	/* Reset the cached link lengths */
+	if (coap_resource_index_init(&index, wk_resources) < 0) {
+		TC_PRINT("Could not build the index\n");
+		goto out;
+	}
+
+	/* A later block first, the resources before it are skipped with
+	 * their link lengths not cached yet, then all the blocks with them
+	 * cached.
+	 */
+	num = IS_ENABLED(CONFIG_COAP_WELL_KNOWN_BLOCK_WISE) ? 1 : 0;
+
+	do {
+		if (well_known_core_check(num++, &more) < 0) {
+			goto out;
+		}
+	} while (more);
+
+	num = 0;
+
+	do {
+		if (well_known_core_check(num++, &more) < 0) {
+			goto out;
+		}
+	} while (more);
+
+	result = TC_PASS;
+
+out:
+	TC_END_RESULT(result);
+
+	return result;
+}
+
+#if defined(CONFIG_COAP_NET_BUF)
+/* Small fragments so that the options and payload span several of them */
+NET_BUF_POOL_DEFINE(coap_frags, 24, 8, 0, NULL);
+
+static int test_net_buf_chain(void)
+{
+	static const char segment[] = "a-long-path-segment";
+	static uint8_t block[] = "zero copy block";
+	uint8_t token[] = { 0x01, 0x02, 0x03, 0x04 };
+	uint8_t data[COAP_BUF_SIZE];
+	uint8_t linear[COAP_BUF_SIZE];
+	uint8_t value[sizeof(segment)];
+	uint8_t tkl[COAP_TOKEN_MAX_LEN];
+	struct coap_buf_packet cpkt, parsed;
+	struct coap_buf_option options[2];
+	struct coap_packet flat;
+	struct net_buf *buf, *frag, *payload;
+	struct iovec iov[24];
+	uint16_t offset, len;
+	int result = TC_FAIL;
+	int r;
+
+	buf = net_buf_alloc(&coap_frags, K_NO_WAIT);
+	if (!buf) {
+		TC_PRINT("Could not allocate a fragment\n");
+		goto out;
+	}
+
+	r = coap_buf_packet_init(&cpkt, buf, K_NO_WAIT, 1, COAP_TYPE_CON,
+				 sizeof(token), token, COAP_METHOD_GET, 0x1234);
+	r |= coap_buf_packet_append_option(&cpkt, COAP_OPTION_URI_PATH,
+					   (const uint8_t *)segment,
+					   strlen(segment));
+	r |= coap_buf_append_option_int(&cpkt, COAP_OPTION_CONTENT_FORMAT, 42);
+	r |= coap_buf_append_option_int(&cpkt, COAP_OPTION_BLOCK2, 0x1234);
+	r |= coap_buf_packet_append_payload_marker(&cpkt);
+	r |= coap_buf_packet_append_payload(&cpkt, (const uint8_t *)"x", 1);
+	if (r) {
+		TC_PRINT("Could not build the packet\n");
+		goto done;
+	}
+
+	/* An overflowing length must leave the payload length untouched */
+	r = coap_buf_packet_append_payload(&cpkt, block, UINT16_MAX);
+	if (r != -EINVAL) {
+		TC_PRINT("Appended an overflowing payload\n");
+		goto done;
+	}
+
+	frag = net_buf_alloc_with_data(&coap_frags, block, sizeof(block) - 1,
+				       K_NO_WAIT);
+	if (!frag ||
+	    coap_buf_packet_append_payload_frag(&cpkt, frag) < 0) {
+		TC_PRINT("Could not attach the payload\n");
+		goto done;
+	}
+
+	r = coap_buf_packet_append_payload(&cpkt, (const uint8_t *)"y", 1);
+	if (r != -EINVAL) {
+		TC_PRINT("Appended after a referenced fragment\n");
+		goto done;
+	}
+
+	/* The same packet built in a flat buffer must be identical */
+	r = coap_packet_init(&flat, data, sizeof(data), 1, COAP_TYPE_CON,
+			     sizeof(token), token, COAP_METHOD_GET, 0x1234);
+	r |= coap_packet_append_option(&flat, COAP_OPTION_URI_PATH,
+				       (const uint8_t *)segment,
+				       strlen(segment));
+	r |= coap_append_option_int(&flat, COAP_OPTION_CONTENT_FORMAT, 42);
+	r |= coap_append_option_int(&flat, COAP_OPTION_BLOCK2, 0x1234);
+	r |= coap_packet_append_payload_marker(&flat);
+	r |= coap_packet_append_payload(&flat, (const uint8_t *)"x", 1);
+	r |= coap_packet_append_payload(&flat, block, sizeof(block) - 1);
+	if (r) {
+		TC_PRINT("Could not build the flat packet\n");
+		goto done;
+	}
+
+	if (coap_buf_packet_len(&cpkt) != flat.offset ||
+	    net_buf_frags_len(buf) != flat.offset ||
+	    net_buf_linearize(linear, sizeof(linear), buf, 0,
+			      flat.offset) != flat.offset ||
+	    memcmp(linear, data, flat.offset)) {
+		TC_PRINT("Packets differ\n");
+		goto done;
+	}
+
+	r = coap_buf_packet_to_iovec(&cpkt, iov, ARRAY_SIZE(iov));
+	if (r <= 0 || iov[r - 1].iov_base != block) {
+		TC_PRINT("Payload was copied\n");
+		goto done;
+	}
+
+	if (coap_buf_packet_parse(&parsed, buf) < 0) {
+		TC_PRINT("Could not parse the packet\n");
+		goto done;
+	}
+
+	if (coap_buf_header_get_code(&parsed) != COAP_METHOD_GET ||
+	    coap_buf_header_get_id(&parsed) != 0x1234 ||
+	    coap_buf_header_get_type(&parsed) != COAP_TYPE_CON ||
+	    coap_buf_header_get_token(&parsed, tkl) != sizeof(token) ||
+	    memcmp(tkl, token, sizeof(token))) {
+		TC_PRINT("Invalid header\n");
+		goto done;
+	}
+
+	r = coap_buf_find_options(&parsed, COAP_OPTION_URI_PATH, options,
+				  ARRAY_SIZE(options));
+	if (r != 1 || options[0].len != strlen(segment) ||
+	    coap_buf_option_read(&options[0], value, sizeof(value)) !=
+	    strlen(segment) || memcmp(value, segment, strlen(segment))) {
+		TC_PRINT("Invalid URI path option\n");
+		goto done;
+	}
+
+	if (coap_buf_get_option_int(&parsed,
+				    COAP_OPTION_CONTENT_FORMAT) != 42 ||
+	    coap_buf_get_option_int(&parsed, COAP_OPTION_BLOCK2) != 0x1234 ||
+	    coap_buf_get_option_int(&parsed,
+				    COAP_OPTION_OBSERVE) != -ENOENT) {
+		TC_PRINT("Invalid integer options\n");
+		goto done;
+	}
+
+	payload = coap_buf_packet_get_payload(&parsed, &offset, &len);
+	if (!payload || len != 1 + sizeof(block) - 1 ||
+	    net_buf_linearize(linear, sizeof(linear), payload, offset,
+			      len) != len ||
+	    linear[0] != 'x' || memcmp(&linear[1], block, sizeof(block) - 1)) {
+		TC_PRINT("Invalid payload\n");
+		goto done;
+	}
+
+	result = TC_PASS;
+
+done:
+	net_buf_unref(buf);
+
+out:
+	TC_END_RESULT(result);
+
+	return result;
+}
+#endif
+
+#if defined(CONFIG_COAP_OBSERVE_ENGINE)
+#define ENGINE_INTERVAL_MS 100
+
+static struct coap_resource engine_resources[] = {
+	{ .path = server_resource_1_path },
+	{ },
+};
+
+static struct coap_observer engine_observers[NUM_OBSERVERS];
+
+static struct {
+	struct coap_observer *observer;
+	uint8_t type;
+	uint16_t id;
+	int seq;
+} engine_sent[NUM_OBSERVERS];
+
+static int engine_sent_count;
+static bool engine_error;
+
+static int engine_encode(struct coap_resource *resource,
+			 struct coap_packet *cpkt, void *user_data)
+{
+	static const uint8_t payload[] = "22.5";
+	int r;
+
+	r = coap_append_option_int(cpkt, COAP_OPTION_CONTENT_FORMAT, 0);
+	if (r < 0) {
+		return r;
+	}
+
+	r = coap_packet_append_payload_marker(cpkt);
+	if (r < 0) {
+		return r;
+	}
+
+	return coap_packet_append_payload(cpkt, payload, sizeof(payload) - 1);
+}
+
+static int engine_send(struct coap_observer *observer,
+		       const struct msghdr *msg, void *user_data)
+{
+	uint8_t data[COAP_BUF_SIZE];
+	struct coap_packet cpkt;
+	uint8_t token[8];
+	uint16_t len = 0U;
+	size_t i;
+
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		memcpy(data + len, msg->msg_iov[i].iov_base,
+		       msg->msg_iov[i].iov_len);
+		len += msg->msg_iov[i].iov_len;
+	}
+
+	if (engine_sent_count == ARRAY_SIZE(engine_sent) ||
+	    msg->msg_name != &observer->addr ||
+	    coap_packet_parse(&cpkt, data, len, NULL, 0) < 0 ||
+	    coap_header_get_token(&cpkt, token) != observer->tkl ||
+	    memcmp(token, observer->token, observer->tkl)) {
+		engine_error = true;
+		return -EINVAL;
+	}
+
+	engine_sent[engine_sent_count].observer = observer;
+	engine_sent[engine_sent_count].type = coap_header_get_type(&cpkt);
+	engine_sent[engine_sent_count].id = coap_header_get_id(&cpkt);
+	engine_sent[engine_sent_count].seq =
+		coap_get_option_int(&cpkt, COAP_OPTION_OBSERVE);
+	engine_sent_count++;
+
+	return len;
+}
+
+/* Checks that every observer in the list got the current state */
+static bool engine_check_sent(int count, uint8_t type)
+{
+	int i;
+
+	if (engine_error || engine_sent_count != count) {
+		return false;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (engine_sent[i].type != type ||
+		    engine_sent[i].seq != engine_resources[0].age ||
+		    (i > 0 && engine_sent[i].id == engine_sent[i - 1].id)) {
+			return false;
+		}
+	}
+
+	engine_sent_count = 0;
+
+	return true;
+}
+
+static struct coap_observer *engine_response(
+	struct coap_observe_engine *engine, int observer, uint8_t type)
+{
+	struct coap_observer *o = &engine_observers[observer];
+	struct coap_packet response;
+	uint8_t data[COAP_BUF_SIZE];
+	int r;
+
+	r = coap_packet_init(&response, data, sizeof(data), 1, type, 0, NULL,
+			     COAP_CODE_EMPTY, o->id);
+	if (r < 0) {
+		return NULL;
+	}
+
+	return coap_observe_engine_response(engine, &response, &o->addr);
+}
+
+static int test_observe_engine(void)
+{
+	static uint8_t buf[COAP_BUF_SIZE];
+	struct coap_observe_engine engine;
+	struct coap_observer *o;
+	int result = TC_FAIL;
+	int32_t r;
+	int i;
+
+	r = coap_observe_engine_init(&engine, engine_resources, buf,
+				     sizeof(buf), engine_encode, engine_send,
+				     NULL);
+	if (r < 0) {
+		TC_PRINT("Could not initialize the engine\n");
+		goto done;
+	}
+
+	engine.min_interval_ms = ENGINE_INTERVAL_MS;
+
+	for (i = 0; i < NUM_OBSERVERS; i++) {
+		struct sockaddr_in6 addr = dummy_addr;
+
+		addr.sin6_port = htons(MY_PORT + i);
+
+		o = coap_observer_next_unused(engine_observers, NUM_OBSERVERS);
+		memcpy(&o->addr, &addr, sizeof(addr));
+		o->token[0] = i;
+		o->tkl = 1U;
+
+		coap_register_observer(&engine_resources[0], o);
+	}
+
+	/* Updates right after the registration are held back */
+	coap_observe_engine_notify(&engine, &engine_resources[0]);
+	coap_observe_engine_notify(&engine, &engine_resources[0]);
+	coap_observe_engine_notify(&engine, &engine_resources[0]);
+
+	r = coap_observe_engine_process(&engine);
+	if (r <= 0 || r > ENGINE_INTERVAL_MS || engine_sent_count) {
+		TC_PRINT("Notifications were not rate limited\n");
+		goto done;
+	}
+
+	/* Then the updates are coalesced into one notification each */
+	k_sleep(K_MSEC(r));
+
+	r = coap_observe_engine_process(&engine);
+	if (r != SYS_FOREVER_MS ||
+	    !engine_check_sent(NUM_OBSERVERS, COAP_TYPE_NON_CON)) {
+		TC_PRINT("Invalid non-confirmable notifications\n");
+		goto done;
+	}
+
+	/* Every notification is confirmable with a zero interval, and a
+	 * new update waits for the outstanding one to be acknowledged.
+	 */
+	engine.con_interval_ms = 0U;
+
+	k_sleep(K_MSEC(ENGINE_INTERVAL_MS));
+	coap_observe_engine_notify(&engine, &engine_resources[0]);
+
+	r = coap_observe_engine_process(&engine);
+	if (r <= 0 || !engine_check_sent(NUM_OBSERVERS, COAP_TYPE_CON)) {
+		TC_PRINT("Invalid confirmable notifications\n");
+		goto done;
+	}
+
+	k_sleep(K_MSEC(ENGINE_INTERVAL_MS));
+	coap_observe_engine_notify(&engine, &engine_resources[0]);
+
+	coap_observe_engine_process(&engine);
+	if (!engine_check_sent(0, COAP_TYPE_CON)) {
+		TC_PRINT("Sent while a confirmable notification is out\n");
+		goto done;
+	}
+
+	if (engine_response(&engine, 0, COAP_TYPE_ACK) !=
+	    &engine_observers[0]) {
+		TC_PRINT("ACK not matched\n");
+		goto done;
+	}
+
+	coap_observe_engine_process(&engine);
+	if (!engine_check_sent(1, COAP_TYPE_CON) ||
+	    engine_sent[0].observer != &engine_observers[0]) {
+		TC_PRINT("Acknowledged observer not notified\n");
+		goto done;
+	}
+
+	/* A reset removes the observer */
+	if (engine_response(&engine, 1, COAP_TYPE_RESET) !=
+	    &engine_observers[1] ||
+	    sys_slist_find_and_remove(&engine_resources[0].observers,
+				      &engine_observers[1].list) ||
+	    coap_observer_next_unused(engine_observers, NUM_OBSERVERS) !=
+	    &engine_observers[1]) {
+		TC_PRINT("Observer not removed\n");
+		goto done;
+	}
+
+	result = TC_PASS;
+
+done:
+	TC_END_RESULT(result);
+
+	return result;
+}
+#endif
+
 static const struct {
 	const char *name;
 	int (*func)(void);
@@ -1477,6 +2095,14 @@ static const struct {
 	{ "Test retransmission", test_retransmit_second_round, },
 	{ "Test observer server", test_observer_server, },
 	{ "Test observer client", test_observer_client, },
+	{ "Test resource index", test_resource_index, },
+	{ "Test .well-known/core", test_well_known_core, },
+#if defined(CONFIG_COAP_NET_BUF)
+	{ "Test net_buf chain", test_net_buf_chain, },
+#endif
+#if defined(CONFIG_COAP_OBSERVE_ENGINE)
+	{ "Test observe engine", test_observe_engine, },
+#endif
 };
 
 void main(void)
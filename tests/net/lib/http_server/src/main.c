@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <net/socket.h>
+#include <net/http_server.h>
+
+/* The server and the client run in the same thread over the loopback
+ * interface: the test sends a request, then polls the server until the
+ * expected response is received.
+ */
+
+#define SERVER_PORT 8080
+#define BUFFER_SIZE 256
+#define POLL_ROUNDS 10
+
+#define HELLO_RESPONSE \
+	"HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\n" \
+	"Content-Length: 5\r\n\r\nhello"
+
+static struct http_server_ctx server;
+static int client = -1;
+static size_t echo_len;
+
+static int hello_cb(struct http_server_conn *conn, enum http_server_event evt,
+		    const uint8_t *data, size_t len, void *user_data)
+{
+	if (evt == HTTP_SERVER_REQ_END) {
+		return http_server_response(conn, 200, "text/plain",
+					    "hello", 5);
+	}
+
+	return 0;
+}
+
+static int echo_cb(struct http_server_conn *conn, enum http_server_event evt,
+		   const uint8_t *data, size_t len, void *user_data)
+{
+	switch (evt) {
+	case HTTP_SERVER_REQ_HEADERS:
+		echo_len = 0;
+		return http_server_response_begin(conn, 200, NULL,
+						  HTTP_SERVER_CHUNKED);
+	case HTTP_SERVER_REQ_BODY:
+		echo_len += len;
+		return http_server_response_send(conn, data, len);
+	default:
+		return 0;
+	}
+}
+
+/* Longer than the response header buffer of the server */
+#define LONG_CONTENT_TYPE \
+	"application/vnd.test.a-content-type-name-that-goes-on-and-on" \
+	"-and-on-and-on-and-on-and-on-and-on-and-on-and-on-and-on-and-on" \
+	"-and-on-and-on-and-on-and-on-and-on-and-on-and-on-and-on+json"
+
+static int long_ret;
+
+static int long_cb(struct http_server_conn *conn, enum http_server_event evt,
+		   const uint8_t *data, size_t len, void *user_data)
+{
+	if (evt == HTTP_SERVER_REQ_END) {
+		long_ret = http_server_response(conn, 200, LONG_CONTENT_TYPE,
+						"hello", 5);
+		return long_ret;
+	}
+
+	return 0;
+}
+
+static const struct http_resource resources[] = {
+	{
+		.path = "/hello",
+		.methods = HTTP_METHOD_BIT(HTTP_GET) |
+			   HTTP_METHOD_BIT(HTTP_HEAD),
+		.cb = hello_cb,
+	},
+	{
+		.path = "/echo/*",
+		.methods = HTTP_METHOD_BIT(HTTP_POST),
+		.cb = echo_cb,
+	},
+	{
+		.path = "/long",
+		.methods = HTTP_METHOD_BIT(HTTP_GET),
+		.cb = long_cb,
+	},
+};
+
+static void client_send(const char *request)
+{
+	size_t len = strlen(request);
+
+	zassert_equal(zsock_send(client, request, len, 0), len,
+		      "send failed");
+}
+
+/* Serve until the expected response is received, then check for more. */
+static void client_expect(const char *response)
+{
+	uint8_t buf[BUFFER_SIZE];
+	size_t expected = strlen(response);
+	size_t received = 0;
+	ssize_t ret;
+	int i;
+
+	for (i = 0; i < POLL_ROUNDS && received < expected; i++) {
+		zassert_equal(http_server_poll(&server, 100), 0, "poll failed");
+
+		ret = zsock_recv(client, buf + received, sizeof(buf) - received,
+				 ZSOCK_MSG_DONTWAIT);
+		if (ret > 0) {
+			received += ret;
+		}
+	}
+
+	zassert_equal(received, expected, "expected %zu bytes, got %zu",
+		      expected, received);
+	zassert_mem_equal(buf, response, expected, "unexpected response");
+}
+
+static void client_expect_close(void)
+{
+	uint8_t buf[1];
+	ssize_t ret = -1;
+	int i;
+
+	for (i = 0; i < POLL_ROUNDS && ret != 0; i++) {
+		zassert_equal(http_server_poll(&server, 100), 0, "poll failed");
+		ret = zsock_recv(client, buf, sizeof(buf), ZSOCK_MSG_DONTWAIT);
+	}
+
+	zassert_equal(ret, 0, "connection not closed");
+}
+
+static void client_setup(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+		.sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+	};
+
+	client = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(client >= 0, "socket failed");
+	zassert_equal(zsock_connect(client, (struct sockaddr *)&addr,
+				    sizeof(addr)), 0, "connect failed");
+}
+
+static void client_teardown(void)
+{
+	int i;
+
+	zsock_close(client);
+
+	/* Let the server close its side. */
+	for (i = 0; i < 2; i++) {
+		(void)http_server_poll(&server, 10);
+	}
+}
+
+static void test_keep_alive(void)
+{
+	client_send("GET /hello HTTP/1.1\r\nHost: test\r\n\r\n");
+	client_expect(HELLO_RESPONSE);
+
+	client_send("GET /hello?x=1 HTTP/1.1\r\nHost: test\r\n\r\n");
+	client_expect(HELLO_RESPONSE);
+}
+
+static void test_pipelining(void)
+{
+	client_send("GET /hello HTTP/1.1\r\n\r\n"
+		    "HEAD /hello HTTP/1.1\r\n\r\n"
+		    "GET /hello HTTP/1.1\r\n\r\n");
+	client_expect(HELLO_RESPONSE
+		      "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\n"
+		      "Content-Length: 5\r\n\r\n"
+		      HELLO_RESPONSE);
+}
+
+static void test_chunked(void)
+{
+	client_send("POST /echo/x HTTP/1.1\r\n"
+		    "Transfer-Encoding: chunked\r\n\r\n"
+		    "5\r\nhello\r\n6\r\n world\r\n0\r\n\r\n");
+	client_expect("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+		      "5\r\nhello\r\n6\r\n world\r\n0\r\n\r\n");
+	zassert_equal(echo_len, 11, "wrong body length");
+}
+
+static void test_content_length_body(void)
+{
+	client_send("POST /echo/ HTTP/1.1\r\nContent-Length: 4\r\n\r\n"
+		    "data");
+	client_expect("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+		      "4\r\ndata\r\n0\r\n\r\n");
+}
+
+static void test_errors(void)
+{
+	client_send("GET /missing HTTP/1.1\r\n\r\n");
+	client_expect("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+
+	/* The body of a refused request is skipped. */
+	client_send("PUT /hello HTTP/1.1\r\nContent-Length: 3\r\n\r\nabc");
+	client_expect("HTTP/1.1 405 Method Not Allowed\r\n"
+		      "Content-Length: 0\r\n\r\n");
+
+	client_send("GET /hello/this/url/is/longer/than/the/maximum/url/length"
+		    "/of/the/server HTTP/1.1\r\n\r\n");
+	client_expect("HTTP/1.1 414 URI Too Long\r\nContent-Length: 0\r\n\r\n");
+}
+
+static void test_http_1_0(void)
+{
+	client_send("GET /hello HTTP/1.0\r\n\r\n");
+	client_expect("HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\n"
+		      "Content-Length: 5\r\nConnection: close\r\n\r\nhello");
+	client_expect_close();
+}
+
+static void test_http_1_0_unknown_length(void)
+{
+	client_send("POST /echo/ HTTP/1.0\r\nContent-Length: 2\r\n"
+		    "Connection: keep-alive\r\n\r\nhi");
+	client_expect("HTTP/1.1 200 OK\r\nConnection: close\r\n\r\nhi");
+	client_expect_close();
+}
+
+static void test_bad_request(void)
+{
+	client_send("GET /hello HTTP/1.1\r\nBad Header\r\n\r\n");
+	client_expect("HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n"
+		      "Connection: close\r\n\r\n");
+	client_expect_close();
+}
+
+static void test_header_too_long(void)
+{
+	client_send("GET /long HTTP/1.1\r\n\r\n");
+	client_expect_close();
+	zassert_equal(long_ret, -ENOMEM, "long header not refused");
+}
+
+static void test_init(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	int ret;
+
+	ret = http_server_init(&server, (struct sockaddr *)&addr, sizeof(addr),
+			       resources, ARRAY_SIZE(resources));
+	zassert_equal(ret, 0, "server init failed");
+}
+
+static void test_close(void)
+{
+	http_server_close(&server);
+	zassert_equal(server.listen_sock, -1, "not closed");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(http_server,
+		ztest_unit_test(test_init),
+		ztest_unit_test_setup_teardown(test_keep_alive,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_pipelining,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_chunked,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_content_length_body,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_errors,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_http_1_0,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_http_1_0_unknown_length,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_bad_request,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_header_too_long,
+					       client_setup, client_teardown),
+		ztest_unit_test(test_close));
+
+	ztest_run_test_suite(http_server);
+}
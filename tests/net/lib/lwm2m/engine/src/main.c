@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <net/lwm2m.h>
+
+#include "lwm2m_object.h"
+#include "lwm2m_engine.h"
+
+/* A test object with an integer and a string resource per instance */
+#define TEST_OBJ_ID	32770
+#define TEST_S32_ID	0
+#define TEST_STRING_ID	1
+#define TEST_MAX_ID	2
+
+#define MAX_INSTANCES	4
+
+/* Instance ids spread over the id space, net.lwm2m.engine.one_bucket
+ * puts them all in the same index bucket.
+ */
+static const uint16_t inst_ids[MAX_INSTANCES] = { 0, 7, 300, 65534 };
+
+static struct {
+	int32_t s32;
+	char string[8];
+} data[MAX_INSTANCES];
+
+static struct lwm2m_engine_obj test_obj;
+static struct lwm2m_engine_obj_field fields[] = {
+	OBJ_FIELD_DATA(TEST_S32_ID, RW, S32),
+	OBJ_FIELD_DATA(TEST_STRING_ID, RW, STRING),
+};
+
+static struct lwm2m_engine_obj_inst inst[MAX_INSTANCES];
+static struct lwm2m_engine_res res[MAX_INSTANCES][TEST_MAX_ID];
+static struct lwm2m_engine_res_inst res_inst[MAX_INSTANCES][TEST_MAX_ID];
+
+static struct lwm2m_engine_obj_inst *test_obj_create(uint16_t obj_inst_id)
+{
+	int index, i = 0, j = 0;
+
+	for (index = 0; index < MAX_INSTANCES; index++) {
+		if (inst[index].obj && inst[index].obj_inst_id == obj_inst_id) {
+			return NULL;
+		}
+	}
+
+	for (index = 0; index < MAX_INSTANCES; index++) {
+		if (!inst[index].obj) {
+			break;
+		}
+	}
+
+	if (index == MAX_INSTANCES) {
+		return NULL;
+	}
+
+	init_res_instance(res_inst[index], ARRAY_SIZE(res_inst[index]));
+
+	INIT_OBJ_RES_DATA(TEST_S32_ID, res[index], i, res_inst[index], j,
+			  &data[index].s32, sizeof(data[index].s32));
+	INIT_OBJ_RES_DATA(TEST_STRING_ID, res[index], i, res_inst[index], j,
+			  data[index].string, sizeof(data[index].string));
+
+	inst[index].resources = res[index];
+	inst[index].resource_count = i;
+
+	return &inst[index];
+}
+
+static void s32_path(char *path, size_t len, uint16_t obj_inst_id)
+{
+	snprintk(path, len, "%u/%u/%u", TEST_OBJ_ID, obj_inst_id,
+		 TEST_S32_ID);
+}
+
+static void test_init(void)
+{
+	struct lwm2m_engine_obj_inst *obj_inst;
+	int i;
+
+	test_obj.obj_id = TEST_OBJ_ID;
+	test_obj.fields = fields;
+	test_obj.field_count = ARRAY_SIZE(fields);
+	test_obj.max_instance_count = MAX_INSTANCES;
+	test_obj.create_cb = test_obj_create;
+	lwm2m_register_obj(&test_obj);
+
+	for (i = 0; i < MAX_INSTANCES; i++) {
+		zassert_equal(lwm2m_create_obj_inst(TEST_OBJ_ID, inst_ids[i],
+						    &obj_inst), 0,
+			      "Could not create instance %u", inst_ids[i]);
+	}
+}
+
+static void test_obj_inst_index(void)
+{
+	struct lwm2m_engine_obj_inst *obj_inst;
+	char path[32];
+	int32_t value;
+	int i;
+
+	for (i = 0; i < MAX_INSTANCES; i++) {
+		s32_path(path, sizeof(path), inst_ids[i]);
+		zassert_equal(lwm2m_engine_set_s32(path, inst_ids[i]), 0,
+			      "Instance %u not found", inst_ids[i]);
+	}
+
+	for (i = 0; i < MAX_INSTANCES; i++) {
+		s32_path(path, sizeof(path), inst_ids[i]);
+		zassert_equal(lwm2m_engine_get_s32(path, &value), 0, NULL);
+		zassert_equal(value, inst_ids[i], "Wrong instance %u",
+			      inst_ids[i]);
+	}
+
+	s32_path(path, sizeof(path), 8);
+	zassert_equal(lwm2m_engine_get_s32(path, &value), -ENOENT,
+		      "Found a missing instance");
+
+	/* the other instances of the bucket stay reachable */
+	zassert_equal(lwm2m_delete_obj_inst(TEST_OBJ_ID, inst_ids[1]), 0,
+		      NULL);
+
+	for (i = 0; i < MAX_INSTANCES; i++) {
+		s32_path(path, sizeof(path), inst_ids[i]);
+		zassert_equal(lwm2m_engine_get_s32(path, &value),
+			      i == 1 ? -ENOENT : 0, "Wrong lookup of %u",
+			      inst_ids[i]);
+	}
+
+	zassert_equal(lwm2m_create_obj_inst(TEST_OBJ_ID, inst_ids[1],
+					    &obj_inst), 0, NULL);
+	zassert_equal(lwm2m_create_obj_inst(TEST_OBJ_ID, inst_ids[1],
+					    &obj_inst), -ENOMEM,
+		      "Created a fifth instance");
+
+	s32_path(path, sizeof(path), inst_ids[1]);
+	zassert_equal(lwm2m_engine_get_s32(path, &value), 0,
+		      "Recreated instance not found");
+}
+
+static void test_res_handle(void)
+{
+	struct lwm2m_res_handle s32_handle, string_handle;
+	char string[sizeof(data[0].string)];
+	int32_t value;
+
+	zassert_equal(lwm2m_engine_get_res_handle("32770/300/0", &s32_handle),
+		      0, NULL);
+	zassert_equal(lwm2m_engine_get_res_handle("32770/300/1",
+						  &string_handle), 0, NULL);
+
+	zassert_equal(lwm2m_engine_handle_set_s32(&s32_handle, -42), 0, NULL);
+	zassert_equal(lwm2m_engine_get_s32("32770/300/0", &value), 0, NULL);
+	zassert_equal(value, -42, "Handle wrote the wrong resource");
+
+	zassert_equal(lwm2m_engine_set_s32("32770/300/0", 42), 0, NULL);
+	zassert_equal(lwm2m_engine_handle_get_s32(&s32_handle, &value), 0,
+		      NULL);
+	zassert_equal(value, 42, "Handle read the wrong resource");
+
+	zassert_equal(lwm2m_engine_handle_set_string(&string_handle, "abc"),
+		      0, NULL);
+	zassert_equal(lwm2m_engine_handle_get_string(&string_handle, string,
+						     sizeof(string)), 0, NULL);
+	zassert_true(strcmp(string, "abc") == 0, "Wrong string");
+}
+
+static void test_res_handle_errors(void)
+{
+	struct lwm2m_res_handle handle;
+	int32_t value;
+
+	zassert_equal(lwm2m_engine_get_res_handle("32770/300", &handle),
+		      -EINVAL, "Accepted an instance path");
+	zassert_equal(lwm2m_engine_get_res_handle("32770/8/0", &handle),
+		      -ENOENT, "Found a missing instance");
+	zassert_equal(lwm2m_engine_get_res_handle("32770/300/5", &handle),
+		      -ENOENT, "Found a missing resource");
+
+	/* the resource exists, its instance 3 does not */
+	(void)memset(&handle, 0xa5, sizeof(handle));
+	zassert_equal(lwm2m_engine_get_res_handle("32770/300/0/3", &handle),
+		      -ENOENT, "Found a missing resource instance");
+	zassert_equal(lwm2m_engine_handle_set_s32(&handle, 1), -EINVAL,
+		      "Used a failed handle");
+
+	zassert_equal(lwm2m_engine_set_s32("32770/300/0/3", 1), -ENOENT,
+		      "Wrote a missing resource instance");
+	zassert_equal(lwm2m_engine_get_s32("32770/300/0/3", &value),
+		      -ENOENT, "Read a missing resource instance");
+}
+
+static void test_res_handle_stale(void)
+{
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_res_handle handle;
+	int32_t value;
+
+	zassert_equal(lwm2m_engine_get_res_handle("32770/65534/0", &handle),
+		      0, NULL);
+	zassert_equal(lwm2m_delete_obj_inst(TEST_OBJ_ID, 65534), 0, NULL);
+
+	zassert_equal(lwm2m_engine_handle_set_s32(&handle, 1), -ENOENT,
+		      "Wrote through a stale handle");
+	zassert_equal(lwm2m_engine_handle_get_s32(&handle, &value), -ENOENT,
+		      "Read through a stale handle");
+
+	zassert_equal(lwm2m_create_obj_inst(TEST_OBJ_ID, 65534, &obj_inst), 0,
+		      NULL);
+	zassert_equal(lwm2m_engine_get_res_handle("32770/65534/0", &handle),
+		      0, NULL);
+	zassert_equal(lwm2m_engine_handle_set_s32(&handle, 1), 0, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(lwm2m_engine,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_obj_inst_index),
+			 ztest_unit_test(test_res_handle),
+			 ztest_unit_test(test_res_handle_errors),
+			 ztest_unit_test(test_res_handle_stale));
+
+	ztest_run_test_suite(lwm2m_engine);
+}
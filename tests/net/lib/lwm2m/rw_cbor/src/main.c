@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <net/lwm2m.h>
+
+#include "lwm2m_object.h"
+#include "lwm2m_engine.h"
+#include "lwm2m_rw_cbor.h"
+
+/* A test object with one writable resource of each encoded type */
+#define TEST_OBJ_ID	32769
+#define TEST_STRING_ID	0
+#define TEST_S32_ID	1
+#define TEST_BOOL_ID	2
+#define TEST_FLOAT_ID	3
+#define TEST_MAX_ID	4
+
+#define TEST_STRING	"hello"
+#define TEST_S32	-300
+#define TEST_BOOL	true
+#define TEST_FLOAT	{ 21, 500000 }
+
+static char string_value[16];
+static int32_t s32_value;
+static bool bool_value;
+static float32_value_t float_value;
+
+static struct lwm2m_engine_obj test_obj;
+static struct lwm2m_engine_obj_field fields[] = {
+	OBJ_FIELD_DATA(TEST_STRING_ID, RW, STRING),
+	OBJ_FIELD_DATA(TEST_S32_ID, RW, S32),
+	OBJ_FIELD_DATA(TEST_BOOL_ID, RW, BOOL),
+	OBJ_FIELD_DATA(TEST_FLOAT_ID, RW, FLOAT32),
+};
+
+static struct lwm2m_engine_obj_inst inst;
+static struct lwm2m_engine_res res[TEST_MAX_ID];
+static struct lwm2m_engine_res_inst res_inst[TEST_MAX_ID];
+
+/* Response built by a read, and request holding the data of a write */
+static struct lwm2m_message msg;
+static struct coap_packet in_cpkt;
+static uint8_t in_data[128];
+
+static struct lwm2m_engine_obj_inst *test_obj_create(uint16_t obj_inst_id)
+{
+	int i = 0, j = 0;
+
+	init_res_instance(res_inst, ARRAY_SIZE(res_inst));
+
+	INIT_OBJ_RES_DATA(TEST_STRING_ID, res, i, res_inst, j,
+			  string_value, sizeof(string_value));
+	INIT_OBJ_RES_DATA(TEST_S32_ID, res, i, res_inst, j,
+			  &s32_value, sizeof(s32_value));
+	INIT_OBJ_RES_DATA(TEST_BOOL_ID, res, i, res_inst, j,
+			  &bool_value, sizeof(bool_value));
+	INIT_OBJ_RES_DATA(TEST_FLOAT_ID, res, i, res_inst, j,
+			  &float_value, sizeof(float_value));
+
+	inst.resources = res;
+	inst.resource_count = i;
+
+	return &inst;
+}
+
+static void set_values(void)
+{
+	float32_value_t value = TEST_FLOAT;
+
+	zassert_equal(lwm2m_engine_set_string("32769/0/0", TEST_STRING), 0,
+		      "Could not set the string");
+	zassert_equal(lwm2m_engine_set_s32("32769/0/1", TEST_S32), 0,
+		      "Could not set the integer");
+	zassert_equal(lwm2m_engine_set_bool("32769/0/2", TEST_BOOL), 0,
+		      "Could not set the boolean");
+	zassert_equal(lwm2m_engine_set_float32("32769/0/3", &value), 0,
+		      "Could not set the float");
+}
+
+static void clear_values(void)
+{
+	float32_value_t value = { 0 };
+
+	lwm2m_engine_set_string("32769/0/0", "");
+	lwm2m_engine_set_s32("32769/0/1", 0);
+	lwm2m_engine_set_bool("32769/0/2", false);
+	lwm2m_engine_set_float32("32769/0/3", &value);
+}
+
+static void check_values(void)
+{
+	char string[sizeof(string_value)];
+	float32_value_t value;
+	int32_t s32;
+	bool b;
+
+	zassert_equal(lwm2m_engine_get_string("32769/0/0", string,
+					      sizeof(string)), 0, NULL);
+	zassert_true(strcmp(string, TEST_STRING) == 0, "Wrong string");
+	zassert_equal(lwm2m_engine_get_s32("32769/0/1", &s32), 0, NULL);
+	zassert_equal(s32, TEST_S32, "Wrong integer");
+	zassert_equal(lwm2m_engine_get_bool("32769/0/2", &b), 0, NULL);
+	zassert_equal(b, TEST_BOOL, "Wrong boolean");
+	zassert_equal(lwm2m_engine_get_float32("32769/0/3", &value), 0, NULL);
+	zassert_true(value.val1 == 21 && value.val2 == 500000, "Wrong float");
+}
+
+static void set_path(uint8_t level, uint16_t res_id)
+{
+	(void)memset(&msg.path, 0, sizeof(msg.path));
+	msg.path.obj_id = TEST_OBJ_ID;
+	msg.path.obj_inst_id = 0U;
+	msg.path.res_id = res_id;
+	msg.path.level = level;
+}
+
+/* Reads msg.path into a response of max_len bytes */
+static int read_op(int format, uint16_t max_len)
+{
+	int ret;
+
+	ret = coap_packet_init(&msg.cpkt, msg.msg_data, max_len, 1,
+			       COAP_TYPE_ACK, 0, NULL,
+			       COAP_RESPONSE_CODE_CONTENT, 0);
+	zassert_equal(ret, 0, "Could not init the response");
+
+	msg.out.out_cpkt = &msg.cpkt;
+	msg.out.writer = format == LWM2M_FORMAT_APP_SENML_CBOR ?
+			 &senml_cbor_writer : &lwm2m_cbor_writer;
+
+	return do_read_op_cbor(&msg, format);
+}
+
+static const uint8_t *read_payload(int format, uint16_t *len)
+{
+	static struct coap_packet rsp;
+	const uint8_t *payload;
+
+	zassert_equal(read_op(format, sizeof(msg.msg_data)), 0,
+		      "Read failed");
+	zassert_equal(coap_packet_parse(&rsp, msg.msg_data, msg.cpkt.offset,
+					NULL, 0), 0, "Invalid response");
+
+	payload = coap_packet_get_payload(&rsp, len);
+	zassert_not_null(payload, "No payload");
+
+	return payload;
+}
+
+/* Writes the payload to msg.path as a request would */
+static int write_op(int format, const uint8_t *payload, uint16_t len)
+{
+	int ret;
+
+	ret = coap_packet_init(&in_cpkt, in_data, sizeof(in_data), 1,
+			       COAP_TYPE_CON, 0, NULL, COAP_METHOD_PUT, 0);
+	ret |= coap_append_option_int(&in_cpkt, COAP_OPTION_CONTENT_FORMAT,
+				      format);
+	ret |= coap_packet_append_payload_marker(&in_cpkt);
+	ret |= coap_packet_append_payload(&in_cpkt, (uint8_t *)payload, len);
+	zassert_equal(ret, 0, "Could not build the request");
+
+	ret = coap_packet_parse(&in_cpkt, in_data, in_cpkt.offset, NULL, 0);
+	zassert_equal(ret, 0, "Invalid request");
+
+	msg.in.in_cpkt = &in_cpkt;
+	msg.in.reader = &cbor_reader;
+	msg.in.offset = in_cpkt.hdr_len + in_cpkt.opt_len;
+
+	if (format == LWM2M_FORMAT_APP_SENML_CBOR) {
+		return do_write_op_senml_cbor(&msg);
+	}
+
+	return do_write_op_lwm2m_cbor(&msg);
+}
+
+static void test_init(void)
+{
+	struct lwm2m_engine_obj_inst *obj_inst;
+
+	test_obj.obj_id = TEST_OBJ_ID;
+	test_obj.fields = fields;
+	test_obj.field_count = ARRAY_SIZE(fields);
+	test_obj.max_instance_count = 1U;
+	test_obj.create_cb = test_obj_create;
+	lwm2m_register_obj(&test_obj);
+
+	zassert_equal(lwm2m_create_obj_inst(TEST_OBJ_ID, 0, &obj_inst), 0,
+		      "Could not create the instance");
+}
+
+static void test_senml_encode(void)
+{
+	static const uint8_t s32_payload[] = {
+		0x9f, 0xa3,
+		0x21, 0x69, '/', '3', '2', '7', '6', '9', '/', '0', '/',
+		0x00, 0x61, '1',
+		0x02, 0x39, 0x01, 0x2b,
+		0xff,
+	};
+	static const uint8_t float_payload[] = {
+		0x9f, 0xa3,
+		0x21, 0x69, '/', '3', '2', '7', '6', '9', '/', '0', '/',
+		0x00, 0x61, '3',
+		0x02, 0xfa, 0x41, 0xac, 0x00, 0x00,
+		0xff,
+	};
+	const uint8_t *payload;
+	uint16_t len;
+
+	set_values();
+
+	set_path(3U, TEST_S32_ID);
+	payload = read_payload(LWM2M_FORMAT_APP_SENML_CBOR, &len);
+	zassert_equal(len, sizeof(s32_payload), "Wrong length");
+	zassert_mem_equal(payload, s32_payload, len, "Wrong integer record");
+
+	set_path(3U, TEST_FLOAT_ID);
+	payload = read_payload(LWM2M_FORMAT_APP_SENML_CBOR, &len);
+	zassert_equal(len, sizeof(float_payload), "Wrong length");
+	zassert_mem_equal(payload, float_payload, len, "Wrong float record");
+}
+
+static void test_lwm2m_cbor_encode(void)
+{
+	static const uint8_t string_payload[] = {
+		0xa1,
+		0x82, 0x19, 0x80, 0x01, 0x00,
+		0xbf,
+		0x00, 0x65, 'h', 'e', 'l', 'l', 'o',
+		0xff,
+	};
+	const uint8_t *payload;
+	uint16_t len;
+
+	set_values();
+
+	set_path(3U, TEST_STRING_ID);
+	payload = read_payload(LWM2M_FORMAT_OMA_CBOR, &len);
+	zassert_equal(len, sizeof(string_payload), "Wrong length");
+	zassert_mem_equal(payload, string_payload, len, "Wrong map");
+}
+
+static void round_trip(int format)
+{
+	uint8_t payload[sizeof(msg.msg_data)];
+	const uint8_t *data;
+	uint16_t len;
+
+	set_values();
+
+	set_path(2U, 0U);
+	data = read_payload(format, &len);
+	memcpy(payload, data, len);
+
+	clear_values();
+
+	set_path(2U, 0U);
+	zassert_equal(write_op(format, payload, len), 0, "Write failed");
+
+	check_values();
+}
+
+static void test_senml_round_trip(void)
+{
+	round_trip(LWM2M_FORMAT_APP_SENML_CBOR);
+}
+
+static void test_lwm2m_cbor_round_trip(void)
+{
+	round_trip(LWM2M_FORMAT_OMA_CBOR);
+}
+
+static void test_malformed(void)
+{
+	/* the text string of the name is cut short */
+	static const uint8_t truncated[] = { 0x9f, 0xa2, 0x00, 0x63, '1' };
+	/* the name is not a path */
+	static const uint8_t bad_name[] = {
+		0x9f, 0xa2, 0x00, 0x61, 'x', 0x02, 0x01, 0xff,
+	};
+	/* the root of LwM2M-CBOR must be a map */
+	static const uint8_t not_map[] = { 0x80 };
+	/* more path elements than a resource instance */
+	static const uint8_t too_deep[] = {
+		0xa1, 0x19, 0x80, 0x01,
+		0xa1, 0x00, 0xa1, 0x02, 0xa1, 0x00, 0xa1, 0x00, 0x01,
+	};
+
+	set_path(2U, 0U);
+	zassert_true(write_op(LWM2M_FORMAT_APP_SENML_CBOR, truncated,
+			      sizeof(truncated)) < 0, "Truncated accepted");
+	zassert_true(write_op(LWM2M_FORMAT_APP_SENML_CBOR, bad_name,
+			      sizeof(bad_name)) < 0, "Bad name accepted");
+
+	set_path(1U, 0U);
+	zassert_true(write_op(LWM2M_FORMAT_OMA_CBOR, not_map,
+			      sizeof(not_map)) < 0, "Array accepted");
+	zassert_true(write_op(LWM2M_FORMAT_OMA_CBOR, too_deep,
+			      sizeof(too_deep)) < 0, "Deep path accepted");
+}
+
+static void test_no_space(void)
+{
+	/* header, content-format and marker leave 9 bytes of payload */
+	set_values();
+
+	set_path(3U, TEST_STRING_ID);
+	zassert_equal(read_op(LWM2M_FORMAT_APP_SENML_CBOR, 16), -ENOMEM,
+		      "Truncated payload not reported");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(lwm2m_rw_cbor,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_senml_encode),
+			 ztest_unit_test(test_lwm2m_cbor_encode),
+			 ztest_unit_test(test_senml_round_trip),
+			 ztest_unit_test(test_lwm2m_cbor_round_trip),
+			 ztest_unit_test(test_malformed),
+			 ztest_unit_test(test_no_space));
+
+	ztest_run_test_suite(lwm2m_rw_cbor);
+}
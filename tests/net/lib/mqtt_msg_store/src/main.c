@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <net/socket.h>
+#include <net/mqtt.h>
+
+#include <mqtt_internal.h>
+
+/* The broker side of the connection is the other end of a socket pair. */
+
+#define BUFFER_SIZE 128
+
+#define TOPIC_BYTES 0x00, 0x07, 's', 'e', 'n', 's', 'o', 'r', 's'
+
+static uint8_t rx_buffer[BUFFER_SIZE];
+static uint8_t tx_buffer[BUFFER_SIZE];
+static uint8_t store_buffer[BUFFER_SIZE];
+static struct mqtt_client client;
+static int broker;
+
+static const uint8_t connack[] = { 0x20, 0x02, 0x00, 0x00 };
+static const uint8_t connack_session[] = { 0x20, 0x02, 0x01, 0x00 };
+
+static void broker_send(const uint8_t *data, size_t len)
+{
+	zassert_equal(zsock_send(broker, data, len, 0), len, "send failed");
+	zassert_equal(mqtt_input(&client), 0, "input failed");
+}
+
+static void broker_expect(const uint8_t *data, size_t len)
+{
+	uint8_t buf[BUFFER_SIZE];
+	ssize_t ret;
+
+	ret = zsock_recv(broker, buf, sizeof(buf), ZSOCK_MSG_DONTWAIT);
+	zassert_equal(ret, len, "expected %u bytes, got %d", len, ret);
+	zassert_mem_equal(buf, data, len, "unexpected packet");
+}
+
+static void broker_expect_nothing(void)
+{
+	uint8_t buf[BUFFER_SIZE];
+
+	zassert_equal(zsock_recv(broker, buf, sizeof(buf),
+				 ZSOCK_MSG_DONTWAIT), -1, "unexpected data");
+	zassert_equal(errno, EAGAIN, "unexpected error");
+}
+
+static int publish(uint16_t message_id, enum mqtt_qos qos,
+		   const char *payload)
+{
+	struct mqtt_publish_param param = {
+		.message.topic.topic = MQTT_UTF8_LITERAL("sensors"),
+		.message.topic.qos = qos,
+		.message.payload.data = (uint8_t *)payload,
+		.message.payload.len = strlen(payload),
+		.message_id = message_id,
+	};
+
+	return mqtt_publish(&client, &param);
+}
+
+static void client_setup(void)
+{
+	int sv[2];
+
+	zassert_equal(zsock_socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0,
+		      "socketpair failed");
+
+	mqtt_client_init(&client);
+	client.rx_buf = rx_buffer;
+	client.rx_buf_size = sizeof(rx_buffer);
+	client.tx_buf = tx_buffer;
+	client.tx_buf_size = sizeof(tx_buffer);
+	client.msg_store_buf = store_buffer;
+	client.msg_store_buf_size = sizeof(store_buffer);
+	client.transport.type = MQTT_TRANSPORT_NON_SECURE;
+	client.transport.tcp.sock = sv[0];
+	broker = sv[1];
+
+	/* The CONNECT packet is not needed, start from the CONNACK. */
+	MQTT_SET_STATE(&client, MQTT_STATE_TCP_CONNECTED);
+	broker_send(connack, sizeof(connack));
+	zassert_true(MQTT_HAS_STATE(&client, MQTT_STATE_CONNECTED),
+		     "not connected");
+}
+
+static void client_teardown(void)
+{
+	mqtt_abort(&client);
+	zsock_close(broker);
+}
+
+static void test_puback(void)
+{
+	static const uint8_t expected[] = {
+		0x32, 0x0e, TOPIC_BYTES, 0x00, 0x01, 'a', 'b', 'c'
+	};
+	static const uint8_t puback[] = { 0x40, 0x02, 0x00, 0x01 };
+
+	zassert_equal(publish(1, MQTT_QOS_1_AT_LEAST_ONCE, "abc"), 0,
+		      "publish failed");
+	broker_expect(expected, sizeof(expected));
+	zassert_equal(mqtt_inflight_count(&client), 1, "not stored");
+
+	broker_send(puback, sizeof(puback));
+	zassert_equal(mqtt_inflight_count(&client), 0, "not removed");
+}
+
+static void test_qos0_not_stored(void)
+{
+	zassert_equal(publish(0, MQTT_QOS_0_AT_MOST_ONCE, "abc"), 0,
+		      "publish failed");
+	zassert_equal(mqtt_inflight_count(&client), 0, "QoS 0 stored");
+}
+
+static void test_window_full(void)
+{
+	zassert_equal(publish(1, MQTT_QOS_1_AT_LEAST_ONCE, "a"), 0,
+		      "publish failed");
+	zassert_equal(publish(2, MQTT_QOS_1_AT_LEAST_ONCE, "b"), 0,
+		      "publish failed");
+	zassert_equal(publish(3, MQTT_QOS_1_AT_LEAST_ONCE, "c"), -ENOBUFS,
+		      "window not enforced");
+	zassert_equal(mqtt_inflight_count(&client), 2, "wrong count");
+}
+
+static void test_store_full(void)
+{
+	static const char large[] = "0123456789012345678901234567890123456789"
+				    "0123456789012345678901234567890123456789";
+
+	zassert_equal(publish(1, MQTT_QOS_1_AT_LEAST_ONCE, large), 0,
+		      "publish failed");
+	zassert_equal(publish(2, MQTT_QOS_1_AT_LEAST_ONCE, large), -ENOBUFS,
+		      "store size not enforced");
+}
+
+static void test_resend_session_present(void)
+{
+	static const uint8_t expected[] = {
+		0x32, 0x0c, TOPIC_BYTES, 0x00, 0x01, 'a',
+		0x32, 0x0c, TOPIC_BYTES, 0x00, 0x02, 'b',
+	};
+	static const uint8_t expected_dup[] = {
+		0x3a, 0x0c, TOPIC_BYTES, 0x00, 0x01, 'a',
+		0x3a, 0x0c, TOPIC_BYTES, 0x00, 0x02, 'b',
+	};
+
+	zassert_equal(publish(1, MQTT_QOS_1_AT_LEAST_ONCE, "a"), 0,
+		      "publish failed");
+	zassert_equal(publish(2, MQTT_QOS_1_AT_LEAST_ONCE, "b"), 0,
+		      "publish failed");
+	broker_expect(expected, sizeof(expected));
+
+	/* Both are sent again with the DUP flag in a single write. */
+	broker_send(connack_session, sizeof(connack_session));
+	broker_expect(expected_dup, sizeof(expected_dup));
+	zassert_equal(mqtt_inflight_count(&client), 2, "wrong count");
+}
+
+static void test_qos2_release(void)
+{
+	static const uint8_t expected[] = {
+		0x34, 0x0c, TOPIC_BYTES, 0x00, 0x05, 'a',
+	};
+	static const uint8_t pubrec[] = { 0x50, 0x02, 0x00, 0x05 };
+	static const uint8_t pubrel[] = { 0x62, 0x02, 0x00, 0x05 };
+	static const uint8_t pubcomp[] = { 0x70, 0x02, 0x00, 0x05 };
+	struct mqtt_pubrel_param rel = { .message_id = 5 };
+
+	zassert_equal(publish(5, MQTT_QOS_2_EXACTLY_ONCE, "a"), 0,
+		      "publish failed");
+	broker_expect(expected, sizeof(expected));
+
+	broker_send(pubrec, sizeof(pubrec));
+	zassert_equal(mqtt_publish_qos2_release(&client, &rel), 0,
+		      "release failed");
+	broker_expect(pubrel, sizeof(pubrel));
+
+	/* Only the release is sent again. */
+	broker_send(connack_session, sizeof(connack_session));
+	broker_expect(pubrel, sizeof(pubrel));
+	zassert_equal(mqtt_inflight_count(&client), 1, "wrong count");
+
+	broker_send(pubcomp, sizeof(pubcomp));
+	zassert_equal(mqtt_inflight_count(&client), 0, "not removed");
+}
+
+static void test_resend_new_session(void)
+{
+	static const uint8_t expected[] = {
+		0x32, 0x0c, TOPIC_BYTES, 0x00, 0x06, 'b',
+	};
+	struct mqtt_pubrel_param rel = { .message_id = 5 };
+	uint8_t buf[BUFFER_SIZE];
+
+	zassert_equal(publish(5, MQTT_QOS_2_EXACTLY_ONCE, "a"), 0,
+		      "publish failed");
+	zassert_equal(mqtt_publish_qos2_release(&client, &rel), 0,
+		      "release failed");
+	zassert_equal(publish(6, MQTT_QOS_1_AT_LEAST_ONCE, "b"), 0,
+		      "publish failed");
+	(void)zsock_recv(broker, buf, sizeof(buf), ZSOCK_MSG_DONTWAIT);
+
+	/* The release is dropped, the publish is sent as a new one. */
+	broker_send(connack, sizeof(connack));
+	broker_expect(expected, sizeof(expected));
+	zassert_equal(mqtt_inflight_count(&client), 1, "wrong count");
+}
+
+static void test_batch(void)
+{
+	static const uint8_t expected[] = {
+		0x30, 0x0a, TOPIC_BYTES, 'a',
+		0x32, 0x0c, TOPIC_BYTES, 0x00, 0x01, 'b',
+		0x30, 0x0b, TOPIC_BYTES, 'c', 'd',
+	};
+
+	zassert_equal(mqtt_publish_batch_begin(&client), 0, "begin failed");
+	zassert_equal(publish(0, MQTT_QOS_0_AT_MOST_ONCE, "a"), 0,
+		      "publish failed");
+	zassert_equal(publish(1, MQTT_QOS_1_AT_LEAST_ONCE, "b"), 0,
+		      "publish failed");
+	zassert_equal(publish(0, MQTT_QOS_0_AT_MOST_ONCE, "cd"), 0,
+		      "publish failed");
+	broker_expect_nothing();
+
+	zassert_equal(mqtt_publish_batch_end(&client), 0, "end failed");
+	broker_expect(expected, sizeof(expected));
+	zassert_equal(mqtt_inflight_count(&client), 1, "not stored");
+}
+
+static void test_batch_full(void)
+{
+	static const uint8_t one[] = { 0x30, 0x0a, TOPIC_BYTES, 'a' };
+	uint8_t expected[4 * sizeof(one)];
+	int i;
+
+	zassert_equal(mqtt_publish_batch_begin(&client), 0, "begin failed");
+
+	/* The fourth message fills the batch, which is then written. */
+	for (i = 0; i < 4; i++) {
+		memcpy(expected + i * sizeof(one), one, sizeof(one));
+		zassert_equal(publish(0, MQTT_QOS_0_AT_MOST_ONCE, "a"), 0,
+			      "publish failed");
+	}
+
+	broker_expect(expected, sizeof(expected));
+	zassert_equal(mqtt_publish_batch_end(&client), 0, "end failed");
+	broker_expect_nothing();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(mqtt_msg_store,
+		ztest_unit_test_setup_teardown(test_puback,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_qos0_not_stored,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_window_full,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_store_full,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_resend_session_present,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_qos2_release,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_resend_new_session,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_batch,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_batch_full,
+					       client_setup, client_teardown));
+
+	ztest_run_test_suite(mqtt_msg_store);
+}
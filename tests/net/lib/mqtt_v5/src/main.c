@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <net/socket.h>
+#include <net/mqtt.h>
+
+#include <mqtt_internal.h>
+
+/* The broker side of the connection is the other end of a socket pair. */
+
+#define BUFFER_SIZE 128
+
+#define TOPIC_BYTES 0x00, 0x07, 's', 'e', 'n', 's', 'o', 'r', 's'
+#define ALIAS_1 0x03, 0x23, 0x00, 0x01
+
+static uint8_t rx_buffer[BUFFER_SIZE];
+static uint8_t tx_buffer[BUFFER_SIZE];
+static struct mqtt_client client;
+static int broker;
+
+static struct mqtt_evt last_evt;
+static uint8_t last_topic[BUFFER_SIZE];
+static uint8_t last_payload[BUFFER_SIZE];
+
+/* Receive Maximum 2, Topic Alias Maximum 1. */
+static const uint8_t connack[] = {
+	0x20, 0x09, 0x00, 0x00,
+	0x06, 0x21, 0x00, 0x02, 0x22, 0x00, 0x01
+};
+
+static void evt_handler(struct mqtt_client *const c,
+			const struct mqtt_evt *evt)
+{
+	const struct mqtt_publish_param *pub = &evt->param.publish;
+
+	last_evt = *evt;
+
+	if (evt->type != MQTT_EVT_PUBLISH || evt->result != 0) {
+		return;
+	}
+
+	memcpy(last_topic, pub->message.topic.topic.utf8,
+	       pub->message.topic.topic.size);
+	zassert_equal(mqtt_readall_publish_payload(c, last_payload,
+						   pub->message.payload.len),
+		      0, "payload read failed");
+}
+
+static void broker_send(const uint8_t *data, size_t len)
+{
+	zassert_equal(zsock_send(broker, data, len, 0), len, "send failed");
+	zassert_equal(mqtt_input(&client), 0, "input failed");
+}
+
+static void broker_expect(const uint8_t *data, size_t len)
+{
+	uint8_t buf[BUFFER_SIZE];
+	ssize_t ret;
+
+	ret = zsock_recv(broker, buf, sizeof(buf), ZSOCK_MSG_DONTWAIT);
+	zassert_equal(ret, len, "expected %u bytes, got %d", len, ret);
+	zassert_mem_equal(buf, data, len, "unexpected packet");
+}
+
+static int publish(const char *topic, uint16_t message_id, enum mqtt_qos qos)
+{
+	struct mqtt_publish_param param = {
+		.message.topic.topic.utf8 = (uint8_t *)topic,
+		.message.topic.topic.size = strlen(topic),
+		.message.topic.qos = qos,
+		.message.payload.data = (uint8_t *)"a",
+		.message.payload.len = 1,
+		.message_id = message_id,
+	};
+
+	return mqtt_publish(&client, &param);
+}
+
+static void client_setup(void)
+{
+	int sv[2];
+
+	zassert_equal(zsock_socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0,
+		      "socketpair failed");
+
+	mqtt_client_init(&client);
+	client.protocol_version = MQTT_VERSION_5_0;
+	client.client_id = MQTT_UTF8_LITERAL("cid");
+	client.evt_cb = evt_handler;
+	client.rx_buf = rx_buffer;
+	client.rx_buf_size = sizeof(rx_buffer);
+	client.tx_buf = tx_buffer;
+	client.tx_buf_size = sizeof(tx_buffer);
+	client.transport.type = MQTT_TRANSPORT_NON_SECURE;
+	client.transport.tcp.sock = sv[0];
+	broker = sv[1];
+
+	memset(&last_evt, 0, sizeof(last_evt));
+
+	/* The CONNECT packet is tested apart, start from the CONNACK. */
+	MQTT_SET_STATE(&client, MQTT_STATE_TCP_CONNECTED);
+	broker_send(connack, sizeof(connack));
+	zassert_true(MQTT_HAS_STATE(&client, MQTT_STATE_CONNECTED),
+		     "not connected");
+}
+
+static void client_teardown(void)
+{
+	mqtt_abort(&client);
+	zsock_close(broker);
+}
+
+static void test_connect(void)
+{
+	static const uint8_t expected[] = {
+		0x10, 0x1b, 0x00, 0x04, 'M', 'Q', 'T', 'T', 0x05, 0x02,
+		0x00, 0x3c,
+		/* Session Expiry, Receive Maximum, Topic Alias Maximum */
+		0x0b, 0x11, 0x00, 0x00, 0x00, 0x3c, 0x21, 0x00, 0x0a,
+		0x22, 0x00, 0x02,
+		0x00, 0x03, 'c', 'i', 'd'
+	};
+	struct buf_ctx buf = {
+		.cur = tx_buffer,
+		.end = tx_buffer + sizeof(tx_buffer),
+	};
+
+	client.clean_session = 1U;
+	client.keepalive = 60U;
+	client.session_expiry_interval = 60U;
+	client.receive_maximum = 10U;
+
+	zassert_equal(connect_request_encode(&client, &buf), 0,
+		      "encode failed");
+	zassert_equal(buf.end - buf.cur, sizeof(expected), "wrong length");
+	zassert_mem_equal(buf.cur, expected, sizeof(expected),
+			  "unexpected packet");
+}
+
+static void test_connack(void)
+{
+	const struct mqtt_connack_param *param = &last_evt.param.connack;
+
+	zassert_equal(last_evt.type, MQTT_EVT_CONNACK, "no CONNACK event");
+	zassert_equal(param->receive_maximum, 2, "wrong receive maximum");
+	zassert_equal(param->topic_alias_maximum, 1, "wrong alias maximum");
+	zassert_equal(param->maximum_qos, MQTT_QOS_2_EXACTLY_ONCE,
+		      "wrong default maximum QoS");
+}
+
+static void test_tx_topic_alias(void)
+{
+	static const uint8_t first[] = {
+		0x30, 0x0e, TOPIC_BYTES, ALIAS_1, 'a'
+	};
+	static const uint8_t aliased[] = {
+		0x30, 0x07, 0x00, 0x00, ALIAS_1, 'a'
+	};
+	/* The server accepts a single alias. */
+	static const uint8_t other[] = {
+		0x30, 0x09, 0x00, 0x05, 'o', 't', 'h', 'e', 'r', 0x00, 'a'
+	};
+
+	zassert_equal(publish("sensors", 0, MQTT_QOS_0_AT_MOST_ONCE), 0,
+		      "publish failed");
+	broker_expect(first, sizeof(first));
+
+	zassert_equal(publish("sensors", 0, MQTT_QOS_0_AT_MOST_ONCE), 0,
+		      "publish failed");
+	broker_expect(aliased, sizeof(aliased));
+
+	zassert_equal(publish("other", 0, MQTT_QOS_0_AT_MOST_ONCE), 0,
+		      "publish failed");
+	broker_expect(other, sizeof(other));
+}
+
+static void test_receive_maximum(void)
+{
+	/* Success reason code and no properties are omitted. */
+	static const uint8_t puback[] = { 0x40, 0x02, 0x00, 0x01 };
+
+	zassert_equal(publish("sensors", 1, MQTT_QOS_1_AT_LEAST_ONCE), 0,
+		      "publish failed");
+	zassert_equal(publish("sensors", 2, MQTT_QOS_1_AT_LEAST_ONCE), 0,
+		      "publish failed");
+	zassert_equal(publish("sensors", 3, MQTT_QOS_1_AT_LEAST_ONCE),
+		      -ENOBUFS, "receive maximum not enforced");
+	zassert_equal(publish("sensors", 0, MQTT_QOS_0_AT_MOST_ONCE), 0,
+		      "QoS 0 not sent");
+
+	broker_send(puback, sizeof(puback));
+	zassert_equal(last_evt.param.puback.reason_code, 0, "wrong reason");
+	zassert_equal(publish("sensors", 3, MQTT_QOS_1_AT_LEAST_ONCE), 0,
+		      "publish failed");
+}
+
+static void test_ack_reason_code(void)
+{
+	static const uint8_t puback[] = { 0x40, 0x03, 0x00, 0x01, 0x10 };
+
+	zassert_equal(publish("sensors", 1, MQTT_QOS_1_AT_LEAST_ONCE), 0,
+		      "publish failed");
+
+	broker_send(puback, sizeof(puback));
+	zassert_equal(last_evt.type, MQTT_EVT_PUBACK, "no PUBACK event");
+	zassert_equal(last_evt.param.puback.message_id, 1, "wrong id");
+	zassert_equal(last_evt.param.puback.reason_code, 0x10,
+		      "wrong reason");
+}
+
+static void test_rx_topic_alias(void)
+{
+	static const uint8_t first[] = {
+		0x30, 0x0e, TOPIC_BYTES, ALIAS_1, 'x'
+	};
+	static const uint8_t aliased[] = {
+		0x30, 0x07, 0x00, 0x00, ALIAS_1, 'y'
+	};
+	const struct mqtt_publish_param *param = &last_evt.param.publish;
+
+	broker_send(first, sizeof(first));
+	zassert_equal(last_evt.type, MQTT_EVT_PUBLISH, "no PUBLISH event");
+	zassert_equal(param->topic_alias, 1, "wrong alias");
+	zassert_equal(last_payload[0], 'x', "wrong payload");
+
+	memset(last_topic, 0, sizeof(last_topic));
+	broker_send(aliased, sizeof(aliased));
+	zassert_equal(param->message.topic.topic.size, 7, "alias not resolved");
+	zassert_mem_equal(last_topic, "sensors", 7, "wrong topic");
+	zassert_equal(last_payload[0], 'y', "wrong payload");
+}
+
+static void test_rx_unknown_topic_alias(void)
+{
+	static const uint8_t unknown[] = {
+		0x30, 0x07, 0x00, 0x00, 0x03, 0x23, 0x00, 0x02, 'x'
+	};
+
+	zassert_equal(zsock_send(broker, unknown, sizeof(unknown), 0),
+		      sizeof(unknown), "send failed");
+	zassert_equal(mqtt_input(&client), -EINVAL, "alias not checked");
+	zassert_equal(last_evt.type, MQTT_EVT_DISCONNECT, "not disconnected");
+}
+
+static void test_server_disconnect(void)
+{
+	/* Session taken over. */
+	static const uint8_t disconnect[] = { 0xe0, 0x01, 0x8e };
+
+	zassert_equal(zsock_send(broker, disconnect, sizeof(disconnect), 0),
+		      sizeof(disconnect), "send failed");
+	zassert_equal(mqtt_input(&client), -ECONNRESET, "not reset");
+	zassert_equal(last_evt.type, MQTT_EVT_DISCONNECT, "not disconnected");
+	zassert_equal(last_evt.result, -ECONNRESET, "wrong result");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(mqtt_v5,
+		ztest_unit_test_setup_teardown(test_connect,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_connack,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_tx_topic_alias,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_receive_maximum,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_ack_reason_code,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_rx_topic_alias,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_rx_unknown_topic_alias,
+					       client_setup, client_teardown),
+		ztest_unit_test_setup_teardown(test_server_disconnect,
+					       client_setup, client_teardown));
+
+	ztest_run_test_suite(mqtt_v5);
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <string.h>
+#include <ztest_assert.h>
+#include <net/socket.h>
+#include <net/tls_credentials.h>
+
+#include "../../socket_helpers.h"
+
+#define PSK_TAG 1
+#define SERVER_PORT 4244
+
+#define SERVER_STACK_SIZE 4096
+#define SERVER_PRIORITY K_PRIO_PREEMPT(8)
+
+#define PEERS 3
+#define ROUNDS 4
+
+static const unsigned char psk[] = {
+	0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+	0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+};
+static const char psk_id[] = "dtls_multi_peer_test";
+
+static const sec_tag_t sec_tags[] = { PSK_TAG };
+
+K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+
+static struct sockaddr_in server_addr;
+
+static int c_socks[PEERS];
+
+/* Echo the datagrams back to the peer they came from */
+static void server(void *p1, void *p2, void *p3)
+{
+	int s_sock = POINTER_TO_INT(p1);
+	int count = POINTER_TO_INT(p2);
+	struct sockaddr_in addr;
+	socklen_t addrlen;
+	uint8_t byte;
+	ssize_t ret;
+
+	ARG_UNUSED(p3);
+
+	while (count--) {
+		addrlen = sizeof(addr);
+		ret = recvfrom(s_sock, &byte, 1, 0, (struct sockaddr *)&addr,
+			       &addrlen);
+		zassert_equal(ret, 1, "recvfrom failed (%d)", errno);
+		zassert_equal(addrlen, sizeof(addr), "Invalid addrlen");
+
+		ret = sendto(s_sock, &byte, 1, 0, (struct sockaddr *)&addr,
+			     addrlen);
+		zassert_equal(ret, 1, "sendto failed (%d)", errno);
+	}
+}
+
+static int dtls_socket(int role)
+{
+	int sock;
+	int ret;
+
+	sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_DTLS_1_2);
+	zassert_true(sock >= 0, "socket open failed (%d)", errno);
+
+	ret = setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST, sec_tags,
+			 sizeof(sec_tags));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	ret = setsockopt(sock, SOL_TLS, TLS_DTLS_ROLE, &role, sizeof(role));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	return sock;
+}
+
+static void echo(int sock, uint8_t byte)
+{
+	uint8_t reply = 0;
+
+	zassert_equal(send(sock, &byte, 1, 0), 1, "send failed (%d)", errno);
+	zassert_equal(recv(sock, &reply, 1, 0), 1, "recv failed (%d)", errno);
+	zassert_equal(reply, byte, "Reply from another session");
+}
+
+static void test_setup(void)
+{
+	int ret;
+
+	ret = tls_credential_add(PSK_TAG, TLS_CREDENTIAL_PSK, psk,
+				 sizeof(psk));
+	zassert_equal(ret, 0, "Cannot add PSK (%d)", ret);
+
+	ret = tls_credential_add(PSK_TAG, TLS_CREDENTIAL_PSK_ID, psk_id,
+				 strlen(psk_id));
+	zassert_equal(ret, 0, "Cannot add PSK ID (%d)", ret);
+
+	server_addr.sin_family = AF_INET;
+	server_addr.sin_port = htons(SERVER_PORT);
+	ret = inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR,
+			&server_addr.sin_addr);
+	zassert_equal(ret, 1, "inet_pton failed");
+}
+
+static void test_multi_peer_option(void)
+{
+	int sock, optval;
+	socklen_t optlen = sizeof(optval);
+	int ret;
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TLS_1_2);
+	zassert_true(sock >= 0, "socket open failed (%d)", errno);
+
+	optval = 1;
+	ret = setsockopt(sock, SOL_TLS, TLS_DTLS_MULTI_PEER, &optval,
+			 sizeof(optval));
+	zassert_equal(ret, -1, "Multi-peer TLS socket accepted");
+	zassert_equal(errno, EINVAL, "Unexpected errno (%d)", errno);
+
+	zassert_equal(close(sock), 0, "close failed");
+
+	sock = dtls_socket(TLS_DTLS_ROLE_SERVER);
+
+	ret = getsockopt(sock, SOL_TLS, TLS_DTLS_MULTI_PEER, &optval, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optval, 0, "Multi-peer enabled by default");
+
+	optval = 1;
+	ret = setsockopt(sock, SOL_TLS, TLS_DTLS_MULTI_PEER, &optval,
+			 sizeof(optval));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	ret = getsockopt(sock, SOL_TLS, TLS_DTLS_MULTI_PEER, &optval, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optval, 1, "Multi-peer not enabled");
+
+	zassert_equal(close(sock), 0, "close failed");
+}
+
+static void test_multi_peer_echo(void)
+{
+	int optval = 1;
+	int s_sock, i, j;
+	int ret;
+
+	s_sock = dtls_socket(TLS_DTLS_ROLE_SERVER);
+
+	ret = setsockopt(s_sock, SOL_TLS, TLS_DTLS_MULTI_PEER, &optval,
+			 sizeof(optval));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	ret = bind(s_sock, (struct sockaddr *)&server_addr,
+		   sizeof(server_addr));
+	zassert_equal(ret, 0, "bind failed (%d)", errno);
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack), server,
+			INT_TO_POINTER(s_sock),
+			INT_TO_POINTER(PEERS * ROUNDS), NULL,
+			SERVER_PRIORITY, 0, K_NO_WAIT);
+
+	for (i = 0; i < PEERS; i++) {
+		c_socks[i] = dtls_socket(TLS_DTLS_ROLE_CLIENT);
+
+		optval = TLS_PEER_VERIFY_NONE;
+		ret = setsockopt(c_socks[i], SOL_TLS, TLS_PEER_VERIFY, &optval,
+				 sizeof(optval));
+		zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+		ret = connect(c_socks[i], (struct sockaddr *)&server_addr,
+			      sizeof(server_addr));
+		zassert_equal(ret, 0, "connect failed (%d)", errno);
+	}
+
+	/* All the sessions stay open on the one server socket, so the
+	 * replies must reach the peer that sent the datagram.
+	 */
+	for (j = 0; j < ROUNDS; j++) {
+		for (i = 0; i < PEERS; i++) {
+			echo(c_socks[i], (uint8_t)(i * ROUNDS + j));
+		}
+	}
+
+	k_thread_join(&server_thread, K_FOREVER);
+
+	for (i = 0; i < PEERS; i++) {
+		zassert_equal(close(c_socks[i]), 0, "close failed");
+	}
+
+	zassert_equal(close(s_sock), 0, "close failed");
+}
+
+void test_main(void)
+{
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(8));
+
+	ztest_test_suite(socket_dtls_multi_peer,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_multi_peer_option),
+			 ztest_unit_test(test_multi_peer_echo));
+
+	ztest_run_test_suite(socket_dtls_multi_peer);
+}
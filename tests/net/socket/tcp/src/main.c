@@ -652,6 +652,136 @@ void test_v6_so_rcvtimeo(void)
 }
 
 #ifdef CONFIG_USERSPACE
+#define BUF_TEST_CHUNK 100
+#define BUF_TEST_RCVBUF 2000
+#define BUF_TEST_SNDBUF 300
+
+/* Send chunks without blocking until the send fails several times in a
+ * row, return the number of bytes sent.
+ */
+static size_t send_until_full(int sock, const char *buf)
+{
+	size_t total = 0;
+	int tries = 0;
+	ssize_t ret;
+
+	while (tries < 5) {
+		ret = send(sock, buf, BUF_TEST_CHUNK, MSG_DONTWAIT);
+		if (ret > 0) {
+			total += ret;
+			tries = 0;
+			continue;
+		}
+
+		zassert_equal(errno, EAGAIN, "send failed (%d)", errno);
+
+		/* Let the peer acknowledge the data and update the window */
+		k_msleep(THREAD_SLEEP);
+		tries++;
+	}
+
+	return total;
+}
+
+void test_v4_so_rcvbuf_sndbuf(void)
+{
+	static char buf[BUF_TEST_RCVBUF * 2];
+	int c_sock;
+	int s_sock;
+	int new_sock;
+	struct sockaddr_in c_saddr;
+	struct sockaddr_in s_saddr;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	socklen_t optlen;
+	size_t total, received;
+	int optval, rv;
+	ssize_t ret;
+
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &c_sock, &c_saddr);
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &s_sock, &s_saddr);
+
+	/* Accepted sockets inherit the buffer size of the listener */
+	optval = BUF_TEST_RCVBUF;
+	rv = setsockopt(s_sock, SOL_SOCKET, SO_RCVBUF, &optval,
+			sizeof(optval));
+	zassert_equal(rv, 0, "setsockopt failed (%d)", errno);
+
+	test_bind(s_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_listen(s_sock);
+
+	test_connect(c_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_accept(s_sock, &new_sock, &addr, &addrlen);
+
+	optlen = sizeof(optval);
+	rv = getsockopt(new_sock, SOL_SOCKET, SO_RCVBUF, &optval, &optlen);
+	zassert_equal(rv, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optval, BUF_TEST_RCVBUF, "Receive buffer not inherited");
+
+	/* The server does not read: the advertised window closes once the
+	 * receive buffer is full, and the client stops sending.
+	 */
+	memset(buf, 'a', sizeof(buf));
+	total = send_until_full(c_sock, buf);
+	zassert_true(total >= BUF_TEST_RCVBUF - BUF_TEST_CHUNK &&
+		     total <= BUF_TEST_RCVBUF + BUF_TEST_CHUNK,
+		     "Sent %zu bytes into a %d bytes window", total,
+		     BUF_TEST_RCVBUF);
+
+	/* Reading reopens the window */
+	received = 0;
+	while (received < total) {
+		ret = recv(new_sock, buf, sizeof(buf), 0);
+		zassert_true(ret > 0, "recv failed (%d)", errno);
+		received += ret;
+	}
+
+	k_msleep(THREAD_SLEEP);
+
+	ret = send(c_sock, buf, BUF_TEST_CHUNK, MSG_DONTWAIT);
+	zassert_equal(ret, BUF_TEST_CHUNK, "Window not reopened (%d)", errno);
+
+	ret = recv(new_sock, buf, sizeof(buf), 0);
+	zassert_equal(ret, BUF_TEST_CHUNK, "recv failed (%d)", errno);
+
+	/* With a cooperative stack the data stays unacknowledged until this
+	 * thread sleeps, so the send buffer limit applies.
+	 */
+	if (IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE)) {
+		optval = BUF_TEST_SNDBUF;
+		rv = setsockopt(c_sock, SOL_SOCKET, SO_SNDBUF, &optval,
+				sizeof(optval));
+		zassert_equal(rv, 0, "setsockopt failed (%d)", errno);
+
+		total = 0;
+		while (send(c_sock, buf, BUF_TEST_CHUNK, MSG_DONTWAIT) > 0) {
+			total += BUF_TEST_CHUNK;
+		}
+
+		zassert_equal(errno, EAGAIN, "send failed (%d)", errno);
+		zassert_equal(total, BUF_TEST_SNDBUF,
+			      "Sent %zu bytes with a %d bytes send buffer",
+			      total, BUF_TEST_SNDBUF);
+
+		received = 0;
+		while (received < total) {
+			ret = recv(new_sock, buf, sizeof(buf), 0);
+			zassert_true(ret > 0, "recv failed (%d)", errno);
+			received += ret;
+		}
+	}
+
+	test_close(c_sock);
+	test_eof(new_sock);
+
+	test_close(new_sock);
+	test_close(s_sock);
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
 #define CHILD_STACK_SZ		(2048 + CONFIG_TEST_EXTRA_STACKSIZE)
 struct k_thread child_thread;
 K_THREAD_STACK_DEFINE(child_stack, CHILD_STACK_SZ);
@@ -739,6 +869,7 @@ void test_main(void)
 		ztest_user_unit_test(test_v4_accept_timeout),
 		ztest_unit_test(test_v4_so_rcvtimeo),
 		ztest_unit_test(test_v6_so_rcvtimeo),
+		ztest_unit_test(test_v4_so_rcvbuf_sndbuf),
 		ztest_user_unit_test(test_socket_permission)
 		);
 
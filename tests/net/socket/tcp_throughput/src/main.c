@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <string.h>
+#include <ztest_assert.h>
+#include <net/socket.h>
+#include <net/loopback.h>
+
+#include "../../socket_helpers.h"
+
+#define SERVER_PORT 4242
+#define ANY_PORT 0
+
+#define TRANSFER_SIZE (32 * 1024)
+#define CHUNK_SIZE 512
+
+/* How long we wait for the whole transfer before failing the test */
+#define TRANSFER_TIMEOUT_MS (60 * MSEC_PER_SEC)
+
+/* Minimum throughputs, in kB/s. They are well below what the stack
+ * achieves on emulated targets, so that they fail on stalls, like
+ * needless retransmission timeouts or a window that does not reopen,
+ * rather than on the speed of the host.
+ */
+#define MIN_KBPS_LOSSLESS 16
+#define MIN_KBPS_DELAY 4
+#define MIN_KBPS_LOSS 4
+#define MIN_KBPS_LOSS_AND_DELAY 2
+
+#define TCP_TEARDOWN_TIMEOUT K_SECONDS(1)
+
+#define SENDER_STACK_SIZE 2048
+#define SENDER_PRIORITY K_PRIO_PREEMPT(8)
+
+K_THREAD_STACK_DEFINE(sender_stack, SENDER_STACK_SIZE);
+static struct k_thread sender_thread;
+
+static uint8_t tx_buf[CHUNK_SIZE];
+static uint8_t rx_buf[CHUNK_SIZE];
+
+/* The payload is a running byte counter so that lost, duplicated and
+ * reordered data can be detected at the receiver.
+ */
+static uint8_t pattern_byte(size_t offset)
+{
+	return (uint8_t)(offset * 7U + (offset >> 8));
+}
+
+static void sender(void *p1, void *p2, void *p3)
+{
+	int sock = POINTER_TO_INT(p1);
+	size_t sent = 0;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (sent < TRANSFER_SIZE) {
+		size_t len = MIN(sizeof(tx_buf), TRANSFER_SIZE - sent);
+		ssize_t ret;
+
+		for (size_t i = 0; i < len; i++) {
+			tx_buf[i] = pattern_byte(sent + i);
+		}
+
+		ret = send(sock, tx_buf, len, 0);
+		zassert_true(ret > 0, "send failed (%d)", errno);
+
+		sent += ret;
+	}
+}
+
+static void run_transfer(const char *cc, float drop_ratio, uint32_t delay_ms,
+			 int64_t min_kbps)
+{
+	struct sockaddr_in c_saddr, s_saddr, addr;
+	socklen_t addrlen = sizeof(addr);
+	int c_sock, s_sock, new_sock;
+	struct timeval optval = {
+		.tv_sec = TRANSFER_TIMEOUT_MS / MSEC_PER_SEC,
+	};
+	int dropped = loopback_get_num_dropped_packets();
+	size_t received = 0;
+	int64_t start, elapsed, kbps;
+	ssize_t ret;
+
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &c_sock, &c_saddr);
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &s_sock, &s_saddr);
+
+	if (cc) {
+		ret = setsockopt(c_sock, IPPROTO_TCP, TCP_CONGESTION, cc,
+				 strlen(cc));
+		zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+	}
+
+	zassert_equal(bind(s_sock, (struct sockaddr *)&s_saddr,
+			   sizeof(s_saddr)), 0, "bind failed");
+	zassert_equal(listen(s_sock, 1), 0, "listen failed");
+	zassert_equal(connect(c_sock, (struct sockaddr *)&s_saddr,
+			      sizeof(s_saddr)), 0, "connect failed");
+
+	new_sock = accept(s_sock, (struct sockaddr *)&addr, &addrlen);
+	zassert_true(new_sock >= 0, "accept failed");
+
+	ret = setsockopt(new_sock, SOL_SOCKET, SO_RCVTIMEO, &optval,
+			 sizeof(optval));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	/* Only impair the link for the bulk transfer so that the
+	 * connection setup and teardown are deterministic.
+	 */
+	zassert_equal(loopback_set_packet_drop_ratio(drop_ratio), 0,
+		      "Cannot set drop ratio");
+	zassert_equal(loopback_set_packet_delay(delay_ms), 0,
+		      "Cannot set delay");
+
+	start = k_uptime_get();
+
+	k_thread_create(&sender_thread, sender_stack,
+			K_THREAD_STACK_SIZEOF(sender_stack), sender,
+			INT_TO_POINTER(c_sock), NULL, NULL,
+			SENDER_PRIORITY, 0, K_NO_WAIT);
+
+	while (received < TRANSFER_SIZE) {
+		ret = recv(new_sock, rx_buf, sizeof(rx_buf), 0);
+		zassert_true(ret > 0, "recv failed after %zu bytes (%d)",
+			     received, errno);
+
+		for (ssize_t i = 0; i < ret; i++) {
+			zassert_equal(rx_buf[i], pattern_byte(received + i),
+				      "Data mismatch at offset %zu",
+				      received + i);
+		}
+
+		received += ret;
+	}
+
+	elapsed = MAX(k_uptime_get() - start, 1);
+
+	k_thread_join(&sender_thread, K_FOREVER);
+
+	loopback_set_packet_drop_ratio(0.0f);
+	loopback_set_packet_delay(0);
+
+	kbps = (received * MSEC_PER_SEC) / (elapsed * 1024);
+
+	TC_PRINT("%s drop %d%% delay %u ms: %zu bytes in %lld ms "
+		 "(%lld kB/s), %d packets dropped\n", cc ? cc : "default",
+		 (int)(drop_ratio * 100), delay_ms, received, elapsed,
+		 kbps, loopback_get_num_dropped_packets() - dropped);
+
+	zassert_true(kbps >= min_kbps, "Throughput %lld kB/s below %lld kB/s",
+		     kbps, min_kbps);
+
+	zassert_equal(close(c_sock), 0, "close failed");
+	zassert_equal(close(new_sock), 0, "close failed");
+	zassert_equal(close(s_sock), 0, "close failed");
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
+static void test_throughput_lossless(void)
+{
+	run_transfer(NULL, 0.0f, 0, MIN_KBPS_LOSSLESS);
+}
+
+static void test_throughput_delay(void)
+{
+	run_transfer(NULL, 0.0f, 50, MIN_KBPS_DELAY);
+}
+
+static void test_throughput_loss(void)
+{
+	run_transfer(NULL, 0.02f, 0, MIN_KBPS_LOSS);
+}
+
+static void test_throughput_loss_and_delay(void)
+{
+	run_transfer(NULL, 0.05f, 50, MIN_KBPS_LOSS_AND_DELAY);
+}
+
+static void test_congestion_control_sockopt(void)
+{
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	char name[16];
+	socklen_t optlen = sizeof(name);
+	int sock;
+	int ret;
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(sock >= 0, "socket open failed");
+
+	ret = getsockopt(sock, IPPROTO_TCP, TCP_CONGESTION, name, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(strcmp(name, CONFIG_NET_TCP_CC_DEFAULT), 0,
+		      "Unexpected default algorithm %s", name);
+
+	ret = setsockopt(sock, IPPROTO_TCP, TCP_CONGESTION, "vegas",
+			 sizeof("vegas"));
+	zassert_equal(ret, -1, "Unknown algorithm accepted");
+	zassert_equal(errno, ENOENT, "Unexpected errno (%d)", errno);
+
+	ret = setsockopt(sock, IPPROTO_TCP, TCP_CONGESTION, "cubic",
+			 strlen("cubic"));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	optlen = sizeof(name);
+	ret = getsockopt(sock, IPPROTO_TCP, TCP_CONGESTION, name, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(strcmp(name, "cubic"), 0, "Algorithm not changed");
+	zassert_equal(optlen, sizeof("cubic"), "Invalid optlen");
+
+	zassert_equal(close(sock), 0, "close failed");
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void test_throughput_newreno_loss_and_delay(void)
+{
+#if defined(CONFIG_NET_TCP_CC_NEWRENO)
+	run_transfer("newreno", 0.05f, 50, MIN_KBPS_LOSS_AND_DELAY);
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void test_throughput_cubic_loss_and_delay(void)
+{
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+	run_transfer("cubic", 0.05f, 50, MIN_KBPS_LOSS_AND_DELAY);
+#else
+	ztest_test_skip();
+#endif
+}
+
+void test_main(void)
+{
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(8));
+
+	ztest_test_suite(socket_tcp_throughput,
+			 ztest_unit_test(test_throughput_lossless),
+			 ztest_unit_test(test_throughput_delay),
+			 ztest_unit_test(test_throughput_loss),
+			 ztest_unit_test(test_throughput_loss_and_delay),
+			 ztest_unit_test(test_congestion_control_sockopt),
+			 ztest_unit_test(test_throughput_newreno_loss_and_delay),
+			 ztest_unit_test(test_throughput_cubic_loss_and_delay)
+			 );
+
+	ztest_run_test_suite(socket_tcp_throughput);
+}
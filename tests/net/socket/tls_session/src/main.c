@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <string.h>
+#include <ztest_assert.h>
+#include <net/socket.h>
+#include <net/tls_credentials.h>
+
+#include "../../socket_helpers.h"
+
+#define PSK_TAG 1
+#define SERVER_PORT 4243
+
+#define SERVER_STACK_SIZE 4096
+#define SERVER_PRIORITY K_PRIO_PREEMPT(8)
+
+#define CONNECTIONS 3
+
+static const unsigned char psk[] = {
+	0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+	0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+};
+static const char psk_id[] = "tls_session_test";
+
+static const sec_tag_t sec_tags[] = { PSK_TAG };
+
+K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+
+static struct sockaddr_in server_addr;
+
+static void get_stats(int sock, struct tls_session_cache_stats *stats)
+{
+	socklen_t optlen = sizeof(*stats);
+	int ret;
+
+	ret = getsockopt(sock, SOL_TLS, TLS_SESSION_CACHE_STATS, stats,
+			 &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optlen, sizeof(*stats), "Invalid optlen");
+}
+
+static void set_tls_options(int sock, bool cache)
+{
+	int optval;
+	int ret;
+
+	ret = setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST, sec_tags,
+			 sizeof(sec_tags));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	optval = cache ? TLS_SESSION_CACHE_ENABLED :
+		TLS_SESSION_CACHE_DISABLED;
+	ret = setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE, &optval,
+			 sizeof(optval));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+}
+
+static void server(void *p1, void *p2, void *p3)
+{
+	int s_sock = POINTER_TO_INT(p1);
+	int count = POINTER_TO_INT(p2);
+	struct sockaddr_in addr;
+	socklen_t addrlen;
+	uint8_t byte;
+	int new_sock;
+
+	ARG_UNUSED(p3);
+
+	while (count--) {
+		addrlen = sizeof(addr);
+		new_sock = accept(s_sock, (struct sockaddr *)&addr, &addrlen);
+		zassert_true(new_sock >= 0, "accept failed (%d)", errno);
+
+		zassert_equal(recv(new_sock, &byte, 1, 0), 1, "recv failed");
+		zassert_equal(send(new_sock, &byte, 1, 0), 1, "send failed");
+
+		zassert_equal(close(new_sock), 0, "close failed");
+	}
+}
+
+static int start_server(bool cache, int count)
+{
+	int s_sock;
+	int ret;
+
+	s_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TLS_1_2);
+	zassert_true(s_sock >= 0, "socket open failed (%d)", errno);
+
+	set_tls_options(s_sock, cache);
+
+	/* Each test uses a new port so that the connections of the
+	 * previous test can still be closing.
+	 */
+	server_addr.sin_port = htons(ntohs(server_addr.sin_port) + 1);
+
+	ret = bind(s_sock, (struct sockaddr *)&server_addr,
+		   sizeof(server_addr));
+	zassert_equal(ret, 0, "bind failed (%d)", errno);
+	zassert_equal(listen(s_sock, 1), 0, "listen failed");
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack), server,
+			INT_TO_POINTER(s_sock), INT_TO_POINTER(count), NULL,
+			SERVER_PRIORITY, 0, K_NO_WAIT);
+
+	return s_sock;
+}
+
+static void client_connect(bool cache)
+{
+	int verify = TLS_PEER_VERIFY_NONE;
+	uint8_t byte = 0x5a;
+	int c_sock;
+	int ret;
+
+	c_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TLS_1_2);
+	zassert_true(c_sock >= 0, "socket open failed (%d)", errno);
+
+	set_tls_options(c_sock, cache);
+
+	ret = setsockopt(c_sock, SOL_TLS, TLS_PEER_VERIFY, &verify,
+			 sizeof(verify));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	ret = connect(c_sock, (struct sockaddr *)&server_addr,
+		      sizeof(server_addr));
+	zassert_equal(ret, 0, "connect failed (%d)", errno);
+
+	zassert_equal(send(c_sock, &byte, 1, 0), 1, "send failed");
+	zassert_equal(recv(c_sock, &byte, 1, 0), 1, "recv failed");
+	zassert_equal(byte, 0x5a, "Invalid data");
+
+	zassert_equal(close(c_sock), 0, "close failed");
+}
+
+static void test_setup(void)
+{
+	int ret;
+
+	ret = tls_credential_add(PSK_TAG, TLS_CREDENTIAL_PSK, psk,
+				 sizeof(psk));
+	zassert_equal(ret, 0, "Cannot add PSK (%d)", ret);
+
+	ret = tls_credential_add(PSK_TAG, TLS_CREDENTIAL_PSK_ID, psk_id,
+				 strlen(psk_id));
+	zassert_equal(ret, 0, "Cannot add PSK ID (%d)", ret);
+
+	server_addr.sin_family = AF_INET;
+	server_addr.sin_port = htons(SERVER_PORT);
+	ret = inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR,
+			&server_addr.sin_addr);
+	zassert_equal(ret, 1, "inet_pton failed");
+}
+
+static void test_session_cache_option(void)
+{
+	int sock, optval;
+	socklen_t optlen = sizeof(optval);
+	int ret;
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TLS_1_2);
+	zassert_true(sock >= 0, "socket open failed (%d)", errno);
+
+	ret = getsockopt(sock, SOL_TLS, TLS_SESSION_CACHE, &optval, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optval, TLS_SESSION_CACHE_DISABLED,
+		      "Cache enabled by default");
+
+	optval = 2;
+	ret = setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE, &optval,
+			 sizeof(optval));
+	zassert_equal(ret, -1, "Invalid value accepted");
+	zassert_equal(errno, EINVAL, "Unexpected errno (%d)", errno);
+
+	optval = TLS_SESSION_CACHE_ENABLED;
+	ret = setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE, &optval,
+			 sizeof(optval));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	ret = getsockopt(sock, SOL_TLS, TLS_SESSION_CACHE, &optval, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optval, TLS_SESSION_CACHE_ENABLED, "Cache not enabled");
+
+	zassert_equal(close(sock), 0, "close failed");
+}
+
+static void test_session_resumed(void)
+{
+	struct tls_session_cache_stats before, after;
+	int s_sock, i;
+
+	s_sock = start_server(true, CONNECTIONS);
+
+	get_stats(s_sock, &before);
+
+	for (i = 0; i < CONNECTIONS; i++) {
+		client_connect(true);
+	}
+
+	k_thread_join(&server_thread, K_FOREVER);
+
+	get_stats(s_sock, &after);
+
+	/* Only the first connection needs the full handshake */
+	zassert_equal(after.client_full - before.client_full, 1,
+		      "Unexpected full handshakes");
+	zassert_equal(after.client_resumed - before.client_resumed,
+		      CONNECTIONS - 1, "Sessions not resumed");
+	zassert_equal(after.client_stored - before.client_stored,
+		      CONNECTIONS, "Sessions not stored");
+
+	zassert_equal(close(s_sock), 0, "close failed");
+}
+
+static void test_session_cache_disabled(void)
+{
+	struct tls_session_cache_stats before, after;
+	int s_sock, i;
+
+	s_sock = start_server(false, 2);
+
+	get_stats(s_sock, &before);
+
+	for (i = 0; i < 2; i++) {
+		client_connect(false);
+	}
+
+	k_thread_join(&server_thread, K_FOREVER);
+
+	get_stats(s_sock, &after);
+
+	zassert_equal(after.client_stored, before.client_stored,
+		      "Session stored with cache disabled");
+	zassert_equal(after.server_hits, before.server_hits,
+		      "Session resumed with cache disabled");
+
+	zassert_equal(close(s_sock), 0, "close failed");
+}
+
+static void test_session_cache_purge(void)
+{
+	struct tls_session_cache_stats before, after;
+	int s_sock;
+	int ret;
+
+	/* All the connections go to the same server port, so that the
+	 * cached session matches until it is purged.
+	 */
+	s_sock = start_server(true, 3);
+
+	get_stats(s_sock, &before);
+
+	client_connect(true);
+	client_connect(true);
+
+	get_stats(s_sock, &after);
+
+	zassert_equal(after.client_full - before.client_full, 1,
+		      "Unexpected full handshakes");
+	zassert_equal(after.client_resumed - before.client_resumed, 1,
+		      "Session not resumed before the purge");
+
+	ret = setsockopt(s_sock, SOL_TLS, TLS_SESSION_CACHE_PURGE, NULL, 0);
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	before = after;
+
+	client_connect(true);
+
+	k_thread_join(&server_thread, K_FOREVER);
+
+	get_stats(s_sock, &after);
+
+	zassert_equal(after.client_full - before.client_full, 1,
+		      "No full handshake after the purge");
+	zassert_equal(after.client_resumed, before.client_resumed,
+		      "Purged session resumed");
+
+	zassert_equal(close(s_sock), 0, "close failed");
+}
+
+void test_main(void)
+{
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(8));
+
+	ztest_test_suite(socket_tls_session,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_session_cache_option),
+			 ztest_unit_test(test_session_resumed),
+			 ztest_unit_test(test_session_cache_disabled),
+			 ztest_unit_test(test_session_cache_purge));
+
+	ztest_run_test_suite(socket_tls_session);
+}
@@ -816,6 +816,99 @@ void test_so_rcvtimeo(void)
 	zassert_equal(rv, 0, "close failed");
 }
 
+void test_so_rcvbuf(void)
+{
+	struct sockaddr_in client_addr, server_addr;
+	int client_sock, server_sock, rv, i;
+	int optval, rcvbuf;
+	socklen_t optlen;
+	ssize_t ret;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	optlen = sizeof(optval);
+	rv = getsockopt(server_sock, SOL_SOCKET, SO_RCVBUF, &optval, &optlen);
+	zassert_equal(rv, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optval, CONFIG_NET_CONTEXT_RCVBUF_DEFAULT,
+		      "Invalid default receive buffer size");
+	zassert_equal(optlen, sizeof(optval), "Invalid optlen");
+
+	optval = -1;
+	rv = setsockopt(server_sock, SOL_SOCKET, SO_RCVBUF, &optval,
+			sizeof(optval));
+	zassert_equal(rv, -1, "Negative size accepted");
+	zassert_equal(errno, EINVAL, "Unexpected errno (%d)", errno);
+
+	/* Room for two datagrams but not for the third one */
+	rcvbuf = 2 * STRLEN(TEST_STR2) + 1;
+	rv = setsockopt(server_sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf,
+			sizeof(rcvbuf));
+	zassert_equal(rv, 0, "setsockopt failed (%d)", errno);
+
+	optlen = sizeof(optval);
+	rv = getsockopt(server_sock, SOL_SOCKET, SO_RCVBUF, &optval, &optlen);
+	zassert_equal(rv, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optval, rcvbuf, "Receive buffer size not changed");
+
+	for (i = 0; i < 4; i++) {
+		ret = sendto(client_sock, BUF_AND_SIZE(TEST_STR2), 0,
+			     (struct sockaddr *)&server_addr,
+			     sizeof(server_addr));
+		zassert_equal(ret, STRLEN(TEST_STR2), "sendto failed");
+	}
+
+	k_msleep(100);
+
+	for (i = 0; i < 2; i++) {
+		ret = recv(server_sock, rx_buf, sizeof(rx_buf), MSG_DONTWAIT);
+		zassert_equal(ret, STRLEN(TEST_STR2), "recv failed (%d)",
+			      errno);
+	}
+
+	ret = recv(server_sock, rx_buf, sizeof(rx_buf), MSG_DONTWAIT);
+	zassert_equal(ret, -1, "Datagram over the buffer size received");
+	zassert_equal(errno, EAGAIN, "Unexpected errno (%d)", errno);
+
+	/* Reading gave the space back */
+	ret = sendto(client_sock, BUF_AND_SIZE(TEST_STR2), 0,
+		     (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(ret, STRLEN(TEST_STR2), "sendto failed");
+
+	ret = recv(server_sock, rx_buf, sizeof(rx_buf), 0);
+	zassert_equal(ret, STRLEN(TEST_STR2), "recv failed (%d)", errno);
+
+	optlen = sizeof(optval);
+	rv = getsockopt(client_sock, SOL_SOCKET, SO_SNDBUF, &optval, &optlen);
+	zassert_equal(rv, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optval, CONFIG_NET_CONTEXT_SNDBUF_DEFAULT,
+		      "Invalid default send buffer size");
+
+	optval = STRLEN(TEST_STR2);
+	rv = setsockopt(client_sock, SOL_SOCKET, SO_SNDBUF, &optval,
+			sizeof(optval));
+	zassert_equal(rv, 0, "setsockopt failed (%d)", errno);
+
+	/* A datagram larger than the buffer fits when nothing is queued */
+	ret = sendto(client_sock, BUF_AND_SIZE(TEST_STR2), 0,
+		     (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(ret, STRLEN(TEST_STR2), "sendto failed");
+
+	ret = recv(server_sock, rx_buf, sizeof(rx_buf), 0);
+	zassert_equal(ret, STRLEN(TEST_STR2), "recv failed (%d)", errno);
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
 static void comm_sendmsg_with_txtime(int client_sock,
 				     struct sockaddr *client_addr,
 				     socklen_t client_addrlen,
@@ -1031,6 +1124,7 @@ void test_main(void)
 			 ztest_unit_test(test_so_priority),
 			 ztest_unit_test(test_so_txtime),
 			 ztest_unit_test(test_so_rcvtimeo),
+			 ztest_unit_test(test_so_rcvbuf),
 			 ztest_unit_test(test_v4_sendmsg_recvfrom),
 			 ztest_user_unit_test(test_v4_sendmsg_recvfrom),
 			 ztest_unit_test(test_v4_sendmsg_recvfrom_no_aux_data),
@@ -641,6 +641,19 @@ static void handle_server_test(sa_family_t af, struct tcphdr *th)
 		break;
 	case T_SYN_ACK:
 		test_verify_flags(th, SYN | ACK);
+
+		/* The peer offered window scaling, SACK and timestamps so
+		 * those must be present in SYN-ACK if we support them.
+		 */
+		if (test_case_no == 4U &&
+		    (IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) ||
+		     IS_ENABLED(CONFIG_NET_TCP_SACK) ||
+		     IS_ENABLED(CONFIG_NET_TCP_TIMESTAMPS))) {
+			zassert_true(th_off(th) > 5, "No options in SYN-ACK");
+		} else if (test_case_no != 4U) {
+			zassert_equal(th_off(th), 5, "Unexpected options");
+		}
+
 		seq++;
 		ack = ntohs(th->th_seq) + 1U;
 		reply = prepare_ack_packet(af, htons(MY_PORT),
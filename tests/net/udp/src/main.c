@@ -48,6 +48,7 @@ LOG_MODULE_REGISTER(net_test, NET_LOG_LEVEL);
 #define NET_LOG_ENABLED 1
 #endif
 #include "net_private.h"
+#include "net_stats.h"
 #include "ipv4.h"
 
 static bool test_failed;
@@ -668,9 +669,97 @@ void test_udp(void)
 	zassert_false(test_failed, "udp tests failed");
 }
 
+#define BATCH_COUNT 8
+
+static int batch_recv[2];
+
+static enum net_verdict test_batch_cb(struct net_conn *conn,
+				      struct net_pkt *pkt,
+				      union net_ip_header *ip_hdr,
+				      union net_proto_header *proto_hdr,
+				      void *user_data)
+{
+	batch_recv[POINTER_TO_INT(user_data)]++;
+
+	net_pkt_unref(pkt);
+
+	k_sem_give(&recv_lock);
+
+	return NET_OK;
+}
+
+void test_udp_batch(void)
+{
+	struct net_if *iface = net_if_get_default();
+	struct in_addr in4addr_my = { { { 192, 0, 2, 1 } } };
+	struct in_addr in4addr_peer = { { { 192, 0, 2, 9 } } };
+	struct net_conn_handle *handlers[2];
+	struct net_pkt *pkts[BATCH_COUNT];
+	int ret, i;
+#if defined(CONFIG_NET_RX_BATCH) && defined(CONFIG_NET_STATISTICS)
+	net_stats_t rx_batches = GET_STAT(iface, rx_batches);
+#endif
+
+	k_sem_reset(&recv_lock);
+
+	for (i = 0; i < ARRAY_SIZE(handlers); i++) {
+		ret = net_udp_register(AF_INET, NULL, NULL, 0, 5001 + i,
+				       test_batch_cb, INT_TO_POINTER(i),
+				       &handlers[i]);
+		zassert_equal(ret, 0, "UDP register failed (%d)", ret);
+	}
+
+	/* Two flows interleaved so that a stale connection lookup shared
+	 * between packets of the batch would be noticed.
+	 */
+	for (i = 0; i < BATCH_COUNT; i++) {
+		pkts[i] = net_pkt_alloc_with_buffer(iface, sizeof(payload),
+						    AF_INET, IPPROTO_UDP,
+						    K_SECONDS(1));
+		zassert_not_null(pkts[i], "Out of mem");
+
+		if (net_ipv4_create(pkts[i], &in4addr_peer, &in4addr_my) ||
+		    net_udp_create(pkts[i], htons(12345),
+				   htons(5001 + (i / 2) % 2)) ||
+		    net_pkt_write(pkts[i], payload, sizeof(payload))) {
+			zassert_true(0, "Cannot create IPv4 UDP pkt");
+		}
+
+		net_pkt_cursor_init(pkts[i]);
+		net_ipv4_finalize(pkts[i], IPPROTO_UDP);
+	}
+
+	ret = net_recv_data_batch(iface, pkts, BATCH_COUNT);
+	zassert_equal(ret, BATCH_COUNT, "Batch not queued (%d)", ret);
+
+	for (i = 0; i < BATCH_COUNT; i++) {
+		zassert_equal(k_sem_take(&recv_lock, TIMEOUT), 0,
+			      "Timeout, only %d packets received", i);
+	}
+
+	zassert_equal(batch_recv[0], BATCH_COUNT / 2, "Wrong flow 0 count");
+	zassert_equal(batch_recv[1], BATCH_COUNT / 2, "Wrong flow 1 count");
+
+#if defined(CONFIG_NET_RX_BATCH) && defined(CONFIG_NET_STATISTICS)
+	/* The whole burst is queued before the Rx thread runs, it is
+	 * processed in as few wakeups as the batch size allows.
+	 */
+	rx_batches = GET_STAT(iface, rx_batches) - rx_batches;
+	zassert_equal(rx_batches,
+		      DIV_ROUND_UP(BATCH_COUNT, CONFIG_NET_RX_BATCH_SIZE),
+		      "Packets processed in %u batches", rx_batches);
+#endif
+
+	for (i = 0; i < ARRAY_SIZE(handlers); i++) {
+		zassert_equal(net_udp_unregister(handlers[i]), 0,
+			      "Cannot unregister udp");
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_udp_fn,
-		ztest_unit_test(test_udp));
+		ztest_unit_test(test_udp),
+		ztest_unit_test(test_udp_batch));
 	ztest_run_test_suite(test_udp_fn);
 }
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Test the ring and the flash copies of the persistent backend
+ *
+ */
+
+#include <ztest.h>
+
+/* The backend is built with the test, with a small ring, to reach its
+ * internals.
+ */
+#define CONFIG_LOG_BACKEND_PERSIST_RAM_SIZE 256
+#define CONFIG_LOG_BACKEND_PERSIST_RECORD_MAX 32
+
+#ifdef CONFIG_FLASH_MAP
+#define CONFIG_LOG_BACKEND_PERSIST_FLASH 1
+#define CONFIG_LOG_BACKEND_PERSIST_FLASH_PERIOD 0
+#endif
+
+#include "log_backend_persist.c"
+
+/* Records of 20 characters take 36 bytes, the ring holds 7 of them and
+ * they are split at its end.
+ */
+#define MSG_LEN 20
+#define RECORD_LEN (sizeof(struct record_hdr) + MSG_LEN)
+#define RECORDS_MAX (RING_SIZE / RECORD_LEN)
+
+static void msg_get(char *msg, uint32_t seq)
+{
+	snprintk(msg, MSG_LEN + 1, "record %013u", seq);
+}
+
+/* Add the record seq, the timestamp is the sequence number. */
+static void record_add(void)
+{
+	char msg[MSG_LEN + 1];
+	uint32_t seq = ring.seq;
+
+	msg_get(msg, seq);
+	staging_len = 0;
+	(void)staging_out((uint8_t *)msg, MSG_LEN, NULL);
+	record_commit(LOG_LEVEL_INF, 1, seq);
+}
+
+static void records_add(int cnt)
+{
+	for (int i = 0; i < cnt; i++) {
+		record_add();
+	}
+}
+
+static void ring_init(void)
+{
+	ring_reset();
+	read_hint_seq = 0U;
+	read_hint_pos = 0U;
+}
+
+/* Read the records from first to last, starting with the sequence number
+ * seq, and return the one following the last one. If last is the newest
+ * record, check that nothing follows.
+ */
+static uint32_t records_check(uint32_t seq, uint32_t first, uint32_t last,
+			      uint16_t boot)
+{
+	struct log_persist_record record;
+	char buf[MSG_LEN + 1];
+	char msg[MSG_LEN + 1];
+
+	for (uint32_t i = first; i <= last; i++) {
+		zassert_equal(log_persist_read(&seq, &record, buf, sizeof(buf)),
+			      0, "Record %u not read", i);
+		zassert_equal(record.seq, i, "Read %u instead of %u",
+			      record.seq, i);
+		zassert_equal(record.timestamp, i, "Wrong timestamp");
+		zassert_equal(record.boot, boot, "Wrong boot count");
+		zassert_equal(record.level, LOG_LEVEL_INF, "Wrong level");
+		msg_get(msg, i);
+		zassert_true(strcmp(buf, msg) == 0, "Wrong message %s", buf);
+		zassert_equal(seq, i + 1U, "Wrong next sequence number");
+	}
+
+	if (last + 1U == ring.seq) {
+		zassert_equal(log_persist_read(&seq, &record, buf,
+					       sizeof(buf)),
+			      -ENOENT, "Record read after %u", last);
+	}
+
+	return seq;
+}
+
+#ifdef CONFIG_LOG_BACKEND_PERSIST_FLASH
+static void flash_erase_all(void)
+{
+	const struct flash_area *fa;
+
+	zassert_equal(flash_area_open(FLASH_PARTITION, &fa), 0, NULL);
+	zassert_equal(flash_area_erase(fa, 0, fa->fa_size), 0, NULL);
+	flash_area_close(fa);
+}
+#else
+static void flash_erase_all(void)
+{
+}
+#endif
+
+static void test_wrap_around(void)
+{
+	ring_init();
+
+	records_add(3 * RECORDS_MAX + 2);
+
+	zassert_equal(ring.head - ring.tail, RECORDS_MAX * RECORD_LEN,
+		      "Oldest records not dropped");
+	zassert_equal(ring.seq, 3 * RECORDS_MAX + 3, "Wrong sequence number");
+
+	(void)records_check(0U, 2 * RECORDS_MAX + 3, 3 * RECORDS_MAX + 2, 0U);
+}
+
+/* Corrupt a copy of a valid ring and check that it is reset at boot. */
+static void mount_check(const struct ring *saved, const char *what,
+			void (*corrupt)(void))
+{
+	ring = *saved;
+	corrupt();
+
+	log_backend_persist_api.init();
+
+	zassert_equal(ring.head, ring.tail, "Mounted with %s", what);
+	zassert_equal(ring.seq, 1U, "Not reset with %s", what);
+	zassert_equal(ring.boot, 0U, "Not reset with %s", what);
+}
+
+static void record_hdr_corrupt(uint32_t pos, uint16_t len, uint32_t seq)
+{
+	struct record_hdr hdr;
+
+	ring_read(pos, &hdr, sizeof(hdr));
+	hdr.len += len;
+	hdr.seq += seq;
+	ring_write(pos, &hdr, sizeof(hdr));
+}
+
+static void corrupt_len(void)
+{
+	record_hdr_corrupt(ring.tail + RECORD_LEN,
+			   CONFIG_LOG_BACKEND_PERSIST_RECORD_MAX, 0U);
+}
+
+static void corrupt_seq(void)
+{
+	record_hdr_corrupt(ring.tail + 2 * RECORD_LEN, 0U, 5U);
+}
+
+static void corrupt_magic(void)
+{
+	ring.magic = ~RING_MAGIC;
+}
+
+static void corrupt_head(void)
+{
+	ring.head = ring.tail + RING_SIZE + RECORD_LEN;
+}
+
+static void corrupt_cut(void)
+{
+	ring.head -= 3U;
+}
+
+static void test_mount(void)
+{
+	static struct ring saved;
+
+	flash_erase_all();
+	ring_init();
+	records_add(RECORDS_MAX + 3);
+	saved = ring;
+
+	/* A valid ring is kept, with the next boot count */
+	log_backend_persist_api.init();
+	zassert_equal(ring.boot, 1U, "Ring not mounted");
+	zassert_equal(ring.seq, saved.seq, "Wrong sequence number");
+	(void)records_check(0U, 4U, RECORDS_MAX + 3, 0U);
+
+	mount_check(&saved, "a long record", corrupt_len);
+	mount_check(&saved, "a sequence gap", corrupt_seq);
+	mount_check(&saved, "a bad magic number", corrupt_magic);
+	mount_check(&saved, "a head too far", corrupt_head);
+	mount_check(&saved, "a cut record", corrupt_cut);
+}
+
+static void test_read_consecutive(void)
+{
+	struct log_persist_record record;
+	char buf[MSG_LEN + 1];
+	uint32_t seq;
+
+	ring_init();
+	records_add(4);
+
+	/* Each read continues from the position of the previous one */
+	seq = records_check(0U, 1U, 4U, 0U);
+	zassert_equal(read_hint_seq, seq, "Hint not kept");
+	zassert_equal(read_hint_pos, ring.head, "Wrong hint");
+
+	records_add(2);
+	seq = records_check(seq, 5U, 6U, 0U);
+
+	/* A record in the middle, away from the hint */
+	seq = 3U;
+	(void)records_check(seq, 3U, 6U, 0U);
+
+	/* The hint points to a dropped record, the oldest one is read */
+	seq = 2U;
+	zassert_equal(log_persist_read(&seq, &record, buf, sizeof(buf)), 0,
+		      NULL);
+	records_add(RECORDS_MAX);
+	zassert_equal(seq, read_hint_seq, NULL);
+	zassert_true((read_hint_pos - ring.tail) > (ring.head - ring.tail),
+		     "Hint still in the ring");
+	(void)records_check(seq, 7U, RECORDS_MAX + 6, 0U);
+
+	/* Long messages are truncated */
+	seq = RECORDS_MAX + 6;
+	zassert_equal(log_persist_read(&seq, &record, buf, 8), 0, NULL);
+	zassert_equal(strlen(buf), 7, "Message not truncated");
+
+	log_persist_clear();
+	seq = 0U;
+	zassert_equal(log_persist_read(&seq, &record, buf, sizeof(buf)),
+		      -ENOENT, "Record read after a clear");
+}
+
+#ifdef CONFIG_LOG_BACKEND_PERSIST_FLASH
+static void test_flash_slots(void)
+{
+	const struct flash_area *fa;
+	struct ring header;
+	uint32_t seq;
+
+	flash_erase_all();
+	ring_init();
+	(void)flash_load(false);
+
+	records_add(3);
+	zassert_equal(log_persist_flush(), 0, "First copy failed");
+	records_add(2);
+	zassert_equal(log_persist_flush(), 0, "Second copy failed");
+
+	zassert_equal(flash_area_open(FLASH_PARTITION, &fa), 0, NULL);
+	zassert_equal(flash_last_slot(fa), 1, "Copies not alternated");
+
+	/* Reset while copying to slot 0, after its erase */
+	zassert_equal(flash_slot, 0, NULL);
+	zassert_equal(flash_area_erase(fa, flash_slot_off(fa, 0),
+				       fa->fa_size / 2U), 0, NULL);
+
+	ring.magic = 0U;
+	log_backend_persist_api.init();
+	zassert_equal(ring.boot, 1U, "Last copy not loaded");
+	(void)records_check(0U, 1U, 5U, 0U);
+	zassert_equal(flash_slot, 0, "Last copy not kept");
+
+	/* Reset while copying to slot 1, after its header: the records of
+	 * the slot are erased, the copy in slot 0 is loaded.
+	 */
+	records_add(1);
+	zassert_equal(log_persist_flush(), 0, "Third copy failed");
+	zassert_equal(flash_area_erase(fa, flash_slot_off(fa, 1),
+				       fa->fa_size / 2U), 0, NULL);
+	memcpy(&header, &ring, FLASH_CHUNK);
+	header.seq += 10U;
+	zassert_equal(flash_area_write(fa, flash_slot_off(fa, 1), &header,
+				       FLASH_CHUNK), 0, NULL);
+	zassert_equal(flash_last_slot(fa), 1, NULL);
+
+	ring.magic = 0U;
+	log_backend_persist_api.init();
+	zassert_equal(ring.boot, 2U, "Previous copy not loaded");
+	seq = records_check(0U, 1U, 5U, 0U);
+	(void)records_check(seq, 6U, 6U, 1U);
+	zassert_equal(flash_slot, 1, "Previous copy not kept");
+
+	flash_area_close(fa);
+}
+#else
+static void test_flash_slots(void)
+{
+	ztest_test_skip();
+}
+#endif
+
+void test_main(void)
+{
+	/* The test adds the records itself */
+	log_backend_disable(&log_backend_persist);
+
+	ztest_test_suite(log_backend_persist,
+			 ztest_unit_test(test_wrap_around),
+			 ztest_unit_test(test_mount),
+			 ztest_unit_test(test_read_consecutive),
+			 ztest_unit_test(test_flash_slots));
+
+	ztest_run_test_suite(log_backend_persist);
+}
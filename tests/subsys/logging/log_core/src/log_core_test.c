@@ -20,6 +20,10 @@
 #include <logging/log.h>
 #include "test_module.h"
 
+#ifndef CONFIG_LOG_RATE_LIMIT_BURST
+#define CONFIG_LOG_RATE_LIMIT_BURST 0
+#endif
+
 #define LOG_MODULE_NAME test
 LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
@@ -171,6 +175,10 @@ static void log_setup(bool backend2_enable)
 	}
 
 	test_source_id = log_source_id_get(STRINGIFY(LOG_MODULE_NAME));
+
+	if (IS_ENABLED(CONFIG_LOG_RATE_LIMIT)) {
+		log_rate_limit_set(CONFIG_LOG_DOMAIN_ID, test_source_id, 0, 0);
+	}
 }
 
 /*
@@ -477,6 +485,68 @@ static void test_log_msg_dropped_notification(void)
 	k_sched_unlock();
 }
 
+/*
+ * Test checks that messages exceeding the burst of a source are suppressed
+ * and reported with the next accepted message, and that a rate limited call
+ * site is limited independently of its source.
+ */
+static void test_log_rate_limit(void)
+{
+	if (!IS_ENABLED(CONFIG_LOG_RATE_LIMIT)) {
+		ztest_test_skip();
+		return;
+	}
+
+	log_setup(false);
+
+	log_rate_limit_set(CONFIG_LOG_DOMAIN_ID, test_source_id, 5, 3);
+
+	for (int i = 0; i < 5; i++) {
+		LOG_INF("test");
+	}
+
+	while (log_process(false)) {
+	}
+
+	zassert_equal(3, backend1_cb.counter,
+		      "Unexpected amount of messages received by the backend.");
+	zassert_equal(2, log_rate_limit_suppressed_get(CONFIG_LOG_DOMAIN_ID,
+						       test_source_id),
+		      "Unexpected amount of suppressed messages.");
+
+	/* One token is added every 200 ms. */
+	k_msleep(250);
+
+	LOG_INF("test");
+	LOG_INF("test");
+
+	while (log_process(false)) {
+	}
+
+	/* Expect the report of the suppressed messages and one message. */
+	zassert_equal(5, backend1_cb.counter,
+		      "Unexpected amount of messages received by the backend.");
+	zassert_equal(3, log_rate_limit_suppressed_get(CONFIG_LOG_DOMAIN_ID,
+						       test_source_id),
+		      "Unexpected amount of suppressed messages.");
+
+	log_rate_limit_set(CONFIG_LOG_DOMAIN_ID, test_source_id, 0, 0);
+	backend1_cb.counter = 0;
+
+	for (int i = 0; i < CONFIG_LOG_RATE_LIMIT_BURST + 2; i++) {
+		LOG_INF_RATELIMIT("test");
+	}
+
+	while (log_process(false)) {
+	}
+
+	zassert_equal(CONFIG_LOG_RATE_LIMIT_BURST, backend1_cb.counter,
+		      "Unexpected amount of messages received by the backend.");
+	zassert_equal(2, log_rate_limit_suppressed_get(CONFIG_LOG_DOMAIN_ID,
+						       test_source_id),
+		      "Unexpected amount of suppressed messages.");
+}
+
 static void test_single_z_log_get_s_mask(const char *str, uint32_t nargs,
 					 uint32_t exp_mask)
 {
@@ -538,6 +608,7 @@ void test_main(void)
 			 ztest_unit_test(test_log_strdup_detect_miss),
 			 ztest_unit_test(test_strdup_trimming),
 			 ztest_unit_test(test_log_msg_dropped_notification),
+			 ztest_unit_test(test_log_rate_limit),
 			 ztest_unit_test(test_z_log_get_s_mask),
 			 ztest_unit_test(test_log_panic));
 	ztest_run_test_suite(test_log_list);
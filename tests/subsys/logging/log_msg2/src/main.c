@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Test packaged log messages
+ *
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <sys/cbprintf.h>
+#include <logging/log.h>
+#include <logging/log_backend.h>
+#include <logging/log_ctrl.h>
+#include <logging/log_output.h>
+
+#define LOG_MODULE_NAME test
+LOG_MODULE_REGISTER(LOG_MODULE_NAME, LOG_LEVEL_DBG);
+
+static char output[512];
+static size_t output_len;
+static uint32_t processed;
+static uint16_t package_len;
+static uint32_t total_drops;
+
+static int out(uint8_t *data, size_t length, void *ctx)
+{
+	ARG_UNUSED(ctx);
+
+	length = MIN(length, sizeof(output) - 1 - output_len);
+	memcpy(&output[output_len], data, length);
+	output_len += length;
+	output[output_len] = '\0';
+
+	return length;
+}
+
+static uint8_t test_output_buf[16];
+
+LOG_OUTPUT_DEFINE(test_output, out, test_output_buf, sizeof(test_output_buf));
+
+static void process(const struct log_backend *const backend,
+		    const struct log_msg2 *msg)
+{
+	processed++;
+	package_len = msg->package_len;
+	log_output_msg2_process(&test_output, msg, LOG_OUTPUT_FLAG_CRLF_LFONLY);
+}
+
+static void dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	total_drops += cnt;
+}
+
+static void panic(const struct log_backend *const backend)
+{
+}
+
+static const struct log_backend_api test_backend_api = {
+	.process = process,
+	.dropped = dropped,
+	.panic = panic,
+};
+
+LOG_BACKEND_DEFINE(test_backend, test_backend_api, false);
+
+static void flush(void)
+{
+	while (log_process(false)) {
+	}
+}
+
+static void setup(void)
+{
+	flush();
+	output_len = 0;
+	output[0] = '\0';
+	processed = 0;
+	total_drops = 0;
+}
+
+static void test_args(void)
+{
+	LOG_INF("%d %u %s", -1, 2, "ro");
+	LOG_WRN("%llx %c %5.2s|%-4d|", 0x1122334455ULL, 'x', "abc", 7);
+	LOG_DBG("no args");
+	flush();
+
+	zassert_equal(processed, 3, "wrong number of messages");
+	zassert_equal(strcmp(output,
+			     "test: -1 2 ro\n"
+			     "test: 1122334455 x    ab|7   |\n"
+			     "test: no args\n"), 0, "unexpected output: %s",
+		      output);
+}
+
+static void test_transient_string(void)
+{
+	char str[] = "abc";
+
+	/* The string is copied in the message, log_strdup() is a no-op. */
+	LOG_INF("%s", str);
+	zassert_equal_ptr(log_strdup(str), str, "string duplicated");
+	str[0] = 'z';
+	flush();
+
+	zassert_equal(strcmp(output, "test: abc\n"), 0, "unexpected output: %s",
+		      output);
+}
+
+static void test_arg_types(void)
+{
+	char c = 'c';
+	int16_t h = -3;
+	uint8_t bytes[] = { 'x', '\0' };
+	const char *null_str = NULL;
+	char expected[64];
+
+	/* Only char pointers are copied, other pointers are kept as is. */
+	LOG_INF("%c %hd %s %p", c, h, null_str, bytes);
+	flush();
+
+	snprintk(expected, sizeof(expected), "test: c -3 (null) %p\n", bytes);
+	zassert_equal(strcmp(output, expected), 0, "unexpected output: %s",
+		      output);
+}
+
+/* Length of the package created for the arguments in the mode tested. */
+#define PACKAGE_LEN(...) ({ \
+	int _len = cbprintf_package(NULL, 0, __VA_ARGS__); \
+	\
+	if (!IS_ENABLED(CONFIG_LOG2_ALWAYS_RUNTIME)) { \
+		CBPRINTF_STATIC_PACKAGE(NULL, 0, _len, __VA_ARGS__); \
+	} \
+	_len; \
+})
+
+static void test_string_precision(void)
+{
+	static const char str[] = "abcdef";
+	/* Not NUL terminated, so not passed as a char pointer */
+	char chars[] = { 'x', 'y', 'z' };
+
+	/* The precision is applied when the message is formatted. */
+	LOG_INF("%.*s %.2s", 3, str, (const uint8_t *)chars);
+	flush();
+
+	zassert_equal(strcmp(output, "test: abc xy\n"), 0,
+		      "unexpected output: %s", output);
+	zassert_equal(package_len, PACKAGE_LEN("%.*s %.2s", 3, str,
+					       (const uint8_t *)chars),
+		      "unexpected package length");
+}
+
+static void test_char_pointer(void)
+{
+	char str[] = "abc";
+	char expected[64];
+
+	/* The pointer of a copied string is printed by %p. */
+	LOG_INF("%p %s", str, str);
+	flush();
+
+	snprintk(expected, sizeof(expected), "test: %p abc\n", str);
+	zassert_equal(strcmp(output, expected), 0, "unexpected output: %s",
+		      output);
+	zassert_equal(package_len, PACKAGE_LEN("%p %s", str, str),
+		      "unexpected package length");
+}
+
+static void test_hexdump(void)
+{
+	static const uint8_t data[] = { 0x01, 0x02, 0x41, 0x42 };
+
+	LOG_HEXDUMP_INF(data, sizeof(data), "hex");
+	flush();
+
+	zassert_equal(processed, 1, "wrong number of messages");
+	zassert_not_null(strstr(output, "test: hex\n"), "no metadata: %s",
+			 output);
+	zassert_not_null(strstr(output, "01 02 41 42"), "no data: %s", output);
+	zassert_not_null(strstr(output, "|..AB"), "no characters: %s", output);
+}
+
+static void test_generic(void)
+{
+	struct log_msg_ids src_level = {
+		.level = LOG_LEVEL_INF,
+		.domain_id = CONFIG_LOG_DOMAIN_ID,
+		.source_id = LOG_CURRENT_MODULE_ID(),
+	};
+
+	log_string_sync(src_level, "%s %d", "generic", 5);
+	flush();
+
+	zassert_equal(strcmp(output, "test: generic 5\n"), 0,
+		      "unexpected output: %s", output);
+}
+
+static void test_overflow(void)
+{
+	uint32_t logged;
+
+	/* New messages are dropped once the buffer is full. */
+	for (logged = 0; logged < CONFIG_LOG_BUFFER_SIZE / 8; logged++) {
+		LOG_INF("%d", logged);
+	}
+
+	flush();
+
+	zassert_true(total_drops > 0, "no message dropped");
+	zassert_equal(processed + total_drops, logged, "messages lost");
+	zassert_equal(strncmp(output, "test: 0\ntest: 1\n", 16), 0,
+		      "oldest messages not kept: %s", output);
+
+	/* Space is available again once processed. */
+	setup();
+	LOG_INF("after");
+	flush();
+	zassert_equal(strcmp(output, "test: after\n"), 0,
+		      "unexpected output: %s", output);
+}
+
+void test_main(void)
+{
+	log_backend_enable(&test_backend, NULL, LOG_LEVEL_DBG);
+
+	ztest_test_suite(test_log_msg2,
+			 ztest_unit_test_setup_teardown(test_args, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_transient_string,
+							setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_arg_types, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_string_precision,
+							setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_char_pointer, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_hexdump, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_generic, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_overflow, setup,
+							unit_test_noop));
+	ztest_run_test_suite(test_log_msg2);
+}
@@ -15,6 +15,8 @@
 #include <shell/shell.h>
 #include <shell/shell_dummy.h>
 
+#include "shell_utils.h"
+
 #define MAX_CMD_SYNTAX_LEN	(11)
 static char dynamic_cmd_buffer[][MAX_CMD_SYNTAX_LEN] = {
 		"dynamic",
@@ -168,6 +170,89 @@ static void test_shell_module(void)
 
 	test_shell_execute_cmd("", -ENOEXEC); /* empty command */
 	test_shell_execute_cmd("not existing command", -ENOEXEC);
+
+	/* Root commands are found by exact match only. */
+	test_shell_execute_cmd("test_shell", -ENOEXEC);
+	test_shell_execute_cmd("test_shell_cmdx", -ENOEXEC);
+	test_shell_execute_cmd("aaaaaa", -ENOEXEC);
+	test_shell_execute_cmd("zzzzzz", -ENOEXEC);
+}
+
+/* Check the root commands found for a prefix against a linear scan. */
+static void root_prefix_check(const char *prefix, size_t len)
+{
+	const struct shell_static_entry *entry;
+	size_t exp_first = SIZE_MAX;
+	size_t exp_cnt = 0;
+	size_t first;
+	size_t cnt;
+
+	for (size_t idx = 0; (entry = z_shell_cmd_get(NULL, idx, NULL));
+	     idx++) {
+		if (strncmp(entry->syntax, prefix, len) == 0) {
+			exp_first = MIN(exp_first, idx);
+			exp_cnt++;
+		}
+	}
+
+	cnt = z_shell_root_cmd_prefix_find(prefix, len, &first);
+
+	zassert_equal(cnt, exp_cnt, "%.*s: %zu commands instead of %zu",
+		      (int)len, prefix, cnt, exp_cnt);
+	if (cnt > 0) {
+		zassert_equal(first, exp_first, "%.*s: first %zu instead of %zu",
+			      (int)len, prefix, first, exp_first);
+	}
+}
+
+/* test tab completion of root commands */
+static void test_root_cmd_completion(void)
+{
+	const struct shell_static_entry *entry;
+	size_t cmd_cnt = 0;
+	size_t first;
+	size_t cnt;
+
+	while (z_shell_cmd_get(NULL, cmd_cnt, NULL) != NULL) {
+		cmd_cnt++;
+	}
+
+	/* An empty prefix completes to every command */
+	cnt = z_shell_root_cmd_prefix_find("", 0, &first);
+	zassert_equal(first, 0, "Wrong first command");
+	zassert_equal(cnt, cmd_cnt, "Not all commands completed");
+
+	/* Every prefix of every command, including the first and the last
+	 * sorted ones.
+	 */
+	for (size_t idx = 0; idx < cmd_cnt; idx++) {
+		entry = z_shell_cmd_get(NULL, idx, NULL);
+
+		for (size_t len = 1; len <= strlen(entry->syntax); len++) {
+			root_prefix_check(entry->syntax, len);
+		}
+	}
+
+	entry = z_shell_cmd_get(NULL, 0, NULL);
+	cnt = z_shell_root_cmd_prefix_find(entry->syntax,
+					   strlen(entry->syntax), &first);
+	zassert_equal(first, 0, "First command not completed");
+
+	entry = z_shell_cmd_get(NULL, cmd_cnt - 1, NULL);
+	cnt = z_shell_root_cmd_prefix_find(entry->syntax,
+					   strlen(entry->syntax), &first);
+	zassert_equal(first + cnt, cmd_cnt, "Last command not completed");
+
+	/* Prefixes with no match, before, between and after the commands */
+	root_prefix_check("", 1);
+	root_prefix_check("test_shell_cmdx", 15);
+	root_prefix_check("test_s_", 7);
+	root_prefix_check("zzzzzz", 6);
+	zassert_equal(z_shell_root_cmd_prefix_find("zzzzzz", 6, &first), 0,
+		      "Unexpected match");
+
+	/* Only the given length of the prefix is compared */
+	root_prefix_check("test_shell_cmdx", 14);
 }
 
 /* test wildcard and static subcommands */
@@ -182,6 +267,10 @@ static void test_shell_wildcards_static(void)
 
 	test_shell_execute_cmd("test_wildcard *", 3);
 	test_shell_execute_cmd("test_wildcard a*", 2);
+
+	/* Wildcards are not expanded at the root level */
+	test_shell_execute_cmd("test_wildcar?", -ENOEXEC);
+	test_shell_execute_cmd("test_wild* argument_1", -ENOEXEC);
 }
 
 /* test wildcard and dynamic subcommands */
@@ -399,6 +488,7 @@ void test_main(void)
 			ztest_unit_test(test_cmd_select),
 			ztest_unit_test(test_cmd_resize),
 			ztest_unit_test(test_shell_module),
+			ztest_unit_test(test_root_cmd_completion),
 			ztest_unit_test(test_shell_wildcards_static),
 			ztest_unit_test(test_shell_wildcards_dynamic),
 			ztest_unit_test(test_shell_fprintf),
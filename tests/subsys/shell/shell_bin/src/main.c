@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Binary shell backend test suite
+ *
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <device.h>
+#include <drivers/uart.h>
+#include <shell/shell.h>
+#include <shell/shell_bin.h>
+#include <sys/byteorder.h>
+#include <sys/crc.h>
+
+#define WAIT_MS		2000
+#define WAIT_STEP_MS	20
+#define LONG_OUTPUT_LEN	300
+
+/* UART fed by the test, recording what the backend sends. */
+static struct {
+	struct k_spinlock lock;
+	uint8_t rx[256];
+	size_t rx_len;
+	size_t rx_pos;
+	uint8_t tx[4096];
+	size_t tx_len;
+	bool tx_overflow;
+	uart_irq_callback_user_data_t cb;
+	void *cb_data;
+} fake_uart;
+
+static void fake_poll_out(const struct device *dev, unsigned char c)
+{
+	k_spinlock_key_t key = k_spin_lock(&fake_uart.lock);
+
+	if (fake_uart.tx_len < sizeof(fake_uart.tx)) {
+		fake_uart.tx[fake_uart.tx_len++] = c;
+	} else {
+		fake_uart.tx_overflow = true;
+	}
+
+	k_spin_unlock(&fake_uart.lock, key);
+}
+
+static int fake_fifo_read(const struct device *dev, uint8_t *data,
+			  const int size)
+{
+	int len = MIN(size, (int)(fake_uart.rx_len - fake_uart.rx_pos));
+
+	memcpy(data, &fake_uart.rx[fake_uart.rx_pos], len);
+	fake_uart.rx_pos += len;
+
+	return len;
+}
+
+static void fake_irq_rx_enable(const struct device *dev)
+{
+}
+
+static void fake_irq_rx_disable(const struct device *dev)
+{
+}
+
+static int fake_irq_rx_ready(const struct device *dev)
+{
+	return fake_uart.rx_pos < fake_uart.rx_len;
+}
+
+static int fake_irq_update(const struct device *dev)
+{
+	return 1;
+}
+
+static void fake_irq_callback_set(const struct device *dev,
+				  uart_irq_callback_user_data_t cb,
+				  void *user_data)
+{
+	fake_uart.cb = cb;
+	fake_uart.cb_data = user_data;
+}
+
+static const struct uart_driver_api fake_uart_api = {
+	.poll_out = fake_poll_out,
+	.fifo_read = fake_fifo_read,
+	.irq_rx_enable = fake_irq_rx_enable,
+	.irq_rx_disable = fake_irq_rx_disable,
+	.irq_rx_ready = fake_irq_rx_ready,
+	.irq_update = fake_irq_update,
+	.irq_callback_set = fake_irq_callback_set,
+};
+
+static int fake_uart_init(const struct device *dev)
+{
+	return 0;
+}
+
+DEVICE_DEFINE(fake_uart, "FAKE_UART", fake_uart_init, NULL, NULL, NULL,
+	      PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_DEVICE, &fake_uart_api);
+
+static int cmd_echo(const struct shell *shell, size_t argc, char **argv)
+{
+	shell_print(shell, "%s", argv[1]);
+
+	return 0;
+}
+SHELL_CMD_ARG_REGISTER(test_echo, NULL, "Print the argument", cmd_echo, 2, 0);
+
+static int cmd_fail(const struct shell *shell, size_t argc, char **argv)
+{
+	return -EPERM;
+}
+SHELL_CMD_REGISTER(test_fail, NULL, "Fail", cmd_fail);
+
+static int cmd_long(const struct shell *shell, size_t argc, char **argv)
+{
+	for (int i = 0; i < LONG_OUTPUT_LEN; i++) {
+		shell_fprintf(shell, SHELL_NORMAL, "x");
+	}
+
+	return 0;
+}
+SHELL_CMD_REGISTER(test_long, NULL, "Print more than a frame", cmd_long);
+
+/* Send a frame to the backend, with a wrong CRC if bad_crc. len is the
+ * length in the header, only data_len bytes of payload follow.
+ */
+static void frame_receive(uint8_t type, uint16_t seq, uint16_t len,
+			  const void *data, size_t data_len, bool bad_crc)
+{
+	struct shell_bin_hdr hdr = {
+		.sync = SHELL_BIN_SYNC,
+		.type = type,
+		.seq = sys_cpu_to_le16(seq),
+		.len = sys_cpu_to_le16(len),
+	};
+	uint16_t crc;
+	uint8_t *rx = fake_uart.rx;
+
+	zassert_true(sizeof(hdr) + data_len + sizeof(crc) <=
+		     sizeof(fake_uart.rx), "Frame too long for the test");
+
+	crc = crc16_itu_t(crc16_itu_t(0, &hdr.type, sizeof(hdr) - 1),
+			  data, data_len);
+	if (bad_crc) {
+		crc ^= 0x0101;
+	}
+
+	memcpy(rx, &hdr, sizeof(hdr));
+	memcpy(&rx[sizeof(hdr)], data, data_len);
+	sys_put_le16(crc, &rx[sizeof(hdr) + data_len]);
+	fake_uart.rx_len = sizeof(hdr) + data_len + sizeof(crc);
+	fake_uart.rx_pos = 0;
+
+	zassert_not_null(fake_uart.cb, "Backend not initialized");
+	fake_uart.cb(DEVICE_GET(fake_uart), fake_uart.cb_data);
+	zassert_equal(fake_uart.rx_pos, fake_uart.rx_len,
+		      "Frame not consumed");
+}
+
+static void cmd_receive(uint16_t seq, const char *cmd)
+{
+	frame_receive(SHELL_BIN_FRAME_CMD, seq, strlen(cmd), cmd, strlen(cmd),
+		      false);
+}
+
+/* Frames sent by the backend */
+struct sent {
+	uint8_t buf[sizeof(fake_uart.tx)];
+	size_t len;
+	/* output of the command looked for */
+	char output[512];
+	size_t output_len;
+	int output_frames;
+	bool result;
+	int32_t ret;
+	bool log;
+};
+
+/* Decode the frames sent so far, looking for the output and result of the
+ * command seq and for a log message containing log. The tests use distinct
+ * sequence numbers and log messages.
+ */
+static void sent_decode(struct sent *sent, uint16_t seq, const char *log)
+{
+	k_spinlock_key_t key = k_spin_lock(&fake_uart.lock);
+	bool overflow = fake_uart.tx_overflow;
+	size_t pos = 0;
+
+	memcpy(sent->buf, fake_uart.tx, fake_uart.tx_len);
+	sent->len = fake_uart.tx_len;
+	k_spin_unlock(&fake_uart.lock, key);
+
+	zassert_false(overflow, "Too much output");
+
+	sent->output_len = 0;
+	sent->output_frames = 0;
+	sent->result = false;
+	sent->log = false;
+
+	while (pos + sizeof(struct shell_bin_hdr) + sizeof(uint16_t) <=
+	       sent->len) {
+		struct shell_bin_hdr hdr;
+		uint8_t *payload = &sent->buf[pos + sizeof(hdr)];
+		size_t len;
+
+		memcpy(&hdr, &sent->buf[pos], sizeof(hdr));
+		len = sys_le16_to_cpu(hdr.len);
+		zassert_equal(hdr.sync, SHELL_BIN_SYNC, "No sync at %zu", pos);
+
+		if (pos + sizeof(hdr) + len + sizeof(uint16_t) > sent->len) {
+			/* frame being sent */
+			break;
+		}
+
+		zassert_equal(crc16_itu_t(0, &sent->buf[pos + 1],
+					  sizeof(hdr) - 1 + len),
+			      sys_get_le16(&payload[len]), "Wrong CRC at %zu",
+			      pos);
+
+		if (hdr.type == SHELL_BIN_FRAME_LOG) {
+			zassert_equal(sys_le16_to_cpu(hdr.seq), 0,
+				      "Log with a sequence number");
+			payload[len] = '\0';
+			if ((log != NULL) && strstr((char *)payload, log)) {
+				sent->log = true;
+			}
+		} else if (sys_le16_to_cpu(hdr.seq) != seq) {
+			/* other command */
+		} else if (hdr.type == SHELL_BIN_FRAME_OUTPUT) {
+			zassert_true(sent->output_len + len <
+				     sizeof(sent->output), "Output too long");
+			memcpy(&sent->output[sent->output_len], payload, len);
+			sent->output_len += len;
+			sent->output[sent->output_len] = '\0';
+			sent->output_frames++;
+		} else if (hdr.type == SHELL_BIN_FRAME_RESULT) {
+			zassert_equal(len, sizeof(int32_t), "Wrong result");
+			sent->ret = (int32_t)sys_get_le32(payload);
+			sent->result = true;
+		}
+
+		pos += sizeof(hdr) + len + sizeof(uint16_t);
+	}
+}
+
+static struct sent sent;
+
+/* Wait for the result of the command seq, or for log if not NULL. */
+static void sent_wait(uint16_t seq, const char *log)
+{
+	for (int ms = 0; ms < WAIT_MS; ms += WAIT_STEP_MS) {
+		sent_decode(&sent, seq, log);
+		if ((log == NULL) ? sent.result : sent.log) {
+			return;
+		}
+
+		k_msleep(WAIT_STEP_MS);
+	}
+}
+
+static void test_cmd(void)
+{
+	cmd_receive(1, "test_echo hello");
+	sent_wait(1, NULL);
+
+	zassert_true(sent.result, "No result");
+	zassert_equal(sent.ret, 0, "Wrong result %d", sent.ret);
+	zassert_not_null(strstr(sent.output, "hello\r\n"),
+			 "Unexpected output: %s", sent.output);
+}
+
+static void test_cmd_error(void)
+{
+	cmd_receive(2, "test_fail");
+	sent_wait(2, NULL);
+
+	zassert_true(sent.result, "No result");
+	zassert_equal(sent.ret, -EPERM, "Wrong result %d", sent.ret);
+
+	cmd_receive(3, "test_none");
+	sent_wait(3, NULL);
+
+	zassert_true(sent.result, "No result");
+	zassert_true(sent.ret < 0, "Unknown command succeeded");
+}
+
+static void test_long_output(void)
+{
+	size_t count = 0;
+
+	cmd_receive(4, "test_long");
+	sent_wait(4, NULL);
+
+	zassert_true(sent.result, "No result");
+	zassert_true(sent.output_frames > LONG_OUTPUT_LEN /
+		     CONFIG_SHELL_BIN_TX_BUFFER_SIZE, "Output not split");
+
+	for (size_t i = 0; i < sent.output_len; i++) {
+		count += (sent.output[i] == 'x');
+	}
+
+	zassert_equal(count, LONG_OUTPUT_LEN, "Output lost");
+}
+
+static void test_bad_crc(void)
+{
+	static const char cmd[] = "test_echo bad";
+
+	frame_receive(SHELL_BIN_FRAME_CMD, 5, strlen(cmd), cmd, strlen(cmd),
+		      true);
+	sent_wait(5, "wrong CRC");
+
+	zassert_true(sent.log, "Frame not reported");
+	zassert_false(sent.result, "Frame with a wrong CRC executed");
+
+	cmd_receive(6, "test_echo good");
+	sent_wait(6, NULL);
+
+	zassert_true(sent.result, "Not synchronized after a wrong CRC");
+	zassert_equal(sent.ret, 0, "Wrong result %d", sent.ret);
+}
+
+static void test_too_long(void)
+{
+	char cmd[CONFIG_SHELL_CMD_BUFF_SIZE + 10];
+
+	(void)memset(cmd, 'a', sizeof(cmd));
+
+	/* Dropped from its header, whose sequence number is not checked */
+	frame_receive(SHELL_BIN_FRAME_CMD, 7, sizeof(cmd), cmd, sizeof(cmd),
+		      false);
+	sent_wait(7, "too long");
+
+	zassert_true(sent.log, "Frame not reported");
+	zassert_false(sent.result, "Result sent for a dropped frame");
+
+	cmd_receive(8, "test_echo good");
+	sent_wait(8, NULL);
+
+	zassert_true(sent.result, "Not synchronized after a long frame");
+	zassert_equal(sent.ret, 0, "Wrong result %d", sent.ret);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(shell_bin,
+			 ztest_unit_test(test_cmd),
+			 ztest_unit_test(test_cmd_error),
+			 ztest_unit_test(test_long_output),
+			 ztest_unit_test(test_bad_crc),
+			 ztest_unit_test(test_too_long));
+
+	ztest_run_test_suite(shell_bin);
+}
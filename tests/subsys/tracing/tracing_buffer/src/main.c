@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2021 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Test the merge of the per-CPU tracing buffers
+ *
+ */
+
+#include <ztest.h>
+
+/* The buffers are built with the test, small, to reach their internals. */
+#define CONFIG_TRACING_BUFFER_PER_CPU 1
+#define CONFIG_TRACING_BUFFER_SIZE 256
+#define CONFIG_TRACING_CMD_BUFFER_SIZE 32
+
+#include "tracing_buffer.c"
+
+/* One emitter per CPU, each filling its buffer many times. */
+#define EMITTER_CNT CONFIG_MP_NUM_CPUS
+#define EVENT_CNT 2000
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+struct test_event {
+	uint32_t emitter;
+	uint32_t seq;
+};
+
+static K_THREAD_STACK_ARRAY_DEFINE(emitter_stacks, EMITTER_CNT, STACK_SIZE);
+static struct k_thread emitter_threads[EMITTER_CNT];
+
+static void emitter(void *p1, void *p2, void *p3)
+{
+	uint32_t id = POINTER_TO_UINT(p1);
+	struct test_event *event;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (uint32_t seq = 0; seq < EVENT_CNT; seq++) {
+		while ((event = (struct test_event *)
+			tracing_buffer_event_alloc(sizeof(*event))) == NULL) {
+			k_yield();
+		}
+
+		event->emitter = id;
+		event->seq = seq;
+		tracing_buffer_event_commit((uint8_t *)event);
+	}
+}
+
+static const struct tracing_event *event_get(uint8_t *data)
+{
+	return CONTAINER_OF(data, struct tracing_event, data);
+}
+
+/* Commit an event in the buffer of a CPU, whichever CPU runs the test. */
+static uint8_t *event_put(int cpu)
+{
+	struct tracing_event *event;
+
+	event = mpsc_pbuf_alloc(&cpu_buffers[cpu],
+				sizeof(*event) + sizeof(uint32_t));
+	zassert_not_null(event, "Buffer of CPU %d full", cpu);
+
+	event->timestamp = k_cycle_get_32();
+	event->length = sizeof(uint32_t);
+	event->cpu = cpu;
+	mpsc_pbuf_commit(&cpu_buffers[cpu], event);
+
+	return event->data;
+}
+
+/* Claim an event, check that it is the expected one and free it. */
+static void event_check(uint8_t *expected)
+{
+	uint8_t *data;
+
+	zassert_equal(tracing_buffer_event_claim(&data), sizeof(uint32_t),
+		      "Event not claimed");
+	zassert_equal_ptr(data, expected, "Wrong event claimed");
+	tracing_buffer_event_free();
+}
+
+static void test_claim_order(void)
+{
+	uint32_t cpu_events[CONFIG_MP_NUM_CPUS] = { 0 };
+	uint32_t next_seq[EMITTER_CNT] = { 0 };
+	const struct tracing_event *event;
+	const struct test_event *data;
+	uint32_t timestamp = 0U;
+	uint32_t total = 0U;
+	uint8_t *buf;
+
+	tracing_buffer_init();
+
+	for (int i = 0; i < EMITTER_CNT; i++) {
+		k_thread_create(&emitter_threads[i], emitter_stacks[i],
+				STACK_SIZE, emitter, UINT_TO_POINTER(i),
+				NULL, NULL, K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	}
+
+	while (total < EMITTER_CNT * EVENT_CNT) {
+		if (tracing_buffer_event_claim(&buf) == 0U) {
+			k_sleep(K_TICKS(1));
+			continue;
+		}
+
+		event = event_get(buf);
+		data = (const struct test_event *)buf;
+
+		zassert_true(total == 0U ||
+			     (int32_t)(event->timestamp - timestamp) >= 0,
+			     "Event %u of emitter %u claimed out of order",
+			     data->seq, data->emitter);
+		zassert_equal(data->seq, next_seq[data->emitter],
+			      "Events of emitter %u lost", data->emitter);
+
+		next_seq[data->emitter]++;
+		cpu_events[event->cpu]++;
+		timestamp = event->timestamp;
+		total++;
+
+		tracing_buffer_event_free();
+	}
+
+	for (int i = 0; i < EMITTER_CNT; i++) {
+		k_thread_join(&emitter_threads[i], K_FOREVER);
+	}
+
+	zassert_true(tracing_buffer_is_empty(), "Events left");
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		zassert_true(cpu_events[i] > 0U, "No event from CPU %d", i);
+	}
+}
+
+static void test_uncommitted_head(void)
+{
+	uint8_t *first;
+	uint8_t *second;
+	uint8_t *buf;
+	int cpu;
+
+	tracing_buffer_init();
+
+	/* The head of a buffer is reserved, a later event is committed in
+	 * the buffer of another CPU, or behind it without SMP.
+	 */
+	first = tracing_buffer_event_alloc(sizeof(uint32_t));
+	zassert_not_null(first, "Event not allocated");
+	cpu = event_get(first)->cpu;
+	second = event_put((cpu + 1) % CONFIG_MP_NUM_CPUS);
+
+	zassert_equal(tracing_buffer_event_claim(&buf), 0U,
+		      "Claimed past an uncommitted head");
+	zassert_false(tracing_buffer_is_empty(), "Events not pending");
+
+	tracing_buffer_event_commit(first);
+	/* Let the cycle counter pass the timestamps. */
+	k_busy_wait(10);
+
+	event_check(first);
+	event_check(second);
+	zassert_equal(tracing_buffer_event_claim(&buf), 0U, "Event left");
+	zassert_true(tracing_buffer_is_empty(), "Events left");
+}
+
+static void test_claim_recent(void)
+{
+	struct tracing_event *event;
+	uint8_t *data;
+	uint8_t *buf;
+
+	tracing_buffer_init();
+
+	/* An event timestamped after the start of the claim may be newer
+	 * than an event of a CPU found empty, it is not claimed yet.
+	 */
+	data = event_put(0);
+	event = CONTAINER_OF(data, struct tracing_event, data);
+	event->timestamp = k_cycle_get_32() + sys_clock_hw_cycles_per_sec();
+
+	zassert_equal(tracing_buffer_event_claim(&buf), 0U,
+		      "Claimed an event newer than the claim");
+
+	event->timestamp = k_cycle_get_32();
+	k_busy_wait(10);
+
+	event_check(data);
+	zassert_true(tracing_buffer_is_empty(), "Events left");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(tracing_buffer,
+			 ztest_unit_test(test_uncommitted_head),
+			 ztest_unit_test(test_claim_recent),
+			 ztest_unit_test(test_claim_order));
+
+	ztest_run_test_suite(tracing_buffer);
+}